@@ -0,0 +1,426 @@
+#include "ofxRulr/Nodes/DeclareNodes.h"
+#include "BatchRunner.h"
+
+#include "ofAppNoWindow.h"
+
+#include "Poco/Path.h"
+
+#ifdef TARGET_OSX
+#include <mach-o/dyld.h>
+#endif
+
+#ifndef TARGET_WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+//----------
+bool BatchRunner::run(const vector<string> & arguments, int & exitCode) {
+	try {
+		if (arguments.size() >= 2 && arguments[0] == "--batch") {
+			string reportFilename;
+			size_t threadCount = 0;
+			size_t memoryLimitMB = 0;
+			for (size_t i = 2; i + 1 < arguments.size(); i += 2) {
+				if (arguments[i] == "--report") {
+					reportFilename = arguments[i + 1];
+				}
+				else if (arguments[i] == "--threads") {
+					threadCount = ofToInt(arguments[i + 1]);
+				}
+				else if (arguments[i] == "--memory-limit") {
+					memoryLimitMB = ofToInt(arguments[i + 1]);
+				}
+				else {
+					ofLogError("BatchRunner") << "Unknown argument [" << arguments[i] << "]";
+				}
+			}
+			exitCode = BatchRunner::runBatch(arguments[1], reportFilename, threadCount, memoryLimitMB);
+			return true;
+		}
+		else if (arguments.size() >= 4 && arguments[0] == "--job") {
+			exitCode = BatchRunner::runJob(arguments[1], ofToInt(arguments[2]), arguments[3]);
+			return true;
+		}
+		else if (!arguments.empty() && arguments[0] == "--self-test") {
+			exitCode = BatchRunner::runSelfTest();
+			return true;
+		}
+	}
+	catch (const std::exception & e) {
+		ofLogError("BatchRunner") << e.what();
+		exitCode = 1;
+		return true;
+	}
+	return false;
+}
+
+//----------
+int BatchRunner::runBatch(const string & jobsFilename, string reportFilename, size_t threadCount, size_t memoryLimitMB) {
+	const auto jobsJson = BatchRunner::loadJson(jobsFilename);
+	const auto & jobs = jobsJson["jobs"];
+	if (!jobs.isArray() || jobs.empty()) {
+		ofLogError("BatchRunner") << "No jobs found in [" << jobsFilename << "]";
+		return 1;
+	}
+
+	//command line overrides the jobs file
+	if (threadCount == 0) {
+		threadCount = jobsJson["threads"].asUInt();
+	}
+	if (threadCount == 0) {
+		threadCount = max(thread::hardware_concurrency(), 1u);
+	}
+	threadCount = min(threadCount, (size_t)jobs.size());
+
+	if (memoryLimitMB == 0) {
+		memoryLimitMB = jobsJson["memoryLimitMB"].asUInt();
+	}
+
+	if (reportFilename.empty()) {
+		reportFilename = ofFilePath::removeExt(jobsFilename) + ".report.json";
+	}
+
+	ofLogNotice("BatchRunner") << "Running " << jobs.size() << " jobs on " << threadCount << " processes";
+
+	const auto startTime = chrono::system_clock::now();
+	vector<Json::Value> jobReports(jobs.size());
+	atomic<size_t> nextJob(0);
+	mutex logMutex;
+
+	auto worker = [&]() {
+		while (true) {
+			const auto jobIndex = nextJob++;
+			if (jobIndex >= jobs.size()) {
+				break;
+			}
+			const auto & job = jobs[(Json::ArrayIndex) jobIndex];
+			const auto jobMemoryLimitMB = job.isMember("memoryLimitMB")
+				? (size_t) job["memoryLimitMB"].asUInt()
+				: memoryLimitMB;
+			const auto jobReportFilename = reportFilename + ".job" + ofToString(jobIndex) + ".json";
+			ofFile::removeFile(jobReportFilename, false);
+
+			const auto jobStartTime = chrono::high_resolution_clock::now();
+			auto processResult = BatchRunner::runProcess({
+				BatchRunner::getExecutablePath()
+				, "--job"
+				, ofFilePath::getAbsolutePath(jobsFilename, false)
+				, ofToString(jobIndex)
+				, ofFilePath::getAbsolutePath(jobReportFilename, false)
+			}, jobMemoryLimitMB);
+			const auto duration = chrono::duration<double>(chrono::high_resolution_clock::now() - jobStartTime).count();
+
+			//the job writes its own report unless it crashed or was killed
+			Json::Value jobReport;
+			bool hasJobReport = false;
+			if (ofFile::doesFileExist(jobReportFilename, false)) {
+				try {
+					jobReport = BatchRunner::loadJson(jobReportFilename);
+					hasJobReport = true;
+				}
+				RULR_CATCH_ALL_TO_ERROR;
+				ofFile::removeFile(jobReportFilename, false);
+			}
+			if (!hasJobReport) {
+				jobReport["name"] = job["name"];
+				jobReport["patch"] = job["patch"];
+				jobReport["success"] = false;
+				jobReport["error"] = processResult.launched
+					? "Job process ended without writing a report (crashed or exceeded its memory limit)"
+					: "Couldn't launch job process";
+			}
+			jobReport["exitCode"] = processResult.exitCode;
+			jobReport["duration"] = duration;
+			jobReport["peakMemoryMB"] = (Json::UInt64) processResult.peakMemoryMB;
+			jobReport["memoryLimitMB"] = (Json::UInt64) jobMemoryLimitMB;
+			jobReports[jobIndex] = jobReport;
+
+			lock_guard<mutex> lock(logMutex);
+			ofLogNotice("BatchRunner") << "[" << (jobIndex + 1) << "/" << jobs.size() << "] " << job["name"].asString()
+				<< (jobReport["success"].asBool() ? " succeeded" : " failed") << " in " << duration << "s";
+		}
+	};
+
+	vector<thread> threads;
+	for (size_t i = 0; i < threadCount; i++) {
+		threads.emplace_back(worker);
+	}
+	for (auto & workerThread : threads) {
+		workerThread.join();
+	}
+
+	Json::Value report;
+	report["jobsFile"] = ofFilePath::getAbsolutePath(jobsFilename, false);
+	report["threads"] = (Json::UInt64) threadCount;
+	report["duration"] = chrono::duration<double>(chrono::system_clock::now() - startTime).count();
+	size_t failedCount = 0;
+	for (const auto & jobReport : jobReports) {
+		report["jobs"].append(jobReport);
+		if (!jobReport["success"].asBool()) {
+			failedCount++;
+		}
+	}
+	report["failedCount"] = (Json::UInt64) failedCount;
+	BatchRunner::saveJson(report, reportFilename);
+
+	ofLogNotice("BatchRunner") << (jobs.size() - failedCount) << " of " << jobs.size() << " jobs succeeded. Report written to [" << reportFilename << "]";
+	return failedCount == 0 ? 0 : 1;
+}
+
+//----------
+int BatchRunner::runJob(const string & jobsFilename, size_t jobIndex, const string & reportFilename) {
+	Json::Value report;
+	bool success = true;
+
+	try {
+		const auto jobsJson = BatchRunner::loadJson(jobsFilename);
+		const auto & job = jobsJson["jobs"][(Json::ArrayIndex) jobIndex];
+		if (job.isNull()) {
+			throw(ofxRulr::Exception("Job " + ofToString(jobIndex) + " not found in [" + jobsFilename + "]"));
+		}
+		report["name"] = job["name"];
+		report["patch"] = job["patch"];
+
+		//no window and no GL context, nodes mustn't draw
+		ofSetupOpenGL(make_shared<ofAppNoWindow>(), 1, 1, OF_WINDOW);
+
+		//the patch and node files are loaded relative to the data path
+		if (job.isMember("patch")) {
+			auto patchPath = job["patch"].asString();
+			if (!ofFilePath::isAbsolute(patchPath)) {
+				patchPath = ofFilePath::join(ofFilePath::getEnclosingDirectory(jobsFilename, false), patchPath);
+			}
+			ofSetDataPathRoot(ofFilePath::addTrailingSlash(patchPath));
+		}
+
+		ofxRulr::Nodes::loadCoreNodes();
+#ifdef TARGET_WIN32
+		ofxRulr::Nodes::loadPluginNodes();
+#endif
+
+		auto & world = ofxRulr::Graph::World::X();
+		world.add(MAKE(ofxRulr::Graph::Editor::Patch));
+		world.initHeadless();
+
+		if (job.isMember("patch")) {
+			const auto startTime = chrono::high_resolution_clock::now();
+			world.loadAll();
+			report["loadDuration"] = chrono::duration<double>(chrono::high_resolution_clock::now() - startTime).count();
+		}
+
+		//nodes given in the job itself
+		for (const auto & nodeJson : job["nodes"]) {
+			world.getPatch()->addNodeHost(ofxRulr::Graph::FactoryRegister::X().make(nodeJson));
+		}
+
+		for (const auto & actionJson : job["actions"]) {
+			Json::Value actionReport;
+			actionReport["node"] = actionJson["node"];
+			actionReport["action"] = actionJson["action"];
+
+			const auto startTime = chrono::high_resolution_clock::now();
+			try {
+				auto node = world.findNode(actionJson["node"].asString());
+				if (!node) {
+					throw(ofxRulr::Exception("Node [" + actionJson["node"].asString() + "] not found in patch"));
+				}
+				node->runAction(actionJson["action"].asString(), actionReport["results"]);
+				actionReport["success"] = true;
+			}
+			catch (const std::exception & e) {
+				actionReport["success"] = false;
+				actionReport["error"] = e.what();
+				success = false;
+			}
+			actionReport["duration"] = chrono::duration<double>(chrono::high_resolution_clock::now() - startTime).count();
+			report["actions"].append(actionReport);
+
+			//later actions often depend on earlier ones
+			if (!success && !job["continueOnError"].asBool()) {
+				break;
+			}
+		}
+
+		if (success && job["save"].asBool()) {
+			world.saveAll();
+		}
+	}
+	catch (const std::exception & e) {
+		report["error"] = e.what();
+		success = false;
+	}
+
+	report["success"] = success;
+	BatchRunner::saveJson(report, reportFilename);
+
+	return success ? 0 : 1;
+}
+
+//----------
+int BatchRunner::runSelfTest() {
+	Json::Value job;
+	job["name"] = "Self test";
+	{
+		Json::Value nodeJson;
+		nodeJson["NodeTypeName"] = "Test::BenchmarkRigidBody";
+		nodeJson["Name"] = "Benchmark RigidBody";
+		job["nodes"].append(nodeJson);
+	}
+	{
+		Json::Value actionJson;
+		actionJson["node"] = "Benchmark RigidBody";
+		actionJson["action"] = "Benchmark";
+		job["actions"].append(actionJson);
+	}
+	Json::Value jobsJson;
+	jobsJson["jobs"].append(job);
+
+	//run it in its own process like any other batch
+	const auto jobsFilename = ofFilePath::join(Poco::Path::temp(), "RulrSelfTest.json");
+	const auto reportFilename = ofFilePath::removeExt(jobsFilename) + ".report.json";
+	BatchRunner::saveJson(jobsJson, jobsFilename);
+	BatchRunner::runBatch(jobsFilename, reportFilename, 1, 0);
+
+	//the action must have written its results, not just returned
+	const auto report = BatchRunner::loadJson(reportFilename);
+	const auto & actionReport = report["jobs"][(Json::ArrayIndex) 0]["actions"][(Json::ArrayIndex) 0];
+	if (!actionReport["success"].asBool() || !actionReport["results"].isMember("cached")) {
+		ofLogError("BatchRunner") << "Self test failed. Report written to [" << reportFilename << "]";
+		return 1;
+	}
+
+	ofLogNotice("BatchRunner") << "Self test passed";
+	return 0;
+}
+
+//----------
+BatchRunner::ProcessResult BatchRunner::runProcess(const vector<string> & arguments, size_t memoryLimitMB) {
+	ProcessResult result;
+
+#ifdef TARGET_WIN32
+	string commandLine;
+	for (const auto & argument : arguments) {
+		commandLine += "\"" + argument + "\" ";
+	}
+
+	//the job object caps the memory of the process and kills it if we go away
+	auto jobObject = CreateJobObjectA(NULL, NULL);
+	if (!jobObject) {
+		return result;
+	}
+	{
+		JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits = { 0 };
+		limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+		if (memoryLimitMB > 0) {
+			limits.BasicLimitInformation.LimitFlags |= JOB_OBJECT_LIMIT_PROCESS_MEMORY;
+			limits.ProcessMemoryLimit = memoryLimitMB * 1024 * 1024;
+		}
+		SetInformationJobObject(jobObject, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+	}
+
+	STARTUPINFOA startupInfo = { 0 };
+	startupInfo.cb = sizeof(startupInfo);
+	PROCESS_INFORMATION processInformation = { 0 };
+
+	//start suspended so that the limits apply before it allocates anything
+	if (CreateProcessA(NULL, &commandLine[0], NULL, NULL, FALSE, CREATE_SUSPENDED, NULL, NULL, &startupInfo, &processInformation)) {
+		AssignProcessToJobObject(jobObject, processInformation.hProcess);
+		ResumeThread(processInformation.hThread);
+		result.launched = true;
+
+		WaitForSingleObject(processInformation.hProcess, INFINITE);
+
+		DWORD exitCode = 0;
+		GetExitCodeProcess(processInformation.hProcess, &exitCode);
+		result.exitCode = (int) exitCode;
+
+		JOBOBJECT_EXTENDED_LIMIT_INFORMATION usage = { 0 };
+		if (QueryInformationJobObject(jobObject, JobObjectExtendedLimitInformation, &usage, sizeof(usage), NULL)) {
+			result.peakMemoryMB = usage.PeakProcessMemoryUsed / (1024 * 1024);
+		}
+
+		CloseHandle(processInformation.hThread);
+		CloseHandle(processInformation.hProcess);
+	}
+	CloseHandle(jobObject);
+#else
+	vector<char *> argv;
+	for (const auto & argument : arguments) {
+		argv.push_back(const_cast<char *>(argument.c_str()));
+	}
+	argv.push_back(nullptr);
+
+	auto processID = fork();
+	if (processID == 0) {
+		//child
+		if (memoryLimitMB > 0) {
+			struct rlimit limit;
+			limit.rlim_cur = limit.rlim_max = (rlim_t) memoryLimitMB * 1024 * 1024;
+			setrlimit(RLIMIT_AS, &limit);
+		}
+		execv(argv[0], argv.data());
+		_exit(127);
+	}
+	else if (processID > 0) {
+		result.launched = true;
+
+		int status = 0;
+		struct rusage usage;
+		if (wait4(processID, &status, 0, &usage) == processID) {
+			result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#ifdef TARGET_OSX
+			result.peakMemoryMB = usage.ru_maxrss / (1024 * 1024); // bytes
+#else
+			result.peakMemoryMB = usage.ru_maxrss / 1024; // kilobytes
+#endif
+		}
+	}
+#endif
+
+	return result;
+}
+
+//----------
+string BatchRunner::getExecutablePath() {
+#ifdef TARGET_WIN32
+	char path[MAX_PATH];
+	GetModuleFileNameA(NULL, path, MAX_PATH);
+	return string(path);
+#elif defined(TARGET_OSX)
+	char path[PATH_MAX];
+	uint32_t size = sizeof(path);
+	_NSGetExecutablePath(path, &size);
+	return string(path);
+#else
+	char path[PATH_MAX];
+	auto length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+	path[max(length, (ssize_t) 0)] = 0;
+	return string(path);
+#endif
+}
+
+//----------
+Json::Value BatchRunner::loadJson(const string & filename) {
+	ofFile input;
+	if (!input.open(filename, ofFile::ReadOnly, false)) {
+		throw(ofxRulr::Exception("Couldn't open [" + filename + "]"));
+	}
+	string jsonRaw = input.readToBuffer().getText();
+
+	Json::Reader reader;
+	Json::Value json;
+	if (!reader.parse(jsonRaw, json)) {
+		throw(ofxRulr::Exception("Couldn't parse [" + filename + "] : " + reader.getFormattedErrorMessages()));
+	}
+	return json;
+}
+
+//----------
+void BatchRunner::saveJson(const Json::Value & json, const string & filename) {
+	Json::StyledWriter writer;
+	ofFile output;
+	output.open(filename, ofFile::WriteOnly, false);
+	output << writer.write(json);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxRulr.h"
+
+///Re-runs node actions (e.g. "Calibrate") over archived patches without a window or GL context.
+///
+///	Rulr --batch jobs.json [--report report.json] [--threads N] [--memory-limit MB]
+///	Rulr --self-test
+///
+///jobs.json :
+///	{
+///		"threads" : 0,
+///		"memoryLimitMB" : 4096,
+///		"jobs" : [
+///			{
+///				"name" : "Show 2017",
+///				"patch" : "D:/Archive/Show2017/data",
+///				"actions" : [
+///					{ "node" : "Camera Intrinsics", "action" : "Calibrate" },
+///					{ "node" : "Projector From Graycode", "action" : "Calibrate" }
+///				],
+///				"save" : false, // save the patch after the actions succeed
+///				"continueOnError" : false, // run the remaining actions after one fails
+///				"memoryLimitMB" : 8192
+///			},
+///			{
+///				"name" : "Benchmark",
+///				"nodes" : [ // added to the patch, in the same format as in a saved patch (the patch folder is optional)
+///					{ "NodeTypeName" : "Test::BenchmarkRigidBody", "Name" : "Benchmark RigidBody" }
+///				],
+///				"actions" : [
+///					{ "node" : "Benchmark RigidBody", "action" : "Benchmark" }
+///				]
+///			}
+///		]
+///	}
+///
+///Each job runs in its own process (Rulr --job jobs.json <index> <report>) with its memory capped, so a job which
+///crashes or runs out of memory doesn't take the others down, and jobs run concurrently across cores.
+///The report lists each job's exit code, duration and peak memory, and each action's duration and results (e.g. residuals).
+///
+///--self-test runs a job like the second one above through the same path, and fails unless the action wrote its results.
+class BatchRunner {
+public:
+	///Returns true and sets exitCode if the arguments asked for a batch run or a job
+	static bool run(const vector<string> & arguments, int & exitCode);
+protected:
+	struct ProcessResult {
+		bool launched = false;
+		int exitCode = -1;
+		size_t peakMemoryMB = 0;
+	};
+
+	static int runBatch(const string & jobsFilename, string reportFilename, size_t threadCount, size_t memoryLimitMB);
+	static int runJob(const string & jobsFilename, size_t jobIndex, const string & reportFilename);
+	static int runSelfTest();
+
+	static ProcessResult runProcess(const vector<string> & arguments, size_t memoryLimitMB);
+	static string getExecutablePath();
+
+	static Json::Value loadJson(const string & filename);
+	static void saveJson(const Json::Value &, const string & filename);
+};
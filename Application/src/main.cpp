@@ -1,8 +1,17 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "BatchRunner.h"
 
 //========================================================================
-int main() {
+int main(int argc, char * argv[]) {
+	//headless batch runs (see BatchRunner.h)
+	{
+		int exitCode;
+		if (BatchRunner::run(vector<string>(argv + 1, argv + argc), exitCode)) {
+			return exitCode;
+		}
+	}
+
 	ofGLFWWindowSettings windowSettings;
 	windowSettings.setGLVersion(RULR_GL_VERSION_MAJOR, RULR_GL_VERSION_MINOR);
 	windowSettings.width = 1920;
@@ -15,3 +15,4 @@
 #include "ofxRulr/Utils/Graphics.h"
 #include "ofxRulr/Utils/ScopedProcess.h"
 #include "ofxRulr/Utils/Utils.h"
+#include "ofxRulr/Utils/WorldBatch.h"
@@ -5,6 +5,7 @@
 #include "opencv2/core/core.hpp"
 
 #include "ofxRulr/Utils/Constants.h"
+#include "ofxRulr/Utils/Utils.h"
 #include "ofxMachineVision/Constants.h"
 
 #ifndef __func__
@@ -47,7 +48,7 @@ namespace ofxRulr {
 	catch (std::exception e) { X; }
 
 #define RULR_CATCH_ALL_TO_ALERT \
-	RULR_CATCH_ALL_TO(ofSystemAlertDialog(e.what()))
+	RULR_CATCH_ALL_TO(ofxRulr::Utils::alert(e.what()))
 
 #define RULR_CATCH_ALL_TO_ERROR \
 	RULR_CATCH_ALL_TO(ofLogError("ofxRulr") << e.what())
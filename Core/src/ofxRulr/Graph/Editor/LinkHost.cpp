@@ -24,12 +24,37 @@ namespace ofxRulr {
 
 			//---------
 			void LinkHost::updateBounds() {
-				ofRectangle bounds(this->getSourcePinPosition(), this->getTargetPinPosition());
-				bounds.x -= 10;
-				bounds.y -= 10;
-				bounds.width += 20;
-				bounds.height += 20;
-				this->setBounds(bounds);
+				try {
+					const auto sourcePinPosition = this->getSourcePinPosition();
+					const auto targetPinPosition = this->getTargetPinPosition();
+					if (this->wireValid && sourcePinPosition == this->wireSource && targetPinPosition == this->wireTarget) {
+						return;
+					}
+
+					const auto wireRigidity = ofVec2f(100, 0);
+					ofPolyline wire;
+					wire.addVertex(sourcePinPosition);
+					wire.bezierTo(sourcePinPosition + wireRigidity, targetPinPosition - wireRigidity, targetPinPosition, 40);
+
+					this->wire.clear();
+					this->wire.setMode(OF_PRIMITIVE_LINE_STRIP);
+					this->wire.addVertices(wire.getVertices());
+					this->wireSource = sourcePinPosition;
+					this->wireTarget = targetPinPosition;
+					this->wireValid = true;
+
+					//the bezier bulges past the pins horizontally
+					auto bounds = wire.getBoundingBox();
+					bounds.x -= 10;
+					bounds.y -= 10;
+					bounds.width += 20;
+					bounds.height += 20;
+					this->setBounds(bounds);
+				}
+				catch (ofxRulr::Exception e) {
+					this->wireValid = false;
+					ofLogError("ofxRulr::Graph::Editor::LinkHost::updateBounds()") << e.what();
+				}
 			}
 			
 			//---------
@@ -45,50 +70,41 @@ namespace ofxRulr {
 
 			//---------
 			void LinkHost::callbackDraw(ofxCvGui::DrawArguments & args) {
-				try {
-					const ofVec2f sourcePinPosition = this->getSourcePinPosition();
-					const ofVec2f targetPinPosition = this->getTargetPinPosition();
+				if (!this->wireValid) {
+					return;
+				}
 
-					//move from local to patch space
-					ofPushMatrix();
-					{
-						ofTranslate(-this->getBoundsInParent().getTopLeft());
+				//move from local to patch space
+				ofPushMatrix();
+				{
+					ofTranslate(-this->getBoundsInParent().getTopLeft());
 
-						const auto wireRigidity = ofVec2f(100, 0);
-						ofPolyline wire;
-						wire.addVertex(sourcePinPosition);
-						wire.bezierTo(sourcePinPosition + wireRigidity, targetPinPosition - wireRigidity, targetPinPosition, 40);
+					ofPushStyle();
+					{
 
-						ofPushStyle();
+						//shadow
+						ofPushMatrix();
 						{
-
-							//shadow
-							ofPushMatrix();
-							{
-								ofTranslate(5.0f, 5.0f);
-								ofSetLineWidth(2.0f);
-								ofSetColor(0, 100);
-								wire.draw();
-							}
-							ofPopMatrix();
-
-							//outline
-							ofSetLineWidth(3.0f);
-							ofSetColor(0);
-							wire.draw();
-
-							//line
+							ofTranslate(5.0f, 5.0f);
 							ofSetLineWidth(2.0f);
-							ofSetColor(this->getColor());
-							wire.draw();
+							ofSetColor(0, 100);
+							this->wire.draw();
 						}
-						ofPopStyle();
+						ofPopMatrix();
+
+						//outline
+						ofSetLineWidth(3.0f);
+						ofSetColor(0);
+						this->wire.draw();
+
+						//line
+						ofSetLineWidth(2.0f);
+						ofSetColor(this->getColor());
+						this->wire.draw();
 					}
-					ofPopMatrix();
-				}
-				catch (ofxRulr::Exception e) {
-					ofLogError("ofxRulr::Graph::Editor::LinkHost::draw()") << e.what();
+					ofPopStyle();
 				}
+				ofPopMatrix();
 			}
 
 			//---------
@@ -120,10 +136,7 @@ namespace ofxRulr {
 			//---------
 			void TemporaryLinkHost::setCursorPosition(const ofVec2f & cursorPosition) {
 				this->cursorPosition = cursorPosition;
-				auto targetNode = this->targetNode.lock();
-				if (targetNode) {
-					this->setBounds(ofRectangle(cursorPosition, targetNode->getOutputPinPositionGlobal()));
-				}
+				this->updateBounds();
 			}
 
 			//---------
@@ -10,7 +10,7 @@ namespace ofxRulr {
 				typedef unsigned int Index;
 				LinkHost();
 				bool isValid() const;
-				void updateBounds(); //ideally can be called from listener instead of every frame
+				void updateBounds(); //rebuilds the wire only when a pin has moved
 				ofColor getColor() const;
 			protected:
 				void callbackDraw(ofxCvGui::DrawArguments &);
@@ -19,6 +19,11 @@ namespace ofxRulr {
 				weak_ptr<NodeHost> sourceNode;
 				weak_ptr<NodeHost> targetNode;
 				weak_ptr<AbstractPin> targetPin;
+
+				ofVboMesh wire; // in patch space
+				ofVec2f wireSource;
+				ofVec2f wireTarget;
+				bool wireValid = false;
 			};
 
 			class TemporaryLinkHost : public LinkHost {
@@ -1,6 +1,8 @@
 #include "pch_RulrCore.h"
 #include "NodeHost.h"
 
+#include "ofxRulr/Utils/Utils.h"
+
 using namespace ofxAssets;
 
 namespace ofxRulr {
@@ -9,6 +11,13 @@ namespace ofxRulr {
 			//----------
 			NodeHost::NodeHost(shared_ptr<Nodes::Base> node) {
 				node->setNodeHost(this);
+				this->node = node;
+
+				//without a gui we only keep the node and its bounds (e.g. for saving the patch)
+				if (Utils::isHeadless()) {
+					this->setBounds(ofRectangle(200, 200, 200, 200));
+					return;
+				}
 
 				/*
 				The NodeHost Gui element is a tree of elements:
@@ -26,7 +35,6 @@ namespace ofxRulr {
 
 				ofxCvGui::ElementPtr title;
 
-				this->node = node;
 				this->nodeView = node->getPanel();
 				//check if this node has a view
 				if (nodeView) {
@@ -1,6 +1,7 @@
 #include "pch_RulrCore.h"
 #include "Patch.h"
 #include "ofxRulr/Utils/ScopedProcess.h"
+#include "ofxRulr/Utils/Utils.h"
 
 #include "ofxCvGui/Widgets/Button.h"
 
@@ -46,11 +47,15 @@ namespace ofxRulr {
 				this->getCanvasElementGroup()->onDraw.addListener([this](ofxCvGui::DrawArguments & args) {
 					this->drawGridLines();
 				}, this, -1);
+				this->getCanvasElementGroup()->onDraw.addListener([this](ofxCvGui::DrawArguments & args) {
+					this->drawCollapsedNodeHosts();
+				}, this, -1);
 
 				this->onUpdate += [this](ofxCvGui::UpdateArguments &) {
 					if (this->dirty) {
 						this->rebuild();
 					}
+					this->updateVisibility();
 				};
 				this->onKeyboard += [this](ofxCvGui::KeyboardArguments & args) {
 					if (args.action == ofxCvGui::KeyboardArguments::Action::Pressed) {
@@ -101,16 +106,24 @@ namespace ofxRulr {
 				this->dirty = true;
 			}
 
+			//----------
+			void Patch::View::markIndexDirty() {
+				this->indexDirty = true;
+			}
+
 			//----------
 			void Patch::View::rebuild() {
+				//node and link hosts start disabled, updateVisibility enables the ones in view
 				this->canvasElements->clear();
 				const auto & nodeHosts = this->patchInstance.getNodeHosts();
 				for (const auto & it : nodeHosts) {
+					it.second->setEnabled(false);
 					this->canvasElements->add(it.second);
 				}
 
 				const auto & linkHosts = this->patchInstance.getLinkHosts();
 				for (const auto & it : linkHosts) {
+					it.second->setEnabled(false);
 					this->canvasElements->add(it.second);
 				}
 
@@ -118,6 +131,83 @@ namespace ofxRulr {
 				if (newLink) {
 					this->canvasElements->add(newLink);
 				}
+
+				this->enabledElements.clear();
+				this->indexDirty = true;
+				this->dirty = false;
+			}
+
+			//----------
+			void Patch::View::rebuildIndex() {
+				this->spatialIndex.clear();
+				for (const auto & it : this->patchInstance.getNodeHosts()) {
+					this->spatialIndex.add(it.second);
+				}
+				for (const auto & it : this->patchInstance.getLinkHosts()) {
+					//disabled link hosts don't update themselves
+					it.second->updateBounds();
+					this->spatialIndex.add(it.second);
+				}
+				this->indexDirty = false;
+			}
+
+			//----------
+			void Patch::View::updateVisibility() {
+				if (this->indexDirty) {
+					this->rebuildIndex();
+				}
+
+				//level of detail : draw the nodes as plain boxes whilst the canvas is moving
+				const auto scrollPosition = this->getScrollPosition();
+				const auto now = ofGetElapsedTimef();
+				if (scrollPosition != this->lastScrollPosition) {
+					this->lastScrollPosition = scrollPosition;
+					this->lastScrollTime = now;
+				}
+				const bool collapsed = this->patchInstance.parameters.collapseWhilePanning
+					&& now - this->lastScrollTime < 0.25f;
+
+				vector<ofxCvGui::ElementPtr> visibleElements;
+				if (this->patchInstance.parameters.culling) {
+					this->spatialIndex.query(this->getViewportInCanvas(), visibleElements);
+				}
+				else {
+					visibleElements = this->spatialIndex.getElements();
+				}
+
+				vector<ofxCvGui::ElementPtr> enabledElements;
+				enabledElements.reserve(visibleElements.size());
+				this->collapsedNodeHosts.clear();
+				for (const auto & element : visibleElements) {
+					if (collapsed) {
+						auto nodeHost = dynamic_pointer_cast<NodeHost>(element);
+						if (nodeHost) {
+							this->collapsedNodeHosts.push_back(nodeHost);
+							continue;
+						}
+					}
+					enabledElements.push_back(element);
+				}
+
+				//only touch the elements which changed state
+				if (enabledElements != this->enabledElements) {
+					for (const auto & element : this->enabledElements) {
+						element->setEnabled(false);
+					}
+					for (const auto & element : enabledElements) {
+						element->setEnabled(true);
+					}
+					this->enabledElements = move(enabledElements);
+				}
+			}
+
+			//----------
+			ofRectangle Patch::View::getViewportInCanvas() {
+				//include a margin for shadows and the output pins
+				const auto margin = 50.0f;
+				return ofRectangle(this->getScrollPosition() - ofVec2f(margin, margin)
+					, this->getWidth() + margin * 2.0f
+					, this->getHeight() + margin * 2.0f);
 			}
 
 			//----------
@@ -151,10 +241,43 @@ namespace ofxRulr {
 				ofPopStyle();
 			}
 
+			//----------
+			void Patch::View::drawCollapsedNodeHosts() {
+				if (this->collapsedNodeHosts.empty()) {
+					return;
+				}
+
+				ofPushStyle();
+				{
+					ofFill();
+					for (const auto & nodeHost : this->collapsedNodeHosts) {
+						const auto bounds = nodeHost->getBounds();
+						auto node = nodeHost->getNodeInstance();
+
+						ofSetColor(80);
+						ofDrawRectangle(bounds);
+
+						ofSetColor(node->getColor());
+						ofDrawRectangle(bounds.x, bounds.y, bounds.width, 4);
+
+						ofSetColor(255);
+						ofDrawBitmapString(node->getName(), bounds.x + 10, bounds.y + 24);
+					}
+				}
+				ofPopStyle();
+			}
+
 			//----------
 			shared_ptr<NodeHost> Patch::View::getNodeHostUnderCursor(const ofVec2f & cursorInCanvas) {
+				if (this->indexDirty) {
+					this->rebuildIndex();
+				}
+
+				vector<ofxCvGui::ElementPtr> elements;
+				this->spatialIndex.query(ofRectangle(cursorInCanvas - ofVec2f(1, 1), 2, 2), elements);
+
 				shared_ptr<NodeHost> nodeUnderCursor;
-				for (shared_ptr<Element> element : this->getCanvasElementGroup()->getElements()) {
+				for (const auto & element : elements) {
 					auto asNodeHost = dynamic_pointer_cast<NodeHost>(element);
 					if (asNodeHost) {
 						if (element->getBounds().inside(cursorInCanvas)) {
@@ -199,12 +322,17 @@ namespace ofxRulr {
 
 			//----------
 			void Patch::init() {
-				this->view = MAKE(View, *this);
+				//the view and the link hosts are only for the gui (e.g. not in a batch job)
+				if (!Utils::isHeadless()) {
+					this->view = MAKE(View, *this);
+				}
 
 				RULR_NODE_UPDATE_LISTENER;
 				RULR_NODE_DRAW_WORLD_LISTENER;
 				RULR_NODE_SERIALIZATION_LISTENERS;
 				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->manageParameters(this->parameters);
 			}
 
 			//----------
@@ -244,7 +372,7 @@ namespace ofxRulr {
 				}
 
 				auto & canvasJson = json["Canvas"];
-				canvasJson["Scroll"] << this->view->getScrollPosition();
+				canvasJson["Scroll"] << (this->view ? this->view->getScrollPosition() : this->headlessScrollPosition);
 			}
 
 			//----------
@@ -256,7 +384,12 @@ namespace ofxRulr {
 				const auto & canvasJson = json["Canvas"];
 				ofVec2f canvasScrollPosiition;
 				canvasJson["Scroll"] >> canvasScrollPosiition;
-				this->view->setScrollPosition(canvasScrollPosiition);
+				if (this->view) {
+					this->view->setScrollPosition(canvasScrollPosiition);
+				}
+				else {
+					this->headlessScrollPosition = canvasScrollPosiition;
+				}
 			}
 
 			//----------
@@ -334,7 +467,9 @@ namespace ofxRulr {
 				}
 
 				this->rebuildLinkHosts();
-				this->view->markDirty();
+				if (this->view) {
+					this->view->markDirty();
+				}
 				scopedProcess.end();
 			}
 
@@ -378,14 +513,25 @@ namespace ofxRulr {
 
 			//----------
 			void Patch::rebuildLinkHosts() {
+				if (!this->view) {
+					return;
+				}
+
+				//look up hosts by node once rather than searching for each link
+				map<shared_ptr<Nodes::Base>, shared_ptr<NodeHost>> nodeHostsByNode;
+				for (const auto & nodeHost : this->nodeHosts) {
+					nodeHostsByNode.emplace(nodeHost.second->getNodeInstance(), nodeHost.second);
+				}
+
 				this->linkHosts.clear();
 				for (auto targetNodeHost : this->nodeHosts) {
 					auto targetNode = targetNodeHost.second->getNodeInstance();
 					for (auto targetPin : targetNode->getInputPins()) {
 						if (targetPin->isConnected()) {
 							auto sourceNode = targetPin->getConnectionUntyped();
-							auto sourceNodeHost = this->findNodeHost(sourceNode);
-							if (sourceNodeHost) {
+							auto findSourceNodeHost = nodeHostsByNode.find(sourceNode);
+							if (findSourceNodeHost != nodeHostsByNode.end()) {
+								auto sourceNodeHost = findSourceNodeHost->second;
 								auto observedLinkHost = make_shared<ObservedLinkHost>(sourceNodeHost, targetNodeHost.second, targetPin);
 								auto linkHost = dynamic_pointer_cast<LinkHost>(observedLinkHost);
 								this->linkHosts.insert(pair <LinkHost::Index, shared_ptr<LinkHost>>(this->getNextFreeLinkHostIndex(), linkHost));
@@ -393,6 +539,17 @@ namespace ofxRulr {
 						}
 					}
 				}
+				this->view->markDirty();
+			}
+
+			//----------
+			void Patch::setCullingEnabled(bool cullingEnabled) {
+				this->parameters.culling = cullingEnabled;
+			}
+
+			//----------
+			void Patch::setCollapseWhilePanning(bool collapseWhilePanning) {
+				this->parameters.collapseWhilePanning = collapseWhilePanning;
 			}
 
 			//----------
@@ -443,10 +600,17 @@ namespace ofxRulr {
 				nodeHost->onDropInputConnection += [this](const shared_ptr<AbstractPin> &) {
 					this->view->markDirty();
 				};
+				nodeHost->onBoundsChange += [this](ofxCvGui::BoundsChangeArguments &) {
+					if (this->view) {
+						this->view->markIndexDirty();
+					}
+				};
 				nodeHost->getNodeInstance()->onAnyInputConnectionChanged += [this]() {
 					this->rebuildLinkHosts();
 				};
-				this->view->markDirty();
+				if (this->view) {
+					this->view->markDirty();
+				}
 			}
 			
 			//----------
@@ -454,6 +618,15 @@ namespace ofxRulr {
 				this->addNodeHost(nodeHost, this->getNextFreeNodeHostIndex());
 			}
 			
+			//----------
+			void Patch::clear() {
+				this->nodeHosts.clear();
+				this->rebuildLinkHosts();
+				if (this->view) {
+					this->view->markDirty();
+				}
+			}
+
 			//----------
 			void Patch::deleteSelection() {
 				auto selection = this->selection.lock();
@@ -554,9 +727,7 @@ namespace ofxRulr {
 				auto inspector = inspectArguments.inspector;
 				
 				inspector->addButton("Clear patch", [this]() {
-					this->nodeHosts.clear();
-					this->rebuildLinkHosts();
-					this->view->markDirty();
+					this->clear();
 				});
 				
 				inspector->add(new Widgets::Button("Duplicate patch down", [this]() {
@@ -594,6 +765,7 @@ namespace ofxRulr {
 			//----------
 			void Patch::callbackBeginMakeConnection(shared_ptr<NodeHost> targetNodeHost, shared_ptr<AbstractPin> targetPin) {
 				this->newLink = make_shared<TemporaryLinkHost>(targetNodeHost, targetPin);
+				this->view->markDirty();
 			}
 
 			//----------
@@ -3,6 +3,7 @@
 #include "NodeHost.h"
 #include "LinkHost.h"
 #include "NodeBrowser.h"
+#include "SpatialIndex.h"
 
 #include "ofxRulr/Nodes/Base.h"
 #include "ofxRulr/Graph/FactoryRegister.h"
@@ -21,6 +22,7 @@ namespace ofxRulr {
 					View(Patch &);
 					//const shared_ptr<ofxCvGui::Panels::Base> findScreen(const ofVec2f & xy, ofRectangle & currentPanelBounds) override;
 					void markDirty();
+					void markIndexDirty();
 
 					shared_ptr<NodeHost> getNodeHostUnderCursor(const ofVec2f & cursorInCanvas);
 					shared_ptr<NodeHost> getNodeHostUnderCursor();
@@ -28,15 +30,27 @@ namespace ofxRulr {
 					const ofxCvGui::PanelPtr findScreen(const ofVec2f & xy, ofRectangle & currentPanelBounds) override;
 				protected:
 					void rebuild();
+					void rebuildIndex();
+					void updateVisibility();
+					ofRectangle getViewportInCanvas();
 
 					ofVec2f lastCursorPositionInCanvas;
 					void drawGridLines();
+					void drawCollapsedNodeHosts();
 					Patch & patchInstance;
 					shared_ptr<NodeBrowser> nodeBrowser;
 					ofVec2f birthLocation;
 
 					shared_ptr<ofTexture> cell;
 					bool dirty = true;
+
+					SpatialIndex spatialIndex; // node hosts then link hosts
+					bool indexDirty = true;
+					vector<ofxCvGui::ElementPtr> enabledElements; // all other node and link hosts are disabled
+					vector<shared_ptr<NodeHost>> collapsedNodeHosts;
+
+					ofVec2f lastScrollPosition;
+					float lastScrollTime = -1.0f;
 				};
 				Patch();
 				virtual ~Patch();
@@ -53,6 +67,8 @@ namespace ofxRulr {
 				void drawWorldStage();
 
 				void rebuildLinkHosts();
+				void setCullingEnabled(bool);
+				void setCollapseWhilePanning(bool);
 				const NodeHostSet & getNodeHosts() const;
 				const LinkHostSet & getLinkHosts() const;
 
@@ -63,6 +79,7 @@ namespace ofxRulr {
 				void addNodeHost(shared_ptr<NodeHost>, int index);
 				void addNodeHost(shared_ptr<NodeHost>);
 
+				void clear();
 				void deleteSelection();
 				void cut();
 				void copy();
@@ -79,9 +96,16 @@ namespace ofxRulr {
 				void callbackBeginMakeConnection(shared_ptr<NodeHost> targetNodeHost, shared_ptr<AbstractPin> targetPin);
 				void callbackReleaseMakeConnection(ofxCvGui::MouseArguments &);
 
+				struct : ofParameterGroup {
+					ofParameter<bool> culling{ "Cull offscreen items", true };
+					ofParameter<bool> collapseWhilePanning{ "Collapse nodes while panning", true };
+					PARAM_DECLARE("Patch", culling, collapseWhilePanning);
+				} parameters;
+
 				NodeHostSet nodeHosts;
 				LinkHostSet linkHosts;
-				shared_ptr<View> view;
+				shared_ptr<View> view; // none when headless
+				ofVec2f headlessScrollPosition; // kept so that saving a headless patch doesn't lose the scroll
 
 				shared_ptr<TemporaryLinkHost> newLink;
 				weak_ptr<NodeHost> selection;
@@ -0,0 +1,84 @@
+#include "pch_RulrCore.h"
+#include "SpatialIndex.h"
+
+namespace ofxRulr {
+	namespace Graph {
+		namespace Editor {
+			//----------
+			SpatialIndex::SpatialIndex(float cellSize) :
+				cellSize(cellSize) {
+
+			}
+
+			//----------
+			void SpatialIndex::clear() {
+				this->elements.clear();
+				this->bounds.clear();
+				this->cells.clear();
+			}
+
+			//----------
+			void SpatialIndex::add(ofxCvGui::ElementPtr element) {
+				this->add(element, element->getBounds());
+			}
+
+			//----------
+			void SpatialIndex::add(ofxCvGui::ElementPtr element, const ofRectangle & bounds) {
+				auto index = this->elements.size();
+				this->elements.push_back(element);
+				this->bounds.push_back(bounds);
+
+				Cell min, max;
+				this->getCellRange(bounds, min, max);
+				for (int row = min.first; row <= max.first; row++) {
+					for (int column = min.second; column <= max.second; column++) {
+						this->cells[Cell(row, column)].push_back(index);
+					}
+				}
+			}
+
+			//----------
+			void SpatialIndex::query(const ofRectangle & region, vector<ofxCvGui::ElementPtr> & results) const {
+				results.clear();
+
+				Cell min, max;
+				this->getCellRange(region, min, max);
+
+				vector<size_t> indices;
+				for (int row = min.first; row <= max.first; row++) {
+					//cells are ordered by row then column, so each row of the region is one run of the map
+					auto it = this->cells.lower_bound(Cell(row, min.second));
+					for (; it != this->cells.end() && it->first.first == row && it->first.second <= max.second; it++) {
+						for (auto index : it->second) {
+							if (this->bounds[index].intersects(region)) {
+								indices.push_back(index);
+							}
+						}
+					}
+				}
+
+				//elements spanning several cells are found more than once
+				sort(indices.begin(), indices.end());
+				indices.erase(unique(indices.begin(), indices.end()), indices.end());
+
+				results.reserve(indices.size());
+				for (auto index : indices) {
+					results.push_back(this->elements[index]);
+				}
+			}
+
+			//----------
+			const vector<ofxCvGui::ElementPtr> & SpatialIndex::getElements() const {
+				return this->elements;
+			}
+
+			//----------
+			void SpatialIndex::getCellRange(const ofRectangle & region, Cell & min, Cell & max) const {
+				min.first = (int) floor(region.getTop() / this->cellSize);
+				min.second = (int) floor(region.getLeft() / this->cellSize);
+				max.first = (int) floor(region.getBottom() / this->cellSize);
+				max.second = (int) floor(region.getRight() / this->cellSize);
+			}
+		}
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ofxCvGui/Element.h"
+
+namespace ofxRulr {
+	namespace Graph {
+		namespace Editor {
+			/***
+			Uniform grid over the bounds of the patch's elements, so that the
+			view can find the elements inside a rectangle without visiting all of them.
+			Query results keep the order the elements were added in (i.e. draw order).
+			*/
+			class SpatialIndex {
+			public:
+				SpatialIndex(float cellSize = 512.0f);
+
+				void clear();
+				void add(ofxCvGui::ElementPtr);
+				void add(ofxCvGui::ElementPtr, const ofRectangle & bounds);
+
+				void query(const ofRectangle &, vector<ofxCvGui::ElementPtr> & results) const;
+				const vector<ofxCvGui::ElementPtr> & getElements() const;
+			protected:
+				typedef pair<int, int> Cell; // row, column
+				void getCellRange(const ofRectangle &, Cell & min, Cell & max) const;
+
+				float cellSize;
+				vector<ofxCvGui::ElementPtr> elements;
+				vector<ofRectangle> bounds;
+				map<Cell, vector<size_t>> cells; // element indices per cell
+			};
+		}
+	}
+}
@@ -40,23 +40,7 @@ namespace ofxRulr {
 			// INIITALISE NODES
 			//--
 			//
-			set<shared_ptr<Nodes::Base>> failedNodes;
-			for (auto node : *this) {
-				bool initSuccess = false;
-				try
-				{
-					node->init();
-					initSuccess = true;
-				}
-				RULR_CATCH_ALL_TO_ALERT
-
-				if (!initSuccess) {
-					failedNodes.insert(node);
-				}
-			}
-			for (auto failedNode : failedNodes) {
-				this->remove(failedNode);
-			}
+			this->initNodes();
 			//
 			//--
 
@@ -201,6 +185,55 @@ namespace ofxRulr {
 			}
 		}
 
+		//-----------
+		void World::initHeadless() {
+			Utils::setHeadless(true);
+			this->initNodes();
+		}
+
+		//-----------
+		shared_ptr<Nodes::Base> World::findNode(const string & name) const {
+			for (auto node : *this) {
+				if (node->getName() == name) {
+					return node;
+				}
+			}
+
+			auto patch = this->getPatch();
+			if (patch) {
+				for (const auto & it : patch->getNodeHosts()) {
+					if (it.second) {
+						auto node = it.second->getNodeInstance();
+						if (node && node->getName() == name) {
+							return node;
+						}
+					}
+				}
+			}
+			return shared_ptr<Nodes::Base>();
+		}
+
+		//-----------
+		void World::initNodes() {
+			set<shared_ptr<Nodes::Base>> failedNodes;
+			for (auto node : *this) {
+				bool initSuccess = false;
+				try
+				{
+					node->init();
+					initSuccess = true;
+				}
+				RULR_CATCH_ALL_TO_ALERT
+
+				if (!initSuccess) {
+					failedNodes.insert(node);
+				}
+			}
+			for (auto failedNode : failedNodes) {
+				this->remove(failedNode);
+			}
+		}
+
 		//-----------
 		void World::saveAll() const {
 			for(auto node : * this) {
@@ -17,6 +17,12 @@ namespace ofxRulr {
 			World();
 			virtual ~World();
 			void init(ofxCvGui::Controller &, bool enableWorldStageView = true);
+
+			///Initialise the nodes without any gui or world stage, and switch on Utils::setHeadless
+			void initHeadless();
+
+			///Find a node by name (e.g. inside the patch), returns nullptr if not found
+			shared_ptr<Nodes::Base> findNode(const string & name) const;
 			void loadAll(bool printDebug = false);
 			void saveAll() const;
 			static ofxCvGui::Controller & getGuiController();
@@ -26,6 +32,8 @@ namespace ofxRulr {
 
 			ofParameter<bool> lockSelection{ "Lock selection", false };
 		protected:
+			void initNodes();
+
 			static ofxCvGui::Controller * gui; ///< Why is this static? Needs comment.  I presume it's so we can grid multiple worlds?
 			ofxCvGui::PanelGroupPtr guiGrid;
 			chrono::system_clock::time_point lastSaveOrLoad = chrono::system_clock::now();
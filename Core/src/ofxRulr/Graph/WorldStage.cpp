@@ -32,23 +32,34 @@ namespace ofxRulr {
 					this->drawGrid();
 				}
 				if (this->world) {
-					auto & world = *this->world;
-					for (const auto node : world) {
-						const auto & whenDrawOnWorldStage = node->getWhenDrawOnWorldStage();
-						switch (whenDrawOnWorldStage) {
-						case WhenDrawOnWorldStage::Selected:
-							if (node->isBeingInspected()) {
+					//nodes add their primitives to this batch, which is drawn once all the nodes have been visited
+					this->batch.begin();
+
+					//the batch must be closed even if a node throws, or the next frame can't open it
+					try {
+						auto & world = *this->world;
+						for (const auto node : world) {
+							const auto & whenDrawOnWorldStage = node->getWhenDrawOnWorldStage();
+							switch (whenDrawOnWorldStage) {
+							case WhenDrawOnWorldStage::Selected:
+								if (node->isBeingInspected()) {
+									node->drawWorldStage();
+								}
+								break;
+							case WhenDrawOnWorldStage::Always:
 								node->drawWorldStage();
+								break;
+							case WhenDrawOnWorldStage::Never:
+							default:
+								break;
 							}
-							break;
-						case WhenDrawOnWorldStage::Always:
-							node->drawWorldStage();
-							break;
-						case WhenDrawOnWorldStage::Never:
-						default:
-							break;
 						}
 					}
+					catch (...) {
+						this->batch.end();
+						throw;
+					}
+					this->batch.end();
 				}
 			};
 			auto & camera = this->view->getCamera();
@@ -190,6 +201,15 @@ namespace ofxRulr {
 			}
 
 			inspector->addParameterGroup(this->parameters.grid);
+
+			inspector->add(new Widgets::Title("Batch", Widgets::Title::Level::H3));
+			inspector->add(new Widgets::LiveValue<string>("Points / spheres / lines", [this]() {
+				const auto & statistics = this->batch.getLastStatistics();
+				return ofToString(statistics.points) + " / " + ofToString(statistics.spheres) + " / " + ofToString(statistics.lines);
+			}));
+			inspector->add(new Widgets::LiveValue<size_t>("Draw calls", [this]() {
+				return this->batch.getLastStatistics().drawCalls;
+			}));
 		}
 
 
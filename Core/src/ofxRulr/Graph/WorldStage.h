@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Nodes/Base.h"
+#include "../Utils/WorldBatch.h"
 
 #include "ofxCvGui/Panels/World.h"
 
@@ -53,6 +54,8 @@ namespace ofxRulr {
 			ofCamera * camera = nullptr;
 			ofTexture * grid;
 			ofLight light;
+
+			Utils::WorldBatch batch;
 		};
 	}
 }
\ No newline at end of file
@@ -249,6 +249,7 @@ namespace ofxRulr {
 
 		//----------
 		void Base::manageParameters(ofParameterGroup & parameters, bool addToInspector) {
+			this->managedParameters.push_back(&parameters);
 			this->onSerialize += [&parameters](Json::Value & json) {
 				Utils::Serializable::serialize(json, parameters);
 			};
@@ -262,6 +263,34 @@ namespace ofxRulr {
 			}
 		}
 
+		//----------
+		const vector<ofParameterGroup *> & Base::getManagedParameters() const {
+			return this->managedParameters;
+		}
+
+		//----------
+		void Base::addAction(const string & name, const Action & action) {
+			this->actions[name] = action;
+		}
+
+		//----------
+		vector<string> Base::getActionNames() const {
+			vector<string> names;
+			for (const auto & action : this->actions) {
+				names.push_back(action.first);
+			}
+			return names;
+		}
+
+		//----------
+		void Base::runAction(const string & name, Json::Value & report) {
+			auto findAction = this->actions.find(name);
+			if (findAction == this->actions.end()) {
+				throw(ofxRulr::Exception("Node [" + this->getName() + "] has no action [" + name + "]"));
+			}
+			findAction->second(report);
+		}
+
 		//----------
 		void Base::addInput(shared_ptr<Graph::AbstractPin> pin) {
 			//setup events to fire on this node for this pin
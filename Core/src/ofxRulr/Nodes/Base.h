@@ -147,6 +147,14 @@ namespace ofxRulr {
 			void throwIfMissingAnyConnection() const;
 
 			void manageParameters(ofParameterGroup &, bool addToInspector = true);
+			const vector<ofParameterGroup *> & getManagedParameters() const;
+
+			///Named operations (e.g. "Calibrate") which can be run without the GUI, e.g. by the batch runner.
+			///The action can add its results (e.g. residuals) to the report.
+			typedef function<void(Json::Value & report)> Action;
+			void addAction(const string & name, const Action &);
+			vector<string> getActionNames() const;
+			void runAction(const string & name, Json::Value & report);
 
 			ofxLiquidEvent<void> onInit;
 			ofxLiquidEvent<void> onDestroy;
@@ -188,6 +196,8 @@ namespace ofxRulr {
 			shared_ptr<ofColor> color;
 
 			string name;
+			map<string, Action> actions;
+			vector<ofParameterGroup *> managedParameters;
 			bool initialized;
 			uint64_t lastFrameUpdate;
 			bool updateAllInputsFirst;
@@ -0,0 +1,1127 @@
+#include "pch_RulrCore.h"
+#include "BundleAdjuster.h"
+
+#include "ofxRulr/Exception.h"
+#include "ofxRulr/Utils/ParallelFor.h"
+
+#include <thread>
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace {
+			enum CameraParameter : size_t {
+				FocalLengthX = 0,
+				FocalLengthY,
+				PrincipalPointX,
+				PrincipalPointY,
+				K1,
+				K2,
+				P1,
+				P2,
+				K3,
+				RotationX,
+				RotationY,
+				RotationZ,
+				TranslationX,
+				TranslationY,
+				TranslationZ,
+				CameraBlockSize
+			};
+
+			const size_t IntrinsicCount = 9;
+			const size_t PoseBlockSize = 6;
+			const size_t CouplingBlockSize = CameraBlockSize * PoseBlockSize;
+
+			struct Pose {
+				double rotation[9]; // row major
+				double translation[3];
+			};
+
+			struct CameraState {
+				double intrinsics[IntrinsicCount];
+				Pose extrinsics; // camera 0 to this camera
+				bool free[CameraBlockSize];
+				bool fixAspectRatio = false;
+				double aspectRatio = 1.0; // fy / fx
+			};
+
+			struct ViewState {
+				Pose pose; // object to camera 0
+				bool fixed = false;
+			};
+
+			//normal equations of one view : the pose block, and its coupling to each camera which sees it
+			struct ViewSystem {
+				double V[PoseBlockSize * PoseBlockSize];
+				double g[PoseBlockSize];
+				vector<size_t> cameras;
+				vector<array<double, CouplingBlockSize>> W; // CameraBlockSize x PoseBlockSize per camera
+				double Vinverse[PoseBlockSize * PoseBlockSize];
+			};
+
+			struct CameraSystem {
+				double U[CameraBlockSize * CameraBlockSize];
+				double g[CameraBlockSize];
+			};
+
+#pragma mark Small linear algebra
+			//----------
+			void rotate(const double * rotation, const double * x, double * result) {
+				for (int i = 0; i < 3; i++) {
+					result[i] = rotation[i * 3 + 0] * x[0] + rotation[i * 3 + 1] * x[1] + rotation[i * 3 + 2] * x[2];
+				}
+			}
+
+			//----------
+			void transform(const Pose & pose, const double * x, double * result) {
+				rotate(pose.rotation, x, result);
+				for (int i = 0; i < 3; i++) {
+					result[i] += pose.translation[i];
+				}
+			}
+
+			//----------
+			void exponentialMap(const double * omega, double * rotation) {
+				const auto theta = sqrt(omega[0] * omega[0] + omega[1] * omega[1] + omega[2] * omega[2]);
+				double a, b;
+				if (theta < 1e-10) {
+					a = 1.0;
+					b = 0.5;
+				}
+				else {
+					a = sin(theta) / theta;
+					b = (1.0 - cos(theta)) / (theta * theta);
+				}
+				const double K[9] = {
+					0, -omega[2], omega[1],
+					omega[2], 0, -omega[0],
+					-omega[1], omega[0], 0
+				};
+				for (int i = 0; i < 3; i++) {
+					for (int j = 0; j < 3; j++) {
+						double KK = 0.0;
+						for (int k = 0; k < 3; k++) {
+							KK += K[i * 3 + k] * K[k * 3 + j];
+						}
+						rotation[i * 3 + j] = (i == j ? 1.0 : 0.0) + a * K[i * 3 + j] + b * KK;
+					}
+				}
+			}
+
+			//----------
+			///rotation <- exp(delta[0..2]) * rotation, translation += delta[3..5]
+			void applyUpdate(Pose & pose, const double * delta) {
+				double update[9];
+				exponentialMap(delta, update);
+				double rotation[9];
+				for (int i = 0; i < 3; i++) {
+					for (int j = 0; j < 3; j++) {
+						rotation[i * 3 + j] = update[i * 3 + 0] * pose.rotation[0 * 3 + j]
+							+ update[i * 3 + 1] * pose.rotation[1 * 3 + j]
+							+ update[i * 3 + 2] * pose.rotation[2 * 3 + j];
+					}
+				}
+				copy(rotation, rotation + 9, pose.rotation);
+				for (int i = 0; i < 3; i++) {
+					pose.translation[i] += delta[3 + i];
+				}
+			}
+
+			//----------
+			///In place Cholesky of a symmetric positive definite matrix (lower triangle). Returns false if not positive definite
+			bool choleskyDecompose(double * A, size_t n) {
+				for (size_t j = 0; j < n; j++) {
+					auto diagonal = A[j * n + j];
+					for (size_t k = 0; k < j; k++) {
+						diagonal -= A[j * n + k] * A[j * n + k];
+					}
+					if (!(diagonal > 0.0)) {
+						return false;
+					}
+					diagonal = sqrt(diagonal);
+					A[j * n + j] = diagonal;
+					for (size_t i = j + 1; i < n; i++) {
+						auto value = A[i * n + j];
+						for (size_t k = 0; k < j; k++) {
+							value -= A[i * n + k] * A[j * n + k];
+						}
+						A[i * n + j] = value / diagonal;
+					}
+				}
+				return true;
+			}
+
+			//----------
+			void choleskySolve(const double * L, size_t n, double * x) {
+				for (size_t i = 0; i < n; i++) {
+					auto value = x[i];
+					for (size_t k = 0; k < i; k++) {
+						value -= L[i * n + k] * x[k];
+					}
+					x[i] = value / L[i * n + i];
+				}
+				for (size_t i = n; i-- > 0; ) {
+					auto value = x[i];
+					for (size_t k = i + 1; k < n; k++) {
+						value -= L[k * n + i] * x[k];
+					}
+					x[i] = value / L[i * n + i];
+				}
+			}
+
+#pragma mark Conversions
+			//----------
+			Pose toPose(const cv::Mat & rotationVector, const cv::Mat & translation) {
+				Pose pose;
+				cv::Mat rotation;
+				if (rotationVector.empty()) {
+					rotation = cv::Mat::eye(3, 3, CV_64F);
+				}
+				else {
+					cv::Mat rotationVector64;
+					rotationVector.convertTo(rotationVector64, CV_64F);
+					cv::Rodrigues(rotationVector64, rotation);
+				}
+				for (int i = 0; i < 9; i++) {
+					pose.rotation[i] = rotation.at<double>(i / 3, i % 3);
+				}
+				for (int i = 0; i < 3; i++) {
+					pose.translation[i] = translation.empty() ? 0.0 : translation.reshape(1, 3).at<double>(i);
+				}
+				return pose;
+			}
+
+			//----------
+			void fromPose(const Pose & pose, cv::Mat & rotationVector, cv::Mat & translation) {
+				cv::Mat rotation(3, 3, CV_64F);
+				for (int i = 0; i < 9; i++) {
+					rotation.at<double>(i / 3, i % 3) = pose.rotation[i];
+				}
+				cv::Rodrigues(rotation, rotationVector);
+				translation = (cv::Mat_<double>(3, 1) << pose.translation[0], pose.translation[1], pose.translation[2]);
+			}
+
+			//----------
+			CameraState toCameraState(const BundleAdjuster::Camera & camera, bool isFirstCamera) {
+				CameraState state;
+
+				cv::Mat cameraMatrix;
+				camera.cameraMatrix.convertTo(cameraMatrix, CV_64F);
+				state.intrinsics[FocalLengthX] = cameraMatrix.at<double>(0, 0);
+				state.intrinsics[FocalLengthY] = cameraMatrix.at<double>(1, 1);
+				state.intrinsics[PrincipalPointX] = cameraMatrix.at<double>(0, 2);
+				state.intrinsics[PrincipalPointY] = cameraMatrix.at<double>(1, 2);
+
+				cv::Mat distortionCoefficients;
+				if (!camera.distortionCoefficients.empty()) {
+					camera.distortionCoefficients.reshape(1, (int) camera.distortionCoefficients.total()).convertTo(distortionCoefficients, CV_64F);
+				}
+				for (int i = 0; i < 5; i++) {
+					state.intrinsics[K1 + i] = i < distortionCoefficients.rows ? distortionCoefficients.at<double>(i) : 0.0;
+				}
+
+				if (isFirstCamera) {
+					state.extrinsics = toPose(cv::Mat(), cv::Mat());
+				}
+				else {
+					state.extrinsics = toPose(camera.rotationVector, camera.translation);
+				}
+
+				for (auto & free : state.free) {
+					free = true;
+				}
+				const auto flags = camera.flags;
+				if (flags & CV_CALIB_FIX_INTRINSIC) {
+					for (size_t i = 0; i < IntrinsicCount; i++) {
+						state.free[i] = false;
+					}
+				}
+				if (flags & CV_CALIB_FIX_FOCAL_LENGTH) {
+					state.free[FocalLengthX] = false;
+					state.free[FocalLengthY] = false;
+				}
+				if (flags & CV_CALIB_FIX_ASPECT_RATIO) {
+					state.fixAspectRatio = true;
+					state.aspectRatio = state.intrinsics[FocalLengthY] / state.intrinsics[FocalLengthX];
+					state.free[FocalLengthY] = false;
+				}
+				if (flags & CV_CALIB_FIX_PRINCIPAL_POINT) {
+					state.free[PrincipalPointX] = false;
+					state.free[PrincipalPointY] = false;
+				}
+				if (flags & CV_CALIB_ZERO_TANGENT_DIST) {
+					state.intrinsics[P1] = 0.0;
+					state.intrinsics[P2] = 0.0;
+					state.free[P1] = false;
+					state.free[P2] = false;
+				}
+				if (flags & CV_CALIB_FIX_K1) {
+					state.free[K1] = false;
+				}
+				if (flags & CV_CALIB_FIX_K2) {
+					state.free[K2] = false;
+				}
+				if (flags & CV_CALIB_FIX_K3) {
+					state.free[K3] = false;
+				}
+				if (isFirstCamera || camera.fixExtrinsics) {
+					for (size_t i = IntrinsicCount; i < CameraBlockSize; i++) {
+						state.free[i] = false;
+					}
+				}
+				return state;
+			}
+
+			//----------
+			void fromCameraState(const CameraState & state, BundleAdjuster::Camera & camera, bool isFirstCamera) {
+				camera.cameraMatrix = (cv::Mat_<double>(3, 3) << state.intrinsics[FocalLengthX], 0, state.intrinsics[PrincipalPointX]
+					, 0, state.intrinsics[FocalLengthY], state.intrinsics[PrincipalPointY]
+					, 0, 0, 1);
+
+				//keep the caller's layout, coefficients we don't model are zero
+				auto coefficientCount = max((int)camera.distortionCoefficients.total(), 5);
+				cv::Mat distortionCoefficients = cv::Mat::zeros(coefficientCount, 1, CV_64F);
+				for (int i = 0; i < 5; i++) {
+					distortionCoefficients.at<double>(i) = state.intrinsics[K1 + i];
+				}
+				if (!camera.distortionCoefficients.empty() && camera.distortionCoefficients.rows == 1) {
+					distortionCoefficients = distortionCoefficients.t();
+				}
+				camera.distortionCoefficients = distortionCoefficients;
+
+				if (!isFirstCamera) {
+					fromPose(state.extrinsics, camera.rotationVector, camera.translation);
+				}
+			}
+
+#pragma mark Projection
+			//----------
+			///Project a point in camera space. Optionally gives d(u,v)/d(point) (2x3) and d(u,v)/d(intrinsics) (2x9)
+			void project(const double * intrinsics
+				, const double * point
+				, double * projected
+				, double * pointJacobian = nullptr
+				, double * intrinsicsJacobian = nullptr) {
+				const auto & fx = intrinsics[FocalLengthX];
+				const auto & fy = intrinsics[FocalLengthY];
+				const auto & k1 = intrinsics[K1];
+				const auto & k2 = intrinsics[K2];
+				const auto & p1 = intrinsics[P1];
+				const auto & p2 = intrinsics[P2];
+				const auto & k3 = intrinsics[K3];
+
+				const auto inverseZ = 1.0 / point[2];
+				const auto x = point[0] * inverseZ;
+				const auto y = point[1] * inverseZ;
+				const auto r2 = x * x + y * y;
+				const auto r4 = r2 * r2;
+				const auto r6 = r4 * r2;
+				const auto radial = 1.0 + k1 * r2 + k2 * r4 + k3 * r6;
+				const auto xd = x * radial + 2.0 * p1 * x * y + p2 * (r2 + 2.0 * x * x);
+				const auto yd = y * radial + p1 * (r2 + 2.0 * y * y) + 2.0 * p2 * x * y;
+
+				projected[0] = fx * xd + intrinsics[PrincipalPointX];
+				projected[1] = fy * yd + intrinsics[PrincipalPointY];
+
+				if (pointJacobian) {
+					const auto dRadialDr2 = k1 + 2.0 * k2 * r2 + 3.0 * k3 * r4;
+					const auto dxdDx = radial + 2.0 * x * x * dRadialDr2 + 2.0 * p1 * y + 6.0 * p2 * x;
+					const auto dxdDy = 2.0 * x * y * dRadialDr2 + 2.0 * p1 * x + 2.0 * p2 * y;
+					const auto dydDx = 2.0 * x * y * dRadialDr2 + 2.0 * p1 * x + 2.0 * p2 * y;
+					const auto dydDy = radial + 2.0 * y * y * dRadialDr2 + 6.0 * p1 * y + 2.0 * p2 * x;
+
+					//d(x, y) / d(point)
+					const double dxDpoint[3] = { inverseZ, 0.0, -x * inverseZ };
+					const double dyDpoint[3] = { 0.0, inverseZ, -y * inverseZ };
+
+					for (int i = 0; i < 3; i++) {
+						pointJacobian[i] = fx * (dxdDx * dxDpoint[i] + dxdDy * dyDpoint[i]);
+						pointJacobian[3 + i] = fy * (dydDx * dxDpoint[i] + dydDy * dyDpoint[i]);
+					}
+				}
+
+				if (intrinsicsJacobian) {
+					auto du = intrinsicsJacobian;
+					auto dv = intrinsicsJacobian + IntrinsicCount;
+					fill(du, du + IntrinsicCount, 0.0);
+					fill(dv, dv + IntrinsicCount, 0.0);
+
+					du[FocalLengthX] = xd;
+					dv[FocalLengthY] = yd;
+					du[PrincipalPointX] = 1.0;
+					dv[PrincipalPointY] = 1.0;
+					du[K1] = fx * x * r2;
+					dv[K1] = fy * y * r2;
+					du[K2] = fx * x * r4;
+					dv[K2] = fy * y * r4;
+					du[K3] = fx * x * r6;
+					dv[K3] = fy * y * r6;
+					du[P1] = fx * 2.0 * x * y;
+					dv[P1] = fy * (r2 + 2.0 * y * y);
+					du[P2] = fx * (r2 + 2.0 * x * x);
+					dv[P2] = fy * 2.0 * x * y;
+				}
+			}
+
+			//----------
+			double huberWeight(double error, double threshold) {
+				if (threshold <= 0.0 || error <= threshold) {
+					return 1.0;
+				}
+				return threshold / error;
+			}
+
+			//----------
+			double huberCost(double error, double threshold) {
+				if (threshold <= 0.0 || error <= threshold) {
+					return error * error;
+				}
+				return 2.0 * threshold * error - threshold * threshold;
+			}
+
+#pragma mark Threading
+			//----------
+			///Calls action(first, last, threadIndex) on contiguous ranges of [0, count), one range per threadIndex
+			///so that each can accumulate into its own slot. The ranges are run on the shared Utils::parallelFor pool
+			void parallelRanges(size_t count, size_t threadCount, const function<void(size_t, size_t, size_t)> & action) {
+				threadCount = max<size_t>(min(threadCount, count), 1);
+				if (threadCount == 1) {
+					action(0, count, 0);
+					return;
+				}
+
+				parallelFor(threadCount, [&](size_t threadIndex) {
+					action(count * threadIndex / threadCount, count * (threadIndex + 1) / threadCount, threadIndex);
+				}, threadCount);
+			}
+
+#pragma mark Problem
+			class Problem {
+			public:
+				Problem(vector<CameraState> & cameras
+					, vector<ViewState> & views
+					, const vector<BundleAdjuster::Observation> & observations
+					, const BundleAdjuster::Settings & settings)
+					: cameras(cameras)
+					, views(views)
+					, observations(observations)
+					, settings(settings) {
+					this->threadCount = settings.threadCount > 0
+						? settings.threadCount
+						: max<size_t>(thread::hardware_concurrency(), 1);
+
+					this->observationsByView.resize(views.size());
+					for (size_t i = 0; i < observations.size(); i++) {
+						const auto & observation = observations[i];
+						if (observation.camera >= cameras.size() || observation.view >= views.size()) {
+							throw(ofxRulr::Exception("Bundle adjustment observation refers to a camera or view which doesn't exist"));
+						}
+						if (observation.objectPoints.size() != observation.imagePoints.size()) {
+							throw(ofxRulr::Exception("Bundle adjustment observation has different numbers of object and image points"));
+						}
+						this->observationsByView[observation.view].push_back(i);
+						this->pointCount += observation.objectPoints.size();
+					}
+
+					this->viewSystems.resize(views.size());
+					for (size_t viewIndex = 0; viewIndex < views.size(); viewIndex++) {
+						auto & viewSystem = this->viewSystems[viewIndex];
+						for (auto observationIndex : this->observationsByView[viewIndex]) {
+							auto camera = observations[observationIndex].camera;
+							if (find(viewSystem.cameras.begin(), viewSystem.cameras.end(), camera) == viewSystem.cameras.end()) {
+								viewSystem.cameras.push_back(camera);
+							}
+						}
+						viewSystem.W.resize(viewSystem.cameras.size());
+					}
+				}
+
+				//----------
+				///Sum of (robust) squared errors, and the plain sum for the RMS
+				double evaluate(const vector<CameraState> & cameras
+					, const vector<ViewState> & views
+					, double * sumSquaredError = nullptr
+					, size_t * outlierCount = nullptr) const {
+					const auto huberThreshold = (double) this->settings.huberThreshold;
+					vector<double> costs(this->threadCount, 0.0);
+					vector<double> squaredErrors(this->threadCount, 0.0);
+					vector<size_t> outliers(this->threadCount, 0);
+
+					parallelRanges(this->observations.size(), this->threadCount, [&](size_t first, size_t last, size_t threadIndex) {
+						for (size_t i = first; i < last; i++) {
+							const auto & observation = this->observations[i];
+							const auto & camera = cameras[observation.camera];
+							const auto & view = views[observation.view];
+							for (size_t j = 0; j < observation.objectPoints.size(); j++) {
+								const auto & objectPoint = observation.objectPoints[j];
+								const double object[3] = { objectPoint.x, objectPoint.y, objectPoint.z };
+								double rig[3], point[3], projected[2];
+								transform(view.pose, object, rig);
+								transform(camera.extrinsics, rig, point);
+								project(camera.intrinsics, point, projected);
+
+								const auto dx = projected[0] - observation.imagePoints[j].x;
+								const auto dy = projected[1] - observation.imagePoints[j].y;
+								const auto squaredError = dx * dx + dy * dy;
+								const auto error = sqrt(squaredError);
+								costs[threadIndex] += huberCost(error, huberThreshold);
+								squaredErrors[threadIndex] += squaredError;
+								if (huberThreshold > 0.0 && error > huberThreshold) {
+									outliers[threadIndex]++;
+								}
+							}
+						}
+					});
+
+					if (sumSquaredError) {
+						*sumSquaredError = accumulate(squaredErrors.begin(), squaredErrors.end(), 0.0);
+					}
+					if (outlierCount) {
+						*outlierCount = accumulate(outliers.begin(), outliers.end(), (size_t)0);
+					}
+					return accumulate(costs.begin(), costs.end(), 0.0);
+				}
+
+				//----------
+				///Accumulate the normal equations (U, V, W, gradients) at the current state
+				void buildNormalEquations() {
+					const auto huberThreshold = (double) this->settings.huberThreshold;
+					const auto cameraCount = this->cameras.size();
+
+					//camera blocks are accumulated per thread then summed
+					vector<vector<CameraSystem>> threadCameraSystems(this->threadCount, vector<CameraSystem>(cameraCount));
+					for (auto & cameraSystems : threadCameraSystems) {
+						for (auto & cameraSystem : cameraSystems) {
+							fill(begin(cameraSystem.U), end(cameraSystem.U), 0.0);
+							fill(begin(cameraSystem.g), end(cameraSystem.g), 0.0);
+						}
+					}
+
+					parallelRanges(this->views.size(), this->threadCount, [&](size_t first, size_t last, size_t threadIndex) {
+						auto & cameraSystems = threadCameraSystems[threadIndex];
+
+						for (size_t viewIndex = first; viewIndex < last; viewIndex++) {
+							const auto & view = this->views[viewIndex];
+							auto & viewSystem = this->viewSystems[viewIndex];
+							fill(begin(viewSystem.V), end(viewSystem.V), 0.0);
+							fill(begin(viewSystem.g), end(viewSystem.g), 0.0);
+							for (auto & W : viewSystem.W) {
+								W.fill(0.0);
+							}
+
+							for (auto observationIndex : this->observationsByView[viewIndex]) {
+								const auto & observation = this->observations[observationIndex];
+								const auto & camera = this->cameras[observation.camera];
+								auto & cameraSystem = cameraSystems[observation.camera];
+								auto & W = viewSystem.W[find(viewSystem.cameras.begin(), viewSystem.cameras.end(), observation.camera) - viewSystem.cameras.begin()];
+
+								for (size_t j = 0; j < observation.objectPoints.size(); j++) {
+									const auto & objectPoint = observation.objectPoints[j];
+									const double object[3] = { objectPoint.x, objectPoint.y, objectPoint.z };
+
+									double rotatedObject[3], rig[3], rotatedRig[3], point[3];
+									rotate(view.pose.rotation, object, rotatedObject);
+									for (int i = 0; i < 3; i++) {
+										rig[i] = rotatedObject[i] + view.pose.translation[i];
+									}
+									rotate(camera.extrinsics.rotation, rig, rotatedRig);
+									for (int i = 0; i < 3; i++) {
+										point[i] = rotatedRig[i] + camera.extrinsics.translation[i];
+									}
+
+									double projected[2], pointJacobian[6], intrinsicsJacobian[2 * IntrinsicCount];
+									project(camera.intrinsics, point, projected, pointJacobian, intrinsicsJacobian);
+
+									const double residual[2] = {
+										projected[0] - observation.imagePoints[j].x,
+										projected[1] - observation.imagePoints[j].y
+									};
+									const auto weight = huberWeight(sqrt(residual[0] * residual[0] + residual[1] * residual[1]), huberThreshold);
+
+									//d(u,v)/d(rig point) = d(u,v)/d(point) * camera rotation
+									double rigJacobian[6];
+									for (int row = 0; row < 2; row++) {
+										for (int col = 0; col < 3; col++) {
+											rigJacobian[row * 3 + col] = pointJacobian[row * 3 + 0] * camera.extrinsics.rotation[0 * 3 + col]
+												+ pointJacobian[row * 3 + 1] * camera.extrinsics.rotation[1 * 3 + col]
+												+ pointJacobian[row * 3 + 2] * camera.extrinsics.rotation[2 * 3 + col];
+										}
+									}
+
+									//view pose : d(rig point) / d(rotation perturbation) = -[R X]x, translation gives identity
+									double poseJacobian[2 * PoseBlockSize];
+									for (int row = 0; row < 2; row++) {
+										const auto J = rigJacobian + row * 3;
+										auto out = poseJacobian + row * PoseBlockSize;
+										out[0] = rotatedObject[1] * J[2] - rotatedObject[2] * J[1];
+										out[1] = rotatedObject[2] * J[0] - rotatedObject[0] * J[2];
+										out[2] = rotatedObject[0] * J[1] - rotatedObject[1] * J[0];
+										out[3] = J[0];
+										out[4] = J[1];
+										out[5] = J[2];
+									}
+									if (view.fixed) {
+										fill(begin(poseJacobian), end(poseJacobian), 0.0);
+									}
+
+									//camera intrinsics and extrinsics
+									double cameraJacobian[2 * CameraBlockSize];
+									for (int row = 0; row < 2; row++) {
+										const auto J = pointJacobian + row * 3;
+										auto out = cameraJacobian + row * CameraBlockSize;
+										copy(intrinsicsJacobian + row * IntrinsicCount, intrinsicsJacobian + (row + 1) * IntrinsicCount, out);
+										out[RotationX] = rotatedRig[1] * J[2] - rotatedRig[2] * J[1];
+										out[RotationY] = rotatedRig[2] * J[0] - rotatedRig[0] * J[2];
+										out[RotationZ] = rotatedRig[0] * J[1] - rotatedRig[1] * J[0];
+										out[TranslationX] = J[0];
+										out[TranslationY] = J[1];
+										out[TranslationZ] = J[2];
+
+										if (camera.fixAspectRatio) {
+											out[FocalLengthX] += camera.aspectRatio * out[FocalLengthY];
+										}
+										for (size_t i = 0; i < CameraBlockSize; i++) {
+											if (!camera.free[i]) {
+												out[i] = 0.0;
+											}
+										}
+									}
+
+									//accumulate
+									for (int row = 0; row < 2; row++) {
+										const auto Jc = cameraJacobian + row * CameraBlockSize;
+										const auto Jp = poseJacobian + row * PoseBlockSize;
+										const auto r = residual[row] * weight;
+
+										for (size_t a = 0; a < CameraBlockSize; a++) {
+											if (Jc[a] == 0.0) {
+												continue;
+											}
+											const auto wJ = weight * Jc[a];
+											for (size_t b = a; b < CameraBlockSize; b++) {
+												cameraSystem.U[a * CameraBlockSize + b] += wJ * Jc[b];
+											}
+											for (size_t b = 0; b < PoseBlockSize; b++) {
+												W[a * PoseBlockSize + b] += wJ * Jp[b];
+											}
+											cameraSystem.g[a] -= Jc[a] * r;
+										}
+										for (size_t a = 0; a < PoseBlockSize; a++) {
+											const auto wJ = weight * Jp[a];
+											for (size_t b = a; b < PoseBlockSize; b++) {
+												viewSystem.V[a * PoseBlockSize + b] += wJ * Jp[b];
+											}
+											viewSystem.g[a] -= Jp[a] * r;
+										}
+									}
+								}
+							}
+
+							//mirror the upper triangle
+							for (size_t a = 0; a < PoseBlockSize; a++) {
+								for (size_t b = 0; b < a; b++) {
+									viewSystem.V[a * PoseBlockSize + b] = viewSystem.V[b * PoseBlockSize + a];
+								}
+							}
+						}
+					});
+
+					//sum the camera blocks
+					this->cameraSystems.assign(cameraCount, CameraSystem());
+					for (size_t cameraIndex = 0; cameraIndex < cameraCount; cameraIndex++) {
+						auto & cameraSystem = this->cameraSystems[cameraIndex];
+						fill(begin(cameraSystem.U), end(cameraSystem.U), 0.0);
+						fill(begin(cameraSystem.g), end(cameraSystem.g), 0.0);
+						for (const auto & cameraSystems : threadCameraSystems) {
+							for (size_t i = 0; i < CameraBlockSize * CameraBlockSize; i++) {
+								cameraSystem.U[i] += cameraSystems[cameraIndex].U[i];
+							}
+							for (size_t i = 0; i < CameraBlockSize; i++) {
+								cameraSystem.g[i] += cameraSystems[cameraIndex].g[i];
+							}
+						}
+						for (size_t a = 0; a < CameraBlockSize; a++) {
+							for (size_t b = 0; b < a; b++) {
+								cameraSystem.U[a * CameraBlockSize + b] = cameraSystem.U[b * CameraBlockSize + a];
+							}
+						}
+					}
+				}
+
+				//----------
+				///Solve the damped system with the view poses eliminated. Returns false if it's not positive definite
+				bool solveStep(double lambda, vector<double> & cameraStep, vector<double> & viewStep) {
+					const auto cameraCount = this->cameras.size();
+					const auto size = cameraCount * CameraBlockSize;
+
+					auto damp = [lambda](double diagonal) {
+						return diagonal + lambda * max(diagonal, 1e-9);
+					};
+
+					//invert each damped view block
+					atomic<bool> viewBlocksOK{ true };
+					parallelRanges(this->views.size(), this->threadCount, [&](size_t first, size_t last, size_t) {
+						for (size_t viewIndex = first; viewIndex < last; viewIndex++) {
+							auto & viewSystem = this->viewSystems[viewIndex];
+							if (this->views[viewIndex].fixed) {
+								continue;
+							}
+
+							double L[PoseBlockSize * PoseBlockSize];
+							copy(begin(viewSystem.V), end(viewSystem.V), L);
+							for (size_t i = 0; i < PoseBlockSize; i++) {
+								L[i * PoseBlockSize + i] = damp(L[i * PoseBlockSize + i]);
+							}
+							if (!choleskyDecompose(L, PoseBlockSize)) {
+								viewBlocksOK = false;
+								continue;
+							}
+							for (size_t col = 0; col < PoseBlockSize; col++) {
+								double column[PoseBlockSize] = { 0 };
+								column[col] = 1.0;
+								choleskySolve(L, PoseBlockSize, column);
+								for (size_t row = 0; row < PoseBlockSize; row++) {
+									viewSystem.Vinverse[row * PoseBlockSize + col] = column[row];
+								}
+							}
+						}
+					});
+					if (!viewBlocksOK) {
+						return false;
+					}
+
+					//reduced camera system S = U - sum(W V^-1 W^T), b = g_c - sum(W V^-1 g_v)
+					vector<vector<double>> threadS(this->threadCount, vector<double>(size * size, 0.0));
+					vector<vector<double>> threadB(this->threadCount, vector<double>(size, 0.0));
+					parallelRanges(this->views.size(), this->threadCount, [&](size_t first, size_t last, size_t threadIndex) {
+						auto & S = threadS[threadIndex];
+						auto & b = threadB[threadIndex];
+						for (size_t viewIndex = first; viewIndex < last; viewIndex++) {
+							if (this->views[viewIndex].fixed) {
+								continue;
+							}
+							const auto & viewSystem = this->viewSystems[viewIndex];
+							const auto & Vinverse = viewSystem.Vinverse;
+
+							//W V^-1 for each camera of this view
+							vector<array<double, CouplingBlockSize>> WVinverse(viewSystem.cameras.size());
+							for (size_t c = 0; c < viewSystem.cameras.size(); c++) {
+								const auto & W = viewSystem.W[c];
+								for (size_t row = 0; row < CameraBlockSize; row++) {
+									for (size_t col = 0; col < PoseBlockSize; col++) {
+										double value = 0.0;
+										for (size_t k = 0; k < PoseBlockSize; k++) {
+											value += W[row * PoseBlockSize + k] * Vinverse[k * PoseBlockSize + col];
+										}
+										WVinverse[c][row * PoseBlockSize + col] = value;
+									}
+								}
+							}
+
+							for (size_t c1 = 0; c1 < viewSystem.cameras.size(); c1++) {
+								const auto offset1 = viewSystem.cameras[c1] * CameraBlockSize;
+								const auto & WVinverse1 = WVinverse[c1];
+
+								for (size_t row = 0; row < CameraBlockSize; row++) {
+									double value = 0.0;
+									for (size_t k = 0; k < PoseBlockSize; k++) {
+										value += WVinverse1[row * PoseBlockSize + k] * viewSystem.g[k];
+									}
+									b[offset1 + row] -= value;
+								}
+
+								for (size_t c2 = 0; c2 < viewSystem.cameras.size(); c2++) {
+									const auto offset2 = viewSystem.cameras[c2] * CameraBlockSize;
+									const auto & W2 = viewSystem.W[c2];
+									for (size_t row = 0; row < CameraBlockSize; row++) {
+										for (size_t col = 0; col < CameraBlockSize; col++) {
+											double value = 0.0;
+											for (size_t k = 0; k < PoseBlockSize; k++) {
+												value += WVinverse1[row * PoseBlockSize + k] * W2[col * PoseBlockSize + k];
+											}
+											S[(offset1 + row) * size + offset2 + col] -= value;
+										}
+									}
+								}
+							}
+						}
+					});
+
+					vector<double> S(size * size, 0.0);
+					vector<double> b(size, 0.0);
+					for (size_t t = 0; t < this->threadCount; t++) {
+						for (size_t i = 0; i < S.size(); i++) {
+							S[i] += threadS[t][i];
+						}
+						for (size_t i = 0; i < size; i++) {
+							b[i] += threadB[t][i];
+						}
+					}
+					for (size_t cameraIndex = 0; cameraIndex < cameraCount; cameraIndex++) {
+						const auto & cameraSystem = this->cameraSystems[cameraIndex];
+						const auto offset = cameraIndex * CameraBlockSize;
+						for (size_t row = 0; row < CameraBlockSize; row++) {
+							for (size_t col = 0; col < CameraBlockSize; col++) {
+								auto value = cameraSystem.U[row * CameraBlockSize + col];
+								if (row == col) {
+									value = damp(value);
+								}
+								S[(offset + row) * size + offset + col] += value;
+							}
+							b[offset + row] += cameraSystem.g[row];
+						}
+
+						//fixed parameters don't move
+						const auto & camera = this->cameras[cameraIndex];
+						for (size_t i = 0; i < CameraBlockSize; i++) {
+							if (!camera.free[i]) {
+								for (size_t j = 0; j < size; j++) {
+									S[(offset + i) * size + j] = 0.0;
+									S[j * size + offset + i] = 0.0;
+								}
+								S[(offset + i) * size + offset + i] = 1.0;
+								b[offset + i] = 0.0;
+							}
+						}
+					}
+
+					if (!choleskyDecompose(S.data(), size)) {
+						return false;
+					}
+					choleskySolve(S.data(), size, b.data());
+					cameraStep = b;
+
+					//back substitute the view steps
+					viewStep.assign(this->views.size() * PoseBlockSize, 0.0);
+					parallelRanges(this->views.size(), this->threadCount, [&](size_t first, size_t last, size_t) {
+						for (size_t viewIndex = first; viewIndex < last; viewIndex++) {
+							if (this->views[viewIndex].fixed) {
+								continue;
+							}
+							const auto & viewSystem = this->viewSystems[viewIndex];
+							double rhs[PoseBlockSize];
+							copy(begin(viewSystem.g), end(viewSystem.g), rhs);
+							for (size_t c = 0; c < viewSystem.cameras.size(); c++) {
+								const auto offset = viewSystem.cameras[c] * CameraBlockSize;
+								const auto & W = viewSystem.W[c];
+								for (size_t k = 0; k < PoseBlockSize; k++) {
+									for (size_t row = 0; row < CameraBlockSize; row++) {
+										rhs[k] -= W[row * PoseBlockSize + k] * cameraStep[offset + row];
+									}
+								}
+							}
+							for (size_t row = 0; row < PoseBlockSize; row++) {
+								double value = 0.0;
+								for (size_t k = 0; k < PoseBlockSize; k++) {
+									value += viewSystem.Vinverse[row * PoseBlockSize + k] * rhs[k];
+								}
+								viewStep[viewIndex * PoseBlockSize + row] = value;
+							}
+						}
+					});
+
+					return true;
+				}
+
+				//----------
+				void applyStep(const vector<double> & cameraStep
+					, const vector<double> & viewStep
+					, vector<CameraState> & cameras
+					, vector<ViewState> & views) const {
+					for (size_t cameraIndex = 0; cameraIndex < cameras.size(); cameraIndex++) {
+						auto & camera = cameras[cameraIndex];
+						const auto step = cameraStep.data() + cameraIndex * CameraBlockSize;
+						for (size_t i = 0; i < IntrinsicCount; i++) {
+							camera.intrinsics[i] += step[i];
+						}
+						if (camera.fixAspectRatio) {
+							camera.intrinsics[FocalLengthY] = camera.aspectRatio * camera.intrinsics[FocalLengthX];
+						}
+						applyUpdate(camera.extrinsics, step + IntrinsicCount);
+					}
+					for (size_t viewIndex = 0; viewIndex < views.size(); viewIndex++) {
+						applyUpdate(views[viewIndex].pose, viewStep.data() + viewIndex * PoseBlockSize);
+					}
+				}
+
+				//----------
+				BundleAdjuster::Result run() {
+					BundleAdjuster::Result result;
+					result.pointCount = this->pointCount;
+					if (this->pointCount == 0) {
+						return result;
+					}
+
+					double sumSquaredError;
+					auto cost = this->evaluate(this->cameras, this->views, &sumSquaredError);
+					result.initialReprojectionError = sqrt(sumSquaredError / (double)this->pointCount);
+
+					double lambda = 1e-3;
+					vector<double> cameraStep, viewStep;
+					bool converged = false;
+
+					for (result.iterations = 0; result.iterations < this->settings.maximumIterations && !converged; result.iterations++) {
+						this->buildNormalEquations();
+
+						//try steps with increasing damping until the cost goes down
+						bool accepted = false;
+						for (int attempt = 0; attempt < 10 && !accepted; attempt++) {
+							if (!this->solveStep(lambda, cameraStep, viewStep)) {
+								lambda *= 10.0;
+								continue;
+							}
+
+							auto cameras = this->cameras;
+							auto views = this->views;
+							this->applyStep(cameraStep, viewStep, cameras, views);
+							auto newCost = this->evaluate(cameras, views);
+
+							if (newCost < cost) {
+								converged = (cost - newCost) <= this->settings.convergenceThreshold * cost;
+								this->cameras = cameras;
+								this->views = views;
+								cost = newCost;
+								lambda = max(lambda / 10.0, 1e-12);
+								accepted = true;
+							}
+							else {
+								lambda *= 10.0;
+							}
+						}
+
+						if (!accepted) {
+							//no step reduces the cost, we're at a minimum
+							converged = true;
+						}
+					}
+
+					this->evaluate(this->cameras, this->views, &sumSquaredError, &result.outlierCount);
+					result.reprojectionError = sqrt(sumSquaredError / (double)this->pointCount);
+					result.success = true;
+					return result;
+				}
+
+			protected:
+				vector<CameraState> & cameras;
+				vector<ViewState> & views;
+				const vector<BundleAdjuster::Observation> & observations;
+				const BundleAdjuster::Settings & settings;
+
+				size_t threadCount;
+				size_t pointCount = 0;
+				vector<vector<size_t>> observationsByView;
+				vector<ViewSystem> viewSystems;
+				vector<CameraSystem> cameraSystems;
+			};
+
+			//----------
+			cv::Mat getMedian(const vector<cv::Mat> & values) {
+				cv::Mat median(3, 1, CV_64F);
+				for (int i = 0; i < 3; i++) {
+					vector<double> components;
+					for (const auto & value : values) {
+						components.push_back(value.at<double>(i));
+					}
+					nth_element(components.begin(), components.begin() + components.size() / 2, components.end());
+					median.at<double>(i) = components[components.size() / 2];
+				}
+				return median;
+			}
+		}
+
+		//----------
+		BundleAdjuster::Result BundleAdjuster::solve(vector<Camera> & cameras
+			, vector<View> & views
+			, const vector<Observation> & observations
+			, const Settings & settings) {
+			vector<CameraState> cameraStates;
+			for (size_t i = 0; i < cameras.size(); i++) {
+				cameraStates.push_back(toCameraState(cameras[i], i == 0));
+			}
+
+			vector<ViewState> viewStates;
+			for (const auto & view : views) {
+				ViewState viewState;
+				viewState.pose = toPose(view.rotationVector, view.translation);
+				viewState.fixed = view.fixed;
+				viewStates.push_back(viewState);
+			}
+
+			Problem problem(cameraStates, viewStates, observations, settings);
+			auto result = problem.run();
+
+			for (size_t i = 0; i < cameras.size(); i++) {
+				fromCameraState(cameraStates[i], cameras[i], i == 0);
+			}
+			for (size_t i = 0; i < views.size(); i++) {
+				fromPose(viewStates[i].pose, views[i].rotationVector, views[i].translation);
+			}
+
+			return result;
+		}
+
+		//----------
+		double BundleAdjuster::calibrateCamera(const vector<vector<cv::Point3f>> & objectPoints
+			, const vector<vector<cv::Point2f>> & imagePoints
+			, cv::Size imageSize
+			, cv::Mat & cameraMatrix
+			, cv::Mat & distortionCoefficients
+			, vector<cv::Mat> & rotationVectors
+			, vector<cv::Mat> & translations
+			, int flags
+			, const Settings & settings) {
+			if (objectPoints.empty() || objectPoints.size() != imagePoints.size()) {
+				throw(ofxRulr::Exception("calibrateCamera needs the same (non-zero) number of object and image point sets"));
+			}
+
+			Camera camera;
+			camera.flags = flags;
+			if (flags & CV_CALIB_USE_INTRINSIC_GUESS) {
+				cameraMatrix.convertTo(camera.cameraMatrix, CV_64F);
+				camera.distortionCoefficients = distortionCoefficients.empty()
+					? cv::Mat::zeros(5, 1, CV_64F)
+					: distortionCoefficients.clone();
+			}
+			else {
+				double aspectRatio = 0.0;
+				if ((flags & CV_CALIB_FIX_ASPECT_RATIO) && !cameraMatrix.empty()) {
+					cv::Mat cameraMatrix64;
+					cameraMatrix.convertTo(cameraMatrix64, CV_64F);
+					aspectRatio = cameraMatrix64.at<double>(0, 0) / cameraMatrix64.at<double>(1, 1);
+				}
+				camera.cameraMatrix = cv::initCameraMatrix2D(objectPoints, imagePoints, imageSize, aspectRatio);
+				camera.distortionCoefficients = distortionCoefficients.empty()
+					? cv::Mat::zeros(5, 1, CV_64F)
+					: cv::Mat::zeros(distortionCoefficients.size(), CV_64F);
+			}
+
+			//initial view poses from the initial intrinsics
+			vector<View> views(objectPoints.size());
+			vector<Observation> observations(objectPoints.size());
+			for (size_t i = 0; i < objectPoints.size(); i++) {
+				if (objectPoints[i].size() < 4 || objectPoints[i].size() != imagePoints[i].size()) {
+					throw(ofxRulr::Exception("calibrateCamera needs at least 4 matching object and image points in every view"));
+				}
+				cv::solvePnP(objectPoints[i]
+					, imagePoints[i]
+					, camera.cameraMatrix
+					, camera.distortionCoefficients
+					, views[i].rotationVector
+					, views[i].translation);
+
+				observations[i].camera = 0;
+				observations[i].view = i;
+				observations[i].objectPoints = objectPoints[i];
+				observations[i].imagePoints = imagePoints[i];
+			}
+
+			vector<Camera> cameras(1, camera);
+			auto result = BundleAdjuster::solve(cameras, views, observations, settings);
+
+			cameraMatrix = cameras[0].cameraMatrix;
+			distortionCoefficients = cameras[0].distortionCoefficients;
+			rotationVectors.resize(views.size());
+			translations.resize(views.size());
+			for (size_t i = 0; i < views.size(); i++) {
+				rotationVectors[i] = views[i].rotationVector;
+				translations[i] = views[i].translation;
+			}
+
+			return result.reprojectionError;
+		}
+
+		//----------
+		double BundleAdjuster::stereoCalibrate(const vector<vector<cv::Point3f>> & objectPoints
+			, const vector<vector<cv::Point2f>> & imagePoints1
+			, const vector<vector<cv::Point2f>> & imagePoints2
+			, cv::Mat & cameraMatrix1
+			, cv::Mat & distortionCoefficients1
+			, cv::Mat & cameraMatrix2
+			, cv::Mat & distortionCoefficients2
+			, cv::Size imageSize
+			, cv::Mat & rotation
+			, cv::Mat & translation
+			, cv::Mat & essential
+			, cv::Mat & fundamental
+			, int flags
+			, const Settings & settings) {
+			if (objectPoints.empty() || objectPoints.size() != imagePoints1.size() || objectPoints.size() != imagePoints2.size()) {
+				throw(ofxRulr::Exception("stereoCalibrate needs the same (non-zero) number of object and image point sets"));
+			}
+
+			//as OpenCV, calibrate each camera first unless we've been given the intrinsics
+			if (!(flags & (CV_CALIB_FIX_INTRINSIC | CV_CALIB_USE_INTRINSIC_GUESS))) {
+				vector<cv::Mat> rotationVectors, translations;
+				auto monoFlags = flags & ~(CV_CALIB_FIX_INTRINSIC | CV_CALIB_SAME_FOCAL_LENGTH);
+				BundleAdjuster::calibrateCamera(objectPoints, imagePoints1, imageSize, cameraMatrix1, distortionCoefficients1, rotationVectors, translations, monoFlags, settings);
+				BundleAdjuster::calibrateCamera(objectPoints, imagePoints2, imageSize, cameraMatrix2, distortionCoefficients2, rotationVectors, translations, monoFlags, settings);
+			}
+
+			vector<Camera> cameras(2);
+			cameraMatrix1.convertTo(cameras[0].cameraMatrix, CV_64F);
+			cameraMatrix2.convertTo(cameras[1].cameraMatrix, CV_64F);
+			cameras[0].distortionCoefficients = distortionCoefficients1.empty() ? cv::Mat::zeros(5, 1, CV_64F) : distortionCoefficients1.clone();
+			cameras[1].distortionCoefficients = distortionCoefficients2.empty() ? cv::Mat::zeros(5, 1, CV_64F) : distortionCoefficients2.clone();
+			for (auto & camera : cameras) {
+				camera.flags = flags & ~CV_CALIB_USE_INTRINSIC_GUESS;
+			}
+
+			//initial poses, and the median of the relative transforms between the cameras
+			vector<View> views(objectPoints.size());
+			vector<Observation> observations;
+			vector<cv::Mat> relativeRotationVectors, relativeTranslations;
+			for (size_t i = 0; i < objectPoints.size(); i++) {
+				cv::Mat rotationVector2, translation2;
+				cv::solvePnP(objectPoints[i], imagePoints1[i], cameras[0].cameraMatrix, cameras[0].distortionCoefficients, views[i].rotationVector, views[i].translation);
+				cv::solvePnP(objectPoints[i], imagePoints2[i], cameras[1].cameraMatrix, cameras[1].distortionCoefficients, rotationVector2, translation2);
+
+				cv::Mat rotation1, rotation2;
+				cv::Rodrigues(views[i].rotationVector, rotation1);
+				cv::Rodrigues(rotationVector2, rotation2);
+				cv::Mat relativeRotation = rotation2 * rotation1.t();
+				cv::Mat relativeRotationVector;
+				cv::Rodrigues(relativeRotation, relativeRotationVector);
+				relativeRotationVectors.push_back(relativeRotationVector);
+				relativeTranslations.push_back(translation2 - relativeRotation * views[i].translation);
+
+				Observation observation1;
+				observation1.camera = 0;
+				observation1.view = i;
+				observation1.objectPoints = objectPoints[i];
+				observation1.imagePoints = imagePoints1[i];
+				observations.push_back(observation1);
+
+				Observation observation2 = observation1;
+				observation2.camera = 1;
+				observation2.imagePoints = imagePoints2[i];
+				observations.push_back(observation2);
+			}
+			cameras[1].rotationVector = getMedian(relativeRotationVectors);
+			cameras[1].translation = getMedian(relativeTranslations);
+
+			auto result = BundleAdjuster::solve(cameras, views, observations, settings);
+
+			if (!(flags & CV_CALIB_FIX_INTRINSIC)) {
+				cameraMatrix1 = cameras[0].cameraMatrix;
+				distortionCoefficients1 = cameras[0].distortionCoefficients;
+				cameraMatrix2 = cameras[1].cameraMatrix;
+				distortionCoefficients2 = cameras[1].distortionCoefficients;
+			}
+			cv::Rodrigues(cameras[1].rotationVector, rotation);
+			translation = cameras[1].translation.clone();
+
+			//E = [T]x R, F = K2^-T E K1^-1
+			{
+				const auto & t = translation;
+				cv::Mat skew = (cv::Mat_<double>(3, 3) << 0, -t.at<double>(2), t.at<double>(1)
+					, t.at<double>(2), 0, -t.at<double>(0)
+					, -t.at<double>(1), t.at<double>(0), 0);
+				essential = skew * rotation;
+				fundamental = cameras[1].cameraMatrix.inv().t() * essential * cameras[0].cameraMatrix.inv();
+				fundamental /= fundamental.at<double>(2, 2);
+			}
+
+			return result.reprojectionError;
+		}
+	}
+}
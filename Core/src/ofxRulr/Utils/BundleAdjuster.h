@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ofxCvMin.h"
+#include "ofxRulr/Utils/Constants.h"
+
+namespace ofxRulr {
+	namespace Utils {
+		///Sparse Levenberg-Marquardt bundle adjustment for calibrating cameras from views of rigid point sets
+		///(e.g. boards). Every observation touches one camera (intrinsics and extrinsics) and one view pose, so
+		///the view poses are eliminated with the Schur complement and the linear solve only grows with the number
+		///of cameras. Jacobians are analytic and evaluated over several threads. An optional Huber loss reduces
+		///the influence of bad detections.
+		///The camera model is OpenCV's with 5 distortion coefficients (k1, k2, p1, p2, k3).
+		class RULR_EXPORTS BundleAdjuster {
+		public:
+			struct Camera {
+				cv::Mat cameraMatrix;
+				cv::Mat distortionCoefficients;
+
+				//camera 0 to this camera. Always identity for camera 0
+				cv::Mat rotationVector;
+				cv::Mat translation;
+
+				///CV_CALIB_FIX_FOCAL_LENGTH, FIX_ASPECT_RATIO, FIX_PRINCIPAL_POINT, ZERO_TANGENT_DIST,
+				///FIX_K1, FIX_K2, FIX_K3 and FIX_INTRINSIC are supported
+				int flags = 0;
+				bool fixExtrinsics = false;
+			};
+
+			struct View {
+				//object to camera 0
+				cv::Mat rotationVector;
+				cv::Mat translation;
+				bool fixed = false;
+			};
+
+			struct Observation {
+				size_t camera;
+				size_t view;
+				vector<cv::Point3f> objectPoints;
+				vector<cv::Point2f> imagePoints;
+			};
+
+			struct Settings {
+				size_t maximumIterations = 100;
+				float huberThreshold = 0.0f; // px, 0 for plain least squares (as OpenCV)
+				double convergenceThreshold = 1e-10; // relative change in cost
+				size_t threadCount = 0; // 0 for hardware concurrency
+			};
+
+			struct Result {
+				bool success = false;
+				size_t iterations = 0;
+				size_t pointCount = 0;
+				size_t outlierCount = 0; // points beyond the Huber threshold
+				double initialReprojectionError = 0.0; // px RMS
+				double reprojectionError = 0.0; // px RMS
+			};
+
+			///Refines cameras and views in place
+			static Result solve(vector<Camera> &
+				, vector<View> &
+				, const vector<Observation> &
+				, const Settings & = Settings());
+
+			///Same arguments and result as cv::calibrateCamera. Returns the RMS reprojection error
+			static double calibrateCamera(const vector<vector<cv::Point3f>> & objectPoints
+				, const vector<vector<cv::Point2f>> & imagePoints
+				, cv::Size imageSize
+				, cv::Mat & cameraMatrix
+				, cv::Mat & distortionCoefficients
+				, vector<cv::Mat> & rotationVectors
+				, vector<cv::Mat> & translations
+				, int flags = 0
+				, const Settings & = Settings());
+
+			///Same arguments and result as cv::stereoCalibrate. Returns the RMS reprojection error
+			static double stereoCalibrate(const vector<vector<cv::Point3f>> & objectPoints
+				, const vector<vector<cv::Point2f>> & imagePoints1
+				, const vector<vector<cv::Point2f>> & imagePoints2
+				, cv::Mat & cameraMatrix1
+				, cv::Mat & distortionCoefficients1
+				, cv::Mat & cameraMatrix2
+				, cv::Mat & distortionCoefficients2
+				, cv::Size imageSize
+				, cv::Mat & rotation // 3x3, camera 1 to camera 2
+				, cv::Mat & translation
+				, cv::Mat & essential
+				, cv::Mat & fundamental
+				, int flags = CV_CALIB_FIX_INTRINSIC
+				, const Settings & = Settings());
+		};
+	}
+}
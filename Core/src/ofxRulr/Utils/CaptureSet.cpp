@@ -11,6 +11,7 @@ namespace ofxRulr {
 		//----------
 		AbstractCaptureSet::BaseCapture::BaseCapture() {
 			this->selected.addListener(this, &BaseCapture::callbackSelectedChanged);
+			this->color.addListener(this, &BaseCapture::callbackColorChanged);
 
 			this->onSerialize += [this](Json::Value & json) {
 				json << this->selected;
@@ -160,6 +161,11 @@ namespace ofxRulr {
 			this->onSelectionChanged.notifyListeners(value);
 		}
 
+		//----------
+		void AbstractCaptureSet::BaseCapture::callbackColorChanged(ofColor &) {
+			this->onChange.notifyListeners();
+		}
+
 		//----------
 		void AbstractCaptureSet::BaseCapture::rebuildDateStrings() {
 			time_t time = chrono::system_clock::to_time_t(this->timestamp.get());
@@ -32,6 +32,7 @@ namespace ofxRulr {
 				ofParameter<bool> selected{ "Selected", true };
 				virtual ofxCvGui::ElementPtr getDataDisplay();
 				void callbackSelectedChanged(bool &);
+				void callbackColorChanged(ofColor &);
 
 				string timeString;
 				string secondString;
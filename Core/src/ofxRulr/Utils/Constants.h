@@ -32,4 +32,8 @@ namespace ofxRulr {
 	MAKE_ENUM(FindBoardMode
 		, (Raw, Optimized, Assistant)
 		, ("Raw", "Optimized", "Assistant"));
+
+	MAKE_ENUM(CalibrationSolver
+		, (OpenCV, Sparse)
+		, ("OpenCV", "Sparse"));
 }
@@ -0,0 +1,102 @@
+#include "pch_RulrCore.h"
+#include "Hungarian.h"
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace Hungarian {
+			//----------
+			vector<int> solve(const vector<float> & costs
+				, size_t rows
+				, size_t cols
+				, float maximumCost) {
+				vector<int> assignment(rows, -1);
+				if (rows == 0 || cols == 0) {
+					return assignment;
+				}
+
+				//pad to a square problem. forbidden and padded entries get a cost larger than any valid solution
+				const auto size = max(rows, cols);
+				double forbiddenCost = 1.0;
+				for (const auto & cost : costs) {
+					if (cost < maximumCost) {
+						forbiddenCost += abs((double)cost);
+					}
+				}
+
+				auto getCost = [&](size_t row, size_t col) {
+					if (row >= rows || col >= cols) {
+						return forbiddenCost;
+					}
+					const auto & cost = costs[row * cols + col];
+					return cost < maximumCost ? (double)cost : forbiddenCost;
+				};
+
+				//potentials and matching are 1-indexed, index 0 is the virtual start column
+				vector<double> rowPotential(size + 1, 0.0);
+				vector<double> colPotential(size + 1, 0.0);
+				vector<size_t> colMatch(size + 1, 0);
+				vector<size_t> way(size + 1, 0);
+				vector<double> minimumSlack(size + 1);
+				vector<bool> used(size + 1);
+
+				for (size_t row = 1; row <= size; row++) {
+					colMatch[0] = row;
+					size_t col0 = 0;
+					fill(minimumSlack.begin(), minimumSlack.end(), numeric_limits<double>::infinity());
+					fill(used.begin(), used.end(), false);
+
+					do {
+						used[col0] = true;
+						const auto row0 = colMatch[col0];
+						auto delta = numeric_limits<double>::infinity();
+						size_t col1 = 0;
+
+						for (size_t col = 1; col <= size; col++) {
+							if (used[col]) {
+								continue;
+							}
+							const auto slack = getCost(row0 - 1, col - 1) - rowPotential[row0] - colPotential[col];
+							if (slack < minimumSlack[col]) {
+								minimumSlack[col] = slack;
+								way[col] = col0;
+							}
+							if (minimumSlack[col] < delta) {
+								delta = minimumSlack[col];
+								col1 = col;
+							}
+						}
+
+						for (size_t col = 0; col <= size; col++) {
+							if (used[col]) {
+								rowPotential[colMatch[col]] += delta;
+								colPotential[col] -= delta;
+							}
+							else {
+								minimumSlack[col] -= delta;
+							}
+						}
+						col0 = col1;
+					} while (colMatch[col0] != 0);
+
+					//unwind the augmenting path
+					do {
+						const auto col1 = way[col0];
+						colMatch[col0] = colMatch[col1];
+						col0 = col1;
+					} while (col0 != 0);
+				}
+
+				for (size_t col = 1; col <= size; col++) {
+					const auto row = colMatch[col] - 1;
+					if (row < rows && col - 1 < cols) {
+						if (costs[row * cols + col - 1] < maximumCost) {
+							assignment[row] = (int) (col - 1);
+						}
+					}
+				}
+
+				return assignment;
+			}
+		}
+	}
+}
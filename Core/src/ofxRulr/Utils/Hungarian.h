@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+
+#include "ofxRulr/Utils/Constants.h"
+
+using namespace std;
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace Hungarian {
+			///Minimum cost assignment of rows to columns (Kuhn-Munkres, O(n^3)).
+			///costs is row-major with rows * cols entries. The matrix does not need to be square.
+			///Any cost >= maximumCost is treated as a forbidden pairing (gating).
+			///Returns the assigned column for each row, or -1 where the row is unassigned.
+			RULR_EXPORTS vector<int> solve(const vector<float> & costs
+				, size_t rows
+				, size_t cols
+				, float maximumCost = numeric_limits<float>::infinity());
+		}
+	}
+}
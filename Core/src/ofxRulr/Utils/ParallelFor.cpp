@@ -0,0 +1,104 @@
+#include "pch_RulrCore.h"
+#include "ParallelFor.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <condition_variable>
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace {
+			struct ParallelForState {
+				const function<void(size_t)> * action;
+				size_t count;
+				atomic<size_t> next{ 0 };
+
+				//helpers which started before the caller finished
+				size_t activeHelpers = 0;
+				bool finished = false;
+				exception_ptr exception;
+				mutex stateMutex;
+				condition_variable helpersDone;
+
+				//----------
+				void work() {
+					size_t i;
+					while ((i = this->next++) < this->count) {
+						try {
+							(*this->action)(i);
+						}
+						catch (...) {
+							auto lock = unique_lock<mutex>(this->stateMutex);
+							if (!this->exception) {
+								this->exception = current_exception();
+							}
+							//skip the remaining work
+							this->next.store(this->count);
+						}
+					}
+				}
+			};
+
+			//----------
+			ThreadPool & getThreadPool() {
+				static ThreadPool threadPool(max(thread::hardware_concurrency(), 2u) - 1, 1024);
+				return threadPool;
+			}
+		}
+
+		//----------
+		void parallelFor(size_t count, const function<void(size_t)> & action, size_t threadCount) {
+			if (threadCount == 0) {
+				threadCount = max(thread::hardware_concurrency(), 1u);
+			}
+			threadCount = min(threadCount, count);
+			if (threadCount <= 1) {
+				for (size_t i = 0; i < count; i++) {
+					action(i);
+				}
+				return;
+			}
+
+			auto state = make_shared<ParallelForState>();
+			state->action = &action;
+			state->count = count;
+
+			//helpers which only get to run after we've finished don't touch the action
+			auto & threadPool = getThreadPool();
+			for (size_t i = 1; i < threadCount; i++) {
+				auto queued = threadPool.performAsync([state]() {
+					{
+						auto lock = unique_lock<mutex>(state->stateMutex);
+						if (state->finished) {
+							return;
+						}
+						state->activeHelpers++;
+					}
+
+					state->work();
+
+					auto lock = unique_lock<mutex>(state->stateMutex);
+					state->activeHelpers--;
+					state->helpersDone.notify_all();
+				});
+				if (!queued) {
+					break;
+				}
+			}
+
+			state->work();
+
+			{
+				auto lock = unique_lock<mutex>(state->stateMutex);
+				state->finished = true;
+				state->helpersDone.wait(lock, [&state]() {
+					return state->activeHelpers == 0;
+				});
+			}
+
+			if (state->exception) {
+				rethrow_exception(state->exception);
+			}
+		}
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <functional>
+
+#include "ofxRulr/Utils/Constants.h"
+
+using namespace std;
+
+namespace ofxRulr {
+	namespace Utils {
+		///Calls action(i) for every i in [0, count) using up to threadCount threads (0 = one per hardware thread).
+		///Work is shared with a persistent thread pool so no threads are created per call. The calling thread
+		///also takes work, so this is safe to call from inside another parallelFor.
+		///The first exception thrown by action is rethrown on the calling thread.
+		RULR_EXPORTS void parallelFor(size_t count
+			, const function<void(size_t)> & action
+			, size_t threadCount = 0);
+	}
+}
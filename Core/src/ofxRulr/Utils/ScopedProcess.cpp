@@ -11,6 +11,10 @@ namespace ofxRulr {
 		//----------
 		ScopedProcess::ActiveProcesses::ActiveProcesses() {
 			this->idlingThread = thread([this]() {
+				if (Utils::isHeadless()) {
+					return; // no sounds
+				}
+
 				auto & soundEngine = SoundEngine::X();
 				auto & assetsRegister = ofxAssets::Register::X();
 
@@ -52,7 +56,7 @@ namespace ofxRulr {
 			this->activeProcesses.push_back(process);
 
 			//start sounding
-			if (!isSounding && process->getHasSuccessOrFail()) {
+			if (!isSounding && process->getHasSuccessOrFail() && !Utils::isHeadless()) {
 				SoundEngine::X().play("ofxRulr::start");
 				this->waitForStartSound = true;
 				this->isSounding = true;
@@ -60,7 +64,7 @@ namespace ofxRulr {
 			}
 
 			//print to screen
-			{
+			if (!Utils::isHeadless()) {
 				stringstream message;
 				for (const auto process : this->activeProcesses) {
 					message << process->getActivityName() << endl;
@@ -112,7 +116,7 @@ namespace ofxRulr {
 
 		//----------
 		void ScopedProcess::ActiveProcesses::popProcess(ScopedProcess * process) {
-			if (process->getHasSuccessOrFail()) {
+			if (process->getHasSuccessOrFail() && !Utils::isHeadless()) {
 				//play the end sound
 				{
 					auto & assetRegister = ofxAssets::Register::X();
@@ -178,7 +182,7 @@ namespace ofxRulr {
 			}
 
 			//stop idling sound if this is the last
-			if (this->activeProcesses.empty()) {
+			if (this->activeProcesses.empty() && !Utils::isHeadless()) {
 				SoundEngine::X().stopAll("ofxRulr::idle");
 			}
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+#include <atomic>
+
+using namespace std;
+
+namespace ofxRulr {
+	namespace Utils {
+		///Versioned, read-mostly value shared between the main thread and worker threads.
+		///One thread publishes immutable copies, any thread can take the current copy.
+		///A reader keeps the copy it took (and its version) for as long as it needs, regardless of later publishes.
+		///Note : the atomic shared_ptr functions are not lock free with MSVC or libstdc++ (see isLockFree). They use
+		///a small internal lock which is only held whilst the pointer is copied, never whilst a value is built or used.
+		template<typename Type>
+		class Snapshot {
+		public:
+			typedef uint64_t Version;
+
+			struct Entry {
+				shared_ptr<Type> value;
+				Version version = 0; // 0 means nothing published yet
+			};
+
+			//----------
+			///The value and version always come from the same publish
+			Entry get() const {
+				auto entry = atomic_load(&this->entry);
+				return entry ? *entry : Entry();
+			}
+
+			//----------
+			shared_ptr<Type> getValue() const {
+				return this->get().value;
+			}
+
+			//----------
+			///Whether taking / publishing the pointer is lock free on this platform
+			bool isLockFree() const {
+				return atomic_is_lock_free(&this->entry);
+			}
+
+			//----------
+			Version getVersion() const {
+				return this->version.load();
+			}
+
+			//----------
+			///Publish from one thread only (normally the main thread). Returns the new version
+			Version publish(shared_ptr<Type> value) {
+				auto entry = make_shared<Entry>();
+				entry->value = value;
+				entry->version = this->version.load() + 1;
+				atomic_store(&this->entry, shared_ptr<const Entry>(entry));
+				this->version.store(entry->version);
+				return entry->version;
+			}
+
+			//----------
+			///Forward an entry taken from another Snapshot, keeping its version. Returns true if it was new
+			bool mirror(const Entry & upstream) {
+				auto current = atomic_load(&this->entry);
+				if (current && current->value == upstream.value && current->version == upstream.version) {
+					return false;
+				}
+				atomic_store(&this->entry, shared_ptr<const Entry>(make_shared<Entry>(upstream)));
+				this->version.store(upstream.version);
+				return true;
+			}
+
+			//----------
+			void clear() {
+				this->publish(nullptr);
+			}
+		protected:
+			shared_ptr<const Entry> entry;
+			atomic<Version> version{ 0 };
+		};
+	}
+}
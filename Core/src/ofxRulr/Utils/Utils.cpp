@@ -45,5 +45,29 @@ namespace ofxRulr {
 
 			return output.str();
 		}
+
+		namespace {
+			bool headless = false;
+		}
+
+		//----------
+		void setHeadless(bool value) {
+			headless = value;
+		}
+
+		//----------
+		bool isHeadless() {
+			return headless;
+		}
+
+		//----------
+		void alert(const string & message) {
+			if (headless) {
+				ofLogError("ofxRulr") << message;
+			}
+			else {
+				ofSystemAlertDialog(message);
+			}
+		}
 	}
 }
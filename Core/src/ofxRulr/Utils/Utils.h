@@ -12,5 +12,13 @@ namespace ofxRulr {
 			, bool showMinutes = true
 			, bool showSeconds = true
 			, bool showMilliseconds = false);
+
+		///Headless mode is for running patches without a window (e.g. the batch runner).
+		///Nothing is drawn, no sounds are played and alerts go to the log.
+		RULR_EXPORTS void setHeadless(bool);
+		RULR_EXPORTS bool isHeadless();
+
+		///Shows a dialog, or logs an error when headless
+		RULR_EXPORTS void alert(const std::string & message);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "pch_RulrCore.h"
+#include "WorldBatch.h"
+#include "Graphics.h"
+
+#include "ofxRulr/Exception.h"
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace {
+			WorldBatch * currentBatch = nullptr;
+
+			//----------
+			const ofMesh & getUnitSphere() {
+				static auto sphere = ofIcoSpherePrimitive(1.0f, 1).getMesh();
+				return sphere;
+			}
+		}
+
+#pragma mark Scope
+		//----------
+		WorldBatch::Scope::Scope() {
+			this->batch = WorldBatch::getCurrent();
+			if (!this->batch) {
+				this->ownedBatch = make_unique<WorldBatch>();
+				this->ownedBatch->begin();
+				this->batch = this->ownedBatch.get();
+			}
+		}
+
+		//----------
+		WorldBatch::Scope::~Scope() {
+			if (this->ownedBatch) {
+				this->ownedBatch->end();
+			}
+		}
+
+		//----------
+		WorldBatch * WorldBatch::Scope::operator->() {
+			return this->batch;
+		}
+
+		//----------
+		WorldBatch & WorldBatch::Scope::operator*() {
+			return * this->batch;
+		}
+
+#pragma mark WorldBatch
+		//----------
+		WorldBatch::WorldBatch() {
+			this->spheres.setMode(OF_PRIMITIVE_TRIANGLES);
+			this->spheres.setUsage(GL_STREAM_DRAW);
+		}
+
+		//----------
+		void WorldBatch::begin() {
+			if (this->open) {
+				throw(ofxRulr::Exception("WorldBatch::begin() called on a batch which is already open"));
+			}
+			this->beginModelView = ofGetCurrentMatrix(OF_MATRIX_MODELVIEW);
+			this->beginModelViewInverse = this->beginModelView.getInverse();
+			this->previous = currentBatch;
+			currentBatch = this;
+			this->open = true;
+		}
+
+		//----------
+		void WorldBatch::end() {
+			if (!this->open) {
+				return;
+			}
+			this->draw();
+			currentBatch = this->previous;
+			this->previous = nullptr;
+			this->open = false;
+		}
+
+		//----------
+		WorldBatch * WorldBatch::getCurrent() {
+			return currentBatch;
+		}
+
+		//----------
+		void WorldBatch::addPoint(const ofVec3f & point, const ofFloatColor & color, float size) {
+			auto & mesh = this->points[size];
+			mesh.addVertex(point * this->getTransform());
+			mesh.addColor(color);
+			this->statistics.points++;
+		}
+
+		//----------
+		void WorldBatch::addPoints(const vector<ofVec3f> & points, const ofFloatColor & color, float size) {
+			const auto & transform = this->getTransform();
+			auto & mesh = this->points[size];
+			for (const auto & point : points) {
+				mesh.addVertex(point * transform);
+				mesh.addColor(color);
+			}
+			this->statistics.points += points.size();
+		}
+
+		//----------
+		void WorldBatch::addPoints(const vector<ofVec3f> & points, const vector<ofFloatColor> & colors, float size) {
+			if (points.size() != colors.size()) {
+				throw(ofxRulr::Exception("WorldBatch::addPoints needs one color per point"));
+			}
+			const auto & transform = this->getTransform();
+			auto & mesh = this->points[size];
+			for (const auto & point : points) {
+				mesh.addVertex(point * transform);
+			}
+			mesh.addColors(colors);
+			this->statistics.points += points.size();
+		}
+
+		//----------
+		void WorldBatch::addSphere(const ofVec3f & center, float radius, const ofFloatColor & color) {
+			const auto & transform = this->getTransform();
+			const auto & unitSphere = getUnitSphere();
+
+			const auto indexOffset = (ofIndexType) this->spheres.getNumVertices();
+			for (const auto & vertex : unitSphere.getVertices()) {
+				this->spheres.addVertex((vertex * radius + center) * transform);
+				this->spheres.addColor(color);
+			}
+			for (const auto & index : unitSphere.getIndices()) {
+				this->spheres.addIndex(index + indexOffset);
+			}
+			this->statistics.spheres++;
+		}
+
+		//----------
+		void WorldBatch::addLine(const ofVec3f & start, const ofVec3f & end, const ofFloatColor & color, float width) {
+			this->addLine(start, end, color, color, width);
+		}
+
+		//----------
+		void WorldBatch::addLine(const ofVec3f & start, const ofVec3f & end, const ofFloatColor & startColor, const ofFloatColor & endColor, float width) {
+			const auto & transform = this->getTransform();
+			auto & mesh = this->lines[width];
+			mesh.addVertex(start * transform);
+			mesh.addVertex(end * transform);
+			mesh.addColor(startColor);
+			mesh.addColor(endColor);
+			this->statistics.lines++;
+		}
+
+		//----------
+		void WorldBatch::addLineStrip(const vector<ofVec3f> & vertices, const vector<ofFloatColor> & colors, float width) {
+			if (vertices.size() != colors.size()) {
+				throw(ofxRulr::Exception("WorldBatch::addLineStrip needs one color per vertex"));
+			}
+			if (vertices.size() < 2) {
+				return;
+			}
+
+			//strips are stored as separate segments so that they can share a mesh
+			const auto & transform = this->getTransform();
+			auto & mesh = this->lines[width];
+			auto previous = vertices.front() * transform;
+			for (size_t i = 1; i < vertices.size(); i++) {
+				auto vertex = vertices[i] * transform;
+				mesh.addVertex(previous);
+				mesh.addVertex(vertex);
+				mesh.addColor(colors[i - 1]);
+				mesh.addColor(colors[i]);
+				previous = vertex;
+			}
+			this->statistics.lines += vertices.size() - 1;
+		}
+
+		//----------
+		void WorldBatch::addAxes(const ofMatrix4x4 & transform, float size) {
+			const auto origin = ofVec3f() * transform;
+			this->addLine(origin, ofVec3f(size, 0, 0) * transform, ofColor::red, 3.0f);
+			this->addLine(origin, ofVec3f(0, size, 0) * transform, ofColor::green, 3.0f);
+			this->addLine(origin, ofVec3f(0, 0, size) * transform, ofColor::blue, 3.0f);
+		}
+
+		//----------
+		void WorldBatch::addFrustum(const ofMatrix4x4 & viewProjection, const ofFloatColor & color, float width) {
+			//corners of the clip space cube, back to world space
+			const auto inverse = viewProjection.getInverse();
+			ofVec3f corners[8];
+			for (int i = 0; i < 8; i++) {
+				corners[i] = ofVec3f(i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1) * inverse;
+			}
+
+			for (int i = 0; i < 8; i++) {
+				for (int axis = 1; axis < 8; axis <<= 1) {
+					if (!(i & axis)) {
+						this->addLine(corners[i], corners[i | axis], color, width);
+					}
+				}
+			}
+		}
+
+		//----------
+		const WorldBatch::Statistics & WorldBatch::getLastStatistics() const {
+			return this->lastStatistics;
+		}
+
+		//----------
+		void WorldBatch::draw() {
+			ofPushMatrix();
+			ofPushStyle();
+			{
+				//undo anything pushed onto the matrix stack since begin()
+				ofMultMatrix(this->beginModelView * ofGetCurrentMatrix(OF_MATRIX_MODELVIEW).getInverse());
+				ofEnableAlphaBlending();
+				ofSetColor(255);
+
+				if (this->spheres.getNumVertices() > 0) {
+					this->spheres.draw();
+					this->statistics.drawCalls++;
+				}
+
+				for (auto & it : this->lines) {
+					if (it.second.getNumVertices() > 0) {
+						it.second.setMode(OF_PRIMITIVE_LINES);
+						ofSetLineWidth(it.first);
+						it.second.draw();
+						this->statistics.drawCalls++;
+					}
+				}
+
+				for (auto & it : this->points) {
+					if (it.second.getNumVertices() > 0) {
+						it.second.setMode(OF_PRIMITIVE_POINTS);
+						Graphics::pushPointSize(it.first);
+						{
+							it.second.draw();
+						}
+						Graphics::popPointSize();
+						this->statistics.drawCalls++;
+					}
+				}
+			}
+			ofPopStyle();
+			ofPopMatrix();
+
+			//keep the meshes (and their allocations) between frames
+			this->spheres.clear();
+			for (auto & it : this->lines) {
+				it.second.clear();
+			}
+			for (auto & it : this->points) {
+				it.second.clear();
+			}
+
+			this->lastStatistics = this->statistics;
+			this->statistics = Statistics();
+		}
+
+		//----------
+		const ofMatrix4x4 & WorldBatch::getTransform() {
+			if (!this->open) {
+				throw(ofxRulr::Exception("WorldBatch needs begin() before adding primitives"));
+			}
+			this->transform = ofGetCurrentMatrix(OF_MATRIX_MODELVIEW) * this->beginModelViewInverse;
+			return this->transform;
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ofxRulr/Utils/Constants.h"
+
+namespace ofxRulr {
+	namespace Utils {
+		///Collects world primitives and draws them as a few merged meshes (one per point size / line width, one for all
+		///spheres) instead of one draw call per primitive. The WorldStage opens a batch around the nodes' drawWorldStage
+		///calls each frame. Primitives are stored relative to the modelview matrix at begin(), so they can be
+		///added from inside ofPushMatrix / ofMultMatrix blocks.
+		class RULR_EXPORTS WorldBatch {
+		public:
+			///Adds to the batch which is open (e.g. the WorldStage's), or opens one which is drawn when the Scope ends.
+			class RULR_EXPORTS Scope {
+			public:
+				Scope();
+				~Scope();
+				WorldBatch * operator->();
+				WorldBatch & operator*();
+			protected:
+				unique_ptr<WorldBatch> ownedBatch;
+				WorldBatch * batch;
+			};
+
+			struct Statistics {
+				size_t points = 0;
+				size_t spheres = 0;
+				size_t lines = 0;
+				size_t drawCalls = 0;
+			};
+
+			WorldBatch();
+			void begin();
+			void end(); // draws and clears the batch
+			static WorldBatch * getCurrent();
+
+			void addPoint(const ofVec3f &, const ofFloatColor &, float size = 5.0f);
+			void addPoints(const vector<ofVec3f> &, const ofFloatColor &, float size = 5.0f);
+			void addPoints(const vector<ofVec3f> &, const vector<ofFloatColor> &, float size = 5.0f);
+
+			void addSphere(const ofVec3f & center, float radius, const ofFloatColor &);
+
+			void addLine(const ofVec3f &, const ofVec3f &, const ofFloatColor &, float width = 1.0f);
+			void addLine(const ofVec3f &, const ofVec3f &, const ofFloatColor &, const ofFloatColor &, float width = 1.0f);
+			void addLineStrip(const vector<ofVec3f> &, const vector<ofFloatColor> &, float width = 1.0f);
+
+			///Same as ofDrawAxis inside ofMultMatrix(transform)
+			void addAxes(const ofMatrix4x4 & transform, float size);
+
+			///Edges of the volume seen by a view, e.g. view.getViewMatrix() * view.getClippedProjectionMatrix()
+			void addFrustum(const ofMatrix4x4 & viewProjection, const ofFloatColor &, float width = 1.0f);
+
+			const Statistics & getLastStatistics() const;
+		protected:
+			void draw();
+			const ofMatrix4x4 & getTransform(); // current model matrix relative to the batch
+
+			ofMatrix4x4 beginModelView;
+			ofMatrix4x4 beginModelViewInverse;
+			ofMatrix4x4 transform;
+			WorldBatch * previous = nullptr;
+			bool open = false;
+
+			map<float, ofVboMesh> points; // by point size
+			map<float, ofVboMesh> lines; // by line width, as pairs of vertices
+			ofVboMesh spheres;
+			Statistics statistics;
+			Statistics lastStatistics;
+		};
+	}
+}
@@ -4,11 +4,38 @@
 
 #include "ofxRulr/Nodes/Item/View.h"
 
+#include "ofxGLM.h"
+
 namespace ofxRulr {
 	namespace Nodes {
 		namespace Procedure {
 			namespace Calibrate {
 				namespace ProCamSolver {
+#pragma mark ViewParameters
+					//----------
+					ofxRay::Camera ViewParameters::getViewInWorldSpace() const {
+						auto view = this->viewInObjectSpace;
+						const auto width = view.getWidth();
+						const auto height = view.getHeight();
+
+						//as Item::View::rebuildView
+						cv::Mat cameraMatrix = cv::Mat::eye(3, 3, CV_64F);
+						cameraMatrix.at<double>(0, 0) = width * this->throwRatio;
+						cameraMatrix.at<double>(1, 1) = width * this->throwRatio / this->pixelAspectRatio;
+						cameraMatrix.at<double>(0, 2) = ofMap(this->lensOffset.x, +0.5f, -0.5f, 0, width);
+						cameraMatrix.at<double>(1, 2) = ofMap(this->lensOffset.y, -0.5f, +0.5f, 0, height);
+						view.setProjection(ofxCv::makeProjectionMatrix(cameraMatrix, cv::Size(width, height)));
+
+						//as Item::RigidBody::getTransform
+						auto quat = glm::quat(glm::vec3(this->rotationEuler.x * DEG_TO_RAD, this->rotationEuler.y * DEG_TO_RAD, this->rotationEuler.z * DEG_TO_RAD));
+						auto transform = ofxGLM::toOf(glm::toMat4(quat));
+						((ofVec4f*)&transform)[3] = ofVec4f(this->position.x, this->position.y, this->position.z, 1.0f);
+						view.setView(transform.getInverse());
+
+						return view;
+					}
+
+#pragma mark AddView
 					//----------
 					AddView::AddView() {
 						RULR_NODE_INIT_LISTENER;
@@ -182,6 +209,10 @@ namespace ofxRulr {
 								position[i] = value;
 								view->setPosition(position);
 							};
+							this->position[i].apply = [i](ViewParameters & viewParameters, float value) {
+								viewParameters.position[i] = value;
+							};
+							this->position[i].derivative = (ViewParameters::Derivative) (ViewParameters::PositionX + i);
 						}
 
 						for (int i = 0; i < 3; i++) {
@@ -193,6 +224,10 @@ namespace ofxRulr {
 								rotation[i] = value;
 								view->setRotationEuler(rotation);
 							};
+							this->rotation[i].apply = [i](ViewParameters & viewParameters, float value) {
+								viewParameters.rotationEuler[i] = value;
+							};
+							this->rotation[i].derivative = (ViewParameters::Derivative) (ViewParameters::RotationX + i);
 						}
 
 						this->throwRatioLog.get = [view]() {
@@ -201,6 +236,10 @@ namespace ofxRulr {
 						this->throwRatioLog.set = [view](float value) {
 							view->setThrowRatio(exp(value));
 						};
+						this->throwRatioLog.apply = [](ViewParameters & viewParameters, float value) {
+							viewParameters.throwRatio = exp(value);
+						};
+						this->throwRatioLog.derivative = ViewParameters::ThrowRatioLog;
 
 						this->pixelAspectRatioLog.get = [view]() {
 							return log(view->getPixelAspectRatio());
@@ -208,6 +247,10 @@ namespace ofxRulr {
 						this->pixelAspectRatioLog.set = [view](float value) {
 							view->setPixelAspectRatio(exp(value));
 						};
+						this->pixelAspectRatioLog.apply = [](ViewParameters & viewParameters, float value) {
+							viewParameters.pixelAspectRatio = exp(value);
+						};
+						this->pixelAspectRatioLog.derivative = ViewParameters::PixelAspectRatioLog;
 
 						for (int i = 0; i < 2; i++) {
 							this->lensOffset[i].get = [view, i]() {
@@ -218,6 +261,10 @@ namespace ofxRulr {
 								lensOffset[i] = value;
 								view->setLensOffset(lensOffset);
 							};
+							this->lensOffset[i].apply = [i](ViewParameters & viewParameters, float value) {
+								viewParameters.lensOffset[i] = value;
+							};
+							this->lensOffset[i].derivative = (ViewParameters::Derivative) (ViewParameters::LensOffsetX + i);
 						}
 
 
@@ -236,6 +283,21 @@ namespace ofxRulr {
 						return activeFitParameters;
 					}
 
+					//----------
+					ViewParameters AddView::getViewParameters() const {
+						this->throwIfMissingAConnection<Item::View>();
+						auto view = this->getInput<Item::View>();
+
+						ViewParameters viewParameters;
+						viewParameters.viewInObjectSpace = view->getViewInObjectSpace();
+						viewParameters.position = view->getPosition();
+						viewParameters.rotationEuler = view->getRotationEuler();
+						viewParameters.throwRatio = view->getThrowRatio();
+						viewParameters.pixelAspectRatio = view->getPixelAspectRatio();
+						viewParameters.lensOffset = view->getLensOffset();
+						return viewParameters;
+					}
+
 					//----------
 					shared_ptr<ofxRulr::Nodes::Base> AddView::getNode() {
 						return this->getInput<Item::View>();
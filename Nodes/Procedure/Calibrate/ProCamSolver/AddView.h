@@ -7,12 +7,41 @@ namespace ofxRulr {
 		namespace Procedure {
 			namespace Calibrate {
 				namespace ProCamSolver {
+					///A copy of the parameters of a view, so that solves can try values without changing the node
+					struct ViewParameters {
+						///Quantities which the ray of a pixel can be differentiated with respect to
+						enum Derivative {
+							PositionX,
+							PositionY,
+							PositionZ,
+							RotationX,
+							RotationY,
+							RotationZ,
+							ThrowRatioLog,
+							PixelAspectRatioLog,
+							LensOffsetX,
+							LensOffsetY,
+							DerivativeCount
+						};
+
+						ofxRay::Camera viewInObjectSpace; // for size and clipping
+						ofVec3f position;
+						ofVec3f rotationEuler;
+						float throwRatio;
+						float pixelAspectRatio;
+						ofVec2f lensOffset;
+
+						ofxRay::Camera getViewInWorldSpace() const;
+					};
+
 					struct FitParameter {
 						string name;
 						bool enabled;
 						float deviation;
 						function<float()> get;
 						function<void(float)> set;
+						function<void(ViewParameters &, float)> apply; // set on a copy, safe off the main thread
+						ViewParameters::Derivative derivative; // which quantity of the view apply changes
 					};
 
 					class AddView : public Node {
@@ -27,6 +56,7 @@ namespace ofxRulr {
 						void populateInspector(ofxCvGui::InspectArguments &);
 
 						vector<FitParameter *> getActiveFitParameters();
+						ViewParameters getViewParameters() const;
 					protected:
 						shared_ptr<Nodes::Base> getNode() override;
 
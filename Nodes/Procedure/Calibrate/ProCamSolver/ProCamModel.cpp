@@ -9,11 +9,71 @@ namespace ofxRulr {
 		namespace Procedure {
 			namespace Calibrate {
 				namespace ProCamSolver {
+					namespace {
+						///The ray of one pixel and its derivatives with respect to each quantity of the view
+						struct RayDerivatives {
+							glm::dvec3 origin;
+							glm::dvec3 direction;
+							glm::dvec3 originDerivatives[ViewParameters::DerivativeCount];
+							glm::dvec3 directionDerivatives[ViewParameters::DerivativeCount];
+						};
+
+						//----------
+						RayDerivatives getRayDerivatives(const ViewParameters & viewParameters, const ofxRay::Camera & view, const ofVec2f & coordinate) {
+							RayDerivatives result;
+							for (int i = 0; i < ViewParameters::DerivativeCount; i++) {
+								result.originDerivatives[i] = glm::dvec3(0.0);
+								result.directionDerivatives[i] = glm::dvec3(0.0);
+							}
+
+							//as ViewParameters::getViewInWorldSpace, i.e. rotate x then y then z
+							const auto rotation = glm::dvec3(viewParameters.rotationEuler.x, viewParameters.rotationEuler.y, viewParameters.rotationEuler.z) * (double) DEG_TO_RAD;
+							const auto rotationY = glm::angleAxis(rotation.y, glm::dvec3(0, 1, 0));
+							const auto rotationZ = glm::angleAxis(rotation.z, glm::dvec3(0, 0, 1));
+							const auto quat = glm::dquat(rotation);
+
+							//take the direction from ofxRay and scale it to unit depth along the view's -z axis
+							const auto ray = view.castCoordinate(coordinate);
+							auto localDirection = glm::conjugate(quat) * glm::dvec3(ray.t.x, ray.t.y, ray.t.z);
+							localDirection /= -localDirection.z;
+
+							result.origin = glm::dvec3(viewParameters.position.x, viewParameters.position.y, viewParameters.position.z);
+							result.direction = quat * localDirection;
+
+							for (int i = 0; i < 3; i++) {
+								result.originDerivatives[ViewParameters::PositionX + i][i] = 1.0;
+							}
+
+							//each euler angle rotates the direction about its axis after the later rotations are applied
+							const glm::dvec3 rotationAxes[3] = {
+								rotationZ * rotationY * glm::dvec3(1, 0, 0),
+								rotationZ * glm::dvec3(0, 1, 0),
+								glm::dvec3(0, 0, 1)
+							};
+							for (int i = 0; i < 3; i++) {
+								result.directionDerivatives[ViewParameters::RotationX + i] = glm::cross(rotationAxes[i], result.direction) * (double) DEG_TO_RAD;
+							}
+
+							//at unit depth x = (u - cx) / fx and y = (cy - v) / fy, with fx = width * throwRatio and fy = fx / pixelAspectRatio
+							const auto width = (double) view.getWidth();
+							const auto height = (double) view.getHeight();
+							const auto throwRatio = (double) viewParameters.throwRatio;
+							const auto pixelAspectRatio = (double) viewParameters.pixelAspectRatio;
+							result.directionDerivatives[ViewParameters::ThrowRatioLog] = quat * glm::dvec3(-localDirection.x, -localDirection.y, 0.0);
+							result.directionDerivatives[ViewParameters::PixelAspectRatioLog] = quat * glm::dvec3(0.0, localDirection.y, 0.0);
+							result.directionDerivatives[ViewParameters::LensOffsetX] = quat * glm::dvec3(1.0 / throwRatio, 0.0, 0.0);
+							result.directionDerivatives[ViewParameters::LensOffsetY] = quat * glm::dvec3(0.0, height * pixelAspectRatio / (width * throwRatio), 0.0);
+
+							return result;
+						}
+					}
+
 					//----------
 					Model::Model(shared_ptr<AddView> camera, shared_ptr<AddView> projector) {
 						{
 							auto parameters = camera->getActiveFitParameters();
 							this->fitParameters.insert(this->fitParameters.end(), parameters.begin(), parameters.end());
+							this->cameraFitParameterCount = parameters.size();
 						}
 						{
 							auto parameters = projector->getActiveFitParameters();
@@ -23,6 +83,9 @@ namespace ofxRulr {
 						this->camera = dynamic_pointer_cast<Item::Camera>(camera->getInput<Item::View>());
 						this->projector = dynamic_pointer_cast<Item::Projector>(projector->getInput<Item::View>());
 
+						this->cameraParameters = camera->getViewParameters();
+						this->projectorParameters = projector->getViewParameters();
+
 						this->multiThreaded = true;
 					}
 
@@ -77,6 +140,97 @@ namespace ofxRulr {
 						}
 						return bounds;
 					}
+
+					//----------
+					vector<double> Model::getNodeParameters() const {
+						vector<double> parameters(this->getParameterCount());
+						for (int i = 0; i < this->fitParameters.size(); i++) {
+							parameters[i] = this->fitParameters[i]->get();
+						}
+						return parameters;
+					}
+
+					//----------
+					void Model::setNodeParameters(const vector<double> & parameters) {
+						for (int i = 0; i < this->fitParameters.size(); i++) {
+							this->fitParameters[i]->set(parameters[i]);
+						}
+					}
+
+					//----------
+					double Model::getTotalResidual(const double * parameters, const vector<AddScan::DataPoint> & dataPoints) const {
+						auto cameraParameters = this->cameraParameters;
+						auto projectorParameters = this->projectorParameters;
+						for (size_t i = 0; i < this->fitParameters.size(); i++) {
+							auto & viewParameters = i < this->cameraFitParameterCount ? cameraParameters : projectorParameters;
+							this->fitParameters[i]->apply(viewParameters, (float) parameters[i]);
+						}
+
+						const auto cameraView = cameraParameters.getViewInWorldSpace();
+						const auto projectorView = projectorParameters.getViewInWorldSpace();
+
+						double residual = 0.0;
+						for (const auto & dataPoint : dataPoints) {
+							const auto cameraRay = cameraView.castCoordinate(dataPoint.camera);
+							const auto projectorRay = projectorView.castCoordinate(dataPoint.projector);
+							residual += cameraRay.intersect(projectorRay).getLengthSquared();
+						}
+						return residual;
+					}
+
+					//----------
+					double Model::getTotalResidualAndGradient(const double * parameters, const vector<AddScan::DataPoint> & dataPoints, double * gradient) const {
+						auto cameraParameters = this->cameraParameters;
+						auto projectorParameters = this->projectorParameters;
+						for (size_t i = 0; i < this->fitParameters.size(); i++) {
+							auto & viewParameters = i < this->cameraFitParameterCount ? cameraParameters : projectorParameters;
+							this->fitParameters[i]->apply(viewParameters, (float) parameters[i]);
+						}
+
+						const auto cameraView = cameraParameters.getViewInWorldSpace();
+						const auto projectorView = projectorParameters.getViewInWorldSpace();
+
+						const auto count = this->getParameterCount();
+						for (unsigned int i = 0; i < count; i++) {
+							gradient[i] = 0.0;
+						}
+
+						//the residual of each point is the squared distance between the two rays, i.e. (w . n)^2 / (n . n)
+						//with w = projectorOrigin - cameraOrigin and n = cameraDirection x projectorDirection
+						double residual = 0.0;
+						for (const auto & dataPoint : dataPoints) {
+							const auto cameraRay = getRayDerivatives(cameraParameters, cameraView, dataPoint.camera);
+							const auto projectorRay = getRayDerivatives(projectorParameters, projectorView, dataPoint.projector);
+
+							const auto w = projectorRay.origin - cameraRay.origin;
+							const auto n = glm::cross(cameraRay.direction, projectorRay.direction);
+							const auto a = glm::dot(w, n);
+							const auto b = glm::dot(n, n);
+							if (b < 1e-12) {
+								//parallel rays have no closest point
+								continue;
+							}
+							const auto pointResidual = a * a / b;
+							residual += pointResidual;
+
+							for (unsigned int i = 0; i < count; i++) {
+								const auto derivative = this->fitParameters[i]->derivative;
+								glm::dvec3 dw, dn;
+								if (i < this->cameraFitParameterCount) {
+									dw = -cameraRay.originDerivatives[derivative];
+									dn = glm::cross(cameraRay.directionDerivatives[derivative], projectorRay.direction);
+								}
+								else {
+									dw = projectorRay.originDerivatives[derivative];
+									dn = glm::cross(cameraRay.direction, projectorRay.directionDerivatives[derivative]);
+								}
+								const auto da = glm::dot(dw, n) + glm::dot(w, dn);
+								const auto db = 2.0 * glm::dot(n, dn);
+								gradient[i] += (2.0 * a * da - pointResidual * db) / b;
+							}
+						}
+						return residual;
+					}
 				}
 			}
 		}
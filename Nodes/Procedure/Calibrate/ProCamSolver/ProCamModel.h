@@ -27,10 +27,23 @@ namespace ofxRulr {
 						vector<double> getLowerBounds() const;
 						vector<double> getUpperBounds() const;
 
+						///Current values of the fit parameters in the nodes
+						vector<double> getNodeParameters() const;
+						void setNodeParameters(const vector<double> &);
+
+						///Sum of residuals for a set of parameter values. Only reads copies of the views, so can be called from any thread.
+						double getTotalResidual(const double * parameters, const vector<AddScan::DataPoint> &) const;
+
+						///Analytic gradient of getTotalResidual, also returns the residual at parameters
+						double getTotalResidualAndGradient(const double * parameters, const vector<AddScan::DataPoint> &, double * gradient) const;
 					protected:
 						shared_ptr<Item::Camera> camera;
 						shared_ptr<Item::Projector> projector;
 						vector<FitParameter *> fitParameters;
+						size_t cameraFitParameterCount;
+
+						ViewParameters cameraParameters;
+						ViewParameters projectorParameters;
 
 						ofxRay::Camera cameraCached;
 						ofxRay::Projector projectorCached;
@@ -7,7 +7,9 @@
 
 #include "ofxRulr/Nodes/Item/Camera.h"
 #include "ofxRulr/Nodes/Item/Projector.h"
+#include "ofxRulr/Utils/ParallelFor.h"
 
+#include <random>
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -34,6 +36,8 @@ namespace ofxRulr {
 						RULR_NODE_UPDATE_LISTENER;
 						RULR_NODE_INSPECTOR_LISTENER;
 
+						this->manageParameters(this->parameters);
+
 						this->panel = make_shared<ofxCvGui::Panels::Widgets>();
 					}
 
@@ -58,6 +62,29 @@ namespace ofxRulr {
 							solveButton->setHeight(100.0f);
 							solveButton->setHotKey(OF_KEY_RETURN);
 						}
+
+						inspector->addLiveValue<string>("Last solve", [this]() {
+							const auto & result = this->results.lastSolve;
+							return ofToString(result.residual) + " in " + ofToString(result.duration) + "s";
+						});
+
+						inspector->addButton("Benchmark", [this]() {
+							try {
+								this->benchmark();
+							}
+							RULR_CATCH_ALL_TO_ALERT;
+						});
+						if (this->results.hasBenchmark) {
+							inspector->addLiveValue<string>("Global search", [this]() {
+								const auto & result = this->results.globalSearch;
+								return ofToString(result.residual) + " in " + ofToString(result.duration) + "s";
+							});
+							inspector->addLiveValue<string>("Multi-start", [this]() {
+								const auto & result = this->results.multiStart;
+								return ofToString(result.residual) + " in " + ofToString(result.duration) + "s ("
+									+ ofToString(result.startsAgreed) + " of " + ofToString(result.startsRun) + " starts agreed)";
+							});
+						}
 					}
 
 					//----------
@@ -106,35 +133,197 @@ namespace ofxRulr {
 
 						auto views = this->getViews(); 
 						auto scans = this->getScans();
+						if (views.size() < 2 || scans.empty()) {
+							throw(ofxRulr::Exception("ProCamSolver needs 2 views and a scan"));
+						}
 
 						auto fitPoints = scans[0]->getFitPoints();
 						ProCamSolver::Model model(views[0], views[1]);
 
 						{
 							Utils::ScopedProcess fitProcess("Fit views to rays");
-							//ofxNonLinearFit::Fit<Model> fit(model.getParameterCount(), ofxNonLinearFit::Algorithm(nlopt::algorithm::LN_NEWUOA_BOUND));
 
-							ofxNonLinearFit::Fit<Model> fit(model.getParameterCount(), ofxNonLinearFit::Algorithm(nlopt::algorithm::GN_MLSL));
-							ofxNonLinearFit::Fit<Model> localFit(model.getParameterCount(), ofxNonLinearFit::Algorithm(nlopt::algorithm::LN_NEWUOA));
-							nlopt_set_local_optimizer(fit.getOptimiser(), localFit.getOptimiser());
-							nlopt_set_maxtime(fit.getOptimiser(), 60 * 10); // 10mins max
+							if (this->parameters.method.get() == SolveMethod::GlobalSearch) {
+								this->results.lastSolve = this->solveGlobalSearch(model, fitPoints);
+							}
+							else {
+								this->results.lastSolve = this->solveMultiStart(model, fitPoints);
+							}
+							model.setNodeParameters(this->results.lastSolve.parameters);
+
+							fitProcess.end();
+						}
+
+						ofLogVerbose("ProCamSolver::Solver") << "Residual : " << this->results.lastSolve.residual;
+						scopedProcess.end();
+					}
+
+					//----------
+					void Solver::benchmark() {
+						Utils::ScopedProcess scopedProcess("ProCam Solve benchmark", false);
+
+						auto views = this->getViews();
+						auto scans = this->getScans();
+						if (views.size() < 2 || scans.empty()) {
+							throw(ofxRulr::Exception("ProCamSolver needs 2 views and a scan"));
+						}
+
+						auto fitPoints = scans[0]->getFitPoints();
+						ProCamSolver::Model model(views[0], views[1]);
+						const auto initialParameters = model.getNodeParameters();
+
+						//both start from the values in the nodes
+						this->results.globalSearch = this->solveGlobalSearch(model, fitPoints);
+						model.setNodeParameters(initialParameters);
+						this->results.multiStart = this->solveMultiStart(model, fitPoints);
+						this->results.hasBenchmark = true;
+
+						const auto & best = this->results.multiStart.residual <= this->results.globalSearch.residual
+							? this->results.multiStart
+							: this->results.globalSearch;
+						model.setNodeParameters(best.parameters);
+
+						ofLogNotice("ProCamSolver::Solver") << "Global search : " << this->results.globalSearch.duration << "s, residual " << this->results.globalSearch.residual
+							<< ". Multi-start : " << this->results.multiStart.duration << "s, residual " << this->results.multiStart.residual
+							<< " (" << this->results.multiStart.startsRun << " starts, " << this->results.multiStart.startsAgreed << " agreed)";
+
+						ofxCvGui::refreshInspector(this);
+						scopedProcess.end();
+					}
+
+					//----------
+					Solver::Result Solver::solveGlobalSearch(Model & model, vector<AddScan::DataPoint> & fitPoints) {
+						auto startTime = chrono::high_resolution_clock::now();
+
+						//ofxNonLinearFit::Fit<Model> fit(model.getParameterCount(), ofxNonLinearFit::Algorithm(nlopt::algorithm::LN_NEWUOA_BOUND));
 
-							//set bounds
-							{
-								auto & optimizer = fit.getOptimiser();
-								auto lowerBounds = model.getLowerBounds();
-								auto upperBounds = model.getUpperBounds();
-								nlopt_set_lower_bounds(optimizer, lowerBounds.data());
-								nlopt_set_upper_bounds(optimizer, upperBounds.data());
+						ofxNonLinearFit::Fit<Model> fit(model.getParameterCount(), ofxNonLinearFit::Algorithm(nlopt::algorithm::GN_MLSL));
+						ofxNonLinearFit::Fit<Model> localFit(model.getParameterCount(), ofxNonLinearFit::Algorithm(nlopt::algorithm::LN_NEWUOA));
+						nlopt_set_local_optimizer(fit.getOptimiser(), localFit.getOptimiser());
+						nlopt_set_maxtime(fit.getOptimiser(), this->parameters.maxTime);
+
+						//set bounds
+						{
+							auto & optimizer = fit.getOptimiser();
+							auto lowerBounds = model.getLowerBounds();
+							auto upperBounds = model.getUpperBounds();
+							nlopt_set_lower_bounds(optimizer, lowerBounds.data());
+							nlopt_set_upper_bounds(optimizer, upperBounds.data());
+						}
+
+						double residual = 0;
+						fit.optimise(model, &fitPoints, &residual);
+
+						//optimise leaves the result in the nodes
+						Result result;
+						result.parameters = model.getNodeParameters();
+						result.residual = model.getTotalResidual(result.parameters.data(), fitPoints);
+						result.duration = chrono::duration<float>(chrono::high_resolution_clock::now() - startTime).count();
+						result.startsRun = 1;
+						return result;
+					}
+
+					//----------
+					Solver::Result Solver::solveMultiStart(Model & model, vector<AddScan::DataPoint> & fitPoints) {
+						auto startTime = chrono::high_resolution_clock::now();
+
+						const auto parameterCount = model.getParameterCount();
+						const auto initialParameters = model.getNodeParameters();
+						const auto lowerBounds = model.getLowerBounds();
+						const auto upperBounds = model.getUpperBounds();
+
+						const auto startCount = (size_t) this->parameters.multiStart.starts.get();
+						const auto agreementCount = (size_t) this->parameters.multiStart.agreementCount.get();
+						const auto agreementTolerance = (double) this->parameters.multiStart.agreementTolerance.get();
+						const auto seed = (unsigned int) this->parameters.multiStart.seed.get();
+						const auto maxTime = (double) this->parameters.maxTime.get();
+
+						const auto threadCount = (size_t) this->parameters.multiStart.threadCount.get();
+
+						struct LocalSolve {
+							const Model * model;
+							const vector<AddScan::DataPoint> * fitPoints;
+							const atomic<bool> * stop;
+							nlopt_opt optimiser;
+						};
+
+						auto objective = [](unsigned int, const double * x, double * gradient, void * data) -> double {
+							auto & localSolve = *(LocalSolve *) data;
+							if (localSolve.stop->load()) {
+								nlopt_force_stop(localSolve.optimiser);
+							}
+							if (gradient) {
+								return localSolve.model->getTotalResidualAndGradient(x, *localSolve.fitPoints, gradient);
+							}
+							else {
+								return localSolve.model->getTotalResidual(x, *localSolve.fitPoints);
 							}
+						};
 
-							double residual = 0;
-							if (fit.optimise(model, &fitPoints, &residual)) {
-								fitProcess.end();
+						Result result;
+						result.residual = numeric_limits<double>::max();
+						vector<double> finishedResiduals;
+						mutex resultMutex;
+
+						atomic<bool> stop(false);
+
+						Utils::parallelFor(startCount, [&](size_t startIndex) {
+							if (stop.load()) {
+								return;
+							}
+
+							//the first start is the current values, the rest are spread over the bounds
+							vector<double> parameters(initialParameters);
+							if (startIndex > 0) {
+								mt19937 randomEngine(seed + (unsigned int) startIndex);
+								for (unsigned int i = 0; i < parameterCount; i++) {
+									parameters[i] = uniform_real_distribution<double>(lowerBounds[i], upperBounds[i])(randomEngine);
+								}
+							}
+
+							auto optimiser = nlopt_create(NLOPT_LD_LBFGS, parameterCount);
+							LocalSolve localSolve{ &model, &fitPoints, &stop, optimiser };
+							nlopt_set_min_objective(optimiser, objective, &localSolve);
+							nlopt_set_lower_bounds(optimiser, lowerBounds.data());
+							nlopt_set_upper_bounds(optimiser, upperBounds.data());
+							nlopt_set_xtol_rel(optimiser, 1e-6);
+							nlopt_set_maxtime(optimiser, max(maxTime - chrono::duration<double>(chrono::high_resolution_clock::now() - startTime).count(), 1.0));
+
+							//e.g. NLOPT_ROUNDOFF_LIMITED or a forced stop still leaves the best point found in parameters
+							double residual = numeric_limits<double>::infinity();
+							nlopt_optimize(optimiser, parameters.data(), &residual);
+							nlopt_destroy(optimiser);
+
+							if (!isfinite(residual)) {
+								return;
+							}
+
+							lock_guard<mutex> lock(resultMutex);
+							result.startsRun++;
+							finishedResiduals.push_back(residual);
+							if (residual < result.residual) {
+								result.residual = residual;
+								result.parameters = parameters;
+							}
+
+							result.startsAgreed = 0;
+							for (auto finishedResidual : finishedResiduals) {
+								if (finishedResidual <= result.residual * (1.0 + agreementTolerance)) {
+									result.startsAgreed++;
+								}
 							}
+							if (result.startsAgreed >= agreementCount
+								|| chrono::duration<double>(chrono::high_resolution_clock::now() - startTime).count() > maxTime) {
+								stop.store(true);
+							}
+						}, threadCount);
 
-							cout << "residual : " << residual << endl;
+						if (result.parameters.empty()) {
+							throw(ofxRulr::Exception("No multi-start solve converged"));
 						}
+
+						result.duration = chrono::duration<float>(chrono::high_resolution_clock::now() - startTime).count();
+						return result;
 					}
 
 					//----------
@@ -2,6 +2,7 @@
 #include "ofxRulr/Nodes/Base.h"
 
 #include "Node.h"
+#include "AddScan.h"
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -9,7 +10,11 @@ namespace ofxRulr {
 			namespace Calibrate {
 				namespace ProCamSolver {
 					class AddView;
-					class AddScan;
+					class Model;
+
+					MAKE_ENUM(SolveMethod
+						, (GlobalSearch, MultiStart)
+						, ("Global search", "Multi-start"));
 
 					class Solver : public Base {
 					public:
@@ -26,11 +31,52 @@ namespace ofxRulr {
 
 						void solve();
 
+						///Solve the stored views and scan with both methods from the same starting values, keeping the better result
+						void benchmark();
+
 						vector<shared_ptr<AddView>> getViews() const;
 						vector<shared_ptr<AddScan>> getScans() const;
 					protected:
+						struct Result {
+							vector<double> parameters;
+							double residual = 0.0;
+							float duration = 0.0f; // s
+							size_t startsRun = 0;
+							size_t startsAgreed = 0;
+						};
+
+						///MLSL global search with NEWUOA local searches over the whole bounds
+						Result solveGlobalSearch(Model &, vector<AddScan::DataPoint> &);
+
+						///Independent L-BFGS solves from seeded starts within the bounds, spread across threads.
+						///Stops early once enough solves land on the best residual.
+						Result solveMultiStart(Model &, vector<AddScan::DataPoint> &);
+
 						void rebuildPanel();
 
+						struct : ofParameterGroup {
+							ofParameter<SolveMethod> method{ "Method", SolveMethod::GlobalSearch };
+							ofParameter<float> maxTime{ "Max time [s]", 60 * 10, 1, 60 * 60 };
+
+							struct : ofParameterGroup {
+								ofParameter<int> starts{ "Starts", 64, 1, 10000 };
+								ofParameter<int> threadCount{ "Threads", 0, 0, 64 }; // 0 for hardware concurrency
+								ofParameter<int> agreementCount{ "Agreement count", 4, 1, 1000 }; // stop once this many solves agree
+								ofParameter<float> agreementTolerance{ "Agreement tolerance", 0.01f, 0.0f, 1.0f }; // relative to the best residual
+								ofParameter<int> seed{ "Seed", 0, 0, 1000000 };
+								PARAM_DECLARE("Multi-start", starts, threadCount, agreementCount, agreementTolerance, seed);
+							} multiStart;
+
+							PARAM_DECLARE("Solver", method, maxTime, multiStart);
+						} parameters;
+
+						struct {
+							Result lastSolve;
+							Result globalSearch;
+							Result multiStart;
+							bool hasBenchmark = false;
+						} results;
+
 						shared_ptr<ofxCvGui::Panels::Widgets> panel;
 						vector<weak_ptr<Node>> nodes;
 
@@ -0,0 +1,455 @@
+#pragma once
+
+//Layout and reader for the channel tree which Data::Channels::SharedMemoryPublisher writes into shared memory.
+//This header only uses the standard library and the OS, so other applications on the same machine can include it directly.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ofxRulr {
+	namespace Data {
+		namespace Channels {
+			///The mapping holds a header, a schema (one fixed size record per channel) and a ring of frames.
+			///Each frame holds every channel's value at the offset given in the schema. The schema and each frame
+			///are guarded by a sequence number which is odd whilst being written (a seqlock), so readers copy
+			///without taking a lock and retry if the writer got there first.
+			namespace SharedMemory {
+				enum ValueType : uint32_t {
+					None = 0,
+					Bool,
+					Int32,
+					Int64,
+					UInt32,
+					UInt64,
+					Float,
+					String, // uint32_t length, then characters
+					Vec3f,
+					Vec4f,
+					IntVector // uint32_t count, then int32_t values
+				};
+
+				const char Magic[8] = { 'R', 'U', 'L', 'R', 'C', 'H', 'N', '1' };
+				const uint32_t Version = 1;
+				const size_t AddressLength = 112;
+
+				struct Header {
+					char magic[8];
+					uint32_t version;
+					uint32_t channelCapacity;
+					uint32_t valuesCapacity; // bytes per frame
+					uint32_t ringLength;
+					uint64_t schemaOffset;
+					uint64_t ringOffset;
+					uint64_t frameStride;
+					uint64_t size;
+
+					std::atomic<uint64_t> schemaSequence; // odd whilst the schema is being written
+					uint32_t channelCount; // guarded by schemaSequence
+					uint32_t reserved;
+					std::atomic<uint64_t> frameIndex; // last complete frame, 0 before the first
+				};
+
+				struct SchemaEntry {
+					char address[AddressLength]; // e.g. "/bodies/0/position", null terminated
+					uint32_t type; // ValueType
+					uint32_t offset; // into the frame's values
+					uint32_t size; // bytes reserved for the value
+					uint32_t capacity; // characters or elements for String and IntVector
+				};
+
+				struct FrameHeader {
+					std::atomic<uint64_t> sequence; // odd whilst the frame is being written
+					uint64_t frameIndex;
+					uint64_t schemaSequence; // the schema the values are laid out with
+					int64_t timestamp; // steady_clock nanoseconds when published
+					uint32_t valuesSize;
+					uint32_t reserved;
+				};
+
+				//----------
+				inline std::string getSystemName(const std::string & name) {
+#ifdef _WIN32
+					return "Local\\Rulr.Channels." + name;
+#else
+					return "/rulr.channels." + name;
+#endif
+				}
+
+				//----------
+				inline int64_t getTimestamp() {
+					return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+				}
+
+				///A named shared memory block. The publisher creates it, readers open it read-only.
+				class Mapping {
+				public:
+					~Mapping() {
+						this->close();
+					}
+
+					//----------
+					bool create(const std::string & name, size_t size) {
+						this->close();
+						auto systemName = getSystemName(name);
+#ifdef _WIN32
+						auto handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE
+							, (DWORD) ((uint64_t) size >> 32), (DWORD) (size & 0xFFFFFFFF), systemName.c_str());
+						if (!handle) {
+							return false;
+						}
+						auto view = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+						if (!view) {
+							CloseHandle(handle);
+							return false;
+						}
+						this->handle = handle;
+#else
+						shm_unlink(systemName.c_str()); // clear out a mapping left by a crashed publisher
+						auto fileDescriptor = shm_open(systemName.c_str(), O_CREAT | O_RDWR, 0644);
+						if (fileDescriptor < 0) {
+							return false;
+						}
+						if (ftruncate(fileDescriptor, (off_t) size) != 0) {
+							::close(fileDescriptor);
+							shm_unlink(systemName.c_str());
+							return false;
+						}
+						auto view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+						::close(fileDescriptor);
+						if (view == MAP_FAILED) {
+							shm_unlink(systemName.c_str());
+							return false;
+						}
+						this->owner = true;
+#endif
+						this->data = (uint8_t *) view;
+						this->size = size;
+						this->systemName = systemName;
+						return true;
+					}
+
+					//----------
+					bool open(const std::string & name) {
+						this->close();
+						auto systemName = getSystemName(name);
+#ifdef _WIN32
+						auto handle = OpenFileMappingA(FILE_MAP_READ, FALSE, systemName.c_str());
+						if (!handle) {
+							return false;
+						}
+						auto view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+						if (!view) {
+							CloseHandle(handle);
+							return false;
+						}
+						MEMORY_BASIC_INFORMATION information;
+						VirtualQuery(view, &information, sizeof(information));
+						this->handle = handle;
+						this->size = information.RegionSize;
+#else
+						auto fileDescriptor = shm_open(systemName.c_str(), O_RDONLY, 0);
+						if (fileDescriptor < 0) {
+							return false;
+						}
+						struct stat fileStatus;
+						if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < (off_t) sizeof(Header)) {
+							::close(fileDescriptor);
+							return false;
+						}
+						auto view = mmap(nullptr, (size_t) fileStatus.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+						::close(fileDescriptor);
+						if (view == MAP_FAILED) {
+							return false;
+						}
+						this->size = (size_t) fileStatus.st_size;
+#endif
+						this->data = (uint8_t *) view;
+						this->systemName = systemName;
+
+						//check it's ours and complete
+						const auto & header = * (const Header *) this->data;
+						if (this->size < sizeof(Header)
+							|| memcmp(header.magic, Magic, sizeof(Magic)) != 0
+							|| header.version != Version
+							|| header.size > this->size) {
+							this->close();
+							return false;
+						}
+						return true;
+					}
+
+					//----------
+					void close() {
+						if (!this->data) {
+							return;
+						}
+#ifdef _WIN32
+						UnmapViewOfFile(this->data);
+						CloseHandle((HANDLE) this->handle);
+						this->handle = nullptr;
+#else
+						munmap(this->data, this->size);
+						if (this->owner) {
+							shm_unlink(this->systemName.c_str());
+						}
+						this->owner = false;
+#endif
+						this->data = nullptr;
+						this->size = 0;
+					}
+
+					bool isOpen() const {
+						return this->data != nullptr;
+					}
+
+					uint8_t * getData() const {
+						return this->data;
+					}
+
+					size_t getSize() const {
+						return this->size;
+					}
+				protected:
+					uint8_t * data = nullptr;
+					size_t size = 0;
+					std::string systemName;
+#ifdef _WIN32
+					void * handle = nullptr;
+#else
+					bool owner = false;
+#endif
+				};
+
+				///Reads the latest frame without blocking the publisher. Not thread safe, use one Reader per thread.
+				class Reader {
+				public:
+					struct Channel {
+						std::string address;
+						ValueType type;
+						uint32_t offset;
+						uint32_t size;
+						uint32_t capacity;
+					};
+
+					struct Frame {
+						uint64_t frameIndex = 0;
+						uint64_t schemaVersion = 0;
+						int64_t timestamp = 0; // see getTimestamp()
+						std::vector<uint8_t> values;
+					};
+
+					//----------
+					bool open(const std::string & name) {
+						this->channels.clear();
+						this->schemaSequence = 0;
+						this->lastFrameIndex = 0;
+						return this->mapping.open(name);
+					}
+
+					//----------
+					void close() {
+						this->mapping.close();
+					}
+
+					//----------
+					bool isOpen() const {
+						return this->mapping.isOpen();
+					}
+
+					///Copies the latest frame if there's one newer than the last read.
+					///The schema is read first if it has changed, calling onSchemaChange.
+					bool readFrame(Frame & frame) {
+						if (!this->isOpen()) {
+							return false;
+						}
+						const auto & header = this->getHeader();
+
+						for (int attempt = 0; attempt < 100; attempt++) {
+							const auto frameIndex = header.frameIndex.load(std::memory_order_acquire);
+							if (frameIndex == 0 || frameIndex == this->lastFrameIndex) {
+								return false;
+							}
+
+							const auto & frameHeader = * (const FrameHeader *) (this->mapping.getData() + header.ringOffset + (frameIndex % header.ringLength) * header.frameStride);
+							const auto sequence = frameHeader.sequence.load(std::memory_order_acquire);
+							if (sequence & 1) {
+								continue;
+							}
+
+							const auto copiedFrameIndex = frameHeader.frameIndex;
+							const auto frameSchemaSequence = frameHeader.schemaSequence;
+							const auto timestamp = frameHeader.timestamp;
+							const auto valuesSize = std::min(frameHeader.valuesSize, header.valuesCapacity);
+							frame.values.resize(valuesSize);
+							memcpy(frame.values.data(), (const uint8_t *) &frameHeader + sizeof(FrameHeader), valuesSize);
+
+							std::atomic_thread_fence(std::memory_order_acquire);
+							if (frameHeader.sequence.load(std::memory_order_relaxed) != sequence) {
+								//the publisher wrapped around the ring whilst we copied
+								continue;
+							}
+							if (copiedFrameIndex <= this->lastFrameIndex) {
+								continue;
+							}
+
+							if (frameSchemaSequence != this->schemaSequence) {
+								this->readSchema();
+								if (frameSchemaSequence != this->schemaSequence) {
+									//the schema changed again since this frame
+									continue;
+								}
+							}
+
+							frame.frameIndex = copiedFrameIndex;
+							frame.schemaVersion = this->getSchemaVersion();
+							frame.timestamp = timestamp;
+							this->lastFrameIndex = copiedFrameIndex;
+							return true;
+						}
+						return false;
+					}
+
+					///Polls until a new frame arrives (spinning first for the lowest latency, then yielding)
+					bool waitForFrame(Frame & frame, std::chrono::microseconds timeout) {
+						const auto endTime = std::chrono::steady_clock::now() + timeout;
+						for (int spin = 0; ; spin++) {
+							if (this->readFrame(frame)) {
+								return true;
+							}
+							if (std::chrono::steady_clock::now() > endTime) {
+								return false;
+							}
+							if (spin > 1000) {
+								std::this_thread::yield();
+							}
+						}
+					}
+
+					const std::vector<Channel> & getChannels() const {
+						return this->channels;
+					}
+
+					///-1 if not found
+					int findChannel(const std::string & address) const {
+						for (size_t i = 0; i < this->channels.size(); i++) {
+							if (this->channels[i].address == address) {
+								return (int) i;
+							}
+						}
+						return -1;
+					}
+
+					///Changes whenever the channel tree or a channel's type changes
+					uint64_t getSchemaVersion() const {
+						return this->schemaSequence / 2;
+					}
+
+					///For fixed size types (bool, the integers, float, and float[3] / float[4] for Vec3f / Vec4f)
+					template<typename Type>
+					Type getValue(const Frame & frame, size_t channelIndex) const {
+						Type value;
+						memset(&value, 0, sizeof(value));
+						const auto & channel = this->channels.at(channelIndex);
+						if (sizeof(Type) <= channel.size && channel.offset + sizeof(Type) <= frame.values.size()) {
+							memcpy(&value, frame.values.data() + channel.offset, sizeof(Type));
+						}
+						return value;
+					}
+
+					//----------
+					std::string getString(const Frame & frame, size_t channelIndex) const {
+						const auto & channel = this->channels.at(channelIndex);
+						auto length = std::min(this->getValue<uint32_t>(frame, channelIndex), channel.capacity);
+						if (channel.offset + sizeof(uint32_t) + length > frame.values.size()) {
+							return std::string();
+						}
+						return std::string((const char *) frame.values.data() + channel.offset + sizeof(uint32_t), length);
+					}
+
+					//----------
+					std::vector<int32_t> getIntVector(const Frame & frame, size_t channelIndex) const {
+						const auto & channel = this->channels.at(channelIndex);
+						auto count = std::min(this->getValue<uint32_t>(frame, channelIndex), channel.capacity);
+						std::vector<int32_t> values(count);
+						if (channel.offset + sizeof(uint32_t) + count * sizeof(int32_t) <= frame.values.size()) {
+							memcpy(values.data(), frame.values.data() + channel.offset + sizeof(uint32_t), count * sizeof(int32_t));
+						}
+						return values;
+					}
+
+					///Called from readFrame when the channel tree changes (and on the first read)
+					std::function<void(const std::vector<Channel> &)> onSchemaChange;
+				protected:
+					//----------
+					const Header & getHeader() const {
+						return * (const Header *) this->mapping.getData();
+					}
+
+					//----------
+					bool readSchema() {
+						const auto & header = this->getHeader();
+						std::vector<SchemaEntry> entries;
+
+						for (int attempt = 0; attempt < 1000; attempt++) {
+							const auto sequence = header.schemaSequence.load(std::memory_order_acquire);
+							if (sequence & 1) {
+								std::this_thread::yield();
+								continue;
+							}
+
+							entries.resize(std::min(header.channelCount, header.channelCapacity));
+							memcpy(entries.data(), this->mapping.getData() + header.schemaOffset, entries.size() * sizeof(SchemaEntry));
+
+							std::atomic_thread_fence(std::memory_order_acquire);
+							if (header.schemaSequence.load(std::memory_order_relaxed) != sequence) {
+								continue;
+							}
+
+							this->channels.clear();
+							for (const auto & entry : entries) {
+								Channel channel;
+								channel.address = std::string(entry.address, strnlen(entry.address, AddressLength));
+								channel.type = (ValueType) entry.type;
+								channel.offset = entry.offset;
+								channel.size = entry.size;
+								channel.capacity = entry.capacity;
+								this->channels.push_back(channel);
+							}
+							this->schemaSequence = sequence;
+
+							if (this->onSchemaChange) {
+								this->onSchemaChange(this->channels);
+							}
+							return true;
+						}
+						return false;
+					}
+
+					Mapping mapping;
+					std::vector<Channel> channels;
+					uint64_t schemaSequence = 0;
+					uint64_t lastFrameIndex = 0;
+				};
+			}
+		}
+	}
+}
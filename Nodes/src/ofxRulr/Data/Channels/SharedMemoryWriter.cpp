@@ -0,0 +1,319 @@
+#include "pch_RulrNodes.h"
+#include "SharedMemoryWriter.h"
+
+#include "ofxRulr/Exception.h"
+
+namespace ofxRulr {
+	namespace Data {
+		namespace Channels {
+			namespace {
+				//----------
+				uint32_t align(uint32_t offset, uint32_t alignment) {
+					return (offset + alignment - 1) / alignment * alignment;
+				}
+
+				//----------
+				SharedMemory::ValueType toValueType(Channel::Type type) {
+					switch (type) {
+					case Channel::Type::Bool:
+						return SharedMemory::ValueType::Bool;
+					case Channel::Type::Int:
+					case Channel::Type::Int32:
+						return SharedMemory::ValueType::Int32;
+					case Channel::Type::Int64:
+						return SharedMemory::ValueType::Int64;
+					case Channel::Type::UInt32:
+						return SharedMemory::ValueType::UInt32;
+					case Channel::Type::UInt64:
+						return SharedMemory::ValueType::UInt64;
+					case Channel::Type::Float:
+						return SharedMemory::ValueType::Float;
+					case Channel::Type::String:
+						return SharedMemory::ValueType::String;
+					case Channel::Type::Vec3f:
+						return SharedMemory::ValueType::Vec3f;
+					case Channel::Type::Vec4f:
+						return SharedMemory::ValueType::Vec4f;
+					case Channel::Type::IntVector:
+						return SharedMemory::ValueType::IntVector;
+					default:
+						return SharedMemory::ValueType::None;
+					}
+				}
+
+				//----------
+				//characters for strings, elements for vectors
+				uint32_t getLength(const Channel & channel, SharedMemory::ValueType type) {
+					if (type == SharedMemory::ValueType::String) {
+						return (uint32_t) channel.getValue<string>().size();
+					}
+					else if (type == SharedMemory::ValueType::IntVector) {
+						return (uint32_t) channel.getValue<vector<int>>().size();
+					}
+					return 0;
+				}
+			}
+
+			//----------
+			SharedMemoryWriter::SharedMemoryWriter(const Settings & settings) :
+			settings(settings) {
+				this->settings.ringLength = max(this->settings.ringLength, 2u);
+
+				const auto schemaOffset = align(sizeof(SharedMemory::Header), 64);
+				const auto ringOffset = align(schemaOffset + this->settings.channelCapacity * sizeof(SharedMemory::SchemaEntry), 64);
+				const auto frameStride = align(sizeof(SharedMemory::FrameHeader) + this->settings.valuesCapacity, 64);
+				const auto size = (uint64_t) ringOffset + (uint64_t) frameStride * this->settings.ringLength;
+
+				if (!this->mapping.create(this->settings.name, (size_t) size)) {
+					throw(ofxRulr::Exception("Couldn't create shared memory [" + SharedMemory::getSystemName(this->settings.name) + "]"));
+				}
+
+				auto data = this->mapping.getData();
+				memset(data, 0, (size_t) size);
+
+				auto & header = this->getHeader();
+				memcpy(header.magic, SharedMemory::Magic, sizeof(header.magic));
+				header.version = SharedMemory::Version;
+				header.channelCapacity = this->settings.channelCapacity;
+				header.valuesCapacity = this->settings.valuesCapacity;
+				header.ringLength = this->settings.ringLength;
+				header.schemaOffset = schemaOffset;
+				header.ringOffset = ringOffset;
+				header.frameStride = frameStride;
+				header.size = size;
+			}
+
+			//----------
+			void SharedMemoryWriter::publish(Channel & rootChannel) {
+				if (this->schemaDirty || !this->checkSchema()) {
+					this->rebuildSchema(rootChannel);
+				}
+
+				auto & header = this->getHeader();
+				this->frameIndex++;
+				auto & frameHeader = * (SharedMemory::FrameHeader *) (this->mapping.getData() + header.ringOffset + (this->frameIndex % header.ringLength) * header.frameStride);
+				auto values = (uint8_t *) &frameHeader + sizeof(SharedMemory::FrameHeader);
+
+				const auto sequence = frameHeader.sequence.load(memory_order_relaxed);
+				frameHeader.sequence.store(sequence + 1, memory_order_relaxed);
+				atomic_thread_fence(memory_order_release);
+				{
+					frameHeader.frameIndex = this->frameIndex;
+					frameHeader.schemaSequence = header.schemaSequence.load(memory_order_relaxed);
+					frameHeader.timestamp = SharedMemory::getTimestamp();
+					frameHeader.valuesSize = this->valuesSize;
+					for (const auto & entry : this->entries) {
+						this->writeValue(entry, values);
+					}
+				}
+				frameHeader.sequence.store(sequence + 2, memory_order_release);
+
+				header.frameIndex.store(this->frameIndex, memory_order_release);
+			}
+
+			//----------
+			void SharedMemoryWriter::notifySchemaChange() {
+				this->schemaDirty = true;
+			}
+
+			//----------
+			const SharedMemoryWriter::Settings & SharedMemoryWriter::getSettings() const {
+				return this->settings;
+			}
+
+			//----------
+			uint64_t SharedMemoryWriter::getFrameIndex() const {
+				return this->frameIndex;
+			}
+
+			//----------
+			uint64_t SharedMemoryWriter::getSchemaVersion() const {
+				return ((const SharedMemory::Header *) this->mapping.getData())->schemaSequence.load(memory_order_relaxed) / 2;
+			}
+
+			//----------
+			size_t SharedMemoryWriter::getChannelCount() const {
+				return this->entries.size();
+			}
+
+			//----------
+			size_t SharedMemoryWriter::getDroppedChannelCount() const {
+				return this->droppedChannelCount;
+			}
+
+			//----------
+			void SharedMemoryWriter::rebuildSchema(Channel & rootChannel) {
+				vector<pair<string, shared_ptr<Channel>>> channels;
+				this->collectChannels(rootChannel, "", channels);
+
+				//lay out the values
+				this->entries.clear();
+				this->droppedChannelCount = 0;
+				uint32_t offset = 0;
+				for (const auto & channel : channels) {
+					Entry entry;
+					entry.address = channel.first;
+					entry.channel = channel.second;
+					entry.type = toValueType(channel.second->getValueType());
+					entry.capacity = 0;
+
+					switch (entry.type) {
+					case SharedMemory::ValueType::Bool:
+						entry.size = 1;
+						break;
+					case SharedMemory::ValueType::Int32:
+					case SharedMemory::ValueType::UInt32:
+					case SharedMemory::ValueType::Float:
+						entry.size = 4;
+						break;
+					case SharedMemory::ValueType::Int64:
+					case SharedMemory::ValueType::UInt64:
+						entry.size = 8;
+						break;
+					case SharedMemory::ValueType::Vec3f:
+						entry.size = 12;
+						break;
+					case SharedMemory::ValueType::Vec4f:
+						entry.size = 16;
+						break;
+					case SharedMemory::ValueType::String:
+						//leave room to grow so that we don't rewrite the schema every time the string changes
+						entry.capacity = max(ofNextPow2(getLength(*channel.second, entry.type) + 1), 64);
+						entry.size = sizeof(uint32_t) + entry.capacity;
+						break;
+					case SharedMemory::ValueType::IntVector:
+						entry.capacity = max(ofNextPow2(getLength(*channel.second, entry.type) + 1), 16);
+						entry.size = sizeof(uint32_t) + entry.capacity * sizeof(int32_t);
+						break;
+					default:
+						continue;
+					}
+
+					entry.offset = align(offset, 8);
+					if (entry.address.size() >= SharedMemory::AddressLength
+						|| this->entries.size() >= this->settings.channelCapacity
+						|| entry.offset + entry.size > this->settings.valuesCapacity) {
+						this->droppedChannelCount++;
+						continue;
+					}
+					offset = entry.offset + entry.size;
+					this->entries.push_back(entry);
+				}
+				this->valuesSize = offset;
+
+				if (this->droppedChannelCount > 0) {
+					ofLogWarning("Data::Channels::SharedMemoryWriter") << this->droppedChannelCount << " channels don't fit in the shared memory and won't be published";
+				}
+
+				//write the schema
+				auto & header = this->getHeader();
+				const auto sequence = header.schemaSequence.load(memory_order_relaxed);
+				header.schemaSequence.store(sequence + 1, memory_order_relaxed);
+				atomic_thread_fence(memory_order_release);
+				{
+					auto schemaEntries = (SharedMemory::SchemaEntry *) (this->mapping.getData() + header.schemaOffset);
+					for (size_t i = 0; i < this->entries.size(); i++) {
+						const auto & entry = this->entries[i];
+						auto & schemaEntry = schemaEntries[i];
+						memset(&schemaEntry, 0, sizeof(schemaEntry));
+						memcpy(schemaEntry.address, entry.address.c_str(), entry.address.size());
+						schemaEntry.type = entry.type;
+						schemaEntry.offset = entry.offset;
+						schemaEntry.size = entry.size;
+						schemaEntry.capacity = entry.capacity;
+					}
+					header.channelCount = (uint32_t) this->entries.size();
+				}
+				header.schemaSequence.store(sequence + 2, memory_order_release);
+
+				this->schemaDirty = false;
+			}
+
+			//----------
+			void SharedMemoryWriter::collectChannels(Channel & channel, const string & address, vector<pair<string, shared_ptr<Channel>>> & channels) {
+				for (auto & subChannel : channel.getSubChannels()) {
+					auto subAddress = address + "/" + subChannel.first;
+					channels.emplace_back(subAddress, subChannel.second);
+					this->collectChannels(*subChannel.second, subAddress, channels);
+				}
+			}
+
+			//----------
+			bool SharedMemoryWriter::checkSchema() const {
+				for (const auto & entry : this->entries) {
+					if (toValueType(entry.channel->getValueType()) != entry.type) {
+						return false;
+					}
+					if (entry.capacity > 0 && getLength(*entry.channel, entry.type) > entry.capacity) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			//----------
+			void SharedMemoryWriter::writeValue(const Entry & entry, uint8_t * values) const {
+				auto value = values + entry.offset;
+				const auto & channel = *entry.channel;
+
+				switch (entry.type) {
+				case SharedMemory::ValueType::Bool:
+					*value = channel.getValue<bool>() ? 1 : 0;
+					break;
+				case SharedMemory::ValueType::Int32:
+				{
+					int32_t intValue = channel.getValueType() == Channel::Type::Int
+						? (int32_t) channel.getValue<int>()
+						: channel.getValue<int32_t>();
+					memcpy(value, &intValue, sizeof(intValue));
+					break;
+				}
+				case SharedMemory::ValueType::Int64:
+					memcpy(value, &channel.getValue<int64_t>(), sizeof(int64_t));
+					break;
+				case SharedMemory::ValueType::UInt32:
+					memcpy(value, &channel.getValue<uint32_t>(), sizeof(uint32_t));
+					break;
+				case SharedMemory::ValueType::UInt64:
+					memcpy(value, &channel.getValue<uint64_t>(), sizeof(uint64_t));
+					break;
+				case SharedMemory::ValueType::Float:
+					memcpy(value, &channel.getValue<float>(), sizeof(float));
+					break;
+				case SharedMemory::ValueType::Vec3f:
+					memcpy(value, channel.getValue<ofVec3f>().getPtr(), sizeof(float) * 3);
+					break;
+				case SharedMemory::ValueType::Vec4f:
+					memcpy(value, channel.getValue<ofVec4f>().getPtr(), sizeof(float) * 4);
+					break;
+				case SharedMemory::ValueType::String:
+				{
+					const auto & stringValue = channel.getValue<string>();
+					auto length = (uint32_t) min((size_t) entry.capacity, stringValue.size());
+					memcpy(value, &length, sizeof(length));
+					memcpy(value + sizeof(length), stringValue.data(), length);
+					break;
+				}
+				case SharedMemory::ValueType::IntVector:
+				{
+					const auto & vectorValue = channel.getValue<vector<int>>();
+					auto count = (uint32_t) min((size_t) entry.capacity, vectorValue.size());
+					memcpy(value, &count, sizeof(count));
+					for (uint32_t i = 0; i < count; i++) {
+						auto element = (int32_t) vectorValue[i];
+						memcpy(value + sizeof(count) + i * sizeof(int32_t), &element, sizeof(element));
+					}
+					break;
+				}
+				default:
+					break;
+				}
+			}
+
+			//----------
+			SharedMemory::Header & SharedMemoryWriter::getHeader() {
+				return * (SharedMemory::Header *) this->mapping.getData();
+			}
+		}
+	}
+}
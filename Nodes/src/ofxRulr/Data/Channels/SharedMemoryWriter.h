@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ofxRulr/Utils/Constants.h"
+
+#include "Channel.h"
+#include "SharedMemory.h"
+
+namespace ofxRulr {
+	namespace Data {
+		namespace Channels {
+			///Publishes a channel tree into shared memory for readers on the same machine (see SharedMemory::Reader).
+			///The schema is only written again when the tree, a channel's type or the space a string or vector needs changes.
+			class RULR_EXPORTS SharedMemoryWriter {
+			public:
+				struct Settings {
+					string name = "Rulr";
+					uint32_t channelCapacity = 4096;
+					uint32_t valuesCapacity = 1 << 20; // bytes per frame
+					uint32_t ringLength = 4;
+				};
+
+				///Throws if the shared memory can't be created
+				SharedMemoryWriter(const Settings &);
+
+				void publish(Channel & rootChannel);
+
+				///Call when channels are added or removed
+				void notifySchemaChange();
+
+				const Settings & getSettings() const;
+				uint64_t getFrameIndex() const;
+				uint64_t getSchemaVersion() const;
+				size_t getChannelCount() const;
+				size_t getDroppedChannelCount() const; // didn't fit in the capacity
+			protected:
+				struct Entry {
+					string address;
+					shared_ptr<Channel> channel;
+					SharedMemory::ValueType type;
+					uint32_t offset;
+					uint32_t size;
+					uint32_t capacity;
+				};
+
+				void rebuildSchema(Channel & rootChannel);
+				void collectChannels(Channel &, const string & address, vector<pair<string, shared_ptr<Channel>>> &);
+				bool checkSchema() const;
+				void writeValue(const Entry &, uint8_t * values) const;
+
+				SharedMemory::Header & getHeader();
+
+				Settings settings;
+				SharedMemory::Mapping mapping;
+				vector<Entry> entries;
+				uint32_t valuesSize = 0;
+				size_t droppedChannelCount = 0;
+				bool schemaDirty = true;
+				uint64_t frameIndex = 0;
+			};
+		}
+	}
+}
@@ -9,35 +9,143 @@ using namespace ofxWebWidgets;
 namespace ofxRulr {
 	namespace Nodes {
 		namespace Application {
+			namespace {
+				const size_t MaxCommandResults = 256;
+
+				//----------
+				string decodeUrl(const string & encoded) {
+					string decoded;
+					for (size_t i = 0; i < encoded.size(); i++) {
+						if (encoded[i] == '%' && i + 2 < encoded.size()) {
+							decoded.push_back((char) ofHexToInt(encoded.substr(i + 1, 2)));
+							i += 2;
+						}
+						else if (encoded[i] == '+') {
+							decoded.push_back(' ');
+						}
+						else {
+							decoded.push_back(encoded[i]);
+						}
+					}
+					return decoded;
+				}
+
+				//----------
+				map<string, string> getQuery(const string & url) {
+					map<string, string> query;
+					auto queryStart = url.find('?');
+					if (queryStart == string::npos) {
+						return query;
+					}
+					for (const auto & pair : ofSplitString(url.substr(queryStart + 1), "&", true)) {
+						auto equals = pair.find('=');
+						if (equals == string::npos) {
+							query[decodeUrl(pair)] = "";
+						}
+						else {
+							query[decodeUrl(pair.substr(0, equals))] = decodeUrl(pair.substr(equals + 1));
+						}
+					}
+					return query;
+				}
+
+				//----------
+				const string & getArgument(const map<string, string> & query, const string & name) {
+					auto findArgument = query.find(name);
+					if (findArgument == query.end()) {
+						throw(ofxRulr::Exception("Missing argument [" + name + "]"));
+					}
+					return findArgument->second;
+				}
+
+				//----------
+				json toJson(const ofParameterGroup & parameters) {
+					json jsonParameters = json::object();
+					for (const auto & parameter : parameters) {
+						auto group = dynamic_pointer_cast<ofParameterGroup>(parameter);
+						if (group) {
+							jsonParameters[parameter->getName()] = toJson(*group);
+						}
+						else {
+							jsonParameters[parameter->getName()] = parameter->toString();
+						}
+					}
+					return jsonParameters;
+				}
+
+				//----------
+				shared_ptr<ofAbstractParameter> findParameter(ofParameterGroup & parameters, const string & name) {
+					for (auto & parameter : parameters) {
+						if (parameter->getName() == name) {
+							return parameter;
+						}
+						auto group = dynamic_pointer_cast<ofParameterGroup>(parameter);
+						if (group) {
+							auto subParameter = findParameter(*group, name);
+							if (subParameter) {
+								return subParameter;
+							}
+						}
+					}
+					return shared_ptr<ofAbstractParameter>();
+				}
+			}
+
 #pragma mark HTTPServerControl::RequestHandler
 			//----------
 			HTTPServerControl::RequestHandler & HTTPServerControl::RequestHandler::X() {
-				auto instance = make_unique<RequestHandler>();
-				return *instance;
+				static RequestHandler instance;
+				return instance;
 			}
 
 			//----------
 			void HTTPServerControl::RequestHandler::handleRequest(const Request & request
 				, shared_ptr<Response> & response) {
-				auto urlVector = ofSplitString(request.url, "/");
-				auto path = Path(urlVector.begin(), urlVector.end());
-				path.pop_front(); // clear the empty
-				path.pop_front(); // clear the prefix
-
 				json responseBody;
 
 				try {
 					json data;
 
-					const auto pathString = request.getPathString();
+					auto pathString = request.getPathString();
+					pathString = pathString.substr(0, pathString.find('?'));
+					const auto query = getQuery(request.url);
+
 					if (pathString == "/listNodes") {
 						data = this->listNodes();
 					}
+					else if (pathString == "/status") {
+						data = this->getStatus();
+					}
+					else if (pathString == "/nodes") {
+						data = this->getSnapshotOrThrow()->nodes;
+					}
+					else if (pathString == "/node") {
+						data = this->getNode(getArgument(query, "name"));
+					}
+					else if (pathString == "/setParameter") {
+						Command command;
+						command.type = Command::Type::SetParameter;
+						command.node = getArgument(query, "node");
+						command.parameter = getArgument(query, "parameter");
+						command.value = getArgument(query, "value");
+						data = this->queueCommand(command);
+					}
+					else if (pathString == "/runAction") {
+						Command command;
+						command.type = Command::Type::RunAction;
+						command.node = getArgument(query, "node");
+						command.action = getArgument(query, "action");
+						data = this->queueCommand(command);
+					}
+					else if (pathString == "/command") {
+						data = this->getCommandResult(ofToInt64(getArgument(query, "index")));
+					}
 					else {
 						//quit without constructing a response
 						//this is the correct pattern when 'we don't handle this'
 						return;
 					}
+					this->requestCount++;
 
 					responseBody = {
 						{ "success", true },
@@ -71,34 +179,109 @@ namespace ofxRulr {
 
 			}
 
+			//----------
+			void HTTPServerControl::RequestHandler::publishSnapshot(shared_ptr<const Snapshot> snapshot) {
+				lock_guard<mutex> lock(this->snapshotMutex);
+				this->snapshot = snapshot;
+			}
+
+			//----------
+			shared_ptr<const HTTPServerControl::Snapshot> HTTPServerControl::RequestHandler::getSnapshot() const {
+				lock_guard<mutex> lock(this->snapshotMutex);
+				return this->snapshot;
+			}
+
+			//----------
+			void HTTPServerControl::RequestHandler::setMaxQueueLength(size_t maxQueueLength) {
+				lock_guard<mutex> lock(this->commandsMutex);
+				this->maxQueueLength = maxQueueLength;
+			}
+
+			//----------
+			size_t HTTPServerControl::RequestHandler::getQueueLength() const {
+				lock_guard<mutex> lock(this->commandsMutex);
+				return this->commands.size();
+			}
+
+			//----------
+			vector<HTTPServerControl::Command> HTTPServerControl::RequestHandler::popCommands() {
+				lock_guard<mutex> lock(this->commandsMutex);
+				vector<Command> commands(this->commands.begin(), this->commands.end());
+				this->commands.clear();
+				return commands;
+			}
+
+			//----------
+			void HTTPServerControl::RequestHandler::setCommandResult(uint64_t index, const json & result) {
+				lock_guard<mutex> lock(this->commandsMutex);
+				this->commandResults[index] = result;
+				while (this->commandResults.size() > MaxCommandResults) {
+					this->commandResults.erase(this->commandResults.begin());
+				}
+			}
+
+			//----------
+			uint64_t HTTPServerControl::RequestHandler::getRequestCount() const {
+				return this->requestCount.load();
+			}
+
 			//----------
 			json HTTPServerControl::RequestHandler::listNodes() {
-				auto patch = ofxRulr::Graph::World::X().getPatch();
+				return this->getSnapshotOrThrow()->nodeList;
+			}
 
-				auto & nodeHosts = patch->getNodeHosts();
+			//----------
+			json HTTPServerControl::RequestHandler::getStatus() {
+				auto status = this->getSnapshotOrThrow()->status;
+				status["queueLength"] = this->getQueueLength();
+				return status;
+			}
 
-				json jsonNodes;
-				for (auto & it : nodeHosts) {
-					auto nodeHost = it.second;
-					if (nodeHost) {
-						json jsonNode;
-						jsonNode["index"] = it.first;
-						auto node = nodeHost->getNodeInstance();
-						if (node) {
-							jsonNode["defined"] = true;
-							jsonNode["name"] = node->getName();
-							jsonNode["typeName"] = node->getTypeName();
+			//----------
+			json HTTPServerControl::RequestHandler::getNode(const string & name) {
+				auto snapshot = this->getSnapshotOrThrow();
+				auto findNode = snapshot->nodeIndices.find(name);
+				if (findNode == snapshot->nodeIndices.end()) {
+					throw(ofxRulr::Exception("Node [" + name + "] not found"));
+				}
+				return snapshot->nodes[findNode->second];
+			}
 
-							jsonNodes.push_back(jsonNode);
-						}
-					}
+			//----------
+			json HTTPServerControl::RequestHandler::queueCommand(Command & command) {
+				lock_guard<mutex> lock(this->commandsMutex);
+				if (this->commands.size() >= this->maxQueueLength) {
+					throw(ofxRulr::Exception("Command queue is full"));
 				}
+				command.index = this->nextCommandIndex++;
+				this->commands.push_back(command);
+				this->commandResults[command.index] = json{
+					{ "queued", true }
+				};
 				return json{
-					{ "nodeCount", nodeHosts.size() },
-					{ "nodes", jsonNodes }
+					{ "index", command.index }
 				};
 			}
 
+			//----------
+			json HTTPServerControl::RequestHandler::getCommandResult(uint64_t index) {
+				lock_guard<mutex> lock(this->commandsMutex);
+				auto findResult = this->commandResults.find(index);
+				if (findResult == this->commandResults.end()) {
+					throw(ofxRulr::Exception("Command " + ofToString(index) + " not found"));
+				}
+				return findResult->second;
+			}
+
+			//----------
+			shared_ptr<const HTTPServerControl::Snapshot> HTTPServerControl::RequestHandler::getSnapshotOrThrow() const {
+				auto snapshot = this->getSnapshot();
+				if (!snapshot) {
+					throw(ofxRulr::Exception("No snapshot has been published yet"));
+				}
+				return snapshot;
+			}
+
 #pragma mark HTTPServerControl
 			//----------
 			HTTPServerControl::HTTPServerControl() {
@@ -126,6 +309,9 @@ namespace ofxRulr {
 			//----------
 			void HTTPServerControl::init() {
 				RULR_NODE_UPDATE_LISTENER;
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->manageParameters(this->parameters);
 			}
 
 			//----------
@@ -138,6 +324,136 @@ namespace ofxRulr {
 				else if (server.isRunning() && !this->parameters.run) {
 					server.stop();
 				}
+
+				if (!server.isRunning()) {
+					return;
+				}
+
+				auto & requestHandler = RequestHandler::X();
+				requestHandler.setMaxQueueLength((size_t) this->parameters.maxQueueLength.get());
+
+				//commands first so the snapshot shows what they did
+				for (const auto & command : requestHandler.popCommands()) {
+					requestHandler.setCommandResult(command.index, this->runCommand(command));
+					this->commandsRun++;
+				}
+
+				if (ofGetFrameNum() % this->parameters.snapshotInterval.get() == 0 || !requestHandler.getSnapshot()) {
+					auto startTime = chrono::high_resolution_clock::now();
+					requestHandler.publishSnapshot(this->buildSnapshot());
+					this->snapshotDuration = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+				}
+			}
+
+			//----------
+			void HTTPServerControl::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				inspector->addLiveValue<float>("Snapshot duration [ms]", [this]() {
+					return this->snapshotDuration;
+				});
+				inspector->addLiveValue<uint64_t>("Requests served", []() {
+					return RequestHandler::X().getRequestCount();
+				});
+				inspector->addLiveValue<size_t>("Commands run", [this]() {
+					return this->commandsRun;
+				});
+			}
+
+			//----------
+			shared_ptr<HTTPServerControl::Snapshot> HTTPServerControl::buildSnapshot() const {
+				auto snapshot = make_shared<Snapshot>();
+
+				json jsonNodeList = json::array();
+				json jsonNodes = json::array();
+
+				static const ofxRulr::Graph::Editor::Patch::NodeHostSet noNodeHosts;
+				auto patch = ofxRulr::Graph::World::X().getPatch();
+				const auto & nodeHosts = patch ? patch->getNodeHosts() : noNodeHosts;
+
+				for (auto & it : nodeHosts) {
+					auto nodeHost = it.second;
+					if (nodeHost) {
+						auto node = nodeHost->getNodeInstance();
+						if (node) {
+							json jsonNode;
+							jsonNode["index"] = it.first;
+							jsonNode["defined"] = true;
+							jsonNode["name"] = node->getName();
+							jsonNode["typeName"] = node->getTypeName();
+							jsonNodeList.push_back(jsonNode);
+
+							json jsonParameters = json::object();
+							for (auto parameters : node->getManagedParameters()) {
+								jsonParameters[parameters->getName()] = toJson(*parameters);
+							}
+							jsonNode["parameters"] = jsonParameters;
+							jsonNode["actions"] = node->getActionNames();
+
+							snapshot->nodeIndices[node->getName()] = jsonNodes.size();
+							jsonNodes.push_back(jsonNode);
+						}
+					}
+				}
+
+				snapshot->nodeList = json{
+					{ "nodeCount", nodeHosts.size() },
+					{ "nodes", jsonNodeList }
+				};
+				snapshot->nodes = jsonNodes;
+				snapshot->status = json{
+					{ "frameIndex", ofGetFrameNum() },
+					{ "time", ofGetElapsedTimef() },
+					{ "frameRate", ofGetFrameRate() },
+					{ "frameTime", ofGetLastFrameTime() * 1000.0 }, // ms
+					{ "nodeCount", nodeHosts.size() },
+					{ "snapshotDuration", this->snapshotDuration } // ms, of the previous snapshot
+				};
+
+				return snapshot;
+			}
+
+			//----------
+			json HTTPServerControl::runCommand(const Command & command) {
+				try {
+					auto node = ofxRulr::Graph::World::X().findNode(command.node);
+					if (!node) {
+						throw(ofxRulr::Exception("Node [" + command.node + "] not found"));
+					}
+
+					switch (command.type) {
+					case Command::Type::SetParameter:
+					{
+						for (auto parameters : node->getManagedParameters()) {
+							auto parameter = findParameter(*parameters, command.parameter);
+							if (parameter) {
+								parameter->fromString(command.value);
+								return json{
+									{ "success", true },
+									{ "value", parameter->toString() }
+								};
+							}
+						}
+						throw(ofxRulr::Exception("Parameter [" + command.parameter + "] not found in [" + command.node + "]"));
+					}
+					case Command::Type::RunAction:
+					{
+						Json::Value report;
+						node->runAction(command.action, report);
+						return json{
+							{ "success", true },
+							{ "report", json::parse(Json::FastWriter().write(report)) }
+						};
+					}
+					default:
+						throw(ofxRulr::Exception("Unknown command"));
+					}
+				}
+				catch (const std::exception & e) {
+					return json{
+						{ "success", false },
+						{ "error", e.what() }
+					};
+				}
 			}
 		}
 	}
@@ -6,16 +6,70 @@
 namespace ofxRulr {
 	namespace Nodes {
 		namespace Application {
+			///Requests are served on the web server's threads from a snapshot of the patch which update() publishes,
+			///so they never touch the live nodes. Requests which change the patch are queued and run in update().
+			///
+			///	/status, /listNodes, /nodes, /node?name=
+			///	/setParameter?node=&parameter=&value=, /runAction?node=&action= (both reply with a command index)
+			///	/command?index= (the result of a queued command)
 			class HTTPServerControl : public Nodes::Base {
 			public:
+				///Built on the main thread and never changed after it's published
+				struct Snapshot {
+					json status;
+					json nodeList; // as /listNodes has always returned
+					json nodes; // with parameters and actions
+					map<string, size_t> nodeIndices; // by name, into nodes
+				};
+
+				struct Command {
+					enum Type {
+						SetParameter,
+						RunAction
+					};
+
+					uint64_t index = 0;
+					Type type = SetParameter;
+					string node;
+					string parameter;
+					string value;
+					string action;
+				};
+
 				class RequestHandler : public ofxWebWidgets::RequestHandler {
 				public:
 					static RequestHandler & X();
 					void handleRequest(const ofxWebWidgets::Request & request, shared_ptr<ofxWebWidgets::Response> & response) override;
 					RequestHandler();
+
+					void publishSnapshot(shared_ptr<const Snapshot>);
+					shared_ptr<const Snapshot> getSnapshot() const;
+
+					void setMaxQueueLength(size_t);
+					size_t getQueueLength() const;
+					vector<Command> popCommands();
+					void setCommandResult(uint64_t index, const json & result);
+
+					uint64_t getRequestCount() const;
 				protected:
 					json listNodes();
+					json getStatus();
+					json getNode(const string & name);
+					json queueCommand(Command &);
+					json getCommandResult(uint64_t index);
+
+					shared_ptr<const Snapshot> getSnapshotOrThrow() const;
+
+					mutable mutex snapshotMutex;
+					shared_ptr<const Snapshot> snapshot;
 
+					mutable mutex commandsMutex;
+					deque<Command> commands;
+					size_t maxQueueLength = 64;
+					uint64_t nextCommandIndex = 1;
+					map<uint64_t, json> commandResults; // the most recent
+
+					atomic<uint64_t> requestCount{ 0 };
 				};
 
 				HTTPServerControl();
@@ -23,11 +77,20 @@ namespace ofxRulr {
 				string getTypeName() const override;
 				void init();
 				void update();
+				void populateInspector(ofxCvGui::InspectArguments &);
 			protected:
+				shared_ptr<Snapshot> buildSnapshot() const;
+				json runCommand(const Command &);
+
 				struct : ofParameterGroup {
 					ofParameter<bool> run { "Run", false};
-					PARAM_DECLARE("HTTPServerControl", run)
+					ofParameter<int> snapshotInterval{ "Snapshot interval [frames]", 1, 1, 600 };
+					ofParameter<int> maxQueueLength{ "Max queue length", 64, 1, 10000 };
+					PARAM_DECLARE("HTTPServerControl", run, snapshotInterval, maxQueueLength);
 				} parameters;
+
+				float snapshotDuration = 0.0f; // ms
+				size_t commandsRun = 0;
 			};
 		}
 	}
@@ -3,14 +3,13 @@
 
 #include "ofxRulr/Nodes/Item/RigidBody.h"
 #include "ofxRulr/Nodes/DMX/MovingHead.h"
+#include "ofxRulr/Nodes/DMX/Transmit.h"
 
 #include "ofxCvGui/Widgets/Toggle.h"
 #include "ofxCvGui/Widgets/Slider.h"
 #include "ofxCvGui/Widgets/Title.h"
 #include "ofxCvGui/Widgets/LiveValue.h"
 
-#include "ofxRulr/Utils/PolyFit.h"
-
 #include "ofxCvMin.h"
 
 using namespace ofxCvGui;
@@ -24,6 +23,13 @@ namespace ofxRulr {
 				RULR_NODE_INIT_LISTENER;
 			}
 
+			//----------
+			AimMovingHeadAt::~AimMovingHeadAt() {
+				this->clearThreadedOutput();
+
+				this->unsubscribePoseSamples();
+			}
+
 			//----------
 			void AimMovingHeadAt::init() {
 				RULR_NODE_UPDATE_LISTENER;
@@ -31,7 +37,26 @@ namespace ofxRulr {
 				RULR_NODE_SERIALIZATION_LISTENERS;
 
 				this->addInput<MovingHead>();
-				this->addInput<Item::RigidBody>("Target");
+				auto targetInput = this->addInput<Item::RigidBody>("Target");
+				targetInput->onNewConnection += [this](shared_ptr<Item::RigidBody> target) {
+					this->unsubscribePoseSamples();
+					this->poseSampleSource = target;
+					target->addPoseSampleListener([this](Item::RigidBody::PoseSample & poseSample) {
+						{
+							auto lock = unique_lock<mutex>(this->filterMutex);
+							this->filter.lastPipelineSampleTime = Clock::now();
+							this->filter.hasPipelineSamples = true;
+						}
+						this->statistics.fromPipeline.store(true);
+						this->addPoseSample(poseSample);
+					}, this);
+				};
+				targetInput->onDeleteConnection += [this](shared_ptr<Item::RigidBody>) {
+					this->unsubscribePoseSamples();
+					auto lock = unique_lock<mutex>(this->filterMutex);
+					this->filter.state.isTracking = false;
+					this->filter.hasPipelineSamples = false;
+				};
 
 				this->ignoreBlankTransform.set("Ignore blank transform", true);
 
@@ -43,15 +68,21 @@ namespace ofxRulr {
 
 				//prediction
 				{
-					this->steveJobs.enabled.set("Enabled", false);
-					this->steveJobs.steps.set("Steps", 10, 0, 1000);
-					this->steveJobs.minimumVelocity.set("Minimum velocity [m/s]", 1.0f, 0.0f, 20.0f);
-					this->steveJobs.maximumAcceleration.set("Maximum acceleration [m/s^2]", 1.0f, 0.0f, 10.0f);
-					this->steveJobs.kalmanFilter = KalmanFilter(6, 3, 0);
-					this->steveJobs.measurmentVector = Mat_<float>(3, 1);
-					this->steveJobs.isTracking = false;
-					this->steveJobs.velocityOK = false;
-					this->steveJobs.accelerationOK = false;
+					this->prediction.enabled.set("Enabled", false);
+					this->prediction.latency.set("System latency [ms]", 80.0f, 0.0f, 500.0f);
+					this->prediction.maximumHorizon.set("Maximum horizon [ms]", 250.0f, 0.0f, 1000.0f);
+					this->prediction.constantAcceleration.set("Constant acceleration model", false);
+					this->prediction.processNoise.set("Process noise", 10.0f, 0.0f, 1000.0f);
+					this->prediction.measurementNoise.set("Measurement noise [m]", 0.01f, 0.0001f, 1.0f);
+					this->prediction.sampleTimeout.set("Pipeline sample timeout [ms]", 500.0f, 0.0f, 5000.0f);
+					this->prediction.outputAtDMXRate.set("Output at DMX rate", true);
+
+					this->legacyPrediction.steps.set("Steps", 10, 0, 1000);
+					this->legacyPrediction.minimumVelocity.set("Minimum velocity [m/s]", 1.0f, 0.0f, 20.0f);
+					this->legacyPrediction.maximumAcceleration.set("Maximum acceleration [m/s^2]", 1.0f, 0.0f, 10.0f);
+
+					this->filter.kalmanFilter = KalmanFilter(9, 3, 0, CV_32F);
+					this->filter.measurement = Mat_<float>(3, 1);
 				}
 			}
 
@@ -62,6 +93,14 @@ namespace ofxRulr {
 
 			//----------
 			void AimMovingHeadAt::update() {
+				//pass parameters to other threads
+				this->threadParameters.ignoreBlankTransform.store(this->ignoreBlankTransform.get());
+				this->threadParameters.latency.store(this->prediction.latency.get() / 1000.0f);
+				this->threadParameters.maximumHorizon.store(this->prediction.maximumHorizon.get() / 1000.0f);
+				this->threadParameters.constantAcceleration.store(this->prediction.constantAcceleration.get());
+				this->threadParameters.processNoise.store(this->prediction.processNoise.get());
+				this->threadParameters.measurementNoise.store(this->prediction.measurementNoise.get());
+
 				auto movingHead = this->getInput<MovingHead>();
 				auto target = this->getInput<Item::RigidBody>("Target");
 				if (target && movingHead) {
@@ -69,22 +108,44 @@ namespace ofxRulr {
 						//check if transform is blank before using it (blank can be an indicator of bad tracking)
 						if (this->ignoreBlankTransform) {
 							if (target->getTransform().isIdentity()) {
-								this->steveJobs.isTracking = false;
+								auto lock = unique_lock<mutex>(this->filterMutex);
+								this->filter.state.isTracking = false;
 								throw(Exception("Target has no position data"));
 							}
 						}
 
+						//if the target isn't receiving timestamped samples from a tracking pipeline, sample it once per app frame
+						{
+							bool pipelineActive;
+							{
+								auto lock = unique_lock<mutex>(this->filterMutex);
+								chrono::duration<float, milli> sinceLastPipelineSample = Clock::now() - this->filter.lastPipelineSampleTime;
+								pipelineActive = this->filter.hasPipelineSamples && sinceLastPipelineSample.count() < this->prediction.sampleTimeout;
+							}
+							if (!pipelineActive) {
+								this->statistics.fromPipeline.store(false);
+								Item::RigidBody::PoseSample poseSample;
+								poseSample.timestamp = Clock::now();
+								poseSample.position = target->getPosition();
+								poseSample.rotation = target->getRotationQuat();
+								this->addPoseSample(poseSample);
+							}
+						}
+
 						//get either the raw position or the predicted position
 						ofVec3f aimFor;
-						if(this->steveJobs.enabled) {
-							aimFor = this->doASteveJobs(target->getPosition());
+						ofQuaternion objectRotation;
+						auto filterState = this->getFilterState();
+						if (this->prediction.enabled && filterState.isTracking) {
+							aimFor = this->predictPosition(filterState, Clock::now());
+							objectRotation = filterState.rotation;
 						}
 						else {
 							aimFor = target->getPosition();
+							objectRotation = target->getRotationQuat();
 						}
 
 						//calculate the position offset in target coords
-						const auto objectRotation = target->getRotationQuat();
 						const auto offset = this->getObjectPositionOffset() * objectRotation;
 
 						//perform the lookAt
@@ -93,7 +154,16 @@ namespace ofxRulr {
 					RULR_CATCH_ALL_TO_ERROR;
 				}
 				else {
-					this->steveJobs.isTracking = false;
+					auto lock = unique_lock<mutex>(this->filterMutex);
+					this->filter.state.isTracking = false;
+				}
+
+				//re-aim on the DMX transmit thread if we can
+				if (movingHead && this->prediction.enabled && this->prediction.outputAtDMXRate) {
+					this->updateThreadedOutput(movingHead);
+				}
+				else {
+					this->clearThreadedOutput();
 				}
 			}
 
@@ -107,10 +177,18 @@ namespace ofxRulr {
 
 				auto & jsonPrediction = json["prediction"];
 				{
-					Utils::Serializable::serialize(jsonPrediction, this->steveJobs.enabled);
-					Utils::Serializable::serialize(jsonPrediction, this->steveJobs.steps);
-					Utils::Serializable::serialize(jsonPrediction, this->steveJobs.minimumVelocity);
-					Utils::Serializable::serialize(jsonPrediction, this->steveJobs.maximumAcceleration);
+					Utils::Serializable::serialize(jsonPrediction, this->prediction.enabled);
+					Utils::Serializable::serialize(jsonPrediction, this->prediction.latency);
+					Utils::Serializable::serialize(jsonPrediction, this->prediction.maximumHorizon);
+					Utils::Serializable::serialize(jsonPrediction, this->prediction.constantAcceleration);
+					Utils::Serializable::serialize(jsonPrediction, this->prediction.processNoise);
+					Utils::Serializable::serialize(jsonPrediction, this->prediction.measurementNoise);
+					Utils::Serializable::serialize(jsonPrediction, this->prediction.sampleTimeout);
+					Utils::Serializable::serialize(jsonPrediction, this->prediction.outputAtDMXRate);
+
+					Utils::Serializable::serialize(jsonPrediction, this->legacyPrediction.steps);
+					Utils::Serializable::serialize(jsonPrediction, this->legacyPrediction.minimumVelocity);
+					Utils::Serializable::serialize(jsonPrediction, this->legacyPrediction.maximumAcceleration);
 				}
 			}
 
@@ -124,17 +202,25 @@ namespace ofxRulr {
 
 				const auto & jsonPrediction = json["prediction"];
 				{
-					Utils::Serializable::deserialize(jsonPrediction, this->steveJobs.enabled);
-					Utils::Serializable::deserialize(jsonPrediction, this->steveJobs.steps);
-					Utils::Serializable::deserialize(jsonPrediction, this->steveJobs.minimumVelocity);
-					Utils::Serializable::deserialize(jsonPrediction, this->steveJobs.maximumAcceleration);
+					Utils::Serializable::deserialize(jsonPrediction, this->prediction.enabled);
+					Utils::Serializable::deserialize(jsonPrediction, this->prediction.latency);
+					Utils::Serializable::deserialize(jsonPrediction, this->prediction.maximumHorizon);
+					Utils::Serializable::deserialize(jsonPrediction, this->prediction.constantAcceleration);
+					Utils::Serializable::deserialize(jsonPrediction, this->prediction.processNoise);
+					Utils::Serializable::deserialize(jsonPrediction, this->prediction.measurementNoise);
+					Utils::Serializable::deserialize(jsonPrediction, this->prediction.sampleTimeout);
+					Utils::Serializable::deserialize(jsonPrediction, this->prediction.outputAtDMXRate);
+
+					Utils::Serializable::deserialize(jsonPrediction, this->legacyPrediction.steps);
+					Utils::Serializable::deserialize(jsonPrediction, this->legacyPrediction.minimumVelocity);
+					Utils::Serializable::deserialize(jsonPrediction, this->legacyPrediction.maximumAcceleration);
 				}
 			}
 
 			//----------
 			void AimMovingHeadAt::populateInspector(ofxCvGui::InspectArguments & inspectArguments) {
 				auto inspector = inspectArguments.inspector;
-				
+
 				inspector->add(new Widgets::Toggle(this->ignoreBlankTransform));
 
 				inspector->add(new Widgets::Title("Position offset", Widgets::Title::Level::H2));
@@ -142,47 +228,38 @@ namespace ofxRulr {
 					inspector->add(new Widgets::Slider(this->objectPositionOffset[i]));
 				}
 
-				inspector->add(new Widgets::Title("Steve Jobs Mode", Widgets::Title::Level::H2));
+				inspector->add(new Widgets::Title("Prediction", Widgets::Title::Level::H2));
 				{
-					inspector->add(new Widgets::Title("Prediction", Widgets::Title::Level::H3));
-					inspector->add(new Widgets::Toggle(this->steveJobs.enabled));
-					inspector->add(new Widgets::Slider(this->steveJobs.steps));
-
-					inspector->add(new Widgets::Title("Velocity", Widgets::Title::Level::H3));
-					{
-						inspector->add(new Widgets::Slider(this->steveJobs.minimumVelocity));
-						auto velocityWidget = new Widgets::LiveValueHistory("Velocity", [this]() {
-							return this->steveJobs.velocity.length();
-						});
-						velocityWidget->onDraw += [this](DrawArguments & args) {
-							if (this->steveJobs.velocityOK) {
-								ofPushStyle();
-								ofFill();
-								ofSetColor(100, 200, 100);
-								ofDrawCircle(args.localBounds.width - 10, 10, 8.0f);
-								ofPopStyle();
-							}
-						};
-						inspector->add(velocityWidget);
-					}
-
-					inspector->add(new Widgets::Title("Acceleration", Widgets::Title::Level::H3));
-					{
-						inspector->add(new Widgets::Slider(this->steveJobs.maximumAcceleration));
-						auto accelerationWidget = new Widgets::LiveValueHistory("Acceleration", [this]() {
-							return this->steveJobs.acceleration.length();
-						});
-						accelerationWidget->onDraw += [this](DrawArguments & args) {
-							if (this->steveJobs.accelerationOK) {
-								ofPushStyle();
-								ofFill();
-								ofSetColor(100, 200, 100);
-								ofDrawCircle(args.localBounds.width - 10, 10, 8.0f);
-								ofPopStyle();
-							}
-						};
-						inspector->add(accelerationWidget);
-					}
+					inspector->add(new Widgets::Toggle(this->prediction.enabled));
+					inspector->add(new Widgets::Slider(this->prediction.latency));
+					inspector->add(new Widgets::Slider(this->prediction.maximumHorizon));
+					inspector->add(new Widgets::Toggle(this->prediction.outputAtDMXRate));
+
+					inspector->add(new Widgets::Title("Filter", Widgets::Title::Level::H3));
+					inspector->add(new Widgets::Toggle(this->prediction.constantAcceleration));
+					inspector->add(new Widgets::Slider(this->prediction.processNoise));
+					inspector->add(new Widgets::Slider(this->prediction.measurementNoise));
+					inspector->add(new Widgets::Slider(this->prediction.sampleTimeout));
+
+					inspector->add(new Widgets::Title("Status", Widgets::Title::Level::H3));
+					inspector->add(new Widgets::LiveValue<string>("Sample source", [this]() {
+						return this->statistics.fromPipeline.load() ? string("Tracking pipeline") : string("App frame");
+					}));
+					inspector->add(new Widgets::LiveValue<string>("Output", [this]() {
+						return this->outputTransmit.expired() ? string("App frame") : string("DMX transmit thread");
+					}));
+					inspector->add(new Widgets::LiveValueHistory("Sample interval [ms]", [this]() {
+						return this->statistics.sampleInterval.load();
+					}));
+					inspector->add(new Widgets::LiveValueHistory("Innovation [mm]", [this]() {
+						return this->statistics.innovation.load() * 1000.0f;
+					}));
+					inspector->add(new Widgets::LiveValueHistory("Prediction horizon [ms]", [this]() {
+						return this->statistics.horizon.load();
+					}));
+					inspector->add(new Widgets::LiveValueHistory("Velocity [m/s]", [this]() {
+						return this->getFilterState().velocity.length();
+					}));
 				}
 			}
 
@@ -206,124 +283,220 @@ namespace ofxRulr {
 			}
 
 			//----------
-			ofVec3f AimMovingHeadAt::doASteveJobs(const ofVec3f & targetPosition) {
-				//we presume a constant frame rate (necessary for Kalman filter)
+			void AimMovingHeadAt::addPoseSample(const Item::RigidBody::PoseSample & poseSample) {
+				if (this->threadParameters.ignoreBlankTransform.load() && poseSample.position == ofVec3f() && poseSample.rotation == ofQuaternion()) {
+					return;
+				}
 
-				auto dt = ofGetLastFrameTime();
+				auto lock = unique_lock<mutex>(this->filterMutex);
+				auto & state = this->filter.state;
 
-				if (!this->steveJobs.isTracking) {
-					//initialise the tracking
-					this->initPrediction(targetPosition);
-					this->steveJobs.isTracking = true;
-					this->steveJobs.position = targetPosition;
+				chrono::duration<float> dt = poseSample.timestamp - state.timestamp;
+				if (!state.isTracking || dt.count() > 1.0f) {
+					//start again if we've lost track for too long
+					this->initFilter(poseSample);
+					return;
 				}
-				else {
-					//update the velocity and acceleration
-					auto newVelocity = (targetPosition - this->steveJobs.position) / dt;
-					auto newAcceleration = ((newVelocity - this->steveJobs.velocity) / dt) / ofGetFrameRate();
-					this->steveJobs.acceleration = this->steveJobs.acceleration * 0.99f + newAcceleration * 0.01f;
-					this->steveJobs.velocity = this->steveJobs.velocity * 0.99f + newVelocity * 0.01f;
-					this->steveJobs.position = targetPosition;
+				if (dt.count() <= 0.0f) {
+					//out of order or duplicate
+					return;
 				}
+				this->statistics.sampleInterval.store(dt.count() * 1000.0f);
 
+				//state is [position, velocity, acceleration] for each axis, rebuild the model for this sample's dt
+				{
+					const auto constantAcceleration = this->threadParameters.constantAcceleration.load();
+					const auto q = this->threadParameters.processNoise.load();
+					const auto r = this->threadParameters.measurementNoise.load();
+					const auto t = dt.count();
+
+					Mat_<float> transition = Mat_<float>::eye(9, 9);
+					Mat_<float> processNoise = Mat_<float>::zeros(9, 9);
+					for (int i = 0; i < 3; i++) {
+						const int p = i;
+						const int v = 3 + i;
+						const int a = 6 + i;
+						transition(p, v) = t;
+						if (constantAcceleration) {
+							//white noise jerk
+							transition(p, a) = t * t / 2.0f;
+							transition(v, a) = t;
+
+							processNoise(p, p) = q * pow(t, 5) / 20.0f;
+							processNoise(p, v) = processNoise(v, p) = q * pow(t, 4) / 8.0f;
+							processNoise(p, a) = processNoise(a, p) = q * pow(t, 3) / 6.0f;
+							processNoise(v, v) = q * pow(t, 3) / 3.0f;
+							processNoise(v, a) = processNoise(a, v) = q * t * t / 2.0f;
+							processNoise(a, a) = q * t;
+						}
+						else {
+							//white noise acceleration, acceleration state is held at zero
+							transition(a, a) = 0.0f;
 
+							processNoise(p, p) = q * pow(t, 3) / 3.0f;
+							processNoise(p, v) = processNoise(v, p) = q * t * t / 2.0f;
+							processNoise(v, v) = q * t;
+						}
+					}
+					this->filter.kalmanFilter.transitionMatrix = transition;
+					this->filter.kalmanFilter.processNoiseCov = processNoise;
+					setIdentity(this->filter.kalmanFilter.measurementNoiseCov, Scalar::all(r * r));
+				}
 
-				//--
-				//normal kalman operation
-				//--
-				//
-				auto prediction = this->steveJobs.kalmanFilter.predict();
+				auto predicted = this->filter.kalmanFilter.predict();
 				for (int i = 0; i < 3; i++) {
-					this->steveJobs.measurmentVector.at<float>(i) = targetPosition[i];
-				}
-				auto corrected = this->steveJobs.kalmanFilter.correct(this->steveJobs.measurmentVector);
-				//
-				//--
-
-
-
-				//--
-				//if we dont' meet the thresholds, just pass through the raw tracking data
-				//--
-				//
-				this->steveJobs.velocityOK = this->steveJobs.velocity.length() > this->steveJobs.minimumVelocity;
-				this->steveJobs.accelerationOK = this->steveJobs.acceleration.length() < this->steveJobs.maximumAcceleration;
-				if(!this->steveJobs.velocityOK && this->steveJobs.accelerationOK) {
-					return targetPosition;
-				}
-				//
-				//--
-
-
-
-				//--
-				//calculate the future after 30 frames
-				//--
-				//
-				auto futureKalman = KalmanFilter(4, 2, 0);
-#define COPY_ATTRIB(TARGET, SOURCE, ATTRIBUTE) TARGET.ATTRIBUTE = SOURCE.ATTRIBUTE.clone()
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, errorCovPost);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, errorCovPre);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, gain);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, measurementMatrix);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, measurementNoiseCov);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, processNoiseCov);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, statePost);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, statePre);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, transitionMatrix);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, temp1);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, temp2);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, temp3);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, temp4);
-				COPY_ATTRIB(futureKalman, this->steveJobs.kalmanFilter, temp5);
-				for (int i = 0; i < this->steveJobs.steps; i++) {
-					futureKalman.statePost = futureKalman.predict();
-				}
-				auto theNextIPad = futureKalman.predict();
-				//
-				//--
-
-
-
-				//copy the future predicted state back into the measurement position we'll use
-				ofVec3f futurePosition;
+					this->filter.measurement.at<float>(i) = poseSample.position[i];
+				}
+				{
+					ofVec3f innovation;
+					for (int i = 0; i < 3; i++) {
+						innovation[i] = poseSample.position[i] - predicted.at<float>(i);
+					}
+					this->statistics.innovation.store(innovation.length());
+				}
+				auto corrected = this->filter.kalmanFilter.correct(this->filter.measurement);
+
 				for (int i = 0; i < 3; i++) {
-					futurePosition[i] = theNextIPad.at<float>(i);
+					state.position[i] = corrected.at<float>(i);
+					state.velocity[i] = corrected.at<float>(3 + i);
+					state.acceleration[i] = corrected.at<float>(6 + i);
 				}
-				return futurePosition;
+				state.rotation = poseSample.rotation;
+				state.timestamp = poseSample.timestamp;
+			}
+
+			//----------
+			AimMovingHeadAt::FilterState AimMovingHeadAt::getFilterState() const {
+				auto lock = unique_lock<mutex>(this->filterMutex);
+				return this->filter.state;
 			}
 
 			//----------
-			void AimMovingHeadAt::initPrediction(const ofVec3f & startPostiion) {
-				//state
-				//x, y, vx, vy
-
-				//transition
-				this->steveJobs.kalmanFilter.transitionMatrix = Mat_<float>(6, 6) <<
-					1, 0, 0, 1, 0, 0,
-					0, 1, 0, 0, 1, 0,
-					0, 0, 1, 0, 0, 1,
-					0, 0, 0, 1, 0, 0,
-					0, 0, 0, 0, 1, 0,
-					0, 0, 0, 0, 0, 1;
-				
+			ofVec3f AimMovingHeadAt::predictPosition(const FilterState & state, const Clock::time_point & time) {
+				//time since the sample was measured plus the time for the head to get there
+				chrono::duration<float> sinceSample = time - state.timestamp;
+				auto horizon = sinceSample.count() + this->threadParameters.latency.load();
+				horizon = ofClamp(horizon, 0.0f, this->threadParameters.maximumHorizon.load());
+				this->statistics.horizon.store(horizon * 1000.0f);
+
+				auto position = state.position + state.velocity * horizon;
+				if (this->threadParameters.constantAcceleration.load()) {
+					position += state.acceleration * (horizon * horizon / 2.0f);
+				}
+				return position;
+			}
+
+			//----------
+			void AimMovingHeadAt::initFilter(const Item::RigidBody::PoseSample & poseSample) {
+				auto & kalmanFilter = this->filter.kalmanFilter;
+
 				//opening state (presume no velocity to begin)
-				this->steveJobs.kalmanFilter.statePre.at<float>(0) = startPostiion.x;
-				this->steveJobs.kalmanFilter.statePre.at<float>(1) = startPostiion.y;
-				this->steveJobs.kalmanFilter.statePre.at<float>(2) = startPostiion.z;
-				this->steveJobs.kalmanFilter.statePre.at<float>(3) = 0.0f;
-				this->steveJobs.kalmanFilter.statePre.at<float>(4) = 0.0f;
-				this->steveJobs.kalmanFilter.statePre.at<float>(5) = 0.0f;
-
-				setIdentity(this->steveJobs.kalmanFilter.measurementMatrix);
-				setIdentity(this->steveJobs.kalmanFilter.processNoiseCov, Scalar::all(1e-4));
-				setIdentity(this->steveJobs.kalmanFilter.measurementNoiseCov, Scalar::all(1));
-				setIdentity(this->steveJobs.kalmanFilter.errorCovPre, Scalar::all(0.1));
-
-				this->steveJobs.isTracking = true;
-				this->steveJobs.position = ofVec3f();
-				this->steveJobs.velocity = ofVec3f();
-				this->steveJobs.acceleration = ofVec3f();
+				kalmanFilter.statePost = Mat_<float>::zeros(9, 1);
+				for (int i = 0; i < 3; i++) {
+					kalmanFilter.statePost.at<float>(i) = poseSample.position[i];
+				}
+
+				kalmanFilter.measurementMatrix = Mat_<float>::zeros(3, 9);
+				for (int i = 0; i < 3; i++) {
+					kalmanFilter.measurementMatrix.at<float>(i, i) = 1.0f;
+				}
+
+				//we're sure of the position, but not of the motion
+				const auto r = this->threadParameters.measurementNoise.load();
+				kalmanFilter.errorCovPost = Mat_<float>::zeros(9, 9);
+				for (int i = 0; i < 3; i++) {
+					kalmanFilter.errorCovPost.at<float>(i, i) = r * r;
+					kalmanFilter.errorCovPost.at<float>(3 + i, 3 + i) = 10.0f;
+					kalmanFilter.errorCovPost.at<float>(6 + i, 6 + i) = 10.0f;
+				}
+
+				auto & state = this->filter.state;
+				state.isTracking = true;
+				state.timestamp = poseSample.timestamp;
+				state.position = poseSample.position;
+				state.velocity = ofVec3f();
+				state.acceleration = ofVec3f();
+				state.rotation = poseSample.rotation;
+			}
+
+			//----------
+			void AimMovingHeadAt::updateThreadedOutput(shared_ptr<MovingHead> movingHead) {
+				//check the moving head can encode pan / tilt for us
+				if (!movingHead->canEncodePanTilt()) {
+					this->clearThreadedOutput();
+					return;
+				}
+
+				auto transmit = movingHead->getInput<Transmit>();
+				if (!transmit) {
+					this->clearThreadedOutput();
+					return;
+				}
+
+				//cache what the transmit thread needs to know about the moving head
+				{
+					auto lock = unique_lock<mutex>(this->outputTargetMutex);
+					this->outputTarget.movingHead = movingHead;
+					this->outputTarget.worldToMovingHead = movingHead->getTransform().getInverse();
+					this->outputTarget.tiltOffset = movingHead->getTiltOffset();
+					this->outputTarget.panTiltRange = movingHead->getPanTiltRange();
+					this->outputTarget.objectPositionOffset = this->getObjectPositionOffset();
+					this->outputTarget.channelIndex = movingHead->getChannelIndex();
+					this->outputTarget.channelCount = movingHead->getChannels().size();
+				}
+
+				//register with the transmitter (or move to a new one)
+				auto universeIndex = movingHead->getUniverseIndex();
+				if (this->outputTransmit.lock() != transmit || this->outputUniverseIndex != universeIndex) {
+					this->clearThreadedOutput();
+					transmit->setThreadedChannelGenerator(this, universeIndex, [this](const Clock::time_point & sendTime, Value * channels) {
+						this->generateChannels(sendTime, channels);
+					});
+					this->outputTransmit = transmit;
+					this->outputUniverseIndex = universeIndex;
+				}
+			}
+
+			//----------
+			void AimMovingHeadAt::clearThreadedOutput() {
+				auto transmit = this->outputTransmit.lock();
+				if (transmit) {
+					transmit->clearThreadedChannelGenerator(this);
+				}
+				this->outputTransmit.reset();
+			}
+
+			//----------
+			void AimMovingHeadAt::unsubscribePoseSamples() {
+				auto source = this->poseSampleSource.lock();
+				if (source) {
+					source->removePoseSampleListeners(this);
+				}
+				this->poseSampleSource.reset();
+			}
+
+			//----------
+			void AimMovingHeadAt::generateChannels(const Clock::time_point & sendTime, Value * channels) {
+				//called on the transmit thread
+				auto filterState = this->getFilterState();
+				if (!filterState.isTracking) {
+					//leave the values from the app frame
+					return;
+				}
+
+				OutputTarget outputTarget;
+				{
+					auto lock = unique_lock<mutex>(this->outputTargetMutex);
+					outputTarget = this->outputTarget;
+				}
+				auto movingHead = outputTarget.movingHead.lock();
+				if (!movingHead || outputTarget.channelIndex + outputTarget.channelCount > 513) {
+					return;
+				}
+
+				auto aimFor = this->predictPosition(filterState, sendTime) + outputTarget.objectPositionOffset * filterState.rotation;
+				auto panTilt = MovingHead::getPanTiltForTargetInObjectSpace(aimFor * outputTarget.worldToMovingHead, outputTarget.tiltOffset);
+				movingHead->encodePanTilt(panTilt, outputTarget.panTiltRange, channels + outputTarget.channelIndex);
 			}
 		}
 	}
@@ -1,14 +1,29 @@
 #pragma once
 
 #include "ofxRulr/Nodes/Base.h"
+#include "ofxRulr/Nodes/Item/RigidBody.h"
 #include "ofxCvMin.h"
 
+#include "Base.h"
+#include "MovingHead.h"
+
+#include <atomic>
+#include <chrono>
+
 namespace ofxRulr {
 	namespace Nodes {
 		namespace DMX {
+			class Transmit;
+
+			///With prediction enabled, timestamped pose samples of the target (e.g. announced by MoCap::UpdateTracking
+			///from its processing thread) feed a Kalman filter, and the aim point is extrapolated forwards by the system latency.
+			///If the moving head can encode pan / tilt directly, the aim is re-evaluated for every DMX frame on the transmit thread.
 			class AimMovingHeadAt : public Nodes::Base {
 			public:
+				typedef chrono::high_resolution_clock Clock;
+
 				AimMovingHeadAt();
+				virtual ~AimMovingHeadAt();
 				void init();
 				string getTypeName() const override;
 				void update();
@@ -25,28 +40,90 @@ namespace ofxRulr {
 				string getTargetName();
 
 			protected:
-				ofVec3f doASteveJobs(const ofVec3f & targetPosition);
-				void initPrediction(const ofVec3f & startPosition);
+				struct FilterState {
+					bool isTracking = false;
+					Clock::time_point timestamp;
+					ofVec3f position;
+					ofVec3f velocity;
+					ofVec3f acceleration;
+					ofQuaternion rotation;
+				};
+
+				struct OutputTarget {
+					weak_ptr<MovingHead> movingHead;
+					ofMatrix4x4 worldToMovingHead;
+					float tiltOffset = 0.0f;
+					MovingHead::PanTiltRange panTiltRange;
+					ofVec3f objectPositionOffset;
+					ChannelIndex channelIndex = 1;
+					size_t channelCount = 0;
+				};
+
+				//thread safe
+				void addPoseSample(const Item::RigidBody::PoseSample &);
+				FilterState getFilterState() const;
+				ofVec3f predictPosition(const FilterState &, const Clock::time_point & time);
+
+				void initFilter(const Item::RigidBody::PoseSample &);
+				void updateThreadedOutput(shared_ptr<MovingHead>);
+				void clearThreadedOutput();
+				void unsubscribePoseSamples();
+				void generateChannels(const Clock::time_point & sendTime, Value * channels);
 
 				ofParameter<bool> ignoreBlankTransform;
 				ofParameter<float> objectPositionOffset[3];
 
 				struct {
 					ofParameter<bool> enabled;
-					ofParameter<float> steps;
+					ofParameter<float> latency;
+					ofParameter<float> maximumHorizon;
+					ofParameter<bool> constantAcceleration;
+					ofParameter<float> processNoise;
+					ofParameter<float> measurementNoise;
+					ofParameter<float> sampleTimeout;
+					ofParameter<bool> outputAtDMXRate;
+				} prediction;
+
+				//settings of the previous fixed-step predictor. Not used, but kept so that older patches don't lose them when saved
+				struct {
+					ofParameter<int> steps;
 					ofParameter<float> minimumVelocity;
 					ofParameter<float> maximumAcceleration;
+				} legacyPrediction;
 
-					bool isTracking;
-					ofVec3f position;
-					ofVec3f velocity;
-					ofVec3f acceleration;
-					bool velocityOK;
-					bool accelerationOK;
+				//copies of the parameters for use outside the main thread
+				struct {
+					atomic<bool> ignoreBlankTransform{ true };
+					atomic<float> latency{ 0.0f }; // s
+					atomic<float> maximumHorizon{ 0.0f }; // s
+					atomic<bool> constantAcceleration{ false };
+					atomic<float> processNoise{ 0.0f };
+					atomic<float> measurementNoise{ 0.0f };
+				} threadParameters;
 
+				struct {
 					cv::KalmanFilter kalmanFilter;
-					cv::Mat measurmentVector;
-				} steveJobs;
+					cv::Mat measurement;
+					FilterState state;
+					Clock::time_point lastPipelineSampleTime;
+					bool hasPipelineSamples = false;
+				} filter;
+				mutable mutex filterMutex;
+
+				struct {
+					atomic<float> sampleInterval{ 0.0f }; // ms
+					atomic<float> innovation{ 0.0f }; // m
+					atomic<float> horizon{ 0.0f }; // ms
+					atomic<bool> fromPipeline{ false };
+				} statistics;
+
+				OutputTarget outputTarget;
+				mutex outputTargetMutex;
+				weak_ptr<Transmit> outputTransmit;
+
+				//the body we listen to, which may already be gone from the Target pin
+				weak_ptr<Item::RigidBody> poseSampleSource;
+				UniverseIndex outputUniverseIndex = 0;
 			};
 		}
 	}
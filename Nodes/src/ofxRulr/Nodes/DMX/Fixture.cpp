@@ -117,6 +117,16 @@ namespace ofxRulr {
 				this->channelIndex = channelIndex;
 			}
 
+			//----------
+			DMX::ChannelIndex Fixture::getChannelIndex() const {
+				return this->channelIndex.get();
+			}
+
+			//----------
+			DMX::UniverseIndex Fixture::getUniverseIndex() const {
+				return this->universeIndex.get();
+			}
+
 			//----------
 			const vector<shared_ptr<Fixture::Channel>> & Fixture::getChannels() const {
 				return this->channels;
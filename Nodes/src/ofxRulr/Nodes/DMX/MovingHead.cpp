@@ -160,6 +160,24 @@ namespace ofxRulr {
 				this->parameters.tilt = panTilt.y;
 			}
 
+			//----------
+			MovingHead::PanTiltRange MovingHead::getPanTiltRange() const {
+				PanTiltRange range;
+				range.pan = ofVec2f(this->parameters.pan.getMin(), this->parameters.pan.getMax());
+				range.tilt = ofVec2f(this->parameters.tilt.getMin(), this->parameters.tilt.getMax());
+				return range;
+			}
+
+			//----------
+			bool MovingHead::canEncodePanTilt() const {
+				return false;
+			}
+
+			//----------
+			void MovingHead::encodePanTilt(const ofVec2f & panTilt, const PanTiltRange &, DMX::Value * fixtureChannels) const {
+
+			}
+
 			//----------
 			void MovingHead::setBrightness(float brightness) {
 				this->parameters.brightness = brightness;
@@ -186,6 +204,11 @@ namespace ofxRulr {
 				this->parameters.tiltOffset = tiltOffset;
 			}
 
+			//----------
+			float MovingHead::getTiltOffset() const {
+				return this->parameters.tiltOffset.get();
+			}
+
 			//----------
 			void MovingHead::copyFrom(shared_ptr<MovingHead> other) {
 				this->parameters.pan = other->parameters.pan;
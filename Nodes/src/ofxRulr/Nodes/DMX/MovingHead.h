@@ -23,12 +23,26 @@ namespace ofxRulr {
 				void lookAt(const ofVec3f & worldSpacePoint); /// warning : throws exception if impossible
 				void setPanTilt(const ofVec2f & panTilt);
 
+				struct PanTiltRange {
+					ofVec2f pan; // min, max
+					ofVec2f tilt; // min, max
+				};
+				PanTiltRange getPanTiltRange() const;
+
+				///Returns true if this type of moving head implements encodePanTilt
+				virtual bool canEncodePanTilt() const;
+
+				///Thread safe. Writes the DMX values for this pan / tilt into the fixture's channels (fixtureChannels[0] is the fixture's first channel).
+				///Take the range from getPanTiltRange() on the main thread.
+				virtual void encodePanTilt(const ofVec2f & panTilt, const PanTiltRange &, DMX::Value * fixtureChannels) const;
+
 				void setBrightness(float);
 				void setIris(float);
 				void setPower(bool);
 				void setHome();
 
 				void setTiltOffset(float);
+				float getTiltOffset() const;
 				void copyFrom(shared_ptr<MovingHead>);
 			protected:
 				void populateInspector(ofxCvGui::InspectArguments &);
@@ -93,6 +93,23 @@ namespace ofxRulr {
 				return "DMX::Sharpy";
 			}
 
+			//----------
+			bool Sharpy::canEncodePanTilt() const {
+				return true;
+			}
+
+			//----------
+			void Sharpy::encodePanTilt(const ofVec2f & panTilt, const PanTiltRange & range, DMX::Value * fixtureChannels) const {
+				//channel order matches init() : Pan, Pan fine, Tilt, Tilt fine are channels 10-13
+				//same mapping as the channel generators in init()
+				auto panAll = (int)ofMap(panTilt.x, range.pan.x, range.pan.y, 0, std::numeric_limits<uint16_t>::max(), true);
+				auto tiltAll = (int)ofMap(panTilt.y, range.tilt.x, range.tilt.y, 0, std::numeric_limits<uint16_t>::max(), true);
+				fixtureChannels[9] = (DMX::Value) (panAll >> 8);
+				fixtureChannels[10] = (DMX::Value) (panAll % 256);
+				fixtureChannels[11] = (DMX::Value) (tiltAll >> 8);
+				fixtureChannels[12] = (DMX::Value) (tiltAll % 256);
+			}
+
 			//----------
 			void Sharpy::update() {
 				if (this->rebootState.rebooting) {
@@ -12,6 +12,8 @@ namespace ofxRulr {
 				void update();
 
 				string getTypeName() const;
+				bool canEncodePanTilt() const override;
+				void encodePanTilt(const ofVec2f & panTilt, const PanTiltRange &, DMX::Value * fixtureChannels) const override;
 
 				void serialize(Json::Value &);
 				void deserialize(const Json::Value &);
@@ -14,6 +14,9 @@ namespace ofxRulr {
 #pragma mark Transmit::Universe
 			//----------
 			Transmit::Universe::Universe() {
+				for (auto & buffer : this->buffers) {
+					buffer.fill(0);
+				}
 				this->clearChannels();
 				this->previewDirty = true;
 				this->preview.allocate(32, 16, GL_LUMINANCE);
@@ -63,6 +66,45 @@ namespace ofxRulr {
 				this->previewDirty = true;
 			}
 
+			//----------
+			bool Transmit::Universe::publish() {
+				if (this->hasPublished && memcmp(this->lastPublished.data(), this->values, 513) == 0) {
+					return false;
+				}
+
+				auto & writeBuffer = this->buffers[this->writeBufferIndex];
+				memcpy(writeBuffer.data(), this->values, 513);
+				memcpy(this->lastPublished.data(), this->values, 513);
+				this->hasPublished = true;
+
+				//swap our write buffer with the shared buffer, marking it as new
+				auto previousShared = this->sharedBufferIndex.exchange(this->writeBufferIndex | NewDataFlag);
+				this->writeBufferIndex = previousShared & BufferIndexMask;
+				return true;
+			}
+
+			//----------
+			bool Transmit::Universe::takeSnapshot() {
+				if (!(this->sharedBufferIndex.load() & NewDataFlag)) {
+					return false;
+				}
+
+				//swap our read buffer with the shared buffer, clearing the new flag
+				auto previousShared = this->sharedBufferIndex.exchange(this->readBufferIndex);
+				this->readBufferIndex = previousShared & BufferIndexMask;
+				return true;
+			}
+
+			//----------
+			const Value * Transmit::Universe::getSnapshot() const {
+				return this->buffers[this->readBufferIndex].data();
+			}
+
+			//----------
+			Value * Transmit::Universe::getSnapshot() {
+				return this->buffers[this->readBufferIndex].data();
+			}
+
 #pragma mark Transmit
 			//----------
 			Transmit::Transmit() {
@@ -72,15 +114,29 @@ namespace ofxRulr {
 				RULR_NODE_SERIALIZATION_LISTENERS;
 			}
 
+			//----------
+			Transmit::~Transmit() {
+				this->stopTransmitThread();
+			}
+
 			//----------
 			void Transmit::init() {
 				this->view = make_shared<Panels::Scroll>();
 				this->setUniverseCount(1);
 				this->firstFrame = true;
+
+				this->manageParameters(this->parameters, false);
+
+				this->startTransmitThread();
 			}
 
 			//----------
 			void Transmit::update() {
+				//pass parameters to the transmit thread
+				this->transmitFrameRate.store(this->parameters.frameRate.get());
+				this->transmitSkipUnchanged.store(this->parameters.skipUnchanged.get());
+				this->transmitKeepAlivePeriod.store(this->parameters.keepAlivePeriod.get());
+
 				if (this->firstFrame) {
 					//don't send on first frame
 					this->firstFrame = false;
@@ -90,7 +146,7 @@ namespace ofxRulr {
 						if (this->universes[i]->blackoutEnabled) {
 							this->universes[i]->clearChannels();
 						}
-						this->sendUniverse(i, this->universes[i]);
+						this->universes[i]->publish();
 					}
 				}
 			}
@@ -126,6 +182,30 @@ namespace ofxRulr {
 			//----------
 			void Transmit::populateInspector(ofxCvGui::InspectArguments & inspectArguments) {
 				auto inspector = inspectArguments.inspector;
+
+				inspector->addParameterGroup(this->parameters);
+				inspector->addLiveValueHistory("Frame interval [ms]", [this]() {
+					return this->statistics.frameInterval.load();
+				});
+				inspector->addLiveValueHistory("Mean jitter [ms]", [this]() {
+					return this->statistics.meanJitter.load();
+				});
+				inspector->addLiveValue<float>("Max jitter [ms]", [this]() {
+					return this->statistics.maxJitter.load();
+				});
+				inspector->addButton("Reset max jitter", [this]() {
+					this->statistics.maxJitter.store(0.0f);
+				});
+				inspector->addLiveValue<uint32_t>("Frames sent", [this]() {
+					return this->statistics.framesSent.load();
+				});
+				inspector->addLiveValue<uint32_t>("Universes sent", [this]() {
+					return this->statistics.universesSent.load();
+				});
+				inspector->addLiveValue<uint32_t>("Universes skipped (unchanged)", [this]() {
+					return this->statistics.universesSkipped.load();
+				});
+
 				for (int i = 0; i < this->universes.size(); i++) {
 					inspector->add(new Widgets::Title("Universe " + ofToString(i)));
 					inspector->add(new Widgets::Toggle(this->universes[i]->blackoutEnabled));
@@ -153,14 +233,30 @@ namespace ofxRulr {
 				}
 			}
 
+			//----------
+			void Transmit::setThreadedChannelGenerator(const void * owner, UniverseIndex universeIndex, const ThreadedChannelGenerator & generator) {
+				auto lock = unique_lock<mutex>(this->threadedChannelGeneratorsMutex);
+				this->threadedChannelGenerators[owner] = make_pair(universeIndex, generator);
+			}
+
+			//----------
+			void Transmit::clearThreadedChannelGenerator(const void * owner) {
+				//generators are called with this mutex held, so none can be in flight once we have it
+				auto lock = unique_lock<mutex>(this->threadedChannelGeneratorsMutex);
+				this->threadedChannelGenerators.erase(owner);
+			}
+
 			//----------
 			void Transmit::setUniverseCount(UniverseIndex universeCount) {
-				if (this->universes.size() > universeCount) {
-					this->universes.resize(universeCount);
-				}
-				else {
-					while (universeCount > this->universes.size()) {
-						this->universes.push_back(make_shared<Universe>());
+				{
+					auto lock = unique_lock<mutex>(this->universesMutex);
+					if (this->universes.size() > universeCount) {
+						this->universes.resize(universeCount);
+					}
+					else {
+						while (universeCount > this->universes.size()) {
+							this->universes.push_back(make_shared<Universe>());
+						}
 					}
 				}
 
@@ -183,6 +279,131 @@ namespace ofxRulr {
 					this->view->add(preview);
 				}
 			}
+
+			//----------
+			void Transmit::startTransmitThread() {
+				if (this->transmitThreadRunning.load()) {
+					return;
+				}
+				this->transmitThreadRunning.store(true);
+				this->transmitThread = thread([this]() {
+					this->transmitThreadLoop();
+				});
+			}
+
+			//----------
+			void Transmit::stopTransmitThread() {
+				this->transmitThreadRunning.store(false);
+				if (this->transmitThread.joinable()) {
+					this->transmitThread.join();
+				}
+			}
+
+			//----------
+			void Transmit::transmitThreadLoop() {
+#ifdef TARGET_WIN32
+				SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#endif
+				typedef chrono::high_resolution_clock Clock;
+
+				auto nextFrameTime = Clock::now();
+				auto lastFrameTime = nextFrameTime;
+				bool firstFrame = true;
+
+				vector<shared_ptr<Universe>> universes;
+				vector<Clock::time_point> lastSendTimes;
+				vector<bool> hasSnapshot;
+				Universe::Buffer beforeGenerators;
+
+				while (this->transmitThreadRunning.load()) {
+					const auto period = chrono::duration_cast<Clock::duration>(chrono::duration<double>(1.0 / max(this->transmitFrameRate.load(), 1.0f)));
+
+					//pace to absolute deadlines so that late frames don't accumulate drift
+					nextFrameTime += period;
+					auto now = Clock::now();
+					if (nextFrameTime + period < now) {
+						//we've fallen more than a frame behind (e.g. the device blocked), don't try to catch up in a burst
+						nextFrameTime = now;
+					}
+					this_thread::sleep_until(nextFrameTime);
+
+					//frame timing statistics
+					auto frameTime = Clock::now();
+					if (!firstFrame) {
+						chrono::duration<float, milli> interval = frameTime - lastFrameTime;
+						chrono::duration<float, milli> periodMilliseconds = period;
+						auto jitter = abs(interval.count() - periodMilliseconds.count());
+
+						this->statistics.frameInterval.store(interval.count());
+						this->statistics.meanJitter.store(ofLerp(this->statistics.meanJitter.load(), jitter, 0.05f));
+						if (jitter > this->statistics.maxJitter.load()) {
+							this->statistics.maxJitter.store(jitter);
+						}
+					}
+					firstFrame = false;
+					lastFrameTime = frameTime;
+
+					//take a copy of the universe list
+					{
+						auto lock = unique_lock<mutex>(this->universesMutex);
+						universes = this->universes;
+					}
+					lastSendTimes.resize(universes.size(), Clock::time_point());
+					hasSnapshot.resize(universes.size(), false);
+
+					const auto skipUnchanged = this->transmitSkipUnchanged.load();
+					const auto keepAlivePeriod = chrono::duration_cast<Clock::duration>(chrono::duration<float>(this->transmitKeepAlivePeriod.load()));
+
+					for (size_t i = 0; i < universes.size(); i++) {
+						auto & universe = universes[i];
+						auto isNew = universe->takeSnapshot();
+						if (isNew) {
+							hasSnapshot[i] = true;
+						}
+						else if (!hasSnapshot[i]) {
+							//nothing has been published yet (e.g. first app frame)
+							continue;
+						}
+
+						//let generators write their send-time values over the snapshot
+						{
+							auto lock = unique_lock<mutex>(this->threadedChannelGeneratorsMutex);
+							bool hasGenerators = false;
+							for (auto & generator : this->threadedChannelGenerators) {
+								if (generator.second.first != i) {
+									continue;
+								}
+								if (!hasGenerators) {
+									memcpy(beforeGenerators.data(), universe->getSnapshot(), 513);
+									hasGenerators = true;
+								}
+								try {
+									generator.second.second(frameTime, universe->getSnapshot());
+								}
+								RULR_CATCH_ALL_TO_ERROR;
+							}
+							if (hasGenerators && memcmp(beforeGenerators.data(), universe->getSnapshot(), 513) != 0) {
+								isNew = true;
+							}
+						}
+
+						if (skipUnchanged && !isNew && frameTime - lastSendTimes[i] < keepAlivePeriod) {
+							this->statistics.universesSkipped++;
+							continue;
+						}
+
+						try {
+							this->sendUniverse((UniverseIndex)i, universe->getSnapshot());
+						}
+						RULR_CATCH_ALL_TO_ERROR;
+
+						lastSendTimes[i] = frameTime;
+						this->statistics.universesSent++;
+					}
+
+					this->statistics.framesSent++;
+				}
+			}
 		}
 	}
 }
\ No newline at end of file
@@ -5,27 +5,79 @@
 
 #include "Base.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <thread>
+
 namespace ofxRulr {
 	namespace Nodes {
 		namespace DMX {
+			///Universes are filled on the main thread (e.g. by Fixture::update) and published once per
+			///app frame. A dedicated thread takes the latest published snapshot of each universe and
+			///calls sendUniverse at a fixed rate, independent of the app frame rate.
 			class Transmit : public DMX::Base {
 			public:
 				class Universe {
 				public:
+					typedef array<Value, 513> Buffer;
+
 					Universe();
+
+					//main thread
 					void setChannel(ChannelIndex channel, Value value);
 					void setChannels(ChannelIndex channelOffset, Value * values, ChannelIndex count);
 					const Value * getChannels() const;
 					const ofTexture & getTextureReference();
 					void clearChannels();
+
+					///Make the current channel values available to the transmit thread. Returns false if nothing changed.
+					bool publish();
+
+					//transmit thread
+					///Take the most recently published values. Returns true if they are newer than the previous snapshot.
+					bool takeSnapshot();
+					const Value * getSnapshot() const;
+					Value * getSnapshot();
+
 					ofParameter<bool> blackoutEnabled;
 				protected:
+					enum : uint8_t {
+						BufferIndexMask = 0x3,
+						NewDataFlag = 0x4
+					};
+
 					Value values[513]; // 0th channel is unused
 					ofTexture preview;
 					bool previewDirty;
+
+					//lock-free triple buffer (write / shared / read) so neither thread ever waits for the other
+					Buffer buffers[3];
+					uint8_t writeBufferIndex = 0;
+					atomic<uint8_t> sharedBufferIndex{ 1 };
+					uint8_t readBufferIndex = 2;
+
+					Buffer lastPublished;
+					bool hasPublished = false;
+				};
+
+				///Called on the transmit thread just before a universe is sent, to overwrite channels with values
+				///which should be evaluated at the send time (e.g. predicted pan / tilt). channels has 513 entries.
+				typedef function<void(const chrono::high_resolution_clock::time_point & sendTime, Value * channels)> ThreadedChannelGenerator;
+
+				struct Statistics {
+					atomic<float> frameInterval{ 0.0f }; // ms
+					atomic<float> meanJitter{ 0.0f }; // ms
+					atomic<float> maxJitter{ 0.0f }; // ms, since last reset
+					atomic<uint32_t> framesSent{ 0 };
+					atomic<uint32_t> universesSent{ 0 };
+					atomic<uint32_t> universesSkipped{ 0 };
 				};
 
 				Transmit();
+				virtual ~Transmit();
 				void init();
 				void update();
 				virtual string getTypeName() const override;
@@ -38,14 +90,45 @@ namespace ofxRulr {
 				UniverseIndex getUniverseCount() const;
 				const vector<shared_ptr<Universe>> & getUniverses() const;
 				shared_ptr<Universe> getUniverse(UniverseIndex universeIndex) const;
+
+				///Any previous generator for this owner is replaced
+				void setThreadedChannelGenerator(const void * owner, UniverseIndex, const ThreadedChannelGenerator &);
+				///After this returns, the owner's generator will not be called again
+				void clearThreadedChannelGenerator(const void * owner);
 			protected:
 				void setUniverseCount(UniverseIndex);
-				virtual void sendUniverse(UniverseIndex, shared_ptr<Universe>) { }
+
+				///Called from the transmit thread. channels has 513 entries (0th is the start code slot).
+				virtual void sendUniverse(UniverseIndex, const Value * channels) { }
+
+				void startTransmitThread();
+				///Subclasses must call this in their destructor, since sendUniverse is virtual
+				void stopTransmitThread();
+				void transmitThreadLoop();
+
+				struct : ofParameterGroup {
+					ofParameter<float> frameRate{ "Frame rate [Hz]", 44, 1, 100 };
+					ofParameter<bool> skipUnchanged{ "Skip unchanged universes", true };
+					ofParameter<float> keepAlivePeriod{ "Keep alive period [s]", 1, 0, 10 };
+					PARAM_DECLARE("Transmit", frameRate, skipUnchanged, keepAlivePeriod);
+				} parameters;
+
 				shared_ptr<ofxCvGui::Panels::Scroll> view;
 
 				vector<shared_ptr<Universe>> universes;
+				mutex universesMutex; // only held when the set of universes changes or is copied by the transmit thread
+
+				map<const void *, pair<UniverseIndex, ThreadedChannelGenerator>> threadedChannelGenerators;
+				mutex threadedChannelGeneratorsMutex;
 
 				bool firstFrame;
+
+				thread transmitThread;
+				atomic<bool> transmitThreadRunning{ false };
+				atomic<float> transmitFrameRate{ 44.0f };
+				atomic<bool> transmitSkipUnchanged{ true };
+				atomic<float> transmitKeepAlivePeriod{ 1.0f };
+				Statistics statistics;
 			};
 		}
 	}
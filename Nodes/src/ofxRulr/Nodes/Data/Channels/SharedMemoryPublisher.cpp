@@ -0,0 +1,127 @@
+#include "pch_RulrNodes.h"
+#include "SharedMemoryPublisher.h"
+#include "Database.h"
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Data {
+			namespace Channels {
+				//----------
+				SharedMemoryPublisher::SharedMemoryPublisher() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string SharedMemoryPublisher::getTypeName() const {
+					return "Data::Channels::SharedMemoryPublisher";
+				}
+
+				//----------
+				void SharedMemoryPublisher::init() {
+					RULR_NODE_UPDATE_LISTENER;
+					RULR_NODE_INSPECTOR_LISTENER;
+
+					auto databasePin = this->addInput<Database>();
+					databasePin->onNewConnection += [this](shared_ptr<Database> database) {
+						database->onPopulateData.addListener([this](ofxRulr::Data::Channels::Channel & rootChannel) {
+							this->publish(rootChannel);
+						}, this);
+						database->getRootChannel()->onHeirarchyChange.addListener([this]() {
+							if (this->writer) {
+								this->writer->notifySchemaChange();
+							}
+						}, this);
+						this->needsRecreate = true;
+					};
+					databasePin->onDeleteConnection += [this](shared_ptr<Database> database) {
+						if (database) {
+							database->onPopulateData.removeListeners(this);
+							database->getRootChannel()->onHeirarchyChange.removeListeners(this);
+						}
+					};
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void SharedMemoryPublisher::update() {
+					if (!this->parameters.enabled) {
+						//open a fresh mapping when we're enabled again
+						this->writer.reset();
+						this->needsRecreate = true;
+						return;
+					}
+
+					//recreate the mapping if its layout has changed (readers will need to reopen it)
+					if (this->writer && !this->needsRecreate) {
+						const auto settings = this->getSettings();
+						const auto & currentSettings = this->writer->getSettings();
+						if (settings.name != currentSettings.name
+							|| settings.channelCapacity != currentSettings.channelCapacity
+							|| settings.valuesCapacity != currentSettings.valuesCapacity
+							|| settings.ringLength != currentSettings.ringLength) {
+							this->needsRecreate = true;
+						}
+					}
+
+					if (this->needsRecreate) {
+						this->writer.reset();
+						this->needsRecreate = false;
+						try {
+							this->writer = make_unique<ofxRulr::Data::Channels::SharedMemoryWriter>(this->getSettings());
+						}
+						RULR_CATCH_ALL_TO_ERROR;
+					}
+				}
+
+				//----------
+				void SharedMemoryPublisher::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					inspector->addLiveValue<string>("Shared memory", [this]() {
+						return this->writer
+							? ofxRulr::Data::Channels::SharedMemory::getSystemName(this->writer->getSettings().name)
+							: string("Closed");
+					});
+					inspector->addLiveValue<size_t>("Channels", [this]() {
+						return this->writer ? this->writer->getChannelCount() : 0;
+					});
+					inspector->addLiveValue<size_t>("Dropped channels", [this]() {
+						return this->writer ? this->writer->getDroppedChannelCount() : 0;
+					});
+					inspector->addLiveValue<uint64_t>("Schema version", [this]() {
+						return this->writer ? this->writer->getSchemaVersion() : 0;
+					});
+					inspector->addLiveValue<uint64_t>("Frame index", [this]() {
+						return this->writer ? this->writer->getFrameIndex() : 0;
+					});
+					inspector->addLiveValue<float>("Publish duration [us]", [this]() {
+						return this->publishDuration;
+					});
+				}
+
+				//----------
+				void SharedMemoryPublisher::publish(ofxRulr::Data::Channels::Channel & rootChannel) {
+					if (!this->writer) {
+						return;
+					}
+
+					auto startTime = chrono::high_resolution_clock::now();
+					this->writer->publish(rootChannel);
+					this->publishDuration = chrono::duration<float, micro>(chrono::high_resolution_clock::now() - startTime).count();
+				}
+
+				//----------
+				ofxRulr::Data::Channels::SharedMemoryWriter::Settings SharedMemoryPublisher::getSettings() const {
+					ofxRulr::Data::Channels::SharedMemoryWriter::Settings settings;
+					settings.name = this->parameters.name.get();
+					settings.channelCapacity = (uint32_t) this->parameters.channelCapacity.get();
+					settings.valuesCapacity = (uint32_t) this->parameters.valuesCapacity.get() * 1024;
+					settings.ringLength = (uint32_t) this->parameters.ringLength.get();
+					return settings;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ofxRulr/Nodes/Base.h"
+#include "ofxRulr/Data/Channels/SharedMemoryWriter.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Data {
+			namespace Channels {
+				class Database;
+
+				///Publishes the Database into shared memory each frame, so that applications on this machine can read it
+				///with ofxRulr/Data/Channels/SharedMemory.h instead of going through OSC
+				class SharedMemoryPublisher : public Nodes::Base {
+				public:
+					SharedMemoryPublisher();
+					string getTypeName() const override;
+
+					void init();
+					void update();
+					void populateInspector(ofxCvGui::InspectArguments &);
+				protected:
+					void publish(ofxRulr::Data::Channels::Channel & rootChannel);
+					ofxRulr::Data::Channels::SharedMemoryWriter::Settings getSettings() const;
+
+					struct : ofParameterGroup {
+						ofParameter<bool> enabled{ "Enabled", true };
+						ofParameter<string> name{ "Name", "Rulr" };
+						ofParameter<int> channelCapacity{ "Channel capacity", 4096, 1, 1 << 20 };
+						ofParameter<int> valuesCapacity{ "Values capacity [KB]", 1024, 1, 1 << 20 };
+						ofParameter<int> ringLength{ "Ring length", 4, 2, 64 };
+						PARAM_DECLARE("SharedMemoryPublisher", enabled, name, channelCapacity, valuesCapacity, ringLength);
+					} parameters;
+
+					unique_ptr<ofxRulr::Data::Channels::SharedMemoryWriter> writer;
+					bool needsRecreate = true;
+					float publishDuration = 0.0f; // us
+				};
+			}
+		}
+	}
+}
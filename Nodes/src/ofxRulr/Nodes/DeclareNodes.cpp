@@ -9,6 +9,7 @@
 
 #include "ofxRulr/Nodes/Data/Channels/Database.h"
 #include "ofxRulr/Nodes/Data/Channels/Generator/Application.h"
+#include "ofxRulr/Nodes/Data/Channels/SharedMemoryPublisher.h"
 #include "ofxRulr/Nodes/Data/Mesh.h"
 #include "ofxRulr/Nodes/Data/Recorder.h"
 
@@ -32,6 +33,11 @@
 #include "ofxRulr/Nodes/System/VideoOutput.h"
 
 #include "ofxRulr/Nodes/Test/ARCube.h"
+#include "ofxRulr/Nodes/Test/BenchmarkFocus.h"
+#include "ofxRulr/Nodes/Test/BenchmarkRigidBody.h"
+#include "ofxRulr/Nodes/Test/BenchmarkHTTPServerControl.h"
+#include "ofxRulr/Nodes/Test/BenchmarkPatch.h"
+#include "ofxRulr/Nodes/Test/BenchmarkWorldBatch.h"
 #include "ofxRulr/Nodes/Test/Focus.h"
 
 #include "ofxRulr/Nodes/Watchdog/Camera.h"
@@ -50,6 +56,7 @@ namespace ofxRulr {
 			
 			RULR_DECLARE_NODE(Data::Channels::Database);
 			RULR_DECLARE_NODE(Data::Channels::Generator::Application);
+			RULR_DECLARE_NODE(Data::Channels::SharedMemoryPublisher);
 			RULR_DECLARE_NODE(Data::Mesh);
 			RULR_DECLARE_NODE(Data::Recorder);
 
@@ -75,6 +82,11 @@ namespace ofxRulr {
 			
 			RULR_DECLARE_NODE(Test::ARCube);
 			RULR_DECLARE_NODE(Test::Focus);
+			RULR_DECLARE_NODE(Test::BenchmarkFocus);
+			RULR_DECLARE_NODE(Test::BenchmarkRigidBody);
+			RULR_DECLARE_NODE(Test::BenchmarkHTTPServerControl);
+			RULR_DECLARE_NODE(Test::BenchmarkPatch);
+			RULR_DECLARE_NODE(Test::BenchmarkWorldBatch);
 
 			RULR_DECLARE_NODE(Watchdog::Camera);
 			RULR_DECLARE_NODE(Watchdog::Startup);
@@ -225,6 +225,67 @@ namespace ofxRulr {
 				return vertices;
 			}
 
+			//----------
+			ofMesh Mesh::getWorldMesh() const {
+				ofMesh worldMesh;
+				worldMesh.setMode(OF_PRIMITIVE_TRIANGLES);
+
+				if (this->modelLoader) {
+					const auto transform = this->getMeshTransform() * this->getTransform();
+					const auto meshCount = this->modelLoader->getMeshCount();
+
+					for (size_t i = 0; i < meshCount; i++) {
+						const auto & meshHelper = this->modelLoader->getMeshHelper(i);
+						const auto mesh = this->modelLoader->getMesh(i);
+						const auto meshTransform = meshHelper.matrix * transform;
+						const auto normalTransform = ofMatrix4x4::getTransposedOf(meshTransform.getInverse());
+
+						const auto indexOffset = (ofIndexType)worldMesh.getNumVertices();
+						for (const auto & vertex : mesh.getVertices()) {
+							worldMesh.addVertex(vertex * meshTransform);
+						}
+						if (mesh.getNumNormals() == mesh.getNumVertices()) {
+							for (const auto & normal : mesh.getNormals()) {
+								worldMesh.addNormal(ofMatrix4x4::transform3x3(normal, normalTransform).getNormalized());
+							}
+						}
+						else {
+							worldMesh.getNormals().resize(worldMesh.getNumVertices());
+						}
+						if (mesh.getNumColors() == mesh.getNumVertices()) {
+							worldMesh.addColors(mesh.getColors());
+						}
+						else {
+							worldMesh.getColors().resize(worldMesh.getNumVertices(), ofFloatColor::white);
+						}
+						if (mesh.getNumTexCoords() == mesh.getNumVertices()) {
+							worldMesh.addTexCoords(mesh.getTexCoords());
+						}
+						else {
+							worldMesh.getTexCoords().resize(worldMesh.getNumVertices());
+						}
+
+						if (mesh.hasIndices()) {
+							for (const auto & index : mesh.getIndices()) {
+								worldMesh.addIndex(index + indexOffset);
+							}
+						}
+						else {
+							for (ofIndexType j = 0; j < (ofIndexType)mesh.getNumVertices(); j++) {
+								worldMesh.addIndex(j + indexOffset);
+							}
+						}
+					}
+				}
+
+				return worldMesh;
+			}
+
+			//----------
+			const ofPixels & Mesh::getTexturePixels() const {
+				return this->texture.getPixels();
+			}
+
 
 			//----------
 			void Mesh::populateInspector(ofxCvGui::InspectArguments & inspectArguments) {
@@ -30,6 +30,13 @@ namespace ofxRulr {
 
 				virtual vector<ofVec3f> getVertices() const override;
 
+				///All faces as one indexed triangle mesh with vertices and normals in world space.
+				///Colors and texture coordinates are included where the model has them (white and 0 elsewhere).
+				ofMesh getWorldMesh() const;
+
+				///Pixels of the texture which is bound when drawing the mesh (unallocated if none)
+				const ofPixels & getTexturePixels() const;
+
 			protected:
 				void populateInspector(ofxCvGui::InspectArguments &);
 				void loadMesh();
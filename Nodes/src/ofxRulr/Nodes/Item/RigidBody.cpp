@@ -25,6 +25,22 @@ namespace ofxRulr {
 				//RULR_NODE_INIT_LISTENER;
 			}
 
+			//---------
+			RigidBody::~RigidBody() {
+				for (int i = 0; i < 3; i++) {
+					this->translation[i].removeListener(this, &RigidBody::callbackTransformParameterChange);
+					this->rotationEuler[i].removeListener(this, &RigidBody::callbackTransformParameterChange);
+				}
+				if (this->parentPin) {
+					this->parentPin->onNewConnection.removeListeners(this);
+					this->parentPin->onDeleteConnection.removeListeners(this);
+				}
+				auto parent = this->getParent();
+				if (parent) {
+					parent->onTransformChange.removeListeners(this);
+				}
+			}
+
 			//---------
 			string RigidBody::getTypeName() const {
 				return "Item::RigidBody";
@@ -43,6 +59,20 @@ namespace ofxRulr {
 				this->rotationEuler[0].set("Rotation X", 0, -180.0f, 180.0f);
 				this->rotationEuler[1].set("Rotation Y", 0, -180.0f, 180.0f);
 				this->rotationEuler[2].set("Rotation Z", 0, -180.0f, 180.0f);
+
+				//the cached transform is rebuilt after any of these change, however they're set
+				for (int i = 0; i < 3; i++) {
+					this->translation[i].addListener(this, &RigidBody::callbackTransformParameterChange);
+					this->rotationEuler[i].addListener(this, &RigidBody::callbackTransformParameterChange);
+				}
+
+				this->parentPin = this->addInput<RigidBody>("Parent");
+				this->parentPin->onNewConnection.addListener([this](shared_ptr<RigidBody> parent) {
+					this->callbackParentChange(parent);
+				}, this);
+				this->parentPin->onDeleteConnection.addListener([this](shared_ptr<RigidBody>) {
+					this->callbackParentChange(shared_ptr<RigidBody>());
+				}, this);
 			}
 
 			//---------
@@ -280,6 +310,45 @@ namespace ofxRulr {
 
 			//---------
 			ofMatrix4x4 RigidBody::getTransform() const {
+				return this->getTransformSnapshot().transform;
+			}
+
+			//---------
+			RigidBody::TransformSnapshot RigidBody::getTransformSnapshot() const {
+				lock_guard<mutex> lock(this->transformCacheMutex);
+
+				//bring the parent up to date first
+				auto parent = this->parent.lock();
+				TransformSnapshot parentSnapshot;
+				if (parent) {
+					parentSnapshot = parent->getTransformSnapshot();
+				}
+
+				auto changed = this->transformDirty.exchange(false);
+				if (changed) {
+					this->cachedLocalTransform = this->getLocalTransform();
+				}
+				if (parentSnapshot.version != this->cachedParentVersion) {
+					//parent moved, was connected or went away
+					this->cachedParentVersion = parentSnapshot.version;
+					changed = true;
+				}
+
+				if (changed) {
+					this->cachedTransform = parent
+						? this->cachedLocalTransform * parentSnapshot.transform
+						: this->cachedLocalTransform;
+					this->transformVersion++;
+				}
+
+				TransformSnapshot snapshot;
+				snapshot.transform = this->cachedTransform;
+				snapshot.version = this->transformVersion;
+				return snapshot;
+			}
+
+			//---------
+			ofMatrix4x4 RigidBody::getLocalTransform() const {
 				//rotation
 				auto quat = glm::quat(glm::vec3(this->rotationEuler[0] * DEG_TO_RAD, this->rotationEuler[1] * DEG_TO_RAD, this->rotationEuler[2] * DEG_TO_RAD));
 				auto transform = toOf(glm::toMat4(quat));
@@ -314,7 +383,13 @@ namespace ofxRulr {
 			}
 
 			//---------
-			void RigidBody::setTransform(const ofMatrix4x4 & transform) {
+			void RigidBody::setTransform(const ofMatrix4x4 & worldTransform) {
+				auto transform = worldTransform;
+				auto parent = this->getParent();
+				if (parent) {
+					transform = worldTransform * parent->getTransform().getInverse();
+				}
+
 				auto translation = ((ofVec4f*)&transform)[3]; //last row is translation. rip it out;
 
 				//first 3x3 is rotation, rip it out and convert it
@@ -380,6 +455,45 @@ namespace ofxRulr {
 				this->onTransformChange.notifyListeners();
 			}
 
+			//----------
+			void RigidBody::setParent(shared_ptr<RigidBody> parent) {
+				if (parent) {
+					this->parentPin->connectTyped(parent);
+				}
+				else {
+					this->parentPin->resetConnection();
+				}
+			}
+
+			//----------
+			shared_ptr<RigidBody> RigidBody::getParent() const {
+				lock_guard<mutex> lock(this->transformCacheMutex);
+				return this->parent.lock();
+			}
+
+			//----------
+			void RigidBody::notifyPoseSample(const ofMatrix4x4 & transform, const chrono::high_resolution_clock::time_point & timestamp) {
+				PoseSample poseSample;
+				poseSample.timestamp = timestamp;
+				poseSample.position = transform.getTranslation();
+				poseSample.rotation = transform.getRotate();
+
+				lock_guard<mutex> lock(this->poseSampleListenersMutex);
+				this->onPoseSample.notifyListeners(poseSample);
+			}
+
+			//----------
+			void RigidBody::addPoseSampleListener(function<void(PoseSample &)> listener, void * owner) {
+				lock_guard<mutex> lock(this->poseSampleListenersMutex);
+				this->onPoseSample.addListener(listener, owner);
+			}
+
+			//----------
+			void RigidBody::removePoseSampleListeners(void * owner) {
+				lock_guard<mutex> lock(this->poseSampleListenersMutex);
+				this->onPoseSample.removeListeners(owner);
+			}
+
 			//----------
 			void RigidBody::exportRigidBodyMatrix() {
 				const auto matrix = this->getTransform();
@@ -391,6 +505,43 @@ namespace ofxRulr {
 				}
 			}
 
+			//----------
+			void RigidBody::callbackTransformParameterChange(float &) {
+				this->transformDirty = true;
+			}
+
+			//----------
+			void RigidBody::callbackParentChange(shared_ptr<RigidBody> parent) {
+				for (auto ancestor = parent; ancestor; ancestor = ancestor->getParent()) {
+					if (ancestor.get() == this) {
+						ofLogError(this->getTypeName()) << "Cannot use [" << parent->getName() << "] as the parent of [" << this->getName() << "] as it is already one of its children";
+						parent.reset();
+						break;
+					}
+				}
+
+				auto previousParent = this->getParent();
+				if (previousParent) {
+					previousParent->onTransformChange.removeListeners(this);
+				}
+
+				{
+					lock_guard<mutex> lock(this->transformCacheMutex);
+					this->parent = parent;
+				}
+
+				//a different parent can be at the same version as the last one, so don't rely on the version to refresh
+				this->transformDirty = true;
+
+				//children move with their parent
+				if (parent) {
+					parent->onTransformChange.addListener([this]() {
+						this->onTransformChange.notifyListeners();
+					}, this);
+				}
+				this->onTransformChange.notifyListeners();
+			}
+
 #pragma mark Helpers
 			/*
 			//using glm now
@@ -18,7 +18,19 @@ namespace ofxRulr {
 		namespace Item {
 			class RigidBody : public virtual Nodes::Base {
 			public:
+				struct PoseSample {
+					chrono::high_resolution_clock::time_point timestamp;
+					ofVec3f position;
+					ofQuaternion rotation;
+				};
+
+				struct TransformSnapshot {
+					ofMatrix4x4 transform; // world space
+					uint64_t version = 0; // changes whenever the transform does
+				};
+
 				RigidBody();
+				virtual ~RigidBody();
 				virtual string getTypeName() const override;
 				void init();
 				void drawWorldStage();
@@ -28,11 +40,20 @@ namespace ofxRulr {
 				void deserialize(const Json::Value &);
 				void populateInspector(ofxCvGui::InspectArguments &);
 
+				///World space transform (the local transform within the parent's, if there is one).
+				///Cached until a parameter or the parent changes, and safe to call from any thread.
 				ofMatrix4x4 getTransform() const;
+				///getTransform() with a version, so that readers can skip work when the transform hasn't changed
+				TransformSnapshot getTransformSnapshot() const;
+				///Transform from this body's own translation and rotation parameters, rebuilt on each call
+				ofMatrix4x4 getLocalTransform() const;
+
+				//these act on the local parameters
 				ofVec3f getPosition() const;
 				ofQuaternion getRotationQuat() const;
 				ofVec3f getRotationEuler() const;
 
+				///Takes a world space transform, which is moved into the parent's space if there is one
 				void setTransform(const ofMatrix4x4 &);
 				void setPosition(const ofVec3f &);
 				void setRotationEuler(const ofVec3f &);
@@ -40,17 +61,45 @@ namespace ofxRulr {
 				void getExtrinsics(cv::Mat & rotationVector, cv::Mat & translation, bool inverse = false);
 				void clearTransform();
 
+				///Same as connecting the Parent pin. Chains which would loop back are refused.
+				void setParent(shared_ptr<RigidBody>);
+				shared_ptr<RigidBody> getParent() const;
+
+				///For tracking pipelines to announce a measured pose with the time it was measured (e.g. from a worker thread).
+				///This does not change the transform.
+				void notifyPoseSample(const ofMatrix4x4 & transform, const chrono::high_resolution_clock::time_point & timestamp);
+
+				///Listeners are called from the thread which calls notifyPoseSample, so they must be thread safe.
+				///Once removePoseSampleListeners returns, none of the owner's listeners are running or will be called.
+				void addPoseSampleListener(function<void(PoseSample &)>, void * owner);
+				void removePoseSampleListeners(void * owner);
+
 				ofxLiquidEvent<void> onDrawObject;
 				ofxLiquidEvent<DrawWorldAdvancedArgs> onDrawObjectAdvanced;
 
 				ofxLiquidEvent<void> onTransformChange;
 			protected:
 				void exportRigidBodyMatrix();
+				void callbackTransformParameterChange(float &);
+				void callbackParentChange(shared_ptr<RigidBody>);
 
 				ofParameter<float> translation[3];
 				ofParameter<float> rotationEuler[3];
 				ofParameter<float> movementSpeed{ "Movement speed [m/s]", 0.1, 0, 10 };
 			private:
+				shared_ptr<Graph::Pin<RigidBody>> parentPin;
+				weak_ptr<RigidBody> parent;
+
+				//the parent chain is resolved lazily, locking child then parent
+				mutable mutex transformCacheMutex;
+				mutable atomic<bool> transformDirty{ true };
+				mutable ofMatrix4x4 cachedLocalTransform;
+				mutable ofMatrix4x4 cachedTransform;
+				mutable uint64_t transformVersion = 0;
+				mutable uint64_t cachedParentVersion = 0;
+
+				ofxLiquidEvent<PoseSample> onPoseSample;
+				mutex poseSampleListenersMutex;
 			};
 
 			ofVec3f toEuler(const ofQuaternion &);
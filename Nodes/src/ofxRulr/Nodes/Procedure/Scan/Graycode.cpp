@@ -98,6 +98,7 @@ namespace ofxRulr {
 							suite->payload->init(videoOutput->getWidth(), videoOutput->getHeight());
 							suite->encoder.init(suite->payload);
 							suite->decoder.init(suite->payload);
+							suite->decoder.setThreshold((int) this->parameters.processing.threshold);
 							this->suite = move(suite);
 
 							this->previewDirty = true;
@@ -112,7 +113,12 @@ namespace ofxRulr {
 						}
 
 						if ((int) this->suite->decoder.getThreshold() != this->parameters.processing.threshold) {
+							//the active mask depends on the threshold, so we need the full data set
+							this->loadDeferredDataSet();
 							this->suite->decoder.setThreshold((int) this->parameters.processing.threshold);
+							if (this->suite->decoder.hasData()) {
+								this->updateMappedDataSet();
+							}
 							this->previewDirty = true;
 						}
 					}
@@ -122,16 +128,38 @@ namespace ofxRulr {
 				void Graycode::serialize(Json::Value & json) {
 					Utils::Serializable::serialize(json, this->parameters);
 					
-					if (this->suite) {
+					if (this->suite || this->mappedDataSet) {
 						json["hasData"] = true;
 
 						auto & jsonPayload = json["payload"];
-						jsonPayload["width"] = (int) this->suite->payload->getWidth();
-						jsonPayload["height"] = (int) this->suite->payload->getHeight();
+						if (this->mappedDataSet) {
+							jsonPayload["width"] = this->mappedDataSet->getPayloadWidth();
+							jsonPayload["height"] = this->mappedDataSet->getPayloadHeight();
+						}
+						else {
+							jsonPayload["width"] = (int) this->suite->payload->getWidth();
+							jsonPayload["height"] = (int) this->suite->payload->getHeight();
+						}
 
+						//if the full data set was never loaded then the file on disk is still current
 						auto filename = this->getDefaultFilename() + ".sl";
-						this->suite->decoder.saveDataSet(filename);
+						if (this->deferredDataSetFilename != filename) {
+							this->getDecoder().saveDataSet(filename);
+						}
 						json["filename"] = filename;
+
+						//lookups for fast loading. Once saved we use the file mapping instead of our own copy
+						if (this->mappedDataSet) {
+							auto mapFilename = this->getDefaultFilename() + ".slmap";
+							try {
+								//if we're already mapping that file then it's current, and consumers keep the same data set
+								if (!this->mappedDataSet->isMapped() || this->mappedDataSet->getFilename() != ofToDataPath(mapFilename, true)) {
+									this->mappedDataSet = this->mappedDataSet->saveAndOpen(mapFilename);
+								}
+								json["mapFilename"] = mapFilename;
+							}
+							RULR_CATCH_ALL_TO_ERROR;
+						}
 					}
 					else {
 						json["hasData"] = false;
@@ -147,7 +175,22 @@ namespace ofxRulr {
 						auto hasData = json["hasData"].asBool();
 						if (hasData) {
 							auto filename = json["filename"].asString();
-							this->importDataSet(filename);
+
+							//map the lookups and only load the full data set when somebody asks for it
+							bool mapped = false;
+							if (json.isMember("mapFilename")) {
+								try {
+									this->invalidateSuite();
+									this->mappedDataSet = Utils::MappedDataSet::open(json["mapFilename"].asString());
+									this->deferredDataSetFilename = filename;
+									mapped = true;
+								}
+								RULR_CATCH_ALL_TO_ERROR;
+							}
+
+							if (!mapped) {
+								this->importDataSet(filename);
+							}
 						}
 					}
 
@@ -184,6 +227,7 @@ namespace ofxRulr {
 
 					//rebuild suite
 					{
+						this->deferredDataSetFilename.clear();
 						auto suite = make_unique<Suite>();
 						suite->payload = make_shared<ofxGraycode::PayloadGraycode>();
 						suite->payload->init(videoOutputSize.width, videoOutputSize.height);
@@ -260,7 +304,7 @@ namespace ofxRulr {
 					}
 					ofShowCursor();
 
-					this->previewDirty = true;
+					this->updateMappedDataSet();
 				}
 				
 				//----------
@@ -270,7 +314,10 @@ namespace ofxRulr {
 
 				//----------
 				bool Graycode::hasData() const {
-					if (this->suite) {
+					if (this->mappedDataSet) {
+						return true;
+					}
+					else if (this->suite) {
 						return this->suite->decoder.hasData();
 					}
 					else {
@@ -290,6 +337,8 @@ namespace ofxRulr {
 
 				//----------
 				ofxGraycode::Decoder & Graycode::getDecoder() const {
+					this->loadDeferredDataSet();
+
 					if (this->suite) {
 						return this->suite->decoder;
 					}
@@ -309,11 +358,29 @@ namespace ofxRulr {
 				void Graycode::setDataSet(const ofxGraycode::DataSet & dataSet) {
 					//will throw if needs be
 					this->getDecoder().setDataSet(dataSet);
-					this->previewDirty = true;
+					this->updateMappedDataSet();
+				}
+
+				//----------
+				shared_ptr<const Utils::MappedDataSet> Graycode::getMappedDataSet() const {
+					return this->mappedDataSet;
+				}
+
+				//----------
+				const ofTexture & Graycode::getProjectorInCameraPreview() {
+					this->updateMappedPreview(this->projectorInCameraPreview, &Utils::MappedDataSet::getProjectorInCameraPreview);
+					return this->projectorInCameraPreview.texture;
+				}
+
+				//----------
+				const ofTexture & Graycode::getCameraInProjectorPreview() {
+					this->updateMappedPreview(this->cameraInProjectorPreview, &Utils::MappedDataSet::getCameraInProjectorPreview);
+					return this->cameraInProjectorPreview.texture;
 				}
 
 				//----------
 				void Graycode::importDataSet(const string & filename) {
+					this->deferredDataSetFilename.clear();
 					if (!this->hasScanSuite()) {
 						this->suite = make_unique<Suite>();
 					}
@@ -323,14 +390,15 @@ namespace ofxRulr {
 					this->suite->encoder.init(suite->payload);
 					this->parameters.processing.threshold = this->suite->decoder.getThreshold();
 
-					this->previewDirty = true;
+					this->updateMappedDataSet();
 				}
 
 				//----------
 				void Graycode::exportDataSet(const string & filename) {
-					if (this->suite) {
-						this->suite->decoder.saveDataSet(filename);
-						this->suite->decoder.savePreviews();
+					if (this->suite || !this->deferredDataSetFilename.empty()) {
+						auto & decoder = this->getDecoder();
+						decoder.saveDataSet(filename);
+						decoder.savePreviews();
 					}
 					else {
 						ofSystemAlertDialog("No data to save yet. Have you scanned?");
@@ -340,9 +408,57 @@ namespace ofxRulr {
 				//----------
 				void Graycode::invalidateSuite() {
 					this->suite.reset();
+					this->mappedDataSet.reset();
+					this->deferredDataSetFilename.clear();
 					this->previewDirty = true;
 				}
 
+				//----------
+				void Graycode::loadDeferredDataSet() const {
+					if (this->deferredDataSetFilename.empty()) {
+						return;
+					}
+					auto filename = this->deferredDataSetFilename;
+					this->deferredDataSetFilename.clear();
+
+					//the mapped lookups came from this same file, so they stay as they are
+					if (!this->suite) {
+						this->suite = make_unique<Suite>();
+					}
+					this->suite->decoder.loadDataSet(filename);
+					this->suite->payload = this->suite->decoder.getPayload();
+					this->suite->encoder.init(this->suite->payload);
+				}
+
+				//----------
+				void Graycode::updateMappedDataSet() {
+					if (this->suite && this->suite->decoder.getDataSet().getHasData()) {
+						this->mappedDataSet = Utils::MappedDataSet::fromDataSet(this->suite->decoder.getDataSet());
+					}
+					else {
+						this->mappedDataSet.reset();
+					}
+					this->previewDirty = true;
+				}
+
+				//----------
+				void Graycode::updateMappedPreview(MappedPreview & mappedPreview, ofPixels (Utils::MappedDataSet::*getPixels)() const) {
+					auto mappedDataSet = this->mappedDataSet;
+					if (!mappedDataSet) {
+						if (mappedPreview.contentId != 0) {
+							mappedPreview.texture.clear();
+							mappedPreview.contentId = 0;
+						}
+						return;
+					}
+
+					//only rebuilt when the data changes (saving swaps in a mapping of the same content)
+					if (mappedPreview.contentId != mappedDataSet->getContentId()) {
+						mappedPreview.texture.loadData(((*mappedDataSet).*getPixels)());
+						mappedPreview.contentId = mappedDataSet->getContentId();
+					}
+				}
+
 				//----------
 				void Graycode::drawPreviewOnVideoOutput(const ofRectangle & rectangle) {
 					this->preview.draw(rectangle);
@@ -382,12 +498,21 @@ namespace ofxRulr {
 						inspector->add(new Widgets::LiveValue<string>("Has data", [this]() {
 							return this->hasData() ? "True" : "False";
 						}));
+						inspector->add(new Widgets::LiveValue<string>("Lookups", [this]() {
+							if (!this->mappedDataSet) {
+								return "None";
+							}
+							return this->mappedDataSet->isMapped() ? "Mapped from file" : "In memory";
+						}));
 					}
 
 					inspector->add(new Widgets::Title("Payload", Widgets::Title::Level::H2));
 					{
 						inspector->add(new Widgets::LiveValue<unsigned int>("Width", [this]() {
-							if (this->suite) {
+							if (this->mappedDataSet) {
+								return (uint32_t) this->mappedDataSet->getPayloadWidth();
+							}
+							else if (this->suite) {
 								return this->suite->payload->getWidth();
 							}
 							else {
@@ -395,7 +520,10 @@ namespace ofxRulr {
 							}
 						}));
 						inspector->add(new Widgets::LiveValue<unsigned int>("Height", [this]() {
-							if (this->suite) {
+							if (this->mappedDataSet) {
+								return (uint32_t) this->mappedDataSet->getPayloadHeight();
+							}
+							else if (this->suite) {
 								return this->suite->payload->getHeight();
 							}
 							else {
@@ -407,7 +535,10 @@ namespace ofxRulr {
 					inspector->add(new Widgets::Title("Scan camera", Widgets::Title::Level::H2));
 					{
 						inspector->add(new Widgets::LiveValue<unsigned int>("Width", [this]() {
-							if (this->suite) {
+							if (this->mappedDataSet) {
+								return (uint32_t) this->mappedDataSet->getWidth();
+							}
+							else if (this->suite) {
 								return (uint32_t) this->suite->decoder.getWidth();
 							}
 							else {
@@ -415,7 +546,10 @@ namespace ofxRulr {
 							}
 						}));
 						inspector->add(new Widgets::LiveValue<unsigned int>("Height", [this]() {
-							if (this->suite) {
+							if (this->mappedDataSet) {
+								return (uint32_t) this->mappedDataSet->getHeight();
+							}
+							else if (this->suite) {
 								return (uint32_t) this->suite->decoder.getHeight();
 							}
 							else {
@@ -430,31 +564,38 @@ namespace ofxRulr {
 					this->preview.clear();
 					
 					try {
+						//previews come from the lookups, so showing them doesn't need the full data set
+						auto mappedDataSet = this->mappedDataSet;
+						if (!mappedDataSet) {
+							this->previewDirty = false;
+							return;
+						}
+
 						auto previewMode = static_cast<PreviewMode>(this->parameters.preview.previewMode.get());
 						switch (previewMode) {
 						case PreviewMode::CameraInProjector:
 						{
-							this->preview.loadData(this->getDecoder().getCameraInProjector().getPixels());
+							this->preview.loadData(mappedDataSet->getCameraInProjectorPreview());
 							break;
 						}
 						case PreviewMode::ProjectorInCamera:
 						{
-							this->preview.loadData(this->getDecoder().getProjectorInCamera().getPixels());
+							this->preview.loadData(mappedDataSet->getProjectorInCameraPreview());
 							break;
 						}
 						case PreviewMode::Median:
 						{
-							this->preview.loadData(this->getDecoder().getDataSet().getMedian());
+							this->preview.loadData(mappedDataSet->getMedianPixels());
 							break;
 						}
 						case PreviewMode::MedianInverse:
 						{
-							this->preview.loadData(this->getDecoder().getDataSet().getMedianInverse());
+							this->preview.loadData(mappedDataSet->getMedianInversePixels());
 							break;
 						}
 						case PreviewMode::Active:
 						{
-							this->preview.loadData(this->getDecoder().getDataSet().getActive());
+							this->preview.loadData(mappedDataSet->getActivePixels());
 							break;
 						}
 						default:
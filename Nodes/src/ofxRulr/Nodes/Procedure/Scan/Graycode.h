@@ -5,6 +5,7 @@
 #include "ofxGraycode.h"
 #include "ofxCvGui/Panels/Image.h"
 #include "ofxRulr/Utils/VideoOutputListener.h"
+#include "ofxRulr/Utils/MappedDataSet.h"
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -35,10 +36,17 @@ namespace ofxRulr {
 					bool hasData() const;
 
 					bool hasScanSuite() const;
-					ofxGraycode::Decoder & getDecoder() const;
+					ofxGraycode::Decoder & getDecoder() const; // loads the full data set if we've only mapped it so far
 					const ofxGraycode::DataSet & getDataSet() const;
 					void setDataSet(const ofxGraycode::DataSet &);
 
+					///Shared, read-only lookups of the current data. nullptr if there's no data
+					shared_ptr<const Utils::MappedDataSet> getMappedDataSet() const;
+
+					///Built from the mapped data set, so drawing these never loads the full data set. Main thread only
+					const ofTexture & getProjectorInCameraPreview();
+					const ofTexture & getCameraInProjectorPreview();
+
 					void importDataSet(const string & filename = "");
 					void exportDataSet(const string & filename = "");
 				protected:
@@ -49,6 +57,14 @@ namespace ofxRulr {
 					};
 
 					void invalidateSuite();
+					void loadDeferredDataSet() const;
+					void updateMappedDataSet();
+
+					struct MappedPreview {
+						ofTexture texture;
+						uint64_t contentId = 0;
+					};
+					void updateMappedPreview(MappedPreview &, ofPixels (Utils::MappedDataSet::*getPixels)() const);
 					void drawPreviewOnVideoOutput(const ofRectangle &);
 					void populateInspector(ofxCvGui::InspectArguments &);
 					void updatePreview();
@@ -56,7 +72,9 @@ namespace ofxRulr {
 					
 					ofxCvGui::PanelPtr view;
 
-					unique_ptr<Suite> suite;
+					mutable unique_ptr<Suite> suite;
+					shared_ptr<Utils::MappedDataSet> mappedDataSet;
+					mutable string deferredDataSetFilename; // .sl file to load into the decoder when first needed
 
 					ofImage message;
 					
@@ -86,6 +104,8 @@ namespace ofxRulr {
 					
 					ofTexture testPattern;
 					ofTexture preview;
+					MappedPreview projectorInCameraPreview;
+					MappedPreview cameraInProjectorPreview;
 					uint8_t testPatternBrightness = 0;
 					bool previewDirty = true;
 					bool shouldLoadWhenReady = false;
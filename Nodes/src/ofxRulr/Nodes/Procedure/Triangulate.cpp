@@ -5,15 +5,135 @@
 #include "../Item/Projector.h"
 #include "./Scan/Graycode.h"
 
-#include "ofxTriangulate.h"
 #include "ofxCvGui.h"
 
+#include "ofxRulr/Utils/ParallelFor.h"
+
 using namespace ofxRulr::Nodes;
 using namespace ofxCvGui;
 
 namespace ofxRulr {
 	namespace Nodes {
 		namespace Procedure {
+			namespace {
+				//camera pixels are triangulated in square tiles, a multiple of the coarsest cluster
+				const int TileSize = 64;
+
+				//plane quadric (Garland & Heckbert) plus what we need to average the points in a cluster
+				struct Cluster {
+					double quadric[10] = { 0 }; // aa ab ac ad bb bc bd cc cd dd
+					ofVec3f positionSum;
+					ofVec3f minimum{ numeric_limits<float>::max() };
+					ofVec3f maximum{ -numeric_limits<float>::max() };
+					ofVec2f cameraSum;
+					float medianSum = 0.0f;
+					int count = 0;
+
+					//----------
+					void addPlane(const ofVec3f & a, const ofVec3f & b, const ofVec3f & c) {
+						auto normal = (b - a).getCrossed(c - a);
+						const auto area = normal.length() / 2.0f;
+						if (area <= 0.0f) {
+							return;
+						}
+						normal.normalize();
+						const double n[4] = { normal.x, normal.y, normal.z, -normal.dot(a) };
+						int index = 0;
+						for (int i = 0; i < 4; i++) {
+							for (int j = i; j < 4; j++) {
+								this->quadric[index++] += area * n[i] * n[j];
+							}
+						}
+					}
+
+					//----------
+					void add(const Cluster & other) {
+						for (int i = 0; i < 10; i++) {
+							this->quadric[i] += other.quadric[i];
+						}
+						this->positionSum += other.positionSum;
+						this->minimum.set(min(this->minimum.x, other.minimum.x), min(this->minimum.y, other.minimum.y), min(this->minimum.z, other.minimum.z));
+						this->maximum.set(max(this->maximum.x, other.maximum.x), max(this->maximum.y, other.maximum.y), max(this->maximum.z, other.maximum.z));
+						this->cameraSum += other.cameraSum;
+						this->medianSum += other.medianSum;
+						this->count += other.count;
+					}
+
+					//----------
+					///The point with least quadric error, found around the mean using only the well constrained
+					///directions (e.g. a flat patch only constrains the normal), as in Lindstrom's vertex clustering
+					ofVec3f getRepresentative() const {
+						const ofVec3f mean = this->positionSum / this->count;
+						const auto & q = this->quadric;
+
+						//eigen decomposition of the 3x3 part by Jacobi rotations
+						double A[3][3] = {
+							{ q[0], q[1], q[2] },
+							{ q[1], q[4], q[5] },
+							{ q[2], q[5], q[7] }
+						};
+						double V[3][3] = { { 1, 0, 0 },{ 0, 1, 0 },{ 0, 0, 1 } };
+						for (int sweep = 0; sweep < 8; sweep++) {
+							for (int p = 0; p < 2; p++) {
+								for (int r = p + 1; r < 3; r++) {
+									if (abs(A[p][r]) < 1e-30) {
+										continue;
+									}
+									const auto theta = (A[r][r] - A[p][p]) / (2.0 * A[p][r]);
+									const auto t = (theta >= 0 ? 1.0 : -1.0) / (abs(theta) + sqrt(theta * theta + 1.0));
+									const auto cosine = 1.0 / sqrt(t * t + 1.0);
+									const auto sine = t * cosine;
+									for (int k = 0; k < 3; k++) {
+										const auto akp = A[k][p], akr = A[k][r];
+										A[k][p] = cosine * akp - sine * akr;
+										A[k][r] = sine * akp + cosine * akr;
+									}
+									for (int k = 0; k < 3; k++) {
+										const auto apk = A[p][k], ark = A[r][k];
+										A[p][k] = cosine * apk - sine * ark;
+										A[r][k] = sine * apk + cosine * ark;
+									}
+									for (int k = 0; k < 3; k++) {
+										const auto vkp = V[k][p], vkr = V[k][r];
+										V[k][p] = cosine * vkp - sine * vkr;
+										V[k][r] = sine * vkp + cosine * vkr;
+									}
+								}
+							}
+						}
+
+						//gradient of the error at the mean
+						const double gradient[3] = {
+							q[0] * mean.x + q[1] * mean.y + q[2] * mean.z + q[3],
+							q[1] * mean.x + q[4] * mean.y + q[5] * mean.z + q[6],
+							q[2] * mean.x + q[5] * mean.y + q[7] * mean.z + q[8]
+						};
+						const auto largest = max(A[0][0], max(A[1][1], A[2][2]));
+						if (largest <= 0.0) {
+							return mean;
+						}
+
+						ofVec3f representative = mean;
+						for (int i = 0; i < 3; i++) {
+							if (A[i][i] > largest * 1e-3) {
+								const auto step = -(V[0][i] * gradient[0] + V[1][i] * gradient[1] + V[2][i] * gradient[2]) / A[i][i];
+								representative += ofVec3f(V[0][i], V[1][i], V[2][i]) * step;
+							}
+						}
+
+						//stay inside the cluster
+						const auto margin = (this->maximum - this->minimum) * 0.1f;
+						const auto low = this->minimum - margin;
+						const auto high = this->maximum + margin;
+						if (representative.x < low.x || representative.y < low.y || representative.z < low.z
+							|| representative.x > high.x || representative.y > high.y || representative.z > high.z) {
+							return mean;
+						}
+						return representative;
+					}
+				};
+			}
+
 			//----------
 			Triangulate::Triangulate() {
 				RULR_NODE_INIT_LISTENER;
@@ -37,6 +157,17 @@ namespace ofxRulr {
 				this->giveColor.set("Give color", true);
 				this->giveTexCoords.set("Give texture coordinates", true);
 				this->drawPointSize.set("Point size for draw", 1.0f, 1.0f, 10.0f);
+				this->levelCount.set("Levels of detail", 4, 1, 4);
+				this->lodEdgeLimit.set("LOD edge limit [m]", 0.02f, 0.0f, 1.0f);
+				this->drawPointBudget.set("Draw point budget", 1000000, 0, 10000000); // 0 for full resolution
+				this->threadCount.set("Threads", 0, 0, 64); // 0 for hardware concurrency
+
+				this->levels.resize(1);
+
+				this->addAction("Triangulate", [this](Json::Value & report) {
+					this->triangulate();
+					report["pointCount"] = (Json::UInt64) this->getMesh().getNumVertices();
+				});
 			}
 
 			//----------
@@ -46,31 +177,285 @@ namespace ofxRulr {
 
 			//----------
 			void Triangulate::serialize(Json::Value & json) {
-
+				Utils::Serializable::serialize(json, this->maxLength);
+				Utils::Serializable::serialize(json, this->giveColor);
+				Utils::Serializable::serialize(json, this->giveTexCoords);
+				Utils::Serializable::serialize(json, this->drawPointSize);
+				Utils::Serializable::serialize(json, this->levelCount);
+				Utils::Serializable::serialize(json, this->lodEdgeLimit);
+				Utils::Serializable::serialize(json, this->drawPointBudget);
+				Utils::Serializable::serialize(json, this->threadCount);
 			}
 
 			//----------
 			void Triangulate::deserialize(const Json::Value & json) {
-
+				Utils::Serializable::deserialize(json, this->maxLength);
+				Utils::Serializable::deserialize(json, this->giveColor);
+				Utils::Serializable::deserialize(json, this->giveTexCoords);
+				Utils::Serializable::deserialize(json, this->drawPointSize);
+				Utils::Serializable::deserialize(json, this->levelCount);
+				Utils::Serializable::deserialize(json, this->lodEdgeLimit);
+				Utils::Serializable::deserialize(json, this->drawPointBudget);
+				Utils::Serializable::deserialize(json, this->threadCount);
 			}
 
 			//----------
 			void Triangulate::triangulate() {
+				typedef chrono::high_resolution_clock Clock;
+
 				this->throwIfMissingAnyConnection();
 
 				auto camera = this->getInput<Item::Camera>();
 				auto projector = this->getInput<Item::Projector>();
 				auto graycode = this->getInput<Scan::Graycode>();
 
-				const auto & dataSet = graycode->getDataSet();
+				auto dataSet = graycode->getMappedDataSet();
+				if (!dataSet) {
+					throw(Exception("No scan data available"));
+				}
+
+				const auto cameraView = camera->getViewInWorldSpace();
+				const auto projectorView = projector->getViewInWorldSpace();
+
+				const auto width = dataSet->getWidth();
+				const auto height = dataSet->getHeight();
+				const auto projectorWidth = dataSet->getPayloadWidth();
+				const auto data = dataSet->getData();
+				const auto active = dataSet->getActive();
+				const auto median = dataSet->getMedian();
+
+				const auto maxLengthSquared = this->maxLength * this->maxLength;
+				const auto giveColor = this->giveColor.get();
+				const auto giveTexCoords = this->giveTexCoords.get();
+				const auto threadCount = (size_t) this->threadCount.get(); // 0 for hardware concurrency
 
 				Utils::ScopedProcess scopedProcess("Triangulating");
-				ofxTriangulate::Triangulate(dataSet, camera->getViewInWorldSpace(), projector->getViewInWorldSpace(), this->mesh, this->maxLength, this->giveColor, this->giveTexCoords);
-				if (this->mesh.getNumVertices() > 0) {
+
+				vector<Level> levels(1);
+
+				//intersect the camera and projector rays of each active pixel, tile by tile
+				vector<ofVec3f> positions(width * height);
+				vector<uint8_t> valid(width * height, 0);
+				{
+					auto startTime = Clock::now();
+
+					const auto tilesX = (width + TileSize - 1) / TileSize;
+					const auto tilesY = (height + TileSize - 1) / TileSize;
+					Utils::parallelFor(tilesX * tilesY, [&](size_t tileIndex) {
+						const auto tileX = (int) (tileIndex % tilesX) * TileSize;
+						const auto tileY = (int) (tileIndex / tilesX) * TileSize;
+						for (int j = tileY; j < min(tileY + TileSize, height); j++) {
+							for (int i = tileX; i < min(tileX + TileSize, width); i++) {
+								const auto cameraIndex = i + j * width;
+								if (!active[cameraIndex]) {
+									continue;
+								}
+								const auto projectorIndex = data[cameraIndex];
+								const auto cameraRay = cameraView.castPixel(ofVec2f(i, j));
+								const auto projectorRay = projectorView.castPixel(ofVec2f(projectorIndex % projectorWidth, projectorIndex / projectorWidth));
+								const auto intersect = cameraRay.intersect(projectorRay);
+								if (intersect.getLengthSquared() > maxLengthSquared) {
+									continue;
+								}
+								positions[cameraIndex] = intersect.getMidpoint();
+								valid[cameraIndex] = 1;
+							}
+						}
+					}, threadCount);
+
+					//full resolution, in camera pixel order
+					auto & mesh = levels[0].mesh;
+					mesh.setMode(OF_PRIMITIVE_POINTS);
+					for (int cameraIndex = 0; cameraIndex < width * height; cameraIndex++) {
+						if (valid[cameraIndex]) {
+							mesh.addVertex(positions[cameraIndex]);
+							if (giveColor) {
+								mesh.addColor(ofColor(median[cameraIndex]));
+							}
+							if (giveTexCoords) {
+								mesh.addTexCoord(ofVec2f(cameraIndex % width, cameraIndex / width));
+							}
+						}
+					}
+
+					levels[0].buildDuration = chrono::duration<float, milli>(Clock::now() - startTime).count();
+				}
+
+				//levels of detail. The camera pixel grid gives us the surface, whose plane quadrics are
+				//gathered into 2x2 clusters of pixels, then 2x2 clusters of those, and so on
+				{
+					const auto lodEdgeLimitSquared = this->lodEdgeLimit * this->lodEdgeLimit;
+					auto isValid = [&](int i, int j) {
+						return i >= 0 && j >= 0 && i < width && j < height && valid[i + j * width];
+					};
+					auto isTriangle = [&](int ai, int aj, int bi, int bj, int ci, int cj) {
+						if (!isValid(ai, aj) || !isValid(bi, bj) || !isValid(ci, cj)) {
+							return false;
+						}
+						const auto & a = positions[ai + aj * width];
+						const auto & b = positions[bi + bj * width];
+						const auto & c = positions[ci + cj * width];
+						return a.squareDistance(b) < lodEdgeLimitSquared
+							&& b.squareDistance(c) < lodEdgeLimitSquared
+							&& c.squareDistance(a) < lodEdgeLimitSquared;
+					};
+
+					vector<Cluster> clusters;
+					auto clustersWidth = width;
+					auto clustersHeight = height;
+
+					for (int level = 1; level < this->levelCount; level++) {
+						auto startTime = Clock::now();
+
+						const auto nextWidth = (clustersWidth + 1) / 2;
+						const auto nextHeight = (clustersHeight + 1) / 2;
+						vector<Cluster> nextClusters(nextWidth * nextHeight);
+
+						Utils::parallelFor(nextHeight, [&](size_t row) {
+							const auto j0 = (int) row * 2;
+							for (int i0 = 0; i0 < clustersWidth; i0 += 2) {
+								auto & cluster = nextClusters[i0 / 2 + row * nextWidth];
+								for (int j = j0; j < min(j0 + 2, clustersHeight); j++) {
+									for (int i = i0; i < min(i0 + 2, clustersWidth); i++) {
+										if (level > 1) {
+											cluster.add(clusters[i + j * clustersWidth]);
+											continue;
+										}
+
+										//first level, from the pixels
+										if (!valid[i + j * width]) {
+											continue;
+										}
+										const auto & position = positions[i + j * width];
+										cluster.positionSum += position;
+										cluster.minimum.set(min(cluster.minimum.x, position.x), min(cluster.minimum.y, position.y), min(cluster.minimum.z, position.z));
+										cluster.maximum.set(max(cluster.maximum.x, position.x), max(cluster.maximum.y, position.y), max(cluster.maximum.z, position.z));
+										cluster.cameraSum += ofVec2f(i, j);
+										cluster.medianSum += median[i + j * width];
+										cluster.count++;
+
+										//each grid square is split along the same diagonal. add the triangles touching this pixel
+										for (int quadJ = j - 1; quadJ <= j; quadJ++) {
+											for (int quadI = i - 1; quadI <= i; quadI++) {
+												const int first[3][2] = { { quadI, quadJ },{ quadI + 1, quadJ },{ quadI, quadJ + 1 } };
+												const int second[3][2] = { { quadI + 1, quadJ },{ quadI + 1, quadJ + 1 },{ quadI, quadJ + 1 } };
+												for (const auto & triangle : { first, second }) {
+													bool touches = false;
+													for (int k = 0; k < 3; k++) {
+														touches |= triangle[k][0] == i && triangle[k][1] == j;
+													}
+													if (touches && isTriangle(triangle[0][0], triangle[0][1], triangle[1][0], triangle[1][1], triangle[2][0], triangle[2][1])) {
+														cluster.addPlane(positions[triangle[0][0] + triangle[0][1] * width]
+															, positions[triangle[1][0] + triangle[1][1] * width]
+															, positions[triangle[2][0] + triangle[2][1] * width]);
+													}
+												}
+											}
+										}
+									}
+								}
+							}
+						}, threadCount);
+
+						swap(clusters, nextClusters);
+						clustersWidth = nextWidth;
+						clustersHeight = nextHeight;
+
+						vector<ofVec3f> representatives(clusters.size());
+						Utils::parallelFor(clusters.size(), [&](size_t clusterIndex) {
+							const auto & cluster = clusters[clusterIndex];
+							if (cluster.count > 0) {
+								representatives[clusterIndex] = cluster.getRepresentative();
+							}
+						}, threadCount);
+
+						Level lod;
+						lod.mesh.setMode(OF_PRIMITIVE_POINTS);
+						for (size_t clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++) {
+							const auto & cluster = clusters[clusterIndex];
+							if (cluster.count == 0) {
+								continue;
+							}
+							lod.mesh.addVertex(representatives[clusterIndex]);
+							if (giveColor) {
+								lod.mesh.addColor(ofColor(cluster.medianSum / cluster.count));
+							}
+							if (giveTexCoords) {
+								lod.mesh.addTexCoord(cluster.cameraSum / cluster.count);
+							}
+						}
+						lod.buildDuration = chrono::duration<float, milli>(Clock::now() - startTime).count();
+						levels.push_back(move(lod));
+					}
+				}
+
+				this->levels = move(levels);
+				for (size_t i = 0; i < this->levels.size(); i++) {
+					ofLogNotice("ofxRulr::Triangulate") << "Level " << i << " : " << this->levels[i].mesh.getNumVertices() << " points in " << this->levels[i].buildDuration << "ms";
+				}
+				ofxCvGui::refreshInspector(this);
+
+				if (this->levels[0].mesh.getNumVertices() > 0) {
 					scopedProcess.end();
 				}
 			}
 
+			//----------
+			void Triangulate::measureDrawTimes() {
+				typedef chrono::high_resolution_clock Clock;
+				const int repeats = 10;
+
+				this->throwIfMissingAConnection<Item::Camera>();
+				const auto view = this->getInput<Item::Camera>()->getViewInWorldSpace();
+
+				//drawn as the camera sees them, so that every point lands on screen
+				ofFbo fbo;
+				fbo.allocate(view.getWidth(), view.getHeight(), GL_RGBA);
+
+				for (auto & level : this->levels) {
+					fbo.begin();
+					{
+						ofClear(0, 0);
+						view.beginAsCamera();
+						{
+							//upload before we start timing
+							level.mesh.drawVertices();
+							glFinish();
+
+							auto startTime = Clock::now();
+							for (int i = 0; i < repeats; i++) {
+								level.mesh.drawVertices();
+							}
+							glFinish();
+							level.drawDuration = chrono::duration<float, milli>(Clock::now() - startTime).count() / repeats;
+						}
+						view.endAsCamera();
+					}
+					fbo.end();
+				}
+
+				for (size_t i = 0; i < this->levels.size(); i++) {
+					ofLogNotice("ofxRulr::Triangulate") << "Level " << i << " : " << this->levels[i].mesh.getNumVertices() << " points drawn in " << this->levels[i].drawDuration << "ms";
+				}
+			}
+
+			//----------
+			const ofMesh & Triangulate::getMesh(size_t pointBudget) const {
+				if (pointBudget > 0) {
+					for (const auto & level : this->levels) {
+						if (level.mesh.getNumVertices() <= pointBudget) {
+							return level.mesh;
+						}
+					}
+				}
+				return pointBudget > 0 ? this->levels.back().mesh : this->levels.front().mesh;
+			}
+
+			//----------
+			size_t Triangulate::getLevelCount() const {
+				return this->levels.size();
+			}
+
 			//----------
 			void Triangulate::populateInspector(ofxCvGui::InspectArguments & inspectArguments) {
 				auto inspector = inspectArguments.inspector;
@@ -87,17 +472,38 @@ namespace ofxRulr {
 				inspector->add(triangulateButton);
 
 				inspector->addLiveValue<size_t>("Point count", [this]() {
-					return this->mesh.getNumVertices();
+					return this->getMesh().getNumVertices();
 				});
 
 				inspector->add(new Widgets::Slider(this->maxLength));
 				inspector->add(new Widgets::Toggle(this->giveColor));
 				inspector->add(new Widgets::Toggle(this->giveTexCoords));
 				inspector->add(new Widgets::Slider(this->drawPointSize));
+				inspector->add(new Widgets::EditableValue<int>(this->levelCount));
+				inspector->add(new Widgets::Slider(this->lodEdgeLimit));
+				inspector->add(new Widgets::EditableValue<int>(this->drawPointBudget));
+				inspector->add(new Widgets::EditableValue<int>(this->threadCount));
+
+				inspector->add(new Widgets::Title("Levels of detail", Widgets::Title::Level::H3));
+				inspector->add(new Widgets::Button("Measure draw times", [this]() {
+					try {
+						this->measureDrawTimes();
+					}
+					RULR_CATCH_ALL_TO_ALERT;
+				}));
+				for (size_t i = 0; i < this->levels.size(); i++) {
+					inspector->addLiveValue<string>("Level " + ofToString(i) + " points / build / draw [ms]", [this, i]() {
+						if (i >= this->levels.size()) {
+							return string();
+						}
+						const auto & level = this->levels[i];
+						return ofToString(level.mesh.getNumVertices()) + " / " + ofToString(level.buildDuration) + " / " + ofToString(level.drawDuration);
+					});
+				}
 				inspector->add(new Widgets::Button("Save ofMesh...", [this]() {
 					auto result = ofSystemSaveDialog("mesh.ply", "Save mesh as PLY");
 					if (result.bSuccess) {
-						this->mesh.save(result.filePath);
+						this->getMesh().save(result.filePath);
 					}
 				}));
 				inspector->add(new Widgets::Button("Save binary mesh...", [this]() {
@@ -108,17 +514,19 @@ namespace ofxRulr {
 							ofLogError("ofxRulr::Triangulate") << "save failed to open file " << result.fileName;
 							return;
 						}
-						auto numVertices = (uint32_t) this->mesh.getNumVertices();
+						const auto & mesh = this->getMesh();
+
+						auto numVertices = (uint32_t) mesh.getNumVertices();
 						save.write((char *)& numVertices, sizeof(numVertices));
-						save.write((char *) this->mesh.getVerticesPointer(), sizeof(ofVec3f)* numVertices);
+						save.write((char *) mesh.getVerticesPointer(), sizeof(ofVec3f)* numVertices);
 
-						auto numTexCoords = (uint32_t) this->mesh.getNumTexCoords();
+						auto numTexCoords = (uint32_t) mesh.getNumTexCoords();
 						save.write((char *)& numTexCoords, sizeof(numTexCoords));
-						save.write((char *) this->mesh.getTexCoordsPointer(), sizeof(ofVec2f)* numTexCoords);
+						save.write((char *) mesh.getTexCoordsPointer(), sizeof(ofVec2f)* numTexCoords);
 
-						auto numColors = (uint32_t) this->mesh.getNumColors();
+						auto numColors = (uint32_t) mesh.getNumColors();
 						save.write((char *)& numColors, sizeof(numColors));
-						save.write((char *) this->mesh.getColorsPointer(), sizeof(ofFloatColor)* numColors);
+						save.write((char *) mesh.getColorsPointer(), sizeof(ofFloatColor)* numColors);
 
 						save.close();
 					}
@@ -129,7 +537,7 @@ namespace ofxRulr {
 			void Triangulate::drawWorldStage() {
 				Utils::Graphics::pushPointSize(this->drawPointSize);
 				{
-					this->mesh.drawVertices();
+					this->getMesh((size_t) this->drawPointBudget.get()).drawVertices();
 				}
 				Utils::Graphics::popPointSize();
 
@@ -138,13 +546,13 @@ namespace ofxRulr {
 				auto camera = this->getInput<Item::Camera>();
 				if (camera) {
 					if (graycode) {
-						camera->getViewInWorldSpace().drawOnNearPlane(graycode->getDecoder().getProjectorInCamera());
+						camera->getViewInWorldSpace().drawOnNearPlane(graycode->getProjectorInCameraPreview());
 					}
 				}
 				auto projector = this->getInput<Item::Projector>();
 				if (projector) {
 					if (graycode) {
-						projector->getViewInWorldSpace().drawOnNearPlane(graycode->getDecoder().getCameraInProjector());
+						projector->getViewInWorldSpace().drawOnNearPlane(graycode->getCameraInProjectorPreview());
 					}
 				}
 			}
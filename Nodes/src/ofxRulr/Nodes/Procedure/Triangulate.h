@@ -19,16 +19,30 @@ namespace ofxRulr {
 				void deserialize(const Json::Value &);
 
 				void triangulate();
+				void measureDrawTimes();
+
+				///The finest level of detail with no more than pointBudget points (0 for full resolution)
+				const ofMesh & getMesh(size_t pointBudget = 0) const;
+				size_t getLevelCount() const;
 			protected:
 				void populateInspector(ofxCvGui::InspectArguments &);
 				void drawWorldStage();
 
-				ofMesh mesh;
+				struct Level {
+					ofVboMesh mesh;
+					float buildDuration = 0.0f; // ms, level 0 is the triangulation itself
+					float drawDuration = 0.0f; // ms, from measureDrawTimes
+				};
+				vector<Level> levels; // full resolution first, then clusters of 2x2, 4x4, 8x8 camera pixels
 
 				ofParameter<float> maxLength;
 				ofParameter<bool> giveColor;
 				ofParameter<bool> giveTexCoords;
 				ofParameter<float> drawPointSize;
+				ofParameter<int> levelCount;
+				ofParameter<float> lodEdgeLimit;
+				ofParameter<int> drawPointBudget;
+				ofParameter<int> threadCount;
 			};
 		}
 	}
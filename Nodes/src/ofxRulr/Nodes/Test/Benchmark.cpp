@@ -0,0 +1,70 @@
+#include "pch_RulrNodes.h"
+#include "Benchmark.h"
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			//----------
+			Benchmark::Benchmark() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			void Benchmark::init() {
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->addAction("Benchmark", [this](Json::Value & report) {
+					if (this->getRunsOverFrames() && !this->getCanWaitForResult()) {
+						throw(ofxRulr::Exception(this->getTypeName() + " measures the frame loop, so it can only be run from the inspector"));
+					}
+					this->run();
+					if (this->getRunsOverFrames()) {
+						this->waitForResult();
+					}
+					this->serializeResult(report);
+				});
+			}
+
+			//----------
+			void Benchmark::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				inspectArgs.inspector->addButton("Run benchmark", [this]() {
+					try {
+						this->run();
+					}
+					RULR_CATCH_ALL_TO_ALERT;
+				});
+			}
+
+			//----------
+			void Benchmark::run() {
+				this->runBenchmark();
+				if (!this->getRunsOverFrames()) {
+					this->notifyResult();
+				}
+			}
+
+			//----------
+			bool Benchmark::getRunsOverFrames() const {
+				return false;
+			}
+
+			//----------
+			bool Benchmark::getCanWaitForResult() const {
+				return false;
+			}
+
+			//----------
+			void Benchmark::waitForResult() {
+
+			}
+
+			//----------
+			void Benchmark::notifyResult() {
+				this->hasResult = true;
+				ofxCvGui::refreshInspector(this);
+			}
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ofxRulr/Nodes/Base.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			///Base for the benchmark nodes. Adds a "Run benchmark" button and a "Benchmark" action (e.g. for
+			///Application::BatchRunner) which runs the benchmark and writes the result into the action's report.
+			class RULR_EXPORTS Benchmark : public Nodes::Base {
+			public:
+				Benchmark();
+				void init();
+
+				void populateInspector(ofxCvGui::InspectArguments &);
+
+				void run();
+				virtual void runBenchmark() = 0;
+				virtual void serializeResult(Json::Value &) const = 0;
+
+				///Benchmarks of the frame loop (e.g. drawing) only start in runBenchmark and call notifyResult
+				///from a later update, so they can't be run as an action unless they can wait for their result
+				virtual bool getRunsOverFrames() const;
+
+				///For benchmarks which run over frames but don't need the app's frame loop to finish
+				///(e.g. they only need update() to be called), so that they can also be run as an action
+				virtual bool getCanWaitForResult() const;
+				virtual void waitForResult();
+			protected:
+				void notifyResult();
+
+				bool hasResult = false;
+			};
+		}
+	}
+}
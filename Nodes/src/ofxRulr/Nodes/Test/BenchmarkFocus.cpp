@@ -0,0 +1,178 @@
+#include "pch_RulrNodes.h"
+#include "BenchmarkFocus.h"
+
+#include "ofxRulr/Utils/FocusMeasure.h"
+#include "ofxRulr/Utils/ScopedProcess.h"
+
+#include "ofxCvMin.h"
+
+#include <random>
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			//----------
+			BenchmarkFocus::BenchmarkFocus() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			string BenchmarkFocus::getTypeName() const {
+				return "Test::BenchmarkFocus";
+			}
+
+			//----------
+			void BenchmarkFocus::init() {
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->manageParameters(this->parameters);
+			}
+
+			//----------
+			void BenchmarkFocus::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				for (size_t i = 0; i < this->results.size(); i++) {
+					inspector->addTitle(this->results[i].resolution, ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<float>("Original full frame [ms]", [this, i]() {
+						return this->results[i].original;
+					});
+					inspector->addLiveValue<string>("Laplacian scalar / SIMD [ms]", [this, i]() {
+						return ofToString(this->results[i].laplacianScalar) + " / " + ofToString(this->results[i].laplacianSimd);
+					});
+					inspector->addLiveValue<string>("Tenengrad scalar / SIMD [ms]", [this, i]() {
+						return ofToString(this->results[i].tenengradScalar) + " / " + ofToString(this->results[i].tenengradSimd);
+					});
+					inspector->addLiveValue<string>("ROI grid blur difference / Laplacian [ms]", [this, i]() {
+						return ofToString(this->results[i].roiBlurDifference) + " / " + ofToString(this->results[i].roiLaplacian);
+					});
+				}
+			}
+
+			//----------
+			void BenchmarkFocus::serializeResult(Json::Value & json) const {
+				for (const auto & result : this->results) {
+					Json::Value jsonResult;
+					jsonResult["resolution"] = result.resolution;
+					jsonResult["original"] = result.original;
+					jsonResult["laplacianScalar"] = result.laplacianScalar;
+					jsonResult["laplacianSimd"] = result.laplacianSimd;
+					jsonResult["tenengradScalar"] = result.tenengradScalar;
+					jsonResult["tenengradSimd"] = result.tenengradSimd;
+					jsonResult["roiBlurDifference"] = result.roiBlurDifference;
+					jsonResult["roiLaplacian"] = result.roiLaplacian;
+					json["results"].append(jsonResult);
+				}
+			}
+
+			//----------
+			void BenchmarkFocus::runBenchmark() {
+				typedef chrono::high_resolution_clock Clock;
+
+				const auto iterations = this->parameters.iterations.get();
+				const auto blurSize = this->parameters.blurSize.get();
+				const auto colour = this->parameters.colour.get();
+
+				Utils::ScopedProcess scopedProcess("Benchmark focus", false);
+
+				mt19937 randomEngine(0);
+				uniform_int_distribution<int> noiseDistribution(0, 255);
+
+				//ms per frame
+				auto time = [iterations](const function<void()> & action) {
+					auto startTime = Clock::now();
+					for (int i = 0; i < iterations; i++) {
+						action();
+					}
+					return chrono::duration<float, milli>(Clock::now() - startTime).count() / iterations;
+				};
+
+				vector<Result> results;
+				for (auto size : { cv::Size(2592, 1944), cv::Size(5472, 3648) }) {
+					Result result;
+					result.resolution = ofToString(size.width) + "x" + ofToString(size.height);
+
+					//slightly blurred noise, so the measures have some texture to find
+					cv::Mat grayscale(size, CV_8UC1);
+					for (int j = 0; j < size.height; j++) {
+						auto row = grayscale.ptr<uint8_t>(j);
+						for (int i = 0; i < size.width; i++) {
+							row[i] = (uint8_t) noiseDistribution(randomEngine);
+						}
+					}
+					cv::GaussianBlur(grayscale, grayscale, cv::Size(5, 5), 1.0);
+
+					cv::Mat frame;
+					if (colour) {
+						cv::cvtColor(grayscale, frame, CV_GRAY2RGB);
+					}
+					else {
+						frame = grayscale;
+					}
+
+					auto toGrayscale = [colour](const cv::Mat & input, cv::Mat & output) {
+						if (colour) {
+							cv::cvtColor(input, output, CV_RGB2GRAY);
+						}
+						else {
+							output = input;
+						}
+					};
+
+					auto roiSize = cv::Size(size.width * this->parameters.roiSize, size.height * this->parameters.roiSize);
+					auto roi = cv::Rect((size.width - roiSize.width) / 2, (size.height - roiSize.height) / 2, roiSize.width, roiSize.height);
+					auto cells = Utils::FocusMeasure::getCells(cv::Rect(0, 0, roi.width, roi.height), this->parameters.gridSize, this->parameters.gridSize);
+
+					volatile double sink = 0.0; // keep the measures from being optimised away
+					cv::Mat converted;
+
+					result.original = time([&]() {
+						toGrayscale(frame, converted);
+						sink = sink + Utils::FocusMeasure::blurDifference(converted, blurSize);
+					});
+					result.laplacianScalar = time([&]() {
+						toGrayscale(frame, converted);
+						sink = sink + Utils::FocusMeasure::laplacianVariance(converted, false);
+					});
+					result.laplacianSimd = time([&]() {
+						toGrayscale(frame, converted);
+						sink = sink + Utils::FocusMeasure::laplacianVariance(converted, true);
+					});
+					result.tenengradScalar = time([&]() {
+						toGrayscale(frame, converted);
+						sink = sink + Utils::FocusMeasure::tenengrad(converted, false);
+					});
+					result.tenengradSimd = time([&]() {
+						toGrayscale(frame, converted);
+						sink = sink + Utils::FocusMeasure::tenengrad(converted, true);
+					});
+					result.roiBlurDifference = time([&]() {
+						toGrayscale(frame(roi), converted);
+						for (const auto & cell : cells) {
+							sink = sink + Utils::FocusMeasure::blurDifference(converted(cell), blurSize);
+						}
+					});
+					result.roiLaplacian = time([&]() {
+						toGrayscale(frame(roi), converted);
+						for (const auto & cell : cells) {
+							sink = sink + Utils::FocusMeasure::laplacianVariance(converted(cell), true);
+						}
+					});
+
+					ofLogNotice("Test::BenchmarkFocus") << result.resolution << " : "
+						<< "original " << result.original << "ms, "
+						<< "laplacian " << result.laplacianScalar << "ms scalar " << result.laplacianSimd << "ms SIMD, "
+						<< "tenengrad " << result.tenengradScalar << "ms scalar " << result.tenengradSimd << "ms SIMD, "
+						<< "ROI grid blur difference " << result.roiBlurDifference << "ms laplacian " << result.roiLaplacian << "ms";
+
+					results.push_back(result);
+				}
+
+				this->results = results;
+
+				scopedProcess.end();
+			}
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			///Times the focus measures on synthetic 5MP and 20MP frames : Test::Focus's original full frame
+			///measure (colour conversion, blur and absolute difference), the 3x3 measures with and without SIMD,
+			///and a centred ROI split into a grid as Test::Focus now measures by default
+			class BenchmarkFocus : public Benchmark {
+			public:
+				BenchmarkFocus();
+				string getTypeName() const override;
+				void init();
+
+				void populateInspector(ofxCvGui::InspectArguments &);
+
+				void runBenchmark() override;
+				void serializeResult(Json::Value &) const override;
+			protected:
+				struct : ofParameterGroup {
+					ofParameter<int> iterations{ "Iterations", 10, 1, 1000 };
+					ofParameter<int> blurSize{ "Blur size", 3, 1, 50 };
+					ofParameter<float> roiSize{ "ROI size", 0.25f, 0.01f, 1.0f }; // fraction of width and height
+					ofParameter<int> gridSize{ "Grid size", 3, 1, 8 };
+					ofParameter<bool> colour{ "Colour frames", true };
+					PARAM_DECLARE("BenchmarkFocus", iterations, blurSize, roiSize, gridSize, colour);
+				} parameters;
+
+				struct Result {
+					string resolution;
+					float original = 0.0f; // ms, all per frame
+					float laplacianScalar = 0.0f;
+					float laplacianSimd = 0.0f;
+					float tenengradScalar = 0.0f;
+					float tenengradSimd = 0.0f;
+					float roiBlurDifference = 0.0f;
+					float roiLaplacian = 0.0f;
+				};
+				vector<Result> results;
+			};
+		}
+	}
+}
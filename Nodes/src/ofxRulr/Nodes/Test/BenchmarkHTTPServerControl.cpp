@@ -0,0 +1,219 @@
+#include "pch_RulrNodes.h"
+#include "BenchmarkHTTPServerControl.h"
+
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+#pragma mark FrameTimes
+			//----------
+			void BenchmarkHTTPServerControl::FrameTimes::add(float frameTime) {
+				this->total += frameTime;
+				this->max = std::max(this->max, frameTime);
+				this->count++;
+			}
+
+			//----------
+			float BenchmarkHTTPServerControl::FrameTimes::mean() const {
+				return this->count > 0 ? this->total / (float) this->count : 0.0f;
+			}
+
+#pragma mark BenchmarkHTTPServerControl
+			//----------
+			BenchmarkHTTPServerControl::BenchmarkHTTPServerControl() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			BenchmarkHTTPServerControl::~BenchmarkHTTPServerControl() {
+				this->stop();
+			}
+
+			//----------
+			string BenchmarkHTTPServerControl::getTypeName() const {
+				return "Test::BenchmarkHTTPServerControl";
+			}
+
+			//----------
+			void BenchmarkHTTPServerControl::init() {
+				RULR_NODE_UPDATE_LISTENER;
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->manageParameters(this->parameters);
+			}
+
+			//----------
+			void BenchmarkHTTPServerControl::update() {
+				if (this->phase == Phase::Idle) {
+					return;
+				}
+
+				const auto frameTime = (float) ofGetLastFrameTime() * 1000.0f;
+				const auto elapsed = chrono::duration<float>(chrono::steady_clock::now() - this->phaseStart).count();
+
+				if (this->phase == Phase::Baseline) {
+					this->result.baseline.add(frameTime);
+					if (elapsed > this->parameters.duration) {
+						this->phase = Phase::Load;
+						this->phaseStart = chrono::steady_clock::now();
+
+						this->requestThreadsRunning = true;
+						for (int i = 0; i < this->parameters.threads; i++) {
+							this->requestThreads.emplace_back([this]() {
+								this->requestThreadLoop();
+							});
+						}
+					}
+				}
+				else if (this->phase == Phase::Load) {
+					this->result.load.add(frameTime);
+					if (elapsed > this->parameters.duration) {
+						this->stop();
+
+						{
+							lock_guard<mutex> lock(this->statisticsMutex);
+							this->result.requests = this->requests;
+							this->result.errors = this->errors;
+							this->result.requestsPerSecond = (float) this->requests / elapsed;
+							this->result.meanLatency = this->requests > 0 ? (float) (this->totalLatency / this->requests) : 0.0f;
+							this->result.maxLatency = this->maxLatency;
+						}
+
+						ofLogNotice("Test::BenchmarkHTTPServerControl") << this->result.requests << " requests ("
+							<< this->result.requestsPerSecond << " per second, " << this->result.errors << " errors), "
+							<< this->result.meanLatency << "ms mean latency, " << this->result.maxLatency << "ms max. "
+							<< "Frame time " << this->result.baseline.mean() << "ms mean " << this->result.baseline.max << "ms max without load, "
+							<< this->result.load.mean() << "ms mean " << this->result.load.max << "ms max with load";
+						this->notifyResult();
+					}
+				}
+			}
+
+			//----------
+			void BenchmarkHTTPServerControl::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				inspector->addLiveValue<string>("Phase", [this]() {
+					switch (this->phase) {
+					case Phase::Baseline:
+						return string("Measuring baseline");
+					case Phase::Load:
+						return string("Under load");
+					default:
+						return string("Idle");
+					}
+				});
+
+				inspector->addTitle("Result", ofxCvGui::Widgets::Title::Level::H3);
+				inspector->addLiveValue<string>("Requests (errors)", [this]() {
+					return ofToString(this->result.requests) + " (" + ofToString(this->result.errors) + ")";
+				});
+				inspector->addLiveValue<float>("Requests per second", [this]() {
+					return this->result.requestsPerSecond;
+				});
+				inspector->addLiveValue<string>("Mean / max latency [ms]", [this]() {
+					return ofToString(this->result.meanLatency) + " / " + ofToString(this->result.maxLatency);
+				});
+				inspector->addLiveValue<string>("Frame time without load, mean / max [ms]", [this]() {
+					return ofToString(this->result.baseline.mean()) + " / " + ofToString(this->result.baseline.max);
+				});
+				inspector->addLiveValue<string>("Frame time with load, mean / max [ms]", [this]() {
+					return ofToString(this->result.load.mean()) + " / " + ofToString(this->result.load.max);
+				});
+			}
+
+			//----------
+			void BenchmarkHTTPServerControl::runBenchmark() {
+				this->stop();
+
+				this->result = Result();
+				{
+					lock_guard<mutex> lock(this->statisticsMutex);
+					this->requests = 0;
+					this->errors = 0;
+					this->totalLatency = 0.0;
+					this->maxLatency = 0.0f;
+				}
+
+				this->phase = Phase::Baseline;
+				this->phaseStart = chrono::steady_clock::now();
+			}
+
+			//----------
+			void BenchmarkHTTPServerControl::serializeResult(Json::Value & json) const {
+				json["requests"] = (Json::UInt64) this->result.requests;
+				json["errors"] = (Json::UInt64) this->result.errors;
+				json["requestsPerSecond"] = this->result.requestsPerSecond;
+				json["meanLatency"] = this->result.meanLatency;
+				json["maxLatency"] = this->result.maxLatency;
+				json["baseline"]["meanFrameTime"] = this->result.baseline.mean();
+				json["baseline"]["maxFrameTime"] = this->result.baseline.max;
+				json["load"]["meanFrameTime"] = this->result.load.mean();
+				json["load"]["maxFrameTime"] = this->result.load.max;
+			}
+
+			//----------
+			bool BenchmarkHTTPServerControl::getRunsOverFrames() const {
+				return true;
+			}
+
+			//----------
+			void BenchmarkHTTPServerControl::stop() {
+				this->requestThreadsRunning = false;
+				for (auto & requestThread : this->requestThreads) {
+					requestThread.join();
+				}
+				this->requestThreads.clear();
+				this->phase = Phase::Idle;
+			}
+
+			//----------
+			void BenchmarkHTTPServerControl::requestThreadLoop() {
+				const auto host = this->parameters.host.get();
+				const auto port = (Poco::UInt16) this->parameters.port.get();
+				const auto path = this->parameters.path.get();
+
+				unique_ptr<Poco::Net::HTTPClientSession> session;
+				while (this->requestThreadsRunning) {
+					auto startTime = chrono::high_resolution_clock::now();
+					bool success = false;
+					try {
+						if (!session) {
+							session = make_unique<Poco::Net::HTTPClientSession>(host, port);
+							session->setKeepAlive(true);
+						}
+
+						Poco::Net::HTTPRequest request(Poco::Net::HTTPRequest::HTTP_GET, path, Poco::Net::HTTPMessage::HTTP_1_1);
+						request.setKeepAlive(true);
+						session->sendRequest(request);
+
+						Poco::Net::HTTPResponse response;
+						auto & stream = session->receiveResponse(response);
+						stream.ignore(numeric_limits<streamsize>::max());
+
+						success = response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK;
+					}
+					catch (...) {
+						//start again with a new connection
+						session.reset();
+					}
+					auto latency = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+
+					lock_guard<mutex> lock(this->statisticsMutex);
+					if (success) {
+						this->requests++;
+						this->totalLatency += latency;
+						this->maxLatency = max(this->maxLatency, latency);
+					}
+					else {
+						this->errors++;
+					}
+				}
+			}
+		}
+	}
+}
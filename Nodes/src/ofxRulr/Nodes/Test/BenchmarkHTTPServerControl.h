@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			///Load test for Application::HTTPServerControl. Measures the frame time for a few seconds, then keeps
+			///requesting a path from several threads (with keep-alive) and measures the frame time again whilst they run.
+			class BenchmarkHTTPServerControl : public Benchmark {
+			public:
+				BenchmarkHTTPServerControl();
+				virtual ~BenchmarkHTTPServerControl();
+				string getTypeName() const override;
+				void init();
+				void update();
+
+				void populateInspector(ofxCvGui::InspectArguments &);
+
+				void runBenchmark() override;
+				void serializeResult(Json::Value &) const override;
+				bool getRunsOverFrames() const override;
+				void stop();
+			protected:
+				void requestThreadLoop();
+
+				struct : ofParameterGroup {
+					ofParameter<string> host{ "Host", "localhost" };
+					ofParameter<int> port{ "Port", 8080, 1, 65535 };
+					ofParameter<string> path{ "Path", "/status" };
+					ofParameter<int> threads{ "Threads", 8, 1, 256 };
+					ofParameter<float> duration{ "Duration [s]", 10.0f, 1.0f, 600.0f }; // for each phase
+					PARAM_DECLARE("BenchmarkHTTPServerControl", host, port, path, threads, duration);
+				} parameters;
+
+				enum Phase {
+					Idle,
+					Baseline,
+					Load
+				};
+
+				struct FrameTimes {
+					void add(float);
+					float mean() const;
+					float max = 0.0f; // ms
+					float total = 0.0f;
+					size_t count = 0;
+				};
+
+				struct Result {
+					FrameTimes baseline;
+					FrameTimes load;
+					uint64_t requests = 0;
+					uint64_t errors = 0;
+					float requestsPerSecond = 0.0f;
+					float meanLatency = 0.0f; // ms
+					float maxLatency = 0.0f; // ms
+				};
+
+				Phase phase = Phase::Idle;
+				chrono::steady_clock::time_point phaseStart;
+				Result result;
+
+				vector<thread> requestThreads;
+				atomic<bool> requestThreadsRunning{ false };
+				mutex statisticsMutex;
+				uint64_t requests = 0;
+				uint64_t errors = 0;
+				double totalLatency = 0.0;
+				float maxLatency = 0.0f;
+			};
+		}
+	}
+}
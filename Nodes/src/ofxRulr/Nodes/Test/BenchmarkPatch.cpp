@@ -0,0 +1,227 @@
+#include "pch_RulrNodes.h"
+#include "BenchmarkPatch.h"
+
+#include "ofxRulr/Nodes/Item/RigidBody.h"
+#include "ofxRulr/Utils/ScopedProcess.h"
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			//----------
+			BenchmarkPatch::BenchmarkPatch() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			string BenchmarkPatch::getTypeName() const {
+				return "Test::BenchmarkPatch";
+			}
+
+			//----------
+			void BenchmarkPatch::init() {
+				RULR_NODE_UPDATE_LISTENER;
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->manageParameters(this->parameters);
+
+				this->patch = make_shared<Graph::Editor::Patch>();
+				this->patch->init();
+			}
+
+			//----------
+			void BenchmarkPatch::update() {
+				this->patch->update();
+
+				if (!this->running) {
+					return;
+				}
+
+				const auto & run = this->runs[this->runIndex];
+
+				//pan diagonally across the generated patch, wrapping at its edges
+				auto view = dynamic_pointer_cast<Graph::Editor::Patch::View>(this->patch->getPanel());
+				const auto panDistance = this->parameters.panSpeed * (float) this->runFrame;
+				view->setScrollPosition(ofVec2f(fmod(panDistance, this->patchSize.x), fmod(panDistance * 0.5f, this->patchSize.y)));
+
+				//skip the first frames of each run (e.g. the one which generated the patch)
+				const int warmupFrames = 5;
+				if (this->runFrame >= warmupFrames) {
+					const auto frameTime = (float) ofGetLastFrameTime() * 1000.0f;
+					this->totalFrameTime += frameTime;
+					this->maxFrameTime = max(this->maxFrameTime, frameTime);
+				}
+				this->runFrame++;
+
+				if (this->runFrame >= this->parameters.frames + warmupFrames) {
+					Result result;
+					result.nodeCount = run.nodeCount;
+					result.mode = run.mode;
+					result.meanFrameTime = this->totalFrameTime / (float) this->parameters.frames;
+					result.maxFrameTime = this->maxFrameTime;
+					this->results.push_back(result);
+
+					ofLogNotice("Test::BenchmarkPatch") << result.nodeCount << " nodes, " << getModeName(result.mode) << " : "
+						<< result.meanFrameTime << "ms mean, " << result.maxFrameTime << "ms max frame time";
+
+					this->runIndex++;
+					if (this->runIndex < this->runs.size()) {
+						this->beginRun();
+					}
+					else {
+						this->stop();
+						this->notifyResult();
+					}
+				}
+			}
+
+			//----------
+			ofxCvGui::PanelPtr BenchmarkPatch::getPanel() {
+				return this->patch->getPanel();
+			}
+
+			//----------
+			void BenchmarkPatch::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				inspector->addLiveValue<string>("Progress", [this]() {
+					if (this->running) {
+						return ofToString(this->runIndex + 1) + " / " + ofToString(this->runs.size());
+					}
+					else {
+						return string("Idle");
+					}
+				});
+
+				if (!this->results.empty()) {
+					inspector->addTitle("Frame time, mean / max [ms]", ofxCvGui::Widgets::Title::Level::H3);
+					for (const auto & result : this->results) {
+						inspector->addLiveValue<string>(ofToString(result.nodeCount) + " nodes, " + getModeName(result.mode), [result]() {
+							return ofToString(result.meanFrameTime) + " / " + ofToString(result.maxFrameTime);
+						});
+					}
+				}
+			}
+
+			//----------
+			void BenchmarkPatch::runBenchmark() {
+				this->stop();
+
+				vector<size_t> nodeCounts;
+				for (const auto & nodeCountString : ofSplitString(this->parameters.nodeCounts.get(), ",", true, true)) {
+					auto nodeCount = ofToInt(nodeCountString);
+					if (nodeCount > 0) {
+						nodeCounts.push_back((size_t) nodeCount);
+					}
+				}
+				if (nodeCounts.empty()) {
+					throw(ofxRulr::Exception("No node counts to benchmark"));
+				}
+
+				this->runs.clear();
+				for (auto nodeCount : nodeCounts) {
+					for (auto mode : { Mode::DrawAll, Mode::Cull, Mode::CullAndCollapse }) {
+						this->runs.push_back({ nodeCount, mode });
+					}
+				}
+
+				this->results.clear();
+				this->runIndex = 0;
+				this->running = true;
+				this->beginRun();
+				ofxCvGui::refreshInspector(this);
+			}
+
+			//----------
+			void BenchmarkPatch::serializeResult(Json::Value & json) const {
+				for (const auto & result : this->results) {
+					Json::Value jsonResult;
+					jsonResult["nodeCount"] = (Json::UInt64) result.nodeCount;
+					jsonResult["mode"] = getModeName(result.mode);
+					jsonResult["meanFrameTime"] = result.meanFrameTime;
+					jsonResult["maxFrameTime"] = result.maxFrameTime;
+					json["results"].append(jsonResult);
+				}
+			}
+
+			//----------
+			bool BenchmarkPatch::getRunsOverFrames() const {
+				return true;
+			}
+
+			//----------
+			void BenchmarkPatch::stop() {
+				this->running = false;
+				this->patch->setCullingEnabled(true);
+				this->patch->setCollapseWhilePanning(true);
+			}
+
+			//----------
+			void BenchmarkPatch::generate(size_t nodeCount) {
+				Utils::ScopedProcess scopedProcess("Generating patch with " + ofToString(nodeCount) + " nodes", false);
+
+				this->patch->clear();
+
+				const auto columns = (size_t) ceil(sqrt((float) nodeCount));
+				const auto spacing = ofVec2f(400, 250);
+				const auto nodeSize = ofVec2f(220, 150);
+
+				//connect the pins before adding the nodes, so the links are built once at the end
+				vector<pair<shared_ptr<Item::RigidBody>, ofRectangle>> nodes;
+				shared_ptr<Item::RigidBody> previous;
+				for (size_t i = 0; i < nodeCount; i++) {
+					const auto column = i % columns;
+					const auto row = i / columns;
+
+					auto node = make_shared<Item::RigidBody>();
+					node->init();
+					node->setName("Body " + ofToString(i));
+					if (column > 0) {
+						node->setParent(previous);
+					}
+					previous = node;
+
+					nodes.emplace_back(node, ofRectangle(spacing * ofVec2f(column, row), nodeSize.x, nodeSize.y));
+				}
+
+				for (const auto & node : nodes) {
+					this->patch->addNode(node.first, node.second);
+				}
+				this->patch->rebuildLinkHosts();
+
+				const auto rows = (nodeCount + columns - 1) / columns;
+				this->patchSize = spacing * ofVec2f(columns, rows);
+
+				scopedProcess.end();
+			}
+
+			//----------
+			void BenchmarkPatch::beginRun() {
+				const auto & run = this->runs[this->runIndex];
+				if (this->runIndex == 0 || this->runs[this->runIndex - 1].nodeCount != run.nodeCount) {
+					this->generate(run.nodeCount);
+				}
+
+				this->patch->setCullingEnabled(run.mode != Mode::DrawAll);
+				this->patch->setCollapseWhilePanning(run.mode == Mode::CullAndCollapse);
+
+				this->runFrame = 0;
+				this->totalFrameTime = 0.0f;
+				this->maxFrameTime = 0.0f;
+			}
+
+			//----------
+			string BenchmarkPatch::getModeName(Mode mode) {
+				switch (mode) {
+				case Mode::Cull:
+					return "Cull";
+				case Mode::CullAndCollapse:
+					return "Cull and collapse";
+				case Mode::DrawAll:
+				default:
+					return "Draw all";
+				}
+			}
+		}
+	}
+}
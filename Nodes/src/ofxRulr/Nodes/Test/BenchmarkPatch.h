@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "ofxRulr/Graph/Editor/Patch.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			///Generates synthetic patches (a grid of rigid bodies chained along each row) and pans across them,
+			///recording the frame time with everything drawn, with offscreen items culled, and with nodes also collapsed
+			///whilst panning. The generated patch is this node's view, so keep the view on screen (e.g. maximised) whilst it runs.
+			class BenchmarkPatch : public Benchmark {
+			public:
+				BenchmarkPatch();
+				string getTypeName() const override;
+				void init();
+				void update();
+				ofxCvGui::PanelPtr getPanel() override;
+
+				void populateInspector(ofxCvGui::InspectArguments &);
+
+				void runBenchmark() override;
+				void serializeResult(Json::Value &) const override;
+				bool getRunsOverFrames() const override;
+				void stop();
+				void generate(size_t nodeCount);
+			protected:
+				struct : ofParameterGroup {
+					ofParameter<string> nodeCounts{ "Node counts", "100, 500, 2000" };
+					ofParameter<int> frames{ "Frames", 120, 10, 10000 }; // per run
+					ofParameter<float> panSpeed{ "Pan speed [px/frame]", 40.0f, 1.0f, 1000.0f };
+					PARAM_DECLARE("BenchmarkPatch", nodeCounts, frames, panSpeed);
+				} parameters;
+
+				enum Mode {
+					DrawAll,
+					Cull,
+					CullAndCollapse
+				};
+				static string getModeName(Mode);
+
+				struct Run {
+					size_t nodeCount;
+					Mode mode;
+				};
+
+				struct Result {
+					size_t nodeCount = 0;
+					Mode mode = Mode::DrawAll;
+					float meanFrameTime = 0.0f; // ms
+					float maxFrameTime = 0.0f; // ms
+				};
+
+				void beginRun();
+
+				shared_ptr<Graph::Editor::Patch> patch;
+				ofVec2f patchSize;
+
+				vector<Run> runs;
+				size_t runIndex = 0;
+				int runFrame = 0;
+				float totalFrameTime = 0.0f;
+				float maxFrameTime = 0.0f;
+				bool running = false;
+
+				vector<Result> results;
+			};
+		}
+	}
+}
@@ -0,0 +1,184 @@
+#include "pch_RulrNodes.h"
+#include "BenchmarkRigidBody.h"
+
+#include "ofxRulr/Nodes/Item/RigidBody.h"
+#include "ofxRulr/Utils/ScopedProcess.h"
+
+#include <random>
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			//----------
+			BenchmarkRigidBody::BenchmarkRigidBody() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			string BenchmarkRigidBody::getTypeName() const {
+				return "Test::BenchmarkRigidBody";
+			}
+
+			//----------
+			void BenchmarkRigidBody::init() {
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->manageParameters(this->parameters);
+			}
+
+			//----------
+			void BenchmarkRigidBody::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				if (this->hasResult) {
+					inspector->addTitle("Per frame", ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<string>("Rebuilt / cached [ms]", [this]() {
+						return ofToString(this->result.rebuilt) + " / " + ofToString(this->result.cached);
+					});
+					inspector->addLiveValue<string>("Chained rebuilt / cached [ms]", [this]() {
+						return ofToString(this->result.chainRebuilt) + " / " + ofToString(this->result.chainCached);
+					});
+					inspector->addLiveValue<float>("Cached across threads [ms]", [this]() {
+						return this->result.cachedThreaded;
+					});
+				}
+			}
+
+			//----------
+			void BenchmarkRigidBody::serializeResult(Json::Value & json) const {
+				json["rebuilt"] = this->result.rebuilt;
+				json["cached"] = this->result.cached;
+				json["chainRebuilt"] = this->result.chainRebuilt;
+				json["chainCached"] = this->result.chainCached;
+				json["cachedThreaded"] = this->result.cachedThreaded;
+			}
+
+			//----------
+			void BenchmarkRigidBody::runBenchmark() {
+				typedef chrono::high_resolution_clock Clock;
+
+				const auto frames = this->parameters.frames.get();
+				const auto bodyCount = (size_t) this->parameters.bodyCount.get();
+				const auto queriesPerFrame = this->parameters.queriesPerFrame.get();
+				const auto movingBodies = min((size_t) this->parameters.movingBodies.get(), bodyCount);
+				const auto chainLength = (size_t) this->parameters.chainLength.get();
+				const auto threadCount = (size_t) this->parameters.threads.get();
+
+				Utils::ScopedProcess scopedProcess("Benchmark rigid body", false);
+
+				mt19937 randomEngine(0);
+				uniform_real_distribution<float> positionDistribution(-5.0f, 5.0f);
+				uniform_real_distribution<float> angleDistribution(-180.0f, 180.0f);
+
+				auto makeBodies = [&]() {
+					vector<shared_ptr<Item::RigidBody>> bodies;
+					for (size_t i = 0; i < bodyCount; i++) {
+						auto body = make_shared<Item::RigidBody>();
+						body->init();
+						body->setPosition(ofVec3f(positionDistribution(randomEngine), positionDistribution(randomEngine), positionDistribution(randomEngine)));
+						body->setRotationEuler(ofVec3f(angleDistribution(randomEngine), angleDistribution(randomEngine), angleDistribution(randomEngine)));
+						bodies.push_back(body);
+					}
+					return bodies;
+				};
+
+				//the same bodies move each frame in every test
+				auto moveBodies = [&](vector<shared_ptr<Item::RigidBody>> & bodies, int frame) {
+					for (size_t i = 0; i < movingBodies; i++) {
+						bodies[(i * 7919 + frame) % bodyCount]->setPosition(ofVec3f(frame * 0.01f, i * 0.01f, 0.0f));
+					}
+				};
+
+				//ms per frame
+				auto time = [&](vector<shared_ptr<Item::RigidBody>> & bodies, const function<void()> & query) {
+					auto startTime = Clock::now();
+					for (int frame = 0; frame < frames; frame++) {
+						moveBodies(bodies, frame);
+						query();
+					}
+					return chrono::duration<float, milli>(Clock::now() - startTime).count() / frames;
+				};
+
+				//what the world transform would cost without the cache
+				function<ofMatrix4x4(const Item::RigidBody &)> getRebuiltTransform = [&](const Item::RigidBody & body) {
+					auto parent = body.getParent();
+					return parent
+						? body.getLocalTransform() * getRebuiltTransform(*parent)
+						: body.getLocalTransform();
+				};
+
+				volatile float sink = 0.0f; // keep the queries from being optimised away
+				Result result;
+
+				{
+					auto bodies = makeBodies();
+					result.rebuilt = time(bodies, [&]() {
+						for (int query = 0; query < queriesPerFrame; query++) {
+							for (const auto & body : bodies) {
+								sink = sink + body->getLocalTransform()(3, 0);
+							}
+						}
+					});
+					result.cached = time(bodies, [&]() {
+						for (int query = 0; query < queriesPerFrame; query++) {
+							for (const auto & body : bodies) {
+								sink = sink + body->getTransform()(3, 0);
+							}
+						}
+					});
+					result.cachedThreaded = time(bodies, [&]() {
+						vector<thread> threads;
+						for (size_t threadIndex = 0; threadIndex < threadCount; threadIndex++) {
+							threads.emplace_back([&, threadIndex]() {
+								float threadSink = 0.0f;
+								for (int query = (int) threadIndex; query < queriesPerFrame; query += (int) threadCount) {
+									for (const auto & body : bodies) {
+										threadSink += body->getTransform()(3, 0);
+									}
+								}
+								sink = sink + threadSink;
+							});
+						}
+						for (auto & workerThread : threads) {
+							workerThread.join();
+						}
+					});
+				}
+
+				{
+					auto bodies = makeBodies();
+					for (size_t i = 0; i < bodyCount; i++) {
+						if (i % chainLength != 0) {
+							bodies[i]->setParent(bodies[i - 1]);
+						}
+					}
+					result.chainRebuilt = time(bodies, [&]() {
+						for (int query = 0; query < queriesPerFrame; query++) {
+							for (const auto & body : bodies) {
+								sink = sink + getRebuiltTransform(*body)(3, 0);
+							}
+						}
+					});
+					result.chainCached = time(bodies, [&]() {
+						for (int query = 0; query < queriesPerFrame; query++) {
+							for (const auto & body : bodies) {
+								sink = sink + body->getTransform()(3, 0);
+							}
+						}
+					});
+				}
+
+				ofLogNotice("Test::BenchmarkRigidBody") << bodyCount << " bodies x " << queriesPerFrame << " queries per frame : "
+					<< "rebuilt " << result.rebuilt << "ms, "
+					<< "cached " << result.cached << "ms, "
+					<< "chained rebuilt " << result.chainRebuilt << "ms cached " << result.chainCached << "ms, "
+					<< "cached across " << threadCount << " threads " << result.cachedThreaded << "ms";
+
+				this->result = result;
+
+				scopedProcess.end();
+			}
+		}
+	}
+}
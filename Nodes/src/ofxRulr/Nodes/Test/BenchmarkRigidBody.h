@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			///Times RigidBody transform queries over a set of bodies, moving a few of them each frame :
+			///the transform rebuilt from the parameters on every call (as getTransform used to), the cached
+			///transform, the same with the bodies chained to parents, and the cached transform read from several threads
+			class BenchmarkRigidBody : public Benchmark {
+			public:
+				BenchmarkRigidBody();
+				string getTypeName() const override;
+				void init();
+
+				void populateInspector(ofxCvGui::InspectArguments &);
+
+				void runBenchmark() override;
+				void serializeResult(Json::Value &) const override;
+			protected:
+				struct : ofParameterGroup {
+					ofParameter<int> frames{ "Frames", 10, 1, 1000 };
+					ofParameter<int> bodyCount{ "Body count", 1000, 1, 100000 };
+					ofParameter<int> queriesPerFrame{ "Queries per frame", 100, 1, 1000 }; // per body
+					ofParameter<int> movingBodies{ "Moving bodies", 10, 0, 100000 }; // per frame
+					ofParameter<int> chainLength{ "Chain length", 4, 1, 100 };
+					ofParameter<int> threads{ "Threads", 4, 1, 64 };
+					PARAM_DECLARE("BenchmarkRigidBody", frames, bodyCount, queriesPerFrame, movingBodies, chainLength, threads);
+				} parameters;
+
+				struct Result {
+					float rebuilt = 0.0f; // ms, all per frame
+					float cached = 0.0f;
+					float chainRebuilt = 0.0f;
+					float chainCached = 0.0f;
+					float cachedThreaded = 0.0f;
+				} result;
+			};
+		}
+	}
+}
@@ -0,0 +1,195 @@
+#include "pch_RulrNodes.h"
+#include "BenchmarkWorldBatch.h"
+
+#include "ofxRulr/Utils/WorldBatch.h"
+
+#include <random>
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			//----------
+			BenchmarkWorldBatch::BenchmarkWorldBatch() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			string BenchmarkWorldBatch::getTypeName() const {
+				return "Test::BenchmarkWorldBatch";
+			}
+
+			//----------
+			void BenchmarkWorldBatch::init() {
+				RULR_NODE_UPDATE_LISTENER;
+				RULR_NODE_DRAW_WORLD_LISTENER;
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->manageParameters(this->parameters);
+			}
+
+			//----------
+			void BenchmarkWorldBatch::update() {
+				if (!this->running) {
+					return;
+				}
+
+				//skip the first frames of each mode
+				const int warmupFrames = 5;
+				if (this->frame >= warmupFrames) {
+					this->totalFrameTime += (float) ofGetLastFrameTime() * 1000.0f;
+				}
+				this->frame++;
+
+				if (this->frame >= this->parameters.frames + warmupFrames) {
+					auto & result = this->useBatch ? this->batched : this->immediate;
+					result.frameTime = this->totalFrameTime / (float) this->parameters.frames;
+					result.submitTime = this->totalSubmitTime / (float) this->frame;
+					result.drawCalls = this->drawCalls;
+
+					ofLogNotice("Test::BenchmarkWorldBatch") << (this->useBatch ? "Batched : " : "Immediate : ")
+						<< result.frameTime << "ms frame time, " << result.submitTime << "ms submitting, "
+						<< result.drawCalls << " draw calls";
+
+					this->frame = 0;
+					this->totalFrameTime = 0.0f;
+					this->totalSubmitTime = 0.0f;
+					if (this->useBatch) {
+						this->running = false;
+						this->notifyResult();
+					}
+					else {
+						this->useBatch = true;
+					}
+				}
+			}
+
+			//----------
+			void BenchmarkWorldBatch::drawWorldStage() {
+				if (!this->running) {
+					return;
+				}
+
+				auto startTime = chrono::high_resolution_clock::now();
+				if (this->useBatch) {
+					//use a batch of our own, so that its draw calls can be counted
+					Utils::WorldBatch batch;
+					batch.begin();
+					{
+						for (size_t i = 0; i < this->scene.spherePositions.size(); i++) {
+							batch.addSphere(this->scene.spherePositions[i], 0.02f, this->scene.sphereColors[i]);
+						}
+						batch.addPoints(this->scene.points, this->scene.pointColors);
+						for (size_t i = 0; i < this->scene.lineColors.size(); i++) {
+							batch.addLine(this->scene.lineVertices[i * 2], this->scene.lineVertices[i * 2 + 1], this->scene.lineColors[i]);
+						}
+					}
+					batch.end();
+					this->drawCalls = batch.getLastStatistics().drawCalls;
+				}
+				else {
+					//one call per primitive, with the points in a mesh built each frame
+					ofPushStyle();
+					{
+						for (size_t i = 0; i < this->scene.spherePositions.size(); i++) {
+							ofSetColor(this->scene.sphereColors[i]);
+							ofDrawSphere(this->scene.spherePositions[i], 0.02f);
+						}
+
+						ofMesh points;
+						points.addVertices(this->scene.points);
+						points.addColors(this->scene.pointColors);
+						Utils::Graphics::pushPointSize(5.0f);
+						{
+							points.drawVertices();
+						}
+						Utils::Graphics::popPointSize();
+
+						for (size_t i = 0; i < this->scene.lineColors.size(); i++) {
+							ofSetColor(this->scene.lineColors[i]);
+							ofDrawLine(this->scene.lineVertices[i * 2], this->scene.lineVertices[i * 2 + 1]);
+						}
+					}
+					ofPopStyle();
+					this->drawCalls = this->scene.spherePositions.size() + 1 + this->scene.lineColors.size();
+				}
+				this->totalSubmitTime += chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+			}
+
+			//----------
+			void BenchmarkWorldBatch::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				inspector->add(new Widgets::Indicator("Running", [this]() {
+					return (Widgets::Indicator::Status) this->running;
+				}));
+
+				inspector->addTitle("Frame time / submit time [ms], draw calls", ofxCvGui::Widgets::Title::Level::H3);
+				inspector->addLiveValue<string>("Immediate", [this]() {
+					return ofToString(this->immediate.frameTime) + " / " + ofToString(this->immediate.submitTime) + ", " + ofToString(this->immediate.drawCalls);
+				});
+				inspector->addLiveValue<string>("Batched", [this]() {
+					return ofToString(this->batched.frameTime) + " / " + ofToString(this->batched.submitTime) + ", " + ofToString(this->batched.drawCalls);
+				});
+			}
+
+			//----------
+			void BenchmarkWorldBatch::runBenchmark() {
+				this->buildScene();
+
+				this->immediate = Result();
+				this->batched = Result();
+				this->useBatch = false;
+				this->frame = 0;
+				this->totalFrameTime = 0.0f;
+				this->totalSubmitTime = 0.0f;
+				this->running = true;
+			}
+
+			//----------
+			void BenchmarkWorldBatch::serializeResult(Json::Value & json) const {
+				auto serializeModeResult = [](Json::Value & json, const Result & result) {
+					json["frameTime"] = result.frameTime;
+					json["submitTime"] = result.submitTime;
+					json["drawCalls"] = (Json::UInt64) result.drawCalls;
+				};
+				serializeModeResult(json["immediate"], this->immediate);
+				serializeModeResult(json["batched"], this->batched);
+			}
+
+			//----------
+			bool BenchmarkWorldBatch::getRunsOverFrames() const {
+				return true;
+			}
+
+			//----------
+			void BenchmarkWorldBatch::buildScene() {
+				mt19937 randomEngine(0);
+				uniform_real_distribution<float> positionDistribution(-2.0f, 2.0f);
+				uniform_real_distribution<float> colorDistribution(0.0f, 1.0f);
+				auto randomPosition = [&]() {
+					return ofVec3f(positionDistribution(randomEngine), positionDistribution(randomEngine) - 2.0f, positionDistribution(randomEngine) + 3.0f);
+				};
+				auto randomColor = [&]() {
+					return ofFloatColor(colorDistribution(randomEngine), colorDistribution(randomEngine), colorDistribution(randomEngine));
+				};
+
+				this->scene = Scene();
+				for (int i = 0; i < this->parameters.spheres; i++) {
+					this->scene.spherePositions.push_back(randomPosition());
+					this->scene.sphereColors.push_back(randomColor());
+				}
+				for (int i = 0; i < this->parameters.points; i++) {
+					this->scene.points.push_back(randomPosition());
+					this->scene.pointColors.push_back(randomColor());
+				}
+				for (int i = 0; i < this->parameters.lines; i++) {
+					auto start = randomPosition();
+					this->scene.lineVertices.push_back(start);
+					this->scene.lineVertices.push_back(start + (randomPosition() - start) * 0.05f);
+					this->scene.lineColors.push_back(randomColor());
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Test {
+			///Draws a scene of random spheres, points and lines on the WorldStage, first one call per primitive
+			///(as nodes used to) and then through Utils::WorldBatch, and reports the frame time, the time spent
+			///submitting the primitives and the number of draw calls for each. Keep the WorldStage visible whilst it runs.
+			class BenchmarkWorldBatch : public Benchmark {
+			public:
+				BenchmarkWorldBatch();
+				string getTypeName() const override;
+				void init();
+				void update();
+				void drawWorldStage();
+
+				void populateInspector(ofxCvGui::InspectArguments &);
+
+				void runBenchmark() override;
+				void serializeResult(Json::Value &) const override;
+				bool getRunsOverFrames() const override;
+			protected:
+				void buildScene();
+
+				struct : ofParameterGroup {
+					ofParameter<int> spheres{ "Spheres", 1000, 0, 100000 };
+					ofParameter<int> points{ "Points", 10000, 0, 1000000 };
+					ofParameter<int> lines{ "Lines", 5000, 0, 1000000 };
+					ofParameter<int> frames{ "Frames", 120, 10, 10000 }; // per mode
+					PARAM_DECLARE("BenchmarkWorldBatch", spheres, points, lines, frames);
+				} parameters;
+
+				struct Scene {
+					vector<ofVec3f> spherePositions;
+					vector<ofFloatColor> sphereColors;
+					vector<ofVec3f> points;
+					vector<ofFloatColor> pointColors;
+					vector<ofVec3f> lineVertices; // pairs
+					vector<ofFloatColor> lineColors;
+				} scene;
+
+				struct Result {
+					float frameTime = 0.0f; // ms, mean
+					float submitTime = 0.0f; // ms, mean
+					size_t drawCalls = 0; // per frame
+				};
+
+				Result immediate;
+				Result batched;
+
+				bool running = false;
+				bool useBatch = false;
+				int frame = 0;
+				float totalFrameTime = 0.0f;
+				float totalSubmitTime = 0.0f;
+				size_t drawCalls = 0;
+			};
+		}
+	}
+}
@@ -4,6 +4,7 @@
 #include "ofxRulr/Nodes/Item/Camera.h"
 
 #include "ofxRulr/Utils/SoundEngine.h"
+#include "ofxRulr/Utils/FocusMeasure.h"
 
 #include "ofxCvMin.h"
 #include "ofxCvGui/Panels/ElementHost.h"
@@ -28,6 +29,11 @@ namespace ofxRulr {
 				RULR_NODE_INIT_LISTENER;
 				ofxRulr::Utils::SoundEngine::X();
 			}
+
+			//----------
+			Focus::~Focus() {
+				this->stopProcessThread();
+			}
 			
 			//----------
 			string Focus::getTypeName() const {
@@ -71,6 +77,35 @@ namespace ofxRulr {
 							ofxCvGui::Utils::drawText("Select this node and connect active camera.", args.localBounds);
 						}
 					};
+					view->onDrawImage += [this](DrawImageArguments & args) {
+						lock_guard<mutex> lock(this->resultMutex);
+						if (!this->result.active) {
+							return;
+						}
+
+						ofPushStyle();
+						{
+							ofNoFill();
+							ofSetColor(255);
+							ofDrawRectangle(this->result.roi);
+
+							for (size_t i = 0; i < this->result.cells.size(); i++) {
+								const auto & cell = this->result.cells[i];
+								const auto & value = this->result.cellValues[i];
+								const auto & peak = this->result.cellPeaks[i];
+
+								//green when the cell is at its peak
+								auto ratio = peak > 0.0 ? ofClamp(value / peak, 0.0, 1.0) : 0.0;
+								ofSetColor(ofColor(255, 0, 0).getLerped(ofColor(0, 255, 0), ratio));
+								ofDrawRectangle(cell);
+
+								stringstream text;
+								text << ofToString(value, 4) << endl << "peak " << ofToString(peak, 4);
+								ofDrawBitmapStringHighlight(text.str(), cell.x + 5, cell.y + 15);
+							}
+						}
+						ofPopStyle();
+					};
 					view->onBoundsChange += [this](BoundsChangeArguments & args) {
 						auto bounds = args.localBounds;
 						bounds.x = 10;
@@ -92,9 +127,21 @@ namespace ofxRulr {
 				this->blurSize.set("Blur size", 3, 1, 50);
 				this->highValue.set("High value", 0.01, 0, 1);
 				this->lowValue.set("Low value", 0.0, 0, 1);
+
+				this->metric.set("Metric", Utils::FocusMeasure::Metric::BlurDifference, 0, 2);
+				this->roiX.set("ROI x", 0.0f, 0.0f, 1.0f);
+				this->roiY.set("ROI y", 0.0f, 0.0f, 1.0f);
+				this->roiWidth.set("ROI width", 1.0f, 0.0f, 1.0f);
+				this->roiHeight.set("ROI height", 1.0f, 0.0f, 1.0f);
+				this->gridColumns.set("Grid columns", 1, 1, 8);
+				this->gridRows.set("Grid rows", 1, 1, 8);
+				this->showPreview.set("Show preview", true);
+				this->peakHold.set("Peak hold", false);
 				
 				this->updateProcessSettings();
 				Utils::SoundEngine::X().addSource(static_pointer_cast<Focus>(this->shared_from_this()));
+
+				this->startProcessThread();
 			}
 			
 			//----------
@@ -105,9 +152,6 @@ namespace ofxRulr {
 					lock_guard<mutex> lock(this->resultMutex);
 					if(this->getRunFinderEnabled()) {
 						if(this->result.isFrameNew) {
-							this->result.highFrequency.update();
-							this->result.lowFrequency.update();
-							
 							if(this->preview.getWidth() != this->result.width || this->preview.getHeight() != this->result.height) {
 								this->preview.allocate(this->result.width, this->result.height, GL_RGBA);
 							}
@@ -117,14 +161,20 @@ namespace ofxRulr {
 							//--
 							//
 							this->preview.begin();
-							auto & shader = ofxAssets::shader("ofxRulr::focusFinder");
-							shader.begin();
-							shader.setUniformTexture("highFrequency", this->result.highFrequency, 0);
-							shader.setUniformTexture("lowFrequency", this->result.lowFrequency, 1);
-							
-							this->result.highFrequency.draw(0, 0); //draw something with texture coordinates (goes into first texture slow)
-							
-							shader.end();
+							ofClear(0, 0);
+							if (this->showPreview && this->result.highFrequency.isAllocated()) {
+								this->result.highFrequency.update();
+								this->result.lowFrequency.update();
+
+								auto & shader = ofxAssets::shader("ofxRulr::focusFinder");
+								shader.begin();
+								shader.setUniformTexture("highFrequency", this->result.highFrequency, 0);
+								shader.setUniformTexture("lowFrequency", this->result.lowFrequency, 1);
+
+								this->result.highFrequency.draw(this->result.roi.x, this->result.roi.y); //draw something with texture coordinates (goes into first texture slow)
+
+								shader.end();
+							}
 							this->preview.end();
 							//
 							//--
@@ -132,7 +182,12 @@ namespace ofxRulr {
 							this->result.isFrameNew = false;
 							
 							this->result.active = true;
-							this->result.valueNormalised = ofMap(this->result.value, this->lowValue, this->highValue, 0.0f, 1.0f);
+							if (this->peakHold) {
+								this->result.valueNormalised = this->result.peak > 0.0 ? this->result.value / this->result.peak : 0.0f;
+							}
+							else {
+								this->result.valueNormalised = ofMap(this->result.value, this->lowValue, this->highValue, 0.0f, 1.0f);
+							}
 						}
 					} else {
 						this->result.active = false;
@@ -151,10 +206,49 @@ namespace ofxRulr {
 					activeWhenWidget->entangle(this->activewhen);
 				}
 				
+				auto metricWidget = inspector->add(new Widgets::MultipleChoice("Metric"));
+				{
+					metricWidget->addOption("Blur difference");
+					metricWidget->addOption("Laplacian variance");
+					metricWidget->addOption("Tenengrad");
+					metricWidget->entangle(this->metric);
+				}
+
 				inspector->add(new Widgets::EditableValue<int>(this->blurSize));
 				
 				inspector->addSlider(this->highValue);
 				inspector->addSlider(this->lowValue);
+
+				inspector->add(new Widgets::Title("Region", Widgets::Title::Level::H3));
+				inspector->addSlider(this->roiX);
+				inspector->addSlider(this->roiY);
+				inspector->addSlider(this->roiWidth);
+				inspector->addSlider(this->roiHeight);
+				inspector->add(new Widgets::EditableValue<int>(this->gridColumns));
+				inspector->add(new Widgets::EditableValue<int>(this->gridRows));
+				inspector->addToggle(this->showPreview);
+
+				inspector->add(new Widgets::Title("Peak", Widgets::Title::Level::H3));
+				inspector->addToggle(this->peakHold);
+				inspector->addButton("Reset peak", [this]() {
+					this->resetPeak();
+				});
+				inspector->addLiveValueHistory("Value", [this]() {
+					lock_guard<mutex> lock(this->resultMutex);
+					return (float) this->result.value;
+				});
+				inspector->addLiveValueHistory("Peak", [this]() {
+					lock_guard<mutex> lock(this->resultMutex);
+					return (float) this->result.peak;
+				});
+				inspector->addLiveValueHistory("Compute time [ms]", [this]() {
+					lock_guard<mutex> lock(this->resultMutex);
+					return this->result.computeTime;
+				});
+				inspector->addLiveValue<size_t>("Dropped frames", [this]() {
+					lock_guard<mutex> lock(this->pendingFrameMutex);
+					return this->droppedFrames;
+				});
 			}
 			
 			//----------
@@ -163,6 +257,15 @@ namespace ofxRulr {
 				Utils::Serializable::serialize(json, this->blurSize);
 				Utils::Serializable::serialize(json, this->highValue);
 				Utils::Serializable::serialize(json, this->lowValue);
+				Utils::Serializable::serialize(json, this->metric);
+				Utils::Serializable::serialize(json, this->roiX);
+				Utils::Serializable::serialize(json, this->roiY);
+				Utils::Serializable::serialize(json, this->roiWidth);
+				Utils::Serializable::serialize(json, this->roiHeight);
+				Utils::Serializable::serialize(json, this->gridColumns);
+				Utils::Serializable::serialize(json, this->gridRows);
+				Utils::Serializable::serialize(json, this->showPreview);
+				Utils::Serializable::serialize(json, this->peakHold);
 			}
 			
 			//----------
@@ -171,6 +274,15 @@ namespace ofxRulr {
 				Utils::Serializable::deserialize(json, this->blurSize);
 				Utils::Serializable::deserialize(json, this->highValue);
 				Utils::Serializable::deserialize(json, this->lowValue);
+				Utils::Serializable::deserialize(json, this->metric);
+				Utils::Serializable::deserialize(json, this->roiX);
+				Utils::Serializable::deserialize(json, this->roiY);
+				Utils::Serializable::deserialize(json, this->roiWidth);
+				Utils::Serializable::deserialize(json, this->roiHeight);
+				Utils::Serializable::deserialize(json, this->gridColumns);
+				Utils::Serializable::deserialize(json, this->gridRows);
+				Utils::Serializable::deserialize(json, this->showPreview);
+				Utils::Serializable::deserialize(json, this->peakHold);
 			}
 			
 			//----------
@@ -261,17 +373,26 @@ namespace ofxRulr {
 				}
 			}
 			
+			//----------
+			void Focus::resetPeak() {
+				lock_guard<mutex> lock(this->resultMutex);
+				this->result.peak = 0.0;
+				for (auto & cellPeak : this->result.cellPeaks) {
+					cellPeak = 0.0;
+				}
+			}
+
 			//----------
 			void Focus::connect(shared_ptr<ofxMachineVision::Grabber::Simple> grabber) {
 				if(grabber) {
 					grabber->onNewFrameReceived.addListener([this](shared_ptr<ofxMachineVision::Frame> & frame) {
-						this->calculateFocus(frame);
+						this->receiveFrame(frame);
 					}, this);
 					
 					//also perform on existing frame if any
 					auto frame = grabber->getFrame();
 					if(frame) {
-						this->calculateFocus(frame);
+						this->receiveFrame(frame);
 					}
 				}
 			}
@@ -283,6 +404,18 @@ namespace ofxRulr {
 				}
 			}
 			
+			//----------
+			void Focus::receiveFrame(shared_ptr<ofxMachineVision::Frame> frame) {
+				{
+					lock_guard<mutex> lock(this->pendingFrameMutex);
+					if (this->pendingFrame) {
+						this->droppedFrames++;
+					}
+					this->pendingFrame = frame;
+				}
+				this->pendingFrameCondition.notify_one();
+			}
+
 			//----------
 			void Focus::calculateFocus(shared_ptr<ofxMachineVision::Frame> frame) {
 				if(frame) {
@@ -292,62 +425,98 @@ namespace ofxRulr {
 						this->processSettingsMutex.unlock();
 						
 						if(processSettings.enabled) {
+							auto startTime = chrono::high_resolution_clock::now();
+
 							auto & input = frame->getPixels();
-							auto width = frame->getPixels().getWidth();
-							auto height = frame->getPixels().getHeight();
+							auto width = (int) input.getWidth();
+							auto height = (int) input.getHeight();
 							
 							//--
-							//0. Make grayscale
+							//0. Take the ROI and make it grayscale
 							//--
 							//
-							//check if we need to make a grayscale version
-							auto needsGrayscaleConversion = input.getNumChannels() == 3;
-							
-							//reallocate if we need to
-							if(this->process.width != width || this->process.height != height) {
-							 //we reallocate grayscale regardless of if we're going to use it this frame incase the next frame is same dimensions but with a different number of channels
-								this->process.grayscale.allocate(width, height, 1);
-								this->process.blurred.allocate(width, height, 1);
-								this->process.edges.allocate(width, height, 1);
-								
-								this->process.width = width;
-								this->process.height = height;
+							auto roi = cv::Rect(processSettings.roi.x * width
+								, processSettings.roi.y * height
+								, processSettings.roi.width * width
+								, processSettings.roi.height * height) & cv::Rect(0, 0, width, height);
+							if (roi.width < 3 || roi.height < 3) {
+								throw(Exception("ROI is too small"));
 							}
-							
-							//convert if we need to
-							if(needsGrayscaleConversion) {
-								cv::cvtColor(toCv(input), toCv(this->process.grayscale), CV_RGB2GRAY);
+
+							//grayscale input is measured in place, the frame is held until we're done
+							auto inputRoi = toCv(input)(roi);
+							cv::Mat grayscale;
+							switch (input.getNumChannels()) {
+							case 1:
+								grayscale = inputRoi;
+								break;
+							case 3:
+								cv::cvtColor(inputRoi, this->process.grayscale, CV_RGB2GRAY);
+								grayscale = this->process.grayscale;
+								break;
+							case 4:
+								cv::cvtColor(inputRoi, this->process.grayscale, CV_RGBA2GRAY);
+								grayscale = this->process.grayscale;
+								break;
+							default:
+								throw(Exception("Unsupported number of channels"));
 							}
-							
-							auto & grayscale = needsGrayscaleConversion ? this->process.grayscale : input;
 							//
 							//--
-							
-							
-							//1. Blur
-							cv::blur(toCv(grayscale), toCv(this->process.blurred), cv::Size(processSettings.blurSize, processSettings.blurSize));
-							
-							//2. Take absolute difference between original and blurred
-							cv::absdiff(toCv(grayscale), toCv(this->process.blurred), toCv(this->process.edges));
-							
-							//3. Sum all the pixels in the absolute difference image
-							auto total = cv::sum(toCv(this->process.edges))[0];
-							
-							//4. Take the standard deviation of original image
-							cv::Scalar stddev, mean;
-							cv::meanStdDev(toCv(grayscale), mean, stddev);
-							auto cappedStdDev = max((int) stddev[0], 64); //cap the std deviation at 1/4 dynamic range
-							
-							//5. Caculate a normalized result value
-							auto normalized = total / (double(width * height) * cappedStdDev * processSettings.blurSize);
-							
+
+							//1. Measure each cell
+							const auto metric = (Utils::FocusMeasure::Metric) processSettings.metric;
+							auto cells = Utils::FocusMeasure::getCells(cv::Rect(0, 0, roi.width, roi.height)
+								, processSettings.gridColumns
+								, processSettings.gridRows);
+							vector<double> cellValues;
+							double total = 0.0;
+							for (const auto & cell : cells) {
+								auto value = Utils::FocusMeasure::measure(grayscale(cell), metric, processSettings.blurSize);
+								cellValues.push_back(value);
+								total += value;
+							}
+
+							//2. Preview images for the shader (blur and absolute difference of the ROI)
+							if (processSettings.preview) {
+								cv::blur(grayscale, this->process.blurred, cv::Size(processSettings.blurSize, processSettings.blurSize));
+								cv::absdiff(grayscale, this->process.blurred, this->process.edges);
+							}
+
+							auto computeTime = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - startTime).count();
+
 							this->resultMutex.lock();
 							{
-								this->result.highFrequency.getPixels() = this->process.edges;
-								this->result.lowFrequency.getPixels() = this->process.blurred;
-								this->result.value = normalized;
-								this->result.width = this->process.width;
-								this->result.height = this->process.height;
+								if (processSettings.preview) {
+									ofxCv::copy(this->process.edges, this->result.highFrequency.getPixels());
+									ofxCv::copy(this->process.blurred, this->result.lowFrequency.getPixels());
+								}
+								else {
+									//only the pixels, since the textures belong to the main thread
+									this->result.highFrequency.getPixels().clear();
+									this->result.lowFrequency.getPixels().clear();
+								}
+
+								//peaks restart when the grid changes
+								if (this->result.cellPeaks.size() != cells.size()) {
+									this->result.cellPeaks.assign(cells.size(), 0.0);
+									this->result.peak = 0.0;
+								}
+
+								this->result.cells.clear();
+								for (size_t i = 0; i < cells.size(); i++) {
+									const auto & cell = cells[i];
+									this->result.cells.emplace_back(cell.x + roi.x, cell.y + roi.y, cell.width, cell.height);
+									this->result.cellPeaks[i] = max(this->result.cellPeaks[i], cellValues[i]);
+								}
+								this->result.cellValues = cellValues;
+								this->result.value = total / cells.size();
+								this->result.peak = max(this->result.peak, this->result.value);
+
+								this->result.roi = ofRectangle(roi.x, roi.y, roi.width, roi.height);
+								this->result.width = width;
+								this->result.height = height;
+								this->result.computeTime = (float) computeTime / 1000.0f;
 								this->result.isFrameNew = true;
 							}
 							this->resultMutex.unlock();
@@ -364,8 +533,54 @@ namespace ofxRulr {
 				this->processSettings.blurSize = this->blurSize;
 				this->processSettings.lowValue = this->lowValue;
 				this->processSettings.highValue = this->highValue;
+				this->processSettings.metric = this->metric;
+				this->processSettings.roi = ofRectangle(this->roiX, this->roiY, this->roiWidth, this->roiHeight);
+				this->processSettings.gridColumns = this->gridColumns;
+				this->processSettings.gridRows = this->gridRows;
+				this->processSettings.preview = this->showPreview;
 				this->processSettingsMutex.unlock();
 			}
+
+			//----------
+			void Focus::startProcessThread() {
+				if (this->processThreadRunning) {
+					return;
+				}
+				this->processThreadRunning = true;
+				this->processThread = thread([this]() {
+					this->processThreadLoop();
+				});
+			}
+
+			//----------
+			void Focus::stopProcessThread() {
+				{
+					lock_guard<mutex> lock(this->pendingFrameMutex);
+					this->processThreadRunning = false;
+				}
+				this->pendingFrameCondition.notify_one();
+				if (this->processThread.joinable()) {
+					this->processThread.join();
+				}
+			}
+
+			//----------
+			void Focus::processThreadLoop() {
+				while (true) {
+					shared_ptr<ofxMachineVision::Frame> frame;
+					{
+						unique_lock<mutex> lock(this->pendingFrameMutex);
+						this->pendingFrameCondition.wait(lock, [this]() {
+							return this->pendingFrame || !this->processThreadRunning;
+						});
+						if (!this->processThreadRunning) {
+							return;
+						}
+						swap(frame, this->pendingFrame);
+					}
+					this->calculateFocus(frame);
+				}
+			}
 		}
 	}
 }
\ No newline at end of file
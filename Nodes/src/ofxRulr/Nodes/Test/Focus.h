@@ -4,15 +4,22 @@
 
 #include "ofxCvGui/Panels/Draws.h"
 #include "ofxMachineVision/Grabber/Simple.h"
+#include "ofxCvMin.h"
 
 #include "of3dPrimitives.h"
 
+#include <condition_variable>
+#include <thread>
+
 namespace ofxRulr {
 	namespace Nodes {
 		namespace Test {
+			///Frames are measured on a worker thread (frames arriving while it's busy are dropped).
+			///Only the ROI is converted and measured, split into a grid of cells whose values are averaged.
 			class Focus : public Nodes::Base, public ofBaseSoundOutput {
 			public:
 				Focus();
+				virtual ~Focus();
 				string getTypeName() const override;
 				
 				void init();
@@ -26,13 +33,20 @@ namespace ofxRulr {
 				
 				bool getRunFinderEnabled() const;
 				void audioOut(ofSoundBuffer &) override;
+
+				void resetPeak();
 			protected:
 				void connect(shared_ptr<ofxMachineVision::Grabber::Simple> grabber);
 				void disconnect(shared_ptr<ofxMachineVision::Grabber::Simple> grabber);
 				
+				void receiveFrame(shared_ptr<ofxMachineVision::Frame> frame);
 				void calculateFocus(shared_ptr<ofxMachineVision::Frame> frame);
 				
 				void updateProcessSettings();
+
+				void startProcessThread();
+				void stopProcessThread();
+				void processThreadLoop();
 				
 				ofxCvGui::PanelPtr view;
 				ofxCvGui::ElementPtr widget;
@@ -44,17 +58,26 @@ namespace ofxRulr {
 					int blurSize;
 					float highValue;
 					float lowValue;
+					int metric;
+					ofRectangle roi; // normalised to the frame
+					int gridColumns;
+					int gridRows;
+					bool preview;
 				} processSettings;
 				mutex processSettingsMutex;
 				
 				struct {
-					ofPixels grayscale;
-					ofPixels blurred;
-					ofPixels edges;
-					
-					int width = 0;
-					int height = 0;
-				} process; //only accessed in frame callbacks
+					cv::Mat grayscale;
+					cv::Mat blurred;
+					cv::Mat edges;
+				} process; //only accessed on the process thread
+
+				thread processThread;
+				bool processThreadRunning = false;
+				shared_ptr<ofxMachineVision::Frame> pendingFrame;
+				mutex pendingFrameMutex;
+				condition_variable pendingFrameCondition;
+				size_t droppedFrames = 0;
 				
 				struct {
 					ofImage highFrequency;
@@ -62,9 +85,16 @@ namespace ofxRulr {
 					
 					int width = 0;
 					int height = 0;
+					ofRectangle roi; // in pixels, also the area covered by the preview images
 					
-					double value = 0.0;
+					double value = 0.0; // mean over cells
+					double peak = 0.0;
+					vector<ofRectangle> cells;
+					vector<double> cellValues;
+					vector<double> cellPeaks;
+
 					float valueNormalised = 0.0f;
+					float computeTime = 0.0f; // ms
 					bool active = false;
 					bool isFrameNew = false;
 				} result;
@@ -78,6 +108,16 @@ namespace ofxRulr {
 				ofParameter<int> blurSize;
 				ofParameter<float> highValue;
 				ofParameter<float> lowValue;
+
+				ofParameter<int> metric; // Utils::FocusMeasure::Metric
+				ofParameter<float> roiX;
+				ofParameter<float> roiY;
+				ofParameter<float> roiWidth;
+				ofParameter<float> roiHeight;
+				ofParameter<int> gridColumns;
+				ofParameter<int> gridRows;
+				ofParameter<bool> showPreview;
+				ofParameter<bool> peakHold; // normalise the ticks against the best value seen since reset
 				
 				struct {
 					int framesUntilNext = 0;
@@ -0,0 +1,209 @@
+#include "pch_RulrNodes.h"
+#include "FocusMeasure.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define RULR_FOCUS_SSE2
+#endif
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace {
+			struct Sums {
+				int64_t sum = 0;
+				int64_t sumSquares = 0;
+				int64_t count = 0;
+			};
+
+			//----------
+			//Calls kernel(up, middle, down, x, width) over the interior of each row, returns the sums
+			//the SSE2 kernels handle 8 pixels at a time and leave the rest to the scalar kernel
+			template<typename ScalarKernel>
+			Sums accumulateRows(const cv::Mat & image, bool simd, const ScalarKernel & scalarKernel
+				, Sums(*simdRow)(const uint8_t *, const uint8_t *, const uint8_t *, int, int &)) {
+				Sums sums;
+				if (image.cols < 3 || image.rows < 3) {
+					return sums;
+				}
+
+				for (int y = 1; y < image.rows - 1; y++) {
+					const auto up = image.ptr<uint8_t>(y - 1);
+					const auto middle = image.ptr<uint8_t>(y);
+					const auto down = image.ptr<uint8_t>(y + 1);
+
+					int x = 1;
+					if (simd && simdRow) {
+						auto rowSums = simdRow(up, middle, down, image.cols, x);
+						sums.sum += rowSums.sum;
+						sums.sumSquares += rowSums.sumSquares;
+					}
+					for (; x < image.cols - 1; x++) {
+						int value, valueSquared;
+						scalarKernel(up, middle, down, x, value, valueSquared);
+						sums.sum += value;
+						sums.sumSquares += valueSquared;
+					}
+					sums.count += image.cols - 2;
+				}
+				return sums;
+			}
+
+#ifdef RULR_FOCUS_SSE2
+			//----------
+			__m128i load8(const uint8_t * data) {
+				return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) data), _mm_setzero_si128());
+			}
+
+			//----------
+			int64_t horizontalSum(__m128i value) {
+				int32_t lanes[4];
+				_mm_storeu_si128((__m128i *) lanes, value);
+				return (int64_t) lanes[0] + lanes[1] + lanes[2] + lanes[3];
+			}
+
+			//----------
+			Sums laplacianRow(const uint8_t * up, const uint8_t * middle, const uint8_t * down, int width, int & x) {
+				Sums sums;
+				const auto ones = _mm_set1_epi16(1);
+				auto sum = _mm_setzero_si128();
+				auto sumSquares = _mm_setzero_si128();
+				int iterations = 0;
+
+				for (; x + 9 <= width; x += 8) {
+					const auto center = load8(middle + x);
+					const auto neighbours = _mm_add_epi16(_mm_add_epi16(load8(up + x), load8(down + x))
+						, _mm_add_epi16(load8(middle + x - 1), load8(middle + x + 1)));
+					const auto laplacian = _mm_sub_epi16(_mm_slli_epi16(center, 2), neighbours); // within +-1020
+
+					sum = _mm_add_epi32(sum, _mm_madd_epi16(laplacian, ones));
+					sumSquares = _mm_add_epi32(sumSquares, _mm_madd_epi16(laplacian, laplacian)); // up to 2.1M per lane
+
+					//flush before the 32 bit lanes can overflow
+					if (++iterations == 512) {
+						sums.sum += horizontalSum(sum);
+						sums.sumSquares += horizontalSum(sumSquares);
+						sum = _mm_setzero_si128();
+						sumSquares = _mm_setzero_si128();
+						iterations = 0;
+					}
+				}
+				sums.sum += horizontalSum(sum);
+				sums.sumSquares += horizontalSum(sumSquares);
+				return sums;
+			}
+
+			//----------
+			Sums tenengradRow(const uint8_t * up, const uint8_t * middle, const uint8_t * down, int width, int & x) {
+				Sums sums;
+				auto sumSquares = _mm_setzero_si128();
+				int iterations = 0;
+
+				for (; x + 9 <= width; x += 8) {
+					const auto upLeft = load8(up + x - 1);
+					const auto upRight = load8(up + x + 1);
+					const auto downLeft = load8(down + x - 1);
+					const auto downRight = load8(down + x + 1);
+
+					//Sobel, within +-1020
+					const auto gradientX = _mm_sub_epi16(
+						_mm_add_epi16(_mm_add_epi16(upRight, downRight), _mm_slli_epi16(load8(middle + x + 1), 1))
+						, _mm_add_epi16(_mm_add_epi16(upLeft, downLeft), _mm_slli_epi16(load8(middle + x - 1), 1)));
+					const auto gradientY = _mm_sub_epi16(
+						_mm_add_epi16(_mm_add_epi16(downLeft, downRight), _mm_slli_epi16(load8(down + x), 1))
+						, _mm_add_epi16(_mm_add_epi16(upLeft, upRight), _mm_slli_epi16(load8(up + x), 1)));
+
+					sumSquares = _mm_add_epi32(sumSquares, _mm_madd_epi16(gradientX, gradientX)); // up to 2.1M per lane
+					sumSquares = _mm_add_epi32(sumSquares, _mm_madd_epi16(gradientY, gradientY));
+
+					if (++iterations == 256) {
+						sums.sumSquares += horizontalSum(sumSquares);
+						sumSquares = _mm_setzero_si128();
+						iterations = 0;
+					}
+				}
+				sums.sumSquares += horizontalSum(sumSquares);
+				return sums;
+			}
+#else
+			Sums(*const laplacianRow)(const uint8_t *, const uint8_t *, const uint8_t *, int, int &) = nullptr;
+			Sums(*const tenengradRow)(const uint8_t *, const uint8_t *, const uint8_t *, int, int &) = nullptr;
+#endif
+		}
+
+		//----------
+		double FocusMeasure::measure(const cv::Mat & grayscale, Metric metric, int blurSize, bool simd) {
+			switch (metric) {
+			case Metric::BlurDifference:
+				return FocusMeasure::blurDifference(grayscale, blurSize);
+			case Metric::LaplacianVariance:
+				return FocusMeasure::laplacianVariance(grayscale, simd);
+			case Metric::Tenengrad:
+				return FocusMeasure::tenengrad(grayscale, simd);
+			default:
+				return 0.0;
+			}
+		}
+
+		//----------
+		double FocusMeasure::blurDifference(const cv::Mat & grayscale, int blurSize) {
+			if (grayscale.empty()) {
+				return 0.0;
+			}
+
+			cv::Mat blurred, edges;
+			cv::blur(grayscale, blurred, cv::Size(blurSize, blurSize));
+			cv::absdiff(grayscale, blurred, edges);
+			auto total = cv::sum(edges)[0];
+
+			cv::Scalar stddev, mean;
+			cv::meanStdDev(grayscale, mean, stddev);
+			auto cappedStdDev = max((int) stddev[0], 64); //cap the std deviation at 1/4 dynamic range
+
+			return total / (double(grayscale.cols * grayscale.rows) * cappedStdDev * blurSize);
+		}
+
+		//----------
+		double FocusMeasure::laplacianVariance(const cv::Mat & grayscale, bool simd) {
+			auto sums = accumulateRows(grayscale, simd, [](const uint8_t * up, const uint8_t * middle, const uint8_t * down, int x, int & value, int & valueSquared) {
+				value = 4 * middle[x] - up[x] - down[x] - middle[x - 1] - middle[x + 1];
+				valueSquared = value * value;
+			}, laplacianRow);
+			if (sums.count == 0) {
+				return 0.0;
+			}
+			auto mean = (double) sums.sum / sums.count;
+			return (double) sums.sumSquares / sums.count - mean * mean;
+		}
+
+		//----------
+		double FocusMeasure::tenengrad(const cv::Mat & grayscale, bool simd) {
+			auto sums = accumulateRows(grayscale, simd, [](const uint8_t * up, const uint8_t * middle, const uint8_t * down, int x, int & value, int & valueSquared) {
+				const int gradientX = (up[x + 1] + 2 * middle[x + 1] + down[x + 1]) - (up[x - 1] + 2 * middle[x - 1] + down[x - 1]);
+				const int gradientY = (down[x - 1] + 2 * down[x] + down[x + 1]) - (up[x - 1] + 2 * up[x] + up[x + 1]);
+				value = 0;
+				valueSquared = gradientX * gradientX + gradientY * gradientY;
+			}, tenengradRow);
+			if (sums.count == 0) {
+				return 0.0;
+			}
+			return (double) sums.sumSquares / sums.count;
+		}
+
+		//----------
+		vector<cv::Rect> FocusMeasure::getCells(const cv::Rect & roi, int columns, int rows) {
+			vector<cv::Rect> cells;
+			columns = max(columns, 1);
+			rows = max(rows, 1);
+			for (int j = 0; j < rows; j++) {
+				for (int i = 0; i < columns; i++) {
+					const auto x0 = roi.x + roi.width * i / columns;
+					const auto x1 = roi.x + roi.width * (i + 1) / columns;
+					const auto y0 = roi.y + roi.height * j / rows;
+					const auto y1 = roi.y + roi.height * (j + 1) / rows;
+					cells.emplace_back(x0, y0, x1 - x0, y1 - y0);
+				}
+			}
+			return cells;
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ofxRulr/Utils/Constants.h"
+#include "ofxCvMin.h"
+
+namespace ofxRulr {
+	namespace Utils {
+		///Sharpness measures for 8 bit grayscale images (or ROIs of them), higher is sharper.
+		///The 3x3 kernels skip a 1 pixel border and use SSE2 where available.
+		class RULR_EXPORTS FocusMeasure {
+		public:
+			enum Metric {
+				BlurDifference = 0, // Test::Focus's original measure
+				LaplacianVariance,
+				Tenengrad
+			};
+
+			static double measure(const cv::Mat & grayscale, Metric, int blurSize, bool simd = true);
+
+			///Sum of |image - box blur|, normalised by area, blur size and (capped) standard deviation
+			static double blurDifference(const cv::Mat & grayscale, int blurSize);
+
+			///Variance of the 4-neighbour Laplacian
+			static double laplacianVariance(const cv::Mat & grayscale, bool simd = true);
+
+			///Mean squared Sobel gradient magnitude
+			static double tenengrad(const cv::Mat & grayscale, bool simd = true);
+
+			///Split roi into a grid of cells (for drawing and for measuring each)
+			static vector<cv::Rect> getCells(const cv::Rect & roi, int columns, int rows);
+		};
+	}
+}
@@ -0,0 +1,463 @@
+#include "pch_RulrNodes.h"
+#include "MappedDataSet.h"
+
+#include "ofxRulr/Exception.h"
+
+#ifndef TARGET_WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace {
+			const char Magic[8] = { 'R', 'U', 'L', 'R', 'G', 'C', 'M', '1' };
+			const uint32_t Version = 1;
+			const uint64_t SectionAlignment = 4096; // so each section starts on its own page
+
+			//----------
+			uint64_t align(uint64_t offset) {
+				return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+			}
+
+			//----------
+			//a rewritten file gets a new key, so we never hand out a mapping of the old contents
+			string getOpenMappingsKey(const string & path) {
+#ifdef TARGET_WIN32
+				WIN32_FILE_ATTRIBUTE_DATA attributes;
+				if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attributes)) {
+					return path;
+				}
+				auto size = ((uint64_t) attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+				auto modified = ((uint64_t) attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+#else
+				struct stat fileStatus;
+				if (stat(path.c_str(), &fileStatus) != 0) {
+					return path;
+				}
+				auto size = (uint64_t) fileStatus.st_size;
+#ifdef TARGET_OSX
+				auto modified = (uint64_t) fileStatus.st_mtimespec.tv_sec * 1000000000 + fileStatus.st_mtimespec.tv_nsec;
+#else
+				auto modified = (uint64_t) fileStatus.st_mtim.tv_sec * 1000000000 + fileStatus.st_mtim.tv_nsec;
+#endif
+#endif
+				return path + "|" + ofToString(size) + "|" + ofToString(modified);
+			}
+		}
+
+		recursive_mutex MappedDataSet::openMappingsMutex;
+		map<string, weak_ptr<MappedDataSet>> MappedDataSet::openMappings;
+		atomic<uint64_t> MappedDataSet::nextContentId{ 1 };
+
+#pragma mark Pixel
+		//----------
+		ofVec2f MappedDataSet::Pixel::getCameraXY() const {
+			return ofVec2f(this->camera % this->cameraWidth, this->camera / this->cameraWidth);
+		}
+
+		//----------
+		ofVec2f MappedDataSet::Pixel::getProjectorXY() const {
+			return ofVec2f(this->projector % this->projectorWidth, this->projector / this->projectorWidth);
+		}
+
+#pragma mark const_iterator
+		//----------
+		MappedDataSet::const_iterator::const_iterator(const MappedDataSet & dataSet, uint32_t cameraIndex)
+			: dataSet(dataSet) {
+			this->pixel.camera = cameraIndex;
+			this->pixel.cameraWidth = dataSet.getWidth();
+			this->pixel.projectorWidth = dataSet.getPayloadWidth();
+			this->update();
+		}
+
+		//----------
+		const MappedDataSet::Pixel & MappedDataSet::const_iterator::operator*() const {
+			return this->pixel;
+		}
+
+		//----------
+		const MappedDataSet::Pixel * MappedDataSet::const_iterator::operator->() const {
+			return &this->pixel;
+		}
+
+		//----------
+		MappedDataSet::const_iterator & MappedDataSet::const_iterator::operator++() {
+			this->pixel.camera++;
+			this->update();
+			return *this;
+		}
+
+		//----------
+		bool MappedDataSet::const_iterator::operator!=(const const_iterator & other) const {
+			return this->pixel.camera != other.pixel.camera;
+		}
+
+		//----------
+		void MappedDataSet::const_iterator::update() {
+			const auto cameraIndex = this->pixel.camera;
+			if (cameraIndex < (uint32_t) (this->dataSet.getWidth() * this->dataSet.getHeight())) {
+				this->pixel.projector = this->dataSet.getData()[cameraIndex];
+				this->pixel.active = this->dataSet.getActive()[cameraIndex] != 0;
+				this->pixel.median = this->dataSet.getMedian()[cameraIndex];
+			}
+		}
+
+#pragma mark MappedDataSet
+		//----------
+		MappedDataSet::MappedDataSet()
+			: contentId(MappedDataSet::nextContentId++) {
+
+		}
+
+		//----------
+		MappedDataSet::~MappedDataSet() {
+			if (!this->isMapped()) {
+				return;
+			}
+
+#ifdef TARGET_WIN32
+			UnmapViewOfFile(this->base);
+			CloseHandle((HANDLE) this->mappingHandle);
+			CloseHandle((HANDLE) this->fileHandle);
+#else
+			munmap((void*) this->base, this->size);
+#endif
+
+			lock_guard<recursive_mutex> lock(MappedDataSet::openMappingsMutex);
+			auto findMapping = MappedDataSet::openMappings.find(this->openMappingsKey);
+			if (findMapping != MappedDataSet::openMappings.end() && findMapping->second.expired()) {
+				MappedDataSet::openMappings.erase(findMapping);
+			}
+		}
+
+		//----------
+		shared_ptr<MappedDataSet> MappedDataSet::fromDataSet(const ofxGraycode::DataSet & dataSet) {
+			if (!dataSet.getHasData()) {
+				throw(ofxRulr::Exception("Cannot map an ofxGraycode::DataSet which has no data"));
+			}
+
+			auto header = MappedDataSet::makeHeader(dataSet.getWidth()
+				, dataSet.getHeight()
+				, dataSet.getPayloadWidth()
+				, dataSet.getPayloadHeight());
+
+			auto mappedDataSet = shared_ptr<MappedDataSet>(new MappedDataSet());
+			auto & buffer = mappedDataSet->buffer;
+			buffer.assign((size_t) header.size, 0);
+			memcpy(buffer.data(), &header, sizeof(Header));
+
+			const auto cameraPixelCount = (size_t) header.width * header.height;
+			const auto projectorPixelCount = (size_t) header.payloadWidth * header.payloadHeight;
+
+			auto data = (uint32_t*) (buffer.data() + header.dataOffset);
+			auto dataInverse = (uint32_t*) (buffer.data() + header.dataInverseOffset);
+			const auto & sourceData = dataSet.getData().getData();
+			const auto & sourceDataInverse = dataSet.getDataInverse().getData();
+			for (size_t i = 0; i < cameraPixelCount; i++) {
+				data[i] = (uint32_t) sourceData[i];
+			}
+			for (size_t i = 0; i < projectorPixelCount; i++) {
+				dataInverse[i] = (uint32_t) sourceDataInverse[i];
+			}
+
+			memcpy(buffer.data() + header.medianOffset, dataSet.getMedian().getData(), cameraPixelCount);
+			memcpy(buffer.data() + header.medianInverseOffset, dataSet.getMedianInverse().getData(), projectorPixelCount);
+			memcpy(buffer.data() + header.activeOffset, dataSet.getActive().getData(), cameraPixelCount);
+
+			mappedDataSet->base = buffer.data();
+			mappedDataSet->size = buffer.size();
+			return mappedDataSet;
+		}
+
+		//----------
+		shared_ptr<MappedDataSet> MappedDataSet::open(const string & filename) {
+			const auto path = ofToDataPath(filename, true);
+			const auto openMappingsKey = getOpenMappingsKey(path);
+
+			lock_guard<recursive_mutex> lock(MappedDataSet::openMappingsMutex);
+			{
+				auto findMapping = MappedDataSet::openMappings.find(openMappingsKey);
+				if (findMapping != MappedDataSet::openMappings.end()) {
+					auto existingMapping = findMapping->second.lock();
+					if (existingMapping) {
+						return existingMapping;
+					}
+				}
+			}
+
+			auto mappedDataSet = shared_ptr<MappedDataSet>(new MappedDataSet());
+			mappedDataSet->filename = path;
+			mappedDataSet->openMappingsKey = openMappingsKey;
+
+#ifdef TARGET_WIN32
+			auto fileHandle = CreateFileA(path.c_str()
+				, GENERIC_READ
+				, FILE_SHARE_READ
+				, NULL
+				, OPEN_EXISTING
+				, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS
+				, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE) {
+				throw(ofxRulr::Exception("Cannot open " + path));
+			}
+			LARGE_INTEGER fileSize;
+			GetFileSizeEx(fileHandle, &fileSize);
+
+			auto mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (!mappingHandle) {
+				CloseHandle(fileHandle);
+				throw(ofxRulr::Exception("Cannot map " + path));
+			}
+			auto view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+			if (!view) {
+				CloseHandle(mappingHandle);
+				CloseHandle(fileHandle);
+				throw(ofxRulr::Exception("Cannot map " + path));
+			}
+
+			mappedDataSet->fileHandle = fileHandle;
+			mappedDataSet->mappingHandle = mappingHandle;
+			mappedDataSet->base = (const uint8_t*) view;
+			mappedDataSet->size = (size_t) fileSize.QuadPart;
+#else
+			auto fileDescriptor = ::open(path.c_str(), O_RDONLY);
+			if (fileDescriptor < 0) {
+				throw(ofxRulr::Exception("Cannot open " + path));
+			}
+			struct stat fileStatus;
+			fstat(fileDescriptor, &fileStatus);
+
+			auto view = mmap(nullptr, (size_t) fileStatus.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+			::close(fileDescriptor);
+			if (view == MAP_FAILED) {
+				throw(ofxRulr::Exception("Cannot map " + path));
+			}
+
+			mappedDataSet->fileHandle = view; // nothing to keep open, but marks this as mapped
+			mappedDataSet->base = (const uint8_t*) view;
+			mappedDataSet->size = (size_t) fileStatus.st_size;
+#endif
+
+			//check the header (only touches the first page)
+			{
+				const auto & header = mappedDataSet->getHeader();
+				if (mappedDataSet->size < sizeof(Header)
+					|| memcmp(header.magic, Magic, sizeof(Magic)) != 0
+					|| header.version != Version
+					|| header.size > mappedDataSet->size) {
+					throw(ofxRulr::Exception(path + " is not a valid .slmap file"));
+				}
+			}
+
+			MappedDataSet::openMappings[openMappingsKey] = mappedDataSet;
+			return mappedDataSet;
+		}
+
+		//----------
+		void MappedDataSet::save(const string & filename) const {
+			const auto path = ofToDataPath(filename, true);
+			if (this->isMapped() && this->filename == path) {
+				//already there
+				return;
+			}
+
+			//write alongside then swap in, so we never write into a file which somebody has mapped
+			const auto temporaryPath = path + ".tmp";
+			{
+				ofstream file(temporaryPath, ios::binary | ios::out | ios::trunc);
+				if (!file.is_open()) {
+					throw(ofxRulr::Exception("Cannot write " + temporaryPath));
+				}
+				file.write((const char*) this->base, this->size);
+			}
+			if (!ofFile::moveFromTo(temporaryPath, path, false, true)) {
+				throw(ofxRulr::Exception("Cannot replace " + path + ". Is it open elsewhere?"));
+			}
+		}
+
+		//----------
+		shared_ptr<MappedDataSet> MappedDataSet::saveAndOpen(const string & filename) const {
+			this->save(filename);
+			auto mappedDataSet = MappedDataSet::open(filename);
+			mappedDataSet->contentId = this->contentId;
+			return mappedDataSet;
+		}
+
+		//----------
+		bool MappedDataSet::getHasData() const {
+			return this->base != nullptr;
+		}
+
+		//----------
+		bool MappedDataSet::isMapped() const {
+			return this->fileHandle != nullptr;
+		}
+
+		//----------
+		const string & MappedDataSet::getFilename() const {
+			return this->filename;
+		}
+
+		//----------
+		uint64_t MappedDataSet::getContentId() const {
+			return this->contentId;
+		}
+
+		//----------
+		int MappedDataSet::getWidth() const {
+			return (int) this->getHeader().width;
+		}
+
+		//----------
+		int MappedDataSet::getHeight() const {
+			return (int) this->getHeader().height;
+		}
+
+		//----------
+		int MappedDataSet::getPayloadWidth() const {
+			return (int) this->getHeader().payloadWidth;
+		}
+
+		//----------
+		int MappedDataSet::getPayloadHeight() const {
+			return (int) this->getHeader().payloadHeight;
+		}
+
+		//----------
+		const uint32_t * MappedDataSet::getData() const {
+			return (const uint32_t*) (this->base + this->getHeader().dataOffset);
+		}
+
+		//----------
+		const uint32_t * MappedDataSet::getDataInverse() const {
+			return (const uint32_t*) (this->base + this->getHeader().dataInverseOffset);
+		}
+
+		//----------
+		const uint8_t * MappedDataSet::getMedian() const {
+			return this->base + this->getHeader().medianOffset;
+		}
+
+		//----------
+		const uint8_t * MappedDataSet::getMedianInverse() const {
+			return this->base + this->getHeader().medianInverseOffset;
+		}
+
+		//----------
+		const uint8_t * MappedDataSet::getActive() const {
+			return this->base + this->getHeader().activeOffset;
+		}
+
+		//----------
+		ofPixels MappedDataSet::getMedianPixels() const {
+			ofPixels pixels;
+			pixels.setFromPixels(this->getMedian(), this->getWidth(), this->getHeight(), 1);
+			return pixels;
+		}
+
+		//----------
+		ofPixels MappedDataSet::getMedianInversePixels() const {
+			ofPixels pixels;
+			pixels.setFromPixels(this->getMedianInverse(), this->getPayloadWidth(), this->getPayloadHeight(), 1);
+			return pixels;
+		}
+
+		//----------
+		ofPixels MappedDataSet::getActivePixels() const {
+			ofPixels pixels;
+			pixels.setFromPixels(this->getActive(), this->getWidth(), this->getHeight(), 1);
+			return pixels;
+		}
+
+		//----------
+		ofPixels MappedDataSet::getProjectorInCameraPreview() const {
+			const auto width = this->getWidth();
+			const auto height = this->getHeight();
+			const auto payloadWidth = this->getPayloadWidth();
+			const auto payloadHeight = max(this->getPayloadHeight(), 1);
+
+			ofPixels pixels;
+			pixels.allocate(width, height, OF_PIXELS_RGB);
+			pixels.set(0);
+
+			auto output = pixels.getData();
+			auto data = this->getData();
+			auto active = this->getActive();
+			const auto count = width * height;
+			for (int i = 0; i < count; i++) {
+				if (active[i]) {
+					output[i * 3 + 0] = (uint8_t) (255 * (data[i] % payloadWidth) / payloadWidth);
+					output[i * 3 + 1] = (uint8_t) (255 * (data[i] / payloadWidth) / payloadHeight);
+				}
+			}
+			return pixels;
+		}
+
+		//----------
+		ofPixels MappedDataSet::getCameraInProjectorPreview() const {
+			const auto width = this->getWidth();
+			const auto height = max(this->getHeight(), 1);
+			const auto payloadWidth = this->getPayloadWidth();
+			const auto payloadHeight = this->getPayloadHeight();
+
+			ofPixels pixels;
+			pixels.allocate(payloadWidth, payloadHeight, OF_PIXELS_RGB);
+			pixels.set(0);
+
+			auto output = pixels.getData();
+			auto dataInverse = this->getDataInverse();
+			auto active = this->getActive();
+			const auto cameraCount = (uint32_t) (width * height);
+			const auto count = payloadWidth * payloadHeight;
+			for (int i = 0; i < count; i++) {
+				const auto cameraIndex = dataInverse[i];
+				if (cameraIndex < cameraCount && active[cameraIndex]) {
+					output[i * 3 + 0] = (uint8_t) (255 * (cameraIndex % width) / width);
+					output[i * 3 + 1] = (uint8_t) (255 * (cameraIndex / width) / height);
+				}
+			}
+			return pixels;
+		}
+
+		//----------
+		MappedDataSet::const_iterator MappedDataSet::begin() const {
+			return const_iterator(*this, 0);
+		}
+
+		//----------
+		MappedDataSet::const_iterator MappedDataSet::end() const {
+			return const_iterator(*this, (uint32_t) (this->getWidth() * this->getHeight()));
+		}
+
+		//----------
+		MappedDataSet::Header MappedDataSet::makeHeader(uint32_t width, uint32_t height, uint32_t payloadWidth, uint32_t payloadHeight) {
+			Header header;
+			memset(&header, 0, sizeof(Header));
+			memcpy(header.magic, Magic, sizeof(Magic));
+			header.version = Version;
+			header.width = width;
+			header.height = height;
+			header.payloadWidth = payloadWidth;
+			header.payloadHeight = payloadHeight;
+
+			const uint64_t cameraPixelCount = (uint64_t) width * height;
+			const uint64_t projectorPixelCount = (uint64_t) payloadWidth * payloadHeight;
+
+			header.dataOffset = align(sizeof(Header));
+			header.dataInverseOffset = align(header.dataOffset + cameraPixelCount * sizeof(uint32_t));
+			header.medianOffset = align(header.dataInverseOffset + projectorPixelCount * sizeof(uint32_t));
+			header.medianInverseOffset = align(header.medianOffset + cameraPixelCount);
+			header.activeOffset = align(header.medianInverseOffset + projectorPixelCount);
+			header.size = header.activeOffset + cameraPixelCount;
+			return header;
+		}
+
+		//----------
+		const MappedDataSet::Header & MappedDataSet::getHeader() const {
+			return *(const Header*) this->base;
+		}
+	}
+}
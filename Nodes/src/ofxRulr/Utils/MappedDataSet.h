@@ -0,0 +1,123 @@
+#pragma once
+
+#include "ofxGraycode.h"
+#include "ofxRulr/Utils/Constants.h"
+
+#include <mutex>
+#include <atomic>
+
+namespace ofxRulr {
+	namespace Utils {
+		///Read-only view of a decoded ofxGraycode::DataSet with the lookups consumers need already built :
+		///camera->projector, projector->camera, median, median inverse and active mask.
+		///Either held in memory (just decoded) or memory-mapped from a .slmap file, in which case pages are only
+		///read from disk when they're touched. Opening the same file twice gives the same mapping, unless it has been
+		///rewritten in between.
+		class RULR_EXPORTS MappedDataSet {
+		public:
+			struct Pixel {
+				uint32_t camera; // camera pixel index
+				uint32_t projector; // projector pixel index
+				bool active;
+				uint8_t median;
+
+				int cameraWidth;
+				int projectorWidth;
+
+				ofVec2f getCameraXY() const;
+				ofVec2f getProjectorXY() const;
+			};
+
+			class const_iterator {
+			public:
+				const_iterator(const MappedDataSet &, uint32_t cameraIndex);
+				const Pixel & operator*() const;
+				const Pixel * operator->() const;
+				const_iterator & operator++();
+				bool operator!=(const const_iterator &) const;
+			protected:
+				void update();
+				const MappedDataSet & dataSet;
+				Pixel pixel;
+			};
+
+			~MappedDataSet();
+
+			///Copy the lookups out of a decoded data set
+			static shared_ptr<MappedDataSet> fromDataSet(const ofxGraycode::DataSet &);
+
+			///Map a file written by save(). Throws if it's missing or not a .slmap file
+			static shared_ptr<MappedDataSet> open(const string & filename);
+
+			void save(const string & filename) const;
+
+			///save() then open(), keeping our content id since the mapping holds the same data
+			shared_ptr<MappedDataSet> saveAndOpen(const string & filename) const;
+
+			bool getHasData() const;
+			bool isMapped() const;
+			const string & getFilename() const; // empty unless mapped
+
+			///Unique to this content within the process, so consumers can tell whether they've seen it already
+			uint64_t getContentId() const;
+
+			int getWidth() const;
+			int getHeight() const;
+			int getPayloadWidth() const;
+			int getPayloadHeight() const;
+
+			const uint32_t * getData() const; // projector index per camera pixel
+			const uint32_t * getDataInverse() const; // camera index per projector pixel
+			const uint8_t * getMedian() const;
+			const uint8_t * getMedianInverse() const;
+			const uint8_t * getActive() const;
+
+			//copies, for uploading to textures or handing to OpenCV
+			ofPixels getMedianPixels() const;
+			ofPixels getMedianInversePixels() const;
+			ofPixels getActivePixels() const;
+
+			///Camera pixels coloured by their projector coordinate (and the inverse), black where inactive
+			ofPixels getProjectorInCameraPreview() const;
+			ofPixels getCameraInProjectorPreview() const;
+
+			const_iterator begin() const;
+			const_iterator end() const;
+		protected:
+			struct Header {
+				char magic[8];
+				uint32_t version;
+				uint32_t width;
+				uint32_t height;
+				uint32_t payloadWidth;
+				uint32_t payloadHeight;
+				uint32_t reserved;
+				uint64_t dataOffset;
+				uint64_t dataInverseOffset;
+				uint64_t medianOffset;
+				uint64_t medianInverseOffset;
+				uint64_t activeOffset;
+				uint64_t size;
+			};
+
+			MappedDataSet();
+			static Header makeHeader(uint32_t width, uint32_t height, uint32_t payloadWidth, uint32_t payloadHeight);
+			const Header & getHeader() const;
+
+			//either an in-memory buffer or a view of the file
+			vector<uint8_t> buffer;
+			const uint8_t * base = nullptr;
+			size_t size = 0;
+
+			string filename;
+			string openMappingsKey;
+			uint64_t contentId;
+			void * fileHandle = nullptr;
+			void * mappingHandle = nullptr;
+
+			static recursive_mutex openMappingsMutex; // also taken by the destructor, which can run inside open()
+			static map<string, weak_ptr<MappedDataSet>> openMappings; // by path, size and modified time
+			static atomic<uint64_t> nextContentId;
+		};
+	}
+}
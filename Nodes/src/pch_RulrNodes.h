@@ -24,5 +24,6 @@
 #include "ofxRulr/Utils/Set.h"
 #include "ofxRulr/Utils/SoundEngine.h"
 #include "ofxRulr/Utils/Utils.h"
+#include "ofxRulr/Utils/WorldBatch.h"
 #include "ofxRulr/Nodes/GraphicsManager.h"
 
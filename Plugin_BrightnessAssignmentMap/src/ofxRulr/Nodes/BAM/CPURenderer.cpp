@@ -0,0 +1,474 @@
+#include "pch_Plugin_BrightnessAssignmentMap.h"
+#include "CPURenderer.h"
+
+#include "ofxRulr/Utils/ParallelFor.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define RULR_BAM_SSE2
+#endif
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace BAM {
+			namespace {
+				//same as the shader
+				const float ShadowBias = 0.00001f;
+
+				//rows are rasterised in bands so that each thread only sees the triangles it needs
+				const int BandHeight = 16;
+
+				//----------
+				inline ofVec4f transform(const float * matrix, const ofVec3f & point) {
+					//row vector convention, i.e. point * matrix
+					return ofVec4f(point.x * matrix[0] + point.y * matrix[4] + point.z * matrix[8] + matrix[12]
+						, point.x * matrix[1] + point.y * matrix[5] + point.z * matrix[9] + matrix[13]
+						, point.x * matrix[2] + point.y * matrix[6] + point.z * matrix[10] + matrix[14]
+						, point.x * matrix[3] + point.y * matrix[7] + point.z * matrix[11] + matrix[15]);
+				}
+
+				//----------
+				inline float smoothStep(float edge0, float edge1, float x) {
+					auto t = ofClamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+					return t * t * (3.0f - 2.0f * t);
+				}
+
+				//----------
+				inline float sampleBilinear(const cv::Mat & image, float x, float y) {
+					//texel centers are at +0.5, edges are clamped (as GL_CLAMP_TO_EDGE with GL_LINEAR)
+					x = ofClamp(x - 0.5f, 0.0f, (float)(image.cols - 1));
+					y = ofClamp(y - 0.5f, 0.0f, (float)(image.rows - 1));
+					auto x0 = (int)x;
+					auto y0 = (int)y;
+					auto x1 = min(x0 + 1, image.cols - 1);
+					auto y1 = min(y0 + 1, image.rows - 1);
+					auto fx = x - (float)x0;
+					auto fy = y - (float)y0;
+
+					auto row0 = image.ptr<float>(y0);
+					auto row1 = image.ptr<float>(y1);
+					auto top = row0[x0] + (row0[x1] - row0[x0]) * fx;
+					auto bottom = row1[x0] + (row1[x1] - row1[x0]) * fx;
+					return top + (bottom - top) * fy;
+				}
+
+				//----------
+				inline ofFloatColor sampleBilinear(const ofPixels & pixels, float u, float v) {
+					//normalized coordinates, first row at v = 0 (as the texture is uploaded), edges are clamped
+					const auto width = (int)pixels.getWidth();
+					const auto height = (int)pixels.getHeight();
+					const auto channels = (int)pixels.getNumChannels();
+					auto x = ofClamp(u * (float)width - 0.5f, 0.0f, (float)(width - 1));
+					auto y = ofClamp(v * (float)height - 0.5f, 0.0f, (float)(height - 1));
+					auto x0 = (int)x;
+					auto y0 = (int)y;
+					auto x1 = min(x0 + 1, width - 1);
+					auto y1 = min(y0 + 1, height - 1);
+					auto fx = x - (float)x0;
+					auto fy = y - (float)y0;
+
+					auto data = pixels.getData();
+					auto texel = [&](int tx, int ty) {
+						auto value = data + (ty * width + tx) * channels;
+						switch (channels) {
+						case 1:
+							return ofFloatColor(value[0] / 255.0f);
+						case 2:
+							return ofFloatColor(value[0] / 255.0f, value[1] / 255.0f);
+						case 3:
+							return ofFloatColor(value[0] / 255.0f, value[1] / 255.0f, value[2] / 255.0f);
+						default:
+							return ofFloatColor(value[0] / 255.0f, value[1] / 255.0f, value[2] / 255.0f, value[3] / 255.0f);
+						}
+					};
+
+					auto top = texel(x0, y0).getLerped(texel(x1, y0), fx);
+					auto bottom = texel(x0, y1).getLerped(texel(x1, y1), fx);
+					return top.getLerped(bottom, fy);
+				}
+
+				struct ScreenVertex {
+					float x, y, z;
+					float inverseW;
+					bool valid;
+				};
+
+				struct Triangle {
+					ofIndexType indices[3];
+					int minX, maxX, minY, maxY;
+					float inverseArea;
+					ofVec3f faceNormal;
+				};
+			}
+
+			//----------
+			void CPURenderer::renderDepth(const ofMesh & mesh, const View & view, DepthMap & depthMap, const ofPixels & texture) {
+				const auto width = view.width;
+				const auto height = view.height;
+
+				depthMap.depth.create(height, width, CV_32F);
+				depthMap.depth.setTo(1.0f);
+				depthMap.position.create(height, width, CV_32FC3);
+				depthMap.position.setTo(cv::Scalar::all(0));
+				depthMap.normal.create(height, width, CV_32FC3);
+				depthMap.normal.setTo(cv::Scalar::all(0));
+				depthMap.color.create(height, width, CV_32FC4);
+				depthMap.color.setTo(cv::Scalar::all(0));
+
+				if (width <= 0 || height <= 0) {
+					return;
+				}
+
+				const auto & vertices = mesh.getVertices();
+				const auto & normals = mesh.getNormals();
+				const auto hasNormals = normals.size() == vertices.size();
+				const auto & colors = mesh.getColors();
+				const auto hasColors = colors.size() == vertices.size();
+				const auto & texCoords = mesh.getTexCoords();
+				const auto hasTexture = texCoords.size() == vertices.size() && texture.isAllocated();
+				const auto matrix = view.viewProjection.getPtr();
+
+				//project the vertices
+				vector<ScreenVertex> screenVertices(vertices.size());
+				for (size_t i = 0; i < vertices.size(); i++) {
+					auto clip = transform(matrix, vertices[i]);
+					auto & screenVertex = screenVertices[i];
+
+					//no near plane clipping, triangles which cross w = 0 are dropped
+					screenVertex.valid = clip.w > 1e-6f;
+					if (!screenVertex.valid) {
+						continue;
+					}
+					screenVertex.inverseW = 1.0f / clip.w;
+					screenVertex.x = (clip.x * screenVertex.inverseW + 1.0f) / 2.0f * (float)width;
+					screenVertex.y = (clip.y * screenVertex.inverseW + 1.0f) / 2.0f * (float)height;
+					screenVertex.z = (clip.z * screenVertex.inverseW + 1.0f) / 2.0f;
+				}
+
+				//setup the triangles and sort them into bands
+				const auto bandCount = (height + BandHeight - 1) / BandHeight;
+				vector<Triangle> triangles;
+				vector<vector<size_t>> bands(bandCount);
+				{
+					vector<ofIndexType> indices;
+					if (mesh.hasIndices()) {
+						indices = mesh.getIndices();
+					}
+					else {
+						indices.resize(vertices.size());
+						for (size_t i = 0; i < indices.size(); i++) {
+							indices[i] = (ofIndexType)i;
+						}
+					}
+
+					for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+						Triangle triangle;
+						bool valid = true;
+						for (int j = 0; j < 3; j++) {
+							triangle.indices[j] = indices[i + j];
+							if (triangle.indices[j] >= screenVertices.size() || !screenVertices[triangle.indices[j]].valid) {
+								valid = false;
+							}
+						}
+						if (!valid) {
+							continue;
+						}
+
+						const auto & a = screenVertices[triangle.indices[0]];
+						const auto & b = screenVertices[triangle.indices[1]];
+						const auto & c = screenVertices[triangle.indices[2]];
+
+						auto area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+						if (abs(area) < 1e-12f) {
+							continue;
+						}
+						triangle.inverseArea = 1.0f / area;
+
+						//pixels whose centers lie within the bounds
+						triangle.minX = max(0, (int)ceil(min(a.x, min(b.x, c.x)) - 0.5f));
+						triangle.maxX = min(width - 1, (int)floor(max(a.x, max(b.x, c.x)) - 0.5f));
+						triangle.minY = max(0, (int)ceil(min(a.y, min(b.y, c.y)) - 0.5f));
+						triangle.maxY = min(height - 1, (int)floor(max(a.y, max(b.y, c.y)) - 0.5f));
+						if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+							continue;
+						}
+
+						const auto & worldA = vertices[triangle.indices[0]];
+						triangle.faceNormal = (vertices[triangle.indices[1]] - worldA).getCrossed(vertices[triangle.indices[2]] - worldA).getNormalized();
+
+						auto triangleIndex = triangles.size();
+						triangles.push_back(triangle);
+						for (int band = triangle.minY / BandHeight; band <= triangle.maxY / BandHeight; band++) {
+							bands[band].push_back(triangleIndex);
+						}
+					}
+				}
+
+				//rasterise each band
+				Utils::parallelFor((size_t)bandCount, [&](size_t band) {
+					const auto bandMinY = (int)band * BandHeight;
+					const auto bandMaxY = min(bandMinY + BandHeight, height) - 1;
+
+					for (auto triangleIndex : bands[band]) {
+						const auto & triangle = triangles[triangleIndex];
+						const auto & a = screenVertices[triangle.indices[0]];
+						const auto & b = screenVertices[triangle.indices[1]];
+						const auto & c = screenVertices[triangle.indices[2]];
+
+						//barycentric weights change linearly across x
+						const auto stepA = -(c.y - b.y) * triangle.inverseArea;
+						const auto stepB = -(a.y - c.y) * triangle.inverseArea;
+						const auto stepC = -(b.y - a.y) * triangle.inverseArea;
+
+						const auto minY = max(triangle.minY, bandMinY);
+						const auto maxY = min(triangle.maxY, bandMaxY);
+						for (int y = minY; y <= maxY; y++) {
+							auto depthRow = depthMap.depth.ptr<float>(y);
+							auto positionRow = depthMap.position.ptr<cv::Vec3f>(y);
+							auto normalRow = depthMap.normal.ptr<cv::Vec3f>(y);
+							auto colorRow = depthMap.color.ptr<cv::Vec4f>(y);
+
+							const auto pixelX = (float)triangle.minX + 0.5f;
+							const auto pixelY = (float)y + 0.5f;
+							auto weightA = ((c.x - b.x) * (pixelY - b.y) - (c.y - b.y) * (pixelX - b.x)) * triangle.inverseArea;
+							auto weightB = ((a.x - c.x) * (pixelY - c.y) - (a.y - c.y) * (pixelX - c.x)) * triangle.inverseArea;
+							auto weightC = ((b.x - a.x) * (pixelY - a.y) - (b.y - a.y) * (pixelX - a.x)) * triangle.inverseArea;
+
+							for (int x = triangle.minX; x <= triangle.maxX; x++, weightA += stepA, weightB += stepB, weightC += stepC) {
+								if (weightA < 0.0f || weightB < 0.0f || weightC < 0.0f) {
+									continue;
+								}
+
+								//depth is linear in screen space
+								auto z = weightA * a.z + weightB * b.z + weightC * c.z;
+								if (z < 0.0f || z > 1.0f || z >= depthRow[x]) {
+									continue;
+								}
+								depthRow[x] = z;
+
+								//attributes are perspective correct
+								auto perspectiveA = weightA * a.inverseW;
+								auto perspectiveB = weightB * b.inverseW;
+								auto perspectiveC = weightC * c.inverseW;
+								auto normalization = 1.0f / (perspectiveA + perspectiveB + perspectiveC);
+								perspectiveA *= normalization;
+								perspectiveB *= normalization;
+								perspectiveC *= normalization;
+
+								auto position = vertices[triangle.indices[0]] * perspectiveA
+									+ vertices[triangle.indices[1]] * perspectiveB
+									+ vertices[triangle.indices[2]] * perspectiveC;
+								positionRow[x] = cv::Vec3f(position.x, position.y, position.z);
+
+								auto normal = triangle.faceNormal;
+								if (hasNormals) {
+									auto interpolatedNormal = normals[triangle.indices[0]] * perspectiveA
+										+ normals[triangle.indices[1]] * perspectiveB
+										+ normals[triangle.indices[2]] * perspectiveC;
+									auto length = interpolatedNormal.length();
+									if (length > 1e-6f) {
+										normal = interpolatedNormal / length;
+									}
+								}
+								normalRow[x] = cv::Vec3f(normal.x, normal.y, normal.z);
+
+								//as the Color pass, which draws the scene unlit
+								ofFloatColor color = ofFloatColor::white;
+								if (hasColors) {
+									const auto & colorA = colors[triangle.indices[0]];
+									const auto & colorB = colors[triangle.indices[1]];
+									const auto & colorC = colors[triangle.indices[2]];
+									color.set(colorA.r * perspectiveA + colorB.r * perspectiveB + colorC.r * perspectiveC
+										, colorA.g * perspectiveA + colorB.g * perspectiveB + colorC.g * perspectiveC
+										, colorA.b * perspectiveA + colorB.b * perspectiveB + colorC.b * perspectiveC
+										, colorA.a * perspectiveA + colorB.a * perspectiveB + colorC.a * perspectiveC);
+								}
+								if (hasTexture) {
+									auto texCoord = texCoords[triangle.indices[0]] * perspectiveA
+										+ texCoords[triangle.indices[1]] * perspectiveB
+										+ texCoords[triangle.indices[2]] * perspectiveC;
+									auto texel = sampleBilinear(texture, texCoord.x, texCoord.y);
+									color.set(color.r * texel.r, color.g * texel.g, color.b * texel.b, color.a * texel.a);
+								}
+								colorRow[x] = cv::Vec4f(color.r, color.g, color.b, color.a);
+							}
+						}
+					}
+				});
+			}
+
+			//----------
+			void CPURenderer::renderAvailability(const DepthMap & viewDepth
+				, const View & projector
+				, const DepthMap & projectorDepth
+				, const Settings & settings
+				, cv::Mat & availability) {
+				const auto width = viewDepth.depth.cols;
+				const auto height = viewDepth.depth.rows;
+
+				availability.create(height, width, CV_32F);
+				availability.setTo(0.0f);
+
+				if (projectorDepth.depth.empty()) {
+					return;
+				}
+
+				const auto matrix = projector.viewProjection.getPtr();
+				const auto normalCutoff = cos(settings.normalCutoffAngle * DEG_TO_RAD);
+				const auto featherSize = settings.featherSize;
+				const auto projectorWidth = (float)projector.width;
+				const auto projectorHeight = (float)projector.height;
+
+				Utils::parallelFor((size_t)height, [&](size_t y) {
+					auto depthRow = viewDepth.depth.ptr<float>((int)y);
+					auto positionRow = viewDepth.position.ptr<cv::Vec3f>((int)y);
+					auto normalRow = viewDepth.normal.ptr<cv::Vec3f>((int)y);
+					auto outputRow = availability.ptr<float>((int)y);
+
+					for (int x = 0; x < width; x++) {
+						if (depthRow[x] >= 1.0f) {
+							continue;
+						}
+
+						const auto & positionRaw = positionRow[x];
+						const ofVec3f position(positionRaw[0], positionRaw[1], positionRaw[2]);
+
+						auto clip = transform(matrix, position);
+						if (clip.w <= 0.0f) {
+							continue;
+						}
+						const ofVec3f positionProjector(clip.x / clip.w, clip.y / clip.w, clip.z / clip.w);
+
+						//projector edges
+						if (abs(positionProjector.x) >= 1.0f
+							|| abs(positionProjector.y) >= 1.0f
+							|| abs(positionProjector.z) >= 1.0f) {
+							continue;
+						}
+
+						//brightness
+						auto factor = projector.brightness;
+
+						//feather
+						{
+							auto featherPosition = max(abs(positionProjector.x), abs(positionProjector.y));
+							factor *= smoothStep(0.0f, featherSize, 1.0f - featherPosition);
+						}
+
+						//distance
+						auto lookVector = position - projector.position;
+						{
+							auto distanceSquared = lookVector.lengthSquared();
+							factor /= distanceSquared;
+						}
+
+						//shadow
+						{
+							auto depthLookup = sampleBilinear(projectorDepth.depth
+								, (positionProjector.x + 1.0f) / 2.0f * projectorWidth
+								, (positionProjector.y + 1.0f) / 2.0f * projectorHeight);
+							auto depthProjected = (positionProjector.z + 1.0f) / 2.0f;
+							if (abs(depthProjected - depthLookup) >= ShadowBias) {
+								continue;
+							}
+						}
+
+						//normals
+						{
+							const auto & normal = normalRow[x];
+							lookVector.normalize();
+							auto normalFactor = ofClamp(-(lookVector.x * normal[0] + lookVector.y * normal[1] + lookVector.z * normal[2]), 0.0f, 1.0f);
+							if (normalFactor < normalCutoff) {
+								continue;
+							}
+							factor *= normalFactor;
+						}
+
+						outputRow[x] = ofClamp(factor, 0.0f, 1.0f);
+					}
+				});
+			}
+
+			//----------
+			void CPURenderer::renderBrightnessAssignmentMap(const cv::Mat & availabilitySelf
+				, const cv::Mat & availabilityAll
+				, const Settings & settings
+				, cv::Mat & brightnessAssignmentMap) {
+				const auto width = availabilitySelf.cols;
+				const auto height = availabilitySelf.rows;
+				if (availabilityAll.cols != width || availabilityAll.rows != height) {
+					throw(ofxRulr::Exception("Availability maps must be the same size"));
+				}
+
+				brightnessAssignmentMap.create(height, width, CV_32F);
+
+				//feather position is max(|x|, |y|) in normalised coordinates, so cache |x| per column
+				vector<float> columnPosition(width);
+				for (int x = 0; x < width; x++) {
+					columnPosition[x] = abs(((float)x + 0.5f) / (float)width * 2.0f - 1.0f);
+				}
+
+				const auto inverseFeatherSize = 1.0f / max(settings.featherSize, 1e-6f);
+				const auto targetBrightness = settings.targetBrightness;
+				const auto maskThreshold = 1e-7f;
+
+				Utils::parallelFor((size_t)height, [&](size_t y) {
+					const auto rowPosition = abs(((float)y + 0.5f) / (float)height * 2.0f - 1.0f);
+					auto selfRow = availabilitySelf.ptr<float>((int)y);
+					auto allRow = availabilityAll.ptr<float>((int)y);
+					auto outputRow = brightnessAssignmentMap.ptr<float>((int)y);
+
+					int x = 0;
+#ifdef RULR_BAM_SSE2
+					{
+						const auto zero = _mm_setzero_ps();
+						const auto one = _mm_set1_ps(1.0f);
+						const auto two = _mm_set1_ps(2.0f);
+						const auto three = _mm_set1_ps(3.0f);
+						const auto inverseFeatherSize4 = _mm_set1_ps(inverseFeatherSize);
+						const auto targetBrightness4 = _mm_set1_ps(targetBrightness);
+						const auto maskThreshold4 = _mm_set1_ps(maskThreshold);
+						const auto rowPosition4 = _mm_set1_ps(rowPosition);
+
+						for (; x + 4 <= width; x += 4) {
+							//feather (smoothstep)
+							auto featherPosition = _mm_max_ps(_mm_loadu_ps(columnPosition.data() + x), rowPosition4);
+							auto t = _mm_mul_ps(_mm_sub_ps(one, featherPosition), inverseFeatherSize4);
+							t = _mm_min_ps(_mm_max_ps(t, zero), one);
+							auto factor = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(three, _mm_mul_ps(two, t)));
+
+							//inverse of total availability
+							factor = _mm_div_ps(_mm_mul_ps(factor, targetBrightness4), _mm_loadu_ps(allRow + x));
+
+							//mask where we can't project (this also removes the NaN / inf where nothing is available)
+							factor = _mm_and_ps(factor, _mm_cmpge_ps(_mm_loadu_ps(selfRow + x), maskThreshold4));
+
+							_mm_storeu_ps(outputRow + x, factor);
+						}
+					}
+#endif
+					for (; x < width; x++) {
+						if (selfRow[x] < maskThreshold) {
+							outputRow[x] = 0.0f;
+							continue;
+						}
+						auto featherPosition = max(columnPosition[x], rowPosition);
+						auto factor = smoothStep(0.0f, 1.0f, (1.0f - featherPosition) * inverseFeatherSize);
+						outputRow[x] = factor * targetBrightness / allRow[x];
+					}
+				});
+			}
+
+			//----------
+			CPURenderer::View CPURenderer::getView(const ofxRay::Camera & camera, float brightness) {
+				View view;
+				view.viewProjection = camera.getViewMatrix() * camera.getClippedProjectionMatrix();
+				view.position = camera.getPosition();
+				view.width = (int)camera.getWidth();
+				view.height = (int)camera.getHeight();
+				view.brightness = brightness;
+				return view;
+			}
+		}
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ofxRulr.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace BAM {
+			///Software implementation of the BAM passes which doesn't need a GL context.
+			///Maps are stored bottom row first (i.e. the same layout as the GL textures) so that
+			///results can be compared directly with the shader passes.
+			class CPURenderer {
+			public:
+				struct View {
+					ofMatrix4x4 viewProjection; // world to clip space
+					ofVec3f position;
+					int width = 0;
+					int height = 0;
+					float brightness = 1.0f;
+				};
+
+				struct Settings {
+					float normalCutoffAngle = 80.0f; // degrees
+					float featherSize = 0.2f;
+					float targetBrightness = 0.8f;
+				};
+
+				struct DepthMap {
+					cv::Mat depth; // CV_32F, window space [0, 1], 1 where nothing was drawn
+					cv::Mat position; // CV_32FC3, world space
+					cv::Mat normal; // CV_32FC3, world space
+					cv::Mat color; // CV_32FC4, unlit vertex color * texture (as the Color pass), 0 where nothing was drawn
+				};
+
+				///Rasterise a triangle mesh (vertices and normals in world space) from the view.
+				///Vertex colors and the texture (sampled with the mesh's texture coordinates) are used if present.
+				static void renderDepth(const ofMesh &, const View &, DepthMap &, const ofPixels & texture = ofPixels());
+
+				///Availability of the projector at each pixel of the view (as the AvailabilityProjection shader)
+				static void renderAvailability(const DepthMap & viewDepth
+					, const View & projector
+					, const DepthMap & projectorDepth
+					, const Settings &
+					, cv::Mat & availability);
+
+				///As the BrightnessAssignmentMap shader
+				static void renderBrightnessAssignmentMap(const cv::Mat & availabilitySelf
+					, const cv::Mat & availabilityAll
+					, const Settings &
+					, cv::Mat & brightnessAssignmentMap);
+
+				static View getView(const ofxRay::Camera &, float brightness);
+			};
+		}
+	}
+}
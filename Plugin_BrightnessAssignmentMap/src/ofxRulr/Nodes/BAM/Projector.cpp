@@ -18,7 +18,7 @@ namespace ofxRulr {
 			cv::Mat Pass::getHistogram(cv::Mat histogram) {
 				//read image
 				ofFloatPixels floatPixels;
-				this->fbo->readToPixels(floatPixels);
+				this->readToPixels(floatPixels);
 				
 				const int histogramSize = 32;
 				float ranges[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31 };
@@ -58,6 +58,26 @@ namespace ofxRulr {
 				return histogram;
 			}
 
+			//----------
+			void Pass::readToPixels(ofFloatPixels & pixels) {
+				if (this->cpuResult.isAllocated()) {
+					pixels = this->cpuResult;
+				}
+				else {
+					this->fbo->getTexture().readToPixels(pixels);
+				}
+			}
+
+			//----------
+			cv::Mat Pass::allocateCPUResult(int width, int height, int channels) {
+				if (this->cpuResult.getWidth() != width
+					|| this->cpuResult.getHeight() != height
+					|| this->cpuResult.getNumChannels() != channels) {
+					this->cpuResult.allocate(width, height, channels);
+				}
+				return ofxCv::toCv(this->cpuResult);
+			}
+
 			//----------
 			string Pass::toString(Level level) {
 				switch (level) {
@@ -159,6 +179,10 @@ namespace ofxRulr {
 							panel->addToolBarElement("ofxCvGui::save", [this, passLevel] {
 								this->exportPass(passLevel);
 							});
+							panel->onUpdate += [this, passLevel](ofxCvGui::UpdateArguments &) {
+								//results from the CPU backend only go to the GPU when they're previewed
+								this->uploadCPUResult(this->passes[passLevel]);
+							};
 						}
 					}
 				}
@@ -168,7 +192,10 @@ namespace ofxRulr {
 			//----------
 			void Projector::update() {
 				if (this->parameters.autoRender) {
-					this->render(Pass::Level::End);
+					try {
+						this->render(Pass::Level::End);
+					}
+					RULR_CATCH_ALL_TO_ERROR;
 				}
 			}
 
@@ -204,6 +231,11 @@ namespace ofxRulr {
 
 			//----------
 			void Projector::render(Pass::Level requiredPass) {
+				if (this->parameters.backend.get() == Backend::CPU) {
+					this->renderCPU(requiredPass);
+					return;
+				}
+
 				auto projector = this->getInput<Item::Projector>();
 				auto world = this->getInput<World>();
 				auto frameIndex = ofGetFrameNum();
@@ -409,6 +441,8 @@ namespace ofxRulr {
 								}
 								pass.fbo->end();
 
+								pass.cpuResult.clear();
+								pass.cpuResultUploaded = true;
 								pass.renderedFrameIndex = currentFrameIndex;
 							}
 						}
@@ -421,6 +455,29 @@ namespace ofxRulr {
 				return this->parameters.brightness;
 			}
 
+			//---------
+			const CPURenderer::DepthMap & Projector::getDepthMap() {
+				auto currentFrameIndex = ofGetFrameNum();
+				if (this->depthMapFrameIndex != currentFrameIndex) {
+					auto world = this->getInput<World>();
+					if (!world) {
+						throw(ofxRulr::Exception("No BAM::World connected to BAM::Projector"));
+					}
+					CPURenderer::renderDepth(world->getSceneMesh(), this->getCPUView(), this->depthMap, world->getSceneTexture());
+					this->depthMapFrameIndex = currentFrameIndex;
+				}
+				return this->depthMap;
+			}
+
+			//---------
+			CPURenderer::View Projector::getCPUView() const {
+				auto projector = this->getInput<Item::Projector>();
+				if (!projector) {
+					throw(ofxRulr::Exception("No Item::Projector connected to BAM::Projector"));
+				}
+				return CPURenderer::getView(projector->getViewInWorldSpace(), this->getBrightness());
+			}
+
 			//---------
 			void Projector::exportPass(Pass::Level passLevel, string filename /*= ""*/) {
 				if (filename.empty()) {
@@ -435,7 +492,7 @@ namespace ofxRulr {
 				//read the data from the pass
 				auto & pass = this->getPass(passLevel, true);
 				ofFloatPixels floatPixels;
-				pass.fbo->getTexture().readToPixels(floatPixels);
+				pass.readToPixels(floatPixels);
 				
 				auto extension = ofFilePath::getFileExt(filename);
 				if (extension == "exr" || extension == "hdr") {
@@ -490,7 +547,7 @@ namespace ofxRulr {
 							shader.setUniformMatrix4f("projectorVP0"
 								, viewOtherProjector.getViewMatrix() * viewOtherProjector.getClippedProjectionMatrix());
 							shader.setUniform2f("projectorResolution0", ofVec2f(viewOtherProjector.getWidth(), viewOtherProjector.getHeight()));
-							shader.setUniform3f("projectorPosition0", view.getPosition());
+							shader.setUniform3f("projectorPosition0", viewOtherProjector.getPosition());
 							shader.setUniform1f("projectorBrightness0", projector->getBrightness());
 
 							{
@@ -516,6 +573,133 @@ namespace ofxRulr {
 				}
 				view.endAsCamera();
 			}
+
+			//---------
+			void Projector::renderCPU(Pass::Level requiredPass) {
+				auto world = this->getInput<World>();
+				if (!world || !this->getInput<Item::Projector>()) {
+					return;
+				}
+
+				const auto settings = world->getCPURendererSettings();
+				const auto currentFrameIndex = ofGetFrameNum();
+
+				for (uint8_t i = 0; i <= requiredPass; i++) {
+					auto findPass = this->passes.find((Pass::Level) i);
+					if (findPass == this->passes.end()) {
+						continue;
+					}
+					auto & pass = findPass->second;
+					if (pass.renderedFrameIndex == currentFrameIndex) {
+						continue;
+					}
+
+					switch (i) {
+					case Pass::Level::Color:
+					{
+						const auto & depthMap = this->getDepthMap();
+						auto result = pass.allocateCPUResult(depthMap.depth.cols, depthMap.depth.rows, 4);
+						depthMap.color.copyTo(result);
+						break;
+					}
+					case Pass::Level::DepthPreview:
+					{
+						//as the DepthPreview shader
+						const auto & depthMap = this->getDepthMap();
+						auto result = pass.allocateCPUResult(depthMap.depth.cols, depthMap.depth.rows, 4);
+						for (int y = 0; y < depthMap.depth.rows; y++) {
+							auto depthRow = depthMap.depth.ptr<float>(y);
+							auto outputRow = result.ptr<cv::Vec4f>(y);
+							for (int x = 0; x < depthMap.depth.cols; x++) {
+								const auto & depth = depthRow[x];
+								outputRow[x] = cv::Vec4f((cos(depth * 100.0f) + 1.0f) / 2.0f
+									, (cos(depth * 1000.0f) + 1.0f) / 2.0f
+									, (cos(depth * 10000.0f) + 1.0f) / 2.0f
+									, depth == 1.0f ? 0.0f : 1.0f);
+							}
+						}
+						break;
+					}
+					case Pass::Level::AvailabilityProjection:
+					{
+						const auto & depthMap = this->getDepthMap();
+						auto result = pass.allocateCPUResult(depthMap.depth.cols, depthMap.depth.rows, 1);
+						CPURenderer::renderAvailability(depthMap
+							, this->getCPUView()
+							, depthMap
+							, settings
+							, result);
+						break;
+					}
+					case Pass::Level::AccumulateAvailability:
+					{
+						const auto & depthMap = this->getDepthMap();
+						auto thisProjector = static_pointer_cast<Projector>(shared_from_this());
+
+						auto result = pass.allocateCPUResult(depthMap.depth.cols, depthMap.depth.rows, 1);
+						result.setTo(0.0f);
+						cv::Mat availabilityFromOtherProjector;
+						for (auto otherProjector : world->getProjectors()) {
+							if (otherProjector == thisProjector) {
+								//we calculated this in the previous pass
+								result += ofxCv::toCv(this->passes[Pass::Level::AvailabilityProjection].cpuResult);
+								continue;
+							}
+							if (!otherProjector->getInput<Item::Projector>()) {
+								continue;
+							}
+
+							CPURenderer::renderAvailability(depthMap
+								, otherProjector->getCPUView()
+								, otherProjector->getDepthMap()
+								, settings
+								, availabilityFromOtherProjector);
+							result += availabilityFromOtherProjector;
+						}
+						break;
+					}
+					case Pass::Level::BrightnessAssignmentMap:
+					{
+						auto & availabilitySelf = this->passes[Pass::Level::AvailabilityProjection].cpuResult;
+						auto & availabilityAll = this->passes[Pass::Level::AccumulateAvailability].cpuResult;
+						auto result = pass.allocateCPUResult((int) availabilitySelf.getWidth(), (int) availabilitySelf.getHeight(), 1);
+						CPURenderer::renderBrightnessAssignmentMap(ofxCv::toCv(availabilitySelf)
+							, ofxCv::toCv(availabilityAll)
+							, settings
+							, result);
+						break;
+					}
+					default:
+						break;
+					}
+
+					pass.cpuResultUploaded = false;
+					pass.renderedFrameIndex = currentFrameIndex;
+				}
+			}
+
+			//---------
+			void Projector::uploadCPUResult(Pass & pass) {
+				if (pass.cpuResultUploaded || !pass.cpuResult.isAllocated()) {
+					return;
+				}
+
+				const auto width = (int) pass.cpuResult.getWidth();
+				const auto height = (int) pass.cpuResult.getHeight();
+				if (pass.fbo->getWidth() != width
+					|| pass.fbo->getHeight() != height) {
+					ofFbo::Settings fboSettings = pass.settings;
+					fboSettings.width = width;
+					fboSettings.height = height;
+					pass.fbo->allocate(fboSettings);
+				}
+
+				pass.fbo->getTexture().loadData(pass.cpuResult.getData()
+					, width
+					, height
+					, pass.cpuResult.getNumChannels() == 4 ? GL_RGBA : GL_RED);
+				pass.cpuResultUploaded = true;
+			}
 		}
 	}
 }
\ No newline at end of file
@@ -2,10 +2,15 @@
 
 #include "ofxRulr.h"
 #include "Projector.h"
+#include "CPURenderer.h"
 
 namespace ofxRulr {
 	namespace Nodes {
 		namespace BAM {
+			MAKE_ENUM(Backend
+				, (GPU, CPU)
+				, ("GPU", "CPU"));
+
 			struct Pass {
 				enum Level : uint8_t {
 					None = 0,
@@ -23,9 +28,15 @@ namespace ofxRulr {
 				Pass(ofFbo::Settings settings);
 
 				cv::Mat getHistogram(cv::Mat existingHistogram = cv::Mat());
+				void readToPixels(ofFloatPixels &);
+
+				///Allocates cpuResult if needed, returning a header onto its data for the CPU renderer to write into
+				cv::Mat allocateCPUResult(int width, int height, int channels);
 
 				shared_ptr<ofFbo> fbo;
 				ofFbo::Settings settings;
+				ofFloatPixels cpuResult; // unallocated unless rendered by the CPU backend
+				bool cpuResultUploaded = true; // false until cpuResult is in the fbo (uploaded when a preview needs it)
 				uint64_t renderedFrameIndex = numeric_limits<uint64_t>::max();
 
 				static string toString(Level);
@@ -48,17 +59,27 @@ namespace ofxRulr {
 
 				float getBrightness() const;
 
+				///Depth map for the CPU backend, rendered at most once per frame
+				const CPURenderer::DepthMap & getDepthMap();
+				CPURenderer::View getCPUView() const;
+
 				void exportPass(Pass::Level, string filename = "");
 			protected:
 				void renderAvailability(shared_ptr<Projector>, shared_ptr<World>, ofxRay::Camera & view, shared_ptr<Nodes::Base> scene);
+				void renderCPU(Pass::Level requiredPass);
+				void uploadCPUResult(Pass &);
 				ofxCvGui::PanelGroupPtr panelGroup;
 
 				Passes passes;
 
+				CPURenderer::DepthMap depthMap;
+				uint64_t depthMapFrameIndex = numeric_limits<uint64_t>::max();
+
 				struct : ofParameterGroup {
 					ofParameter<float> brightness{ "Brightness", 1, 0, 10 };
 					ofParameter<bool> autoRender{ "Auto render", true };
-					PARAM_DECLARE("Projector", brightness, autoRender);
+					ofParameter<Backend> backend{ "Backend", Backend::GPU };
+					PARAM_DECLARE("Projector", brightness, autoRender, backend);
 				} parameters;
 			};
 		}
@@ -0,0 +1,432 @@
+#include "pch_Plugin_BrightnessAssignmentMap.h"
+#include "BenchmarkCPURenderer.h"
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace BAM {
+			namespace Test {
+				//----------
+				BenchmarkCPURenderer::BenchmarkCPURenderer() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string BenchmarkCPURenderer::getTypeName() const {
+					return "BAM::Test::BenchmarkCPURenderer";
+				}
+
+				//----------
+				void BenchmarkCPURenderer::init() {
+					RULR_NODE_INSPECTOR_LISTENER;
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void BenchmarkCPURenderer::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					inspector->addTitle("Result", ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<string>("Configuration", [this]() {
+						return this->result.configuration;
+					});
+					inspector->addLiveValue<float>("Depth [ms]", [this]() {
+						return this->result.depthDuration;
+					});
+					inspector->addLiveValue<float>("Availability [ms]", [this]() {
+						return this->result.availabilityDuration;
+					});
+					inspector->addLiveValue<float>("Brightness assignment map [ms]", [this]() {
+						return this->result.brightnessAssignmentMapDuration;
+					});
+					inspector->addLiveValue<float>("Throughput [Mpx/s]", [this]() {
+						return this->result.megaPixelsPerSecond;
+					});
+					inspector->addLiveValue<string>("Shader passes", [this]() {
+						return this->result.shaderComparison;
+					});
+					inspector->addLiveValue<float>("Maximum error", [this]() {
+						return this->result.maximumError;
+					});
+					inspector->addLiveValue<int>("Mismatched pixels", [this]() {
+						return this->result.mismatchedPixels;
+					});
+				}
+
+				//----------
+				void BenchmarkCPURenderer::serializeResult(Json::Value & json) const {
+					json["configuration"] = this->result.configuration;
+					json["depthDuration"] = this->result.depthDuration;
+					json["availabilityDuration"] = this->result.availabilityDuration;
+					json["brightnessAssignmentMapDuration"] = this->result.brightnessAssignmentMapDuration;
+					json["megaPixelsPerSecond"] = this->result.megaPixelsPerSecond;
+					json["shaderComparison"] = this->result.shaderComparison;
+					json["maximumError"] = this->result.maximumError;
+					json["mismatchedPixels"] = this->result.mismatchedPixels;
+				}
+
+				//----------
+				void BenchmarkCPURenderer::runBenchmark() {
+					Utils::ScopedProcess scopedProcess("Benchmark BAM CPU renderer", false);
+
+					const auto mesh = this->makeScene();
+					const auto views = this->makeViews();
+					const auto iterations = (size_t) this->parameters.iterations.get();
+
+					CPURenderer::Settings settings;
+
+					Result result;
+					result.configuration = ofToString(views.size()) + " projectors x "
+						+ ofToString(this->parameters.width.get()) + "x" + ofToString(this->parameters.height.get()) + ", "
+						+ ofToString(mesh.getNumIndices() / 3) + " triangles";
+
+					vector<Output> outputs(views.size());
+					cv::Mat availability;
+
+					chrono::duration<float, milli> depthDuration(0);
+					chrono::duration<float, milli> availabilityDuration(0);
+					chrono::duration<float, milli> brightnessAssignmentMapDuration(0);
+
+					for (size_t iteration = 0; iteration < iterations; iteration++) {
+						auto timeStart = chrono::high_resolution_clock::now();
+						for (size_t i = 0; i < views.size(); i++) {
+							CPURenderer::renderDepth(mesh, views[i], outputs[i].depthMap);
+						}
+
+						auto timeDepth = chrono::high_resolution_clock::now();
+						for (size_t i = 0; i < views.size(); i++) {
+							auto & output = outputs[i];
+							output.availabilityAll = cv::Mat::zeros(output.depthMap.depth.size(), CV_32F);
+							for (size_t j = 0; j < views.size(); j++) {
+								CPURenderer::renderAvailability(output.depthMap
+									, views[j]
+									, outputs[j].depthMap
+									, settings
+									, availability);
+								if (i == j) {
+									output.availabilitySelf = availability.clone();
+								}
+								output.availabilityAll += availability;
+							}
+						}
+
+						auto timeAvailability = chrono::high_resolution_clock::now();
+						for (auto & output : outputs) {
+							CPURenderer::renderBrightnessAssignmentMap(output.availabilitySelf
+								, output.availabilityAll
+								, settings
+								, output.brightnessAssignmentMap);
+						}
+
+						auto timeEnd = chrono::high_resolution_clock::now();
+						depthDuration += timeDepth - timeStart;
+						availabilityDuration += timeAvailability - timeDepth;
+						brightnessAssignmentMapDuration += timeEnd - timeAvailability;
+					}
+
+					result.depthDuration = depthDuration.count() / (float)iterations;
+					result.availabilityDuration = availabilityDuration.count() / (float)iterations;
+					result.brightnessAssignmentMapDuration = brightnessAssignmentMapDuration.count() / (float)iterations;
+
+					const auto totalDuration = result.depthDuration + result.availabilityDuration + result.brightnessAssignmentMapDuration;
+					const auto pixelCount = (float)(this->parameters.width.get() * this->parameters.height.get()) * (float)views.size();
+					result.megaPixelsPerSecond = totalDuration > 0.0f
+						? pixelCount / (totalDuration / 1000.0f) / 1e6f
+						: 0.0f;
+
+					//compare against the shader passes
+					if (!ofGetGLRenderer()) {
+						result.shaderComparison = "No GL context";
+					}
+					else {
+						size_t failedCount = 0;
+						const auto tolerance = this->parameters.tolerance.get();
+
+						auto images = this->getImages(outputs);
+						auto shaderImages = this->getImages(this->renderWithShaders(mesh, views, settings));
+						for (const auto & image : images) {
+							const auto & shaderImage = shaderImages[image.first];
+							if (shaderImage.size() != image.second.size() || shaderImage.channels() != image.second.channels()) {
+								failedCount++;
+								continue;
+							}
+
+							bool failed = false;
+							const auto valueCount = image.second.cols * image.second.channels();
+							for (int y = 0; y < image.second.rows; y++) {
+								auto rowShader = shaderImage.ptr<float>(y);
+								auto row = image.second.ptr<float>(y);
+								for (int x = 0; x < valueCount; x++) {
+									//relative error where the values are large (e.g. the inverse of dim availability)
+									auto error = abs(row[x] - rowShader[x]) / max(1.0f, abs(rowShader[x]));
+									if (!(error <= tolerance)) {
+										result.mismatchedPixels++;
+										failed = true;
+									}
+									if (error == error) {
+										result.maximumError = max(result.maximumError, error);
+									}
+								}
+							}
+							if (failed) {
+								failedCount++;
+							}
+						}
+
+						result.shaderComparison = ofToString(images.size() - failedCount) + " / " + ofToString(images.size()) + " match";
+					}
+
+					this->result = result;
+
+					ofLogNotice("BAM::Test::BenchmarkCPURenderer") << result.configuration << " : "
+						<< result.depthDuration << "ms depth, "
+						<< result.availabilityDuration << "ms availability, "
+						<< result.brightnessAssignmentMapDuration << "ms BAM, "
+						<< result.megaPixelsPerSecond << "Mpx/s. Shader passes : " << result.shaderComparison;
+
+					scopedProcess.end();
+				}
+
+				//----------
+				ofMesh BenchmarkCPURenderer::makeScene() const {
+					//a room with a box in the middle
+					ofMesh mesh;
+					mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+
+					const auto subdivisions = this->parameters.subdivisions.get();
+					auto addQuad = [&mesh](const ofVec3f & center, const ofVec3f & halfU, const ofVec3f & halfV, int subdivisions) {
+						auto normal = halfU.getCrossed(halfV).getNormalized();
+						auto indexOffset = (ofIndexType)mesh.getNumVertices();
+						for (int j = 0; j <= subdivisions; j++) {
+							for (int i = 0; i <= subdivisions; i++) {
+								auto u = (float)i / (float)subdivisions * 2.0f - 1.0f;
+								auto v = (float)j / (float)subdivisions * 2.0f - 1.0f;
+								mesh.addVertex(center + halfU * u + halfV * v);
+								mesh.addNormal(normal);
+							}
+						}
+						for (int j = 0; j < subdivisions; j++) {
+							for (int i = 0; i < subdivisions; i++) {
+								auto a = indexOffset + (ofIndexType)(j * (subdivisions + 1) + i);
+								auto b = a + 1;
+								auto c = a + (ofIndexType)(subdivisions + 1);
+								auto d = c + 1;
+								mesh.addTriangle(a, b, d);
+								mesh.addTriangle(a, d, c);
+							}
+						}
+					};
+
+					//floor, back wall and side walls (normals facing in)
+					addQuad(ofVec3f(0, 0, 0), ofVec3f(0, 0, 3), ofVec3f(3, 0, 0), subdivisions);
+					addQuad(ofVec3f(0, 1.5f, -3), ofVec3f(3, 0, 0), ofVec3f(0, 1.5f, 0), subdivisions);
+					addQuad(ofVec3f(-3, 1.5f, 0), ofVec3f(0, 1.5f, 0), ofVec3f(0, 0, 3), subdivisions);
+					addQuad(ofVec3f(3, 1.5f, 0), ofVec3f(0, 0, 3), ofVec3f(0, 1.5f, 0), subdivisions);
+
+					//box (normals facing out)
+					const auto boxSubdivisions = max(subdivisions / 4, 1);
+					addQuad(ofVec3f(0, 1.0f, 0), ofVec3f(0, 0, 0.5f), ofVec3f(0.5f, 0, 0), boxSubdivisions);
+					addQuad(ofVec3f(0, 0.5f, 0.5f), ofVec3f(0.5f, 0, 0), ofVec3f(0, 0.5f, 0), boxSubdivisions);
+					addQuad(ofVec3f(0, 0.5f, -0.5f), ofVec3f(0, 0.5f, 0), ofVec3f(0.5f, 0, 0), boxSubdivisions);
+					addQuad(ofVec3f(0.5f, 0.5f, 0), ofVec3f(0, 0, -0.5f), ofVec3f(0, 0.5f, 0), boxSubdivisions);
+					addQuad(ofVec3f(-0.5f, 0.5f, 0), ofVec3f(0, 0.5f, 0), ofVec3f(0, 0, -0.5f), boxSubdivisions);
+
+					return mesh;
+				}
+
+				//----------
+				vector<CPURenderer::View> BenchmarkCPURenderer::makeViews() const {
+					//projectors on an arc in front of the box, all looking at it
+					const auto projectorCount = this->parameters.projectorCount.get();
+					const auto width = this->parameters.width.get();
+					const auto height = this->parameters.height.get();
+
+					vector<CPURenderer::View> views;
+					for (int i = 0; i < projectorCount; i++) {
+						auto angle = projectorCount > 1
+							? ofMap(i, 0, projectorCount - 1, -60.0f, 60.0f) * DEG_TO_RAD
+							: 0.0f;
+						ofVec3f position(sin(angle) * 2.5f, 2.5f, cos(angle) * 2.5f);
+
+						ofMatrix4x4 viewMatrix;
+						viewMatrix.makeLookAtViewMatrix(position, ofVec3f(0, 0.5f, 0), ofVec3f(0, 1, 0));
+						ofMatrix4x4 projectionMatrix;
+						projectionMatrix.makePerspectiveMatrix(60.0f, (float)width / (float)height, 0.1f, 20.0f);
+
+						CPURenderer::View view;
+						view.viewProjection = viewMatrix * projectionMatrix;
+						view.position = position;
+						view.width = width;
+						view.height = height;
+						views.push_back(view);
+					}
+					return views;
+				}
+
+				//----------
+				map<string, cv::Mat> BenchmarkCPURenderer::getImages(const vector<Output> & outputs) const {
+					map<string, cv::Mat> images;
+					for (size_t i = 0; i < outputs.size(); i++) {
+						const auto & output = outputs[i];
+						auto prefix = "Projector" + ofToString(i) + "-";
+						images[prefix + "Depth"] = output.depthMap.depth;
+						images[prefix + Pass::toString(Pass::Level::AvailabilityProjection)] = output.availabilitySelf;
+						images[prefix + Pass::toString(Pass::Level::AccumulateAvailability)] = output.availabilityAll;
+						images[prefix + Pass::toString(Pass::Level::BrightnessAssignmentMap)] = output.brightnessAssignmentMap;
+					}
+					return images;
+				}
+
+				//----------
+				vector<BenchmarkCPURenderer::Output> BenchmarkCPURenderer::renderWithShaders(const ofMesh & mesh
+					, const vector<CPURenderer::View> & views
+					, const CPURenderer::Settings & settings) const {
+					const auto width = this->parameters.width.get();
+					const auto height = this->parameters.height.get();
+
+					//as BAM::Projector's fbo settings
+					ofFbo::Settings depthSettings;
+					{
+						depthSettings.width = width;
+						depthSettings.height = height;
+						depthSettings.useDepth = true;
+						depthSettings.depthStencilAsTexture = true;
+						depthSettings.internalformat = GL_RGBA;
+						depthSettings.depthStencilInternalFormat = GL_DEPTH_COMPONENT32;
+					}
+					auto availabilitySettings = depthSettings;
+					availabilitySettings.internalformat = GL_R32F;
+					ofFbo::Settings brightnessAssignmentMapSettings;
+					{
+						brightnessAssignmentMapSettings.width = width;
+						brightnessAssignmentMapSettings.height = height;
+						brightnessAssignmentMapSettings.useDepth = false;
+						brightnessAssignmentMapSettings.internalformat = GL_R32F;
+					}
+
+					//the scene is already in world space, so the view projection is all we need
+					auto drawFromView = [](const CPURenderer::View & view, const function<void()> & draw) {
+						ofPushView();
+						{
+							ofSetMatrixMode(OF_MATRIX_PROJECTION);
+							ofLoadMatrix(view.viewProjection);
+							ofSetMatrixMode(OF_MATRIX_MODELVIEW);
+							ofLoadIdentityMatrix();
+
+							ofxRulr::Utils::Graphics::glEnable(GL_DEPTH_TEST);
+							{
+								draw();
+							}
+							ofxRulr::Utils::Graphics::glDisable(GL_DEPTH_TEST);
+						}
+						ofPopView();
+					};
+
+					auto readBack = [](const ofTexture & texture) {
+						ofFloatPixels pixels;
+						texture.readToPixels(pixels);
+						return ofxCv::toCv(pixels).clone();
+					};
+
+					vector<Output> outputs(views.size());
+
+					//Color pass (we only need its depth)
+					vector<shared_ptr<ofFbo>> depthFbos;
+					for (size_t i = 0; i < views.size(); i++) {
+						auto depthFbo = make_shared<ofFbo>();
+						depthFbo->allocate(depthSettings);
+						depthFbo->begin();
+						{
+							ofClear(0, 0);
+							drawFromView(views[i], [&mesh]() {
+								mesh.draw();
+							});
+						}
+						depthFbo->end();
+						outputs[i].depthMap.depth = readBack(depthFbo->getDepthTexture());
+						depthFbos.push_back(depthFbo);
+					}
+
+					//AvailabilityProjection and AccumulateAvailability, as Projector::renderAvailability
+					auto & availabilityShader = ofxAssets::shader("ofxRulr::Nodes::BAM::AvailabilityProjection");
+					ofFbo availabilityFbo;
+					availabilityFbo.allocate(availabilitySettings);
+					for (size_t i = 0; i < views.size(); i++) {
+						auto & output = outputs[i];
+						output.availabilityAll = cv::Mat::zeros(height, width, CV_32F);
+						for (size_t j = 0; j < views.size(); j++) {
+							availabilityFbo.begin();
+							{
+								ofClear(0, 0);
+								drawFromView(views[i], [&]() {
+									availabilityShader.begin();
+									{
+										availabilityShader.setUniform1f("normalCutoff", cos(settings.normalCutoffAngle * DEG_TO_RAD));
+										availabilityShader.setUniform1f("featherSize", settings.featherSize);
+										availabilityShader.setUniformMatrix4f("projectorVP0", views[j].viewProjection);
+										availabilityShader.setUniform2f("projectorResolution0", ofVec2f(views[j].width, views[j].height));
+										availabilityShader.setUniform3f("projectorPosition0", views[j].position);
+										availabilityShader.setUniform1f("projectorBrightness0", views[j].brightness);
+										availabilityShader.setUniformTexture("projectorDepthTexture0", depthFbos[j]->getDepthTexture(), 0);
+										availabilityShader.setUniformTexture("projectorDepthTextureShadow0", depthFbos[j]->getDepthTexture(), 1);
+
+										mesh.draw();
+									}
+									availabilityShader.end();
+								});
+							}
+							availabilityFbo.end();
+
+							auto availability = readBack(availabilityFbo.getTexture());
+							if (i == j) {
+								output.availabilitySelf = availability;
+							}
+							output.availabilityAll += availability;
+						}
+					}
+
+					//BrightnessAssignmentMap
+					auto & brightnessAssignmentMapShader = ofxAssets::shader("ofxRulr::Nodes::BAM::BrightnessAssignmentMap");
+					ofFbo brightnessAssignmentMapFbo;
+					brightnessAssignmentMapFbo.allocate(brightnessAssignmentMapSettings);
+
+					ofPlanePrimitive plane;
+					plane.set(width, height, 2, 2);
+					plane.setPosition(ofVec3f(width / 2.0f, height / 2.0f, 0.0f));
+					plane.mapTexCoordsFromTexture(brightnessAssignmentMapFbo.getTexture());
+
+					ofTexture availabilitySelf;
+					ofTexture availabilityAll;
+					availabilitySelf.allocate(width, height, GL_R32F);
+					availabilityAll.allocate(width, height, GL_R32F);
+					for (auto & output : outputs) {
+						availabilitySelf.loadData(output.availabilitySelf.ptr<float>(), width, height, GL_RED);
+						availabilityAll.loadData(output.availabilityAll.ptr<float>(), width, height, GL_RED);
+
+						brightnessAssignmentMapFbo.begin();
+						{
+							ofClear(0, 0);
+							brightnessAssignmentMapShader.begin();
+							{
+								brightnessAssignmentMapShader.setUniformTexture("AvailabilitySelf", availabilitySelf, 0);
+								brightnessAssignmentMapShader.setUniformTexture("AvailabilityAll", availabilityAll, 1);
+								brightnessAssignmentMapShader.setUniform2f("TextureResolution", ofVec2f(width, height));
+								brightnessAssignmentMapShader.setUniform1f("FeatherSize", settings.featherSize);
+								brightnessAssignmentMapShader.setUniform1f("TargetBrightness", settings.targetBrightness);
+
+								plane.draw();
+							}
+							brightnessAssignmentMapShader.end();
+						}
+						brightnessAssignmentMapFbo.end();
+
+						output.brightnessAssignmentMap = readBack(brightnessAssignmentMapFbo.getTexture());
+					}
+
+					return outputs;
+				}
+			}
+		}
+	}
+}
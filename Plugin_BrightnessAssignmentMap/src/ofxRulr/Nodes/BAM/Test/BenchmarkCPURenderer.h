@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../CPURenderer.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace BAM {
+			namespace Test {
+				///Runs the CPU backend on a deterministic synthetic room lit by several projectors,
+				///reporting throughput and checking the results against the shader passes (when there is a GL context).
+				class BenchmarkCPURenderer : public Nodes::Test::Benchmark {
+				public:
+					BenchmarkCPURenderer();
+					string getTypeName() const override;
+					void init();
+
+					void populateInspector(ofxCvGui::InspectArguments &);
+
+					void runBenchmark() override;
+					void serializeResult(Json::Value &) const override;
+				protected:
+					struct Output {
+						CPURenderer::DepthMap depthMap;
+						cv::Mat availabilitySelf;
+						cv::Mat availabilityAll;
+						cv::Mat brightnessAssignmentMap;
+					};
+
+					ofMesh makeScene() const;
+					vector<CPURenderer::View> makeViews() const;
+					map<string, cv::Mat> getImages(const vector<Output> &) const;
+
+					///Render the same passes with the BAM shaders and read them back
+					vector<Output> renderWithShaders(const ofMesh &, const vector<CPURenderer::View> &, const CPURenderer::Settings &) const;
+
+					struct : ofParameterGroup {
+						ofParameter<int> width{ "Width", 1024, 16, 8192 };
+						ofParameter<int> height{ "Height", 768, 16, 8192 };
+						ofParameter<int> projectorCount{ "Projectors", 3, 1, 16 };
+						ofParameter<int> subdivisions{ "Subdivisions", 32, 1, 512 };
+						ofParameter<int> iterations{ "Iterations", 10, 1, 1000 };
+						ofParameter<float> tolerance{ "Tolerance", 1e-3, 0.0, 1.0 };
+						PARAM_DECLARE("BenchmarkCPURenderer", width, height, projectorCount, subdivisions, iterations, tolerance);
+					} parameters;
+
+					struct Result {
+						string configuration;
+						float depthDuration = 0.0f; // ms per iteration
+						float availabilityDuration = 0.0f; // ms per iteration
+						float brightnessAssignmentMapDuration = 0.0f; // ms per iteration
+						float megaPixelsPerSecond = 0.0f;
+						string shaderComparison = "-";
+						float maximumError = 0.0f;
+						int mismatchedPixels = 0;
+					};
+					Result result;
+				};
+			}
+		}
+	}
+}
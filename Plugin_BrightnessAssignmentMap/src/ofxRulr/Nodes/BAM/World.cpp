@@ -93,6 +93,38 @@ namespace ofxRulr {
 				return this->parameters;
 			}
 
+			//----------
+			CPURenderer::Settings World::getCPURendererSettings() const {
+				CPURenderer::Settings settings;
+				settings.normalCutoffAngle = this->parameters.normalCutoffAngle;
+				settings.featherSize = this->parameters.featherSize;
+				settings.targetBrightness = this->parameters.targetBrightness;
+				return settings;
+			}
+
+			//----------
+			ofMesh World::getSceneMesh() const {
+				return this->getSceneMeshNode()->getWorldMesh();
+			}
+
+			//----------
+			const ofPixels & World::getSceneTexture() const {
+				return this->getSceneMeshNode()->getTexturePixels();
+			}
+
+			//----------
+			shared_ptr<Item::Mesh> World::getSceneMeshNode() const {
+				auto scene = this->getInput<Nodes::Base>("Scene");
+				if (!scene) {
+					throw(ofxRulr::Exception("No scene connected to BAM::World"));
+				}
+				auto meshNode = dynamic_pointer_cast<Item::Mesh>(scene);
+				if (!meshNode) {
+					throw(ofxRulr::Exception("The CPU backend requires the BAM::World scene to be an Item::Mesh"));
+				}
+				return meshNode;
+			}
+
 			//----------
 			void World::exportAll(const string & folderPath) const {
 				auto bamProjectors = this->getProjectors();
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ofxRulr.h"
+#include "ofxRulr/Nodes/Item/Mesh.h"
+#include "CPURenderer.h"
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -17,8 +19,16 @@ namespace ofxRulr {
 				void unregisterProjector(shared_ptr<Projector>);
 				vector<shared_ptr<Projector>> getProjectors() const;
 				const ofParameterGroup & getParameters() const;
+				CPURenderer::Settings getCPURendererSettings() const;
+
+				///Scene geometry for the CPU backend (the scene must be an Item::Mesh)
+				ofMesh getSceneMesh() const;
+				///Texture of the scene for the CPU backend's Color pass
+				const ofPixels & getSceneTexture() const;
 				void exportAll(const string & folderPath) const;
 			protected:
+				shared_ptr<Item::Mesh> getSceneMeshNode() const;
+
 				vector<weak_ptr<Projector>> projectors;
 
 				struct : ofParameterGroup {
@@ -6,6 +6,8 @@
 #include "ofxRulr/Nodes/BAM/World.h"
 #include "ofxRulr/Nodes/BAM/Projector.h"
 #include "ofxRulr/Nodes/BAM/PreviewCoverage.h"
+#include "ofxRulr/Nodes/BAM/CPURenderer.h"
+#include "ofxRulr/Nodes/BAM/Test/BenchmarkCPURenderer.h"
 
 #include "ofxRulr/Nodes/Item/Projector.h"
 #include "ofxRulr/Nodes/Item/Mesh.h"
@@ -7,6 +7,7 @@
 
 #include "ofxRulr/Exception.h"
 #include "ofxRulr/Utils/ScopedProcess.h"
+#include "ofxRulr/Utils/WorldBatch.h"
 
 #include "ofxCvGui/Panels/Groups/Grid.h"
 #include "ofxCvGui/Panels/Draws.h"
@@ -292,28 +293,13 @@ namespace ofxRulr {
 					auto depthCamera = this->getInput<Item::IDepthCamera>();
 					if (depthCamera) {
 						auto depthCameraTransform = depthCamera->getTransform();
-						
-						ofMesh preview;
-						for (auto correspondence : this->correspondences) {
-							preview.addVertex(correspondence.depthCameraObject);
-							preview.addColor(ofColor(
-													 correspondence.cameraNormalized.x * 255.0f,
-													 correspondence.cameraNormalized.y * 255.0f,
-													 0));
-						}
-						
-						ofPushMatrix();
-						{
-							ofMultMatrix(depthCameraTransform);
-							
-							Utils::Graphics::pushPointSize(10.0f);
-							{
-								preview.drawVertices();
-							}
-							Utils::Graphics::popPointSize();
-							
+
+						Utils::WorldBatch::Scope batch;
+						for (const auto & correspondence : this->correspondences) {
+							batch->addPoint(correspondence.depthCameraObject * depthCameraTransform
+								, ofFloatColor(correspondence.cameraNormalized.x, correspondence.cameraNormalized.y, 0.0f)
+								, 10.0f);
 						}
-						ofPopMatrix();
 					}
 				}
 				
@@ -6,6 +6,7 @@
 #include "ofxRulr/Nodes/Item/Camera.h"
 
 #include "ofxRulr/Utils/ScopedProcess.h"
+#include "ofxRulr/Utils/BundleAdjuster.h"
 
 #include "ofConstants.h"
 #include "ofxCvGui.h"
@@ -125,6 +126,11 @@ namespace ofxRulr {
 							ofxCvGui::Utils::drawText("Select this node and connect active camera.", args.localBounds);
 						}
 					};
+
+					this->addAction("Calibrate", [this](Json::Value & report) {
+						this->calibrate();
+						report["reprojectionError"] = this->error.get();
+					});
 				}
 
 				//----------
@@ -345,6 +351,14 @@ namespace ofxRulr {
 					inspector->addLiveValue<float>("Reprojection error [px]", [this]() {
 						return this->error;
 					});
+					inspector->addButton("Compare solvers", [this]() {
+						try {
+							ofxRulr::Utils::ScopedProcess scopedProcess("Comparing calibration solvers");
+							this->compareSolvers();
+							scopedProcess.end();
+						}
+						RULR_CATCH_ALL_TO_ALERT
+					});
 
 					inspector->addSpacer();
 
@@ -448,7 +462,19 @@ namespace ofxRulr {
 
 					vector<Mat> Rotations, Translations;
 					auto flags = CV_CALIB_FIX_K6 | CV_CALIB_FIX_K5;
-					this->error = cv::calibrateCamera(objectPoints, imagePoints, cameraResolution, cameraMatrix, distortionCoefficients, Rotations, Translations, flags);
+					switch (this->parameters.calibration.solver.get().get()) {
+					case CalibrationSolver::Sparse:
+					{
+						Utils::BundleAdjuster::Settings settings;
+						settings.huberThreshold = this->parameters.calibration.huberThreshold;
+						this->error = Utils::BundleAdjuster::calibrateCamera(objectPoints, imagePoints, cameraResolution, cameraMatrix, distortionCoefficients, Rotations, Translations, flags, settings);
+						break;
+					}
+					case CalibrationSolver::OpenCV:
+					default:
+						this->error = cv::calibrateCamera(objectPoints, imagePoints, cameraResolution, cameraMatrix, distortionCoefficients, Rotations, Translations, flags);
+						break;
+					}
 					camera->setIntrinsics(cameraMatrix, distortionCoefficients);
 
 					for (int i = 0; i < captures.size(); i++) {
@@ -465,6 +491,48 @@ namespace ofxRulr {
 						capture->reprojectionError = sqrt(reprojectionErrorSquaredSum / (float)reprojectedImageCoordinates.size());
 					}
 				}
+
+				//----------
+				void CameraIntrinsics::compareSolvers() {
+					this->throwIfMissingAConnection<Item::Camera>();
+					auto camera = this->getInput<Item::Camera>();
+
+					vector<vector<Point2f>> imagePoints;
+					vector<vector<Point3f>> objectPoints;
+					for (auto & capture : this->captures.getSelection()) {
+						if (capture->pointsImageSpace.size() > 0) {
+							imagePoints.push_back(toCv(capture->pointsImageSpace));
+							objectPoints.push_back(toCv(capture->pointsObjectSpace));
+						}
+					}
+					if (imagePoints.size() < 2) {
+						throw(ofxRulr::Exception("You need to add at least 2 captures before comparing solvers"));
+					}
+
+					cv::Size cameraResolution(camera->getWidth(), camera->getHeight());
+					auto flags = CV_CALIB_FIX_K6 | CV_CALIB_FIX_K5;
+
+					//same inputs for both, results are logged but not applied to the camera
+					Mat cameraMatrixOpenCV = Mat::eye(3, 3, CV_64F), cameraMatrixSparse = Mat::eye(3, 3, CV_64F);
+					Mat distortionOpenCV = Mat::zeros(8, 1, CV_64F), distortionSparse = Mat::zeros(8, 1, CV_64F);
+					vector<Mat> rotations, translations;
+
+					auto startTime = chrono::high_resolution_clock::now();
+					auto errorOpenCV = cv::calibrateCamera(objectPoints, imagePoints, cameraResolution, cameraMatrixOpenCV, distortionOpenCV, rotations, translations, flags);
+					chrono::duration<float, milli> durationOpenCV = chrono::high_resolution_clock::now() - startTime;
+
+					Utils::BundleAdjuster::Settings settings;
+					settings.huberThreshold = this->parameters.calibration.huberThreshold;
+					startTime = chrono::high_resolution_clock::now();
+					auto errorSparse = Utils::BundleAdjuster::calibrateCamera(objectPoints, imagePoints, cameraResolution, cameraMatrixSparse, distortionSparse, rotations, translations, flags, settings);
+					chrono::duration<float, milli> durationSparse = chrono::high_resolution_clock::now() - startTime;
+
+					ofLogNotice("CameraIntrinsics") << "Solver comparison on " << imagePoints.size() << " captures" << endl
+						<< "OpenCV : " << errorOpenCV << "px RMS in " << durationOpenCV.count() << "ms" << endl
+						<< "Sparse : " << errorSparse << "px RMS in " << durationSparse.count() << "ms" << endl
+						<< "Camera matrix difference : " << endl << (cameraMatrixSparse - cameraMatrixOpenCV) << endl
+						<< "Distortion difference : " << (distortionSparse - distortionOpenCV).t();
+				}
 			}
 		}
 	}
@@ -55,6 +55,7 @@ namespace ofxRulr {
 					void addCapture(bool triggeredFromTetheredCapture);
 					void findBoard();
 					void calibrate();
+					void compareSolvers();
 
 					shared_ptr<ofxCvGui::Panels::BaseImage> view;
 					ofTexture preview;
@@ -74,7 +75,14 @@ namespace ofxRulr {
 
 							PARAM_DECLARE("Capture", checkAllIncomingFrames, tetheredShootEnabled, findBoardMode);
 						} capture;
-						PARAM_DECLARE("CameraIntrinsics", capture);
+
+						struct : ofParameterGroup {
+							ofParameter<CalibrationSolver> solver{ "Solver", CalibrationSolver::OpenCV };
+							ofParameter<float> huberThreshold{ "Huber threshold [px]", 0.0f, 0.0f, 100.0f }; // sparse solver only, 0 to disable
+							PARAM_DECLARE("Calibration", solver, huberThreshold);
+						} calibration;
+
+						PARAM_DECLARE("CameraIntrinsics", capture, calibration);
 					} parameters;
 					
 					bool isFrameNew = false;
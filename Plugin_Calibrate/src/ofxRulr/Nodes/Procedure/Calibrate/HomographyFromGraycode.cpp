@@ -7,7 +7,7 @@
 #include "ofxRulr/Nodes/Item/Camera.h"
 #include "ofxCvMin.h"
 
-#include "ofxCvGui/Panels/Image.h"
+#include "ofxCvGui/Panels/Draws.h"
 #include "ofxCvGui/Widgets/Button.h"
 
 #include "ofxNonLinearFit.h"
@@ -39,18 +39,16 @@ namespace ofxRulr {
 					this->addInput(MAKE(Graph::Pin<Scan::Graycode>));
 					this->addInput(MAKE(Graph::Pin<Item::Camera>));
 
-					auto view = MAKE(ofxCvGui::Panels::Image, this->dummy);
+					auto view = make_shared<ofxCvGui::Panels::Draws>();
 					view->onDrawImage += [this](ofxCvGui::DrawImageArguments & args) {
 						try {
 							auto graycodeNode = this->getInput<Scan::Graycode>();
 							if (graycodeNode) {
-								auto & dataSet = graycodeNode->getDataSet();
-								if (dataSet.getHasData()) {
+								auto dataSet = graycodeNode->getMappedDataSet();
+								if (dataSet) {
 									ofPushMatrix();
-									graycodeNode->getDecoder().draw(0, 0);
-
 									ofMultMatrix(this->cameraToProjector.getInverse());
-									ofScale(dataSet.getPayloadWidth(), dataSet.getPayloadHeight());
+									ofScale(dataSet->getPayloadWidth(), dataSet->getPayloadHeight());
 									ofPushStyle();
 									ofNoFill();
 									ofSetLineWidth(1.0f);
@@ -84,7 +82,11 @@ namespace ofxRulr {
 				void HomographyFromGraycode::update() {
 					auto graycodeNode = this->getInput<Scan::Graycode>();
 					if (graycodeNode) {
-						this->view->setImage(graycodeNode->getDecoder().getProjectorInCamera());
+						//from the mapped lookups, so this doesn't load the full data set
+						this->view->setDrawObject(graycodeNode->getProjectorInCameraPreview());
+					}
+					else {
+						this->view->clearDrawObject();
 					}
 				}
 
@@ -101,16 +103,16 @@ namespace ofxRulr {
 					try {
 						throwIfMissingAnyConnection();
 						auto graycodeNode = this->getInput<Scan::Graycode>();
-						auto & dataSet = graycodeNode->getDecoder().getDataSet();
-						if (!dataSet.getHasData()) {
+						auto dataSet = graycodeNode->getMappedDataSet();
+						if (!dataSet) {
 							throw(new Exception("No [ofxGraycode::DataSet] loaded"));
 						}
 						auto normalisedToCamera = ofMatrix4x4::newTranslationMatrix(1.0f, -1.0f, 1.0f) *
 							ofMatrix4x4::newScaleMatrix(0.5f, -0.5f, 1.0f) *
-							ofMatrix4x4::newScaleMatrix(dataSet.getWidth(), dataSet.getHeight(), 1.0f);
+							ofMatrix4x4::newScaleMatrix(dataSet->getWidth(), dataSet->getHeight(), 1.0f);
 						auto normaliseToProjector = ofMatrix4x4::newTranslationMatrix(1.0f, -1.0f, 1.0f) *
 							ofMatrix4x4::newScaleMatrix(0.5f, -0.5f, 1.0f) *
-							ofMatrix4x4::newScaleMatrix(dataSet.getPayloadWidth(), dataSet.getPayloadHeight(), 1.0f);
+							ofMatrix4x4::newScaleMatrix(dataSet->getPayloadWidth(), dataSet->getPayloadHeight(), 1.0f);
 						;
 
 						auto cameraNormalisedToProjectorNormalised = normalisedToCamera * this->cameraToProjector * normaliseToProjector.getInverse();
@@ -155,15 +157,15 @@ namespace ofxRulr {
 					this->throwIfMissingAnyConnection();
 
 					auto graycodeNode = this->getInput<Scan::Graycode>();
-					auto & dataSet = graycodeNode->getDataSet();
-					if (!dataSet.getHasData()) {
+					auto dataSet = graycodeNode->getMappedDataSet();
+					if (!dataSet) {
 						throw(ofxRulr::Exception("No data loaded for [ofxGraycode::DataSet]"));
 					}
 
 					vector<ofVec2f> camera;
 					vector<ofVec2f> projector;
 
-					for (const auto & pixel : dataSet) {
+					for (const auto & pixel : *dataSet) {
 						if (pixel.active) {
 							camera.push_back(pixel.getCameraXY());
 							projector.push_back(pixel.getProjectorXY());
@@ -195,8 +197,8 @@ namespace ofxRulr {
 					this->throwIfMissingAnyConnection();
 
 					auto graycodeNode = this->getInput<Scan::Graycode>();
-					auto & dataSet = graycodeNode->getDataSet();
-					if (!dataSet.getHasData()) {
+					auto dataSet = graycodeNode->getMappedDataSet();
+					if (!dataSet) {
 						throw(ofxRulr::Exception("No data loaded for [ofxGraycode::DataSet]"));
 					}
 
@@ -206,7 +208,7 @@ namespace ofxRulr {
 
 					string filePath;
 					if (filename == "") {
-						auto filenameBase = ofFilePath::removeExt(dataSet.getFilename());
+						auto filenameBase = ofFilePath::removeExt(dataSet->getFilename());
 						auto result = ofSystemSaveDialog(filenameBase + "-cameraToProjector.exr", "Save mapping image");
 						if (!result.bSuccess) {
 							return;
@@ -232,8 +234,8 @@ namespace ofxRulr {
 					// where ofGLUtils.cpp lacks GL_RGBA32F from the ofGetImageTypeFromGLType function
 					ofFbo mappingImage;
 					ofFbo::Settings settings;
-					settings.width = dataSet.getPayloadWidth() * factor;
-					settings.height = dataSet.getPayloadHeight() * factor;
+					settings.width = dataSet->getPayloadWidth() * factor;
+					settings.height = dataSet->getPayloadHeight() * factor;
 					settings.internalformat = GL_RGBA32F;
 					settings.numColorbuffers = 1;
 					mappingImage.allocate(settings);
@@ -244,7 +246,7 @@ namespace ofxRulr {
 					ofScale(factor, factor, 1.0f);
 
 					ofMultMatrix(this->cameraToProjector);
-					ofScale(dataSet.getWidth(), dataSet.getHeight());
+					ofScale(dataSet->getWidth(), dataSet->getHeight());
 					ofPushStyle();
 					mappingGrid.drawFaces();
 					ofPopStyle();
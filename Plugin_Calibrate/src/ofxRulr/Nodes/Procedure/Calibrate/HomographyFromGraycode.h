@@ -2,7 +2,7 @@
 
 #include "ofxRulr.h"
 
-#include "ofxCvGui/Panels/Image.h"
+#include "ofxCvGui/Panels/Draws.h"
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -25,11 +25,10 @@ namespace ofxRulr {
 				protected:
 					void populateInspector(ofxCvGui::InspectArguments &);
 
-					shared_ptr<ofxCvGui::Panels::Image> view;
+					shared_ptr<ofxCvGui::Panels::Draws> view;
 
 					ofMatrix4x4 cameraToProjector;
 					ofMesh grid;
-					ofImage dummy;
 
 					ofParameter<bool> undistortFirst;
 					ofParameter<bool> doubleExportSize;
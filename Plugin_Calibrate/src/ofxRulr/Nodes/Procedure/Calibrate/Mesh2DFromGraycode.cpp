@@ -4,8 +4,6 @@
 #include "ofxRulr/Nodes/Procedure/Scan/Graycode.h"
 #include "ofxRulr/Nodes/Data/Mesh.h"
 
-#include "ofxTriangle.h"
-
 namespace ofxRulr {
 	namespace Nodes {
 		namespace Procedure {
@@ -22,10 +20,12 @@ namespace ofxRulr {
 
 				//----------
 				void Mesh2DFromGraycode::init() {
+					RULR_NODE_UPDATE_LISTENER;
 					RULR_NODE_INSPECTOR_LISTENER;
-					RULR_NODE_SERIALIZATION_LISTENERS;
 
-					auto graycodeInput = this->addInput<Scan::Graycode>();
+					this->manageParameters(this->parameters);
+
+					this->addInput<Scan::Graycode>();
 					auto meshInput = this->addInput<Data::Mesh>();
 
 					auto view = make_shared<ofxCvGui::Panels::Draws>();
@@ -35,15 +35,35 @@ namespace ofxRulr {
 							meshNode->getMesh().drawWireframe();
 						}
 					};
-					graycodeInput->onNewConnection += [this, view](shared_ptr<Scan::Graycode> graycodeNode) {
-						view->setDrawObject(graycodeNode->getDecoder().getCameraInProjector());
-					};
-					graycodeInput->onDeleteConnection += [this, view](shared_ptr<Scan::Graycode> graycodeNode) {
-						view->clearDrawObject();
-					};
 					this->view = view;
 				}
 
+				//----------
+				void Mesh2DFromGraycode::update() {
+					auto graycodeNode = this->getInput<Scan::Graycode>();
+
+					//from the mapped lookups, so this doesn't load the full data set
+					if (graycodeNode) {
+						this->view->setDrawObject(graycodeNode->getCameraInProjectorPreview());
+					}
+					else {
+						this->view->clearDrawObject();
+					}
+
+					if (this->parameters.triangulateOnNewData) {
+						if (graycodeNode && this->getInput<Data::Mesh>()) {
+							auto dataSet = graycodeNode->getMappedDataSet();
+							if (dataSet && dataSet->getContentId() != this->triangulatedContentId) {
+								try {
+									this->triangulate();
+								}
+								RULR_CATCH_ALL_TO_ERROR;
+								this->triangulatedContentId = dataSet->getContentId(); // don't retry every frame if it failed
+							}
+						}
+					}
+				}
+
 				//----------
 				ofxCvGui::PanelPtr Mesh2DFromGraycode::getPanel() {
 					return this->view;
@@ -59,14 +79,19 @@ namespace ofxRulr {
 						}
 						RULR_CATCH_ALL_TO_ALERT;
 					});
-				}
 
-				//----------
-				void Mesh2DFromGraycode::serialize(Json::Value & json) {
-				}
-
-				//----------
-				void Mesh2DFromGraycode::deserialize(const Json::Value & json) {
+					inspector->addLiveValue<float>("Duration [ms]", [this]() {
+						return this->duration;
+					});
+					inspector->addLiveValue<string>("Tiles triangulated / reused", [this]() {
+						return ofToString(this->statistics.triangulatedTiles) + " / " + ofToString(this->statistics.reusedTiles);
+					});
+					inspector->addLiveValue<size_t>("Tiles widened", [this]() {
+						return this->statistics.widenedTiles;
+					});
+					inspector->addLiveValue<size_t>("Unresolved triangles", [this]() {
+						return this->statistics.unresolvedTriangles;
+					});
 				}
 
 				//----------
@@ -104,65 +129,82 @@ namespace ofxRulr {
 				void Mesh2DFromGraycode::triangulate() {
 					this->throwIfMissingAnyConnection();
 
-					auto dataSet = this->getInput<Scan::Graycode>()->getDataSet();
-					if (!dataSet.getHasData()) {
+					//shared with the Graycode node and any other consumers, rather than a copy
+					auto dataSet = this->getInput<Scan::Graycode>()->getMappedDataSet();
+					if (!dataSet) {
 						throw(Exception("No scan data available"));
 					}
 
 					//get camera coords in projector space map
-					const auto & cameraInProjector = dataSet.getDataInverse();
-					const auto & active = dataSet.getActive();
+					const auto cameraInProjector = dataSet->getDataInverse();
+					const auto active = dataSet->getActive();
 
-					const auto projectorWidth = cameraInProjector.getWidth();
-					const auto projectorHeight = cameraInProjector.getHeight();
+					const auto projectorWidth = dataSet->getPayloadWidth();
+					const auto projectorHeight = dataSet->getPayloadHeight();
 
-					const auto cameraWidth = active.getWidth();
+					const auto cameraWidth = dataSet->getWidth();
 
-					auto getCameraPixelPosition = [&cameraInProjector, projectorWidth, cameraWidth](int i, int j) {
-						const auto cameraPixelIndex = cameraInProjector.getData()[i + j * projectorWidth];
+					auto getCameraPixelPosition = [cameraInProjector, cameraWidth](uint32_t projectorPixelIndex) {
+						const auto cameraPixelIndex = cameraInProjector[projectorPixelIndex];
 						return ofVec2f(cameraPixelIndex % cameraWidth, cameraPixelIndex / cameraWidth);
 					};
-					auto isActive = [& cameraInProjector, &active, projectorWidth](int i, int j) {
-						const auto cameraPixelIndex = cameraInProjector.getData()[i + j * projectorWidth];
-						const auto isActive = active.getData()[cameraPixelIndex];
+					auto isActive = [cameraInProjector, active](uint32_t projectorPixelIndex) {
+						const auto cameraPixelIndex = cameraInProjector[projectorPixelIndex];
+						const auto isActive = active[cameraPixelIndex];
 						return isActive;
 					};
 
-					vector<ofPoint> projectorSpaceActivePoints;
+					auto startTime = chrono::high_resolution_clock::now();
 
 					//find all active pixels
-					for (int j = 0; j < projectorHeight; j++) {
-						for (int i = 0; i < projectorWidth; i++) {
-							if (isActive(i, j)) {
-								projectorSpaceActivePoints.emplace_back(ofVec2f(i, j));
-							}
+					vector<uint32_t> projectorSpaceActivePixels;
+					const auto projectorPixelCount = (uint32_t) (projectorWidth * projectorHeight);
+					for (uint32_t projectorPixelIndex = 0; projectorPixelIndex < projectorPixelCount; projectorPixelIndex++) {
+						if (isActive(projectorPixelIndex)) {
+							projectorSpaceActivePixels.push_back(projectorPixelIndex);
 						}
 					}
 
 					//triangulate
-					ofMesh mesh;
-					{
-						//make vertices and tex coords
-						Delaunay::Point tempP;
-						vector<Delaunay::Point> delauneyPoints;
-						for (const auto & projectorSpaceActivePoint : projectorSpaceActivePoints) {
-							delauneyPoints.emplace_back(projectorSpaceActivePoint.x, projectorSpaceActivePoint.y);
-							mesh.addVertex(projectorSpaceActivePoint);
-							mesh.addTexCoord(getCameraPixelPosition(projectorSpaceActivePoint.x, projectorSpaceActivePoint.y));
-						}
+					vector<uint32_t> triangles;
+					if (this->parameters.tiled) {
+						Utils::TiledDelaunay::Settings settings;
+						settings.tileSize = this->parameters.tileSize;
+						settings.halo = this->parameters.halo;
+						settings.threadCount = (size_t) this->parameters.threadCount.get();
+						settings.incremental = this->parameters.incremental;
+						this->statistics = this->tiledDelaunay.triangulate(projectorSpaceActivePixels, projectorWidth, projectorHeight, triangles, settings);
+					}
+					else {
+						Utils::TiledDelaunay::triangulateSinglePass(projectorSpaceActivePixels, projectorWidth, triangles);
+						this->tiledDelaunay.clear();
+						this->statistics = Utils::TiledDelaunay::Statistics();
+					}
 
-						//triangulate
-						auto delauney = make_shared<Delaunay>(delauneyPoints);
-						delauney->Triangulate();
+					//make vertices and tex coords
+					ofMesh mesh;
+					vector<ofIndexType> vertexIndices(projectorPixelCount);
+					for (const auto & projectorPixelIndex : projectorSpaceActivePixels) {
+						vertexIndices[projectorPixelIndex] = (ofIndexType) mesh.getNumVertices();
+						mesh.addVertex(ofVec3f(projectorPixelIndex % projectorWidth, projectorPixelIndex / projectorWidth, 0.0f));
+						mesh.addTexCoord(getCameraPixelPosition(projectorPixelIndex));
+					}
 
-						//apply indices
-						for (auto it = delauney->fbegin(); it != delauney->fend(); ++it) {
-							mesh.addIndex(delauney->Org(it));
-							mesh.addIndex(delauney->Dest(it));
-							mesh.addIndex(delauney->Apex(it));
-						}
+					//apply indices
+					auto & indices = mesh.getIndices();
+					indices.reserve(triangles.size());
+					for (auto projectorPixelIndex : triangles) {
+						indices.push_back(vertexIndices[projectorPixelIndex]);
 					}
+
 					swap(this->getInput<Data::Mesh>()->getMesh(), mesh);
+					this->triangulatedContentId = dataSet->getContentId();
+
+					this->duration = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+					ofLogNotice(this->getTypeName()) << "Triangulated " << projectorSpaceActivePixels.size() << " points into "
+						<< triangles.size() / 3 << " triangles in " << this->duration << "ms ("
+						<< this->statistics.triangulatedTiles << " tiles triangulated, "
+						<< this->statistics.reusedTiles << " reused)";
 				}
 			}
 		}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "ofxRulr/Nodes/Base.h"
+#include "ofxRulr/Utils/MappedDataSet.h"
+#include "ofxRulr/Utils/TiledDelaunay.h"
+
+#include "ofxCvGui/Panels/Draws.h"
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -12,15 +16,29 @@ namespace ofxRulr {
 					string getTypeName() const override;
 
 					void init();
+					void update();
 					ofxCvGui::PanelPtr getPanel() override;
 
 					void populateInspector(ofxCvGui::InspectArguments &);
-					void serialize(Json::Value &);
-					void deserialize(const Json::Value &);
 
 					void triangulate();
 				protected:
-					ofxCvGui::PanelPtr view;
+					shared_ptr<ofxCvGui::Panels::Draws> view;
+
+					struct : ofParameterGroup {
+						ofParameter<bool> tiled{ "Tiled", true };
+						ofParameter<int> tileSize{ "Tile size [px]", 128, 16, 4096 };
+						ofParameter<int> halo{ "Halo [px]", 8, 1, 1024 };
+						ofParameter<int> threadCount{ "Threads", 0, 0, 64 }; // 0 for hardware concurrency
+						ofParameter<bool> incremental{ "Incremental", true };
+						ofParameter<bool> triangulateOnNewData{ "Triangulate on new data", false };
+						PARAM_DECLARE("Mesh2DFromGraycode", tiled, tileSize, halo, threadCount, incremental, triangulateOnNewData);
+					} parameters;
+
+					Utils::TiledDelaunay tiledDelaunay;
+					Utils::TiledDelaunay::Statistics statistics;
+					float duration = 0.0f; // ms
+					uint64_t triangulatedContentId = 0; // see Utils::MappedDataSet::getContentId
 				};
 			}
 		}
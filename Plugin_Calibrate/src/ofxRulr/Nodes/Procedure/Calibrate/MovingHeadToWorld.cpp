@@ -107,8 +107,7 @@ namespace ofxRulr {
 
 						auto position = ofVec3f(parameters[0], parameters[1], parameters[2]);
 						auto rotationEuler = ofVec3f(parameters[3], parameters[4], parameters[5]);
-						auto rotationQuat = toOf(glm::quat(toGLM(rotationEuler)));
-						this->transform = ofMatrix4x4::newRotationMatrix(rotationQuat) * ofMatrix4x4::newTranslationMatrix(position);
+						this->transform = Model::makeTransform(position, rotationEuler);
 
 						this->tiltOffset = parameters[6];
 					}
@@ -124,12 +123,26 @@ namespace ofxRulr {
 					return this->tiltOffset;
 				}
 
+				//---------
+				ofMatrix4x4 MovingHeadToWorld::Model::makeTransform(const ofVec3f & position, const ofVec3f & rotationEuler) {
+					auto rotationQuat = toOf(glm::quat(toGLM(rotationEuler)));
+					return ofMatrix4x4::newRotationMatrix(rotationQuat) * ofMatrix4x4::newTranslationMatrix(position);
+				}
+
 #pragma mark MovingHeadToWorld
 				//---------
 				MovingHeadToWorld::MovingHeadToWorld() {
 					RULR_NODE_INIT_LISTENER;
 				}
 
+				//---------
+				MovingHeadToWorld::~MovingHeadToWorld() {
+					this->cancelBackgroundCalibrate();
+					if (this->backgroundResult.valid()) {
+						this->backgroundResult.wait();
+					}
+				}
+
 				//---------
 				void MovingHeadToWorld::init() {
 					RULR_NODE_UPDATE_LISTENER;
@@ -245,6 +258,13 @@ namespace ofxRulr {
 
 				//---------
 				void MovingHeadToWorld::update() {
+					if (this->backgroundResult.valid() && this->backgroundResult.wait_for(chrono::seconds(0)) == future_status::ready) {
+						try {
+							this->applyBackgroundCalibrate(this->backgroundResult.get());
+						}
+						RULR_CATCH_ALL_TO_ALERT;
+					}
+
 					auto movingHead = this->getInput<DMX::MovingHead>();
 					if (movingHead) {
 						//fade the brightness based on last find time
@@ -265,6 +285,7 @@ namespace ofxRulr {
 				void MovingHeadToWorld::serialize(Json::Value & json) {
 					Utils::Serializable::serialize(json, this->beamBrightness);
 					Utils::Serializable::serialize(json, this->calibrateOnAdd);
+					Utils::Serializable::serialize(json, this->multiStart);
 
 					auto & jsonDataPoints = json["dataPoints"];
 					for (int i = 0; i < this->dataPoints.size(); i++) {
@@ -280,6 +301,7 @@ namespace ofxRulr {
 				void MovingHeadToWorld::deserialize(const Json::Value & json) {
 					Utils::Serializable::deserialize(json, this->beamBrightness);
 					Utils::Serializable::deserialize(json, this->calibrateOnAdd);
+					Utils::Serializable::deserialize(json, this->multiStart);
 					
 					this->dataPoints.clear();
 					const auto & jsonDataPoints = json["dataPoints"];
@@ -336,6 +358,33 @@ namespace ofxRulr {
 						return this->residual;
 					}));
 
+					inspector->add(new Widgets::Title("Multi-start calibrate", Widgets::Title::Level::H2));
+					{
+						inspector->addParameterGroup(this->multiStart);
+						inspector->add(new Widgets::Button("Calibrate in background", [this]() {
+							try {
+								this->calibrateInBackground();
+							}
+							RULR_CATCH_ALL_TO_ALERT;
+						}));
+						inspector->add(new Widgets::LiveValue<string>("Progress", [this]() {
+							if (!this->isCalibratingInBackground()) {
+								return string("Idle");
+							}
+							return ofToString(this->backgroundProgress->startsCompleted.load()) + " / " + ofToString(this->backgroundStartCount) + " starts";
+						}));
+						inspector->add(new Widgets::LiveValue<float>("Best residual [deg]", [this]() {
+							if (!this->isCalibratingInBackground()) {
+								return 0.0f;
+							}
+							auto bestResidual = this->backgroundProgress->bestResidual.load();
+							return isinf(bestResidual) ? 0.0f : bestResidual;
+						}));
+						inspector->add(new Widgets::Button("Cancel", [this]() {
+							this->cancelBackgroundCalibrate();
+						}));
+					}
+
 					inspector->add(new Widgets::Title("Tracking", Widgets::Title::Level::H2));
 					{
 						inspector->add(new Widgets::Button("Aim at target", [this]() {
@@ -464,6 +513,91 @@ namespace ofxRulr {
 					return valid;
 				}
 
+				//---------
+				void MovingHeadToWorld::calibrateInBackground() {
+					this->throwIfMissingAConnection<DMX::MovingHead>();
+					if (this->isCalibratingInBackground()) {
+						throw(Exception("Already calibrating"));
+					}
+					auto movingHead = this->getInput<DMX::MovingHead>();
+
+					//copy what the worker needs so that captures can change while it runs
+					vector<Utils::MovingHeadSolver::Observation> observations;
+					for (const auto & dataPoint : this->dataPoints) {
+						observations.push_back({ dataPoint.world, dataPoint.panTilt });
+					}
+					auto initialPosition = movingHead->getPosition();
+					auto initialRotationEuler = movingHead->getRotationEuler() * DEG_TO_RAD; // RigidBody's parameters are in degrees, the solver's are in radians
+
+					Utils::MovingHeadSolver::Settings settings;
+					settings.starts = (size_t) this->multiStart.starts.get();
+					settings.maximumIterations = (size_t) this->multiStart.iterations.get();
+					settings.positionSpread = this->multiStart.positionSpread.get();
+					settings.threadCount = (size_t) this->multiStart.threads.get();
+
+					//throws here rather than on the worker if there's too little data
+					if (observations.size() < 4) {
+						throw(Exception("Need at least 4 captures to calibrate (have " + ofToString(observations.size()) + ")"));
+					}
+
+					auto progress = make_shared<Utils::MovingHeadSolver::Progress>();
+					this->backgroundProgress = progress;
+					this->backgroundStartCount = settings.starts;
+					this->backgroundResult = async(launch::async, [observations, initialPosition, initialRotationEuler, settings, progress]() {
+						return Utils::MovingHeadSolver::solve(observations, initialPosition, initialRotationEuler, settings, progress.get());
+					});
+				}
+
+				//---------
+				void MovingHeadToWorld::cancelBackgroundCalibrate() {
+					if (this->backgroundProgress) {
+						this->backgroundProgress->cancelled = true;
+					}
+				}
+
+				//---------
+				bool MovingHeadToWorld::isCalibratingInBackground() const {
+					return this->backgroundResult.valid();
+				}
+
+				//---------
+				void MovingHeadToWorld::applyBackgroundCalibrate(const Utils::MovingHeadSolver::Result & result) {
+					this->backgroundProgress.reset();
+
+					if (result.cancelled) {
+						ofLogNotice(this->getTypeName()) << "Calibrate cancelled after " << result.startsCompleted << " starts";
+						return;
+					}
+					if (!result.success) {
+						throw(Exception("Calibrate failed, no start gave a valid result"));
+					}
+
+					this->throwIfMissingAConnection<DMX::MovingHead>();
+					auto movingHead = this->getInput<DMX::MovingHead>();
+
+					auto transform = Model::makeTransform(result.position, result.rotationEuler);
+					movingHead->setTransform(transform);
+					movingHead->setTiltOffset(result.tiltOffset);
+					this->residual = result.residual;
+
+					//as Model::evaluate and Model::getResidual
+					auto inverseTransform = transform.getInverse();
+					for (auto & dataPoint : this->dataPoints) {
+						dataPoint.panTiltEvaluated = DMX::MovingHead::getPanTiltForTargetInObjectSpace(dataPoint.world * inverseTransform, result.tiltOffset);
+						auto difference = dataPoint.panTiltEvaluated - dataPoint.panTilt;
+						while (difference.x > 180.0f) {
+							difference.x -= 360.0f;
+						}
+						while (difference.x < -180.0f) {
+							difference.x += 360.0f;
+						}
+						dataPoint.residual = difference.lengthSquared();
+					}
+
+					ofLogNotice(this->getTypeName()) << "Calibrated from start " << result.bestStart << " of " << result.startsCompleted
+						<< " in " << result.duration << "ms, residual " << result.residual << " deg";
+				}
+
 				//---------
 				void MovingHeadToWorld::performAim() {
 					this->throwIfMissingAnyConnection();
@@ -2,6 +2,9 @@
 
 #include "ofxRulr/Nodes/Procedure/Base.h"
 #include "ofxNonLinearFit.h"
+#include "ofxRulr/Utils/MovingHeadSolver.h"
+
+#include <future>
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -29,6 +32,8 @@ namespace ofxRulr {
 
 						const ofMatrix4x4 & getTransform();
 						float getTiltOffset() const;
+
+						static ofMatrix4x4 makeTransform(const ofVec3f & position, const ofVec3f & rotationEuler);
 					protected:
 						ofVec3f initialPosition;
 						ofVec3f initialRotationEuler;
@@ -37,6 +42,7 @@ namespace ofxRulr {
 					};
 
 					MovingHeadToWorld();
+					~MovingHeadToWorld();
 					void init();
 					string getTypeName() const override;
 					void update();
@@ -50,9 +56,16 @@ namespace ofxRulr {
 					void addCapture();
 					void deleteLastCapture();
 					bool calibrate(int iterations = 3);
+
+					///Multi-start fit on a background thread. The result is applied in update when it's ready
+					void calibrateInBackground();
+					void cancelBackgroundCalibrate();
+					bool isCalibratingInBackground() const;
+
 					void performAim();
 				protected:
 					void setPanTiltOrAlert(const ofVec2f &);
+					void applyBackgroundCalibrate(const Utils::MovingHeadSolver::Result &);
 					vector<DataPoint> dataPoints;
 					float residual;
 
@@ -61,6 +74,18 @@ namespace ofxRulr {
 					ofParameter<float> beamBrightness;
 					ofParameter<bool> calibrateOnAdd;
 					ofParameter<bool> continuouslyTrack;
+
+					struct : ofParameterGroup {
+						ofParameter<int> starts{ "Starts", 64, 1, 4096 };
+						ofParameter<int> iterations{ "Iterations", 100, 1, 10000 };
+						ofParameter<float> positionSpread{ "Position spread [m]", 2.0f, 0.0f, 50.0f };
+						ofParameter<int> threads{ "Threads", 0, 0, 64 }; // 0 for hardware concurrency
+						PARAM_DECLARE("Multi-start", starts, iterations, positionSpread, threads);
+					} multiStart;
+
+					future<Utils::MovingHeadSolver::Result> backgroundResult;
+					shared_ptr<Utils::MovingHeadSolver::Progress> backgroundProgress;
+					size_t backgroundStartCount = 0;
 				};
 			}
 		}
@@ -5,6 +5,7 @@
 #include "ofxRulr/Nodes/Item/Camera.h"
 #include "ofxRulr/Nodes/Item/Projector.h"
 #include "ofxRulr/Nodes/Item/AbstractBoard.h"
+#include "ofxRulr/Utils/WorldBatch.h"
 
 #include "ofxTriangle.h"
 
@@ -42,51 +43,29 @@ namespace ofxRulr {
 				//----------
 				void ProjectorFromGraycode::Capture::drawWorld(shared_ptr<Item::Projector> projector)
 				{
-					ofMesh points;
-					points.setMode(ofPrimitiveMode::OF_PRIMITIVE_POINTS);
-
-					ofMesh zigzag;
-					zigzag.setMode(ofPrimitiveMode::OF_PRIMITIVE_LINE_STRIP);
+					if (this->worldPoints.empty()) {
+						return;
+					}
 
-					for (int i = 0; i < this->worldPoints.size(); i++) {
-						const auto & worldPoint = this->worldPoints[i];
-						if (i == 0) {
-							ofPushStyle();
-							{
-								ofSetColor(this->color);
-								ofDrawSphere(worldPoint, 0.05f);
-							}
-							ofPopStyle();
-						}
+					Utils::WorldBatch::Scope batch;
 
-						zigzag.addVertex(worldPoint);
-						zigzag.addColor((float)i / (float)this->worldPoints.size());
-					}
-					zigzag.draw();
+					batch->addSphere(this->worldPoints.front(), 0.05f, this->color.get());
 
-					Utils::Graphics::pushPointSize(5.0f);
-					{
-						points.drawVertices();
+					vector<ofFloatColor> zigzagColors;
+					zigzagColors.reserve(this->worldPoints.size());
+					for (int i = 0; i < this->worldPoints.size(); i++) {
+						zigzagColors.emplace_back((float)i / (float)this->worldPoints.size());
 					}
-					Utils::Graphics::popPointSize();
+					batch->addLineStrip(this->worldPoints, zigzagColors);
 
 					//draw transform axes
-					ofPushMatrix();
-					{
-						ofMultMatrix(this->transform);
-						ofDrawAxis(0.1f);
-					}
-					ofPopMatrix();
+					batch->addAxes(this->transform, 0.1f);
 
 					//draw lines to projector
 					if (projector) {
-						const auto projectorWidth = projector->getWidth();
-						const auto projectorHeight = projector->getHeight();
 						const auto projectorPosition = projector->getPosition();
 						const auto projectorView = projector->getViewInWorldSpace();
-
-						ofMesh projectorRays;
-						projectorRays.setMode(ofPrimitiveMode::OF_PRIMITIVE_TRIANGLES);
+						const auto rayStartColor = ofFloatColor(0.5, 0.5, 0.5, 0.0f);
 
 						for (int i = 0; i < this->worldPoints.size(); i++) {
 							const auto & worldPoint = this->worldPoints[i];
@@ -95,35 +74,23 @@ namespace ofxRulr {
 								this->projectorImagePoints[i].y / projector->getHeight(),
 								0
 							);
-							points.addVertex(worldPoint);
-							points.addColor(color);
+							batch->addPoint(worldPoint, color);
 
+							//outline of the triangle between the projector ray and the world point
 							auto distance = worldPoint.distance(projectorPosition);
 							auto projectorRay = projectorView.castPixel(this->projectorImagePoints[i]);
-							projectorRays.addVertex(projectorRay.s);
-							projectorRays.addVertex(projectorRay.s + projectorRay.t * distance / projectorRay.t.length());
-							projectorRays.addVertex(worldPoint);
-
-							projectorRays.addColor(ofFloatColor(0.5, 0.5, 0.5, 0.0f));
-							color.a = 0.5f;
-							projectorRays.addColor(color);
-							color.a = 1.0f;
-							projectorRays.addColor(color);
-						}
-
-						ofPushStyle();
-						{
-							ofEnableAlphaBlending();
-							projectorRays.drawWireframe();
-							ofDisableAlphaBlending();
+							const auto rayStart = projectorRay.s;
+							const auto rayEnd = projectorRay.s + projectorRay.t * distance / projectorRay.t.length();
+							auto rayEndColor = color;
+							rayEndColor.a = 0.5f;
+
+							batch->addLine(rayStart, rayEnd, rayStartColor, rayEndColor);
+							batch->addLine(rayEnd, worldPoint, rayEndColor, color);
+							batch->addLine(worldPoint, rayStart, color, rayStartColor);
 						}
-						ofPopStyle();
 					}
 					else {
-						for (int i = 0; i < this->worldPoints.size(); i++) {
-							const auto & worldPoint = this->worldPoints[i];
-							points.addVertex(worldPoint);
-						}
+						batch->addPoints(this->worldPoints, ofGetStyle().color);
 					}
 				}
 
@@ -181,6 +148,11 @@ namespace ofxRulr {
 						this->drawOnVideoOutput(bounds);
 					});
 
+					this->addAction("Calibrate", [this](Json::Value & report) {
+						this->calibrate();
+						report["reprojectionError"] = this->reprojectionError.get();
+					});
+
 					{
 						auto panel = ofxCvGui::Panels::Groups::makeStrip();
 						
@@ -283,15 +255,16 @@ namespace ofxRulr {
 						graycodeNode->runScan();
 					}
 
-					auto & dataSet = graycodeNode->getDataSet();
-					if (!dataSet.getHasData()) {
+					auto dataSet = graycodeNode->getMappedDataSet();
+					if (!dataSet) {
 						throw(ofxRulr::Exception("Graycode node has no data"));
 					}
 
 					//Make previews (use graycode data)
+					auto median = dataSet->getMedianPixels();
 					{
-						this->preview.projectorInCamera.loadData(dataSet.getMedian());
-						this->preview.cameraInProjector.loadData(dataSet.getMedianInverse());
+						this->preview.projectorInCamera.loadData(median);
+						this->preview.cameraInProjector.loadData(dataSet->getMedianInversePixels());
 					}
 
 					//Find board in camera
@@ -299,10 +272,7 @@ namespace ofxRulr {
 					vector<cv::Point3f> boardObjectPoints;
 					{
 						Utils::ScopedProcess scopedProcessFindBoard("Find board in camera image", false);
-						const auto & median = dataSet.getMedian();
-
-						ofPixels medianCopy(median);
-						auto medianCopyMat = toCv(medianCopy);
+						auto medianCopyMat = toCv(median);
 
 						if (!boardNode->findBoard(medianCopyMat
 							, cameraImagePoints
@@ -355,7 +325,7 @@ namespace ofxRulr {
 							vector<cv::Point2f> projectorSpace;
 
 							//build up search area
-							for (const auto & pixel : dataSet) {
+							for (const auto & pixel : *dataSet) {
 								const auto distanceSquared = pixel.getCameraXY().squareDistance(ofxCv::toOf(cameraImagePoint));
 								if (distanceSquared < distanceThresholdSquared) {
 									cameraSpace.push_back(ofxCv::toCv(pixel.getCameraXY()));
@@ -2,6 +2,7 @@
 #include "StereoCalibrate.h"
 
 #include "ofxRulr/Nodes/Item/Camera.h"
+#include "ofxRulr/Utils/BundleAdjuster.h"
 #include <future>
 
 #include "ofxNonLinearFit.h"
@@ -72,6 +73,15 @@ namespace ofxRulr {
 					this->addInput<Item::Camera>("Camera B");
 					this->addInput<Item::AbstractBoard>();
 
+					this->addAction("Calibrate", [this](Json::Value & report) {
+						this->calibrate();
+						report["reprojectionError"] = this->reprojectionError.get();
+					});
+
+					this->captures.onChange += [this]() {
+						this->worldCacheDirty = true;
+					};
+
 					//build gui
 					{
 						auto strip = ofxCvGui::Panels::Groups::makeStrip();
@@ -168,56 +178,24 @@ namespace ofxRulr {
 							this->previewIsLastCapture = true;
 						}
 					}
+
+					this->updateWorldCache();
 				}
 
 				//----------
 				void StereoCalibrate::drawWorldStage() {
-					auto captures = this->captures.getSelection();
-					for (auto & capture : captures) {
+					//draw points
+					if (this->parameters.draw.points) {
+						this->worldCachePoints.draw();
+					}
 
+					//draw distances
+					if (this->parameters.draw.distances) {
 						ofPushStyle();
 						{
-							ofSetColor(capture->color);
-
-							//draw points
-							if (this->parameters.draw.points) {
-								for (auto & worldPoint : capture->pointsWorldSpace) {
-									ofDrawSphere(worldPoint, 0.005f);
-								}
-							}
-
-							//draw distances
-							if (this->parameters.draw.distances) {
-								set<pair<int, int>> distancesAlreadyDrawn; //index vs index
-								for (int i = 0; i < capture->pointsWorldSpace.size(); i++) {
-									//build a list of distances
-									multimap<float, int> distancesSquared; //distance vs index
-									for (int j = 0; j < capture->pointsWorldSpace.size(); j++) {
-										if (j == i) {
-											continue;
-										}
-
-										distancesSquared.emplace(capture->pointsWorldSpace[i].squareDistance(capture->pointsWorldSpace[j])
-											, j);
-									}
-
-									//pick 2 closest
-									int foundCount = 0;
-									for (auto it = distancesSquared.begin(); it != distancesSquared.end(); it++) {
-										//check we don't already have this one
-										pair<int, int> distancePair(i, it->second);
-										if (distancesAlreadyDrawn.find(distancePair) == distancesAlreadyDrawn.end()) {
-											auto middle = (capture->pointsWorldSpace[distancePair.first] + capture->pointsWorldSpace[distancePair.second]) / 2.0f;
-											ofDrawBitmapString(ofToString(sqrt(it->first)), middle);
-
-											distancesAlreadyDrawn.insert(distancePair);
-											foundCount++;
-											if (foundCount >= 2) {
-												break;
-											}
-										}
-									}
-								}
+							for (size_t i = 0; i < this->worldCache.labels.size(); i++) {
+								ofSetColor(this->worldCache.labelColors[i]);
+								ofDrawBitmapString(this->worldCache.labels[i], this->worldCache.labelPositions[i]);
 							}
 						}
 						ofPopStyle();
@@ -253,6 +231,7 @@ namespace ofxRulr {
 					this->captures.deserialize(json);
 					Utils::Serializable::deserialize(json, this->parameters);
 					Utils::Serializable::deserialize(json, this->reprojectionError);
+					this->worldCacheDirty = true;
 
 					if (json.isMember("opencvMatricesFile")) {
 						auto filename = json["opencvMatricesFile"].asString();
@@ -387,6 +366,9 @@ namespace ofxRulr {
 						RULR_CATCH_ALL_TO_ALERT;
 					}, OF_KEY_RETURN)->setHeight(100.0f);
 					inspector->addLiveValue<float>(this->reprojectionError);
+					inspector->addLiveValue<float>("World statistics recompute [ms]", [this]() {
+						return this->worldCache.duration;
+					});
 
 					inspector->addParameterGroup(this->parameters);
 				}
@@ -515,19 +497,36 @@ namespace ofxRulr {
 						flags |= CV_CALIB_FIX_INTRINSIC;
 					}
 
-					this->reprojectionError = cv::stereoCalibrate(objectPoints
-						, imagePointsA
-						, imagePointsB
-						, cameraMatrixA
-						, distortionCoefficientsA
-						, cameraMatrixB
-						, distortionCoefficientsB
-						, cameraNodeA->getSize()
-						, rotation3x3
-						, translation
-						, essential
-						, fundamental
-						, flags);
+					if (this->parameters.calibration.solver.get() == CalibrationSolver::Sparse) {
+						this->reprojectionError = Utils::BundleAdjuster::stereoCalibrate(objectPoints
+							, imagePointsA
+							, imagePointsB
+							, cameraMatrixA
+							, distortionCoefficientsA
+							, cameraMatrixB
+							, distortionCoefficientsB
+							, cameraNodeA->getSize()
+							, rotation3x3
+							, translation
+							, essential
+							, fundamental
+							, flags);
+					}
+					else {
+						this->reprojectionError = cv::stereoCalibrate(objectPoints
+							, imagePointsA
+							, imagePointsB
+							, cameraMatrixA
+							, distortionCoefficientsA
+							, cameraMatrixB
+							, distortionCoefficientsB
+							, cameraNodeA->getSize()
+							, rotation3x3
+							, translation
+							, essential
+							, fundamental
+							, flags);
+					}
 
 					if (!this->parameters.calibration.fixIntrinsics) {
 						cameraNodeA->setIntrinsics(cameraMatrixA, distortionCoefficientsA);
@@ -580,6 +579,119 @@ namespace ofxRulr {
 					for (auto capture : selectedCaptures) {
 						capture->pointsWorldSpace = this->triangulate(capture->pointsImageSpaceA, capture->pointsImageSpaceB, false);
 					}
+					this->worldCacheDirty = true;
+				}
+
+				//----------
+				void StereoCalibrate::updateWorldCache() {
+					//pick up a finished rebuild
+					if (this->worldCacheFuture.valid()) {
+						if (this->worldCacheFuture.wait_for(chrono::seconds(0)) != future_status::ready) {
+							return;
+						}
+						this->worldCache = this->worldCacheFuture.get();
+						this->worldCachePoints = ofVboMesh(this->worldCache.points);
+						this->worldCache.points.clear();
+					}
+
+					if (!this->worldCacheDirty) {
+						return;
+					}
+					this->worldCacheDirty = false;
+
+					//copy what the worker needs so that captures can change while it runs
+					struct CaptureData {
+						vector<ofVec3f> points;
+						ofColor color;
+					};
+					vector<CaptureData> captureDatas;
+					for (const auto & capture : this->captures.getSelection()) {
+						captureDatas.push_back(CaptureData{ capture->pointsWorldSpace, capture->color.get() });
+					}
+					auto sphere = ofMesh::sphere(0.005f, 8, OF_PRIMITIVE_TRIANGLES);
+
+					this->worldCacheFuture = async(launch::async, [captureDatas, sphere]() {
+						auto startTime = chrono::high_resolution_clock::now();
+
+						WorldCache worldCache;
+
+						//one mesh of spheres for all the points
+						{
+							size_t pointCount = 0;
+							for (const auto & captureData : captureDatas) {
+								pointCount += captureData.points.size();
+							}
+
+							const auto & sphereVertices = sphere.getVertices();
+							const auto & sphereNormals = sphere.getNormals();
+							const auto & sphereIndices = sphere.getIndices();
+
+							auto & mesh = worldCache.points;
+							mesh.setMode(sphere.getMode());
+							auto & vertices = mesh.getVertices();
+							auto & normals = mesh.getNormals();
+							auto & colors = mesh.getColors();
+							auto & indices = mesh.getIndices();
+							vertices.reserve(pointCount * sphereVertices.size());
+							normals.reserve(pointCount * sphereNormals.size());
+							colors.reserve(pointCount * sphereVertices.size());
+							indices.reserve(pointCount * sphereIndices.size());
+
+							for (const auto & captureData : captureDatas) {
+								const ofFloatColor color(captureData.color);
+								for (const auto & point : captureData.points) {
+									const auto indexOffset = (ofIndexType) vertices.size();
+									for (const auto & sphereVertex : sphereVertices) {
+										vertices.push_back(sphereVertex + point);
+										colors.push_back(color);
+									}
+									normals.insert(normals.end(), sphereNormals.begin(), sphereNormals.end());
+									for (auto sphereIndex : sphereIndices) {
+										indices.push_back(sphereIndex + indexOffset);
+									}
+								}
+							}
+						}
+
+						//label the distance from each point to its 2 nearest neighbours
+						//(a pair which are each other's nearest is only labelled once)
+						for (const auto & captureData : captureDatas) {
+							const auto & points = captureData.points;
+							const auto count = points.size();
+
+							vector<uint8_t> pairsLabelled(count * count, 0);
+							vector<pair<float, size_t>> distancesSquared; // distance vs index
+							distancesSquared.reserve(count);
+
+							for (size_t i = 0; i < count; i++) {
+								distancesSquared.clear();
+								for (size_t j = 0; j < count; j++) {
+									if (j != i) {
+										distancesSquared.emplace_back(points[i].squareDistance(points[j]), j);
+									}
+								}
+								const auto nearestCount = min<size_t>(2, distancesSquared.size());
+								partial_sort(distancesSquared.begin(), distancesSquared.begin() + nearestCount, distancesSquared.end());
+
+								for (size_t k = 0; k < nearestCount; k++) {
+									const auto & distanceSquared = distancesSquared[k];
+									const auto j = distanceSquared.second;
+									if (pairsLabelled[i * count + j]) {
+										continue;
+									}
+									pairsLabelled[i * count + j] = 1;
+									pairsLabelled[j * count + i] = 1;
+
+									worldCache.labelPositions.push_back((points[i] + points[j]) / 2.0f);
+									worldCache.labels.push_back(ofToString(sqrt(distanceSquared.first)));
+									worldCache.labelColors.push_back(captureData.color);
+								}
+							}
+						}
+
+						worldCache.duration = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+						return worldCache;
+					});
 				}
 			}
 		}
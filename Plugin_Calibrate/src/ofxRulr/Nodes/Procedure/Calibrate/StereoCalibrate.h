@@ -7,6 +7,8 @@
 
 #include "Constants_Plugin_Calibration.h"
 
+#include <future>
+
 namespace ofxRulr {
 	namespace Nodes {
 		namespace Procedure {
@@ -69,6 +71,7 @@ namespace ofxRulr {
 					void populateInspector(ofxCvGui::InspectArguments &);
 					void addCapture();
 					void calibrate();
+					void updateWorldCache();
 
 					ofxCvGui::PanelPtr view;
 					ofTexture previewA, previewB;
@@ -88,7 +91,8 @@ namespace ofxRulr {
 
 						struct : ofParameterGroup {
 							ofParameter<bool> fixIntrinsics{ "Fix intrinsics", true };
-							PARAM_DECLARE("Calibrate", fixIntrinsics);
+							ofParameter<CalibrationSolver> solver{ "Solver", CalibrationSolver::OpenCV };
+							PARAM_DECLARE("Calibrate", fixIntrinsics, solver);
 						} calibration;
 
 						struct : ofParameterGroup {
@@ -105,6 +109,19 @@ namespace ofxRulr {
 						chrono::system_clock::time_point lastFailureA = chrono::system_clock::now() - chrono::minutes(1);
 						chrono::system_clock::time_point lastFailureB = chrono::system_clock::now() - chrono::minutes(1);
 					} lastFailures;
+
+					//what drawWorldStage shows for the selected captures, rebuilt on a worker when they change
+					struct WorldCache {
+						ofMesh points; // a sphere per triangulated corner, coloured by capture
+						vector<ofVec3f> labelPositions;
+						vector<string> labels; // distances from each corner to its 2 nearest neighbours
+						vector<ofColor> labelColors;
+						float duration = 0.0f; // ms
+					};
+					WorldCache worldCache;
+					ofVboMesh worldCachePoints;
+					future<WorldCache> worldCacheFuture;
+					bool worldCacheDirty = true;
 				};
 			}
 		}
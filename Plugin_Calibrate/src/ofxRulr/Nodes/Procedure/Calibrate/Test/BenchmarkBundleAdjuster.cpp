@@ -0,0 +1,200 @@
+#include "pch_Plugin_Calibrate.h"
+#include "BenchmarkBundleAdjuster.h"
+
+#include "ofxRulr/Utils/BundleAdjuster.h"
+#include "ofxRulr/Utils/ScopedProcess.h"
+
+#include <random>
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Procedure {
+			namespace Calibrate {
+				namespace Test {
+					//----------
+					BenchmarkBundleAdjuster::BenchmarkBundleAdjuster() {
+						RULR_NODE_INIT_LISTENER;
+					}
+
+					//----------
+					string BenchmarkBundleAdjuster::getTypeName() const {
+						return "Procedure::Calibrate::Test::BenchmarkBundleAdjuster";
+					}
+
+					//----------
+					void BenchmarkBundleAdjuster::init() {
+						RULR_NODE_INSPECTOR_LISTENER;
+
+						this->manageParameters(this->parameters);
+					}
+
+					//----------
+					void BenchmarkBundleAdjuster::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+						auto inspector = inspectArgs.inspector;
+						for (size_t i = 0; i < this->results.size(); i++) {
+							inspector->addTitle(ofToString(this->results[i].viewCount) + " views", ofxCvGui::Widgets::Title::Level::H3);
+							inspector->addLiveValue<string>("Time OpenCV / sparse [ms]", [this, i]() {
+								return ofToString(this->results[i].openCVDuration) + " / " + ofToString(this->results[i].sparseDuration);
+							});
+							inspector->addLiveValue<string>("RMS OpenCV / sparse [px]", [this, i]() {
+								return ofToString(this->results[i].openCVError) + " / " + ofToString(this->results[i].sparseError);
+							});
+							inspector->addLiveValue<float>("Focal length difference [px]", [this, i]() {
+								return this->results[i].focalLengthDifference;
+							});
+							inspector->addLiveValue<float>("Principal point difference [px]", [this, i]() {
+								return this->results[i].principalPointDifference;
+							});
+							inspector->addLiveValue<float>("Distortion difference", [this, i]() {
+								return this->results[i].distortionDifference;
+							});
+							inspector->addLiveValue<float>("Sparse focal length error [px]", [this, i]() {
+								return this->results[i].focalLengthError;
+							});
+						}
+					}
+
+					//----------
+					void BenchmarkBundleAdjuster::serializeResult(Json::Value & json) const {
+						for (const auto & result : this->results) {
+							Json::Value jsonResult;
+							jsonResult["viewCount"] = result.viewCount;
+							jsonResult["openCVDuration"] = result.openCVDuration;
+							jsonResult["sparseDuration"] = result.sparseDuration;
+							jsonResult["openCVError"] = result.openCVError;
+							jsonResult["sparseError"] = result.sparseError;
+							jsonResult["focalLengthDifference"] = result.focalLengthDifference;
+							jsonResult["principalPointDifference"] = result.principalPointDifference;
+							jsonResult["distortionDifference"] = result.distortionDifference;
+							jsonResult["focalLengthError"] = result.focalLengthError;
+							json["results"].append(jsonResult);
+						}
+					}
+
+					//----------
+					void BenchmarkBundleAdjuster::runBenchmark() {
+						typedef chrono::high_resolution_clock Clock;
+
+						const auto boardColumns = this->parameters.boardColumns.get();
+						const auto boardRows = this->parameters.boardRows.get();
+						const auto outlierRate = this->parameters.outlierRate.get();
+
+						Utils::ScopedProcess scopedProcess("Benchmark bundle adjuster", false);
+
+						//the camera we're trying to find
+						const cv::Size imageSize(1280, 720);
+						const cv::Mat cameraMatrix = (cv::Mat_<double>(3, 3) << 1000, 0, 640
+							, 0, 1005, 360
+							, 0, 0, 1);
+						const cv::Mat distortionCoefficients = (cv::Mat_<double>(5, 1) << -0.2, 0.08, 0.0005, -0.0005, 0.0);
+						const auto flags = CV_CALIB_FIX_K4 | CV_CALIB_FIX_K5 | CV_CALIB_FIX_K6;
+
+						vector<cv::Point3f> boardPoints;
+						const auto spacing = 0.03f;
+						for (int j = 0; j < boardRows; j++) {
+							for (int i = 0; i < boardColumns; i++) {
+								boardPoints.push_back(cv::Point3f(i * spacing, j * spacing, 0.0f));
+							}
+						}
+						const cv::Point3f boardCenter((boardColumns - 1) * spacing / 2.0f, (boardRows - 1) * spacing / 2.0f, 0.0f);
+
+						mt19937 randomEngine(0);
+						uniform_real_distribution<float> angleDistribution(-0.6f, 0.6f);
+						uniform_real_distribution<float> offsetDistribution(-0.25f, 0.25f);
+						uniform_real_distribution<float> distanceDistribution(0.6f, 1.5f);
+						uniform_real_distribution<float> outlierDistribution(0.0f, 1.0f);
+						normal_distribution<float> noiseDistribution(0.0f, this->parameters.noise.get());
+
+						//boards seen whole and in front of the camera
+						auto makeView = [&](vector<cv::Point2f> & imagePoints) {
+							while (true) {
+								cv::Mat rotationVector = (cv::Mat_<double>(3, 1) << angleDistribution(randomEngine), angleDistribution(randomEngine), angleDistribution(randomEngine) / 2.0f);
+								cv::Mat rotation;
+								cv::Rodrigues(rotationVector, rotation);
+
+								auto distance = distanceDistribution(randomEngine);
+								cv::Mat center = (cv::Mat_<double>(3, 1) << offsetDistribution(randomEngine) * distance, offsetDistribution(randomEngine) * distance, distance);
+								cv::Mat translation = center - rotation * (cv::Mat_<double>(3, 1) << boardCenter.x, boardCenter.y, boardCenter.z);
+
+								cv::projectPoints(boardPoints, rotationVector, translation, cameraMatrix, distortionCoefficients, imagePoints);
+								bool inside = true;
+								for (const auto & imagePoint : imagePoints) {
+									if (imagePoint.x < 0 || imagePoint.y < 0 || imagePoint.x >= imageSize.width || imagePoint.y >= imageSize.height) {
+										inside = false;
+										break;
+									}
+								}
+								if (!inside) {
+									continue;
+								}
+
+								for (auto & imagePoint : imagePoints) {
+									imagePoint.x += noiseDistribution(randomEngine);
+									imagePoint.y += noiseDistribution(randomEngine);
+									if (outlierDistribution(randomEngine) < outlierRate) {
+										imagePoint.x += 20.0f * noiseDistribution(randomEngine);
+										imagePoint.y += 20.0f * noiseDistribution(randomEngine);
+									}
+								}
+								return;
+							}
+						};
+
+						Utils::BundleAdjuster::Settings settings;
+						settings.huberThreshold = this->parameters.huberThreshold.get();
+						settings.threadCount = (size_t) this->parameters.threadCount.get();
+
+						vector<Result> results;
+						for (auto viewCount : { 50, 200, 1000 }) {
+							vector<vector<cv::Point3f>> objectPoints(viewCount, boardPoints);
+							vector<vector<cv::Point2f>> imagePoints(viewCount);
+							for (auto & viewImagePoints : imagePoints) {
+								makeView(viewImagePoints);
+							}
+
+							Result result;
+							result.viewCount = viewCount;
+
+							cv::Mat cameraMatrixOpenCV, distortionOpenCV = cv::Mat::zeros(5, 1, CV_64F);
+							cv::Mat cameraMatrixSparse, distortionSparse = cv::Mat::zeros(5, 1, CV_64F);
+							vector<cv::Mat> rotationVectors, translations;
+
+							{
+								auto startTime = Clock::now();
+								result.openCVError = cv::calibrateCamera(objectPoints, imagePoints, imageSize, cameraMatrixOpenCV, distortionOpenCV, rotationVectors, translations, flags);
+								result.openCVDuration = chrono::duration<float, milli>(Clock::now() - startTime).count();
+							}
+							{
+								auto startTime = Clock::now();
+								result.sparseError = Utils::BundleAdjuster::calibrateCamera(objectPoints, imagePoints, imageSize, cameraMatrixSparse, distortionSparse, rotationVectors, translations, flags, settings);
+								result.sparseDuration = chrono::duration<float, milli>(Clock::now() - startTime).count();
+							}
+
+							cv::Mat cameraMatrixDifference = cameraMatrixSparse - cameraMatrixOpenCV;
+							result.focalLengthDifference = max(abs(cameraMatrixDifference.at<double>(0, 0)), abs(cameraMatrixDifference.at<double>(1, 1)));
+							result.principalPointDifference = sqrt(pow(cameraMatrixDifference.at<double>(0, 2), 2) + pow(cameraMatrixDifference.at<double>(1, 2), 2));
+							result.distortionDifference = cv::norm(distortionSparse - distortionOpenCV, cv::NORM_INF);
+							result.focalLengthError = max(abs(cameraMatrixSparse.at<double>(0, 0) - cameraMatrix.at<double>(0, 0))
+								, abs(cameraMatrixSparse.at<double>(1, 1) - cameraMatrix.at<double>(1, 1)));
+
+							ofLogNotice("Procedure::Calibrate::Test::BenchmarkBundleAdjuster") << viewCount << " views : "
+								<< "OpenCV " << result.openCVDuration << "ms " << result.openCVError << "px, "
+								<< "sparse " << result.sparseDuration << "ms " << result.sparseError << "px, "
+								<< "focal length difference " << result.focalLengthDifference << "px, "
+								<< "principal point difference " << result.principalPointDifference << "px, "
+								<< "distortion difference " << result.distortionDifference;
+
+							results.push_back(result);
+						}
+
+						this->results = results;
+
+						scopedProcess.end();
+					}
+				}
+			}
+		}
+	}
+}
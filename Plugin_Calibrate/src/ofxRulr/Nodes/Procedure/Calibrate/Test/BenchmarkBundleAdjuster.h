@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ofxRulr.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Procedure {
+			namespace Calibrate {
+				namespace Test {
+					///Calibrates a synthetic camera from 50, 200 and 1000 views of a board with
+					///cv::calibrateCamera and with Utils::BundleAdjuster, and compares the results
+					class BenchmarkBundleAdjuster : public Nodes::Test::Benchmark {
+					public:
+						BenchmarkBundleAdjuster();
+						string getTypeName() const override;
+						void init();
+
+						void populateInspector(ofxCvGui::InspectArguments &);
+
+						void runBenchmark() override;
+						void serializeResult(Json::Value &) const override;
+					protected:
+						struct : ofParameterGroup {
+							ofParameter<int> boardColumns{ "Board columns", 10, 3, 50 };
+							ofParameter<int> boardRows{ "Board rows", 7, 3, 50 };
+							ofParameter<float> noise{ "Noise [px]", 0.3, 0.0, 10.0 };
+							ofParameter<float> outlierRate{ "Outlier rate", 0.0, 0.0, 0.5 };
+							ofParameter<float> huberThreshold{ "Huber threshold [px]", 0.0, 0.0, 100.0 };
+							ofParameter<int> threadCount{ "Threads", 0, 0, 64 }; // 0 for hardware concurrency
+							PARAM_DECLARE("BenchmarkBundleAdjuster", boardColumns, boardRows, noise, outlierRate, huberThreshold, threadCount);
+						} parameters;
+
+						struct Result {
+							int viewCount = 0;
+							float openCVDuration = 0.0f; // ms
+							float sparseDuration = 0.0f; // ms
+							float openCVError = 0.0f; // px RMS
+							float sparseError = 0.0f; // px RMS
+							float focalLengthDifference = 0.0f; // px, largest of fx and fy
+							float principalPointDifference = 0.0f; // px
+							float distortionDifference = 0.0f; // largest coefficient
+							float focalLengthError = 0.0f; // px, sparse against ground truth
+						};
+						vector<Result> results;
+					};
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,177 @@
+#include "pch_Plugin_Calibrate.h"
+#include "BenchmarkMesh2DFromGraycode.h"
+
+#include "ofxRulr/Utils/TiledDelaunay.h"
+#include "ofxRulr/Utils/ScopedProcess.h"
+
+#include <random>
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Procedure {
+			namespace Calibrate {
+				namespace Test {
+					//----------
+					BenchmarkMesh2DFromGraycode::BenchmarkMesh2DFromGraycode() {
+						RULR_NODE_INIT_LISTENER;
+					}
+
+					//----------
+					string BenchmarkMesh2DFromGraycode::getTypeName() const {
+						return "Procedure::Calibrate::Test::BenchmarkMesh2DFromGraycode";
+					}
+
+					//----------
+					void BenchmarkMesh2DFromGraycode::init() {
+						RULR_NODE_INSPECTOR_LISTENER;
+
+						this->manageParameters(this->parameters);
+					}
+
+					//----------
+					void BenchmarkMesh2DFromGraycode::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+						auto inspector = inspectArgs.inspector;
+						for (size_t i = 0; i < this->results.size(); i++) {
+							inspector->addTitle(ofToString(this->results[i].pointCount) + " points", ofxCvGui::Widgets::Title::Level::H3);
+							inspector->addLiveValue<string>("Time single / tiled / incremental [ms]", [this, i]() {
+								return ofToString(this->results[i].singlePassDuration) + " / " + ofToString(this->results[i].tiledDuration) + " / " + ofToString(this->results[i].incrementalDuration);
+							});
+							inspector->addLiveValue<string>("Triangles single / tiled", [this, i]() {
+								return ofToString(this->results[i].singlePassTriangles) + " / " + ofToString(this->results[i].tiledTriangles);
+							});
+							inspector->addLiveValue<string>("Tiles widened / reused", [this, i]() {
+								return ofToString(this->results[i].widenedTiles) + " / " + ofToString(this->results[i].reusedTiles) + " of " + ofToString(this->results[i].tileCount);
+							});
+							inspector->addLiveValue<size_t>("Unresolved triangles", [this, i]() {
+								return this->results[i].unresolvedTriangles;
+							});
+						}
+					}
+
+					//----------
+					void BenchmarkMesh2DFromGraycode::serializeResult(Json::Value & json) const {
+						for (const auto & result : this->results) {
+							Json::Value jsonResult;
+							jsonResult["pointCount"] = (Json::UInt64) result.pointCount;
+							jsonResult["singlePassDuration"] = result.singlePassDuration;
+							jsonResult["tiledDuration"] = result.tiledDuration;
+							jsonResult["incrementalDuration"] = result.incrementalDuration;
+							jsonResult["singlePassTriangles"] = (Json::UInt64) result.singlePassTriangles;
+							jsonResult["tiledTriangles"] = (Json::UInt64) result.tiledTriangles;
+							jsonResult["tileCount"] = (Json::UInt64) result.tileCount;
+							jsonResult["widenedTiles"] = (Json::UInt64) result.widenedTiles;
+							jsonResult["reusedTiles"] = (Json::UInt64) result.reusedTiles;
+							jsonResult["unresolvedTriangles"] = (Json::UInt64) result.unresolvedTriangles;
+							json["results"].append(jsonResult);
+						}
+					}
+
+					//----------
+					void BenchmarkMesh2DFromGraycode::runBenchmark() {
+						typedef chrono::high_resolution_clock Clock;
+
+						const auto activeRate = this->parameters.activeRate.get();
+						const auto changedPatchSize = this->parameters.changedPatchSize.get();
+
+						Utils::TiledDelaunay::Settings settings;
+						settings.tileSize = this->parameters.tileSize;
+						settings.halo = this->parameters.halo;
+						settings.threadCount = (size_t) this->parameters.threadCount.get();
+
+						Utils::ScopedProcess scopedProcess("Benchmark Mesh2DFromGraycode", false);
+
+						mt19937 randomEngine(0);
+						uniform_real_distribution<float> activeDistribution(0.0f, 1.0f);
+
+						vector<Result> results;
+						for (auto pointCount : { 100000, 500000, 2000000 }) {
+							//an ellipse of active pixels with dropouts, filling a 16:9 projector
+							const auto area = pointCount / (activeRate * PI / 4.0f);
+							const auto height = (int) sqrt(area * 9.0f / 16.0f);
+							const auto width = height * 16 / 9;
+
+							auto isInside = [width, height](int i, int j) {
+								const auto x = (i - width / 2.0f) / (width / 2.0f);
+								const auto y = (j - height / 2.0f) / (height / 2.0f);
+								return x * x + y * y < 1.0f;
+							};
+
+							vector<uint8_t> active(width * height, 0);
+							vector<uint32_t> pixelIndices;
+							for (int j = 0; j < height; j++) {
+								for (int i = 0; i < width; i++) {
+									if (isInside(i, j) && activeDistribution(randomEngine) < activeRate) {
+										active[i + j * width] = 1;
+										pixelIndices.push_back(i + j * width);
+									}
+								}
+							}
+
+							Result result;
+							result.pointCount = pixelIndices.size();
+
+							vector<uint32_t> triangles;
+
+							if (this->parameters.singlePass) {
+								auto startTime = Clock::now();
+								Utils::TiledDelaunay::triangulateSinglePass(pixelIndices, width, triangles);
+								result.singlePassDuration = chrono::duration<float, milli>(Clock::now() - startTime).count();
+								result.singlePassTriangles = triangles.size() / 3;
+							}
+
+							Utils::TiledDelaunay tiledDelaunay;
+							settings.incremental = true;
+							{
+								auto startTime = Clock::now();
+								auto statistics = tiledDelaunay.triangulate(pixelIndices, width, height, triangles, settings);
+								result.tiledDuration = chrono::duration<float, milli>(Clock::now() - startTime).count();
+								result.tiledTriangles = triangles.size() / 3;
+								result.tileCount = statistics.tileCount;
+								result.widenedTiles = statistics.widenedTiles;
+								result.unresolvedTriangles = statistics.unresolvedTriangles;
+							}
+
+							//re-roll a patch in the middle, as if part of the scan was thresholded differently
+							{
+								const auto patchX = (width - changedPatchSize) / 2;
+								const auto patchY = (height - changedPatchSize) / 2;
+								for (int j = max(patchY, 0); j < min(patchY + changedPatchSize, height); j++) {
+									for (int i = max(patchX, 0); i < min(patchX + changedPatchSize, width); i++) {
+										active[i + j * width] = isInside(i, j) && activeDistribution(randomEngine) < activeRate;
+									}
+								}
+								pixelIndices.clear();
+								for (uint32_t i = 0; i < active.size(); i++) {
+									if (active[i]) {
+										pixelIndices.push_back(i);
+									}
+								}
+							}
+							{
+								auto startTime = Clock::now();
+								auto statistics = tiledDelaunay.triangulate(pixelIndices, width, height, triangles, settings);
+								result.incrementalDuration = chrono::duration<float, milli>(Clock::now() - startTime).count();
+								result.reusedTiles = statistics.reusedTiles;
+							}
+
+							ofLogNotice("Procedure::Calibrate::Test::BenchmarkMesh2DFromGraycode") << result.pointCount << " points : "
+								<< "single pass " << result.singlePassDuration << "ms " << result.singlePassTriangles << " triangles, "
+								<< "tiled " << result.tiledDuration << "ms " << result.tiledTriangles << " triangles ("
+								<< result.widenedTiles << " of " << result.tileCount << " tiles widened, "
+								<< result.unresolvedTriangles << " unresolved), "
+								<< "incremental " << result.incrementalDuration << "ms (" << result.reusedTiles << " tiles reused)";
+
+							results.push_back(result);
+						}
+
+						this->results = results;
+
+						scopedProcess.end();
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ofxRulr.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Procedure {
+			namespace Calibrate {
+				namespace Test {
+					///Triangulates synthetic Graycode correspondences (100k, 500k and 2M active projector pixels) in a
+					///single pass, tiled, and tiled again after a small patch of the scan changes, and compares the results
+					class BenchmarkMesh2DFromGraycode : public Nodes::Test::Benchmark {
+					public:
+						BenchmarkMesh2DFromGraycode();
+						string getTypeName() const override;
+						void init();
+
+						void populateInspector(ofxCvGui::InspectArguments &);
+
+						void runBenchmark() override;
+						void serializeResult(Json::Value &) const override;
+					protected:
+						struct : ofParameterGroup {
+							ofParameter<float> activeRate{ "Active rate", 0.9, 0.05, 1.0 };
+							ofParameter<int> tileSize{ "Tile size [px]", 128, 16, 4096 };
+							ofParameter<int> halo{ "Halo [px]", 8, 1, 1024 };
+							ofParameter<int> threadCount{ "Threads", 0, 0, 64 }; // 0 for hardware concurrency
+							ofParameter<int> changedPatchSize{ "Changed patch size [px]", 64, 1, 1024 };
+							ofParameter<bool> singlePass{ "Single pass", true }; // slow at 2M
+							PARAM_DECLARE("BenchmarkMesh2DFromGraycode", activeRate, tileSize, halo, threadCount, changedPatchSize, singlePass);
+						} parameters;
+
+						struct Result {
+							size_t pointCount = 0;
+							float singlePassDuration = 0.0f; // ms
+							float tiledDuration = 0.0f; // ms
+							float incrementalDuration = 0.0f; // ms
+							size_t singlePassTriangles = 0;
+							size_t tiledTriangles = 0;
+							size_t tileCount = 0;
+							size_t widenedTiles = 0;
+							size_t reusedTiles = 0; // in the incremental pass
+							size_t unresolvedTriangles = 0;
+						};
+						vector<Result> results;
+					};
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,269 @@
+#include "pch_Plugin_Calibrate.h"
+#include "BenchmarkMovingHeadToWorld.h"
+
+#include "../MovingHeadToWorld.h"
+#include "ofxRulr/Nodes/DMX/MovingHead.h"
+#include "ofxRulr/Utils/MovingHeadSolver.h"
+#include "ofxRulr/Utils/ScopedProcess.h"
+
+#include "ofxGLM.h"
+
+#include <future>
+#include <random>
+#include <thread>
+
+using namespace ofxCvGui;
+using namespace ofxGLM;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Procedure {
+			namespace Calibrate {
+				namespace Test {
+					namespace {
+						struct Fixture {
+							ofVec3f position;
+							ofVec3f rotationEuler;
+							float tiltOffset;
+							ofMatrix4x4 transform;
+
+							ofVec3f initialPosition;
+							ofVec3f initialRotationEuler;
+
+							vector<MovingHeadToWorld::DataPoint> dataPoints;
+						};
+
+						//----------
+						//as RigidBody::setTransform
+						ofVec3f getRotationEuler(const ofMatrix4x4 & transform) {
+							glm::mat3 rotationMatrix;
+							for (int i = 0; i < 3; i++) {
+								for (int j = 0; j < 3; j++) {
+									rotationMatrix[i][j] = transform(i, j);
+								}
+							}
+							auto rotationEuler = glm::eulerAngles(glm::toQuat(rotationMatrix));
+							return ofVec3f(rotationEuler[0], rotationEuler[1], rotationEuler[2]);
+						}
+					}
+
+					//----------
+					BenchmarkMovingHeadToWorld::BenchmarkMovingHeadToWorld() {
+						RULR_NODE_INIT_LISTENER;
+					}
+
+					//----------
+					string BenchmarkMovingHeadToWorld::getTypeName() const {
+						return "Procedure::Calibrate::Test::BenchmarkMovingHeadToWorld";
+					}
+
+					//----------
+					void BenchmarkMovingHeadToWorld::init() {
+						RULR_NODE_INSPECTOR_LISTENER;
+
+						this->manageParameters(this->parameters);
+					}
+
+					//----------
+					void BenchmarkMovingHeadToWorld::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+						auto inspector = inspectArgs.inspector;
+						for (size_t i = 0; i < this->results.size(); i++) {
+							inspector->addTitle(this->results[i].name, ofxCvGui::Widgets::Title::Level::H3);
+							inspector->addLiveValue<float>("Duration [ms]", [this, i]() {
+								return this->results[i].duration;
+							});
+							inspector->addLiveValue<float>("Position error [m]", [this, i]() {
+								return this->results[i].positionError;
+							});
+							inspector->addLiveValue<float>("Rotation error [deg]", [this, i]() {
+								return this->results[i].rotationError;
+							});
+							inspector->addLiveValue<float>("Tilt offset error [deg]", [this, i]() {
+								return this->results[i].tiltOffsetError;
+							});
+							inspector->addLiveValue<string>("Recovered", [this, i]() {
+								return ofToString(this->results[i].recovered) + " / " + ofToString(this->parameters.fixtureCount.get());
+							});
+						}
+					}
+
+					//----------
+					void BenchmarkMovingHeadToWorld::serializeResult(Json::Value & json) const {
+						for (const auto & result : this->results) {
+							Json::Value jsonResult;
+							jsonResult["name"] = result.name;
+							jsonResult["duration"] = result.duration;
+							jsonResult["positionError"] = result.positionError;
+							jsonResult["rotationError"] = result.rotationError;
+							jsonResult["tiltOffsetError"] = result.tiltOffsetError;
+							jsonResult["recovered"] = result.recovered;
+							json["results"].append(jsonResult);
+						}
+					}
+
+					//----------
+					void BenchmarkMovingHeadToWorld::runBenchmark() {
+						typedef chrono::high_resolution_clock Clock;
+
+						const auto fixtureCount = (size_t) this->parameters.fixtureCount.get();
+						const auto observationCount = (size_t) this->parameters.observationCount.get();
+						const auto noise = this->parameters.noise.get();
+						const auto positionGuessError = this->parameters.positionGuessError.get();
+						const auto rotationGuessError = this->parameters.rotationGuessError.get();
+
+						Utils::ScopedProcess scopedProcess("Benchmark MovingHeadToWorld", false);
+
+						//fixtures on a truss over the stage, half hung upside down, each aimed at a marker on the floor
+						mt19937 randomGenerator(0);
+						uniform_real_distribution<float> unit(-1.0f, 1.0f);
+						vector<Fixture> fixtures(fixtureCount);
+						for (size_t i = 0; i < fixtureCount; i++) {
+							auto & fixture = fixtures[i];
+							fixture.position = ofVec3f(unit(randomGenerator) * 5.0f, 5.0f + unit(randomGenerator), unit(randomGenerator) * 5.0f);
+							fixture.rotationEuler = ofVec3f((i % 2 == 0 ? PI : 0.0f) + unit(randomGenerator) * 0.2f
+								, unit(randomGenerator) * PI
+								, unit(randomGenerator) * 0.2f);
+							fixture.tiltOffset = unit(randomGenerator) * 3.0f;
+							fixture.transform = MovingHeadToWorld::Model::makeTransform(fixture.position, fixture.rotationEuler);
+
+							//what the user placed in the rig by eye
+							fixture.initialPosition = fixture.position + ofVec3f(unit(randomGenerator), unit(randomGenerator), unit(randomGenerator)) * positionGuessError;
+							fixture.initialRotationEuler = fixture.rotationEuler + ofVec3f(unit(randomGenerator), unit(randomGenerator), unit(randomGenerator)) * rotationGuessError;
+
+							auto inverseTransform = fixture.transform.getInverse();
+							for (size_t j = 0; j < observationCount; j++) {
+								MovingHeadToWorld::DataPoint dataPoint;
+								dataPoint.world = ofVec3f(unit(randomGenerator) * 6.0f, 1.0f + unit(randomGenerator), unit(randomGenerator) * 6.0f);
+								dataPoint.panTilt = DMX::MovingHead::getPanTiltForTargetInObjectSpace(dataPoint.world * inverseTransform, fixture.tiltOffset)
+									+ ofVec2f(unit(randomGenerator), unit(randomGenerator)) * noise;
+								dataPoint.residual = 0.0f;
+								fixture.dataPoints.push_back(dataPoint);
+							}
+						}
+
+						auto score = [&fixtures](Result & result, size_t fixtureIndex, const ofMatrix4x4 & transform, float tiltOffset) {
+							const auto & fixture = fixtures[fixtureIndex];
+							auto positionError = transform.getTranslation().distance(fixture.position);
+
+							float angle;
+							ofVec3f axis;
+							(fixture.transform.getRotate().inverse() * transform.getRotate()).getRotate(angle, axis);
+							auto rotationError = angle > 180.0f ? 360.0f - angle : angle;
+
+							result.positionError += positionError;
+							result.rotationError += rotationError;
+							result.tiltOffsetError += abs(tiltOffset - fixture.tiltOffset);
+							if (positionError < 0.05f && rotationError < 1.0f) {
+								result.recovered++;
+							}
+						};
+
+						auto toObservations = [](const Fixture & fixture) {
+							vector<Utils::MovingHeadSolver::Observation> observations;
+							for (const auto & dataPoint : fixture.dataPoints) {
+								observations.push_back({ dataPoint.world, dataPoint.panTilt });
+							}
+							return observations;
+						};
+
+						Utils::MovingHeadSolver::Settings settings;
+						settings.starts = (size_t) this->parameters.starts.get();
+						settings.positionSpread = positionGuessError * 2.0f;
+						settings.threadCount = (size_t) this->parameters.threadCount.get();
+
+						vector<Result> results;
+
+						//MovingHeadToWorld::calibrate : 5 NLopt fits in a row on the main thread, each from the last
+						{
+							Result result;
+							result.name = "NLopt (in turn)";
+							auto start = Clock::now();
+							for (size_t i = 0; i < fixtureCount; i++) {
+								auto & fixture = fixtures[i];
+								auto position = fixture.initialPosition;
+								auto rotationEuler = fixture.initialRotationEuler;
+								auto transform = MovingHeadToWorld::Model::makeTransform(position, rotationEuler);
+								float tiltOffset = 0.0f;
+								for (int round = 0; round < 5; round++) {
+									auto fit = ofxNonLinearFit::Fit<MovingHeadToWorld::Model>();
+									auto model = MovingHeadToWorld::Model(position, rotationEuler);
+									double residual;
+									fit.optimise(model, &fixture.dataPoints, &residual);
+
+									//keep the last valid result
+									if (model.getTransform().isNaN() || isnan(model.getTiltOffset())) {
+										break;
+									}
+									transform = model.getTransform();
+									tiltOffset = model.getTiltOffset();
+									position = transform.getTranslation();
+									rotationEuler = getRotationEuler(transform);
+								}
+								score(result, i, transform, tiltOffset);
+							}
+							result.duration = chrono::duration<float, milli>(Clock::now() - start).count();
+							results.push_back(result);
+						}
+
+						//MovingHeadSolver, one fixture at a time with all threads
+						{
+							Result result;
+							result.name = "Multi-start (in turn)";
+							auto start = Clock::now();
+							for (size_t i = 0; i < fixtureCount; i++) {
+								const auto & fixture = fixtures[i];
+								auto solveResult = Utils::MovingHeadSolver::solve(toObservations(fixture), fixture.initialPosition, fixture.initialRotationEuler, settings, nullptr);
+								score(result, i, MovingHeadToWorld::Model::makeTransform(solveResult.position, solveResult.rotationEuler), solveResult.tiltOffset);
+							}
+							result.duration = chrono::duration<float, milli>(Clock::now() - start).count();
+							results.push_back(result);
+						}
+
+						//MovingHeadSolver, all fixtures at once (as several MovingHeadToWorld nodes calibrating in the background)
+						{
+							Result result;
+							result.name = "Multi-start (concurrent)";
+
+							auto concurrentSettings = settings;
+							const auto threadCount = settings.threadCount > 0
+								? settings.threadCount
+								: (size_t) max(thread::hardware_concurrency(), 1U);
+							concurrentSettings.threadCount = max<size_t>(threadCount / fixtureCount, 1);
+
+							auto start = Clock::now();
+							vector<future<Utils::MovingHeadSolver::Result>> futures;
+							for (const auto & fixture : fixtures) {
+								auto observations = toObservations(fixture);
+								auto initialPosition = fixture.initialPosition;
+								auto initialRotationEuler = fixture.initialRotationEuler;
+								futures.push_back(async(launch::async, [observations, initialPosition, initialRotationEuler, concurrentSettings]() {
+									return Utils::MovingHeadSolver::solve(observations, initialPosition, initialRotationEuler, concurrentSettings, nullptr);
+								}));
+							}
+							for (size_t i = 0; i < fixtureCount; i++) {
+								auto solveResult = futures[i].get();
+								score(result, i, MovingHeadToWorld::Model::makeTransform(solveResult.position, solveResult.rotationEuler), solveResult.tiltOffset);
+							}
+							result.duration = chrono::duration<float, milli>(Clock::now() - start).count();
+							results.push_back(result);
+						}
+
+						for (auto & result : results) {
+							result.positionError /= (float) fixtureCount;
+							result.rotationError /= (float) fixtureCount;
+							result.tiltOffsetError /= (float) fixtureCount;
+
+							ofLogNotice(this->getTypeName()) << result.name << " : " << result.duration << "ms, "
+								<< result.positionError << "m position error, "
+								<< result.rotationError << "deg rotation error, "
+								<< result.recovered << "/" << fixtureCount << " recovered";
+						}
+						this->results = results;
+
+						scopedProcess.end();
+					}
+				}
+			}
+		}
+	}
+}
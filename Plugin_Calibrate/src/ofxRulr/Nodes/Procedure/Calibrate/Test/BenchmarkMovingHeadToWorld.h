@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ofxRulr.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace Procedure {
+			namespace Calibrate {
+				namespace Test {
+					///Calibrates synthetic moving heads with known ground truth from a rough initial guess, with
+					///MovingHeadToWorld's NLopt fit and with Utils::MovingHeadSolver (fixtures in turn and all at once)
+					class BenchmarkMovingHeadToWorld : public Nodes::Test::Benchmark {
+					public:
+						BenchmarkMovingHeadToWorld();
+						string getTypeName() const override;
+						void init();
+
+						void populateInspector(ofxCvGui::InspectArguments &);
+
+						void runBenchmark() override;
+						void serializeResult(Json::Value &) const override;
+					protected:
+						struct : ofParameterGroup {
+							ofParameter<int> fixtureCount{ "Fixtures", 16, 1, 256 };
+							ofParameter<int> observationCount{ "Captures per fixture", 12, 4, 1000 };
+							ofParameter<float> noise{ "Noise [deg]", 0.2, 0.0, 5.0 };
+							ofParameter<float> positionGuessError{ "Initial position error [m]", 1.0, 0.0, 10.0 };
+							ofParameter<float> rotationGuessError{ "Initial rotation error [rad]", 0.5, 0.0, 3.2 };
+							ofParameter<int> starts{ "Starts", 64, 1, 4096 };
+							ofParameter<int> threadCount{ "Threads", 0, 0, 64 }; // 0 for hardware concurrency
+							PARAM_DECLARE("BenchmarkMovingHeadToWorld", fixtureCount, observationCount, noise, positionGuessError, rotationGuessError, starts, threadCount);
+						} parameters;
+
+						struct Result {
+							string name;
+							float duration = 0.0f; // ms, all fixtures
+							float positionError = 0.0f; // m, mean
+							float rotationError = 0.0f; // degrees, mean
+							float tiltOffsetError = 0.0f; // degrees, mean
+							int recovered = 0; // within 5cm and 1 degree
+						};
+						vector<Result> results;
+					};
+				}
+			}
+		}
+	}
+}
@@ -5,6 +5,8 @@
 #include "ofxRulr/Nodes/System/VideoOutput.h"
 #include "IReferenceVertices.h"
 
+#include "ofxRulr/Utils/BundleAdjuster.h"
+
 #include "ofxCvGui/Widgets/SelectFile.h"
 #include "ofxCvGui/Widgets/Indicator.h"
 #include "ofxCvGui/Widgets/Button.h"
@@ -222,6 +224,7 @@ namespace ofxRulr {
 					this->useExistingParametersAsInitial.set("Use existing data as initial", false);
 					this->projectorReferenceImageFilename.set("Projector reference image filename", "");
 					this->calibrateOnVertexChange.set("Calibrate on vertex change", true);
+					this->solver.set("Solver", CalibrationSolver::OpenCV);
 
 					videoOutputPin->onNewConnection += [this](shared_ptr<System::VideoOutput> videoOutput) {
 						videoOutput->onDrawOutput.addListener([this](ofRectangle & outputRectangle) {
@@ -293,6 +296,7 @@ namespace ofxRulr {
 					ofxRulr::Utils::Serializable::serialize(json, this->dragVerticesEnabled);
 					ofxRulr::Utils::Serializable::serialize(json, this->calibrateOnVertexChange);
 					ofxRulr::Utils::Serializable::serialize(json, this->useExistingParametersAsInitial);
+					ofxRulr::Utils::Serializable::serialize(json, this->solver);
 				}
 
 				//---------
@@ -308,6 +312,7 @@ namespace ofxRulr {
 					ofxRulr::Utils::Serializable::deserialize(json, this->dragVerticesEnabled);
 					ofxRulr::Utils::Serializable::deserialize(json, this->calibrateOnVertexChange);
 					ofxRulr::Utils::Serializable::deserialize(json, this->useExistingParametersAsInitial);
+					ofxRulr::Utils::Serializable::deserialize(json, this->solver);
 				}
 
 				//---------
@@ -345,6 +350,13 @@ namespace ofxRulr {
 
 					inspector->add(new Widgets::Toggle(this->calibrateOnVertexChange));
 					inspector->add(new Widgets::Toggle(this->useExistingParametersAsInitial));
+					{
+						auto widget = inspector->addMultipleChoice("Solver", { "OpenCV", "Sparse" });
+						widget->setSelection(this->solver.get().get());
+						widget->onValueChange += [this](int value) {
+							this->solver = (CalibrationSolver::Options) value;
+						};
+					}
 					inspector->add(new Widgets::LiveValue<float>("Reprojection error", [this]() {
 						return this->reprojectionError;
 					}));
@@ -484,7 +496,9 @@ namespace ofxRulr {
 					//FIT
 					//--
 					//
-					auto reprojectionError = cv::calibrateCamera(toCv(worldRows), toCv(viewRows), viewSize, cameraMatrix, distortionCoefficients, rotations, translations, flags);
+					auto reprojectionError = this->solver.get() == CalibrationSolver::Sparse
+						? ofxRulr::Utils::BundleAdjuster::calibrateCamera(toCv(worldRows), toCv(viewRows), viewSize, cameraMatrix, distortionCoefficients, rotations, translations, flags)
+						: cv::calibrateCamera(toCv(worldRows), toCv(viewRows), viewSize, cameraMatrix, distortionCoefficients, rotations, translations, flags);
 					//we might have thrown at this point
 					//
 					//--
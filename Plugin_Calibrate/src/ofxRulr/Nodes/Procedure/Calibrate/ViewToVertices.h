@@ -42,6 +42,7 @@ namespace ofxRulr {
 					ofParameter<bool> dragVerticesEnabled;
 					ofParameter<bool> calibrateOnVertexChange;
 					ofParameter<bool> useExistingParametersAsInitial;
+					ofParameter<CalibrationSolver> solver;
 					bool success;
 					float reprojectionError;
 					weak_ptr<IReferenceVertices::Vertex> selection;
@@ -0,0 +1,429 @@
+#include "pch_Plugin_Calibrate.h"
+#include "MovingHeadSolver.h"
+
+#include "ofxRulr/Utils/ParallelFor.h"
+
+#include <mutex>
+#include <random>
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace {
+			const size_t ParameterCount = 7; // position (3), rotation euler (3), tilt offset
+			const double Pi = 3.14159265358979323846;
+			const double RadiansToDegrees = 180.0 / Pi;
+
+			typedef double Matrix3[3][3];
+
+			//----------
+			void rotationX(double angle, Matrix3 & rotation, Matrix3 & derivative) {
+				const auto c = cos(angle), s = sin(angle);
+				const Matrix3 r = { { 1, 0, 0 }, { 0, c, -s }, { 0, s, c } };
+				const Matrix3 d = { { 0, 0, 0 }, { 0, -s, -c }, { 0, c, -s } };
+				memcpy(rotation, r, sizeof(r));
+				memcpy(derivative, d, sizeof(d));
+			}
+
+			//----------
+			void rotationY(double angle, Matrix3 & rotation, Matrix3 & derivative) {
+				const auto c = cos(angle), s = sin(angle);
+				const Matrix3 r = { { c, 0, s }, { 0, 1, 0 }, { -s, 0, c } };
+				const Matrix3 d = { { -s, 0, c }, { 0, 0, 0 }, { -c, 0, -s } };
+				memcpy(rotation, r, sizeof(r));
+				memcpy(derivative, d, sizeof(d));
+			}
+
+			//----------
+			void rotationZ(double angle, Matrix3 & rotation, Matrix3 & derivative) {
+				const auto c = cos(angle), s = sin(angle);
+				const Matrix3 r = { { c, -s, 0 }, { s, c, 0 }, { 0, 0, 1 } };
+				const Matrix3 d = { { -s, -c, 0 }, { c, -s, 0 }, { 0, 0, 0 } };
+				memcpy(rotation, r, sizeof(r));
+				memcpy(derivative, d, sizeof(d));
+			}
+
+			//----------
+			//a^T * b^T * c^T (i.e. (c * b * a)^T)
+			void multiplyTransposed(const Matrix3 & a, const Matrix3 & b, const Matrix3 & c, Matrix3 & result) {
+				Matrix3 ab;
+				for (int i = 0; i < 3; i++) {
+					for (int j = 0; j < 3; j++) {
+						ab[i][j] = a[0][i] * b[j][0] + a[1][i] * b[j][1] + a[2][i] * b[j][2];
+					}
+				}
+				for (int i = 0; i < 3; i++) {
+					for (int j = 0; j < 3; j++) {
+						result[i][j] = ab[i][0] * c[j][0] + ab[i][1] * c[j][1] + ab[i][2] * c[j][2];
+					}
+				}
+			}
+
+			//----------
+			void multiply(const Matrix3 & m, const double * v, double * result) {
+				for (int i = 0; i < 3; i++) {
+					result[i] = m[i][0] * v[0] + m[i][1] * v[1] + m[i][2] * v[2];
+				}
+			}
+
+			//----------
+			double wrapDegrees(double angle) {
+				while (angle > 180.0) {
+					angle -= 360.0;
+				}
+				while (angle < -180.0) {
+					angle += 360.0;
+				}
+				return angle;
+			}
+
+			struct Problem {
+				vector<double> world; // xyz per observation
+				vector<double> panTilt; // pan, tilt per observation
+				size_t count;
+
+				//----------
+				//Sum of squared pan/tilt errors. With jtj and jtr, also accumulates the normal equations (J^T J and J^T r)
+				double evaluate(const double * parameters, double * jtj, double * jtr) const {
+					//object space = rotation^T * (world - position), with rotation = Rz * Ry * Rx as glm::quat(euler)
+					Matrix3 rx, ry, rz, drx, dry, drz;
+					rotationX(parameters[3], rx, drx);
+					rotationY(parameters[4], ry, dry);
+					rotationZ(parameters[5], rz, drz);
+
+					Matrix3 inverseRotation, dInverseRotation[3];
+					multiplyTransposed(rx, ry, rz, inverseRotation);
+					if (jtj) {
+						multiplyTransposed(drx, ry, rz, dInverseRotation[0]);
+						multiplyTransposed(rx, dry, rz, dInverseRotation[1]);
+						multiplyTransposed(rx, ry, drz, dInverseRotation[2]);
+						memset(jtj, 0, sizeof(double) * ParameterCount * ParameterCount);
+						memset(jtr, 0, sizeof(double) * ParameterCount);
+					}
+
+					const auto tiltOffset = parameters[6];
+					double cost = 0.0;
+
+					for (size_t i = 0; i < this->count; i++) {
+						const double offset[3] = {
+							this->world[i * 3 + 0] - parameters[0]
+							, this->world[i * 3 + 1] - parameters[1]
+							, this->world[i * 3 + 2] - parameters[2]
+						};
+						double o[3];
+						multiply(inverseRotation, offset, o);
+
+						const auto horizontalSquared = o[0] * o[0] + o[2] * o[2];
+						const auto radiusSquared = horizontalSquared + o[1] * o[1];
+						if (horizontalSquared < 1e-18) {
+							//directly above or below, pan is undefined
+							continue;
+						}
+						const auto horizontal = sqrt(horizontalSquared);
+						const auto radius = sqrt(radiusSquared);
+
+						const auto pan = atan2(o[2], o[0]) * RadiansToDegrees - 90.0;
+						const auto tilt = acos(max(-1.0, min(1.0, -o[1] / radius))) * RadiansToDegrees + tiltOffset;
+
+						const double residuals[2] = {
+							wrapDegrees(pan - this->panTilt[i * 2 + 0])
+							, tilt - this->panTilt[i * 2 + 1]
+						};
+						cost += residuals[0] * residuals[0] + residuals[1] * residuals[1];
+
+						if (jtj) {
+							//derivatives of pan and tilt with respect to the object space point
+							const double dPan_dO[3] = {
+								-o[2] / horizontalSquared * RadiansToDegrees
+								, 0.0
+								, o[0] / horizontalSquared * RadiansToDegrees
+							};
+							const double dTilt_dO[3] = {
+								-o[0] * o[1] / (radiusSquared * horizontal) * RadiansToDegrees
+								, horizontal / radiusSquared * RadiansToDegrees
+								, -o[1] * o[2] / (radiusSquared * horizontal) * RadiansToDegrees
+							};
+
+							double rows[2][ParameterCount];
+							for (int row = 0; row < 2; row++) {
+								const auto & dR_dO = row == 0 ? dPan_dO : dTilt_dO;
+
+								//position : dO/dPosition = -inverseRotation
+								for (int j = 0; j < 3; j++) {
+									rows[row][j] = -(dR_dO[0] * inverseRotation[0][j] + dR_dO[1] * inverseRotation[1][j] + dR_dO[2] * inverseRotation[2][j]);
+								}
+
+								//rotation : dO/dEuler = dInverseRotation * offset
+								for (int j = 0; j < 3; j++) {
+									double dO[3];
+									multiply(dInverseRotation[j], offset, dO);
+									rows[row][3 + j] = dR_dO[0] * dO[0] + dR_dO[1] * dO[1] + dR_dO[2] * dO[2];
+								}
+
+								rows[row][6] = row == 0 ? 0.0 : 1.0;
+							}
+
+							for (int row = 0; row < 2; row++) {
+								for (size_t j = 0; j < ParameterCount; j++) {
+									jtr[j] += rows[row][j] * residuals[row];
+									for (size_t k = 0; k <= j; k++) {
+										jtj[j * ParameterCount + k] += rows[row][j] * rows[row][k];
+									}
+								}
+							}
+						}
+					}
+
+					if (jtj) {
+						for (size_t j = 0; j < ParameterCount; j++) {
+							for (size_t k = j + 1; k < ParameterCount; k++) {
+								jtj[j * ParameterCount + k] = jtj[k * ParameterCount + j];
+							}
+						}
+					}
+
+					return cost;
+				}
+			};
+
+			//----------
+			///In place Cholesky of a symmetric positive definite matrix (lower triangle). Returns false if not positive definite
+			bool choleskyDecompose(double * A, size_t n) {
+				for (size_t j = 0; j < n; j++) {
+					auto diagonal = A[j * n + j];
+					for (size_t k = 0; k < j; k++) {
+						diagonal -= A[j * n + k] * A[j * n + k];
+					}
+					if (!(diagonal > 0.0)) {
+						return false;
+					}
+					diagonal = sqrt(diagonal);
+					A[j * n + j] = diagonal;
+					for (size_t i = j + 1; i < n; i++) {
+						auto value = A[i * n + j];
+						for (size_t k = 0; k < j; k++) {
+							value -= A[i * n + k] * A[j * n + k];
+						}
+						A[i * n + j] = value / diagonal;
+					}
+				}
+				return true;
+			}
+
+			//----------
+			void choleskySolve(const double * L, size_t n, double * x) {
+				for (size_t i = 0; i < n; i++) {
+					auto value = x[i];
+					for (size_t k = 0; k < i; k++) {
+						value -= L[i * n + k] * x[k];
+					}
+					x[i] = value / L[i * n + i];
+				}
+				for (size_t i = n; i-- > 0; ) {
+					auto value = x[i];
+					for (size_t k = i + 1; k < n; k++) {
+						value -= L[k * n + i] * x[k];
+					}
+					x[i] = value / L[i * n + i];
+				}
+			}
+
+			//----------
+			//Levenberg-Marquardt from the parameters in place. Returns the final cost
+			double refine(const Problem & problem, double * parameters, size_t maximumIterations, const std::atomic<bool> * cancelled) {
+				double jtj[ParameterCount * ParameterCount];
+				double jtr[ParameterCount];
+				double lambda = 1e-3;
+
+				auto cost = problem.evaluate(parameters, jtj, jtr);
+				for (size_t iteration = 0; iteration < maximumIterations; iteration++) {
+					if (cancelled && cancelled->load()) {
+						break;
+					}
+
+					//try steps with increasing damping until the cost goes down
+					bool accepted = false;
+					bool converged = false;
+					for (int attempt = 0; attempt < 10 && !accepted; attempt++) {
+						double A[ParameterCount * ParameterCount];
+						memcpy(A, jtj, sizeof(A));
+						for (size_t j = 0; j < ParameterCount; j++) {
+							A[j * ParameterCount + j] += lambda * max(jtj[j * ParameterCount + j], 1e-9);
+						}
+						double step[ParameterCount];
+						for (size_t j = 0; j < ParameterCount; j++) {
+							step[j] = -jtr[j];
+						}
+						if (!choleskyDecompose(A, ParameterCount)) {
+							lambda *= 10.0;
+							continue;
+						}
+						choleskySolve(A, ParameterCount, step);
+
+						double candidate[ParameterCount];
+						for (size_t j = 0; j < ParameterCount; j++) {
+							candidate[j] = parameters[j] + step[j];
+						}
+						auto newCost = problem.evaluate(candidate, nullptr, nullptr);
+
+						if (newCost < cost) {
+							converged = (cost - newCost) <= 1e-10 * cost;
+							memcpy(parameters, candidate, sizeof(candidate));
+							cost = problem.evaluate(parameters, jtj, jtr);
+							lambda = max(lambda / 10.0, 1e-12);
+							accepted = true;
+						}
+						else {
+							lambda *= 10.0;
+						}
+					}
+
+					if (!accepted || converged) {
+						break;
+					}
+				}
+				return cost;
+			}
+		}
+
+		//----------
+		MovingHeadSolver::Result MovingHeadSolver::solve(const vector<Observation> & observations
+			, const ofVec3f & initialPosition
+			, const ofVec3f & initialRotationEuler
+			, const Settings & settings
+			, Progress * progress) {
+			if (observations.size() < 4) {
+				throw(ofxRulr::Exception("Need at least 4 observations to fit a moving head (have " + ofToString(observations.size()) + ")"));
+			}
+
+			auto startTime = chrono::high_resolution_clock::now();
+
+			Problem problem;
+			problem.count = observations.size();
+			ofVec3f centroid;
+			for (const auto & observation : observations) {
+				problem.world.push_back(observation.world.x);
+				problem.world.push_back(observation.world.y);
+				problem.world.push_back(observation.world.z);
+				problem.panTilt.push_back(observation.panTilt.x);
+				problem.panTilt.push_back(observation.panTilt.y);
+				centroid += observation.world;
+			}
+			centroid /= (float) observations.size();
+
+			//first start is the initial guess if it's valid
+			bool initialValid = true;
+			for (int i = 0; i < 3; i++) {
+				initialValid &= !isnan(initialPosition[i]) && !isnan(initialRotationEuler[i]);
+			}
+			const auto spreadCenter = initialValid ? initialPosition : centroid;
+
+			const auto startCount = max<size_t>(settings.starts, 1);
+			const std::atomic<bool> * cancelled = progress ? &progress->cancelled : nullptr;
+			if (progress) {
+				progress->startsCompleted = 0;
+				progress->bestResidual = numeric_limits<float>::infinity();
+			}
+
+			//parallelFor hands the starts out one at a time, so threads which finish early pick up more
+			mutex bestMutex;
+			double bestCost = numeric_limits<double>::infinity();
+			double bestParameters[ParameterCount] = { 0 };
+			size_t bestStart = 0;
+			std::atomic<size_t> startsCompleted(0);
+
+			parallelFor(startCount, [&](size_t start) {
+				if (cancelled && cancelled->load()) {
+					return;
+				}
+
+				double parameters[ParameterCount];
+				if (start == 0 && initialValid) {
+					parameters[0] = initialPosition.x;
+					parameters[1] = initialPosition.y;
+					parameters[2] = initialPosition.z;
+					parameters[3] = initialRotationEuler.x;
+					parameters[4] = initialRotationEuler.y;
+					parameters[5] = initialRotationEuler.z;
+					parameters[6] = 0.0;
+				}
+				else {
+					//seeded per start, so the result doesn't depend on the thread count
+					mt19937 randomGenerator(settings.seed + (uint32_t) start);
+					uniform_real_distribution<double> unit(-1.0, 1.0);
+					uniform_real_distribution<double> angle(-Pi, Pi);
+
+					double offset[3];
+					do {
+						offset[0] = unit(randomGenerator);
+						offset[1] = unit(randomGenerator);
+						offset[2] = unit(randomGenerator);
+					} while (offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2] > 1.0);
+
+					for (int i = 0; i < 3; i++) {
+						parameters[i] = spreadCenter[i] + offset[i] * settings.positionSpread;
+						parameters[3 + i] = angle(randomGenerator);
+					}
+					parameters[6] = 0.0;
+				}
+
+				auto cost = refine(problem, parameters, settings.maximumIterations, cancelled);
+				const auto completed = ++startsCompleted;
+
+				bool valid = !isnan(cost);
+				for (size_t i = 0; i < ParameterCount; i++) {
+					valid &= !isnan(parameters[i]);
+				}
+
+				{
+					lock_guard<mutex> lock(bestMutex);
+					//ties go to the lower start so the result is deterministic
+					if (valid && (cost < bestCost || (cost == bestCost && start < bestStart))) {
+						bestCost = cost;
+						memcpy(bestParameters, parameters, sizeof(parameters));
+						bestStart = start;
+					}
+					if (progress) {
+						progress->bestResidual = (float) sqrt(bestCost / (double)(problem.count * 2));
+						progress->startsCompleted = completed;
+					}
+				}
+			}, settings.threadCount);
+
+			Result result;
+			result.cancelled = cancelled && cancelled->load();
+			result.startsCompleted = startsCompleted;
+			result.success = bestCost < numeric_limits<double>::infinity();
+			if (result.success) {
+				result.position = ofVec3f(bestParameters[0], bestParameters[1], bestParameters[2]);
+				result.rotationEuler = ofVec3f(bestParameters[3], bestParameters[4], bestParameters[5]);
+				result.tiltOffset = (float) bestParameters[6];
+				result.residual = (float) sqrt(bestCost / (double)(problem.count * 2));
+				result.bestStart = bestStart;
+			}
+			result.duration = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+			return result;
+		}
+
+		//----------
+		ofVec2f MovingHeadSolver::getPanTilt(const ofVec3f & world, const ofVec3f & position, const ofVec3f & rotationEuler, float tiltOffset) {
+			Matrix3 rx, ry, rz, unused;
+			rotationX(rotationEuler.x, rx, unused);
+			rotationY(rotationEuler.y, ry, unused);
+			rotationZ(rotationEuler.z, rz, unused);
+			Matrix3 inverseRotation;
+			multiplyTransposed(rx, ry, rz, inverseRotation);
+
+			const double offset[3] = { world.x - position.x, world.y - position.y, world.z - position.z };
+			double o[3];
+			multiply(inverseRotation, offset, o);
+
+			const auto radius = sqrt(o[0] * o[0] + o[1] * o[1] + o[2] * o[2]);
+			auto pan = atan2(o[2], o[0]) * RadiansToDegrees - 90.0;
+			if (pan < -180.0) {
+				pan += 360.0;
+			}
+			auto tilt = acos(-o[1] / radius) * RadiansToDegrees + tiltOffset;
+			return ofVec2f(pan, tilt);
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+namespace ofxRulr {
+	namespace Utils {
+		///Fits a moving head's position, rotation (euler, radians) and tilt offset to pan/tilt readings aimed at known
+		///world points. Levenberg-Marquardt with the analytic Jacobian of the pan/tilt aiming model is run from many
+		///seeded starts across several threads and the lowest residual is kept, so a poor initial guess doesn't land
+		///in a local minimum. The aiming model is DMX::MovingHead::getPanTiltForTargetInObjectSpace.
+		class MovingHeadSolver {
+		public:
+			struct Observation {
+				ofVec3f world;
+				ofVec2f panTilt; // degrees
+			};
+
+			struct Settings {
+				size_t starts = 64; // the initial guess is the first start
+				size_t maximumIterations = 100;
+				float positionSpread = 2.0f; // m, radius around the initial position (or the targets' centroid) for random starts
+				size_t threadCount = 0; // 0 for hardware concurrency
+				uint32_t seed = 0;
+			};
+
+			///Shared with the caller while a solve runs (e.g. from a background thread)
+			struct Progress {
+				std::atomic<size_t> startsCompleted{ 0 };
+				std::atomic<float> bestResidual{ 0.0f };
+				std::atomic<bool> cancelled{ false };
+			};
+
+			struct Result {
+				bool success = false;
+				bool cancelled = false;
+				ofVec3f position;
+				ofVec3f rotationEuler;
+				float tiltOffset = 0.0f;
+				float residual = 0.0f; // degrees RMS over pan and tilt
+				size_t startsCompleted = 0;
+				size_t bestStart = 0;
+				float duration = 0.0f; // ms
+			};
+
+			///progress can be nullptr. Throws if there are fewer than 4 observations (7 parameters, 2 readings each)
+			static Result solve(const vector<Observation> &
+				, const ofVec3f & initialPosition
+				, const ofVec3f & initialRotationEuler
+				, const Settings &
+				, Progress * progress);
+
+			///Pan/tilt (degrees) for the moving head with these parameters aiming at a world point
+			static ofVec2f getPanTilt(const ofVec3f & world, const ofVec3f & position, const ofVec3f & rotationEuler, float tiltOffset);
+		};
+	}
+}
@@ -0,0 +1,404 @@
+#include "pch_Plugin_Calibrate.h"
+#include "TiledDelaunay.h"
+
+#include "ofxRulr/Utils/ParallelFor.h"
+
+#include "ofxTriangle.h"
+
+#include <unordered_set>
+
+namespace ofxRulr {
+	namespace Utils {
+		namespace {
+			//half open pixel range
+			struct Rect {
+				int x0, y0, x1, y1;
+
+				bool contains(int x, int y) const {
+					return x >= this->x0 && x < this->x1 && y >= this->y0 && y < this->y1;
+				}
+
+				bool contains(const Rect & other) const {
+					return other.x0 >= this->x0 && other.x1 <= this->x1 && other.y0 >= this->y0 && other.y1 <= this->y1;
+				}
+			};
+
+			struct Circle {
+				double x, y, radius;
+			};
+
+			//----------
+			Circle getCircumcircle(int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t cx, int64_t cy) {
+				//relative to a to keep the precision
+				const double bdx = (double) (bx - ax), bdy = (double) (by - ay);
+				const double cdx = (double) (cx - ax), cdy = (double) (cy - ay);
+				const double d = 2.0 * (bdx * cdy - bdy * cdx);
+				const double b2 = bdx * bdx + bdy * bdy;
+				const double c2 = cdx * cdx + cdy * cdy;
+				const double ux = (cdy * b2 - bdy * c2) / d;
+				const double uy = (bdx * c2 - cdx * b2) / d;
+				return Circle{ ax + ux, ay + uy, sqrt(ux * ux + uy * uy) };
+			}
+
+			//----------
+			//exact for coordinates up to 2^16
+			bool isInsideCircumcircle(int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t cx, int64_t cy, int64_t dx, int64_t dy) {
+				const auto adx = ax - dx, ady = ay - dy;
+				const auto bdx = bx - dx, bdy = by - dy;
+				const auto cdx = cx - dx, cdy = cy - dy;
+				const auto determinant = (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+					+ (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy)
+					+ (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+				const auto orientation = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+				return orientation > 0 ? determinant > 0 : determinant < 0;
+			}
+
+			//----------
+			uint64_t hashCombine(uint64_t hash, uint64_t value) {
+				//FNV-1a
+				hash ^= value;
+				hash *= 1099511628211ULL;
+				return hash;
+			}
+
+			const uint64_t hashSeed = 14695981039346656037ULL;
+
+			//the points bucketed by tile
+			struct Grid {
+				int width, height, tileSize, tilesX, tilesY;
+				vector<vector<uint32_t>> buckets;
+				vector<uint64_t> bucketHashes;
+
+				//----------
+				Rect getTileRect(int tileX, int tileY) const {
+					return Rect{ tileX * this->tileSize
+						, tileY * this->tileSize
+						, min((tileX + 1) * this->tileSize, this->width)
+						, min((tileY + 1) * this->tileSize, this->height) };
+				}
+
+				//----------
+				Rect expand(const Rect & rect, int margin) const {
+					return Rect{ max(rect.x0 - margin, 0)
+						, max(rect.y0 - margin, 0)
+						, min(rect.x1 + margin, this->width)
+						, min(rect.y1 + margin, this->height) };
+				}
+
+				//----------
+				Rect getBounds(const Circle & circle) const {
+					//clamp before casting, nearly flat triangles have enormous circles
+					auto clampX = [this](double x) { return (int) max(0.0, min(x, (double) this->width)); };
+					auto clampY = [this](double y) { return (int) max(0.0, min(y, (double) this->height)); };
+					return Rect{ clampX(floor(circle.x - circle.radius))
+						, clampY(floor(circle.y - circle.radius))
+						, clampX(ceil(circle.x + circle.radius) + 1)
+						, clampY(ceil(circle.y + circle.radius) + 1) };
+				}
+
+				//----------
+				///Calls action(bucketIndex, tileRect) for each bucket overlapping rect
+				template<typename Action>
+				void forEachBucket(const Rect & rect, const Action & action) const {
+					if (rect.x1 <= rect.x0 || rect.y1 <= rect.y0) {
+						return;
+					}
+					const auto lastTileX = (rect.x1 - 1) / this->tileSize;
+					const auto lastTileY = (rect.y1 - 1) / this->tileSize;
+					for (int tileY = rect.y0 / this->tileSize; tileY <= lastTileY; tileY++) {
+						for (int tileX = rect.x0 / this->tileSize; tileX <= lastTileX; tileX++) {
+							action(tileX + tileY * this->tilesX, this->getTileRect(tileX, tileY));
+						}
+					}
+				}
+
+				//----------
+				void gather(const Rect & rect, vector<uint32_t> & pixelIndices, vector<uint32_t> & dependencies) const {
+					pixelIndices.clear();
+					this->forEachBucket(rect, [&](int bucketIndex, const Rect & tileRect) {
+						dependencies.push_back(bucketIndex);
+						const auto & bucket = this->buckets[bucketIndex];
+						if (rect.contains(tileRect)) {
+							pixelIndices.insert(pixelIndices.end(), bucket.begin(), bucket.end());
+						}
+						else {
+							for (auto pixelIndex : bucket) {
+								if (rect.contains(pixelIndex % this->width, pixelIndex / this->width)) {
+									pixelIndices.push_back(pixelIndex);
+								}
+							}
+						}
+					});
+				}
+
+				//----------
+				bool hasPointInCircumcircle(int ax, int ay, int bx, int by, int cx, int cy, const Circle & circle, const Rect & excluded, vector<uint32_t> & dependencies) const {
+					bool found = false;
+					this->forEachBucket(this->getBounds(circle), [&](int bucketIndex, const Rect & tileRect) {
+						if (found || excluded.contains(tileRect)) {
+							return;
+						}
+
+						//skip buckets the circle doesn't touch
+						const auto nearestX = max((double) tileRect.x0, min(circle.x, (double) tileRect.x1));
+						const auto nearestY = max((double) tileRect.y0, min(circle.y, (double) tileRect.y1));
+						const auto distance = sqrt((nearestX - circle.x) * (nearestX - circle.x) + (nearestY - circle.y) * (nearestY - circle.y));
+						if (distance > circle.radius + 1.0) {
+							return;
+						}
+
+						dependencies.push_back(bucketIndex);
+						for (auto pixelIndex : this->buckets[bucketIndex]) {
+							const int x = pixelIndex % this->width;
+							const int y = pixelIndex / this->width;
+							if (!excluded.contains(x, y) && isInsideCircumcircle(ax, ay, bx, by, cx, cy, x, y)) {
+								found = true;
+								return;
+							}
+						}
+					});
+					return found;
+				}
+
+				//----------
+				uint64_t hash(const vector<uint32_t> & dependencies) const {
+					auto hash = hashSeed;
+					for (auto bucketIndex : dependencies) {
+						hash = hashCombine(hash, bucketIndex);
+						hash = hashCombine(hash, this->bucketHashes[bucketIndex]);
+					}
+					return hash;
+				}
+			};
+
+			//----------
+			void triangulatePoints(const vector<uint32_t> & pixelIndices, int width, vector<uint32_t> & triangles) {
+				triangles.clear();
+				if (pixelIndices.size() < 3) {
+					return;
+				}
+
+				vector<Delaunay::Point> points;
+				points.reserve(pixelIndices.size());
+				for (auto pixelIndex : pixelIndices) {
+					points.emplace_back(pixelIndex % width, pixelIndex / width);
+				}
+
+				Delaunay delaunay(points);
+				delaunay.Triangulate();
+				for (auto it = delaunay.fbegin(); it != delaunay.fend(); ++it) {
+					triangles.push_back(pixelIndices[delaunay.Org(it)]);
+					triangles.push_back(pixelIndices[delaunay.Dest(it)]);
+					triangles.push_back(pixelIndices[delaunay.Apex(it)]);
+				}
+			}
+		}
+
+		//----------
+		TiledDelaunay::Statistics TiledDelaunay::triangulate(const vector<uint32_t> & pixelIndices, int width, int height, vector<uint32_t> & triangles, const Settings & settings) {
+			const auto tileSize = max(settings.tileSize, 1);
+			const auto halo = max(settings.halo, 1);
+			const auto maxHalo = max(settings.maxHalo, halo);
+
+			if (!settings.incremental || width != this->width || height != this->height || tileSize != this->tileSize) {
+				this->clear();
+				this->width = width;
+				this->height = height;
+				this->tileSize = tileSize;
+			}
+
+			Grid grid;
+			grid.width = width;
+			grid.height = height;
+			grid.tileSize = tileSize;
+			grid.tilesX = (width + tileSize - 1) / tileSize;
+			grid.tilesY = (height + tileSize - 1) / tileSize;
+			grid.buckets.resize(grid.tilesX * grid.tilesY);
+			for (auto pixelIndex : pixelIndices) {
+				const auto x = pixelIndex % width;
+				const auto y = pixelIndex / width;
+				grid.buckets[x / tileSize + (y / tileSize) * grid.tilesX].push_back(pixelIndex);
+			}
+			grid.bucketHashes.resize(grid.buckets.size());
+			for (size_t i = 0; i < grid.buckets.size(); i++) {
+				auto hash = hashSeed;
+				for (auto pixelIndex : grid.buckets[i]) {
+					hash = hashCombine(hash, pixelIndex);
+				}
+				grid.bucketHashes[i] = hash;
+			}
+
+			this->tiles.resize(grid.buckets.size());
+
+			enum class Outcome { Reused, Triangulated, Widened };
+			vector<Outcome> outcomes(this->tiles.size());
+			vector<size_t> unresolvedTriangles(this->tiles.size(), 0);
+
+			auto processTile = [&](size_t tileIndex) {
+				auto & tile = this->tiles[tileIndex];
+				const auto core = grid.getTileRect(tileIndex % grid.tilesX, tileIndex / grid.tilesX);
+
+				if (tile.valid && grid.hash(tile.dependencies) == tile.hash) {
+					outcomes[tileIndex] = Outcome::Reused;
+					return;
+				}
+
+				outcomes[tileIndex] = Outcome::Triangulated;
+
+				auto isInCore = [&core, width](uint32_t pixelIndex) {
+					return core.contains(pixelIndex % width, pixelIndex / width);
+				};
+
+				vector<uint32_t> points;
+				vector<uint32_t> regionTriangles;
+				vector<uint32_t> ringPoints;
+				unordered_set<uint64_t> directedEdges;
+				vector<pair<uint32_t, uint32_t>> hullEdges;
+				auto tileHalo = halo;
+
+				while (true) {
+					const auto region = grid.expand(core, tileHalo);
+					tile.dependencies.clear();
+					grid.gather(region, points, tile.dependencies);
+					triangulatePoints(points, width, regionTriangles);
+
+					tile.triangles.clear();
+					directedEdges.clear();
+					size_t conflicts = 0;
+
+					for (size_t i = 0; i < regionTriangles.size(); i += 3) {
+						auto a = regionTriangles[i];
+						auto b = regionTriangles[i + 1];
+						const auto c = regionTriangles[i + 2];
+						if (!isInCore(a) && !isInCore(b) && !isInCore(c)) {
+							continue;
+						}
+
+						int ax = a % width, ay = a / width;
+						int bx = b % width, by = b / width;
+						const int cx = c % width, cy = c / width;
+
+						//wind them all the same way so that the hull edges are the ones without a twin
+						if ((int64_t) (bx - ax) * (cy - ay) - (int64_t) (by - ay) * (cx - ax) < 0) {
+							swap(a, b);
+							swap(ax, bx);
+							swap(ay, by);
+						}
+						directedEdges.insert((uint64_t) a << 32 | b);
+						directedEdges.insert((uint64_t) b << 32 | c);
+						directedEdges.insert((uint64_t) c << 32 | a);
+
+						//if the circumcircle reaches outside the region then check it against the points out there.
+						//this includes triangles owned by neighbours, since a bad one can be covering for a triangle we're missing
+						const auto circle = getCircumcircle(ax, ay, bx, by, cx, cy);
+						if (!region.contains(grid.getBounds(circle))) {
+							if (grid.hasPointInCircumcircle(ax, ay, bx, by, cx, cy, circle, region, tile.dependencies)) {
+								conflicts++;
+							}
+						}
+
+						//each triangle belongs to the tile containing its lowest pixel index
+						if (isInCore(min(a, min(b, c)))) {
+							tile.triangles.push_back(a);
+							tile.triangles.push_back(b);
+							tile.triangles.push_back(c);
+						}
+					}
+
+					if (conflicts == 0 && tileHalo < maxHalo) {
+						//where the core touches the hull of the region, a point just beyond the halo could be
+						//making triangles we don't have. look for one in the ring the next halo would bring in
+						hullEdges.clear();
+						for (auto edge : directedEdges) {
+							const auto from = (uint32_t) (edge >> 32);
+							const auto to = (uint32_t) edge;
+							if (!directedEdges.count((uint64_t) to << 32 | from) && (isInCore(from) || isInCore(to))) {
+								hullEdges.emplace_back(from, to);
+							}
+						}
+
+						if (!hullEdges.empty()) {
+							grid.gather(grid.expand(core, min(tileHalo * 2, maxHalo)), ringPoints, tile.dependencies);
+							for (auto ringPoint : ringPoints) {
+								const int64_t x = ringPoint % width, y = ringPoint / width;
+								if (region.contains(x, y)) {
+									continue;
+								}
+								for (const auto & hullEdge : hullEdges) {
+									const int64_t fromX = hullEdge.first % width, fromY = hullEdge.first / width;
+									const int64_t toX = hullEdge.second % width, toY = hullEdge.second / width;
+									if ((toX - fromX) * (y - fromY) - (toY - fromY) * (x - fromX) < 0) {
+										conflicts++;
+										break;
+									}
+								}
+								if (conflicts > 0) {
+									break;
+								}
+							}
+						}
+					}
+
+					if (conflicts == 0 || tileHalo >= maxHalo) {
+						unresolvedTriangles[tileIndex] = conflicts;
+						break;
+					}
+
+					tileHalo = min(tileHalo * 2, maxHalo);
+					outcomes[tileIndex] = Outcome::Widened;
+				}
+
+				sort(tile.dependencies.begin(), tile.dependencies.end());
+				tile.dependencies.erase(unique(tile.dependencies.begin(), tile.dependencies.end()), tile.dependencies.end());
+				tile.hash = grid.hash(tile.dependencies);
+				tile.valid = true;
+			};
+
+			//parallelFor hands the tiles out one at a time, which suits their cost varying a lot
+			parallelFor(this->tiles.size(), processTile, settings.threadCount);
+
+			Statistics statistics;
+			statistics.tileCount = this->tiles.size();
+
+			size_t triangleIndexCount = 0;
+			for (const auto & tile : this->tiles) {
+				triangleIndexCount += tile.triangles.size();
+			}
+			triangles.clear();
+			triangles.reserve(triangleIndexCount);
+
+			for (size_t i = 0; i < this->tiles.size(); i++) {
+				const auto & tile = this->tiles[i];
+				triangles.insert(triangles.end(), tile.triangles.begin(), tile.triangles.end());
+
+				switch (outcomes[i]) {
+				case Outcome::Reused:
+					statistics.reusedTiles++;
+					break;
+				case Outcome::Widened:
+					statistics.widenedTiles++;
+					//fall through
+				case Outcome::Triangulated:
+					statistics.triangulatedTiles++;
+					break;
+				}
+				statistics.unresolvedTriangles += unresolvedTriangles[i];
+			}
+
+			return statistics;
+		}
+
+		//----------
+		void TiledDelaunay::triangulateSinglePass(const vector<uint32_t> & pixelIndices, int width, vector<uint32_t> & triangles) {
+			triangulatePoints(pixelIndices, width, triangles);
+		}
+
+		//----------
+		void TiledDelaunay::clear() {
+			this->tiles.clear();
+			this->width = 0;
+			this->height = 0;
+			this->tileSize = 0;
+		}
+	}
+}
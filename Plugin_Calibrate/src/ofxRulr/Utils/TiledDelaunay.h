@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace ofxRulr {
+	namespace Utils {
+		///Delaunay triangulation of points on an integer pixel grid, split into square tiles which are triangulated in parallel.
+		///Each tile is triangulated together with a halo of its neighbours' points and keeps the triangles whose vertex with
+		///the lowest pixel index lies inside it. A kept triangle whose circumcircle contains a point from outside the halo isn't Delaunay in the full set,
+		///so that tile is triangulated again with a wider halo. Co-circular ties along a seam are resolved by each tile on its own.
+		///Tiles are kept between calls, so with incremental set only tiles whose points (or the points around their
+		///triangles) have changed are triangulated again.
+		class TiledDelaunay {
+		public:
+			struct Settings {
+				int tileSize = 128;
+				int halo = 8;
+				int maxHalo = 512;
+				size_t threadCount = 0; // 0 for hardware concurrency
+				bool incremental = true;
+			};
+
+			struct Statistics {
+				size_t tileCount = 0;
+				size_t triangulatedTiles = 0;
+				size_t reusedTiles = 0;
+				size_t widenedTiles = 0;
+				size_t unresolvedTriangles = 0; // still had a conflict at maxHalo
+			};
+
+			///pixelIndices are i + j * width, in ascending order. triangles is filled with pixel index triples.
+			Statistics triangulate(const vector<uint32_t> & pixelIndices, int width, int height, vector<uint32_t> & triangles, const Settings &);
+
+			///All points in one pass, as a reference for the tiled result
+			static void triangulateSinglePass(const vector<uint32_t> & pixelIndices, int width, vector<uint32_t> & triangles);
+
+			void clear();
+		protected:
+			struct Tile {
+				bool valid = false;
+				uint64_t hash = 0; // of the points in the dependencies
+				vector<uint32_t> dependencies; // buckets the triangles were checked against
+				vector<uint32_t> triangles;
+			};
+			vector<Tile> tiles;
+
+			int width = 0;
+			int height = 0;
+			int tileSize = 0;
+		};
+	}
+}
@@ -18,4 +18,8 @@
 #include "ofxRulr/Nodes/Procedure/Calibrate/StereoCalibrate.h"
 #include "ofxRulr/Nodes/Procedure/Calibrate/ViewToVertices.h"
 
+#include "ofxRulr/Nodes/Procedure/Calibrate/Test/BenchmarkBundleAdjuster.h"
+#include "ofxRulr/Nodes/Procedure/Calibrate/Test/BenchmarkMesh2DFromGraycode.h"
+#include "ofxRulr/Nodes/Procedure/Calibrate/Test/BenchmarkMovingHeadToWorld.h"
+
 #include "ofxCvMin.h"
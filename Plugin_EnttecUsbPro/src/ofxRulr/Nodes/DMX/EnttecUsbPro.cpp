@@ -21,6 +21,13 @@ namespace ofxRulr {
 				RULR_NODE_INIT_LISTENER;
 			}
 
+			//----------
+			EnttecUsbPro::~EnttecUsbPro() {
+				//the transmit thread calls our sendUniverse, so it must stop before we're destroyed
+				this->stopTransmitThread();
+				this->disconnect();
+			}
+
 			//----------
 			void EnttecUsbPro::init() {
 				RULR_NODE_SERIALIZATION_LISTENERS;
@@ -51,21 +58,24 @@ namespace ofxRulr {
 			void EnttecUsbPro::connect() {
 				this->disconnect();
 
+				auto sender = make_shared<ofSerial>();
 				try {
-					this->sender = make_shared<ofSerial>();
-					this->sender->setup(this->portName.get(), 57600);
-					if (!this->sender->isInitialized()) {
+					sender->setup(this->portName.get(), 57600);
+					if (!sender->isInitialized()) {
 						throw(Exception("Failed to open port " + this->portName.get()));
 					}
 				}
 				RULR_CATCH_ALL_TO_ALERT;
-				if (this->sender && !this->sender->isInitialized()) {
-					this->sender.reset();
+
+				if (sender->isInitialized()) {
+					auto lock = unique_lock<mutex>(this->senderMutex);
+					this->sender = sender;
 				}
 			}
 
 			//----------
 			void EnttecUsbPro::disconnect() {
+				auto lock = unique_lock<mutex>(this->senderMutex);
 				if (this->sender) {
 					this->sender->close();
 					this->sender.reset();
@@ -73,15 +83,18 @@ namespace ofxRulr {
 			}
 
 			//----------
-			void EnttecUsbPro::sendUniverse(UniverseIndex index, shared_ptr<Universe> universe) {
-				if (this->sender && universe) {
+			void EnttecUsbPro::sendUniverse(UniverseIndex index, const Value * channels) {
+				//called from the transmit thread
+				auto lock = unique_lock<mutex>(this->senderMutex);
+				if (this->sender && channels) {
 					//code taken from ofxDmx
 
 					//we only have one universe, so send it
 
 					ChannelIndex dataSize = 512 + DMX_START_CODE_SIZE;
 					unsigned int packetSize = DMX_PRO_HEADER_SIZE + dataSize + DMX_PRO_END_SIZE;
-					DMX::Value * packet = new DMX::Value[packetSize];
+					this->packet.resize(packetSize);
+					auto packet = this->packet.data();
 
 					// header
 					packet[0] = DMX_PRO_START_MSG;
@@ -91,14 +104,12 @@ namespace ofxRulr {
 
 														// data
 					packet[4] = DMX_START_CODE; // first data byte
-					memcpy(packet + 5, universe->getChannels() + 1, 512);
+					memcpy(packet + 5, channels + 1, 512);
 
 					// end
 					packet[packetSize - 1] = DMX_PRO_END_MSG;
 
 					this->sender->writeBytes(&packet[0], packetSize);
-
-					delete[] packet;
 				}
 			}
 
@@ -9,6 +9,7 @@ namespace ofxRulr {
 			class EnttecUsbPro : public DMX::Transmit {
 			public:
 				EnttecUsbPro();
+				~EnttecUsbPro();
 				void init();
 				string getTypeName() const;
 
@@ -18,11 +19,13 @@ namespace ofxRulr {
 				void connect();
 				void disconnect();
 
-				void sendUniverse(UniverseIndex, shared_ptr<Universe>) override;
+				void sendUniverse(UniverseIndex, const Value * channels) override;
 
 				void populateInspector(ofxCvGui::InspectArguments &);
 
 				shared_ptr<ofSerial> sender;
+				mutex senderMutex; // sender is used from the transmit thread
+				vector<DMX::Value> packet;
 
 				ofParameter<string> portName;
 			};
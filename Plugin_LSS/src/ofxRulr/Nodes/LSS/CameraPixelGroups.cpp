@@ -0,0 +1,211 @@
+#include "pch_Plugin_LSS.h"
+#include "CameraPixelGroups.h"
+
+#include "ofxRulr/Utils/ParallelFor.h"
+
+#include <fstream>
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace LSS {
+			namespace {
+				static_assert(sizeof(ofVec2f) == sizeof(float) * 2, "ofVec2f must be packed to save it directly");
+
+				struct FileHeader {
+					char magic[8];
+					uint32_t version;
+					uint32_t reserved;
+					uint64_t groupCount;
+					uint64_t sampleCount;
+				};
+				const char fileMagic[8] = { 'R', 'U', 'L', 'R', 'C', 'P', 'G', '\0' };
+				const uint32_t fileVersion = 1;
+
+				//----------
+				ofVec2f getTrimmedMean(const ofVec2f * samples, size_t count, vector<float> & distances, vector<float> & partitioned) {
+					if (count == 1) {
+						return samples[0];
+					}
+
+					//plain loops over packed floats, so that the compiler can vectorise them
+					float sumX = 0.0f;
+					float sumY = 0.0f;
+					for (size_t i = 0; i < count; i++) {
+						sumX += samples[i].x;
+						sumY += samples[i].y;
+					}
+					const auto meanX = sumX / (float) count;
+					const auto meanY = sumY / (float) count;
+
+					distances.resize(count);
+					for (size_t i = 0; i < count; i++) {
+						const auto dx = samples[i].x - meanX;
+						const auto dy = samples[i].y - meanY;
+						distances[i] = dx * dx + dy * dy;
+					}
+
+					//80th percentile of the squared distances. nth_element gives the same value as a full sort
+					partitioned.assign(distances.begin(), distances.end());
+					const auto thresholdIndex = (size_t)((float)count * 0.8f);
+					nth_element(partitioned.begin(), partitioned.begin() + thresholdIndex, partitioned.end());
+					auto threshold = partitioned[thresholdIndex];
+					if (threshold < 2.0f) {
+						threshold = 2.0f; // minimum threshold is 2px (always include in trimmed mean)
+					}
+
+					float trimmedX = 0.0f;
+					float trimmedY = 0.0f;
+					float trimmedCount = 0.0f;
+					for (size_t i = 0; i < count; i++) {
+						const auto weight = distances[i] < threshold ? 1.0f : 0.0f;
+						trimmedX += samples[i].x * weight;
+						trimmedY += samples[i].y * weight;
+						trimmedCount += weight;
+					}
+
+					if (trimmedCount == 0.0f) {
+						//all the samples are at the threshold distance (e.g. two samples far apart)
+						return ofVec2f(meanX, meanY);
+					}
+					return ofVec2f(trimmedX / trimmedCount, trimmedY / trimmedCount);
+				}
+			}
+
+			//----------
+			void CameraPixelGroups::getTrimmedMeans(vector<ofVec2f> & means, size_t threadCount) const {
+				const auto groupCount = this->size();
+				means.resize(groupCount);
+
+				//in blocks, so that each block reuses its scratch space and a handful of groups stays on this thread
+				const size_t groupsPerBlock = 4096;
+				const auto blockCount = (groupCount + groupsPerBlock - 1) / groupsPerBlock;
+
+				Utils::parallelFor(blockCount, [this, &means, groupCount, groupsPerBlock](size_t blockIndex) {
+					vector<float> distances;
+					vector<float> partitioned;
+					const auto end = min((blockIndex + 1) * groupsPerBlock, groupCount);
+					for (size_t i = blockIndex * groupsPerBlock; i < end; i++) {
+						const auto offset = this->offsets[i];
+						const auto count = this->offsets[i + 1] - offset;
+						means[i] = getTrimmedMean(this->cameraPixels.data() + offset, count, distances, partitioned);
+					}
+				}, threadCount);
+			}
+
+			//----------
+			void CameraPixelGroups::save(const string & filename) const {
+				ofstream file(ofToDataPath(filename, true), ios::binary);
+				if (!file.is_open()) {
+					throw(ofxRulr::Exception("Couldn't open " + filename + " for writing"));
+				}
+
+				FileHeader header;
+				memcpy(header.magic, fileMagic, sizeof(fileMagic));
+				header.version = fileVersion;
+				header.reserved = 0;
+				header.groupCount = this->projectorPixels.size();
+				header.sampleCount = this->cameraPixels.size();
+
+				file.write((const char *) &header, sizeof(header));
+				file.write((const char *) this->projectorPixels.data(), this->projectorPixels.size() * sizeof(uint32_t));
+				file.write((const char *) this->offsets.data(), this->offsets.size() * sizeof(uint32_t));
+				file.write((const char *) this->cameraPixels.data(), this->cameraPixels.size() * sizeof(ofVec2f));
+
+				if (!file.good()) {
+					throw(ofxRulr::Exception("Failed to write " + filename));
+				}
+			}
+
+			//----------
+			void CameraPixelGroups::load(const string & filename) {
+				this->clear();
+
+				ifstream file(ofToDataPath(filename, true), ios::binary);
+				if (!file.is_open()) {
+					throw(ofxRulr::Exception("Couldn't open " + filename));
+				}
+
+				FileHeader header;
+				file.read((char *) &header, sizeof(header));
+				if (!file.good() || memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0) {
+					throw(ofxRulr::Exception(filename + " isn't a camera pixel groups file"));
+				}
+				if (header.version != fileVersion) {
+					throw(ofxRulr::Exception(filename + " has version " + ofToString(header.version) + ", expected " + ofToString(fileVersion)));
+				}
+
+				//check the file is long enough before allocating anything
+				const auto dataStart = file.tellg();
+				file.seekg(0, ios::end);
+				const auto dataSize = (uint64_t) (file.tellg() - dataStart);
+				file.seekg(dataStart);
+				const auto expectedSize = header.groupCount * sizeof(uint32_t) * 2 + sizeof(uint32_t)
+					+ header.sampleCount * sizeof(ofVec2f);
+				if (dataSize != expectedSize) {
+					throw(ofxRulr::Exception(filename + " is truncated or corrupt"));
+				}
+
+				this->projectorPixels.resize((size_t) header.groupCount);
+				this->offsets.resize((size_t) header.groupCount + 1);
+				this->cameraPixels.resize((size_t) header.sampleCount);
+				file.read((char *) this->projectorPixels.data(), this->projectorPixels.size() * sizeof(uint32_t));
+				file.read((char *) this->offsets.data(), this->offsets.size() * sizeof(uint32_t));
+				file.read((char *) this->cameraPixels.data(), this->cameraPixels.size() * sizeof(ofVec2f));
+
+				if (!file.good()) {
+					this->clear();
+					throw(ofxRulr::Exception("Failed to read " + filename));
+				}
+
+				//offsets index cameraPixels directly, and build() never makes an empty group
+				bool offsetsValid = this->offsets.front() == 0 && this->offsets.back() == this->cameraPixels.size();
+				for (size_t i = 1; i < this->offsets.size() && offsetsValid; i++) {
+					offsetsValid = this->offsets[i] > this->offsets[i - 1];
+				}
+				if (!offsetsValid) {
+					this->clear();
+					throw(ofxRulr::Exception(filename + " has invalid group offsets"));
+				}
+			}
+
+			//----------
+			void CameraPixelGroups::clear() {
+				this->projectorPixels.clear();
+				this->offsets.clear();
+				this->cameraPixels.clear();
+			}
+
+			//----------
+			size_t CameraPixelGroups::size() const {
+				return this->projectorPixels.size();
+			}
+
+			//----------
+			size_t CameraPixelGroups::getSampleCount() const {
+				return this->cameraPixels.size();
+			}
+
+			//----------
+			size_t CameraPixelGroups::getMemoryUsage() const {
+				return this->projectorPixels.capacity() * sizeof(uint32_t)
+					+ this->offsets.capacity() * sizeof(uint32_t)
+					+ this->cameraPixels.capacity() * sizeof(ofVec2f);
+			}
+
+			//----------
+			const vector<uint32_t> & CameraPixelGroups::getProjectorPixels() const {
+				return this->projectorPixels;
+			}
+
+			//----------
+			const vector<uint32_t> & CameraPixelGroups::getOffsets() const {
+				return this->offsets;
+			}
+
+			//----------
+			const vector<ofVec2f> & CameraPixelGroups::getCameraPixels() const {
+				return this->cameraPixels;
+			}
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ofVec2f.h"
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace LSS {
+			///Camera pixels grouped by the projector pixel which they saw, in compressed sparse row layout :
+			///the camera pixels for projectorPixels[i] are cameraPixels[offsets[i]] to cameraPixels[offsets[i + 1] - 1].
+			///Built with a two pass counting sort, so there are three allocations in total rather than one per projector pixel.
+			class CameraPixelGroups {
+			public:
+				///Pixels is a range of items with active, projector and getCameraXY() (e.g. ofxGraycode::DataSet)
+				template<typename Pixels>
+				void build(const Pixels & pixels) {
+					this->clear();
+
+					//first pass : count the camera pixels per projector pixel
+					std::vector<uint32_t> counts;
+					for (const auto & pixel : pixels) {
+						if (pixel.active && pixel.projector != 0) {
+							const uint32_t projectorPixel = pixel.projector;
+							if (projectorPixel >= counts.size()) {
+								counts.resize(std::max<size_t>(projectorPixel + 1, counts.size() * 2), 0);
+							}
+							counts[projectorPixel]++;
+						}
+					}
+
+					//offsets of the projector pixels which were seen. counts becomes the write position for each
+					uint32_t sampleCount = 0;
+					for (uint32_t projectorPixel = 0; projectorPixel < counts.size(); projectorPixel++) {
+						const auto count = counts[projectorPixel];
+						if (count > 0) {
+							this->projectorPixels.push_back(projectorPixel);
+							this->offsets.push_back(sampleCount);
+							counts[projectorPixel] = sampleCount;
+							sampleCount += count;
+						}
+					}
+					this->offsets.push_back(sampleCount);
+
+					//second pass : write the camera pixels into place
+					this->cameraPixels.resize(sampleCount);
+					for (const auto & pixel : pixels) {
+						if (pixel.active && pixel.projector != 0) {
+							this->cameraPixels[counts[pixel.projector]++] = pixel.getCameraXY();
+						}
+					}
+				}
+
+				///Trimmed mean of each group : the mean of the camera pixels nearer to the plain mean than the 80th percentile
+				///(always including those within sqrt(2)px). Groups are split across threadCount threads (0 for hardware concurrency).
+				void getTrimmedMeans(std::vector<ofVec2f> & means, size_t threadCount = 0) const;
+
+				///Writes the arrays as they are in memory, so loading is three reads
+				void save(const std::string & filename) const;
+				void load(const std::string & filename);
+				void clear();
+
+				size_t size() const; // number of projector pixels
+				size_t getSampleCount() const;
+				size_t getMemoryUsage() const; // bytes
+
+				const std::vector<uint32_t> & getProjectorPixels() const;
+				const std::vector<uint32_t> & getOffsets() const;
+				const std::vector<ofVec2f> & getCameraPixels() const;
+			protected:
+				std::vector<uint32_t> projectorPixels;
+				std::vector<uint32_t> offsets; // one more than projectorPixels
+				std::vector<ofVec2f> cameraPixels;
+			};
+		}
+	}
+}
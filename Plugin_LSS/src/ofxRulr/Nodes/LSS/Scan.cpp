@@ -22,6 +22,10 @@ namespace ofxRulr {
 				this->addInput<Procedure::Scan::Graycode>();
 
 				this->manageParameters(this->parameters);
+
+				this->addAction("Triangulate", [this](Json::Value &) {
+					this->triangulate();
+				});
 			}
 
 			//----------
@@ -148,16 +152,21 @@ namespace ofxRulr {
 							}
 
 							//process the data from the scan
-							const auto & dataSet = graycode->getDataSet();
-							map<uint32_t, vector<ofVec2f>> cameraPixelsPerProjectorPixel;
+							CameraPixelGroups cameraPixelsPerProjectorPixel;
 							{
 								Utils::ScopedProcess scopedProcessGatherData("Gathering data", false);
 
-								//build up camera pixels per projector pixel
-								for (const auto & pixel : dataSet) {
-									if (pixel.active && pixel.projector != 0) {
-										auto cameraPixelXY = pixel.getCameraXY();
-										cameraPixelsPerProjectorPixel[pixel.projector].push_back(cameraPixelXY);
+								//the Graycode node only holds the last scan, so existing data for each projector comes from its saved groups
+								const auto groupsFilename = this->getDefaultFilename() + "-" + projector->getName() + ".groups";
+								if (this->parameters.useExistingData && ofFile::doesFileExist(groupsFilename)) {
+									cameraPixelsPerProjectorPixel.load(groupsFilename);
+								}
+								else {
+									//build up camera pixels per projector pixel
+									cameraPixelsPerProjectorPixel.build(graycode->getDataSet());
+
+									if (this->parameters.saveGroups) {
+										cameraPixelsPerProjectorPixel.save(groupsFilename);
 									}
 								}
 							}
@@ -168,69 +177,19 @@ namespace ofxRulr {
 
 								projectorScan->cameraPosition = camera->getPosition();
 
-								for (const auto & projectorPixelIt : cameraPixelsPerProjectorPixel) {
-									//get a camera ray per projector pixel
+								//get a camera pixel per projector pixel (trimmed mean of the camera pixels which saw it)
+								vector<ofVec2f> centroids;
+								cameraPixelsPerProjectorPixel.getTrimmedMeans(centroids);
 
-									auto cameraPixelCount = projectorPixelIt.second.size();
+								//projector pixels are in ascending order, so each insert goes at the end of the map
+								const auto & projectorPixelIndices = cameraPixelsPerProjectorPixel.getProjectorPixels();
+								for (size_t i = 0; i < projectorPixelIndices.size(); i++) {
+									const auto & centroid = centroids[i];
 
-									ofVec2f centroid;
-									if (cameraPixelCount == 0) {
-										//avoid issues
-										continue;
-									}
-									else if (cameraPixelCount == 1) {
-										centroid = projectorPixelIt.second.front();
-									}
-									else {
-										//otherwise take trimmed mean
-										ofVec2f originalMean;
-										{
-											for (const auto & cameraPixel : projectorPixelIt.second) {
-												originalMean += cameraPixel;
-											}
-											originalMean /= projectorPixelIt.second.size();
-										}
-
-										vector<float> distancePerCameraPixelToMean;
-										float thresholdDistance;
-										{
-											distancePerCameraPixelToMean.reserve(projectorPixelIt.second.size());
-											for (const auto & cameraPixel : projectorPixelIt.second) {
-												auto distance = cameraPixel.squareDistance(originalMean);
-												distancePerCameraPixelToMean.push_back(distance);
-											}
-
-											auto sortedDistances = distancePerCameraPixelToMean;
-											std::sort(sortedDistances.begin(), sortedDistances.end());
-											//80%
-											auto thresholdDistanceIndex = (size_t)((float)sortedDistances.size() * 0.8f);
-											thresholdDistance = sortedDistances[thresholdDistanceIndex];
-											if (thresholdDistance < 2) {
-												thresholdDistance = 2; // minimum threshold is 2px (always include in trimmed mean)
-											}
-										}
-
-										size_t trimmedMeanCount = 0;
-										ofVec2f trimmedMean;
-										for (size_t iCameraPixel = 0; iCameraPixel < projectorPixelIt.second.size(); iCameraPixel++) {
-											const auto & distance = distancePerCameraPixelToMean[iCameraPixel];
-											if (distance < thresholdDistance) {
-												trimmedMean += projectorPixelIt.second[iCameraPixel];
-												trimmedMeanCount++;
-											}
-										}
-										trimmedMean /= trimmedMeanCount;
-
-										centroid = trimmedMean;
-									}
-
-									//now we have centroid, let's store the ray
-									{
-										LSS::Projector::ProjectorPixelFind projectorPixel;
-										projectorPixel.cameraPixelRay = cameraViewWorld.castPixel(centroid);
-										projectorPixel.cameraPixelXY = centroid;
-										projectorScan->projectorPixels.emplace(projectorPixelIt.first, projectorPixel);
-									}
+									LSS::Projector::ProjectorPixelFind projectorPixel;
+									projectorPixel.cameraPixelRay = cameraViewWorld.castPixel(centroid);
+									projectorPixel.cameraPixelXY = centroid;
+									projectorScan->projectorPixels.emplace_hint(projectorScan->projectorPixels.end(), projectorPixelIndices[i], projectorPixel);
 								}
 							}
 
@@ -20,13 +20,14 @@ namespace ofxRulr {
 
 				struct : ofParameterGroup {
 					ofParameter<bool> useExistingData{ "Use existing data", false };
+					ofParameter<bool> saveGroups{ "Save camera pixel groups", false };
 					
 					struct : ofParameterGroup {
 						ofParameter<float> maxResidual{ "Maximum residual", 0.05 };
 						PARAM_DECLARE("Triangulate", maxResidual);
 					} triangulate;
 
-					PARAM_DECLARE("Scan", useExistingData, triangulate);
+					PARAM_DECLARE("Scan", useExistingData, saveGroups, triangulate);
 				} parameters;
 			};
 		}
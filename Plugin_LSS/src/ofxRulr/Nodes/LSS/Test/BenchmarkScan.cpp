@@ -0,0 +1,328 @@
+#include "pch_Plugin_LSS.h"
+#include "BenchmarkScan.h"
+
+#ifdef TARGET_WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace LSS {
+			namespace Test {
+				namespace {
+					typedef chrono::high_resolution_clock Clock;
+
+					//----------
+					float getMilliseconds(const Clock::time_point & start) {
+						return chrono::duration<float, milli>(Clock::now() - start).count();
+					}
+
+					//----------
+					float getPeakMemoryMB() {
+#ifdef TARGET_WIN32
+						PROCESS_MEMORY_COUNTERS counters = { 0 };
+						if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+							return (float) counters.PeakWorkingSetSize / (1024.0f * 1024.0f);
+						}
+						return 0.0f;
+#else
+						struct rusage usage;
+						getrusage(RUSAGE_SELF, &usage);
+	#ifdef TARGET_OSX
+						return (float) usage.ru_maxrss / (1024.0f * 1024.0f); // bytes
+	#else
+						return (float) usage.ru_maxrss / 1024.0f; // kilobytes
+	#endif
+#endif
+					}
+
+					//has the members of ofxGraycode::DataSet's pixels which CameraPixelGroups::build uses
+					struct SyntheticPixel {
+						bool active;
+						uint32_t projector;
+						ofVec2f cameraXY;
+
+						const ofVec2f & getCameraXY() const {
+							return this->cameraXY;
+						}
+					};
+				}
+
+				//----------
+				BenchmarkScan::BenchmarkScan() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string BenchmarkScan::getTypeName() const {
+					return "LSS::Test::BenchmarkScan";
+				}
+
+				//----------
+				void BenchmarkScan::init() {
+					RULR_NODE_INSPECTOR_LISTENER;
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void BenchmarkScan::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					inspector->addTitle("Result", ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<string>("Data set", [this]() {
+						if (!this->hasResult) {
+							return string("-");
+						}
+						return ofToString(this->result.sampleCount) + " camera pixels, " + ofToString(this->result.groupCount) + " projector pixels";
+					});
+
+					inspector->addTitle("Map of vectors", ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<float>("Build [ms]", [this]() {
+						return this->result.mapBuildDuration;
+					});
+					inspector->addLiveValue<float>("Trimmed means [ms]", [this]() {
+						return this->result.mapMeansDuration;
+					});
+					inspector->addLiveValue<float>("Memory [MB]", [this]() {
+						return this->result.mapMemoryMB;
+					});
+					inspector->addLiveValue<float>("Peak RSS increase [MB]", [this]() {
+						return this->result.mapPeakIncreaseMB;
+					});
+
+					inspector->addTitle("CameraPixelGroups", ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<float>("Build [ms]", [this]() {
+						return this->result.groupsBuildDuration;
+					});
+					inspector->addLiveValue<float>("Trimmed means, 1 thread [ms]", [this]() {
+						return this->result.groupsMeansSingleThreadDuration;
+					});
+					inspector->addLiveValue<float>("Trimmed means [ms]", [this]() {
+						return this->result.groupsMeansDuration;
+					});
+					inspector->addLiveValue<float>("Memory [MB]", [this]() {
+						return this->result.groupsMemoryMB;
+					});
+					inspector->addLiveValue<float>("Peak RSS increase [MB]", [this]() {
+						return this->result.groupsPeakIncreaseMB;
+					});
+					inspector->addLiveValue<float>("Save [ms]", [this]() {
+						return this->result.saveDuration;
+					});
+					inspector->addLiveValue<float>("Load [ms]", [this]() {
+						return this->result.loadDuration;
+					});
+					inspector->addLiveValue<float>("File size [MB]", [this]() {
+						return this->result.fileSizeMB;
+					});
+
+					inspector->addTitle("Comparison", ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<float>("Max mean difference [px]", [this]() {
+						return this->result.maxMeanDifference;
+					});
+					inspector->addLiveValue<float>("Peak RSS [MB]", [this]() {
+						return this->result.peakMemoryMB;
+					});
+				}
+
+				//----------
+				void BenchmarkScan::serializeResult(Json::Value & json) const {
+					json["groupCount"] = (Json::UInt64) this->result.groupCount;
+					json["sampleCount"] = (Json::UInt64) this->result.sampleCount;
+					json["mapBuildDuration"] = this->result.mapBuildDuration;
+					json["mapMeansDuration"] = this->result.mapMeansDuration;
+					json["mapMemoryMB"] = this->result.mapMemoryMB;
+					json["mapPeakIncreaseMB"] = this->result.mapPeakIncreaseMB;
+					json["groupsBuildDuration"] = this->result.groupsBuildDuration;
+					json["groupsMeansSingleThreadDuration"] = this->result.groupsMeansSingleThreadDuration;
+					json["groupsMeansDuration"] = this->result.groupsMeansDuration;
+					json["groupsMemoryMB"] = this->result.groupsMemoryMB;
+					json["groupsPeakIncreaseMB"] = this->result.groupsPeakIncreaseMB;
+					json["saveDuration"] = this->result.saveDuration;
+					json["loadDuration"] = this->result.loadDuration;
+					json["fileSizeMB"] = this->result.fileSizeMB;
+					json["maxMeanDifference"] = this->result.maxMeanDifference;
+					json["peakMemoryMB"] = this->result.peakMemoryMB;
+				}
+
+				//----------
+				void BenchmarkScan::runBenchmark() {
+					const auto cameraWidth = this->parameters.cameraWidth.get();
+					const auto cameraHeight = this->parameters.cameraHeight.get();
+					const auto projectorWidth = this->parameters.projectorWidth.get();
+					const auto projectorHeight = this->parameters.projectorHeight.get();
+					const auto activeRatio = this->parameters.activeRatio.get();
+					const auto noise = this->parameters.noise.get();
+
+					Utils::ScopedProcess scopedProcess("Benchmark scan", false);
+					this->result = Result();
+					this->hasResult = false;
+
+					//deterministic data set. the projector fills the middle of the camera image with some perspective
+					ofSeedRandom(0);
+					vector<SyntheticPixel> dataSet((size_t) cameraWidth * (size_t) cameraHeight);
+					{
+						size_t index = 0;
+						for (int y = 0; y < cameraHeight; y++) {
+							for (int x = 0; x < cameraWidth; x++) {
+								auto & pixel = dataSet[index++];
+								pixel.cameraXY = ofVec2f(x, y);
+
+								auto u = ((float)x / (float)cameraWidth - 0.1f) / 0.8f;
+								auto v = ((float)y / (float)cameraHeight - 0.1f) / 0.8f;
+								u = (u - 0.5f) * (1.0f + 0.2f * v) + 0.5f;
+
+								auto projectorX = (int) (u * projectorWidth + ofRandomf() * noise);
+								auto projectorY = (int) (v * projectorHeight + ofRandomf() * noise);
+
+								pixel.active = ofRandomuf() < activeRatio
+									&& projectorX >= 0 && projectorX < projectorWidth
+									&& projectorY >= 0 && projectorY < projectorHeight;
+								pixel.projector = pixel.active
+									? (uint32_t)(projectorX + projectorY * projectorWidth)
+									: 0;
+							}
+						}
+					}
+
+					//CameraPixelGroups first, since the peak only goes up
+					vector<ofVec2f> groupMeans;
+					{
+						auto peakBefore = getPeakMemoryMB();
+						{
+							CameraPixelGroups groups;
+							{
+								auto start = Clock::now();
+								groups.build(dataSet);
+								this->result.groupsBuildDuration = getMilliseconds(start);
+							}
+							{
+								auto start = Clock::now();
+								groups.getTrimmedMeans(groupMeans, 1);
+								this->result.groupsMeansSingleThreadDuration = getMilliseconds(start);
+							}
+							{
+								auto start = Clock::now();
+								groups.getTrimmedMeans(groupMeans, (size_t) this->parameters.threads.get());
+								this->result.groupsMeansDuration = getMilliseconds(start);
+							}
+							this->result.groupCount = groups.size();
+							this->result.sampleCount = groups.getSampleCount();
+							this->result.groupsMemoryMB = (float) groups.getMemoryUsage() / (1024.0f * 1024.0f);
+							this->result.groupsPeakIncreaseMB = getPeakMemoryMB() - peakBefore;
+
+							const string filename = "BenchmarkScan.groups";
+							{
+								auto start = Clock::now();
+								groups.save(filename);
+								this->result.saveDuration = getMilliseconds(start);
+							}
+							{
+								auto start = Clock::now();
+								CameraPixelGroups loadedGroups;
+								loadedGroups.load(filename);
+								this->result.loadDuration = getMilliseconds(start);
+
+								if (loadedGroups.getCameraPixels() != groups.getCameraPixels()
+									|| loadedGroups.getProjectorPixels() != groups.getProjectorPixels()) {
+									throw(ofxRulr::Exception("Loaded groups don't match the saved groups"));
+								}
+							}
+							ofFile file(filename);
+							this->result.fileSizeMB = (float) file.getSize() / (1024.0f * 1024.0f);
+							file.remove();
+						}
+					}
+
+					//the map of vectors, with the trimmed mean as Scan had it
+					{
+						auto peakBefore = getPeakMemoryMB();
+
+						map<uint32_t, vector<ofVec2f>> cameraPixelsPerProjectorPixel;
+						{
+							auto start = Clock::now();
+							for (const auto & pixel : dataSet) {
+								if (pixel.active && pixel.projector != 0) {
+									cameraPixelsPerProjectorPixel[pixel.projector].push_back(pixel.getCameraXY());
+								}
+							}
+							this->result.mapBuildDuration = getMilliseconds(start);
+						}
+
+						vector<ofVec2f> mapMeans;
+						{
+							auto start = Clock::now();
+							mapMeans.reserve(cameraPixelsPerProjectorPixel.size());
+							for (const auto & projectorPixelIt : cameraPixelsPerProjectorPixel) {
+								const auto & cameraPixels = projectorPixelIt.second;
+								if (cameraPixels.size() == 1) {
+									mapMeans.push_back(cameraPixels.front());
+									continue;
+								}
+
+								ofVec2f originalMean;
+								for (const auto & cameraPixel : cameraPixels) {
+									originalMean += cameraPixel;
+								}
+								originalMean /= cameraPixels.size();
+
+								vector<float> distances;
+								distances.reserve(cameraPixels.size());
+								for (const auto & cameraPixel : cameraPixels) {
+									distances.push_back(cameraPixel.squareDistance(originalMean));
+								}
+								auto sortedDistances = distances;
+								std::sort(sortedDistances.begin(), sortedDistances.end());
+								auto thresholdDistance = sortedDistances[(size_t)((float)sortedDistances.size() * 0.8f)];
+								if (thresholdDistance < 2) {
+									thresholdDistance = 2;
+								}
+
+								size_t trimmedMeanCount = 0;
+								ofVec2f trimmedMean;
+								for (size_t i = 0; i < cameraPixels.size(); i++) {
+									if (distances[i] < thresholdDistance) {
+										trimmedMean += cameraPixels[i];
+										trimmedMeanCount++;
+									}
+								}
+								mapMeans.push_back(trimmedMeanCount > 0
+									? trimmedMean / trimmedMeanCount
+									: originalMean);
+							}
+							this->result.mapMeansDuration = getMilliseconds(start);
+						}
+
+						//a map node is 3 pointers + colour + key + the vector (3 pointers), then each vector has its own allocation
+						size_t mapMemory = 0;
+						for (const auto & projectorPixelIt : cameraPixelsPerProjectorPixel) {
+							mapMemory += sizeof(void*) * 4 + sizeof(uint32_t) + sizeof(vector<ofVec2f>);
+							mapMemory += projectorPixelIt.second.capacity() * sizeof(ofVec2f);
+						}
+						this->result.mapMemoryMB = (float) mapMemory / (1024.0f * 1024.0f);
+						this->result.mapPeakIncreaseMB = getPeakMemoryMB() - peakBefore;
+
+						if (mapMeans.size() != groupMeans.size()) {
+							throw(ofxRulr::Exception("Map and CameraPixelGroups have different numbers of projector pixels"));
+						}
+						for (size_t i = 0; i < mapMeans.size(); i++) {
+							this->result.maxMeanDifference = max(this->result.maxMeanDifference, mapMeans[i].distance(groupMeans[i]));
+						}
+					}
+
+					this->result.peakMemoryMB = getPeakMemoryMB();
+
+					scopedProcess.end();
+
+					ofLogNotice(this->getTypeName()) << "Map build " << this->result.mapBuildDuration << "ms, means " << this->result.mapMeansDuration << "ms, "
+						<< this->result.mapMemoryMB << "MB. CameraPixelGroups build " << this->result.groupsBuildDuration << "ms, means "
+						<< this->result.groupsMeansDuration << "ms, " << this->result.groupsMemoryMB << "MB, load " << this->result.loadDuration << "ms";
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../CameraPixelGroups.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace LSS {
+			namespace Test {
+				///Groups a synthetic graycode data set by projector pixel, with the map of vectors which Scan used
+				///before and with CameraPixelGroups, and saves / loads the groups
+				class BenchmarkScan : public Nodes::Test::Benchmark {
+				public:
+					BenchmarkScan();
+					string getTypeName() const override;
+					void init();
+
+					void populateInspector(ofxCvGui::InspectArguments &);
+
+					void runBenchmark() override;
+					void serializeResult(Json::Value &) const override;
+				protected:
+					struct : ofParameterGroup {
+						ofParameter<int> cameraWidth{ "Camera width", 2448, 1, 8192 };
+						ofParameter<int> cameraHeight{ "Camera height", 2048, 1, 8192 };
+						ofParameter<int> projectorWidth{ "Projector width", 1920, 1, 8192 };
+						ofParameter<int> projectorHeight{ "Projector height", 1080, 1, 8192 };
+						ofParameter<float> activeRatio{ "Active ratio", 0.9, 0.0, 1.0 };
+						ofParameter<float> noise{ "Noise [px]", 0.5, 0.0, 10.0 };
+						ofParameter<int> threads{ "Threads", 0, 0, 64 };
+						PARAM_DECLARE("BenchmarkScan", cameraWidth, cameraHeight, projectorWidth, projectorHeight, activeRatio, noise, threads);
+					} parameters;
+
+					struct Result {
+						size_t groupCount = 0;
+						size_t sampleCount = 0;
+
+						float mapBuildDuration = 0.0f; // ms
+						float mapMeansDuration = 0.0f; // ms
+						float mapMemoryMB = 0.0f; // estimated heap
+						float mapPeakIncreaseMB = 0.0f;
+
+						float groupsBuildDuration = 0.0f; // ms
+						float groupsMeansSingleThreadDuration = 0.0f; // ms
+						float groupsMeansDuration = 0.0f; // ms
+						float groupsMemoryMB = 0.0f;
+						float groupsPeakIncreaseMB = 0.0f;
+
+						float saveDuration = 0.0f; // ms
+						float loadDuration = 0.0f; // ms
+						float fileSizeMB = 0.0f;
+
+						float maxMeanDifference = 0.0f; // px
+						float peakMemoryMB = 0.0f;
+					};
+					Result result;
+				};
+			}
+		}
+	}
+}
@@ -13,7 +13,9 @@
 #include "ofxRulr/Nodes/System/VideoOutput.h"
 #include "ofxRulr/Utils/PolyFit.h"
 
+#include "ofxRulr/Nodes/LSS/CameraPixelGroups.h"
 #include "ofxRulr/Nodes/LSS/World.h"
 #include "ofxRulr/Nodes/LSS/Projector.h"
 #include "ofxRulr/Nodes/LSS/Scan.h"
 #include "ofxRulr/Nodes/LSS/FitLines.h"
+#include "ofxRulr/Nodes/LSS/Test/BenchmarkScan.h"
@@ -7,5 +7,6 @@ OFXPLUGIN_PLUGIN_MODULES_BEGIN(ofxRulr::Nodes::Base)
 	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::LSS::Projector);
 	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::LSS::Scan);
 	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::LSS::FitLines);
+	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::LSS::Test::BenchmarkScan);
 }
 OFXPLUGIN_PLUGIN_MODULES_END
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "pch_Plugin_MoCap.h"
 #include "Body.h"
 #include "ofxGLM.h"
+#include "ofxRulr/Utils/WorldBatch.h"
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -136,7 +137,7 @@ namespace ofxRulr {
 				}
 
 				//rebuild body description
-				if (!this->getBodyDescription()) {
+				if (this->bodyDescriptionInvalid) {
 					auto bodyDescription = make_shared<Description>();
 
 					auto markers = this->markers.getSelection();
@@ -154,10 +155,8 @@ namespace ofxRulr {
 						, bodyDescription->rotationVector
 						, bodyDescription->translation);
 
-					{
-						auto lock = unique_lock<mutex>(this->bodyDescriptionMutex);
-						this->bodyDescription = bodyDescription;
-					}
+					this->bodyDescription.publish(bodyDescription);
+					this->bodyDescriptionInvalid = false;
 				}
 
 				//update world history
@@ -182,19 +181,14 @@ namespace ofxRulr {
 			void Body::drawObject() const {
 				auto markers = this->markers.getSelection();
 
-				if (this->parameters.drawStyleWorld.useColors) {
-					ofPushStyle();
-					{
-						for (const auto & marker : markers) {
-							ofSetColor(marker->color);
-							ofDrawSphere(marker->position.get(), this->parameters.markerDiameter / 2.0f);
-						}
-					}
-					ofPopStyle();
-				}
-				else {
+				{
+					Utils::WorldBatch::Scope batch;
+					const auto useColors = this->parameters.drawStyleWorld.useColors.get();
+					const auto styleColor = ofGetStyle().color;
 					for (const auto & marker : markers) {
-						ofDrawSphere(marker->position.get(), this->parameters.markerDiameter / 2.0f);
+						batch->addSphere(marker->position.get()
+							, this->parameters.markerDiameter / 2.0f
+							, useColors ? marker->color.get() : styleColor);
 					}
 				}
 
@@ -210,28 +204,24 @@ namespace ofxRulr {
 				auto selection = this->markers.getSelection();
 
 				//the trails are in world space so we treat these outside of drawObject
-				ofPushStyle();
-				{
-					ofEnableAlphaBlending();
-					for (auto marker : selection) {
-						ofMesh trail;
-						trail.setMode(ofPrimitiveMode::OF_PRIMITIVE_LINE_STRIP);
-						ofColor color = this->parameters.drawStyleWorld.useColors.get() ? marker->color : ofColor(255);
-
-						int tailIndex = 0;
-						auto historyLength = marker->worldHistory.size();
-						for (auto point : marker->worldHistory) {
-							trail.addVertex(point);
-							color.a = ofMap(tailIndex++
-								, 0, (float)historyLength
-								, 0.0f, 255.0f
-								, false);
-							trail.addColor(color);
-						}
-						trail.draw();
+				Utils::WorldBatch::Scope batch;
+				vector<ofVec3f> trail;
+				vector<ofFloatColor> trailColors;
+				for (auto marker : selection) {
+					trail.assign(marker->worldHistory.begin(), marker->worldHistory.end());
+					trailColors.clear();
+
+					ofFloatColor color = this->parameters.drawStyleWorld.useColors.get() ? marker->color.get() : ofColor(255);
+					auto historyLength = trail.size();
+					for (size_t tailIndex = 0; tailIndex < historyLength; tailIndex++) {
+						color.a = ofMap(tailIndex
+							, 0, (float)historyLength
+							, 0.0f, 1.0f
+							, false);
+						trailColors.push_back(color);
 					}
+					batch->addLineStrip(trail, trailColors);
 				}
-				ofPopStyle();
 
 			}
 
@@ -276,10 +266,12 @@ namespace ofxRulr {
 
 			//----------
 			shared_ptr<Body::Description> Body::getBodyDescription() const {
-				{
-					auto lock = unique_lock<mutex>(this->bodyDescriptionMutex);
-					return this->bodyDescription;
-				}
+				return this->bodyDescription.getValue();
+			}
+
+			//----------
+			Utils::Snapshot<Body::Description>::Entry Body::getBodyDescriptionSnapshot() const {
+				return this->bodyDescription.get();
 			}
 
 			//----------
@@ -397,8 +389,7 @@ namespace ofxRulr {
 
 			//----------
 			void Body::invalidateBodyDescription() {
-				auto lock = unique_lock<mutex>(this->bodyDescriptionMutex);
-				this->bodyDescription.reset();
+				this->bodyDescriptionInvalid = true;
 			}
 		}
 	}
@@ -2,6 +2,7 @@
 
 #include "ofxRulr.h"
 #include "ofxRulr/Utils/CaptureSet.h"
+#include "ofxRulr/Utils/Snapshot.h"
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -38,8 +39,9 @@ namespace ofxRulr {
 				void serialize(Json::Value &);
 				void deserialize(const Json::Value &);
 
-				//thread safe
+				//thread safe (doesn't wait on edits to the body, see Utils::Snapshot)
 				shared_ptr<Description> getBodyDescription() const;
+				Utils::Snapshot<Description>::Entry getBodyDescriptionSnapshot() const;
 
 				void addMarker(const ofVec3f &);
 
@@ -89,8 +91,9 @@ namespace ofxRulr {
 				ofxCvGui::PanelPtr panel;
 				Utils::CaptureSet<Marker> markers;
 
-				shared_ptr<Description> bodyDescription;
-				mutable mutex bodyDescriptionMutex;
+				//rebuilt on the main thread when invalid. Readers keep the previous description until then
+				Utils::Snapshot<Description> bodyDescription;
+				atomic<bool> bodyDescriptionInvalid{ true };
 
 				ofThreadChannel<ofMatrix4x4> transformIncoming;
 
@@ -24,6 +24,7 @@ namespace ofxRulr {
 				//create the ouput frame;
 				auto outgoingFrame = make_shared<FindMarkerCentroidsFrame>();
 				outgoingFrame->imageFrame = incomingFrame; 
+				outgoingFrame->captureTime = this->getCaptureTime(*incomingFrame);
 
 				//convert to grayscale if needs be
 				outgoingFrame->image = ofxCv::toCv(incomingFrame->getPixels());
@@ -141,6 +142,23 @@ namespace ofxRulr {
 				//announce the new frame
 				this->onNewFrame(outgoingFrame);
 			}
+
+			//----------
+			chrono::high_resolution_clock::time_point FindMarkerCentroids::getCaptureTime(const ofxMachineVision::Frame & frame) {
+				//the camera's timestamps have their own epoch, so we line them up with our clock using the smallest
+				//arrival delay seen so far. If the camera's clock jumps back (e.g. a restarted replay) we start again.
+				auto now = chrono::high_resolution_clock::now();
+				auto offset = chrono::duration_cast<chrono::nanoseconds>(now.time_since_epoch()) - frame.getTimestamp();
+
+				auto lock = unique_lock<mutex>(this->captureClockMutex);
+				if (!this->hasCaptureClockOffset
+					|| offset < this->captureClockOffset
+					|| offset - this->captureClockOffset > chrono::seconds(1)) {
+					this->captureClockOffset = offset;
+					this->hasCaptureClockOffset = true;
+				}
+				return chrono::high_resolution_clock::time_point(chrono::duration_cast<chrono::high_resolution_clock::duration>(frame.getTimestamp() + this->captureClockOffset));
+			}
 		}
 	}
 }
\ No newline at end of file
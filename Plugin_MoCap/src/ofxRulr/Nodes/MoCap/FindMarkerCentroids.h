@@ -8,6 +8,7 @@ namespace ofxRulr {
 		namespace MoCap {
 			struct FindMarkerCentroidsFrame {
 				shared_ptr<ofxMachineVision::Frame> imageFrame;
+				chrono::high_resolution_clock::time_point captureTime = chrono::high_resolution_clock::now(); // imageFrame's timestamp on our clock
 
 				cv::Mat image;
 				cv::Mat blurred;
@@ -31,6 +32,7 @@ namespace ofxRulr {
 				void init();
 			protected:
 				void processFrame(shared_ptr<ofxMachineVision::Frame>) override;
+				chrono::high_resolution_clock::time_point getCaptureTime(const ofxMachineVision::Frame &);
 
 				struct : ofParameterGroup {
 					struct : ofParameterGroup {
@@ -49,6 +51,11 @@ namespace ofxRulr {
 
 					PARAM_DECLARE("FindMarkerCentroids", localDifference, contourFilter);
 				} parameters;
+
+				//camera clock to our clock, taken from the frame which arrived soonest after capture
+				mutex captureClockMutex;
+				chrono::nanoseconds captureClockOffset;
+				bool hasCaptureClockOffset = false;
 			};
 		}
 	}
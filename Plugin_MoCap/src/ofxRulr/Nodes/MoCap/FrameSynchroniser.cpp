@@ -0,0 +1,229 @@
+#include "pch_Plugin_MoCap.h"
+#include "FrameSynchroniser.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			//----------
+			FrameSynchroniser::FrameSynchroniser(size_t cameraCount)
+			: queues(cameraCount)
+			, active(cameraCount, true) {
+
+			}
+
+			//----------
+			size_t FrameSynchroniser::getCameraCount() const {
+				return this->queues.size();
+			}
+
+			//----------
+			void FrameSynchroniser::setSettings(const Settings & settings) {
+				auto lock = unique_lock<mutex>(this->queuesMutex);
+				this->settings = settings;
+			}
+
+			//----------
+			void FrameSynchroniser::setActive(size_t cameraIndex, bool active) {
+				auto lock = unique_lock<mutex>(this->queuesMutex);
+				this->active[cameraIndex] = active;
+				if (!active) {
+					this->queues[cameraIndex].clear();
+				}
+			}
+
+			//----------
+			void FrameSynchroniser::clear() {
+				auto lock = unique_lock<mutex>(this->queuesMutex);
+				for (auto & queue : this->queues) {
+					queue.clear();
+				}
+				this->hasEmitted = false;
+			}
+
+			//----------
+			vector<shared_ptr<SynchronisedFrames>> FrameSynchroniser::add(size_t cameraIndex, shared_ptr<MatchMarkersFrame> frame) {
+				vector<shared_ptr<SynchronisedFrames>> output;
+
+				Entry entry;
+				if (!frame || !FrameSynchroniser::getTimestamp(*frame, entry.timestamp)) {
+					this->statistics.stragglersDropped++;
+					return output;
+				}
+				entry.arrivalTime = Clock::now();
+				entry.frame = frame;
+
+				auto lock = unique_lock<mutex>(this->queuesMutex);
+				if (cameraIndex >= this->queues.size() || !this->active[cameraIndex]) {
+					return output;
+				}
+
+				//frames older than a set we've already emitted can never be matched
+				if (this->hasEmitted && entry.timestamp + this->settings.tolerance < this->lastEmittedTimestamp) {
+					this->statistics.stragglersDropped++;
+					return output;
+				}
+
+				//insert in timestamp order (usually at the back)
+				auto & queue = this->queues[cameraIndex];
+				auto position = queue.end();
+				while (position != queue.begin() && prev(position)->timestamp > entry.timestamp) {
+					position--;
+				}
+				queue.insert(position, move(entry));
+
+				while (queue.size() > max<size_t>(this->settings.bufferSize, 1)) {
+					queue.pop_front();
+					this->statistics.overflowDropped++;
+				}
+
+				const auto now = Clock::now();
+				while (this->emitNext(output, now)) { }
+
+				return output;
+			}
+
+			//----------
+			vector<shared_ptr<SynchronisedFrames>> FrameSynchroniser::flush() {
+				vector<shared_ptr<SynchronisedFrames>> output;
+
+				auto lock = unique_lock<mutex>(this->queuesMutex);
+				const auto now = Clock::now();
+				while (this->emitNext(output, now)) { }
+
+				return output;
+			}
+
+			//----------
+			const FrameSynchroniser::Statistics & FrameSynchroniser::getStatistics() const {
+				return this->statistics;
+			}
+
+			//----------
+			void FrameSynchroniser::resetStatistics() {
+				this->statistics.setsEmitted.store(0);
+				this->statistics.partialSets.store(0);
+				this->statistics.stragglersDropped.store(0);
+				this->statistics.overflowDropped.store(0);
+			}
+
+			//----------
+			bool FrameSynchroniser::getTimestamp(const MatchMarkersFrame & frame, chrono::nanoseconds & timestamp) {
+				if (!frame.incomingFrame || !frame.incomingFrame->imageFrame) {
+					return false;
+				}
+				timestamp = frame.incomingFrame->imageFrame->getTimestamp();
+				return true;
+			}
+
+			//----------
+			bool FrameSynchroniser::emitNext(vector<shared_ptr<SynchronisedFrames>> & output, const Clock::time_point & now) {
+				const auto cameraCount = this->queues.size();
+				const auto & tolerance = this->settings.tolerance;
+
+				//the oldest pending frame defines the window
+				size_t oldestCamera = cameraCount;
+				for (size_t i = 0; i < cameraCount; i++) {
+					if (this->queues[i].empty()) {
+						continue;
+					}
+					if (oldestCamera == cameraCount || this->queues[i].front().timestamp < this->queues[oldestCamera].front().timestamp) {
+						oldestCamera = i;
+					}
+				}
+				if (oldestCamera == cameraCount) {
+					return false;
+				}
+				const auto windowTimestamp = this->queues[oldestCamera].front().timestamp;
+
+				//find the closest frame to the window in each camera
+				vector<int> matches(cameraCount, -1);
+				size_t activeCount = 0;
+				size_t matchCount = 0;
+				bool couldStillArrive = false;
+				for (size_t i = 0; i < cameraCount; i++) {
+					if (!this->active[i]) {
+						continue;
+					}
+					activeCount++;
+
+					const auto & queue = this->queues[i];
+					auto bestDistance = tolerance + chrono::nanoseconds(1);
+					for (size_t j = 0; j < queue.size(); j++) {
+						if (queue[j].timestamp > windowTimestamp + tolerance) {
+							break;
+						}
+						auto distance = queue[j].timestamp - windowTimestamp;
+						if (distance < bestDistance) {
+							bestDistance = distance;
+							matches[i] = (int)j;
+						}
+					}
+
+					if (matches[i] != -1) {
+						matchCount++;
+					}
+					else if (queue.empty() || queue.back().timestamp <= windowTimestamp + tolerance) {
+						//this camera hasn't yet moved past the window
+						couldStillArrive = true;
+					}
+				}
+
+				const auto requiredCount = this->settings.minimumCount == 0
+					? activeCount
+					: min(this->settings.minimumCount, activeCount);
+				const auto isComplete = matchCount == activeCount;
+				const auto waitedTooLong = now - this->queues[oldestCamera].front().arrivalTime > this->settings.maximumWait;
+
+				if (!isComplete && couldStillArrive && !waitedTooLong) {
+					//wait for more frames
+					return false;
+				}
+
+				if (matchCount < requiredCount || matchCount == 0) {
+					//this frame will never be part of a set
+					this->queues[oldestCamera].pop_front();
+					this->statistics.stragglersDropped++;
+					return true;
+				}
+
+				//emit the set
+				auto synchronisedFrames = make_shared<SynchronisedFrames>();
+				synchronisedFrames->frames.resize(cameraCount);
+				synchronisedFrames->timestamp = windowTimestamp;
+				synchronisedFrames->count = matchCount;
+
+				auto firstArrival = now;
+				auto latestTimestamp = windowTimestamp;
+				for (size_t i = 0; i < cameraCount; i++) {
+					if (matches[i] == -1) {
+						continue;
+					}
+					auto & queue = this->queues[i];
+					const auto & entry = queue[matches[i]];
+					synchronisedFrames->frames[i] = entry.frame;
+					firstArrival = min(firstArrival, entry.arrivalTime);
+					latestTimestamp = max(latestTimestamp, entry.timestamp);
+
+					//anything before the match in this camera is superseded
+					this->statistics.stragglersDropped += (uint32_t)matches[i];
+					queue.erase(queue.begin(), queue.begin() + matches[i] + 1);
+				}
+
+				chrono::duration<float, milli> pairingLatency = now - firstArrival;
+				chrono::duration<float, milli> timestampSpread = latestTimestamp - windowTimestamp;
+				this->statistics.pairingLatency.store(ofLerp(this->statistics.pairingLatency.load(), pairingLatency.count(), 0.1f));
+				this->statistics.timestampSpread.store(timestampSpread.count());
+				this->statistics.setsEmitted++;
+				if (!isComplete) {
+					this->statistics.partialSets++;
+				}
+
+				this->hasEmitted = true;
+				this->lastEmittedTimestamp = windowTimestamp;
+
+				output.push_back(synchronisedFrames);
+				return true;
+			}
+		}
+	}
+}
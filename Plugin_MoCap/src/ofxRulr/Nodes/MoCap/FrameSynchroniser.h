@@ -0,0 +1,79 @@
+#pragma once
+
+#include "MatchMarkers.h"
+
+#include <deque>
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			struct SynchronisedFrames {
+				vector<shared_ptr<MatchMarkersFrame>> frames; // one per camera, empty where the camera didn't contribute
+				chrono::nanoseconds timestamp; // of the earliest frame in the set
+				size_t count = 0;
+			};
+
+			///Groups frames arriving from N cameras (on any threads) into sets whose capture
+			///timestamps lie within a tolerance window. Each camera has a bounded reorder buffer,
+			///so frames may arrive out of order. Frames which can't be matched are dropped.
+			class FrameSynchroniser {
+			public:
+				typedef chrono::high_resolution_clock Clock;
+
+				struct Settings {
+					chrono::nanoseconds tolerance = chrono::milliseconds(2);
+					Clock::duration maximumWait = chrono::milliseconds(50); // before giving up on a late camera
+					size_t bufferSize = 8; // per camera
+					size_t minimumCount = 0; // cameras needed to emit a partial set, 0 = all active cameras
+				};
+
+				struct Statistics {
+					atomic<uint32_t> setsEmitted{ 0 };
+					atomic<uint32_t> partialSets{ 0 };
+					atomic<uint32_t> stragglersDropped{ 0 };
+					atomic<uint32_t> overflowDropped{ 0 };
+					atomic<float> pairingLatency{ 0.0f }; // ms, first arrival to emit
+					atomic<float> timestampSpread{ 0.0f }; // ms, within a set
+				};
+
+				FrameSynchroniser(size_t cameraCount);
+
+				size_t getCameraCount() const;
+				void setSettings(const Settings &);
+				///Inactive cameras are not waited for
+				void setActive(size_t cameraIndex, bool);
+				void clear();
+
+				///Thread safe. Returns the sets which have been completed (or can't be completed any further) by this frame
+				vector<shared_ptr<SynchronisedFrames>> add(size_t cameraIndex, shared_ptr<MatchMarkersFrame>);
+
+				///Thread safe. Returns the sets which have waited longer than the maximum wait. Call this regularly so
+				///that frames are still emitted (or dropped) when the other cameras stop sending.
+				vector<shared_ptr<SynchronisedFrames>> flush();
+
+				const Statistics & getStatistics() const;
+				void resetStatistics();
+
+				static bool getTimestamp(const MatchMarkersFrame &, chrono::nanoseconds &);
+			protected:
+				struct Entry {
+					chrono::nanoseconds timestamp;
+					Clock::time_point arrivalTime;
+					shared_ptr<MatchMarkersFrame> frame;
+				};
+
+				bool emitNext(vector<shared_ptr<SynchronisedFrames>> &, const Clock::time_point & now);
+
+				vector<deque<Entry>> queues;
+				vector<bool> active;
+				Settings settings;
+
+				bool hasEmitted = false;
+				chrono::nanoseconds lastEmittedTimestamp;
+
+				mutex queuesMutex;
+				Statistics statistics;
+			};
+		}
+	}
+}
@@ -6,6 +6,49 @@
 namespace ofxRulr {
 	namespace Nodes {
 		namespace MoCap {
+#pragma mark CameraDescription
+			namespace {
+				//----------
+				bool equal(const cv::Mat & a, const cv::Mat & b) {
+					if (a.empty() || b.empty()) {
+						return a.empty() == b.empty();
+					}
+					return a.size() == b.size()
+						&& a.type() == b.type()
+						&& cv::norm(a, b, cv::NORM_INF) == 0.0;
+				}
+			}
+
+			//----------
+			bool CameraDescription::operator==(const CameraDescription & other) const {
+				return equal(this->cameraMatrix, other.cameraMatrix)
+					&& equal(this->distortionCoefficients, other.distortionCoefficients)
+					&& equal(this->inverseRotationVector, other.inverseRotationVector)
+					&& equal(this->inverseTranslation, other.inverseTranslation)
+					&& this->viewProjectionMatrix == other.viewProjectionMatrix;
+			}
+
+			//----------
+			void CameraDescription::updateSnapshot(Utils::Snapshot<CameraDescription> & snapshot, shared_ptr<Item::Camera> cameraNode) {
+				shared_ptr<CameraDescription> cameraDescription;
+				if (cameraNode) {
+					cameraDescription = make_shared<CameraDescription>();
+					cameraDescription->cameraMatrix = cameraNode->getCameraMatrix();
+					cameraDescription->distortionCoefficients = cameraNode->getDistortionCoefficients();
+					cameraNode->getExtrinsics(cameraDescription->inverseRotationVector, cameraDescription->inverseTranslation, true);
+					cameraDescription->viewProjectionMatrix = cameraNode->getViewInWorldSpace().getViewMatrix() * cameraNode->getViewInWorldSpace().getProjectionMatrix();
+				}
+
+				auto publishedCameraDescription = snapshot.getValue();
+				if (!cameraDescription && !publishedCameraDescription) {
+					return;
+				}
+				if (cameraDescription && publishedCameraDescription && *cameraDescription == *publishedCameraDescription) {
+					return;
+				}
+				snapshot.publish(cameraDescription);
+			}
+
 #pragma mark Capture
 			//----------
 			MatchMarkers::Capture::Capture() {
@@ -83,31 +126,14 @@ namespace ofxRulr {
 
 			//----------
 			void MatchMarkers::update() {
-				shared_ptr<Body::Description> bodyDescription;
 				{
 					auto bodyNode = this->getInput<Body>();
-					if (bodyNode) {
-						bodyDescription = bodyNode->getBodyDescription();
-					}
+					this->bodyDescription.mirror(bodyNode
+						? bodyNode->getBodyDescriptionSnapshot()
+						: Utils::Snapshot<Body::Description>::Entry());
 				}
 
-				shared_ptr<CameraDescription> cameraDescription;
-				{
-					auto cameraNode = this->getInput<Item::Camera>();
-					if (cameraNode) {
-						cameraDescription = make_shared<CameraDescription>();
-						cameraDescription->cameraMatrix = cameraNode->getCameraMatrix();
-						cameraDescription->distortionCoefficients = cameraNode->getDistortionCoefficients();
-						cameraNode->getExtrinsics(cameraDescription->inverseRotationVector, cameraDescription->inverseTranslation, true);
-						cameraDescription->viewProjectionMatrix = cameraNode->getViewInWorldSpace().getViewMatrix() * cameraNode->getViewInWorldSpace().getProjectionMatrix();
-					}
-				}
-
-				{
-					auto lock = unique_lock<mutex>(this->descriptionMutex);
-					this->bodyDescription = bodyDescription;
-					this->cameraDescription = cameraDescription;
-				}
+				CameraDescription::updateSnapshot(this->cameraDescription, this->getInput<Item::Camera>());
 
 				{
 					shared_ptr<Capture> newCapture;
@@ -123,6 +149,18 @@ namespace ofxRulr {
 						this->parameters.refindTrackingThreshold = this->parameters.trackingDistanceThreshold;
 					}
 				}
+
+				{
+					auto settings = this->settings.getValue();
+					if (!settings
+						|| settings->trackingDistanceThreshold != this->parameters.trackingDistanceThreshold.get()
+						|| settings->refindTrackingThreshold != this->parameters.refindTrackingThreshold.get()) {
+						auto newSettings = make_shared<Settings>();
+						newSettings->trackingDistanceThreshold = this->parameters.trackingDistanceThreshold.get();
+						newSettings->refindTrackingThreshold = this->parameters.refindTrackingThreshold.get();
+						this->settings.publish(newSettings);
+					}
+				}
 			}
 
 			//----------
@@ -178,8 +216,9 @@ namespace ofxRulr {
 				outputFrame->incomingFrame = incomingFrame;
 
 				{
-					auto lock = unique_lock<mutex>(this->descriptionMutex);
-					outputFrame->bodyDescription = this->bodyDescription;
+					auto bodyDescription = this->bodyDescription.get();
+					outputFrame->bodyDescription = bodyDescription.value;
+					outputFrame->bodyDescriptionVersion = bodyDescription.version;
 					if (!outputFrame->bodyDescription) {
 						//we can't calculate the frame without a marker body
 						return;
@@ -189,16 +228,23 @@ namespace ofxRulr {
 						return;
 					}
 
-					outputFrame->cameraDescription = this->cameraDescription;
+					auto cameraDescription = this->cameraDescription.get();
+					outputFrame->cameraDescription = cameraDescription.value;
+					outputFrame->cameraDescriptionVersion = cameraDescription.version;
 					if (!outputFrame->cameraDescription) {
 						//we can't calculate the frame without a camera
 						return;
 					}
 				}
 
+				auto settings = this->settings.getValue();
+				if (!settings) {
+					//not yet published by the main thread
+					return;
+				}
 
 				//get the distance threshold
-				outputFrame->distanceThresholdSquared = this->parameters.trackingDistanceThreshold.get();
+				outputFrame->distanceThresholdSquared = settings->trackingDistanceThreshold;
 				outputFrame->distanceThresholdSquared *= outputFrame->distanceThresholdSquared;
 
 				//process the normal tracking search
@@ -206,7 +252,7 @@ namespace ofxRulr {
 
 				//try our pre-recorded poses if we failed tracking
 				if (!outputFrame->result.success) {
-					auto searchFrame = this->processCheckKnownPoses(outputFrame);
+					auto searchFrame = this->processCheckKnownPoses(outputFrame, *settings);
 					if (searchFrame) {
 						//found a historic pose which works
 						outputFrame = searchFrame;
@@ -253,18 +299,26 @@ namespace ofxRulr {
 
 			//----------
 			void MatchMarkers::processTrackingSearch(shared_ptr<MatchMarkersFrame> & outputFrame) {
+				MatchMarkers::searchVisibleMarkers(* outputFrame);
+				this->processModelViewTransform(outputFrame);
+			}
+
+			//----------
+			void MatchMarkers::searchVisibleMarkers(MatchMarkersFrame & outputFrame) {
+				const auto & bodyDescription = outputFrame.bodyDescription;
+				const auto & cameraDescription = outputFrame.cameraDescription;
+
 				//combine the camera and body transforms
-				cv::composeRT(outputFrame->bodyDescription->rotationVector
-					, outputFrame->bodyDescription->translation
-					, outputFrame->cameraDescription->inverseRotationVector
-					, outputFrame->cameraDescription->inverseTranslation
-					, outputFrame->modelViewRotationVector
-					, outputFrame->modelViewTranslation);
+				cv::composeRT(bodyDescription->rotationVector
+					, bodyDescription->translation
+					, cameraDescription->inverseRotationVector
+					, cameraDescription->inverseTranslation
+					, outputFrame.modelViewRotationVector
+					, outputFrame.modelViewTranslation);
 
 				//first check the markers are inside the camera image
 				//(cvProjectPoints will happily give us weird results for markers outside view, e.g. distortion loop back, behind cam)
 				{
-					vector<ofVec3f> matrixProjections;
 					for (int i = 0; i < bodyDescription->markerCount; i++) {
 						const auto & objectSpacePoint = bodyDescription->markers.positions[i];
 						const auto worldSpace = objectSpacePoint * bodyDescription->modelTransform;
@@ -280,17 +334,15 @@ namespace ofxRulr {
 							//outside of image space (with some allowance for distortion)
 							continue;
 						}
-						outputFrame->search.markerIDs.push_back(bodyDescription->markers.IDs[i]);
-						outputFrame->search.objectSpacePoints.emplace_back(move(ofxCv::toCv(objectSpacePoint)));
+						outputFrame.search.markerIDs.push_back(bodyDescription->markers.IDs[i]);
+						outputFrame.search.objectSpacePoints.emplace_back(move(ofxCv::toCv(objectSpacePoint)));
 					}
-					outputFrame->search.count = outputFrame->search.markerIDs.size();
+					outputFrame.search.count = outputFrame.search.markerIDs.size();
 				}
-
-				this->processModelViewTransform(outputFrame);
 			}
 
 			//----------
-			shared_ptr<MatchMarkersFrame> MatchMarkers::processCheckKnownPoses(shared_ptr<MatchMarkersFrame> & outputFrame) {
+			shared_ptr<MatchMarkersFrame> MatchMarkers::processCheckKnownPoses(shared_ptr<MatchMarkersFrame> & outputFrame, const Settings & settings) {
 				auto captures = this->captures.getSelection();
 				for (auto capture : captures) {
 					auto searchFrame = make_shared<MatchMarkersFrame>(* outputFrame);
@@ -298,7 +350,7 @@ namespace ofxRulr {
 					searchFrame->modelViewRotationVector = cv::Mat(capture->modelViewRotationVector);
 					searchFrame->modelViewTranslation = cv::Mat(capture->modelViewTranslation);
 					
-					searchFrame->distanceThresholdSquared = this->parameters.refindTrackingThreshold;
+					searchFrame->distanceThresholdSquared = settings.refindTrackingThreshold;
 					searchFrame->distanceThresholdSquared *= searchFrame->distanceThresholdSquared;
 
 					this->processModelViewTransform(searchFrame);
@@ -306,7 +358,7 @@ namespace ofxRulr {
 
 					if (searchFrame->result.success) {
 						//now check it with the tracking distance threshold
-						searchFrame->distanceThresholdSquared = this->parameters.trackingDistanceThreshold;
+						searchFrame->distanceThresholdSquared = settings.trackingDistanceThreshold;
 						this->processModelViewTransform(searchFrame);
 
 						if (searchFrame->result.success) {
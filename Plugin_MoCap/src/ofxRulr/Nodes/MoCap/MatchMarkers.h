@@ -14,6 +14,11 @@ namespace ofxRulr {
 				cv::Mat inverseTranslation;
 
 				ofMatrix4x4 viewProjectionMatrix;
+
+				bool operator==(const CameraDescription &) const;
+
+				///Publish the camera's current description if it differs from the one already in the snapshot
+				static void updateSnapshot(Utils::Snapshot<CameraDescription> &, shared_ptr<Item::Camera>);
 			};
 
 			struct MatchMarkersFrame {
@@ -21,6 +26,10 @@ namespace ofxRulr {
 				shared_ptr<Body::Description> bodyDescription;
 				shared_ptr<CameraDescription> cameraDescription;
 
+				//versions of the snapshots this frame was computed with
+				Utils::Snapshot<Body::Description>::Version bodyDescriptionVersion = 0;
+				Utils::Snapshot<CameraDescription>::Version cameraDescriptionVersion = 0;
+
 				cv::Mat modelViewRotationVector;
 				cv::Mat modelViewTranslation;
 
@@ -77,11 +86,20 @@ namespace ofxRulr {
 				void serialize(Json::Value &);
 				void deserialize(const Json::Value &);
 
+				///Fill the model view transform and the list of markers which should be visible to the camera
+				static void searchVisibleMarkers(MatchMarkersFrame &);
+
+				///Project the searched markers and match each centroid to its nearest marker
+				static void processModelViewTransform(shared_ptr<MatchMarkersFrame> &);
 			protected:
+				struct Settings {
+					float trackingDistanceThreshold;
+					float refindTrackingThreshold;
+				};
+
 				void processFrame(shared_ptr<FindMarkerCentroidsFrame>) override;
 				void processTrackingSearch(shared_ptr<MatchMarkersFrame> &);
-				shared_ptr<MatchMarkersFrame> processCheckKnownPoses(shared_ptr<MatchMarkersFrame> &);
-				void processModelViewTransform(shared_ptr<MatchMarkersFrame> &);
+				shared_ptr<MatchMarkersFrame> processCheckKnownPoses(shared_ptr<MatchMarkersFrame> &, const Settings &);
 
 				struct : ofParameterGroup {
 					ofParameter<float> trackingDistanceThreshold{ "Tracking distance threshold [px]", 20, 0, 300 };
@@ -92,9 +110,10 @@ namespace ofxRulr {
 
 				Utils::CaptureSet<Capture> captures;
 
-				shared_ptr<Body::Description> bodyDescription;
-				shared_ptr<CameraDescription> cameraDescription;
-				mutex descriptionMutex;
+				//published on the main thread, taken by processFrame without locking
+				Utils::Snapshot<Body::Description> bodyDescription; // mirrors the Body's own snapshot
+				Utils::Snapshot<CameraDescription> cameraDescription;
+				Utils::Snapshot<Settings> settings;
 
 				atomic<bool> needsTakeCapture = false;
 				atomic<bool> needsForceUseCapture = false;
@@ -0,0 +1,187 @@
+#include "pch_Plugin_MoCap.h"
+#include "MultiBodyMatcher.h"
+
+#include "ofxRulr/Utils/Hungarian.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			namespace {
+				//----------
+				size_t findRoot(vector<size_t> & parents, size_t index) {
+					while (parents[index] != index) {
+						parents[index] = parents[parents[index]];
+						index = parents[index];
+					}
+					return index;
+				}
+
+				struct Group {
+					vector<size_t> centroids;
+					vector<size_t> markers; // flat marker index
+					vector<pair<size_t, size_t>> pairs; // {centroid, flat marker}
+				};
+			}
+
+			//----------
+			vector<MultiBodyMatcher::Match> MultiBodyMatcher::match(const vector<cv::Point2f> & centroids
+				, const vector<Body> & bodies
+				, float distanceThreshold
+				, Statistics * statistics) {
+				vector<Match> matches(bodies.size());
+				if (statistics) {
+					*statistics = Statistics();
+				}
+
+				//flatten the markers of all bodies
+				vector<cv::Point2f> markerPoints;
+				vector<pair<size_t, size_t>> markerOwners; // {body, index in body}
+				for (size_t bodyIndex = 0; bodyIndex < bodies.size(); bodyIndex++) {
+					const auto & projectedPoints = bodies[bodyIndex].projectedPoints;
+					for (size_t i = 0; i < projectedPoints.size(); i++) {
+						markerPoints.push_back(projectedPoints[i]);
+						markerOwners.emplace_back(bodyIndex, i);
+					}
+				}
+				if (markerPoints.empty() || centroids.empty()) {
+					return matches;
+				}
+
+				//sort markers by x so each centroid only checks a narrow band
+				vector<size_t> markersByX(markerPoints.size());
+				for (size_t i = 0; i < markersByX.size(); i++) {
+					markersByX[i] = i;
+				}
+				sort(markersByX.begin(), markersByX.end(), [&markerPoints](size_t a, size_t b) {
+					return markerPoints[a].x < markerPoints[b].x;
+				});
+
+				//gather candidate pairs and join them into groups
+				const auto centroidCount = centroids.size();
+				const auto distanceThresholdSquared = distanceThreshold * distanceThreshold;
+				vector<size_t> parents(centroidCount + markerPoints.size());
+				for (size_t i = 0; i < parents.size(); i++) {
+					parents[i] = i;
+				}
+
+				vector<pair<size_t, size_t>> candidatePairs;
+				for (size_t centroidIndex = 0; centroidIndex < centroidCount; centroidIndex++) {
+					const auto & centroid = centroids[centroidIndex];
+					auto it = lower_bound(markersByX.begin(), markersByX.end(), centroid.x - distanceThreshold, [&markerPoints](size_t marker, float x) {
+						return markerPoints[marker].x < x;
+					});
+					for (; it != markersByX.end(); it++) {
+						const auto & markerPoint = markerPoints[*it];
+						if (markerPoint.x > centroid.x + distanceThreshold) {
+							break;
+						}
+						const auto delta = centroid - markerPoint;
+						if (delta.dot(delta) < distanceThresholdSquared) {
+							candidatePairs.emplace_back(centroidIndex, *it);
+							auto centroidRoot = findRoot(parents, centroidIndex);
+							auto markerRoot = findRoot(parents, centroidCount + *it);
+							if (centroidRoot != markerRoot) {
+								parents[markerRoot] = centroidRoot;
+							}
+						}
+					}
+				}
+
+				//split the pairs into their groups
+				vector<Group> groups;
+				{
+					vector<int> groupIndices(parents.size(), -1);
+					auto getGroup = [&](size_t node) -> Group & {
+						auto root = findRoot(parents, node);
+						if (groupIndices[root] == -1) {
+							groupIndices[root] = (int)groups.size();
+							groups.emplace_back();
+						}
+						return groups[groupIndices[root]];
+					};
+
+					vector<bool> seen(parents.size(), false);
+					for (const auto & candidatePair : candidatePairs) {
+						auto & group = getGroup(candidatePair.first);
+						group.pairs.push_back(candidatePair);
+						if (!seen[candidatePair.first]) {
+							group.centroids.push_back(candidatePair.first);
+							seen[candidatePair.first] = true;
+						}
+						if (!seen[centroidCount + candidatePair.second]) {
+							group.markers.push_back(candidatePair.second);
+							seen[centroidCount + candidatePair.second] = true;
+						}
+					}
+				}
+
+				//assign within each group
+				vector<vector<pair<size_t, size_t>>> assignments(bodies.size()); // {centroid, index in body} per body
+				auto assign = [&](size_t centroidIndex, size_t flatMarkerIndex) {
+					const auto & owner = markerOwners[flatMarkerIndex];
+					assignments[owner.first].emplace_back(centroidIndex, owner.second);
+				};
+
+				for (const auto & group : groups) {
+					if (statistics) {
+						statistics->largestGroup = max(statistics->largestGroup, group.centroids.size() + group.markers.size());
+					}
+
+					if (group.pairs.size() == 1) {
+						//uncontested
+						assign(group.pairs.front().first, group.pairs.front().second);
+						continue;
+					}
+
+					//local indices for the cost matrix
+					map<size_t, size_t> columns;
+					for (size_t i = 0; i < group.markers.size(); i++) {
+						columns[group.markers[i]] = i;
+					}
+					map<size_t, size_t> rows;
+					for (size_t i = 0; i < group.centroids.size(); i++) {
+						rows[group.centroids[i]] = i;
+					}
+
+					vector<float> costs(group.centroids.size() * group.markers.size(), distanceThresholdSquared);
+					for (const auto & candidatePair : group.pairs) {
+						const auto delta = centroids[candidatePair.first] - markerPoints[candidatePair.second];
+						costs[rows[candidatePair.first] * group.markers.size() + columns[candidatePair.second]] = delta.dot(delta);
+					}
+
+					auto assignment = Utils::Hungarian::solve(costs
+						, group.centroids.size()
+						, group.markers.size()
+						, distanceThresholdSquared);
+					for (size_t row = 0; row < assignment.size(); row++) {
+						if (assignment[row] != -1) {
+							assign(group.centroids[row], group.markers[assignment[row]]);
+						}
+					}
+
+					if (statistics) {
+						statistics->contestedGroups++;
+					}
+				}
+
+				//results in centroid order (as MatchMarkers)
+				for (size_t bodyIndex = 0; bodyIndex < bodies.size(); bodyIndex++) {
+					auto & bodyAssignments = assignments[bodyIndex];
+					sort(bodyAssignments.begin(), bodyAssignments.end());
+					auto & match = matches[bodyIndex];
+					for (const auto & assignment : bodyAssignments) {
+						match.centroidIndices.push_back(assignment.first);
+						match.markerIndices.push_back(assignment.second);
+					}
+				}
+
+				if (statistics) {
+					statistics->candidatePairs = candidatePairs.size();
+					statistics->groupCount = groups.size();
+				}
+
+				return matches;
+			}
+		}
+	}
+}
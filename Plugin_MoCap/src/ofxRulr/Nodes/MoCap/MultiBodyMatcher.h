@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ofxCvMin.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			///Assigns the centroids of one camera frame to the projected markers of every body at once.
+			///Each centroid goes to at most one marker (of any body) and each marker receives at most one
+			///centroid, minimising the total squared distance. Pairs further apart than the threshold are
+			///gated out, and the remaining candidate pairs are split into connected groups so that the
+			///Hungarian solve only ever sees markers which actually compete for the same centroids.
+			class MultiBodyMatcher {
+			public:
+				struct Body {
+					vector<cv::Point2f> projectedPoints;
+				};
+
+				struct Match {
+					vector<size_t> markerIndices; // index in Body::projectedPoints
+					vector<size_t> centroidIndices;
+				};
+
+				struct Statistics {
+					size_t candidatePairs = 0;
+					size_t groupCount = 0;
+					size_t largestGroup = 0; // centroids + markers
+					size_t contestedGroups = 0; // groups which needed the Hungarian solve
+				};
+
+				///Returns one Match per body
+				static vector<Match> match(const vector<cv::Point2f> & centroids
+					, const vector<Body> & bodies
+					, float distanceThreshold
+					, Statistics * statistics = nullptr);
+			};
+		}
+	}
+}
@@ -0,0 +1,260 @@
+#include "pch_Plugin_MoCap.h"
+#include "MultiBodyTracking.h"
+
+#include "ofxRulr/Utils/ParallelFor.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			//----------
+			MultiBodyTracking::MultiBodyTracking() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			string MultiBodyTracking::getTypeName() const {
+				return "MoCap::MultiBodyTracking";
+			}
+
+			//----------
+			void MultiBodyTracking::init() {
+				RULR_NODE_UPDATE_LISTENER;
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				this->addInput<Item::Camera>();
+				for (size_t i = 0; i < MaxBodyCount; i++) {
+					this->addInput<Body>("Body " + ofToString(i + 1));
+				}
+
+				this->manageParameters(this->parameters);
+			}
+
+			//----------
+			void MultiBodyTracking::update() {
+				//publish the bodies when any of them has changed
+				{
+					auto bodyTargets = make_shared<vector<BodyTarget>>();
+					for (size_t i = 0; i < MaxBodyCount; i++) {
+						auto bodyNode = this->getInput<Body>("Body " + ofToString(i + 1));
+						if (bodyNode) {
+							auto bodyDescription = bodyNode->getBodyDescriptionSnapshot();
+							if (bodyDescription.value && bodyDescription.value->markerCount > 0) {
+								BodyTarget bodyTarget;
+								bodyTarget.body = bodyNode;
+								bodyTarget.bodyDescription = bodyDescription.value;
+								bodyTarget.bodyDescriptionVersion = bodyDescription.version;
+								bodyTargets->push_back(bodyTarget);
+							}
+						}
+					}
+
+					auto publishedBodyTargets = this->bodyTargets.getValue();
+					auto changed = !publishedBodyTargets || publishedBodyTargets->size() != bodyTargets->size();
+					for (size_t i = 0; i < bodyTargets->size() && !changed; i++) {
+						const auto & bodyTarget = bodyTargets->at(i);
+						const auto & publishedBodyTarget = publishedBodyTargets->at(i);
+						changed = bodyTarget.bodyDescription != publishedBodyTarget.bodyDescription
+							|| bodyTarget.body.lock() != publishedBodyTarget.body.lock();
+					}
+					if (changed) {
+						this->bodyTargets.publish(bodyTargets);
+					}
+				}
+
+				CameraDescription::updateSnapshot(this->cameraDescription, this->getInput<Item::Camera>());
+
+				{
+					auto settings = this->settings.getValue();
+					if (!settings
+						|| settings->distanceThreshold != this->parameters.distanceThreshold.get()
+						|| settings->reprojectionThreshold != this->parameters.reprojectionThreshold.get()
+						|| settings->threadCount != (size_t) this->parameters.threadCount.get()) {
+						auto newSettings = make_shared<Settings>();
+						newSettings->distanceThreshold = this->parameters.distanceThreshold.get();
+						newSettings->reprojectionThreshold = this->parameters.reprojectionThreshold.get();
+						newSettings->threadCount = (size_t) this->parameters.threadCount.get();
+						this->settings.publish(newSettings);
+					}
+				}
+
+				//apply the latest pose of each body
+				{
+					shared_ptr<MultiBodyTrackingFrame> frame;
+					map<shared_ptr<Body>, ofMatrix4x4> transforms;
+					while (this->trackingUpdateToMainThread.tryReceive(frame)) {
+						for (size_t i = 0; i < frame->bodies.size(); i++) {
+							auto body = frame->bodies[i].lock();
+							if (body && frame->updateTrackingFrames[i]) {
+								transforms[body] = frame->updateTrackingFrames[i]->transform;
+							}
+						}
+					}
+					for (const auto & transform : transforms) {
+						transform.first->setTransform(transform.second);
+					}
+				}
+			}
+
+			//----------
+			void MultiBodyTracking::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				inspector->addLiveValueHistory("Match time [ms]", [this]() {
+					return this->matchDuration.load();
+				});
+				inspector->addLiveValueHistory("Pose time (all threads) [ms]", [this]() {
+					return this->poseDuration.load();
+				});
+				inspector->addLiveValue<int>("Bodies", [this]() {
+					return this->bodyCount.load();
+				});
+				inspector->addLiveValue<int>("Bodies tracked", [this]() {
+					return this->trackedCount.load();
+				});
+				inspector->addLiveValue<int>("Contested groups", [this]() {
+					return this->contestedGroups.load();
+				});
+			}
+
+			//----------
+			void MultiBodyTracking::process(MultiBodyTrackingFrame & frame, const Settings & settings) {
+				const auto bodyCount = frame.matchMarkersFrames.size();
+				const auto & centroids = frame.incomingFrame->centroids;
+
+				frame.updateTrackingFrames.assign(bodyCount, nullptr);
+				frame.reprojectionErrors.assign(bodyCount, 0.0f);
+				vector<float> bodyDurations(bodyCount, 0.0f);
+
+				//project each body's visible markers into the camera
+				vector<MultiBodyMatcher::Body> matcherBodies(bodyCount);
+				Utils::parallelFor(bodyCount, [&](size_t bodyIndex) {
+					auto startTime = chrono::high_resolution_clock::now();
+					auto & matchMarkersFrame = frame.matchMarkersFrames[bodyIndex];
+					matchMarkersFrame->incomingFrame = frame.incomingFrame;
+					matchMarkersFrame->cameraDescription = frame.cameraDescription;
+					matchMarkersFrame->distanceThresholdSquared = settings.distanceThreshold * settings.distanceThreshold;
+
+					try {
+						MatchMarkers::searchVisibleMarkers(*matchMarkersFrame);
+						if (!matchMarkersFrame->search.objectSpacePoints.empty()) {
+							cv::projectPoints(matchMarkersFrame->search.objectSpacePoints
+								, matchMarkersFrame->modelViewRotationVector
+								, matchMarkersFrame->modelViewTranslation
+								, frame.cameraDescription->cameraMatrix
+								, frame.cameraDescription->distortionCoefficients
+								, matchMarkersFrame->search.projectedMarkerImagePoints);
+							matcherBodies[bodyIndex].projectedPoints = matchMarkersFrame->search.projectedMarkerImagePoints;
+						}
+					}
+					RULR_CATCH_ALL_TO_ERROR;
+
+					bodyDurations[bodyIndex] += chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+				}, settings.threadCount);
+
+				//one assignment for all bodies
+				vector<MultiBodyMatcher::Match> matches;
+				{
+					auto startTime = chrono::high_resolution_clock::now();
+					matches = MultiBodyMatcher::match(centroids
+						, matcherBodies
+						, settings.distanceThreshold
+						, &frame.matchStatistics);
+					frame.matchDuration = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+				}
+
+				//solve each body
+				Utils::parallelFor(bodyCount, [&](size_t bodyIndex) {
+					auto startTime = chrono::high_resolution_clock::now();
+					auto & matchMarkersFrame = frame.matchMarkersFrames[bodyIndex];
+					const auto & match = matches[bodyIndex];
+					const auto & search = matchMarkersFrame->search;
+
+					auto & result = matchMarkersFrame->result;
+					result = MatchMarkersFrame::Result();
+					for (size_t i = 0; i < match.markerIndices.size(); i++) {
+						const auto markerIndex = match.markerIndices[i];
+						const auto centroidIndex = match.centroidIndices[i];
+						result.markerListIndicies.push_back(markerIndex);
+						result.markerIDs.push_back(search.markerIDs[markerIndex]);
+						result.projectedPoints.push_back(search.projectedMarkerImagePoints[markerIndex]);
+						result.centroids.push_back(centroids[centroidIndex]);
+						result.centroidIndex.push_back(centroidIndex);
+						result.objectSpacePoints.push_back(search.objectSpacePoints[markerIndex]);
+					}
+					result.count = result.markerIDs.size();
+					result.success = result.count >= 4;
+
+					if (result.success) {
+						float sumErrorsSquared = 0.0f;
+						for (size_t i = 0; i < result.count; i++) {
+							auto delta = result.centroids[i] - result.projectedPoints[i];
+							sumErrorsSquared += delta.dot(delta);
+						}
+						result.reprojectionError = sqrt(sumErrorsSquared);
+
+						try {
+							frame.updateTrackingFrames[bodyIndex] = UpdateTracking::solve(matchMarkersFrame
+								, UpdateTarget::Body
+								, settings.reprojectionThreshold
+								, frame.reprojectionErrors[bodyIndex]);
+						}
+						RULR_CATCH_ALL_TO_ERROR;
+					}
+
+					bodyDurations[bodyIndex] += chrono::duration<float, milli>(chrono::high_resolution_clock::now() - startTime).count();
+				}, settings.threadCount);
+
+				frame.poseDuration = accumulate(bodyDurations.begin(), bodyDurations.end(), 0.0f);
+			}
+
+			//----------
+			void MultiBodyTracking::processFrame(shared_ptr<FindMarkerCentroidsFrame> incomingFrame) {
+				auto outputFrame = make_shared<MultiBodyTrackingFrame>();
+				outputFrame->incomingFrame = incomingFrame;
+
+				auto bodyTargets = this->bodyTargets.getValue();
+				auto cameraDescription = this->cameraDescription.get();
+				auto settings = this->settings.getValue();
+				if (!cameraDescription.value || !bodyTargets || bodyTargets->empty() || !settings) {
+					//we can't calculate the frame without a camera and bodies
+					return;
+				}
+				outputFrame->cameraDescription = cameraDescription.value;
+				outputFrame->cameraDescriptionVersion = cameraDescription.version;
+
+				for (const auto & bodyTarget : *bodyTargets) {
+					auto matchMarkersFrame = make_shared<MatchMarkersFrame>();
+					matchMarkersFrame->bodyDescription = bodyTarget.bodyDescription;
+					matchMarkersFrame->bodyDescriptionVersion = bodyTarget.bodyDescriptionVersion;
+					matchMarkersFrame->cameraDescriptionVersion = cameraDescription.version;
+					outputFrame->matchMarkersFrames.push_back(matchMarkersFrame);
+					outputFrame->bodies.push_back(bodyTarget.body);
+				}
+
+				MultiBodyTracking::process(*outputFrame, *settings);
+
+				//announce the poses now rather than waiting for the main thread
+				int trackedCount = 0;
+				const auto & captureTime = incomingFrame->captureTime;
+				for (size_t i = 0; i < bodyTargets->size(); i++) {
+					const auto & updateTrackingFrame = outputFrame->updateTrackingFrames[i];
+					if (updateTrackingFrame) {
+						trackedCount++;
+						auto body = outputFrame->bodies[i].lock();
+						if (body) {
+							body->notifyPoseSample(updateTrackingFrame->transform, captureTime);
+						}
+					}
+				}
+
+				this->matchDuration.store(outputFrame->matchDuration);
+				this->poseDuration.store(outputFrame->poseDuration);
+				this->bodyCount.store((int)bodyTargets->size());
+				this->trackedCount.store(trackedCount);
+				this->contestedGroups.store((int)outputFrame->matchStatistics.contestedGroups);
+
+				this->onNewFrame.notifyListeners(outputFrame);
+				this->trackingUpdateToMainThread.send(outputFrame);
+			}
+		}
+	}
+}
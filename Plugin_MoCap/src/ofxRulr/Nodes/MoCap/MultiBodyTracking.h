@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ThreadedProcessNode.h"
+#include "UpdateTracking.h"
+#include "MultiBodyMatcher.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			struct MultiBodyTrackingFrame {
+				shared_ptr<FindMarkerCentroidsFrame> incomingFrame;
+				shared_ptr<CameraDescription> cameraDescription;
+				Utils::Snapshot<CameraDescription>::Version cameraDescriptionVersion = 0;
+
+				//one entry per body
+				vector<weak_ptr<Body>> bodies; // empty when not coming from a MultiBodyTracking node
+				vector<shared_ptr<MatchMarkersFrame>> matchMarkersFrames;
+				vector<shared_ptr<UpdateTrackingFrame>> updateTrackingFrames; // nullptr where tracking failed
+				vector<float> reprojectionErrors;
+
+				MultiBodyMatcher::Statistics matchStatistics;
+				float matchDuration = 0.0f; // ms
+				float poseDuration = 0.0f; // ms, summed over the pose threads
+			};
+
+			///Tracks several bodies in one camera with a single pass over the centroids.
+			///All bodies' markers are matched together (see MultiBodyMatcher), then the body poses are solved
+			///in parallel. Replaces one MatchMarkers -> UpdateTracking chain per body.
+			class MultiBodyTracking : public ThreadedProcessNode<FindMarkerCentroids
+				, FindMarkerCentroidsFrame
+				, MultiBodyTrackingFrame> {
+			public:
+				enum Constants : size_t {
+					MaxBodyCount = 20
+				};
+
+				struct Settings {
+					float distanceThreshold = 20.0f; // px
+					float reprojectionThreshold = 5.0f; // px
+					size_t threadCount = 4;
+				};
+
+				MultiBodyTracking();
+				string getTypeName() const override;
+				void init();
+				void update();
+				void populateInspector(ofxCvGui::InspectArguments &);
+
+				///Match and solve all bodies. frame needs incomingFrame, cameraDescription and one
+				///matchMarkersFrame per body with its bodyDescription set.
+				static void process(MultiBodyTrackingFrame &, const Settings &);
+			protected:
+				void processFrame(shared_ptr<FindMarkerCentroidsFrame>) override;
+
+				struct : ofParameterGroup {
+					ofParameter<float> distanceThreshold{ "Tracking distance threshold [px]", 20, 0, 300 };
+					ofParameter<float> reprojectionThreshold{ "Reprojection threshold [px]", 5 };
+					ofParameter<int> threadCount{ "Pose threads", 4, 1, 16 };
+					PARAM_DECLARE("MultiBodyTracking", distanceThreshold, reprojectionThreshold, threadCount);
+				} parameters;
+
+				struct BodyTarget {
+					weak_ptr<Body> body;
+					shared_ptr<Body::Description> bodyDescription;
+					Utils::Snapshot<Body::Description>::Version bodyDescriptionVersion;
+				};
+
+				//published on the main thread, taken by processFrame without locking
+				Utils::Snapshot<vector<BodyTarget>> bodyTargets;
+				Utils::Snapshot<CameraDescription> cameraDescription;
+				Utils::Snapshot<Settings> settings;
+
+				ofThreadChannel<shared_ptr<MultiBodyTrackingFrame>> trackingUpdateToMainThread;
+
+				atomic<float> matchDuration{ 0.0f };
+				atomic<float> poseDuration{ 0.0f };
+				atomic<int> bodyCount{ 0 };
+				atomic<int> trackedCount{ 0 };
+				atomic<int> contestedGroups{ 0 };
+			};
+		}
+	}
+}
@@ -0,0 +1,412 @@
+#include "pch_Plugin_MoCap.h"
+#include "MultiViewSolvePnP.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			namespace {
+				struct Pose {
+					double rotation[9]; // row major
+					double translation[3];
+				};
+
+				struct PreparedView {
+					Pose worldToCamera;
+					double focalLength[2];
+					vector<double> normalisedImagePoints; // undistorted, x,y interleaved
+					const vector<cv::Point3f> * objectPoints;
+				};
+
+				struct Evaluation {
+					double cost = 0.0;
+					double sumSquaredError = 0.0;
+					size_t pointCount = 0;
+					size_t outlierCount = 0;
+				};
+
+				//----------
+				void multiply(const double * a, const double * b, double * result) {
+					for (int i = 0; i < 3; i++) {
+						for (int j = 0; j < 3; j++) {
+							result[i * 3 + j] = a[i * 3 + 0] * b[0 * 3 + j]
+								+ a[i * 3 + 1] * b[1 * 3 + j]
+								+ a[i * 3 + 2] * b[2 * 3 + j];
+						}
+					}
+				}
+
+				//----------
+				void transform(const double * rotation, const double * translation, const double * point, double * result) {
+					for (int i = 0; i < 3; i++) {
+						result[i] = rotation[i * 3 + 0] * point[0]
+							+ rotation[i * 3 + 1] * point[1]
+							+ rotation[i * 3 + 2] * point[2]
+							+ (translation ? translation[i] : 0.0);
+					}
+				}
+
+				//----------
+				void rotationFromVector(const double * rotationVector, double * rotation) {
+					const auto angle = sqrt(rotationVector[0] * rotationVector[0]
+						+ rotationVector[1] * rotationVector[1]
+						+ rotationVector[2] * rotationVector[2]);
+					if (angle < 1e-12) {
+						//first order
+						const double result[9] = {
+							1.0, -rotationVector[2], rotationVector[1]
+							, rotationVector[2], 1.0, -rotationVector[0]
+							, -rotationVector[1], rotationVector[0], 1.0
+						};
+						memcpy(rotation, result, sizeof(result));
+						return;
+					}
+
+					const double x = rotationVector[0] / angle;
+					const double y = rotationVector[1] / angle;
+					const double z = rotationVector[2] / angle;
+					const double c = cos(angle);
+					const double s = sin(angle);
+					const double C = 1.0 - c;
+					const double result[9] = {
+						c + x * x * C, x * y * C - z * s, x * z * C + y * s
+						, y * x * C + z * s, c + y * y * C, y * z * C - x * s
+						, z * x * C - y * s, z * y * C + x * s, c + z * z * C
+					};
+					memcpy(rotation, result, sizeof(result));
+				}
+
+				//----------
+				Pose toPose(const cv::Mat & rotationVector, const cv::Mat & translation) {
+					Pose pose;
+					cv::Mat rotationVector64, translation64;
+					rotationVector.convertTo(rotationVector64, CV_64F);
+					translation.convertTo(translation64, CV_64F);
+					rotationFromVector((const double*)rotationVector64.data, pose.rotation);
+					memcpy(pose.translation, translation64.data, sizeof(pose.translation));
+					return pose;
+				}
+
+				//----------
+				void fromPose(const Pose & pose, cv::Mat & rotationVector, cv::Mat & translation) {
+					cv::Mat rotation(3, 3, CV_64F, (void*)pose.rotation);
+					cv::Rodrigues(rotation, rotationVector);
+					translation = cv::Mat(3, 1, CV_64F, (void*)pose.translation).clone();
+				}
+
+				//----------
+				//Solves the 6x6 symmetric positive definite system (Cholesky)
+				bool solve6x6(const double * A, const double * b, double * x) {
+					double L[36] = { 0 };
+					for (int i = 0; i < 6; i++) {
+						for (int j = 0; j <= i; j++) {
+							double sum = A[i * 6 + j];
+							for (int k = 0; k < j; k++) {
+								sum -= L[i * 6 + k] * L[j * 6 + k];
+							}
+							if (i == j) {
+								if (sum <= 0.0) {
+									return false;
+								}
+								L[i * 6 + i] = sqrt(sum);
+							}
+							else {
+								L[i * 6 + j] = sum / L[j * 6 + j];
+							}
+						}
+					}
+
+					double y[6];
+					for (int i = 0; i < 6; i++) {
+						double sum = b[i];
+						for (int k = 0; k < i; k++) {
+							sum -= L[i * 6 + k] * y[k];
+						}
+						y[i] = sum / L[i * 6 + i];
+					}
+					for (int i = 5; i >= 0; i--) {
+						double sum = y[i];
+						for (int k = i + 1; k < 6; k++) {
+							sum -= L[k * 6 + i] * x[k];
+						}
+						x[i] = sum / L[i * 6 + i];
+					}
+					return true;
+				}
+
+				//----------
+				//Huber cost of all observations. If normal / gradient are set, also accumulate the
+				//Gauss-Newton system for a perturbation of the body pose in world space
+				//(rotation about the body's origin, then translation)
+				Evaluation evaluate(const vector<PreparedView> & views
+					, const Pose & objectToWorld
+					, double huberThreshold
+					, double * normal
+					, double * gradient) {
+					Evaluation evaluation;
+					if (normal) {
+						memset(normal, 0, sizeof(double) * 36);
+						memset(gradient, 0, sizeof(double) * 6);
+					}
+
+					for (const auto & view : views) {
+						const auto & objectPoints = *view.objectPoints;
+						const auto & cameraRotation = view.worldToCamera.rotation;
+
+						//object to camera
+						double rotation[9];
+						multiply(cameraRotation, objectToWorld.rotation, rotation);
+						double translation[3];
+						transform(cameraRotation, view.worldToCamera.translation, objectToWorld.translation, translation);
+
+						for (size_t i = 0; i < objectPoints.size(); i++) {
+							const double objectPoint[3] = { objectPoints[i].x, objectPoints[i].y, objectPoints[i].z };
+							double cameraPoint[3];
+							transform(rotation, translation, objectPoint, cameraPoint);
+							if (cameraPoint[2] <= 1e-6) {
+								//behind the camera
+								continue;
+							}
+
+							const auto inverseZ = 1.0 / cameraPoint[2];
+							const auto projectedX = cameraPoint[0] * inverseZ;
+							const auto projectedY = cameraPoint[1] * inverseZ;
+
+							//residual in pixels
+							const double residual[2] = {
+								view.focalLength[0] * (projectedX - view.normalisedImagePoints[i * 2 + 0])
+								, view.focalLength[1] * (projectedY - view.normalisedImagePoints[i * 2 + 1])
+							};
+							const auto squaredError = residual[0] * residual[0] + residual[1] * residual[1];
+							const auto error = sqrt(squaredError);
+
+							//Huber loss and its IRLS weight
+							double weight = 1.0;
+							if (error <= huberThreshold) {
+								evaluation.cost += 0.5 * squaredError;
+							}
+							else {
+								evaluation.cost += huberThreshold * (error - 0.5 * huberThreshold);
+								weight = huberThreshold / error;
+								evaluation.outlierCount++;
+							}
+							evaluation.sumSquaredError += squaredError;
+							evaluation.pointCount++;
+
+							if (!normal) {
+								continue;
+							}
+
+							//d(residual) / d(camera point)
+							const double dResidual_dCameraPoint[2][3] = {
+								{ view.focalLength[0] * inverseZ, 0.0, -view.focalLength[0] * projectedX * inverseZ }
+								, { 0.0, view.focalLength[1] * inverseZ, -view.focalLength[1] * projectedY * inverseZ }
+							};
+
+							//the rotated (but not translated) object point in world space
+							double rotatedPoint[3];
+							transform(objectToWorld.rotation, nullptr, objectPoint, rotatedPoint);
+
+							double jacobian[2][6];
+							for (int row = 0; row < 2; row++) {
+								//d(residual) / d(world point) = d(residual) / d(camera point) * cameraRotation
+								double g[3];
+								for (int j = 0; j < 3; j++) {
+									g[j] = dResidual_dCameraPoint[row][0] * cameraRotation[0 * 3 + j]
+										+ dResidual_dCameraPoint[row][1] * cameraRotation[1 * 3 + j]
+										+ dResidual_dCameraPoint[row][2] * cameraRotation[2 * 3 + j];
+								}
+
+								//rotation : d(world point) = dw x rotatedPoint, so d(residual) / dw = rotatedPoint x g
+								jacobian[row][0] = rotatedPoint[1] * g[2] - rotatedPoint[2] * g[1];
+								jacobian[row][1] = rotatedPoint[2] * g[0] - rotatedPoint[0] * g[2];
+								jacobian[row][2] = rotatedPoint[0] * g[1] - rotatedPoint[1] * g[0];
+
+								//translation
+								jacobian[row][3] = g[0];
+								jacobian[row][4] = g[1];
+								jacobian[row][5] = g[2];
+							}
+
+							for (int row = 0; row < 2; row++) {
+								for (int j = 0; j < 6; j++) {
+									gradient[j] += weight * jacobian[row][j] * residual[row];
+									for (int k = 0; k <= j; k++) {
+										normal[j * 6 + k] += weight * jacobian[row][j] * jacobian[row][k];
+									}
+								}
+							}
+						}
+					}
+
+					if (normal) {
+						for (int j = 0; j < 6; j++) {
+							for (int k = j + 1; k < 6; k++) {
+								normal[j * 6 + k] = normal[k * 6 + j];
+							}
+						}
+					}
+
+					return evaluation;
+				}
+
+				//----------
+				Pose applyUpdate(const Pose & pose, const double * update) {
+					Pose result;
+					double deltaRotation[9];
+					rotationFromVector(update, deltaRotation);
+					multiply(deltaRotation, pose.rotation, result.rotation);
+					for (int i = 0; i < 3; i++) {
+						result.translation[i] = pose.translation[i] + update[3 + i];
+					}
+					return result;
+				}
+			}
+
+			//----------
+			MultiViewSolvePnP::Result MultiViewSolvePnP::solve(const vector<View> & views
+				, cv::Mat & rotationVector
+				, cv::Mat & translation
+				, bool useExtrinsicGuess
+				, const Settings & settings) {
+				Result result;
+
+				//prepare the views (undistort the image points once)
+				vector<PreparedView> preparedViews;
+				preparedViews.reserve(views.size());
+				size_t pointCount = 0;
+				for (const auto & view : views) {
+					if (view.imagePoints.empty()) {
+						continue;
+					}
+					if (view.imagePoints.size() != view.objectPoints.size()) {
+						throw(ofxRulr::Exception("MultiViewSolvePnP requires sets of image points and object points with equal length per view."));
+					}
+
+					PreparedView preparedView;
+					preparedView.worldToCamera = toPose(view.rotationVector, view.translation);
+
+					cv::Mat cameraMatrix;
+					view.cameraMatrix.convertTo(cameraMatrix, CV_64F);
+					preparedView.focalLength[0] = cameraMatrix.at<double>(0, 0);
+					preparedView.focalLength[1] = cameraMatrix.at<double>(1, 1);
+
+					vector<cv::Point2d> normalisedImagePoints;
+					cv::undistortPoints(view.imagePoints, normalisedImagePoints, view.cameraMatrix, view.distortionCoefficients);
+					preparedView.normalisedImagePoints.resize(normalisedImagePoints.size() * 2);
+					memcpy(preparedView.normalisedImagePoints.data(), normalisedImagePoints.data(), normalisedImagePoints.size() * sizeof(cv::Point2d));
+
+					preparedView.objectPoints = &view.objectPoints;
+					pointCount += view.objectPoints.size();
+					preparedViews.push_back(move(preparedView));
+				}
+				result.viewCount = preparedViews.size();
+				if (pointCount < 3) {
+					return result;
+				}
+
+				//initial guess
+				Pose objectToWorld;
+				if (useExtrinsicGuess && !rotationVector.empty() && !translation.empty()) {
+					objectToWorld = toPose(rotationVector, translation);
+				}
+				else {
+					//single view solvePnP using the view which sees the most points
+					const View * bestView = nullptr;
+					for (const auto & view : views) {
+						if (view.imagePoints.size() >= 4 && (!bestView || view.imagePoints.size() > bestView->imagePoints.size())) {
+							bestView = &view;
+						}
+					}
+					if (!bestView) {
+						return result;
+					}
+
+					cv::Mat modelViewRotationVector, modelViewTranslation;
+					if (!cv::solvePnP(bestView->objectPoints
+						, bestView->imagePoints
+						, bestView->cameraMatrix
+						, bestView->distortionCoefficients
+						, modelViewRotationVector
+						, modelViewTranslation
+						, false
+						, cv::SOLVEPNP_EPNP)) {
+						return result;
+					}
+
+					//object to world = camera to world * object to camera
+					auto objectToCamera = toPose(modelViewRotationVector, modelViewTranslation);
+					auto worldToCamera = toPose(bestView->rotationVector, bestView->translation);
+					double cameraToWorldRotation[9];
+					for (int i = 0; i < 3; i++) {
+						for (int j = 0; j < 3; j++) {
+							cameraToWorldRotation[i * 3 + j] = worldToCamera.rotation[j * 3 + i];
+						}
+					}
+					multiply(cameraToWorldRotation, objectToCamera.rotation, objectToWorld.rotation);
+					double offset[3];
+					for (int i = 0; i < 3; i++) {
+						offset[i] = objectToCamera.translation[i] - worldToCamera.translation[i];
+					}
+					transform(cameraToWorldRotation, nullptr, offset, objectToWorld.translation);
+				}
+
+				//Levenberg-Marquardt
+				const auto huberThreshold = (double) settings.huberThreshold;
+				double normal[36];
+				double gradient[6];
+				auto evaluation = evaluate(preparedViews, objectToWorld, huberThreshold, normal, gradient);
+				double lambda = 1e-3;
+
+				for (result.iterations = 0; result.iterations < settings.maximumIterations; result.iterations++) {
+					bool improved = false;
+					for (int attempt = 0; attempt < 10; attempt++) {
+						double damped[36];
+						memcpy(damped, normal, sizeof(damped));
+						for (int i = 0; i < 6; i++) {
+							damped[i * 6 + i] += lambda * max(normal[i * 6 + i], 1e-9);
+						}
+
+						double negativeGradient[6];
+						for (int i = 0; i < 6; i++) {
+							negativeGradient[i] = -gradient[i];
+						}
+
+						double update[6];
+						if (!solve6x6(damped, negativeGradient, update)) {
+							lambda *= 10.0;
+							continue;
+						}
+
+						auto candidate = applyUpdate(objectToWorld, update);
+						auto candidateEvaluation = evaluate(preparedViews, candidate, huberThreshold, nullptr, nullptr);
+						if (candidateEvaluation.cost < evaluation.cost) {
+							const auto costChange = evaluation.cost - candidateEvaluation.cost;
+							objectToWorld = candidate;
+							evaluation = evaluate(preparedViews, objectToWorld, huberThreshold, normal, gradient);
+							lambda = max(lambda / 10.0, 1e-9);
+							improved = costChange > settings.convergenceThreshold * max(evaluation.cost, 1.0);
+							break;
+						}
+						else {
+							lambda *= 10.0;
+						}
+					}
+
+					if (!improved) {
+						break;
+					}
+				}
+
+				fromPose(objectToWorld, rotationVector, translation);
+
+				result.success = evaluation.pointCount >= 3;
+				result.pointCount = evaluation.pointCount;
+				result.outlierCount = evaluation.outlierCount;
+				result.reprojectionError = evaluation.pointCount > 0
+					? (float) sqrt(evaluation.sumSquaredError / (double) evaluation.pointCount)
+					: 0.0f;
+				return result;
+			}
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ofxCvMin.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			///Jointly solves the pose of a rigid body seen by any number of calibrated cameras.
+			///Uses Levenberg-Marquardt on the 6 pose parameters with a Huber loss on the reprojection error.
+			///Camera parameters are fixed, so every observation only touches the 6 pose parameters and the
+			///6x6 normal equations are accumulated directly per camera (no dense Jacobian is built).
+			class MultiViewSolvePnP {
+			public:
+				struct View {
+					cv::Mat cameraMatrix;
+					cv::Mat distortionCoefficients;
+
+					//world to camera (i.e. the inverse of the camera's rigid body transform)
+					cv::Mat rotationVector;
+					cv::Mat translation;
+
+					vector<cv::Point2f> imagePoints;
+					vector<cv::Point3f> objectPoints;
+				};
+
+				struct Settings {
+					size_t maximumIterations = 20;
+					float huberThreshold = 2.0f; // px
+					double convergenceThreshold = 1e-10;
+				};
+
+				struct Result {
+					bool success = false;
+					size_t iterations = 0;
+					size_t viewCount = 0; // views which contributed points
+					size_t pointCount = 0;
+					size_t outlierCount = 0; // points beyond the Huber threshold
+					float reprojectionError = 0.0f; // px RMS
+				};
+
+				///rotationVector and translation are the object to world transform of the body (CV_64F, 3x1)
+				static Result solve(const vector<View> &
+					, cv::Mat & rotationVector
+					, cv::Mat & translation
+					, bool useExtrinsicGuess
+					, const Settings &);
+			};
+		}
+	}
+}
@@ -0,0 +1,766 @@
+#include "pch_Plugin_MoCap.h"
+#include "Replay.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+#pragma mark Helpers
+			namespace {
+				//----------
+				float getPercentile(vector<float> & sortedValues, float percentile) {
+					if (sortedValues.empty()) {
+						return 0.0f;
+					}
+					auto index = (size_t)(percentile * (float)(sortedValues.size() - 1) + 0.5f);
+					return sortedValues[min(index, sortedValues.size() - 1)];
+				}
+
+				//----------
+				const char * stageNames[] = {
+					"FindMarkerCentroids",
+					"MatchMarkers",
+					"UpdateTracking",
+					"End to end"
+				};
+
+				const size_t MaximumFrameTimings = 1000;
+			}
+
+#pragma mark Replay
+			//----------
+			Replay::Replay() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			Replay::~Replay() {
+				this->stop();
+			}
+
+			//----------
+			string Replay::getTypeName() const {
+				return "MoCap::Replay";
+			}
+
+			//----------
+			void Replay::init() {
+				RULR_NODE_UPDATE_LISTENER;
+				RULR_NODE_INSPECTOR_LISTENER;
+				RULR_NODE_SERIALIZATION_LISTENERS;
+
+				this->addInput<Item::Camera>();
+				this->addInput<Body>();
+
+				{
+					auto input = this->addInput<FindMarkerCentroids>();
+					input->onNewConnection += [this](shared_ptr<FindMarkerCentroids> node) {
+						node->onNewFrame.addListener([this](shared_ptr<FindMarkerCentroidsFrame> frame) {
+							this->notifyStage(FindMarkerCentroidsStage, frame->imageFrame);
+						}, this);
+					};
+					input->onDeleteConnection += [this](shared_ptr<FindMarkerCentroids> node) {
+						if (node) {
+							node->onNewFrame.removeListeners(this);
+						}
+					};
+				}
+				{
+					auto input = this->addInput<MatchMarkers>();
+					input->onNewConnection += [this](shared_ptr<MatchMarkers> node) {
+						node->onNewFrame.addListener([this](shared_ptr<MatchMarkersFrame> frame) {
+							if (frame->incomingFrame) {
+								this->notifyStage(MatchMarkersStage, frame->incomingFrame->imageFrame);
+							}
+						}, this);
+					};
+					input->onDeleteConnection += [this](shared_ptr<MatchMarkers> node) {
+						if (node) {
+							node->onNewFrame.removeListeners(this);
+						}
+					};
+				}
+				{
+					auto input = this->addInput<UpdateTracking>();
+					input->onNewConnection += [this](shared_ptr<UpdateTracking> node) {
+						node->onNewFrame.addListener([this](shared_ptr<UpdateTrackingFrame> frame) {
+							this->notifyTracking(frame);
+						}, this);
+					};
+					input->onDeleteConnection += [this](shared_ptr<UpdateTracking> node) {
+						if (node) {
+							node->onNewFrame.removeListeners(this);
+						}
+					};
+				}
+
+				this->manageParameters(this->parameters);
+			}
+
+			//----------
+			void Replay::update() {
+				//replay thread has finished by itself
+				if (!this->running && this->replayThread.joinable()) {
+					this->replayThread.join();
+					if (this->benchmarkRunning) {
+						this->benchmarkFinishing = true;
+						this->benchmarkReplayEnd = Clock::now();
+					}
+				}
+
+				//wait for the last frames to come through the chain
+				if (this->benchmarkFinishing) {
+					size_t framesInFlight;
+					{
+						auto lock = unique_lock<mutex>(this->statisticsMutex);
+						framesInFlight = this->framesInFlight;
+					}
+					auto timeout = chrono::duration<float, milli>(this->parameters.completionTimeout.get());
+					if (framesInFlight == 0 || Clock::now() - this->benchmarkReplayEnd > timeout) {
+						this->finishBenchmark();
+					}
+				}
+			}
+
+			//----------
+			void Replay::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+
+				inspector->addButton("Load recording...", [this]() {
+					try {
+						this->loadRecording();
+					}
+					RULR_CATCH_ALL_TO_ALERT;
+				});
+				inspector->addLiveValue<size_t>("Recorded frames", [this]() {
+					return this->recordedFrames.size();
+				});
+
+				inspector->addButton("Start", [this]() {
+					try {
+						this->start();
+					}
+					RULR_CATCH_ALL_TO_ALERT;
+				});
+				inspector->addButton("Stop", [this]() {
+					this->stop();
+				});
+				inspector->addIndicatorBool("Running", [this]() {
+					return this->isRunning();
+				});
+				inspector->addLiveValue<size_t>("Frames injected", [this]() {
+					return this->framesInjected.load();
+				});
+
+				inspector->addTitle("Report", ofxCvGui::Widgets::Title::Level::H3);
+				inspector->addLiveValue<float>("Throughput [fps]", [this]() {
+					return this->report.throughput;
+				});
+				inspector->addLiveValue<string>("Frames completed", [this]() {
+					return ofToString(this->report.framesCompleted) + " / " + ofToString(this->report.framesInjected);
+				});
+				for (size_t i = 0; i <= StageCount; i++) {
+					inspector->addLiveValue<string>(string(stageNames[i]) + " [ms]", [this, i]() {
+						if (i >= this->report.stages.size() || this->report.stages[i].count == 0) {
+							return string("-");
+						}
+						const auto & stage = this->report.stages[i];
+						return "p50 " + ofToString(stage.percentile50, 2)
+							+ ", p90 " + ofToString(stage.percentile90, 2)
+							+ ", p99 " + ofToString(stage.percentile99, 2)
+							+ ", max " + ofToString(stage.maximum, 2);
+					});
+				}
+				inspector->addLiveValue<string>("Position error [mm]", [this]() {
+					if (this->report.poseErrorCount == 0) {
+						return string("-");
+					}
+					return "mean " + ofToString(this->report.meanPositionError, 2) + ", max " + ofToString(this->report.maximumPositionError, 2);
+				});
+				inspector->addLiveValue<string>("Rotation error [deg]", [this]() {
+					if (this->report.poseErrorCount == 0) {
+						return string("-");
+					}
+					return "mean " + ofToString(this->report.meanRotationError, 2) + ", max " + ofToString(this->report.maximumRotationError, 2);
+				});
+			}
+
+			//----------
+			void Replay::serialize(Json::Value & json) {
+				Utils::Serializable::serialize(json, this->recordingFolder);
+			}
+
+			//----------
+			void Replay::deserialize(const Json::Value & json) {
+				Utils::Serializable::deserialize(json, this->recordingFolder);
+
+				if (!this->recordingFolder.get().empty()) {
+					try {
+						this->loadRecording(this->recordingFolder.get());
+					}
+					RULR_CATCH_ALL_TO_ERROR;
+				}
+			}
+
+			//----------
+			void Replay::loadRecording(string folderPath) {
+				if (folderPath.empty()) {
+					auto result = ofSystemLoadDialog("Select folder written by RecordMarkerImages", true);
+					if (!result.bSuccess) {
+						return;
+					}
+					folderPath = result.filePath;
+				}
+
+				this->stop();
+
+				//files are named by the frame's timestamp in nanoseconds
+				ofDirectory directory(folderPath);
+				if (!directory.exists()) {
+					throw(ofxRulr::Exception("Recording folder " + folderPath + " doesn't exist"));
+				}
+				directory.allowExt("png");
+				directory.listDir();
+
+				vector<RecordedFrame> recordedFrames;
+				for (size_t i = 0; i < directory.size(); i++) {
+					auto baseName = ofFilePath::getBaseName(directory.getPath(i));
+					try {
+						RecordedFrame recordedFrame;
+						recordedFrame.timestamp = chrono::nanoseconds(stoll(baseName));
+						recordedFrame.path = directory.getPath(i);
+						recordedFrames.push_back(recordedFrame);
+					}
+					catch (...) {
+						//not one of ours
+					}
+				}
+				if (recordedFrames.empty()) {
+					throw(ofxRulr::Exception("No recorded frames found in " + folderPath));
+				}
+
+				sort(recordedFrames.begin(), recordedFrames.end(), [](const RecordedFrame & a, const RecordedFrame & b) {
+					return a.timestamp < b.timestamp;
+				});
+
+				this->recordedFrames = move(recordedFrames);
+				this->recordingFolder = folderPath;
+			}
+
+			//----------
+			void Replay::start() {
+				this->stop();
+
+				auto camera = this->getInput<Item::Camera>();
+				if (!camera) {
+					throw(ofxRulr::Exception("Replay needs a camera to stream frames into"));
+				}
+
+				ReplaySettings settings;
+				settings.source = this->parameters.source.get();
+				settings.rate = this->parameters.rate.get();
+				settings.speed = this->parameters.speed.get();
+				settings.loop = this->parameters.loop.get() && !this->benchmarkRunning;
+				settings.maximumFramesInFlight = (size_t) this->parameters.maximumFramesInFlight.get();
+				settings.completionTimeout = chrono::duration_cast<Clock::duration>(chrono::duration<float, milli>(this->parameters.completionTimeout.get()));
+				settings.camera = camera;
+
+				if (settings.source == ReplaySource::Recording) {
+					if (this->recordedFrames.empty()) {
+						throw(ofxRulr::Exception("No recording loaded"));
+					}
+				}
+				else {
+					auto body = this->getInput<Body>();
+					if (!body) {
+						throw(ofxRulr::Exception("Synthetic replay needs a Body"));
+					}
+					settings.bodyDescription = body->getBodyDescription();
+					settings.baseTransform = body->getTransform();
+					settings.frameCount = (size_t) this->parameters.synthetic.frameCount.get();
+					settings.frameRate = this->parameters.synthetic.frameRate.get();
+					settings.noise = this->parameters.synthetic.noise.get();
+					settings.trajectoryRadius = this->parameters.synthetic.trajectoryRadius.get();
+					settings.trajectoryPeriod = this->parameters.synthetic.trajectoryPeriod.get();
+					settings.spinPeriod = this->parameters.synthetic.spinPeriod.get();
+
+					camera->getCameraMatrix().convertTo(settings.cameraMatrix, CV_64F);
+					camera->getDistortionCoefficients().convertTo(settings.distortionCoefficients, CV_64F);
+					cv::Mat rotationVector, translation;
+					camera->getExtrinsics(rotationVector, translation, true);
+					rotationVector.convertTo(settings.cameraRotationVector, CV_64F);
+					translation.convertTo(settings.cameraTranslation, CV_64F);
+					settings.width = (int)camera->getWidth();
+					settings.height = (int)camera->getHeight();
+				}
+
+				this->resetStatistics();
+				{
+					auto lock = unique_lock<mutex>(this->statisticsMutex);
+					this->completionStage = this->getInput<MatchMarkers>() ? MatchMarkersStage
+						: this->getInput<FindMarkerCentroids>() ? FindMarkerCentroidsStage
+						: StageCount;
+					this->endStage = this->getInput<UpdateTracking>() ? UpdateTrackingStage : this->completionStage;
+				}
+
+				this->running = true;
+				this->replayThread = thread([this, settings]() {
+					this->replayLoop(settings);
+				});
+			}
+
+			//----------
+			void Replay::stop() {
+				this->running = false;
+				this->framesInFlightChanged.notify_all();
+				if (this->replayThread.joinable()) {
+					this->replayThread.join();
+				}
+				this->benchmarkRunning = false;
+				this->benchmarkFinishing = false;
+			}
+
+			//----------
+			bool Replay::isRunning() const {
+				return this->running;
+			}
+
+			//----------
+			void Replay::runBenchmark() {
+				this->stop();
+				this->benchmarkRunning = true;
+				try {
+					this->start();
+				}
+				catch (...) {
+					this->benchmarkRunning = false;
+					throw;
+				}
+			}
+
+			//----------
+			void Replay::serializeResult(Json::Value & json) const {
+				json["framesInjected"] = (Json::UInt64) this->report.framesInjected;
+				json["framesCompleted"] = (Json::UInt64) this->report.framesCompleted;
+				json["duration"] = this->report.duration;
+				json["throughput"] = this->report.throughput;
+				for (const auto & stage : this->report.stages) {
+					auto & jsonStage = json["stages"][stage.name];
+					jsonStage["count"] = (Json::UInt64) stage.count;
+					jsonStage["percentile50"] = stage.percentile50;
+					jsonStage["percentile90"] = stage.percentile90;
+					jsonStage["percentile99"] = stage.percentile99;
+					jsonStage["maximum"] = stage.maximum;
+				}
+				json["poseErrorCount"] = (Json::UInt64) this->report.poseErrorCount;
+				json["meanPositionError"] = this->report.meanPositionError;
+				json["maximumPositionError"] = this->report.maximumPositionError;
+				json["meanRotationError"] = this->report.meanRotationError;
+				json["maximumRotationError"] = this->report.maximumRotationError;
+			}
+
+			//----------
+			bool Replay::getRunsOverFrames() const {
+				//finished from update() once the last frames are through the chain
+				return true;
+			}
+
+			//----------
+			bool Replay::getCanWaitForResult() const {
+				return true;
+			}
+
+			//----------
+			void Replay::waitForResult() {
+				//the stages process on their own threads, so we can wait here instead of over frames
+				while (this->benchmarkRunning) {
+					this_thread::sleep_for(chrono::milliseconds(1));
+					this->update();
+				}
+			}
+
+			//----------
+			Replay::Report Replay::getReport() const {
+				auto lock = unique_lock<mutex>(this->statisticsMutex);
+
+				Report report;
+				report.framesInjected = this->framesInjected.load();
+				report.framesCompleted = this->framesCompleted;
+				if (this->framesCompleted > 0) {
+					report.duration = chrono::duration<float>(this->lastCompletedTime - this->startTime).count();
+					report.throughput = report.duration > 0.0f
+						? (float)report.framesCompleted / report.duration
+						: 0.0f;
+				}
+
+				for (size_t i = 0; i <= StageCount; i++) {
+					auto latencies = this->stageLatencies[i];
+					sort(latencies.begin(), latencies.end());
+
+					StageStatistics stage;
+					stage.name = stageNames[i];
+					stage.count = latencies.size();
+					stage.percentile50 = getPercentile(latencies, 0.5f);
+					stage.percentile90 = getPercentile(latencies, 0.9f);
+					stage.percentile99 = getPercentile(latencies, 0.99f);
+					stage.maximum = latencies.empty() ? 0.0f : latencies.back();
+					report.stages.push_back(stage);
+				}
+
+				report.poseErrorCount = this->positionErrors.size();
+				for (size_t i = 0; i < report.poseErrorCount; i++) {
+					report.meanPositionError += this->positionErrors[i];
+					report.maximumPositionError = max(report.maximumPositionError, this->positionErrors[i]);
+					report.meanRotationError += this->rotationErrors[i];
+					report.maximumRotationError = max(report.maximumRotationError, this->rotationErrors[i]);
+				}
+				if (report.poseErrorCount > 0) {
+					report.meanPositionError /= (float)report.poseErrorCount;
+					report.meanRotationError /= (float)report.poseErrorCount;
+				}
+
+				return report;
+			}
+
+			//----------
+			void Replay::replayLoop(ReplaySettings settings) {
+				const auto isRecording = settings.source == ReplaySource::Recording;
+				const auto sourceCount = isRecording ? this->recordedFrames.size() : settings.frameCount;
+				if (sourceCount == 0) {
+					this->running = false;
+					return;
+				}
+
+				//timestamps keep increasing when we loop
+				chrono::nanoseconds firstTimestamp(0);
+				chrono::nanoseconds sourceDuration;
+				if (isRecording) {
+					firstTimestamp = this->recordedFrames.front().timestamp;
+					sourceDuration = this->recordedFrames.back().timestamp - firstTimestamp;
+					if (sourceCount > 1) {
+						sourceDuration += sourceDuration / (sourceCount - 1);
+					}
+				}
+				else {
+					sourceDuration = chrono::duration_cast<chrono::nanoseconds>(chrono::duration<double>((double)sourceCount / settings.frameRate));
+				}
+
+				const auto replayStart = Clock::now();
+				chrono::nanoseconds loopOffset(0);
+				uint64_t frameIndex = 0;
+				size_t sourceIndex = 0;
+
+				while (this->running) {
+					if (sourceIndex >= sourceCount) {
+						if (!settings.loop) {
+							break;
+						}
+						sourceIndex = 0;
+						loopOffset += sourceDuration;
+					}
+
+					//make the frame
+					shared_ptr<ofxMachineVision::Frame> frame;
+					chrono::nanoseconds timestamp;
+					FrameTiming frameTiming;
+					try {
+						if (isRecording) {
+							const auto & recordedFrame = this->recordedFrames[sourceIndex];
+							timestamp = recordedFrame.timestamp - firstTimestamp + loopOffset;
+							frame = this->makeRecordedFrame(recordedFrame);
+						}
+						else {
+							timestamp = chrono::duration_cast<chrono::nanoseconds>(chrono::duration<double>((double)sourceIndex / settings.frameRate)) + loopOffset;
+							auto bodyTransform = Replay::getTrajectoryTransform(settings, chrono::duration<float>(timestamp).count());
+							frame = this->makeSyntheticFrame(settings, bodyTransform);
+							frameTiming.hasGroundTruth = true;
+							frameTiming.groundTruth = bodyTransform;
+						}
+					}
+					RULR_CATCH_ALL_TO_ERROR;
+					sourceIndex++;
+
+					if (!frame) {
+						continue;
+					}
+					frame->setTimestamp(timestamp);
+					frame->setFrameIndex(frameIndex);
+
+					//pace
+					if (settings.rate == ReplayRate::WallClock) {
+						auto replayTime = chrono::duration<double, nano>(timestamp.count() / (double)settings.speed);
+						this_thread::sleep_until(replayStart + chrono::duration_cast<Clock::duration>(replayTime));
+					}
+					else {
+						auto lock = unique_lock<mutex>(this->statisticsMutex);
+						auto isReady = [this, &settings]() {
+							return this->framesInFlight < settings.maximumFramesInFlight || !this->running;
+						};
+						if (!this->framesInFlightChanged.wait_for(lock, settings.completionTimeout, isReady)) {
+							//presume the frames in flight were dropped somewhere in the chain
+							for (auto & it : this->frameTimings) {
+								if (!it.second.completed) {
+									it.second.abandoned = true;
+								}
+							}
+							this->framesInFlight = 0;
+						}
+					}
+					if (!this->running) {
+						break;
+					}
+
+					auto camera = settings.camera.lock();
+					if (!camera) {
+						break;
+					}
+
+					//register the frame and send it
+					{
+						auto lock = unique_lock<mutex>(this->statisticsMutex);
+						frameTiming.injected = Clock::now();
+						this->frameTimings.emplace(frameIndex, frameTiming);
+						if (this->completionStage != StageCount) {
+							this->framesInFlight++;
+						}
+
+						while (this->frameTimings.size() > MaximumFrameTimings) {
+							auto & oldest = this->frameTimings.begin()->second;
+							if (!oldest.completed && !oldest.abandoned && this->framesInFlight > 0) {
+								this->framesInFlight--;
+							}
+							this->frameTimings.erase(this->frameTimings.begin());
+						}
+					}
+					this->framesInjected++;
+					camera->onNewFrame.notifyListeners(frame);
+
+					frameIndex++;
+				}
+
+				this->running = false;
+			}
+
+			//----------
+			shared_ptr<ofxMachineVision::Frame> Replay::makeRecordedFrame(const RecordedFrame & recordedFrame) const {
+				auto image = cv::imread(recordedFrame.path, cv::IMREAD_GRAYSCALE);
+				if (image.empty()) {
+					throw(ofxRulr::Exception("Couldn't load " + recordedFrame.path));
+				}
+
+				auto frame = ofxMachineVision::FramePool::X().getAvailableAllocatedFrame(image.cols, image.rows, OF_PIXELS_GRAY);
+				image.copyTo(ofxCv::toCv(frame->getPixels()));
+				return frame;
+			}
+
+			//----------
+			shared_ptr<ofxMachineVision::Frame> Replay::makeSyntheticFrame(const ReplaySettings & settings, const ofMatrix4x4 & bodyTransform) const {
+				auto frame = ofxMachineVision::FramePool::X().getAvailableAllocatedFrame(settings.width, settings.height, OF_PIXELS_GRAY);
+				auto image = ofxCv::toCv(frame->getPixels());
+
+				//background noise
+				if (settings.noise > 0.0f) {
+					cv::randu(image, 0, settings.noise);
+				}
+				else {
+					image.setTo(0);
+				}
+
+				const auto & markers = settings.bodyDescription->markers;
+				if (markers.positions.empty()) {
+					return frame;
+				}
+
+				vector<cv::Point3f> worldPoints;
+				for (const auto & position : markers.positions) {
+					worldPoints.push_back(ofxCv::toCv(position * bodyTransform));
+				}
+
+				vector<cv::Point2f> imagePoints;
+				cv::projectPoints(worldPoints
+					, settings.cameraRotationVector
+					, settings.cameraTranslation
+					, settings.cameraMatrix
+					, settings.distortionCoefficients
+					, imagePoints);
+
+				cv::Mat cameraRotation;
+				cv::Rodrigues(settings.cameraRotationVector, cameraRotation);
+				const auto focalLength = settings.cameraMatrix.at<double>(0, 0);
+
+				//draw the markers as discs with sub-pixel accuracy
+				const int shift = 4;
+				const auto scale = (float)(1 << shift);
+				for (size_t i = 0; i < worldPoints.size(); i++) {
+					const auto & worldPoint = worldPoints[i];
+					auto depth = cameraRotation.at<double>(2, 0) * worldPoint.x
+						+ cameraRotation.at<double>(2, 1) * worldPoint.y
+						+ cameraRotation.at<double>(2, 2) * worldPoint.z
+						+ settings.cameraTranslation.at<double>(2);
+					if (depth <= 0.0) {
+						continue;
+					}
+
+					auto radius = focalLength * settings.bodyDescription->markerDiameter / 2.0 / depth;
+					cv::circle(image
+						, cv::Point((int)(imagePoints[i].x * scale), (int)(imagePoints[i].y * scale))
+						, max((int)(radius * scale), 1)
+						, cv::Scalar(255)
+						, -1
+						, CV_AA
+						, shift);
+				}
+
+				return frame;
+			}
+
+			//----------
+			ofMatrix4x4 Replay::getTrajectoryTransform(const ReplaySettings & settings, float time) {
+				//circle in the body's local XZ plane whilst spinning about its local Y
+				auto orbitAngle = time / settings.trajectoryPeriod * TWO_PI;
+				auto spinAngle = time / settings.spinPeriod * 360.0f;
+
+				ofVec3f offset(cos(orbitAngle) * settings.trajectoryRadius
+					, 0.0f
+					, sin(orbitAngle) * settings.trajectoryRadius);
+
+				return ofMatrix4x4::newRotationMatrix(spinAngle, 0, 1, 0)
+					* ofMatrix4x4::newTranslationMatrix(offset)
+					* settings.baseTransform;
+			}
+
+			//----------
+			void Replay::resetStatistics() {
+				auto lock = unique_lock<mutex>(this->statisticsMutex);
+				this->frameTimings.clear();
+				for (auto & latencies : this->stageLatencies) {
+					latencies.clear();
+				}
+				this->positionErrors.clear();
+				this->rotationErrors.clear();
+				this->framesCompleted = 0;
+				this->framesInFlight = 0;
+				this->framesInjected.store(0);
+				this->startTime = Clock::now();
+				this->lastCompletedTime = this->startTime;
+			}
+
+			//----------
+			void Replay::notifyStage(Stage stage, const shared_ptr<ofxMachineVision::Frame> & imageFrame) {
+				if (!imageFrame) {
+					return;
+				}
+
+				const auto now = Clock::now();
+				auto lock = unique_lock<mutex>(this->statisticsMutex);
+
+				auto findTiming = this->frameTimings.find(imageFrame->getFrameIndex());
+				if (findTiming == this->frameTimings.end()) {
+					//not one of ours (or too old)
+					return;
+				}
+				auto & frameTiming = findTiming->second;
+				if (frameTiming.hasStage[stage]) {
+					return;
+				}
+				frameTiming.stages[stage] = now;
+				frameTiming.hasStage[stage] = true;
+
+				//latency since the previous stage this frame passed through
+				auto previousTime = frameTiming.injected;
+				for (int i = (int)stage - 1; i >= 0; i--) {
+					if (frameTiming.hasStage[i]) {
+						previousTime = frameTiming.stages[i];
+						break;
+					}
+				}
+				this->stageLatencies[stage].push_back(chrono::duration<float, milli>(now - previousTime).count());
+
+				if (stage == this->endStage) {
+					this->stageLatencies[StageCount].push_back(chrono::duration<float, milli>(now - frameTiming.injected).count());
+					this->framesCompleted++;
+					this->lastCompletedTime = now;
+				}
+
+				if (stage == this->completionStage && !frameTiming.completed) {
+					frameTiming.completed = true;
+					if (!frameTiming.abandoned && this->framesInFlight > 0) {
+						this->framesInFlight--;
+						lock.unlock();
+						this->framesInFlightChanged.notify_all();
+					}
+				}
+			}
+
+			//----------
+			void Replay::notifyTracking(const shared_ptr<UpdateTrackingFrame> & updateTrackingFrame) {
+				if (!updateTrackingFrame->incomingFrame || !updateTrackingFrame->incomingFrame->incomingFrame) {
+					return;
+				}
+				const auto & imageFrame = updateTrackingFrame->incomingFrame->incomingFrame->imageFrame;
+				if (!imageFrame) {
+					return;
+				}
+
+				this->notifyStage(UpdateTrackingStage, imageFrame);
+
+				//pose error against ground truth
+				if (updateTrackingFrame->updateTarget.get() != UpdateTarget::Body) {
+					return;
+				}
+				auto lock = unique_lock<mutex>(this->statisticsMutex);
+				auto findTiming = this->frameTimings.find(imageFrame->getFrameIndex());
+				if (findTiming == this->frameTimings.end() || !findTiming->second.hasGroundTruth) {
+					return;
+				}
+				const auto & groundTruth = findTiming->second.groundTruth;
+				const auto & transform = updateTrackingFrame->transform;
+
+				auto positionError = (transform.getTranslation() - groundTruth.getTranslation()).length();
+
+				auto rotationDifference = transform.getRotate() * groundTruth.getRotate().inverse();
+				float rotationError;
+				ofVec3f axis;
+				rotationDifference.getRotate(rotationError, axis);
+				if (rotationError > 180.0f) {
+					rotationError = 360.0f - rotationError;
+				}
+
+				this->positionErrors.push_back(positionError * 1000.0f);
+				this->rotationErrors.push_back(rotationError);
+			}
+
+			//----------
+			void Replay::finishBenchmark() {
+				this->benchmarkRunning = false;
+				this->benchmarkFinishing = false;
+				this->report = this->getReport();
+
+				//log and save the report
+				stringstream csv;
+				csv << "stage,count,p50 [ms],p90 [ms],p99 [ms],max [ms]" << endl;
+				for (const auto & stage : this->report.stages) {
+					csv << stage.name << "," << stage.count << ","
+						<< stage.percentile50 << "," << stage.percentile90 << ","
+						<< stage.percentile99 << "," << stage.maximum << endl;
+				}
+				csv << endl;
+				csv << "frames injected," << this->report.framesInjected << endl;
+				csv << "frames completed," << this->report.framesCompleted << endl;
+				csv << "throughput [fps]," << this->report.throughput << endl;
+				csv << "pose samples," << this->report.poseErrorCount << endl;
+				csv << "mean position error [mm]," << this->report.meanPositionError << endl;
+				csv << "max position error [mm]," << this->report.maximumPositionError << endl;
+				csv << "mean rotation error [deg]," << this->report.meanRotationError << endl;
+				csv << "max rotation error [deg]," << this->report.maximumRotationError << endl;
+
+				ofLogNotice("MoCap::Replay") << "Benchmark complete" << endl << csv.str();
+
+				auto filename = ofToDataPath(this->getDefaultFilename() + "-benchmark.csv");
+				ofBuffer buffer(csv.str());
+				ofBufferToFile(filename, buffer);
+
+				this->notifyResult();
+			}
+		}
+	}
+}
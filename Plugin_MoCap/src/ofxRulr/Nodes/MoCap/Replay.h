@@ -0,0 +1,188 @@
+#pragma once
+
+#include "ofxRulr/Nodes/Item/Camera.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+#include "FindMarkerCentroids.h"
+#include "MatchMarkers.h"
+#include "UpdateTracking.h"
+
+#include <thread>
+#include <condition_variable>
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			MAKE_ENUM(ReplaySource
+				, (Recording, Synthetic)
+				, ("Recording", "Synthetic"));
+
+			MAKE_ENUM(ReplayRate
+				, (WallClock, AsFastAsPossible)
+				, ("Wall clock", "As fast as possible"));
+
+			///Streams frames into an Item::Camera (as if they came from its grabber), so that the usual
+			///FindMarkerCentroids -> MatchMarkers -> UpdateTracking chain can be run away from the stage.
+			///Frames come either from a folder written by RecordMarkerImages, or are rendered from a Body
+			///following a known trajectory. Connect the stages to measure their latency, and UpdateTracking
+			///(with a Body update target) to measure pose error against the synthetic ground truth.
+			class Replay : public Nodes::Test::Benchmark {
+			public:
+				typedef chrono::high_resolution_clock Clock;
+
+				struct StageStatistics {
+					string name;
+					size_t count = 0;
+					float percentile50 = 0.0f; // ms
+					float percentile90 = 0.0f; // ms
+					float percentile99 = 0.0f; // ms
+					float maximum = 0.0f; // ms
+				};
+
+				struct Report {
+					size_t framesInjected = 0;
+					size_t framesCompleted = 0; // reached the last connected stage
+					float duration = 0.0f; // s
+					float throughput = 0.0f; // frames per second
+					vector<StageStatistics> stages;
+					size_t poseErrorCount = 0;
+					float meanPositionError = 0.0f; // mm
+					float maximumPositionError = 0.0f; // mm
+					float meanRotationError = 0.0f; // degrees
+					float maximumRotationError = 0.0f; // degrees
+				};
+
+				Replay();
+				virtual ~Replay();
+				string getTypeName() const override;
+				void init();
+				void update();
+
+				void populateInspector(ofxCvGui::InspectArguments &);
+				void serialize(Json::Value &);
+				void deserialize(const Json::Value &);
+
+				void loadRecording(string folderPath = "");
+
+				void start();
+				void stop();
+				bool isRunning() const;
+
+				///Replays the whole source once as fast as possible and reports when done
+				void runBenchmark() override;
+				void serializeResult(Json::Value &) const override;
+				bool getRunsOverFrames() const override;
+				bool getCanWaitForResult() const override;
+				void waitForResult() override;
+				Report getReport() const;
+			protected:
+				enum Stage : size_t {
+					FindMarkerCentroidsStage = 0,
+					MatchMarkersStage,
+					UpdateTrackingStage,
+					StageCount
+				};
+
+				struct RecordedFrame {
+					chrono::nanoseconds timestamp;
+					string path;
+				};
+
+				//everything the replay thread needs, taken on the main thread at start
+				struct ReplaySettings {
+					ReplaySource source;
+					ReplayRate rate;
+					float speed;
+					bool loop;
+					size_t maximumFramesInFlight;
+					Clock::duration completionTimeout;
+
+					weak_ptr<Item::Camera> camera;
+
+					//synthetic
+					size_t frameCount;
+					float frameRate;
+					float noise;
+					float trajectoryRadius;
+					float trajectoryPeriod;
+					float spinPeriod;
+					ofMatrix4x4 baseTransform;
+					shared_ptr<Body::Description> bodyDescription;
+					cv::Mat cameraMatrix;
+					cv::Mat distortionCoefficients;
+					cv::Mat cameraRotationVector; // world to camera
+					cv::Mat cameraTranslation;
+					int width;
+					int height;
+				};
+
+				struct FrameTiming {
+					Clock::time_point injected;
+					Clock::time_point stages[StageCount];
+					bool hasStage[StageCount] = { false, false, false };
+					bool completed = false;
+					bool abandoned = false; // presumed dropped by the chain
+					bool hasGroundTruth = false;
+					ofMatrix4x4 groundTruth;
+				};
+
+				void replayLoop(ReplaySettings);
+				shared_ptr<ofxMachineVision::Frame> makeRecordedFrame(const RecordedFrame &) const;
+				shared_ptr<ofxMachineVision::Frame> makeSyntheticFrame(const ReplaySettings &, const ofMatrix4x4 & bodyTransform) const;
+				static ofMatrix4x4 getTrajectoryTransform(const ReplaySettings &, float time);
+
+				void resetStatistics();
+				void notifyStage(Stage, const shared_ptr<ofxMachineVision::Frame> &);
+				void notifyTracking(const shared_ptr<UpdateTrackingFrame> &);
+				void finishBenchmark();
+
+				struct : ofParameterGroup {
+					ofParameter<ReplaySource> source{ "Source", ReplaySource::Recording };
+					ofParameter<ReplayRate> rate{ "Rate", ReplayRate::WallClock };
+					ofParameter<float> speed{ "Speed", 1.0f, 0.01f, 100.0f };
+					ofParameter<bool> loop{ "Loop", false };
+					ofParameter<int> maximumFramesInFlight{ "Maximum frames in flight", 2, 1, 100 };
+					ofParameter<float> completionTimeout{ "Completion timeout [ms]", 100.0f, 1.0f, 10000.0f };
+
+					struct : ofParameterGroup {
+						ofParameter<int> frameCount{ "Frame count", 1000, 1, 1000000 };
+						ofParameter<float> frameRate{ "Frame rate", 120.0f, 1.0f, 1000.0f };
+						ofParameter<float> noise{ "Noise", 2.0f, 0.0f, 64.0f };
+						ofParameter<float> trajectoryRadius{ "Trajectory radius [m]", 0.2f, 0.0f, 10.0f };
+						ofParameter<float> trajectoryPeriod{ "Trajectory period [s]", 4.0f, 0.1f, 1000.0f };
+						ofParameter<float> spinPeriod{ "Spin period [s]", 8.0f, 0.1f, 1000.0f };
+						PARAM_DECLARE("Synthetic", frameCount, frameRate, noise, trajectoryRadius, trajectoryPeriod, spinPeriod);
+					} synthetic;
+
+					PARAM_DECLARE("Replay", source, rate, speed, loop, maximumFramesInFlight, completionTimeout, synthetic);
+				} parameters;
+
+				ofParameter<string> recordingFolder{ "Recording folder", "" };
+				vector<RecordedFrame> recordedFrames;
+
+				thread replayThread;
+				atomic<bool> running{ false };
+				atomic<size_t> framesInjected{ 0 };
+
+				bool benchmarkRunning = false;
+				bool benchmarkFinishing = false;
+				Clock::time_point benchmarkReplayEnd;
+
+				//statistics (accessed from the processing threads)
+				map<uint64_t, FrameTiming> frameTimings;
+				vector<float> stageLatencies[StageCount + 1]; // ms, last is end to end
+				vector<float> positionErrors; // mm
+				vector<float> rotationErrors; // degrees
+				size_t framesCompleted = 0;
+				size_t framesInFlight = 0;
+				size_t completionStage = StageCount; // deepest connected stage which emits for every frame
+				size_t endStage = StageCount; // deepest connected stage
+				Clock::time_point startTime;
+				Clock::time_point lastCompletedTime;
+				mutable mutex statisticsMutex;
+				condition_variable framesInFlightChanged;
+
+				Report report;
+			};
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#include "pch_Plugin_MoCap.h"
+#include "SynchroniseFrames.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			//----------
+			SynchroniseFrames::SynchroniseFrames() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			string SynchroniseFrames::getTypeName() const {
+				return "MoCap::SynchroniseFrames";
+			}
+
+			//----------
+			void SynchroniseFrames::init() {
+				RULR_NODE_UPDATE_LISTENER;
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				for (size_t i = 0; i < MaxCameraCount; i++) {
+					this->frameSynchroniser.setActive(i, false);
+
+					auto input = this->addInput<MatchMarkers>("MatchMarkers " + ofToString(i + 1));
+					input->onNewConnection += [this, i](shared_ptr<MatchMarkers> inputNode) {
+						this->frameSynchroniser.setActive(i, true);
+						inputNode->onNewFrame.addListener([this, i](shared_ptr<MatchMarkersFrame> incomingFrame) {
+							auto synchronisedFrames = this->frameSynchroniser.add(i, incomingFrame);
+							for (auto & synchronisedFrame : synchronisedFrames) {
+								this->setsSinceLastAppFrame++;
+								this->onNewFrame.notifyListeners(synchronisedFrame);
+							}
+						}, this);
+					};
+					input->onDeleteConnection += [this, i](shared_ptr<MatchMarkers> inputNode) {
+						if (inputNode) {
+							inputNode->onNewFrame.removeListeners(this);
+						}
+						this->frameSynchroniser.setActive(i, false);
+					};
+				}
+
+				this->manageParameters(this->parameters);
+			}
+
+			//----------
+			void SynchroniseFrames::update() {
+				this->updateSynchroniserSettings();
+
+				//emit sets which have timed out whilst no new frames were arriving
+				{
+					auto synchronisedFrames = this->frameSynchroniser.flush();
+					for (auto & synchronisedFrame : synchronisedFrames) {
+						this->setsSinceLastAppFrame++;
+						this->onNewFrame.notifyListeners(synchronisedFrame);
+					}
+				}
+
+				auto setsPerSecond = (float)this->setsSinceLastAppFrame.load() / ofGetLastFrameTime();
+				this->setsPerSecond = ofLerp(this->setsPerSecond, setsPerSecond, 0.1f);
+				this->setsSinceLastAppFrame.store(0);
+			}
+
+			//----------
+			void SynchroniseFrames::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				const auto & statistics = this->frameSynchroniser.getStatistics();
+
+				inspector->addLiveValueHistory("Sets [Hz]", [this]() {
+					return this->setsPerSecond;
+				});
+				inspector->addLiveValueHistory("Pairing latency [ms]", [&statistics]() {
+					return statistics.pairingLatency.load();
+				});
+				inspector->addLiveValueHistory("Timestamp spread [ms]", [&statistics]() {
+					return statistics.timestampSpread.load();
+				});
+				inspector->addLiveValue<uint32_t>("Sets emitted", [&statistics]() {
+					return statistics.setsEmitted.load();
+				});
+				inspector->addLiveValue<uint32_t>("Partial sets", [&statistics]() {
+					return statistics.partialSets.load();
+				});
+				inspector->addLiveValue<uint32_t>("Stragglers dropped", [&statistics]() {
+					return statistics.stragglersDropped.load();
+				});
+				inspector->addLiveValue<uint32_t>("Buffer overflows", [&statistics]() {
+					return statistics.overflowDropped.load();
+				});
+				inspector->addButton("Reset statistics", [this]() {
+					this->frameSynchroniser.resetStatistics();
+				});
+			}
+
+			//----------
+			void SynchroniseFrames::updateSynchroniserSettings() {
+				FrameSynchroniser::Settings settings;
+				settings.tolerance = chrono::duration_cast<chrono::nanoseconds>(chrono::duration<float, milli>(this->parameters.tolerance.get()));
+				settings.maximumWait = chrono::duration_cast<FrameSynchroniser::Clock::duration>(chrono::duration<float, milli>(this->parameters.maximumWait.get()));
+				settings.bufferSize = (size_t) this->parameters.bufferSize.get();
+				settings.minimumCount = (size_t) this->parameters.minimumCount.get();
+				this->frameSynchroniser.setSettings(settings);
+			}
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ofxRulr/Nodes/Base.h"
+#include "FrameSynchroniser.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			///Groups the MatchMarkers results of up to MaxCameraCount cameras by capture timestamp
+			///and emits each synchronised set for a multi-view solver
+			class SynchroniseFrames : public Nodes::Base {
+			public:
+				enum Constants : size_t {
+					MaxCameraCount = 8
+				};
+
+				SynchroniseFrames();
+				string getTypeName() const override;
+				void init();
+				void update();
+				void populateInspector(ofxCvGui::InspectArguments &);
+
+				//happens in the thread of the camera which completes the set (or in the app thread if the set timed out)
+				ofxLiquidEvent<shared_ptr<SynchronisedFrames>> onNewFrame;
+			protected:
+				void updateSynchroniserSettings();
+
+				struct : ofParameterGroup {
+					ofParameter<float> tolerance{ "Tolerance [ms]", 2, 0, 100 };
+					ofParameter<float> maximumWait{ "Maximum wait [ms]", 50, 0, 1000 };
+					ofParameter<int> bufferSize{ "Buffer size per camera", 8, 1, 100 };
+					ofParameter<int> minimumCount{ "Minimum cameras (0 = all)", 0, 0, MaxCameraCount };
+					PARAM_DECLARE("SynchroniseFrames", tolerance, maximumWait, bufferSize, minimumCount);
+				} parameters;
+
+				FrameSynchroniser frameSynchroniser{ MaxCameraCount };
+
+				atomic<int> setsSinceLastAppFrame{ 0 };
+				float setsPerSecond = 0.0f;
+			};
+		}
+	}
+}
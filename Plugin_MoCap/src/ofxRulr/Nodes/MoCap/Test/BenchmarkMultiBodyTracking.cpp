@@ -0,0 +1,270 @@
+#include "pch_Plugin_MoCap.h"
+#include "BenchmarkMultiBodyTracking.h"
+
+#include <random>
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			namespace Test {
+				//----------
+				BenchmarkMultiBodyTracking::BenchmarkMultiBodyTracking() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string BenchmarkMultiBodyTracking::getTypeName() const {
+					return "MoCap::Test::BenchmarkMultiBodyTracking";
+				}
+
+				//----------
+				void BenchmarkMultiBodyTracking::init() {
+					RULR_NODE_INSPECTOR_LISTENER;
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void BenchmarkMultiBodyTracking::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					for (size_t i = 0; i < this->results.size(); i++) {
+						const auto & result = this->results[i];
+						inspector->addTitle(ofToString(result.bodyCount) + " bodies", ofxCvGui::Widgets::Title::Level::H3);
+						inspector->addLiveValue<float>("Per body chains CPU [us/frame]", [this, i]() {
+							return this->results[i].perBodyDuration;
+						});
+						inspector->addLiveValue<float>("Multi body CPU [us/frame]", [this, i]() {
+							return this->results[i].multiBodyDuration;
+						});
+						inspector->addLiveValue<float>("Multi body wall [us/frame]", [this, i]() {
+							return this->results[i].multiBodyWallDuration;
+						});
+						inspector->addLiveValue<string>("Tracked (per body / multi body)", [this, i]() {
+							return ofToString(this->results[i].perBodyTracked * 100.0f, 1) + "% / "
+								+ ofToString(this->results[i].multiBodyTracked * 100.0f, 1) + "%";
+						});
+						inspector->addLiveValue<string>("Mismatches per frame (per body / multi body)", [this, i]() {
+							return ofToString(this->results[i].perBodyMismatches, 2) + " / "
+								+ ofToString(this->results[i].multiBodyMismatches, 2);
+						});
+					}
+				}
+
+				//----------
+				void BenchmarkMultiBodyTracking::serializeResult(Json::Value & json) const {
+					for (const auto & result : this->results) {
+						Json::Value jsonResult;
+						jsonResult["bodyCount"] = result.bodyCount;
+						jsonResult["perBodyDuration"] = result.perBodyDuration;
+						jsonResult["multiBodyDuration"] = result.multiBodyDuration;
+						jsonResult["multiBodyWallDuration"] = result.multiBodyWallDuration;
+						jsonResult["perBodyTracked"] = result.perBodyTracked;
+						jsonResult["multiBodyTracked"] = result.multiBodyTracked;
+						jsonResult["perBodyMismatches"] = result.perBodyMismatches;
+						jsonResult["multiBodyMismatches"] = result.multiBodyMismatches;
+						json["results"].append(jsonResult);
+					}
+				}
+
+				//----------
+				void BenchmarkMultiBodyTracking::runBenchmark() {
+					const auto trialCount = (size_t) this->parameters.trialCount.get();
+					const auto markerCount = (size_t) this->parameters.markerCount.get();
+					const auto distanceThreshold = this->parameters.distanceThreshold.get();
+					const auto reprojectionThreshold = 5.0f;
+
+					Utils::ScopedProcess scopedProcess("Benchmark multi body tracking", false);
+
+					//deterministic scene
+					mt19937 randomEngine(0);
+					uniform_real_distribution<double> unitDistribution(0.0, 1.0);
+					normal_distribution<double> noiseDistribution(0.0, max(this->parameters.noise.get(), 1e-6f));
+					auto random = [&](double minimum, double maximum) {
+						return minimum + (maximum - minimum) * unitDistribution(randomEngine);
+					};
+
+					//camera at the origin looking down +z
+					const float width = 1280.0f;
+					const float height = 720.0f;
+					auto cameraDescription = make_shared<CameraDescription>();
+					cameraDescription->cameraMatrix = (cv::Mat_<double>(3, 3) << 1000, 0, width / 2, 0, 1000, height / 2, 0, 0, 1);
+					cameraDescription->distortionCoefficients = cv::Mat::zeros(5, 1, CV_64F);
+					cameraDescription->inverseRotationVector = cv::Mat::zeros(3, 1, CV_64F);
+					cameraDescription->inverseTranslation = cv::Mat::zeros(3, 1, CV_64F);
+					{
+						const float nearClip = 0.1f;
+						const float farClip = 100.0f;
+						cameraDescription->viewProjectionMatrix = ofMatrix4x4(2.0f * 1000.0f / width, 0, 0, 0
+							, 0, 2.0f * 1000.0f / height, 0, 0
+							, 0, 0, (farClip + nearClip) / (farClip - nearClip), 1
+							, 0, 0, -2.0f * farClip * nearClip / (farClip - nearClip), 0);
+					}
+
+					MultiBodyTracking::Settings settings;
+					settings.distanceThreshold = distanceThreshold;
+					settings.reprojectionThreshold = reprojectionThreshold;
+					settings.threadCount = (size_t) this->parameters.threadCount.get();
+
+					vector<Result> results;
+					for (size_t bodyCount : { 1, 5, 10, 20 }) {
+						Result result;
+						result.bodyCount = (int)bodyCount;
+
+						float perBodyDuration = 0.0f;
+						float multiBodyDuration = 0.0f;
+						float multiBodyWallDuration = 0.0f;
+						size_t perBodyTracked = 0;
+						size_t multiBodyTracked = 0;
+						size_t perBodyMismatches = 0;
+						size_t multiBodyMismatches = 0;
+
+						for (size_t trial = 0; trial < trialCount; trial++) {
+							//bodies at their last known (predicted) poses, then moved slightly to make the frame
+							vector<shared_ptr<Body::Description>> bodyDescriptions;
+							auto incomingFrame = make_shared<FindMarkerCentroidsFrame>();
+							vector<pair<int, MarkerID>> centroidTruth; // {body, marker ID} for each centroid
+
+							for (size_t bodyIndex = 0; bodyIndex < bodyCount; bodyIndex++) {
+								auto bodyDescription = make_shared<Body::Description>();
+								bodyDescription->markerCount = markerCount;
+								bodyDescription->markerDiameter = 0.02f;
+								for (size_t i = 0; i < markerCount; i++) {
+									bodyDescription->markers.IDs.push_back((MarkerID)i);
+									bodyDescription->markers.positions.push_back(ofVec3f(random(-0.1, 0.1), random(-0.1, 0.1), random(-0.1, 0.1)));
+									bodyDescription->markers.colors.push_back(ofColor(255));
+								}
+
+								auto depth = random(2.5, 5.0);
+								cv::Vec3d axis = cv::normalize(cv::Vec3d(random(-1, 1), random(-1, 1), random(-1, 1)));
+								cv::Mat rotationVector = cv::Mat(axis * random(0, PI / 6.0));
+								cv::Mat translation = (cv::Mat_<double>(3, 1) << random(-0.5, 0.5) * depth, random(-0.3, 0.3) * depth, depth);
+								bodyDescription->rotationVector = rotationVector;
+								bodyDescription->translation = translation;
+								bodyDescription->modelTransform = ofxCv::makeMatrix(rotationVector, translation);
+								bodyDescriptions.push_back(bodyDescription);
+
+								//where the markers actually are this frame
+								auto motion = this->parameters.motion.get();
+								cv::Mat trueTranslation = translation + (cv::Mat_<double>(3, 1) << random(-motion, motion), random(-motion, motion), random(-motion, motion));
+								vector<cv::Point3f> objectPoints;
+								for (const auto & position : bodyDescription->markers.positions) {
+									objectPoints.push_back(ofxCv::toCv(position));
+								}
+								vector<cv::Point2f> imagePoints;
+								cv::projectPoints(objectPoints
+									, rotationVector
+									, trueTranslation
+									, cameraDescription->cameraMatrix
+									, cameraDescription->distortionCoefficients
+									, imagePoints);
+								for (size_t i = 0; i < markerCount; i++) {
+									auto imagePoint = imagePoints[i];
+									imagePoint.x += noiseDistribution(randomEngine);
+									imagePoint.y += noiseDistribution(randomEngine);
+									incomingFrame->centroids.push_back(imagePoint);
+									centroidTruth.emplace_back((int)bodyIndex, (MarkerID)i);
+								}
+							}
+
+							for (int i = 0; i < this->parameters.falseCentroids.get(); i++) {
+								incomingFrame->centroids.push_back(cv::Point2f(random(0, width), random(0, height)));
+								centroidTruth.emplace_back(-1, -1);
+							}
+
+							auto countMismatches = [&](size_t bodyIndex, const MatchMarkersFrame & matchMarkersFrame) {
+								size_t mismatches = 0;
+								const auto & matchResult = matchMarkersFrame.result;
+								for (size_t i = 0; i < matchResult.count; i++) {
+									const auto & truth = centroidTruth[matchResult.centroidIndex[i]];
+									if (truth.first != (int)bodyIndex || truth.second != matchResult.markerIDs[i]) {
+										mismatches++;
+									}
+								}
+								return mismatches;
+							};
+
+							//one chain per body (as if each chain had the CPU to itself)
+							{
+								auto timeStart = chrono::high_resolution_clock::now();
+								vector<shared_ptr<MatchMarkersFrame>> matchMarkersFrames;
+								vector<bool> tracked;
+								for (const auto & bodyDescription : bodyDescriptions) {
+									auto matchMarkersFrame = make_shared<MatchMarkersFrame>();
+									matchMarkersFrame->incomingFrame = incomingFrame;
+									matchMarkersFrame->bodyDescription = bodyDescription;
+									matchMarkersFrame->cameraDescription = cameraDescription;
+									matchMarkersFrame->distanceThresholdSquared = distanceThreshold * distanceThreshold;
+									MatchMarkers::searchVisibleMarkers(*matchMarkersFrame);
+									MatchMarkers::processModelViewTransform(matchMarkersFrame);
+
+									bool bodyTracked = false;
+									if (matchMarkersFrame->result.success) {
+										float reprojectionError;
+										bodyTracked = (bool)UpdateTracking::solve(matchMarkersFrame
+											, UpdateTarget::Body
+											, reprojectionThreshold
+											, reprojectionError);
+									}
+									matchMarkersFrames.push_back(matchMarkersFrame);
+									tracked.push_back(bodyTracked);
+								}
+								chrono::duration<float, micro> duration = chrono::high_resolution_clock::now() - timeStart;
+								perBodyDuration += duration.count();
+
+								for (size_t i = 0; i < bodyCount; i++) {
+									perBodyTracked += tracked[i] ? 1 : 0;
+									perBodyMismatches += countMismatches(i, *matchMarkersFrames[i]);
+								}
+							}
+
+							//one pass for all bodies
+							{
+								MultiBodyTrackingFrame frame;
+								frame.incomingFrame = incomingFrame;
+								frame.cameraDescription = cameraDescription;
+								for (const auto & bodyDescription : bodyDescriptions) {
+									auto matchMarkersFrame = make_shared<MatchMarkersFrame>();
+									matchMarkersFrame->bodyDescription = bodyDescription;
+									frame.matchMarkersFrames.push_back(matchMarkersFrame);
+								}
+
+								auto timeStart = chrono::high_resolution_clock::now();
+								MultiBodyTracking::process(frame, settings);
+								chrono::duration<float, micro> duration = chrono::high_resolution_clock::now() - timeStart;
+								multiBodyWallDuration += duration.count();
+								multiBodyDuration += (frame.matchDuration + frame.poseDuration) * 1000.0f;
+
+								for (size_t i = 0; i < bodyCount; i++) {
+									multiBodyTracked += frame.updateTrackingFrames[i] ? 1 : 0;
+									multiBodyMismatches += countMismatches(i, *frame.matchMarkersFrames[i]);
+								}
+							}
+						}
+
+						result.perBodyDuration = perBodyDuration / (float)trialCount;
+						result.multiBodyDuration = multiBodyDuration / (float)trialCount;
+						result.multiBodyWallDuration = multiBodyWallDuration / (float)trialCount;
+						result.perBodyTracked = (float)perBodyTracked / (float)(trialCount * bodyCount);
+						result.multiBodyTracked = (float)multiBodyTracked / (float)(trialCount * bodyCount);
+						result.perBodyMismatches = (float)perBodyMismatches / (float)trialCount;
+						result.multiBodyMismatches = (float)multiBodyMismatches / (float)trialCount;
+
+						ofLogNotice("MoCap::Test::BenchmarkMultiBodyTracking") << bodyCount << " bodies : "
+							<< result.perBodyDuration << "us per body chains, "
+							<< result.multiBodyDuration << "us multi body CPU ("
+							<< result.multiBodyWallDuration << "us wall), "
+							<< result.perBodyMismatches << " / " << result.multiBodyMismatches << " mismatches per frame";
+
+						results.push_back(result);
+					}
+
+					this->results = results;
+
+					scopedProcess.end();
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../MultiBodyTracking.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			namespace Test {
+				///Compares one MatchMarkers -> UpdateTracking chain per body against MultiBodyTracking
+				///for 1, 5, 10 and 20 synthetic bodies seen by one camera
+				class BenchmarkMultiBodyTracking : public Nodes::Test::Benchmark {
+				public:
+					BenchmarkMultiBodyTracking();
+					string getTypeName() const override;
+					void init();
+
+					void populateInspector(ofxCvGui::InspectArguments &);
+
+					void runBenchmark() override;
+					void serializeResult(Json::Value &) const override;
+				protected:
+					struct : ofParameterGroup {
+						ofParameter<int> trialCount{ "Trials", 500, 1, 100000 };
+						ofParameter<int> markerCount{ "Markers per body", 6, 4, 32 };
+						ofParameter<float> noise{ "Noise [px]", 0.3, 0.0, 10.0 };
+						ofParameter<int> falseCentroids{ "False centroids", 5, 0, 100 };
+						ofParameter<float> motion{ "Motion since last frame [m]", 0.01, 0.0, 0.1 };
+						ofParameter<float> distanceThreshold{ "Tracking distance threshold [px]", 20, 0, 300 };
+						ofParameter<int> threadCount{ "Pose threads", 4, 1, 16 };
+						PARAM_DECLARE("BenchmarkMultiBodyTracking", trialCount, markerCount, noise, falseCentroids, motion, distanceThreshold, threadCount);
+					} parameters;
+
+					struct Result {
+						int bodyCount = 0;
+						float perBodyDuration = 0.0f; // us CPU per frame, all chains
+						float multiBodyDuration = 0.0f; // us CPU per frame, all threads
+						float multiBodyWallDuration = 0.0f; // us per frame
+						float perBodyTracked = 0.0f; // fraction of bodies
+						float multiBodyTracked = 0.0f; // fraction of bodies
+						float perBodyMismatches = 0.0f; // wrong centroid assignments per frame
+						float multiBodyMismatches = 0.0f; // wrong centroid assignments per frame
+					};
+					vector<Result> results;
+				};
+			}
+		}
+	}
+}
@@ -0,0 +1,210 @@
+#include "pch_Plugin_MoCap.h"
+#include "BenchmarkMultiViewSolve.h"
+
+#include <random>
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			namespace Test {
+				//----------
+				BenchmarkMultiViewSolve::BenchmarkMultiViewSolve() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string BenchmarkMultiViewSolve::getTypeName() const {
+					return "MoCap::Test::BenchmarkMultiViewSolve";
+				}
+
+				//----------
+				void BenchmarkMultiViewSolve::init() {
+					RULR_NODE_INSPECTOR_LISTENER;
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void BenchmarkMultiViewSolve::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					for (size_t i = 0; i < this->results.size(); i++) {
+						const auto & result = this->results[i];
+						inspector->addTitle(ofToString(result.cameraCount) + " cameras", ofxCvGui::Widgets::Title::Level::H3);
+						inspector->addLiveValue<string>("Solved", [this, i]() {
+							return ofToString(this->results[i].solvedCount) + " / " + ofToString(this->parameters.trialCount.get());
+						});
+						inspector->addLiveValue<float>("Mean solve time [us]", [this, i]() {
+							return this->results[i].meanDuration;
+						});
+						inspector->addLiveValue<float>("Max solve time [us]", [this, i]() {
+							return this->results[i].maxDuration;
+						});
+						inspector->addLiveValue<float>("Mean iterations", [this, i]() {
+							return this->results[i].meanIterations;
+						});
+						inspector->addLiveValue<float>("Mean position error [mm]", [this, i]() {
+							return this->results[i].meanPositionError;
+						});
+						inspector->addLiveValue<float>("Mean rotation error [deg]", [this, i]() {
+							return this->results[i].meanRotationError;
+						});
+					}
+				}
+
+				//----------
+				void BenchmarkMultiViewSolve::serializeResult(Json::Value & json) const {
+					for (const auto & result : this->results) {
+						Json::Value jsonResult;
+						jsonResult["cameraCount"] = result.cameraCount;
+						jsonResult["solvedCount"] = result.solvedCount;
+						jsonResult["meanDuration"] = result.meanDuration;
+						jsonResult["maxDuration"] = result.maxDuration;
+						jsonResult["meanIterations"] = result.meanIterations;
+						jsonResult["meanPositionError"] = result.meanPositionError;
+						jsonResult["meanRotationError"] = result.meanRotationError;
+						json["results"].append(jsonResult);
+					}
+				}
+
+				//----------
+				void BenchmarkMultiViewSolve::runBenchmark() {
+					const auto trialCount = (size_t) this->parameters.trialCount.get();
+					const auto markerCount = (size_t) this->parameters.markerCount.get();
+					const auto cameraDistance = (double) this->parameters.cameraDistance.get();
+
+					Utils::ScopedProcess scopedProcess("Benchmark multi-view solve", false);
+
+					//deterministic scene
+					mt19937 randomEngine(0);
+					uniform_real_distribution<double> unitDistribution(0.0, 1.0);
+					normal_distribution<double> noiseDistribution(0.0, max(this->parameters.noise.get(), 1e-6f));
+					auto random = [&](double minimum, double maximum) {
+						return minimum + (maximum - minimum) * unitDistribution(randomEngine);
+					};
+
+					const cv::Mat cameraMatrix = (cv::Mat_<double>(3, 3) << 1000, 0, 640, 0, 1000, 360, 0, 0, 1);
+					const cv::Mat distortionCoefficients = cv::Mat::zeros(5, 1, CV_64F);
+
+					MultiViewSolvePnP::Settings settings;
+					settings.huberThreshold = this->parameters.huberThreshold.get();
+
+					vector<Result> results;
+					for (size_t cameraCount : { 2, 4, 8 }) {
+						//ring of cameras at head height, all looking at the origin
+						vector<MultiViewSolvePnP::View> views(cameraCount);
+						for (size_t i = 0; i < cameraCount; i++) {
+							auto angle = (double)i / (double)cameraCount * TWO_PI;
+							cv::Vec3d position(cos(angle) * cameraDistance, -1.5, sin(angle) * cameraDistance);
+
+							cv::Vec3d zAxis = cv::normalize(-position);
+							cv::Vec3d xAxis = cv::normalize(cv::Vec3d(0, -1, 0).cross(zAxis));
+							cv::Vec3d yAxis = zAxis.cross(xAxis);
+							cv::Matx33d rotation(xAxis[0], xAxis[1], xAxis[2]
+								, yAxis[0], yAxis[1], yAxis[2]
+								, zAxis[0], zAxis[1], zAxis[2]);
+
+							auto & view = views[i];
+							view.cameraMatrix = cameraMatrix;
+							view.distortionCoefficients = distortionCoefficients;
+							cv::Rodrigues(cv::Mat(rotation), view.rotationVector);
+							view.translation = cv::Mat(-(rotation * position));
+						}
+
+						Result result;
+						result.cameraCount = (int)cameraCount;
+
+						float accumulatedDuration = 0.0f;
+						float accumulatedIterations = 0.0f;
+						float accumulatedPositionError = 0.0f;
+						float accumulatedRotationError = 0.0f;
+
+						for (size_t trial = 0; trial < trialCount; trial++) {
+							//random body
+							vector<cv::Point3f> objectPoints(markerCount);
+							for (auto & objectPoint : objectPoints) {
+								objectPoint = cv::Point3f(random(-0.15, 0.15), random(-0.15, 0.15), random(-0.15, 0.15));
+							}
+
+							cv::Vec3d axis = cv::normalize(cv::Vec3d(random(-1, 1), random(-1, 1), random(-1, 1)));
+							cv::Mat trueRotationVector = cv::Mat(axis * random(0, PI));
+							cv::Mat trueTranslation = (cv::Mat_<double>(3, 1) << random(-0.5, 0.5), random(-0.5, 0.5), random(-0.5, 0.5));
+							cv::Mat trueRotation;
+							cv::Rodrigues(trueRotationVector, trueRotation);
+
+							vector<cv::Point3f> worldPoints;
+							cv::transform(objectPoints, worldPoints, cv::Matx34d(trueRotation.at<double>(0, 0), trueRotation.at<double>(0, 1), trueRotation.at<double>(0, 2), trueTranslation.at<double>(0)
+								, trueRotation.at<double>(1, 0), trueRotation.at<double>(1, 1), trueRotation.at<double>(1, 2), trueTranslation.at<double>(1)
+								, trueRotation.at<double>(2, 0), trueRotation.at<double>(2, 1), trueRotation.at<double>(2, 2), trueTranslation.at<double>(2)));
+
+							//observe it from each camera
+							for (auto & view : views) {
+								vector<cv::Point2f> projectedPoints;
+								cv::projectPoints(worldPoints, view.rotationVector, view.translation, view.cameraMatrix, view.distortionCoefficients, projectedPoints);
+
+								view.imagePoints.clear();
+								view.objectPoints.clear();
+								for (size_t j = 0; j < markerCount; j++) {
+									if (unitDistribution(randomEngine) > this->parameters.visibility) {
+										continue;
+									}
+									auto imagePoint = projectedPoints[j];
+									imagePoint.x += noiseDistribution(randomEngine);
+									imagePoint.y += noiseDistribution(randomEngine);
+									if (unitDistribution(randomEngine) < this->parameters.outlierRate) {
+										imagePoint.x += random(20, 50) * (unitDistribution(randomEngine) > 0.5 ? 1 : -1);
+										imagePoint.y += random(20, 50) * (unitDistribution(randomEngine) > 0.5 ? 1 : -1);
+									}
+									view.imagePoints.push_back(imagePoint);
+									view.objectPoints.push_back(objectPoints[j]);
+								}
+							}
+
+							//solve from cold
+							cv::Mat rotationVector, translation;
+							auto timeStart = chrono::high_resolution_clock::now();
+							auto solveResult = MultiViewSolvePnP::solve(views, rotationVector, translation, false, settings);
+							chrono::duration<float, micro> duration = chrono::high_resolution_clock::now() - timeStart;
+
+							accumulatedDuration += duration.count();
+							result.maxDuration = max(result.maxDuration, duration.count());
+							if (!solveResult.success) {
+								continue;
+							}
+							result.solvedCount++;
+							accumulatedIterations += (float)solveResult.iterations;
+
+							//score against ground truth
+							accumulatedPositionError += (float)cv::norm(translation - trueTranslation) * 1000.0f;
+
+							cv::Mat rotation, rotationError;
+							cv::Rodrigues(rotationVector, rotation);
+							cv::Rodrigues(rotation * trueRotation.t(), rotationError);
+							accumulatedRotationError += (float)cv::norm(rotationError) * RAD_TO_DEG;
+						}
+
+						result.meanDuration = accumulatedDuration / (float)trialCount;
+						if (result.solvedCount > 0) {
+							result.meanIterations = accumulatedIterations / (float)result.solvedCount;
+							result.meanPositionError = accumulatedPositionError / (float)result.solvedCount;
+							result.meanRotationError = accumulatedRotationError / (float)result.solvedCount;
+						}
+
+						ofLogNotice("MoCap::Test::BenchmarkMultiViewSolve") << cameraCount << " cameras : "
+							<< result.meanDuration << "us mean, "
+							<< result.maxDuration << "us max, "
+							<< result.meanPositionError << "mm, "
+							<< result.meanRotationError << "deg mean error";
+
+						results.push_back(result);
+					}
+
+					this->results = results;
+
+					scopedProcess.end();
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../MultiViewSolvePnP.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			namespace Test {
+				///Runs MultiViewSolvePnP against a synthetic body seen by a ring of 2, 4 and 8 cameras
+				class BenchmarkMultiViewSolve : public Nodes::Test::Benchmark {
+				public:
+					BenchmarkMultiViewSolve();
+					string getTypeName() const override;
+					void init();
+
+					void populateInspector(ofxCvGui::InspectArguments &);
+
+					void runBenchmark() override;
+					void serializeResult(Json::Value &) const override;
+				protected:
+					struct : ofParameterGroup {
+						ofParameter<int> trialCount{ "Trials", 1000, 1, 100000 };
+						ofParameter<int> markerCount{ "Markers", 8, 4, 64 };
+						ofParameter<float> visibility{ "Visibility", 0.8, 0.1, 1.0 };
+						ofParameter<float> noise{ "Noise [px]", 0.3, 0.0, 10.0 };
+						ofParameter<float> outlierRate{ "Outlier rate", 0.02, 0.0, 0.5 };
+						ofParameter<float> cameraDistance{ "Camera distance [m]", 4.0, 0.5, 20.0 };
+						ofParameter<float> huberThreshold{ "Huber threshold [px]", 2, 0.1, 100 };
+						PARAM_DECLARE("BenchmarkMultiViewSolve", trialCount, markerCount, visibility, noise, outlierRate, cameraDistance, huberThreshold);
+					} parameters;
+
+					struct Result {
+						int cameraCount = 0;
+						int solvedCount = 0;
+						float meanDuration = 0.0f; // us
+						float maxDuration = 0.0f; // us
+						float meanIterations = 0.0f;
+						float meanPositionError = 0.0f; // mm
+						float meanRotationError = 0.0f; // degrees
+					};
+					vector<Result> results;
+				};
+			}
+		}
+	}
+}
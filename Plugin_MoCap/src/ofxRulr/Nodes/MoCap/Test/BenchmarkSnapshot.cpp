@@ -0,0 +1,282 @@
+#include "pch_Plugin_MoCap.h"
+#include "BenchmarkSnapshot.h"
+
+#include <random>
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			namespace Test {
+				namespace {
+					typedef chrono::high_resolution_clock Clock;
+					typedef Utils::Snapshot<Body::Description>::Version Version;
+
+					//applied to the median read time measured without other threads running
+					const float ContendedReadFactor = 4.0f;
+					const float ContendedReadMinimum = 1.0f; // us, below this we're measuring the clock
+
+					//----------
+					void lockCounted(mutex & mutex, atomic<size_t> & lockWaits) {
+						if (!mutex.try_lock()) {
+							lockWaits++;
+							mutex.lock();
+						}
+					}
+				}
+
+				//----------
+				BenchmarkSnapshot::BenchmarkSnapshot() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string BenchmarkSnapshot::getTypeName() const {
+					return "MoCap::Test::BenchmarkSnapshot";
+				}
+
+				//----------
+				void BenchmarkSnapshot::init() {
+					RULR_NODE_INSPECTOR_LISTENER;
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void BenchmarkSnapshot::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					for (size_t i = 0; i < this->results.size(); i++) {
+						inspector->addTitle(this->results[i].name, ofxCvGui::Widgets::Title::Level::H3);
+						inspector->addLiveValue<string>("Reads / edits", [this, i]() {
+							return ofToString(this->results[i].reads) + " / " + ofToString(this->results[i].publishes);
+						});
+						inspector->addLiveValue<string>("Lock free", [this, i]() {
+							return this->results[i].lockFree ? string("Yes") : string("No");
+						});
+						inspector->addLiveValue<size_t>("Mutex waits", [this, i]() {
+							return this->results[i].lockWaits;
+						});
+						inspector->addLiveValue<size_t>("Contended reads", [this, i]() {
+							return this->results[i].contendedReads;
+						});
+						inspector->addLiveValue<float>("Mean read [us]", [this, i]() {
+							return this->results[i].meanReadDuration;
+						});
+						inspector->addLiveValue<float>("99th percentile read [us]", [this, i]() {
+							return this->results[i].percentile99ReadDuration;
+						});
+						inspector->addLiveValue<float>("Max read [us]", [this, i]() {
+							return this->results[i].maxReadDuration;
+						});
+						inspector->addLiveValue<size_t>("Versions seen", [this, i]() {
+							return this->results[i].versionsSeen;
+						});
+					}
+				}
+
+				//----------
+				void BenchmarkSnapshot::serializeResult(Json::Value & json) const {
+					for (const auto & result : this->results) {
+						Json::Value jsonResult;
+						jsonResult["name"] = result.name;
+						jsonResult["reads"] = (Json::UInt64) result.reads;
+						jsonResult["publishes"] = (Json::UInt64) result.publishes;
+						jsonResult["lockWaits"] = (Json::UInt64) result.lockWaits;
+						jsonResult["contendedReads"] = (Json::UInt64) result.contendedReads;
+						jsonResult["lockFree"] = result.lockFree;
+						jsonResult["meanReadDuration"] = result.meanReadDuration;
+						jsonResult["percentile99ReadDuration"] = result.percentile99ReadDuration;
+						jsonResult["maxReadDuration"] = result.maxReadDuration;
+						jsonResult["versionsSeen"] = (Json::UInt64) result.versionsSeen;
+						json["results"].append(jsonResult);
+					}
+				}
+
+				//----------
+				void BenchmarkSnapshot::runBenchmark() {
+					const auto duration = chrono::duration_cast<Clock::duration>(chrono::duration<float>(this->parameters.duration.get()));
+					const auto readerThreadCount = (size_t) this->parameters.readerThreads.get();
+					const auto readerPeriod = chrono::duration_cast<Clock::duration>(chrono::duration<float>(1.0f / this->parameters.readerRate.get()));
+					const auto publishPeriod = chrono::duration_cast<Clock::duration>(chrono::duration<float>(1.0f / this->parameters.publishRate.get()));
+					const auto markerCount = (size_t) this->parameters.markerCount.get();
+
+					Utils::ScopedProcess scopedProcess("Benchmark snapshot", false);
+
+					//what Body::update does on every edit
+					mt19937 randomEngine(0);
+					uniform_real_distribution<float> distribution(-0.1f, 0.1f);
+					auto makeDescription = [&]() {
+						auto description = make_shared<Body::Description>();
+						for (size_t i = 0; i < markerCount; i++) {
+							description->markers.IDs.push_back((MarkerID)i);
+							description->markers.positions.push_back(ofVec3f(distribution(randomEngine), distribution(randomEngine), distribution(randomEngine)));
+							description->markers.colors.push_back(ofColor(255));
+						}
+						description->markerCount = markerCount;
+						description->markerDiameter = 0.02f;
+						description->modelTransform = ofMatrix4x4::newTranslationMatrix(distribution(randomEngine), 0, 0);
+						ofxCv::decomposeMatrix(description->modelTransform
+							, description->rotationVector
+							, description->translation);
+						return description;
+					};
+
+					//publish(description) and read(version) -> description are given by each method
+					auto run = [&](const string & name
+						, function<void(shared_ptr<Body::Description>)> publish
+						, function<shared_ptr<Body::Description>(Version &)> read
+						, atomic<size_t> & lockWaits
+						, bool lockFree) {
+						Result result;
+						result.name = name;
+						result.lockFree = lockFree;
+
+						publish(makeDescription());
+
+						//time reads with nothing else running, to tell when a read has been held up by another thread
+						float contendedReadThreshold;
+						{
+							vector<float> uncontendedReadDurations;
+							for (int i = 0; i < 1000; i++) {
+								auto readStart = Clock::now();
+								Version version;
+								read(version);
+								chrono::duration<float, micro> readDuration = Clock::now() - readStart;
+								uncontendedReadDurations.push_back(readDuration.count());
+							}
+							auto median = uncontendedReadDurations.begin() + uncontendedReadDurations.size() / 2;
+							nth_element(uncontendedReadDurations.begin(), median, uncontendedReadDurations.end());
+							contendedReadThreshold = max(*median * ContendedReadFactor, ContendedReadMinimum);
+						}
+						lockWaits.store(0);
+
+						const auto startTime = Clock::now();
+						const auto endTime = startTime + duration;
+
+						vector<vector<float>> readDurations(readerThreadCount);
+						vector<size_t> versionsSeen(readerThreadCount, 0);
+						vector<thread> readerThreads;
+						for (size_t threadIndex = 0; threadIndex < readerThreadCount; threadIndex++) {
+							readerThreads.emplace_back([&, threadIndex]() {
+								auto nextTime = startTime;
+								Version lastVersion = 0;
+								size_t markerCountCheck = 0;
+								while (nextTime < endTime) {
+									this_thread::sleep_until(nextTime);
+									nextTime += readerPeriod;
+
+									auto readStart = Clock::now();
+									Version version;
+									auto description = read(version);
+									chrono::duration<float, micro> readDuration = Clock::now() - readStart;
+									readDurations[threadIndex].push_back(readDuration.count());
+
+									//use it a little, as a pipeline stage would
+									if (description) {
+										markerCountCheck += description->markerCount;
+									}
+									if (version != lastVersion) {
+										versionsSeen[threadIndex]++;
+										lastVersion = version;
+									}
+								}
+							});
+						}
+
+						//the main thread editing the body
+						{
+							auto nextTime = startTime;
+							while (nextTime < endTime) {
+								this_thread::sleep_until(nextTime);
+								nextTime += publishPeriod;
+								publish(makeDescription());
+								result.publishes++;
+							}
+						}
+
+						for (auto & readerThread : readerThreads) {
+							readerThread.join();
+						}
+
+						vector<float> allReadDurations;
+						for (const auto & threadReadDurations : readDurations) {
+							allReadDurations.insert(allReadDurations.end(), threadReadDurations.begin(), threadReadDurations.end());
+						}
+						sort(allReadDurations.begin(), allReadDurations.end());
+
+						result.reads = allReadDurations.size();
+						result.lockWaits = lockWaits.load();
+						result.contendedReads = (size_t) (allReadDurations.end() - upper_bound(allReadDurations.begin(), allReadDurations.end(), contendedReadThreshold));
+						result.versionsSeen = versionsSeen.front();
+						if (!allReadDurations.empty()) {
+							result.meanReadDuration = accumulate(allReadDurations.begin(), allReadDurations.end(), 0.0f) / (float)allReadDurations.size();
+							result.percentile99ReadDuration = allReadDurations[(size_t)(0.99f * (float)(allReadDurations.size() - 1))];
+							result.maxReadDuration = allReadDurations.back();
+						}
+
+						ofLogNotice("MoCap::Test::BenchmarkSnapshot") << name << " : "
+							<< result.reads << " reads, "
+							<< result.publishes << " edits, "
+							<< result.lockWaits << " mutex waits, "
+							<< result.contendedReads << " contended reads, "
+							<< result.meanReadDuration << "us mean, "
+							<< result.percentile99ReadDuration << "us p99, "
+							<< result.maxReadDuration << "us max read";
+
+						return result;
+					};
+
+					vector<Result> results;
+
+					//the hand-over as it was : a mutex around the shared description
+					{
+						mutex descriptionMutex;
+						shared_ptr<Body::Description> description;
+						Version version = 0;
+						atomic<size_t> lockWaits{ 0 };
+
+						results.push_back(run("Mutex"
+							, [&](shared_ptr<Body::Description> newDescription) {
+								lockCounted(descriptionMutex, lockWaits);
+								description = newDescription;
+								version++;
+								descriptionMutex.unlock();
+							}
+							, [&](Version & readVersion) {
+								lockCounted(descriptionMutex, lockWaits);
+								auto readDescription = description;
+								readVersion = version;
+								descriptionMutex.unlock();
+								return readDescription;
+							}
+							, lockWaits
+							, false));
+					}
+
+					//Utils::Snapshot, as used by Body, MatchMarkers, UpdateTracking and MultiBodyTracking
+					{
+						Utils::Snapshot<Body::Description> snapshot;
+						atomic<size_t> lockWaits{ 0 }; // no mutex, its internal lock shows up in the contended reads
+
+						results.push_back(run("Snapshot"
+							, [&](shared_ptr<Body::Description> newDescription) {
+								snapshot.publish(newDescription);
+							}
+							, [&](Version & readVersion) {
+								auto entry = snapshot.get();
+								readVersion = entry.version;
+								return entry.value;
+							}
+							, lockWaits
+							, snapshot.isLockFree()));
+					}
+
+					this->results = results;
+
+					scopedProcess.end();
+				}
+			}
+		}
+	}
+}
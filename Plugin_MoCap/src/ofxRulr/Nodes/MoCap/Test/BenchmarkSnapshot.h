@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../Body.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			namespace Test {
+				///Pipeline threads taking the Body description whilst the main thread keeps editing the body.
+				///Compares the mutex guarded hand-over against Utils::Snapshot.
+				class BenchmarkSnapshot : public Nodes::Test::Benchmark {
+				public:
+					BenchmarkSnapshot();
+					string getTypeName() const override;
+					void init();
+
+					void populateInspector(ofxCvGui::InspectArguments &);
+
+					void runBenchmark() override;
+					void serializeResult(Json::Value &) const override;
+				protected:
+					struct : ofParameterGroup {
+						ofParameter<float> duration{ "Duration [s]", 5, 0.1, 60 };
+						ofParameter<int> readerThreads{ "Pipeline threads", 4, 1, 32 };
+						ofParameter<float> readerRate{ "Frame rate [fps]", 500, 1, 10000 };
+						ofParameter<float> publishRate{ "Edit rate [Hz]", 1000, 1, 100000 };
+						ofParameter<int> markerCount{ "Markers", 32, 1, 1000 };
+						PARAM_DECLARE("BenchmarkSnapshot", duration, readerThreads, readerRate, publishRate, markerCount);
+					} parameters;
+
+					struct Result {
+						string name;
+						size_t reads = 0;
+						size_t publishes = 0;
+						size_t lockWaits = 0; // reads or publishes which found the mutex taken (mutex only)
+						size_t contendedReads = 0; // reads which took longer than ContendedReadFactor x an uncontended read
+						bool lockFree = false;
+						float meanReadDuration = 0.0f; // us
+						float percentile99ReadDuration = 0.0f; // us
+						float maxReadDuration = 0.0f; // us
+						size_t versionsSeen = 0; // distinct versions seen by the first thread
+					};
+					vector<Result> results;
+				};
+			}
+		}
+	}
+}
@@ -22,13 +22,33 @@ namespace ofxRulr {
 				RULR_NODE_UPDATE_LISTENER;
 				RULR_NODE_INSPECTOR_LISTENER;
 
-				this->addInput<Item::RigidBody>();
+				auto input = this->addInput<Item::RigidBody>();
+				input->onNewConnection += [this](shared_ptr<Item::RigidBody> rigidBodyNode) {
+					auto lock = unique_lock<mutex>(this->poseSampleTargetMutex);
+					this->poseSampleTarget = rigidBodyNode;
+				};
+				input->onDeleteConnection += [this](shared_ptr<Item::RigidBody>) {
+					auto lock = unique_lock<mutex>(this->poseSampleTargetMutex);
+					this->poseSampleTarget.reset();
+				};
 
 				this->manageParameters(this->parameters);
 			}
 
 			//----------
 			void UpdateTracking::update() {
+				{
+					auto settings = this->settings.getValue();
+					if (!settings
+						|| settings->updateTarget != this->parameters.updateTarget.get().get()
+						|| settings->reprojectionThreshold != this->parameters.reprojectionThreshold.get()) {
+						auto newSettings = make_shared<Settings>();
+						newSettings->updateTarget = this->parameters.updateTarget.get();
+						newSettings->reprojectionThreshold = this->parameters.reprojectionThreshold.get();
+						this->settings.publish(newSettings);
+					}
+				}
+
 				{
 					auto rigidBodyNode = this->getInput<Item::RigidBody>();
 					if (rigidBodyNode) {
@@ -57,11 +77,49 @@ namespace ofxRulr {
 					//do nothing
 					return;
 				}
-				
+
+				auto settings = this->settings.getValue();
+				if (!settings) {
+					//not yet published by the main thread
+					return;
+				}
+
+				float reprojectionError;
+				auto outgoingFrame = UpdateTracking::solve(incomingFrame
+					, settings->updateTarget
+					, settings->reprojectionThreshold
+					, reprojectionError);
+				this->reprojectionError.store(reprojectionError);
+				if (!outgoingFrame) {
+					//reprojection error is too high
+					return;
+				}
+
+				//announce the pose now rather than waiting for the main thread (e.g. for DMX::AimMovingHeadAt)
+				{
+					shared_ptr<Item::RigidBody> poseSampleTarget;
+					{
+						auto lock = unique_lock<mutex>(this->poseSampleTargetMutex);
+						poseSampleTarget = this->poseSampleTarget.lock();
+					}
+					if (poseSampleTarget) {
+						poseSampleTarget->notifyPoseSample(outgoingFrame->transform, incomingFrame->incomingFrame->captureTime);
+					}
+				}
+
+				this->onNewFrame.notifyListeners(outgoingFrame);
+				this->trackingUpdateToMainThread.send(outgoingFrame);
+			}
+
+			//----------
+			shared_ptr<UpdateTrackingFrame> UpdateTracking::solve(shared_ptr<MatchMarkersFrame> incomingFrame
+				, UpdateTarget updateTarget
+				, float reprojectionThreshold
+				, float & reprojectionError) {
 				//construct output
 				auto outgoingFrame = make_shared<UpdateTrackingFrame>();
 				outgoingFrame->incomingFrame = incomingFrame;
-				outgoingFrame->updateTarget = this->parameters.updateTarget;
+				outgoingFrame->updateTarget = updateTarget;
 				outgoingFrame->bodyModelViewRotationVector = incomingFrame->modelViewRotationVector;
 				outgoingFrame->bodyModelViewTranslation = incomingFrame->modelViewTranslation;
 				
@@ -93,12 +151,10 @@ namespace ofxRulr {
 						const auto delta = outgoingFrame->reprojectedAfterTracking[i] - incomingFrame->result.centroids[i];
 						sumErrorSquared += delta.dot(delta);
 					}
-					auto reprojectionError = sqrt(sumErrorSquared);
-					this->reprojectionError.store(reprojectionError);
-					auto reprojectionThreshold = this->parameters.reprojectionThreshold.get();
+					reprojectionError = sqrt(sumErrorSquared);
 					if (reprojectionError > reprojectionThreshold && !incomingFrame->result.forceTakeTransform) {
 						//reprojection error is too high
-						return;
+						return nullptr;
 					}
 				}
 
@@ -139,8 +195,7 @@ namespace ofxRulr {
 						break;
 				}
 
-				this->onNewFrame.notifyListeners(outgoingFrame);
-				this->trackingUpdateToMainThread.send(outgoingFrame);
+				return outgoingFrame;
 			}
 		}
 	}
@@ -35,7 +35,18 @@ namespace ofxRulr {
 				void init();
 				void update();
 				void populateInspector(ofxCvGui::InspectArguments &);
+
+				///Solve the pose from a successful match. Returns nullptr if the reprojection error is above threshold.
+				static shared_ptr<UpdateTrackingFrame> solve(shared_ptr<MatchMarkersFrame>
+					, UpdateTarget
+					, float reprojectionThreshold
+					, float & reprojectionError);
 			protected:
+				struct Settings {
+					UpdateTarget updateTarget;
+					float reprojectionThreshold;
+				};
+
 				void processFrame(shared_ptr<MatchMarkersFrame> incomingFrame) override;
 
 				struct : ofParameterGroup {
@@ -44,7 +55,14 @@ namespace ofxRulr {
 					PARAM_DECLARE("UpdateTracking", updateTarget, reprojectionThreshold);
 				} parameters;
 
+				//published on the main thread, taken by processFrame without locking
+				Utils::Snapshot<Settings> settings;
+
 				ofThreadChannel<shared_ptr<UpdateTrackingFrame>> trackingUpdateToMainThread;
+
+				//for announcing timestamped poses directly from the processing thread
+				weak_ptr<Item::RigidBody> poseSampleTarget;
+				mutex poseSampleTargetMutex;
 				atomic<float> reprojectionError;
 			};
 		}
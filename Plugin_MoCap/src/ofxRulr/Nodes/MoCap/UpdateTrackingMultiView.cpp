@@ -0,0 +1,155 @@
+#include "pch_Plugin_MoCap.h"
+#include "UpdateTrackingMultiView.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			//----------
+			UpdateTrackingMultiView::UpdateTrackingMultiView() {
+				RULR_NODE_INIT_LISTENER;
+			}
+
+			//----------
+			string UpdateTrackingMultiView::getTypeName() const {
+				return "MoCap::UpdateTrackingMultiView";
+			}
+
+			//----------
+			void UpdateTrackingMultiView::init() {
+				RULR_NODE_UPDATE_LISTENER;
+				RULR_NODE_INSPECTOR_LISTENER;
+
+				auto input = this->addInput<Item::RigidBody>();
+				input->onNewConnection += [this](shared_ptr<Item::RigidBody> rigidBodyNode) {
+					auto lock = unique_lock<mutex>(this->poseSampleTargetMutex);
+					this->poseSampleTarget = rigidBodyNode;
+				};
+				input->onDeleteConnection += [this](shared_ptr<Item::RigidBody>) {
+					auto lock = unique_lock<mutex>(this->poseSampleTargetMutex);
+					this->poseSampleTarget.reset();
+				};
+
+				this->manageParameters(this->parameters);
+			}
+
+			//----------
+			void UpdateTrackingMultiView::update() {
+				auto rigidBodyNode = this->getInput<Item::RigidBody>();
+				if (rigidBodyNode) {
+					shared_ptr<UpdateTrackingFrame> updateTrackingFrame;
+					while (this->trackingUpdateToMainThread.tryReceive(updateTrackingFrame)) {}
+
+					if (updateTrackingFrame) {
+						rigidBodyNode->setTransform(updateTrackingFrame->transform);
+					}
+				}
+			}
+
+			//----------
+			void UpdateTrackingMultiView::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+				auto inspector = inspectArgs.inspector;
+				inspector->addLiveValueHistory("Reprojection error [px]", [this]() {
+					return this->reprojectionError.load();
+				});
+				inspector->addLiveValue<int>("Views", [this]() {
+					return this->viewCount.load();
+				});
+				inspector->addLiveValue<int>("Iterations", [this]() {
+					return this->iterations.load();
+				});
+				inspector->addLiveValue<int>("Outliers", [this]() {
+					return this->outlierCount.load();
+				});
+			}
+
+			//----------
+			void UpdateTrackingMultiView::processFrame(shared_ptr<SynchronisedFrames> incomingFrame) {
+				//gather the views
+				vector<MultiViewSolvePnP::View> views;
+				shared_ptr<MatchMarkersFrame> firstFrame;
+				for (const auto & frame : incomingFrame->frames) {
+					if (!frame || !frame->cameraDescription || frame->result.count == 0) {
+						continue;
+					}
+					if (!firstFrame) {
+						firstFrame = frame;
+					}
+
+					MultiViewSolvePnP::View view;
+					view.cameraMatrix = frame->cameraDescription->cameraMatrix;
+					view.distortionCoefficients = frame->cameraDescription->distortionCoefficients;
+					view.rotationVector = frame->cameraDescription->inverseRotationVector;
+					view.translation = frame->cameraDescription->inverseTranslation;
+					view.imagePoints = frame->result.centroids;
+					view.objectPoints = frame->result.objectSpacePoints;
+					views.push_back(move(view));
+				}
+				if (views.empty()) {
+					return;
+				}
+
+				//solve
+				cv::Mat rotationVector, translation;
+				bool useExtrinsicGuess = false;
+				if (this->parameters.useLastPose) {
+					auto lock = unique_lock<mutex>(this->lastPoseMutex);
+					if (this->lastPose.valid) {
+						rotationVector = this->lastPose.rotationVector.clone();
+						translation = this->lastPose.translation.clone();
+						useExtrinsicGuess = true;
+					}
+				}
+
+				MultiViewSolvePnP::Settings settings;
+				settings.huberThreshold = this->parameters.huberThreshold.get();
+				settings.maximumIterations = (size_t) this->parameters.maximumIterations.get();
+
+				auto result = MultiViewSolvePnP::solve(views
+					, rotationVector
+					, translation
+					, useExtrinsicGuess
+					, settings);
+
+				this->reprojectionError.store(result.reprojectionError);
+				this->viewCount.store((int)result.viewCount);
+				this->iterations.store((int)result.iterations);
+				this->outlierCount.store((int)result.outlierCount);
+
+				//ignore if reprojection error is too high (and don't use it as a guess next time)
+				{
+					auto lock = unique_lock<mutex>(this->lastPoseMutex);
+					if (!result.success || result.reprojectionError > this->parameters.reprojectionThreshold.get()) {
+						this->lastPose.valid = false;
+						return;
+					}
+					this->lastPose.rotationVector = rotationVector;
+					this->lastPose.translation = translation;
+					this->lastPose.valid = true;
+				}
+
+				//construct output
+				auto outgoingFrame = make_shared<UpdateTrackingFrame>();
+				outgoingFrame->incomingFrame = firstFrame;
+				outgoingFrame->updateTarget = UpdateTarget::Body;
+				outgoingFrame->modelRotationVector = rotationVector;
+				outgoingFrame->modelTranslation = translation;
+				outgoingFrame->transform = ofxCv::makeMatrix(rotationVector, translation);
+
+				//announce the pose now rather than waiting for the main thread
+				{
+					shared_ptr<Item::RigidBody> poseSampleTarget;
+					{
+						auto lock = unique_lock<mutex>(this->poseSampleTargetMutex);
+						poseSampleTarget = this->poseSampleTarget.lock();
+					}
+					if (poseSampleTarget) {
+						poseSampleTarget->notifyPoseSample(outgoingFrame->transform, firstFrame->incomingFrame->captureTime);
+					}
+				}
+
+				this->onNewFrame.notifyListeners(outgoingFrame);
+				this->trackingUpdateToMainThread.send(outgoingFrame);
+			}
+		}
+	}
+}
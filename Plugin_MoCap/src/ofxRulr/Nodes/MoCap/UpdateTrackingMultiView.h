@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ThreadedProcessNode.h"
+#include "SynchroniseFrames.h"
+#include "UpdateTracking.h"
+#include "MultiViewSolvePnP.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MoCap {
+			///Solves the body pose jointly from every camera in a synchronised set
+			class UpdateTrackingMultiView : public ThreadedProcessNode<SynchroniseFrames
+				, SynchronisedFrames
+				, UpdateTrackingFrame> {
+			public:
+				UpdateTrackingMultiView();
+				string getTypeName() const override;
+				void init();
+				void update();
+				void populateInspector(ofxCvGui::InspectArguments &);
+			protected:
+				void processFrame(shared_ptr<SynchronisedFrames> incomingFrame) override;
+
+				struct : ofParameterGroup {
+					ofParameter<float> huberThreshold{ "Huber threshold [px]", 2, 0.1, 100 };
+					ofParameter<int> maximumIterations{ "Maximum iterations", 20, 1, 100 };
+					ofParameter<float> reprojectionThreshold{ "Reprojection threshold [px]", 5 };
+					ofParameter<bool> useLastPose{ "Use last pose as guess", true };
+					PARAM_DECLARE("UpdateTrackingMultiView", huberThreshold, maximumIterations, reprojectionThreshold, useLastPose);
+				} parameters;
+
+				ofThreadChannel<shared_ptr<UpdateTrackingFrame>> trackingUpdateToMainThread;
+
+				struct {
+					cv::Mat rotationVector;
+					cv::Mat translation;
+					bool valid = false;
+				} lastPose;
+				mutex lastPoseMutex;
+
+				weak_ptr<Item::RigidBody> poseSampleTarget;
+				mutex poseSampleTargetMutex;
+
+				atomic<float> reprojectionError{ 0.0f };
+				atomic<int> viewCount{ 0 };
+				atomic<int> iterations{ 0 };
+				atomic<int> outlierCount{ 0 };
+			};
+		}
+	}
+}
@@ -66,7 +66,8 @@ namespace ofxRulr {
 						}
 					};
 				}
-				
+
+				this->manageParameters(this->parameters);
 			}
 
 			//----------
@@ -80,6 +81,25 @@ namespace ofxRulr {
 					this->stereoCalibrateNode = this->getInput<Procedure::Calibrate::StereoCalibrate>();
 				}
 
+				{
+					FrameSynchroniser::Settings settings;
+					settings.tolerance = chrono::duration_cast<chrono::nanoseconds>(chrono::duration<float, milli>(this->parameters.tolerance.get()));
+					settings.maximumWait = chrono::duration_cast<FrameSynchroniser::Clock::duration>(chrono::duration<float, milli>(this->parameters.maximumWait.get()));
+					this->frameSynchroniser.setSettings(settings);
+				}
+
+				//release frames which have timed out whilst the other camera wasn't sending
+				{
+					auto synchronisedFrames = this->frameSynchroniser.flush();
+					for (const auto & synchronisedFrame : synchronisedFrames) {
+						if (!this->threadPool->performAsync([this, synchronisedFrame]() {
+							this->processCameraSet(synchronisedFrame->frames);
+						})) {
+							this->droppedFramesSinceLastAppFrame++;
+						}
+					}
+				}
+
 				while (this->computeTimeChannel.tryReceive(this->computeTime)) {}
 
 				auto processedFramesPerSecond = (float)processedFramesSinceLastAppFrame.load() / ofGetLastFrameTime();
@@ -104,46 +124,38 @@ namespace ofxRulr {
 					return this->computeTime;
 				});
 
+				const auto & statistics = this->frameSynchroniser.getStatistics();
+				inspector->addLiveValueHistory("Pairing latency [ms]", [&statistics]() {
+					return statistics.pairingLatency.load();
+				});
+				inspector->addLiveValueHistory("Timestamp spread [ms]", [&statistics]() {
+					return statistics.timestampSpread.load();
+				});
+				inspector->addLiveValue<uint32_t>("Pairs", [&statistics]() {
+					return statistics.setsEmitted.load();
+				});
+				inspector->addLiveValue<uint32_t>("Unpaired frames dropped", [&statistics]() {
+					return statistics.stragglersDropped.load() + statistics.overflowDropped.load();
+				});
 			}
 
 			//----------
-			void UpdateTrackingStereo::processFrame(shared_ptr<MatchMarkersFrame> incomingFrame, bool cameraIndex) {
-				vector<shared_ptr<MatchMarkersFrame>> markerTrackingResults;
-				this->markerTrackingMutex.lock();
-				{
-					this->markerTracking[cameraIndex] = incomingFrame;
-					markerTrackingResults = this->markerTracking;
+			void UpdateTrackingStereo::processFrame(shared_ptr<MatchMarkersFrame> incomingFrame, size_t cameraIndex) {
+				//pair frames by capture timestamp
+				auto synchronisedFrames = this->frameSynchroniser.add(cameraIndex, incomingFrame);
+				for (const auto & synchronisedFrame : synchronisedFrames) {
+					this->processCameraSet(synchronisedFrame->frames);
 				}
-				this->markerTrackingMutex.unlock();
-
-				if (cameraIndex != this->cameraWhichSendsSecond) {
-					return;
-				}
-
-				//maybe we've got tracking!
-				for (const auto & markerTrackingResult : markerTrackingResults) {
-					if (!markerTrackingResult) {
-						//not enough data to continue yet
-						return;
-					}
-				}
-
-				this->processCameraSet(markerTrackingResults, incomingFrame);
-
-				//clean it out
-				this->markerTrackingMutex.lock();
-				{
-					for (auto & markerTrackingResult : this->markerTracking) {
-						markerTrackingResult.reset();
-					}
-				}
-				this->markerTrackingMutex.unlock();
 			}
 
 			//----------
-			void UpdateTrackingStereo::processCameraSet(vector<shared_ptr<MatchMarkersFrame>> markerTrackingResults, shared_ptr<MatchMarkersFrame> incomingFrame) {
+			void UpdateTrackingStereo::processCameraSet(vector<shared_ptr<MatchMarkersFrame>> markerTrackingResults) {
 				auto resultA = markerTrackingResults[0];
 				auto resultB = markerTrackingResults[1];
+				if (!resultA || !resultB) {
+					//only one camera is connected
+					return;
+				}
 
 				size_t countFinds = 0;
 				for (const auto & markerTrackingResult : markerTrackingResults) {
@@ -171,7 +183,7 @@ namespace ofxRulr {
 
 				//construct output
 				auto outgoingFrame = make_shared<UpdateTrackingFrame>();
-				outgoingFrame->incomingFrame = incomingFrame;
+				outgoingFrame->incomingFrame = resultB; // camera B's frame represents the pair
 				bodyNode->getExtrinsics(outgoingFrame->bodyModelViewRotationVector
 					, outgoingFrame->bodyModelViewTranslation);
 
@@ -6,6 +6,7 @@
 #include "StereoSolvePnP.h"
 
 #include "MatchMarkers.h"
+#include "FrameSynchroniser.h"
 #include "UpdateTracking.h"
 #include "ofxRulr/Nodes/Procedure/Calibrate/StereoCalibrate.h"
 
@@ -29,10 +30,16 @@ namespace ofxRulr {
 				float processedFramesPerSecond = 0.0f;
 				float droppedFramesPerSecond = 0.0f;
 
-				void processFrame(shared_ptr<MatchMarkersFrame> incomingFrame, bool cameraIndex);
-				void processCameraSet(vector<shared_ptr<MatchMarkersFrame>>, shared_ptr<MatchMarkersFrame> incomingFrame);
+				void processFrame(shared_ptr<MatchMarkersFrame> incomingFrame, size_t cameraIndex);
+				void processCameraSet(vector<shared_ptr<MatchMarkersFrame>>);
 
-				atomic<bool> cameraWhichSendsSecond = 1;
+				struct : ofParameterGroup {
+					ofParameter<float> tolerance{ "Sync tolerance [ms]", 2, 0, 100 };
+					ofParameter<float> maximumWait{ "Sync maximum wait [ms]", 50, 0, 1000 };
+					PARAM_DECLARE("UpdateTrackingStereo", tolerance, maximumWait);
+				} parameters;
+
+				FrameSynchroniser frameSynchroniser{ 2 };
 
 				unique_ptr<StereoSolvePnP> stereoSolvePnP;
 
@@ -42,9 +49,6 @@ namespace ofxRulr {
 				shared_ptr<Procedure::Calibrate::StereoCalibrate> stereoCalibrateNode;
 				mutex stereoCalibrateNodeMutex;
 
-				vector<shared_ptr<MatchMarkersFrame>> markerTracking{ 2 };
-				mutex markerTrackingMutex;
-
 				ofThreadChannel<float> computeTimeChannel;
 				float computeTime;
 			};
@@ -15,6 +15,13 @@
 #include "ofxRulr/Nodes/MoCap/PreviewRecordMarkerImageFrame.h"
 #include "ofxRulr/Nodes/MoCap/MarkerTagger.h"
 #include "ofxRulr/Nodes/MoCap/AddMarkerFromStereo.h"
+#include "ofxRulr/Nodes/MoCap/SynchroniseFrames.h"
+#include "ofxRulr/Nodes/MoCap/UpdateTrackingMultiView.h"
+#include "ofxRulr/Nodes/MoCap/Replay.h"
+#include "ofxRulr/Nodes/MoCap/MultiBodyTracking.h"
+#include "ofxRulr/Nodes/MoCap/Test/BenchmarkMultiViewSolve.h"
+#include "ofxRulr/Nodes/MoCap/Test/BenchmarkMultiBodyTracking.h"
+#include "ofxRulr/Nodes/MoCap/Test/BenchmarkSnapshot.h"
 
 OFXPLUGIN_PLUGIN_MODULES_BEGIN(ofxRulr::Nodes::Base)
 	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::FindMarkerCentroids);
@@ -30,4 +37,11 @@ OFXPLUGIN_PLUGIN_MODULES_BEGIN(ofxRulr::Nodes::Base)
 	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::PreviewRecordMarkerImagesFrame);
 	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::MarkerTagger);
 	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::AddMarkerFromStereo);
+	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::SynchroniseFrames);
+	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::UpdateTrackingMultiView);
+	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::Replay);
+	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::MultiBodyTracking);
+	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::Test::BenchmarkMultiViewSolve);
+	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::Test::BenchmarkMultiBodyTracking);
+	OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MoCap::Test::BenchmarkSnapshot);
 OFXPLUGIN_PLUGIN_MODULES_END
\ No newline at end of file
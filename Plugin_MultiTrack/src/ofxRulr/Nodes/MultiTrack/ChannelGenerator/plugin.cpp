@@ -12,6 +12,9 @@
 #include "ofxRulr/Nodes/MultiTrack/ImageBox.h"
 #include "ofxRulr/Nodes/MultiTrack/Procedure/Calibrate.h"
 #include "ofxRulr/Nodes/MultiTrack/Test/FindMarker.h"
+#include "ofxRulr/Nodes/MultiTrack/Test/BenchmarkFusion.h"
+#include "ofxRulr/Nodes/MultiTrack/Test/BenchmarkChannels.h"
+#include "ofxRulr/Nodes/MultiTrack/Test/BenchmarkSolveSet.h"
 
 #pragma warning(push)
 #pragma warning(disable:4073)
@@ -32,4 +35,7 @@ OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MultiTrack::World);
 OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MultiTrack::ImageBox);
 OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MultiTrack::Procedure::Calibrate);
 OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MultiTrack::Test::FindMarker);
+OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MultiTrack::Test::BenchmarkFusion);
+OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MultiTrack::Test::BenchmarkChannels);
+OFXPLUGIN_PLUGIN_REGISTER_MODULE(ofxRulr::Nodes::MultiTrack::Test::BenchmarkSolveSet);
 OFXPLUGIN_PLUGIN_MODULES_END
\ No newline at end of file
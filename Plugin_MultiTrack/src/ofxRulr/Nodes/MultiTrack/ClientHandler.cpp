@@ -327,7 +327,7 @@ namespace ofxRulr {
 			}
 
 			//----------
-			void serializeChannel(shared_ptr<ClientHandler::Client> client, shared_ptr<Channel> channel, string prefix = "") {
+			void ClientHandler::serializeChannel(shared_ptr<Channel> channel, const function<void(const Message &)> & output, const string & prefix) {
 				for (const auto & subChannelIt : channel->getSubChannels()) {
 					auto name = subChannelIt.first;
 					auto subChannel = subChannelIt.second;
@@ -404,9 +404,9 @@ namespace ofxRulr {
 					default:
 						break;
 					}
-					client->add(message);
+					output(message);
 
-					serializeChannel(client, subChannel, address);
+					serializeChannel(subChannel, output, address);
 				}
 			}
 
@@ -427,7 +427,9 @@ namespace ofxRulr {
 
 					if (databaseNode) {
 						auto rootChannel = databaseNode->getRootChannel();
-						serializeChannel(client, rootChannel);
+						serializeChannel(rootChannel, [client](const Message & message) {
+							client->add(message);
+						});
 					}
 
 					client->endFrame();
@@ -64,6 +64,9 @@ namespace ofxRulr {
 				shared_ptr<Client> addClient(const string & hostName, int port);
 				void removeClient(int clientIndex);
 
+				///One OSC message per channel, addressed by its path in the tree
+				static void serializeChannel(shared_ptr<Data::Channels::Channel>, const function<void(const oscpkt::Message &)> & output, const string & prefix = "");
+
 			protected:
 				void handleIncomingMessages();
 				void handleAddClient(oscpkt::Message::ArgReader &, const oscpkt::SockAddr &);
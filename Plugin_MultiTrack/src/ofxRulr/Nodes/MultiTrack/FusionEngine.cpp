@@ -0,0 +1,393 @@
+#include "pch_MultiTrack.h"
+#include "FusionEngine.h"
+
+#include "ofxRulr/Utils/Hungarian.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MultiTrack {
+			//----------
+			void FusionEngine::clear() {
+				this->tracks.clear();
+				this->sourceToBodyIndex.clear();
+				this->spatialHash.clear();
+				this->combinedBodies.clear();
+				this->statistics = Statistics();
+			}
+
+			//----------
+			void FusionEngine::update(SourceBodies & sourceBodies, const Settings & settings) {
+				auto startTime = chrono::high_resolution_clock::now();
+
+				Statistics statistics;
+				statistics.sourceBodyCount = sourceBodies.size();
+
+				const auto mergeDistanceThreshold = settings.mergeDistanceThreshold;
+				const auto mergeDistanceThresholdSquared = mergeDistanceThreshold * mergeDistanceThreshold;
+
+				//cells at least as wide as the threshold, so neighbouring cells cover every match (and the threshold may be 0)
+				const auto cellSize = max(mergeDistanceThreshold, 0.01f);
+
+				//--
+				//Calculate the anchors once per source body
+				//--
+				//
+				vector<ofVec2f> sourceAnchors(sourceBodies.size());
+				vector<bool> sourceHasAnchor(sourceBodies.size());
+				for (size_t i = 0; i < sourceBodies.size(); i++) {
+					sourceHasAnchor[i] = getAnchor(sourceBodies[i].body, sourceAnchors[i]);
+				}
+				//
+				//--
+
+
+
+				//--
+				//Update bodies seen previously
+				//--
+				//
+				// Tracks from the previous frame are kept as candidates (with their previous anchor)
+				// so that a body can be re-acquired when a sensor changes its body index.
+				vector<bool> sourceAssigned(sourceBodies.size(), false);
+				{
+					unordered_map<BodyIndex, size_t> trackByBodyIndex;
+					for (size_t i = 0; i < this->tracks.size(); i++) {
+						this->tracks[i].sources.clear();
+						trackByBodyIndex[this->tracks[i].bodyIndex] = i;
+					}
+
+					for (size_t i = 0; i < sourceBodies.size(); i++) {
+						const auto & sourceBody = sourceBodies[i];
+						auto findBodyIndex = this->sourceToBodyIndex.find(getSourceKey(sourceBody.subscriberID, sourceBody.body.bodyId));
+						if (findBodyIndex == this->sourceToBodyIndex.end()) {
+							continue;
+						}
+						auto findTrack = trackByBodyIndex.find(findBodyIndex->second);
+						if (findTrack == trackByBodyIndex.end()) {
+							continue;
+						}
+
+						auto & track = this->tracks[findTrack->second];
+						if (!this->trackHasSubscriber(track, sourceBodies, sourceBody.subscriberID)) {
+							track.sources.push_back(i);
+							sourceAssigned[i] = true;
+							statistics.stickyAssignments++;
+						}
+					}
+
+					for (auto & track : this->tracks) {
+						if (!track.sources.empty()) {
+							this->updateTrackAnchor(track, sourceAnchors, sourceHasAnchor);
+						}
+					}
+				}
+				//
+				//--
+
+
+
+				//--
+				//Assign remaining bodies per subscriber
+				//--
+				//
+				// Each subscriber can contribute at most one body to a combined body, so we solve one
+				// assignment per subscriber between its unassigned bodies and nearby combined bodies.
+				{
+					vector<size_t> unassigned;
+					for (size_t i = 0; i < sourceBodies.size(); i++) {
+						if (!sourceAssigned[i]) {
+							unassigned.push_back(i);
+						}
+					}
+					stable_sort(unassigned.begin(), unassigned.end(), [&sourceBodies](size_t a, size_t b) {
+						return sourceBodies[a].subscriberID < sourceBodies[b].subscriberID;
+					});
+
+					vector<int> trackToColumn;
+					vector<size_t> candidateTracks;
+					vector<float> costs;
+
+					//tracks which move or are created below are added to the hash as we go
+					//(entries left in their old cells are rejected by the distance gate)
+					this->buildSpatialHash(cellSize);
+
+					for (auto groupBegin = unassigned.begin(); groupBegin != unassigned.end(); ) {
+						const auto subscriberID = sourceBodies[*groupBegin].subscriberID;
+						auto groupEnd = groupBegin;
+						while (groupEnd != unassigned.end() && sourceBodies[*groupEnd].subscriberID == subscriberID) {
+							groupEnd++;
+						}
+						const auto groupSize = (size_t) (groupEnd - groupBegin);
+
+						//find candidate tracks in the neighbouring cells of each body
+						trackToColumn.assign(this->tracks.size(), -1);
+						candidateTracks.clear();
+
+						for (auto it = groupBegin; it != groupEnd; it++) {
+							if (!sourceHasAnchor[*it]) {
+								continue;
+							}
+							const auto & anchor = sourceAnchors[*it];
+							const auto cellX = (int)floor(anchor.x / cellSize);
+							const auto cellZ = (int)floor(anchor.y / cellSize);
+							for (int x = cellX - 1; x <= cellX + 1; x++) {
+								for (int z = cellZ - 1; z <= cellZ + 1; z++) {
+									auto findCell = this->spatialHash.find(getCellKey(x, z));
+									if (findCell == this->spatialHash.end()) {
+										continue;
+									}
+									for (auto trackIndex : findCell->second) {
+										if (trackToColumn[trackIndex] != -1) {
+											continue;
+										}
+										if (this->trackHasSubscriber(this->tracks[trackIndex], sourceBodies, subscriberID)) {
+											continue;
+										}
+										trackToColumn[trackIndex] = (int) candidateTracks.size();
+										candidateTracks.push_back(trackIndex);
+									}
+								}
+							}
+						}
+
+						//build the gated cost matrix
+						vector<int> assignment(groupSize, -1);
+						if (!candidateTracks.empty()) {
+							costs.assign(groupSize * candidateTracks.size(), numeric_limits<float>::infinity());
+							for (size_t row = 0; row < groupSize; row++) {
+								const auto sourceIndex = *(groupBegin + row);
+								if (!sourceHasAnchor[sourceIndex]) {
+									continue;
+								}
+								for (size_t col = 0; col < candidateTracks.size(); col++) {
+									const auto distanceSquared = sourceAnchors[sourceIndex].squareDistance(this->tracks[candidateTracks[col]].anchor);
+									if (distanceSquared < mergeDistanceThresholdSquared) {
+										costs[row * candidateTracks.size() + col] = sqrt(distanceSquared);
+										statistics.candidatePairs++;
+									}
+								}
+							}
+							assignment = Utils::Hungarian::solve(costs, groupSize, candidateTracks.size(), mergeDistanceThreshold);
+						}
+
+						//apply the assignment (or start new combined bodies)
+						vector<size_t> newTracks;
+						for (size_t row = 0; row < groupSize; row++) {
+							const auto sourceIndex = *(groupBegin + row);
+							if (assignment[row] != -1) {
+								const auto trackIndex = candidateTracks[assignment[row]];
+								auto & track = this->tracks[trackIndex];
+								track.sources.push_back(sourceIndex);
+								this->updateTrackAnchor(track, sourceAnchors, sourceHasAnchor);
+								this->addToSpatialHash(trackIndex, cellSize);
+							}
+							else {
+								Track track;
+								track.bodyIndex = this->nextBodyIndex++;
+								track.sources.push_back(sourceIndex);
+								this->updateTrackAnchor(track, sourceAnchors, sourceHasAnchor);
+								this->tracks.push_back(move(track));
+								this->addToSpatialHash(this->tracks.size() - 1, cellSize);
+								statistics.newBodies++;
+							}
+						}
+
+						groupBegin = groupEnd;
+					}
+				}
+				//
+				//--
+
+
+
+				//--
+				//Calculate the merged bodies and remove inactive bodies
+				//--
+				//
+				CombinedBodySet newCombinedBodies;
+				this->sourceToBodyIndex.clear();
+				{
+					vector<Track> activeTracks;
+					activeTracks.reserve(this->tracks.size());
+
+					for (auto & track : this->tracks) {
+						if (track.sources.empty()) {
+							continue;
+						}
+
+						CombinedBody combinedBody;
+						for (auto sourceIndex : track.sources) {
+							auto & sourceBody = sourceBodies[sourceIndex];
+							combinedBody.originalBodiesWorldSpace.emplace(sourceBody.subscriberID, move(sourceBody.body));
+						}
+
+						auto measuredBody = mean(combinedBody.originalBodiesWorldSpace, settings.mergeSettings);
+						if (!measuredBody.tracked) {
+							continue;
+						}
+
+						this->smooth(track, measuredBody, settings.smoothing);
+						combinedBody.combinedBody = track.smoothedBody;
+
+						for (const auto & originalBody : combinedBody.originalBodiesWorldSpace) {
+							this->sourceToBodyIndex[getSourceKey(originalBody.first, originalBody.second.bodyId)] = track.bodyIndex;
+						}
+
+						newCombinedBodies.emplace(track.bodyIndex, move(combinedBody));
+						activeTracks.push_back(move(track));
+					}
+
+					this->tracks = move(activeTracks);
+				}
+				//
+				//--
+
+				this->combinedBodies = move(newCombinedBodies);
+
+				chrono::duration<float, milli> duration = chrono::high_resolution_clock::now() - startTime;
+				statistics.duration = duration.count();
+				this->statistics = statistics;
+			}
+
+			//----------
+			const CombinedBodySet & FusionEngine::getCombinedBodies() const {
+				return this->combinedBodies;
+			}
+
+			//----------
+			const FusionEngine::Statistics & FusionEngine::getStatistics() const {
+				return this->statistics;
+			}
+
+			//----------
+			bool FusionEngine::getAnchor(const ofxKinectForWindows2::Data::Body & body, ofVec2f & anchor) {
+				ofVec2f accumulated;
+				int count = 0;
+
+				//prefer the pelvis and head
+				for (auto jointType : { JointType::JointType_SpineBase, JointType::JointType_Head }) {
+					auto findJoint = body.joints.find(jointType);
+					if (findJoint != body.joints.end() && findJoint->second.getTrackingState() == TrackingState::TrackingState_Tracked) {
+						const auto & position = findJoint->second.getPosition();
+						accumulated += ofVec2f(position.x, position.z);
+						count++;
+					}
+				}
+
+				//otherwise use any tracked joint
+				if (count == 0) {
+					for (const auto & joint : body.joints) {
+						if (joint.second.getTrackingState() == TrackingState::TrackingState_Tracked) {
+							const auto & position = joint.second.getPosition();
+							accumulated += ofVec2f(position.x, position.z);
+							count++;
+						}
+					}
+				}
+
+				if (count == 0) {
+					return false;
+				}
+
+				anchor = accumulated / (float)count;
+				return true;
+			}
+
+			//----------
+			uint64_t FusionEngine::getSourceKey(SubscriberID subscriberID, uint64_t bodyId) {
+				return ((uint64_t)subscriberID << 32) ^ bodyId;
+			}
+
+			//----------
+			int64_t FusionEngine::getCellKey(int x, int z) {
+				return ((int64_t)x << 32) ^ (int64_t)(uint32_t)z;
+			}
+
+			//----------
+			bool FusionEngine::trackHasSubscriber(const Track & track, const SourceBodies & sourceBodies, SubscriberID subscriberID) const {
+				for (auto sourceIndex : track.sources) {
+					if (sourceBodies[sourceIndex].subscriberID == subscriberID) {
+						return true;
+					}
+				}
+				return false;
+			}
+
+			//----------
+			void FusionEngine::updateTrackAnchor(Track & track, const vector<ofVec2f> & sourceAnchors, const vector<bool> & sourceHasAnchor) const {
+				ofVec2f accumulated;
+				int count = 0;
+				for (auto sourceIndex : track.sources) {
+					if (sourceHasAnchor[sourceIndex]) {
+						accumulated += sourceAnchors[sourceIndex];
+						count++;
+					}
+				}
+				if (count > 0) {
+					track.anchor = accumulated / (float)count;
+					track.hasAnchor = true;
+				}
+			}
+
+			//----------
+			void FusionEngine::buildSpatialHash(float cellSize) {
+				for (auto & cell : this->spatialHash) {
+					cell.second.clear();
+				}
+				for (size_t i = 0; i < this->tracks.size(); i++) {
+					this->addToSpatialHash(i, cellSize);
+				}
+			}
+
+			//----------
+			void FusionEngine::addToSpatialHash(size_t trackIndex, float cellSize) {
+				const auto & track = this->tracks[trackIndex];
+				if (!track.hasAnchor) {
+					return;
+				}
+				auto cellX = (int)floor(track.anchor.x / cellSize);
+				auto cellZ = (int)floor(track.anchor.y / cellSize);
+				auto & cell = this->spatialHash[getCellKey(cellX, cellZ)];
+				if (cell.empty() || cell.back() != trackIndex) {
+					cell.push_back(trackIndex);
+				}
+			}
+
+			//----------
+			void FusionEngine::smooth(Track & track, const ofxKinectForWindows2::Data::Body & measured, float smoothing) const {
+				if (!track.hasHistory || smoothing <= 0.0f) {
+					track.smoothedBody = measured;
+					track.hasHistory = true;
+					return;
+				}
+
+				auto smoothedBody = measured;
+				const auto amount = 1.0f - ofClamp(smoothing, 0.0f, 1.0f);
+				for (auto & joint : smoothedBody.joints) {
+					auto findPrevious = track.smoothedBody.joints.find(joint.first);
+					if (findPrevious == track.smoothedBody.joints.end()) {
+						continue;
+					}
+
+					auto position = findPrevious->second.getPosition().getInterpolated(joint.second.getPosition(), amount);
+					ofQuaternion orientation;
+					orientation.slerp(amount, findPrevious->second.getOrientation(), joint.second.getOrientation());
+
+					_Joint rawJoint = {
+						joint.first,
+						(CameraSpacePoint&)position,
+						joint.second.getTrackingState()
+					};
+
+					_JointOrientation rawJointOrientation = {
+						joint.first,
+						(Vector4&)orientation
+					};
+
+					joint.second.set(rawJoint, rawJointOrientation, joint.second.getPositionInDepthMap());
+				}
+				track.smoothedBody = smoothedBody;
+			}
+		}
+	}
+}
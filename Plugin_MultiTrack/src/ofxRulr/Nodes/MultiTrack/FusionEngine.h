@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Utils.h"
+
+#include <unordered_map>
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MultiTrack {
+			///Associates the bodies seen by every subscriber into combined bodies.
+			///Bodies are held in flat per-frame arrays, candidates are found through a spatial hash
+			///on the pelvis/head joints, and each subscriber's bodies are assigned to the combined
+			///bodies with a gated Hungarian assignment. The combined bodies are temporally smoothed.
+			class FusionEngine {
+			public:
+				struct Settings {
+					float mergeDistanceThreshold = 0.3f;
+					///0 = use the new measurement, 1 = never move
+					float smoothing = 0.0f;
+					MergeSettings mergeSettings = { true, 50.0f };
+				};
+
+				struct SourceBody {
+					SubscriberID subscriberID;
+					ofxKinectForWindows2::Data::Body body;
+				};
+				typedef vector<SourceBody> SourceBodies;
+
+				struct Statistics {
+					size_t sourceBodyCount = 0;
+					size_t stickyAssignments = 0;
+					size_t candidatePairs = 0;
+					size_t newBodies = 0;
+					float duration = 0.0f; // ms
+				};
+
+				void clear();
+
+				///Source bodies are consumed (moved into the combined bodies)
+				void update(SourceBodies & sourceBodies, const Settings &);
+
+				const CombinedBodySet & getCombinedBodies() const;
+				const Statistics & getStatistics() const;
+
+				///The XZ position of the pelvis / head used for association
+				static bool getAnchor(const ofxKinectForWindows2::Data::Body &, ofVec2f & anchor);
+			protected:
+				struct Track {
+					BodyIndex bodyIndex;
+					vector<size_t> sources; // indices into this frame's source bodies
+					ofVec2f anchor;
+					bool hasAnchor = false;
+
+					bool hasHistory = false;
+					ofxKinectForWindows2::Data::Body smoothedBody;
+				};
+
+				static uint64_t getSourceKey(SubscriberID, uint64_t bodyId);
+				static int64_t getCellKey(int x, int z);
+
+				bool trackHasSubscriber(const Track &, const SourceBodies &, SubscriberID) const;
+				void updateTrackAnchor(Track &, const vector<ofVec2f> & sourceAnchors, const vector<bool> & sourceHasAnchor) const;
+				void buildSpatialHash(float cellSize);
+				void addToSpatialHash(size_t trackIndex, float cellSize);
+				void smooth(Track &, const ofxKinectForWindows2::Data::Body & measured, float smoothing) const;
+
+				vector<Track> tracks;
+				unordered_map<uint64_t, BodyIndex> sourceToBodyIndex; // from the previous frame
+				unordered_map<int64_t, vector<size_t>> spatialHash; // cell -> index in tracks
+
+				BodyIndex nextBodyIndex = 0;
+
+				CombinedBodySet combinedBodies;
+				Statistics statistics;
+			};
+		}
+	}
+}
@@ -392,6 +392,25 @@ namespace ofxRulr {
 					});
 					buttonSolveCV->setHeight(100.0f);
 
+					auto buttonSolveRansac = inspector->addButton("Solve RANSAC", [this]() {
+						try {
+							ofxRulr::Utils::ScopedProcess scopedProcess("Solve");
+
+							//Get crackin'
+							for (auto & it : this->solveSets) {
+								it.second.solveRansac();
+							}
+
+							//Repeat.
+							this->setupSolveSets();
+							ofxCvGui::refreshInspector(this);
+
+							scopedProcess.end();
+						}
+						RULR_CATCH_ALL_TO_ALERT;
+					});
+					buttonSolveRansac->setHeight(100.0f);
+
 					for (auto & it : this->solveSets) {
 						auto & result = it.second.getResult();
 
@@ -407,6 +426,11 @@ namespace ofxRulr {
 						inspector->addLiveValue<float>("Residual", [this, result]() {
 							return result.residual;
 						});
+						if (result.inlierCount > 0) {
+							inspector->addLiveValue<size_t>("Inliers", [this, result]() {
+								return result.inlierCount;
+							});
+						}
 					}
 
 					auto buttonConfirm = inspector->addButton("Apply", [this]() {
@@ -0,0 +1,255 @@
+#include "pch_MultiTrack.h"
+#include "BenchmarkChannels.h"
+
+#include "../ClientHandler.h"
+#include "ofxRulr/Data/Channels/SharedMemoryWriter.h"
+#include "ofxRulr/Utils/ScopedProcess.h"
+
+using namespace ofxCvGui;
+using namespace ofxRulr::Data::Channels;
+using namespace oscpkt;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MultiTrack {
+			namespace Test {
+				//----------
+				BenchmarkChannels::BenchmarkChannels() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string BenchmarkChannels::getTypeName() const {
+					return "MultiTrack::Test::BenchmarkChannels";
+				}
+
+				//----------
+				void BenchmarkChannels::init() {
+					RULR_NODE_INSPECTOR_LISTENER;
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void BenchmarkChannels::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					inspector->addLiveValue<size_t>("Channels", [this]() {
+						return this->channelCount;
+					});
+					for (size_t i = 0; i < this->results.size(); i++) {
+						inspector->addTitle(this->results[i].name, ofxCvGui::Widgets::Title::Level::H3);
+						inspector->addLiveValue<string>("Mean / max latency [us]", [this, i]() {
+							return ofToString(this->results[i].meanLatency) + " / " + ofToString(this->results[i].maxLatency);
+						});
+						inspector->addLiveValue<float>("Frames per second", [this, i]() {
+							return this->results[i].framesPerSecond;
+						});
+						inspector->addLiveValue<size_t>("Bytes per frame", [this, i]() {
+							return this->results[i].bytesPerFrame;
+						});
+						inspector->addLiveValue<size_t>("Lost frames", [this, i]() {
+							return this->results[i].lostFrames;
+						});
+					}
+				}
+
+				//----------
+				void BenchmarkChannels::serializeResult(Json::Value & json) const {
+					json["channelCount"] = (Json::UInt64) this->channelCount;
+					for (const auto & result : this->results) {
+						Json::Value jsonResult;
+						jsonResult["name"] = result.name;
+						jsonResult["meanLatency"] = result.meanLatency;
+						jsonResult["maxLatency"] = result.maxLatency;
+						jsonResult["framesPerSecond"] = result.framesPerSecond;
+						jsonResult["bytesPerFrame"] = (Json::UInt64) result.bytesPerFrame;
+						jsonResult["lostFrames"] = (Json::UInt64) result.lostFrames;
+						json["results"].append(jsonResult);
+					}
+				}
+
+				//----------
+				void BenchmarkChannels::runBenchmark() {
+					typedef chrono::steady_clock Clock;
+
+					const auto bodyCount = this->parameters.bodyCount.get();
+					const auto frameCount = (uint64_t) this->parameters.frameCount.get();
+					const auto port = this->parameters.port.get();
+					const auto timeout = chrono::milliseconds(500);
+
+					Utils::ScopedProcess scopedProcess("Benchmark channels", false);
+
+					//a tree like the skeleton channels
+					auto rootChannel = make_shared<Channel>("/");
+					auto updateChannels = [&](uint64_t frameIndex) {
+						for (int i = 0; i < bodyCount; i++) {
+							auto & body = (*rootChannel)["bodies"][ofToString(i)];
+							body["id"] = i;
+							body["position"] = ofVec3f(i, frameIndex * 0.001f, 0.0f);
+							body["rotation"] = ofVec4f(0.0f, 0.0f, 0.0f, 1.0f);
+							body["tracked"] = true;
+							body["name"] = string("Body ") + ofToString(i);
+							body["joints"] = vector<int>(25, (int) frameIndex);
+						}
+						(*rootChannel)["frameIndex"] = frameIndex;
+					};
+					updateChannels(0);
+
+					vector<Transport> results;
+
+					//send a frame, then wait for the reader to say it has arrived
+					auto measure = [&](Transport & transport, const function<void(uint64_t)> & send, atomic<uint64_t> & receivedFrame, atomic<int64_t> & receivedTime) {
+						double accumulatedLatency = 0.0;
+						size_t receivedCount = 0;
+						auto startTime = Clock::now();
+						for (uint64_t frameIndex = 1; frameIndex <= frameCount; frameIndex++) {
+							updateChannels(frameIndex);
+
+							auto sendTime = SharedMemory::getTimestamp();
+							send(frameIndex);
+
+							auto timeoutTime = Clock::now() + timeout;
+							while (receivedFrame.load() < frameIndex && Clock::now() < timeoutTime) {
+								this_thread::yield();
+							}
+							if (receivedFrame.load() < frameIndex) {
+								transport.lostFrames++;
+								continue;
+							}
+
+							auto latency = (float) (receivedTime.load() - sendTime) / 1000.0f;
+							accumulatedLatency += latency;
+							transport.maxLatency = max(transport.maxLatency, latency);
+							receivedCount++;
+						}
+						auto duration = chrono::duration<float>(Clock::now() - startTime).count();
+						transport.meanLatency = receivedCount > 0 ? (float) (accumulatedLatency / receivedCount) : 0.0f;
+						transport.framesPerSecond = (float) frameCount / duration;
+					};
+
+					//shared memory
+					{
+						Transport transport;
+						transport.name = "Shared memory";
+
+						SharedMemoryWriter::Settings settings;
+						settings.name = "BenchmarkChannels";
+						SharedMemoryWriter writer(settings);
+						writer.publish(*rootChannel); // so the reader has something to open
+
+						atomic<bool> running(true);
+						atomic<uint64_t> receivedFrame(0);
+						atomic<int64_t> receivedTime(0);
+						size_t valuesSize = 0;
+						thread readerThread([&]() {
+							SharedMemory::Reader reader;
+							if (!reader.open(settings.name)) {
+								return;
+							}
+							SharedMemory::Reader::Frame frame;
+							while (running) {
+								if (reader.waitForFrame(frame, chrono::microseconds(100000))) {
+									receivedTime = SharedMemory::getTimestamp();
+									valuesSize = frame.values.size();
+									receivedFrame = frame.frameIndex - 1; // the writer's first frame was the one above
+								}
+							}
+						});
+
+						measure(transport, [&](uint64_t) {
+							writer.publish(*rootChannel);
+						}, receivedFrame, receivedTime);
+
+						running = false;
+						readerThread.join();
+
+						this->channelCount = writer.getChannelCount();
+						transport.bytesPerFrame = valuesSize;
+						results.push_back(transport);
+					}
+
+					//OSC over UDP, as ClientHandler sends it
+					{
+						Transport transport;
+						transport.name = "OSC over UDP";
+
+						UdpSocket receiveSocket;
+						receiveSocket.bindTo(port);
+						if (!receiveSocket.isOk()) {
+							throw(ofxRulr::Exception("Couldn't bind to port " + ofToString(port)));
+						}
+						UdpSocket sendSocket;
+						sendSocket.connectTo("127.0.0.1", port);
+
+						atomic<bool> running(true);
+						atomic<uint64_t> receivedFrame(0);
+						atomic<int64_t> receivedTime(0);
+						thread readerThread([&]() {
+							PacketReader packetReader;
+							while (running) {
+								if (!receiveSocket.receiveNextPacket(10)) {
+									continue;
+								}
+								packetReader.init(receiveSocket.packetData(), receiveSocket.packetSize());
+								Message * message;
+								while (packetReader.isOk() && (message = packetReader.popMessage())) {
+									auto handler = message->match("/end");
+									if (handler) {
+										int64_t frameIndex;
+										if (handler.popInt64(frameIndex).isOk()) {
+											receivedTime = SharedMemory::getTimestamp();
+											receivedFrame = (uint64_t) frameIndex;
+										}
+									}
+								}
+							}
+						});
+
+						size_t bytesPerFrame = 0;
+						measure(transport, [&](uint64_t frameIndex) {
+							//bundles split at the same size as ClientHandler::Client
+							PacketWriter packetWriter;
+							packetWriter.startBundle();
+							packetWriter.addMessage(Message("/begin"));
+							bytesPerFrame = 0;
+							ClientHandler::serializeChannel(rootChannel, [&](const Message & message) {
+								packetWriter.addMessage(message);
+								if (packetWriter.packetSize() > 2048) {
+									packetWriter.endBundle();
+									sendSocket.sendPacket(packetWriter.packetData(), packetWriter.packetSize());
+									bytesPerFrame += packetWriter.packetSize();
+									packetWriter.init();
+									packetWriter.startBundle();
+								}
+							});
+							Message endMessage("/end");
+							endMessage.pushInt64((int64_t) frameIndex);
+							packetWriter.addMessage(endMessage);
+							packetWriter.endBundle();
+							sendSocket.sendPacket(packetWriter.packetData(), packetWriter.packetSize());
+							bytesPerFrame += packetWriter.packetSize();
+						}, receivedFrame, receivedTime);
+
+						running = false;
+						readerThread.join();
+
+						transport.bytesPerFrame = bytesPerFrame;
+						results.push_back(transport);
+					}
+
+					for (const auto & transport : results) {
+						ofLogNotice("MultiTrack::Test::BenchmarkChannels") << transport.name << " : " << this->channelCount << " channels, "
+							<< transport.meanLatency << "us mean latency, " << transport.maxLatency << "us max, "
+							<< transport.framesPerSecond << " frames per second, "
+							<< transport.bytesPerFrame << " bytes per frame, "
+							<< transport.lostFrames << " lost";
+					}
+
+					this->results = results;
+
+					scopedProcess.end();
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ofxRulr/Nodes/Base.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MultiTrack {
+			namespace Test {
+				///Sends a synthetic channel tree to a reader thread on this machine, one frame at a time, through
+				///the shared memory publisher and through ClientHandler's OSC over UDP, and times how long each frame takes to arrive
+				class BenchmarkChannels : public Nodes::Test::Benchmark {
+				public:
+					BenchmarkChannels();
+					string getTypeName() const override;
+					void init();
+
+					void populateInspector(ofxCvGui::InspectArguments &);
+
+					void runBenchmark() override;
+					void serializeResult(Json::Value &) const override;
+				protected:
+					struct : ofParameterGroup {
+						ofParameter<int> bodyCount{ "Bodies", 100, 1, 10000 };
+						ofParameter<int> frameCount{ "Frames", 1000, 1, 100000 };
+						ofParameter<int> port{ "OSC port", 4490, 1, 65535 };
+						PARAM_DECLARE("BenchmarkChannels", bodyCount, frameCount, port);
+					} parameters;
+
+					struct Transport {
+						string name;
+						float meanLatency = 0.0f; // us
+						float maxLatency = 0.0f; // us
+						float framesPerSecond = 0.0f;
+						size_t bytesPerFrame = 0;
+						size_t lostFrames = 0;
+					};
+
+					size_t channelCount = 0;
+					vector<Transport> results;
+				};
+			}
+		}
+	}
+}
@@ -0,0 +1,245 @@
+#include "pch_MultiTrack.h"
+#include "BenchmarkFusion.h"
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MultiTrack {
+			namespace Test {
+				//----------
+				BenchmarkFusion::BenchmarkFusion() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string BenchmarkFusion::getTypeName() const {
+					return "MultiTrack::Test::BenchmarkFusion";
+				}
+
+				//----------
+				void BenchmarkFusion::init() {
+					RULR_NODE_DRAW_WORLD_LISTENER;
+					RULR_NODE_INSPECTOR_LISTENER;
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void BenchmarkFusion::drawWorldStage() {
+					ofPushStyle();
+					{
+						for (const auto & combinedBody : this->lastCombinedBodies) {
+							ofColor color(255, 100, 100);
+							color.setHueAngle((combinedBody.first * 60) % 360);
+							ofSetColor(color);
+							combinedBody.second.combinedBody.drawWorld();
+						}
+					}
+					ofPopStyle();
+				}
+
+				//----------
+				void BenchmarkFusion::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					inspector->addTitle("Result", ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<string>("Configuration", [this]() {
+						if (!this->hasResult) {
+							return string("-");
+						}
+						return ofToString(this->result.sensorCount) + " sensors x " + ofToString(this->result.bodyCount) + " bodies x " + ofToString(this->result.frameCount) + " frames";
+					});
+					inspector->addLiveValue<float>("Mean fusion time [ms]", [this]() {
+						return this->result.meanDuration;
+					});
+					inspector->addLiveValue<float>("Max fusion time [ms]", [this]() {
+						return this->result.maxDuration;
+					});
+					inspector->addLiveValue<float>("Mean body count error", [this]() {
+						return this->result.meanBodyCountError;
+					});
+					inspector->addLiveValue<int>("Identity switches", [this]() {
+						return this->result.identitySwitches;
+					});
+					inspector->addLiveValue<float>("Mean position error [m]", [this]() {
+						return this->result.meanPositionError;
+					});
+				}
+
+				//----------
+				void BenchmarkFusion::serializeResult(Json::Value & json) const {
+					json["sensorCount"] = this->result.sensorCount;
+					json["bodyCount"] = this->result.bodyCount;
+					json["frameCount"] = this->result.frameCount;
+					json["meanDuration"] = this->result.meanDuration;
+					json["maxDuration"] = this->result.maxDuration;
+					json["meanBodyCountError"] = this->result.meanBodyCountError;
+					json["identitySwitches"] = this->result.identitySwitches;
+					json["meanPositionError"] = this->result.meanPositionError;
+				}
+
+				//----------
+				void BenchmarkFusion::runBenchmark() {
+					const auto sensorCount = (size_t) this->parameters.sensorCount.get();
+					const auto bodyCount = (size_t) this->parameters.bodyCount.get();
+					const auto frameCount = (size_t) this->parameters.frameCount.get();
+					const auto noise = this->parameters.noise.get();
+					const auto roomSize = this->parameters.roomSize.get();
+
+					Utils::ScopedProcess scopedProcess("Benchmark fusion", false);
+
+					//deterministic scene
+					ofSeedRandom(0);
+
+					//ground truth trajectories are circles around the room
+					struct Trajectory {
+						ofVec2f center;
+						float radius;
+						float speed;
+						float phase;
+					};
+					vector<Trajectory> trajectories(bodyCount);
+					for (auto & trajectory : trajectories) {
+						trajectory.center = ofVec2f(ofRandom(-roomSize / 2.0f, roomSize / 2.0f), ofRandom(-roomSize / 2.0f, roomSize / 2.0f));
+						trajectory.radius = ofRandom(0.5f, roomSize / 4.0f);
+						trajectory.speed = ofRandom(0.2f, 1.5f) / trajectory.radius;
+						trajectory.phase = ofRandom(TWO_PI);
+					}
+
+					//each sensor labels the bodies with its own ids
+					vector<vector<uint64_t>> sensorBodyIds(sensorCount, vector<uint64_t>(bodyCount));
+					vector<uint64_t> sensorNextBodyId(sensorCount);
+					for (size_t sensor = 0; sensor < sensorCount; sensor++) {
+						for (size_t body = 0; body < bodyCount; body++) {
+							sensorBodyIds[sensor][body] = (body + sensor) % bodyCount;
+						}
+						sensorNextBodyId[sensor] = bodyCount;
+					}
+
+					auto makeBody = [noise](const ofVec2f & position, uint64_t bodyId) {
+						ofxKinectForWindows2::Data::Body body;
+						body.tracked = true;
+						body.bodyId = bodyId;
+						for (int i = 0; i < JointType_Count; i++) {
+							auto jointType = (JointType)i;
+							ofVec3f jointPosition(position.x + ofRandomf() * noise
+								, 0.1f + 1.6f * (float)i / (float)(JointType_Count - 1) + ofRandomf() * noise
+								, position.y + ofRandomf() * noise);
+							ofQuaternion orientation;
+
+							_Joint rawJoint = {
+								jointType,
+								(CameraSpacePoint&)jointPosition,
+								TrackingState::TrackingState_Tracked
+							};
+							_JointOrientation rawJointOrientation = {
+								jointType,
+								(Vector4&)orientation
+							};
+							body.joints[jointType].set(rawJoint, rawJointOrientation, ofVec2f(DepthMapSize::Width / 2, DepthMapSize::Height / 2));
+						}
+						return body;
+					};
+
+					FusionEngine fusionEngine;
+					FusionEngine::Settings settings;
+					settings.mergeDistanceThreshold = this->parameters.mergeDistanceThreshold.get();
+					settings.smoothing = this->parameters.smoothing.get();
+					settings.mergeSettings = { false, 0.0f };
+
+					FusionEngine::SourceBodies sourceBodies;
+					sourceBodies.reserve(sensorCount * bodyCount);
+
+					Result result;
+					result.sensorCount = (int)sensorCount;
+					result.bodyCount = (int)bodyCount;
+					result.frameCount = (int)frameCount;
+
+					float accumulatedDuration = 0.0f;
+					float accumulatedBodyCountError = 0.0f;
+					float accumulatedPositionError = 0.0f;
+					size_t positionErrorCount = 0;
+					vector<BodyIndex> previousIdentity(bodyCount, numeric_limits<BodyIndex>::max());
+
+					vector<ofVec2f> groundTruth(bodyCount);
+					for (size_t frame = 0; frame < frameCount; frame++) {
+						const auto time = (float)frame / 30.0f;
+						for (size_t body = 0; body < bodyCount; body++) {
+							const auto & trajectory = trajectories[body];
+							const auto angle = trajectory.phase + trajectory.speed * time;
+							groundTruth[body] = trajectory.center + ofVec2f(cos(angle), sin(angle)) * trajectory.radius;
+						}
+
+						//make the sensor frames
+						sourceBodies.clear();
+						for (size_t sensor = 0; sensor < sensorCount; sensor++) {
+							for (size_t body = 0; body < bodyCount; body++) {
+								if (ofRandomuf() < this->parameters.dropout) {
+									continue;
+								}
+								if (ofRandomuf() < this->parameters.idChangeRate) {
+									sensorBodyIds[sensor][body] = sensorNextBodyId[sensor]++;
+								}
+								sourceBodies.push_back({
+									sensor
+									, makeBody(groundTruth[body], sensorBodyIds[sensor][body])
+								});
+							}
+						}
+
+						fusionEngine.update(sourceBodies, settings);
+
+						const auto & statistics = fusionEngine.getStatistics();
+						accumulatedDuration += statistics.duration;
+						result.maxDuration = max(result.maxDuration, statistics.duration);
+
+						//score the result against ground truth
+						const auto & combinedBodies = fusionEngine.getCombinedBodies();
+						accumulatedBodyCountError += abs((float)combinedBodies.size() - (float)bodyCount);
+
+						for (size_t body = 0; body < bodyCount; body++) {
+							auto nearestDistance = numeric_limits<float>::max();
+							auto nearestIndex = numeric_limits<BodyIndex>::max();
+							for (const auto & combinedBody : combinedBodies) {
+								ofVec2f anchor;
+								if (FusionEngine::getAnchor(combinedBody.second.combinedBody, anchor)) {
+									auto distance = anchor.distance(groundTruth[body]);
+									if (distance < nearestDistance) {
+										nearestDistance = distance;
+										nearestIndex = combinedBody.first;
+									}
+								}
+							}
+
+							if (nearestIndex != numeric_limits<BodyIndex>::max()) {
+								accumulatedPositionError += nearestDistance;
+								positionErrorCount++;
+
+								if (previousIdentity[body] != numeric_limits<BodyIndex>::max() && previousIdentity[body] != nearestIndex) {
+									result.identitySwitches++;
+								}
+								previousIdentity[body] = nearestIndex;
+							}
+						}
+
+					}
+
+					result.meanDuration = accumulatedDuration / (float)frameCount;
+					result.meanBodyCountError = accumulatedBodyCountError / (float)frameCount;
+					result.meanPositionError = positionErrorCount > 0 ? accumulatedPositionError / (float)positionErrorCount : 0.0f;
+
+					this->result = result;
+					this->lastCombinedBodies = fusionEngine.getCombinedBodies();
+
+					ofLogNotice("MultiTrack::Test::BenchmarkFusion") << sensorCount << " sensors x " << bodyCount << " bodies : "
+						<< result.meanDuration << "ms mean, "
+						<< result.maxDuration << "ms max, "
+						<< result.identitySwitches << " identity switches, "
+						<< result.meanPositionError << "m mean position error";
+
+					scopedProcess.end();
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../FusionEngine.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MultiTrack {
+			namespace Test {
+				///Runs the FusionEngine against synthetic bodies seen by many sensors
+				class BenchmarkFusion : public Nodes::Test::Benchmark {
+				public:
+					BenchmarkFusion();
+					string getTypeName() const override;
+					void init();
+					void drawWorldStage();
+
+					void populateInspector(ofxCvGui::InspectArguments &);
+
+					void runBenchmark() override;
+					void serializeResult(Json::Value &) const override;
+				protected:
+					struct : ofParameterGroup {
+						ofParameter<int> sensorCount{ "Sensors", 16, 1, 64 };
+						ofParameter<int> bodyCount{ "Bodies", 6, 1, 32 };
+						ofParameter<int> frameCount{ "Frames", 1000, 1, 100000 };
+						ofParameter<float> noise{ "Noise [m]", 0.02, 0.0, 0.5 };
+						ofParameter<float> dropout{ "Dropout", 0.1, 0.0, 1.0 };
+						ofParameter<float> idChangeRate{ "ID change rate", 0.002, 0.0, 1.0 };
+						ofParameter<float> roomSize{ "Room size [m]", 10.0, 1.0, 100.0 };
+						ofParameter<float> mergeDistanceThreshold{ "Merge distance threshold", 0.3, 0.0, 5.0 };
+						ofParameter<float> smoothing{ "Smoothing", 0.5, 0.0, 0.99 };
+						PARAM_DECLARE("BenchmarkFusion", sensorCount, bodyCount, frameCount, noise, dropout, idChangeRate, roomSize, mergeDistanceThreshold, smoothing);
+					} parameters;
+
+					struct Result {
+						int sensorCount = 0;
+						int bodyCount = 0;
+						int frameCount = 0;
+						float meanDuration = 0.0f; // ms
+						float maxDuration = 0.0f; // ms
+						float meanBodyCountError = 0.0f;
+						int identitySwitches = 0;
+						float meanPositionError = 0.0f; // m
+					};
+					Result result;
+
+					CombinedBodySet lastCombinedBodies;
+				};
+			}
+		}
+	}
+}
@@ -0,0 +1,242 @@
+#include "pch_MultiTrack.h"
+#include "BenchmarkSolveSet.h"
+
+using namespace ofxCvGui;
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MultiTrack {
+			namespace Test {
+				//----------
+				BenchmarkSolveSet::BenchmarkSolveSet() {
+					RULR_NODE_INIT_LISTENER;
+				}
+
+				//----------
+				string BenchmarkSolveSet::getTypeName() const {
+					return "MultiTrack::Test::BenchmarkSolveSet";
+				}
+
+				//----------
+				void BenchmarkSolveSet::init() {
+					RULR_NODE_INSPECTOR_LISTENER;
+					RULR_NODE_SERIALIZATION_LISTENERS;
+
+					this->manageParameters(this->parameters);
+				}
+
+				//----------
+				void BenchmarkSolveSet::populateInspector(ofxCvGui::InspectArguments & inspectArgs) {
+					auto inspector = inspectArgs.inspector;
+					inspector->addButton("Select recorded data", [this]() {
+						auto result = ofSystemLoadDialog("Select saved Calibrate node");
+						if (result.bSuccess) {
+							this->parameters.recordedData = result.filePath;
+						}
+					});
+					inspector->addParameterGroup(this->solveSet.parameters);
+
+					inspector->addTitle("Result", ofxCvGui::Widgets::Title::Level::H3);
+					inspector->addLiveValue<size_t>("Sets", [this]() {
+						return this->setCount;
+					});
+					for (const auto & result : this->results) {
+						inspector->addTitle(result.name, ofxCvGui::Widgets::Title::Level::H3);
+						inspector->addLiveValue<float>("Mean duration [ms]", [result]() {
+							return result.meanDuration;
+						});
+						inspector->addLiveValue<float>("Median point error [m]", [result]() {
+							return result.medianError;
+						});
+						if (this->hasGroundTruth) {
+							inspector->addLiveValue<float>("Rotation error [deg]", [result]() {
+								return result.rotationError;
+							});
+							inspector->addLiveValue<float>("Translation error [m]", [result]() {
+								return result.translationError;
+							});
+						}
+						inspector->addLiveValue<int>("Failures", [result]() {
+							return result.failures;
+						});
+					}
+				}
+
+				//----------
+				void BenchmarkSolveSet::serialize(Json::Value & json) {
+					Utils::Serializable::serialize(json["solveSet"], this->solveSet.parameters);
+				}
+
+				//----------
+				void BenchmarkSolveSet::deserialize(const Json::Value & json) {
+					Utils::Serializable::deserialize(json["solveSet"], this->solveSet.parameters);
+				}
+
+				//----------
+				vector<BenchmarkSolveSet::Correspondences> BenchmarkSolveSet::loadRecordedData() const {
+					const auto filename = this->parameters.recordedData.get();
+					ofFile input;
+					if (!input.open(filename, ofFile::ReadOnly, false)) {
+						throw(ofxRulr::Exception("Couldn't open [" + filename + "]"));
+					}
+					string jsonRaw = input.readToBuffer().getText();
+
+					Json::Reader reader;
+					Json::Value json;
+					if (!reader.parse(jsonRaw, json)) {
+						throw(ofxRulr::Exception("Couldn't parse [" + filename + "] : " + reader.getFormattedErrorMessages()));
+					}
+
+					//as written by Calibrate::serialize
+					vector<Correspondences> sets;
+					const auto & jsonSolveSets = json["solveSets"];
+					for (const auto & jsonSolveSet : jsonSolveSets) {
+						Correspondences correspondences;
+						for (const auto & jsonDataPoint : jsonSolveSet["dataSet"]) {
+							ofVec3f src, dst;
+							jsonDataPoint["src"] >> src;
+							jsonDataPoint["dst"] >> dst;
+							correspondences.srcPoints.push_back(src);
+							correspondences.dstPoints.push_back(dst);
+						}
+						if (correspondences.srcPoints.size() >= 3) {
+							sets.push_back(correspondences);
+						}
+					}
+					if (sets.empty()) {
+						throw(ofxRulr::Exception("No solve sets with 3 or more points in [" + filename + "]"));
+					}
+					return sets;
+				}
+
+				//----------
+				vector<BenchmarkSolveSet::Correspondences> BenchmarkSolveSet::makeSyntheticData() const {
+					const auto pointCount = (size_t) this->parameters.pointCount.get();
+					const auto outlierRatio = this->parameters.outlierRatio.get();
+					const auto noise = this->parameters.noise.get();
+					const auto roomSize = this->parameters.roomSize.get();
+
+					//deterministic sets, one per repeat
+					ofSeedRandom(0);
+					vector<Correspondences> sets(this->parameters.repeats.get());
+					for (auto & correspondences : sets) {
+						//sensors face each other across the room
+						correspondences.hasGroundTruth = true;
+						correspondences.groundTruth.makeRotationMatrix(ofRandom(-180.0f, 180.0f), ofVec3f(0, 1, 0));
+						correspondences.groundTruth.rotate(ofRandom(-10.0f, 10.0f), 1, 0, 0);
+						correspondences.groundTruth.setTranslation(ofRandom(-roomSize, roomSize) / 2.0f, ofRandom(-0.5f, 0.5f), ofRandom(-roomSize, roomSize) / 2.0f);
+
+						for (size_t i = 0; i < pointCount; i++) {
+							ofVec3f src(ofRandom(-roomSize, roomSize) / 2.0f, ofRandom(0.0f, 2.0f), ofRandom(-roomSize, roomSize) / 2.0f);
+							ofVec3f dst;
+							if (ofRandomuf() < outlierRatio) {
+								//a different red thing, or a bad depth reading
+								dst = ofVec3f(ofRandom(-roomSize, roomSize) / 2.0f, ofRandom(0.0f, 2.0f), ofRandom(-roomSize, roomSize) / 2.0f);
+							}
+							else {
+								dst = src * correspondences.groundTruth + ofVec3f(ofRandomf(), ofRandomf(), ofRandomf()) * noise;
+							}
+							correspondences.srcPoints.push_back(src);
+							correspondences.dstPoints.push_back(dst);
+						}
+					}
+					return sets;
+				}
+
+				//----------
+				void BenchmarkSolveSet::serializeResult(Json::Value & json) const {
+					json["setCount"] = (Json::UInt64) this->setCount;
+					json["hasGroundTruth"] = this->hasGroundTruth;
+					for (const auto & result : this->results) {
+						Json::Value jsonResult;
+						jsonResult["name"] = result.name;
+						jsonResult["meanDuration"] = result.meanDuration;
+						jsonResult["medianError"] = result.medianError;
+						jsonResult["rotationError"] = result.rotationError;
+						jsonResult["translationError"] = result.translationError;
+						jsonResult["failures"] = result.failures;
+						json["results"].append(jsonResult);
+					}
+				}
+
+				//----------
+				void BenchmarkSolveSet::runBenchmark() {
+					const auto sets = this->parameters.recordedData.get().empty()
+						? this->makeSyntheticData()
+						: this->loadRecordedData();
+					const auto repeats = this->parameters.recordedData.get().empty()
+						? 1
+						: this->parameters.repeats.get();
+
+					Utils::ScopedProcess scopedProcess("Benchmark SolveSet", false);
+
+					typedef void (ofxRulr::Utils::SolveSet::*SolveFunction)();
+					const vector<pair<string, SolveFunction>> methods = {
+						{ "NL", &ofxRulr::Utils::SolveSet::solveNL },
+						{ "CV", &ofxRulr::Utils::SolveSet::solveCv },
+						{ "RANSAC", &ofxRulr::Utils::SolveSet::solveRansac }
+					};
+
+					vector<MethodResult> results;
+					for (const auto & method : methods) {
+						MethodResult result;
+						result.name = method.first;
+
+						size_t runCount = 0;
+						for (const auto & correspondences : sets) {
+							for (int repeat = 0; repeat < repeats; repeat++) {
+								//setup clears the previous solve
+								this->solveSet.setup(correspondences.srcPoints, correspondences.dstPoints);
+								(this->solveSet.*method.second)();
+								runCount++;
+
+								const auto & solveResult = this->solveSet.getResult();
+								result.meanDuration += chrono::duration<float, milli>(solveResult.totalTime).count();
+								if (!solveResult.success) {
+									result.failures++;
+								}
+
+								//median error is robust to the outliers, so it works without ground truth
+								vector<float> errors;
+								errors.reserve(correspondences.srcPoints.size());
+								for (size_t i = 0; i < correspondences.srcPoints.size(); i++) {
+									errors.push_back((correspondences.srcPoints[i] * solveResult.transform).distance(correspondences.dstPoints[i]));
+								}
+								auto median = errors.begin() + errors.size() / 2;
+								nth_element(errors.begin(), median, errors.end());
+								result.medianError += *median;
+
+								if (correspondences.hasGroundTruth) {
+									auto difference = solveResult.transform * correspondences.groundTruth.getInverse();
+									float angle;
+									ofVec3f axis;
+									difference.getRotate().getRotate(angle, axis);
+									result.rotationError += abs(angle > 180.0f ? 360.0f - angle : angle);
+									result.translationError += solveResult.transform.getTranslation().distance(correspondences.groundTruth.getTranslation());
+								}
+							}
+						}
+
+						result.meanDuration /= (float) runCount;
+						result.medianError /= (float) runCount;
+						result.rotationError /= (float) runCount;
+						result.translationError /= (float) runCount;
+						results.push_back(result);
+
+						ofLogNotice(this->getTypeName()) << result.name << " : " << result.meanDuration << "ms mean, "
+							<< result.medianError << "m median error, "
+							<< result.rotationError << "deg rotation error, "
+							<< result.translationError << "m translation error, "
+							<< result.failures << " failures";
+					}
+
+					this->results = results;
+					this->setCount = sets.size();
+					this->hasGroundTruth = sets.front().hasGroundTruth;
+
+					scopedProcess.end();
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "ofxRulr/Utils/SolveSet.h"
+#include "ofxRulr/Nodes/Test/Benchmark.h"
+
+namespace ofxRulr {
+	namespace Nodes {
+		namespace MultiTrack {
+			namespace Test {
+				///Compares the SolveSet methods on recorded calibration data (a saved Calibrate node) or on synthetic
+				///correspondences with outliers and a known transform
+				class BenchmarkSolveSet : public Nodes::Test::Benchmark {
+				public:
+					BenchmarkSolveSet();
+					string getTypeName() const override;
+					void init();
+
+					void populateInspector(ofxCvGui::InspectArguments &);
+					void serialize(Json::Value &);
+					void deserialize(const Json::Value &);
+
+					void runBenchmark() override;
+					void serializeResult(Json::Value &) const override;
+				protected:
+					struct Correspondences {
+						vector<ofVec3f> srcPoints;
+						vector<ofVec3f> dstPoints;
+						bool hasGroundTruth = false;
+						ofMatrix4x4 groundTruth;
+					};
+					vector<Correspondences> loadRecordedData() const;
+					vector<Correspondences> makeSyntheticData() const;
+
+					struct : ofParameterGroup {
+						ofParameter<string> recordedData{ "Recorded data", "" }; // saved Calibrate node, synthetic if empty
+						ofParameter<int> pointCount{ "Points", 1000, 3, 100000 };
+						ofParameter<float> outlierRatio{ "Outlier ratio", 0.3, 0.0, 0.9 };
+						ofParameter<float> noise{ "Noise [m]", 0.01, 0.0, 0.5 };
+						ofParameter<float> roomSize{ "Room size [m]", 6.0, 1.0, 50.0 };
+						ofParameter<int> repeats{ "Repeats", 10, 1, 1000 };
+						PARAM_DECLARE("BenchmarkSolveSet", recordedData, pointCount, outlierRatio, noise, roomSize, repeats);
+					} parameters;
+
+					ofxRulr::Utils::SolveSet solveSet; // settings are shown in the inspector
+
+					struct MethodResult {
+						string name;
+						float meanDuration = 0.0f; // ms
+						float medianError = 0.0f; // m, mean over sets of the median point error
+						float rotationError = 0.0f; // degrees, against ground truth
+						float translationError = 0.0f; // m, against ground truth
+						int failures = 0;
+					};
+					vector<MethodResult> results;
+					size_t setCount = 0;
+					bool hasGroundTruth = false;
+				};
+			}
+		}
+	}
+}
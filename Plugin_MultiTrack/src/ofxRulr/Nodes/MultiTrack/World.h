@@ -2,6 +2,7 @@
 
 #include "Subscriber.h"
 #include "Utils.h"
+#include "FusionEngine.h"
 
 #include "ofxRulr/Data/Channels/Channel.h"
 
@@ -11,7 +12,7 @@ namespace ofxRulr {
 			class World : public Nodes::Base {
 			public:
 				enum Constants : size_t {
-					NumSubscribers = 6
+					NumSubscribers = 16
 				};
 
 				World();
@@ -24,6 +25,7 @@ namespace ofxRulr {
 				map<size_t, weak_ptr<Subscriber>> & getSubscribers();
 
 				MergeSettings getMergeSettings() const;
+				const CombinedBodySet & getCombinedBodies() const;
 			protected:
 				struct : ofParameterGroup {
 					struct : ofParameterGroup {
@@ -31,7 +33,8 @@ namespace ofxRulr {
 						ofParameter<float> mergeDistanceThreshold{ "Merge distance threshold", 0.3, 0.0, 5.0 };
 						ofParameter<bool> crossoverEnabled{ "Crossover enabled", true };
 						ofParameter<float> crossoverMargin{ "Crossover margin [px]", 50 };
-						PARAM_DECLARE("Fusion", enabled, mergeDistanceThreshold, crossoverEnabled, crossoverMargin);
+						ofParameter<float> smoothing{ "Smoothing", 0.0, 0.0, 0.99 };
+						PARAM_DECLARE("Fusion", enabled, mergeDistanceThreshold, crossoverEnabled, crossoverMargin, smoothing);
 					} fusion;
 
 					struct : ofParameterGroup {
@@ -46,14 +49,11 @@ namespace ofxRulr {
 
 				Subscribers subscribers;
 
-				CombinedBodySet combinedBodies;
-
-				typedef vector<ofxKinectForWindows2::Data::Body> Bodies;
-				typedef map<SubscriberID, Bodies> WorldBodiesUnmerged;
+				FusionEngine fusionEngine;
+				FusionEngine::SourceBodies worldBodiesUnmerged;
 
 				void performFusion();
-				WorldBodiesUnmerged getWorldBodiesUnmerged() const;
-				CombinedBodySet combineWorldBodies(WorldBodiesUnmerged worldBodiesUnmerged) const;
+				void getWorldBodiesUnmerged(FusionEngine::SourceBodies &) const;
 				void populateDatabase(Data::Channels::Channel & rootChannel);
 			};
 		}
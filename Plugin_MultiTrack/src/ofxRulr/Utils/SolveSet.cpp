@@ -1,8 +1,78 @@
 #include "pch_MultiTrack.h"
 #include "SolveSet.h"
 
+#include "ofxRulr/Utils/ParallelFor.h"
+
+#include <numeric>
+#include <random>
+
 namespace ofxRulr {
 	namespace Utils {
+		namespace {
+			struct RigidTransform {
+				cv::Matx33d rotation = cv::Matx33d::eye();
+				cv::Vec3d translation;
+			};
+
+			//----------
+			cv::Vec3d toVec(const cv::Point3f & point) {
+				return cv::Vec3d(point.x, point.y, point.z);
+			}
+
+			//----------
+			double getSquaredError(const RigidTransform & transform, const cv::Point3f & src, const cv::Point3f & dst) {
+				auto error = transform.rotation * toVec(src) + transform.translation - toVec(dst);
+				return error.dot(error);
+			}
+
+			//----------
+			//Kabsch / Umeyama without scale. weights can be empty for equal weights. Returns false if the points are degenerate.
+			bool fitRigid(const vector<cv::Point3f> & src, const vector<cv::Point3f> & dst, const size_t * indices, size_t count, const vector<double> & weights, RigidTransform & transform) {
+				cv::Vec3d srcCentroid, dstCentroid;
+				double totalWeight = 0.0;
+				for (size_t i = 0; i < count; i++) {
+					const auto index = indices[i];
+					const auto weight = weights.empty() ? 1.0 : weights[index];
+					srcCentroid += weight * toVec(src[index]);
+					dstCentroid += weight * toVec(dst[index]);
+					totalWeight += weight;
+				}
+				if (totalWeight <= 0.0) {
+					return false;
+				}
+				srcCentroid /= totalWeight;
+				dstCentroid /= totalWeight;
+
+				cv::Matx33d covariance = cv::Matx33d::zeros();
+				for (size_t i = 0; i < count; i++) {
+					const auto index = indices[i];
+					const auto weight = weights.empty() ? 1.0 : weights[index];
+					auto srcOffset = toVec(src[index]) - srcCentroid;
+					auto dstOffset = toVec(dst[index]) - dstCentroid;
+					covariance += weight * (cv::Matx31d(srcOffset) * cv::Matx13d(dstOffset[0], dstOffset[1], dstOffset[2]));
+				}
+
+				cv::Matx31d singularValues;
+				cv::Matx33d u, vt;
+				cv::SVD::compute(covariance, singularValues, u, vt);
+
+				//collinear points leave the rotation about their line undetermined
+				if (singularValues(1) < 1e-9 * max(singularValues(0), 1e-12)) {
+					return false;
+				}
+
+				auto v = vt.t();
+				auto ut = u.t();
+				auto reflection = cv::determinant(v * ut) < 0.0 ? -1.0 : 1.0;
+				auto correction = cv::Matx33d::diag(cv::Vec3d(1.0, 1.0, reflection));
+
+				transform.rotation = v * correction * ut;
+				transform.translation = dstCentroid - transform.rotation * srcCentroid;
+				return true;
+			}
+
+		}
+
 		//----------
 		SolveSet::SolveSet() {
 			clear();
@@ -120,6 +190,136 @@ namespace ofxRulr {
 			this->completed = true;
 		}
 
+		//----------
+		void SolveSet::solveRansac() {
+			if (this->inPoints.size() < 3) {
+				throw(ofxRulr::Exception("Need at least 3 points for RANSAC"));
+			}
+
+			const auto & settings = this->parameters.ransacSettings;
+			const auto pointCount = this->inPoints.size();
+			const auto hypothesisCount = (size_t) settings.hypotheses.get();
+			const auto blockSize = (size_t) settings.blockSize.get();
+			const auto inlierThreshold = (double) settings.inlierThreshold.get();
+			const auto squaredInlierThreshold = inlierThreshold * inlierThreshold;
+			const auto huberWidth = (double) settings.huberWidth.get();
+			const auto threadCount = (size_t) max(settings.threads.get(), 0); // 0 for hardware concurrency
+
+			auto startTime = chrono::system_clock::now();
+
+			//hypotheses from random minimal samples. Each hypothesis has its own seed so the result doesn't depend on the thread count
+			vector<RigidTransform> hypotheses(hypothesisCount);
+			vector<uint8_t> hypothesisValid(hypothesisCount, false); // not vector<bool>, which threads can't write to separately
+			Utils::parallelFor(hypothesisCount, [&](size_t i) {
+				const vector<double> noWeights;
+				mt19937 randomGenerator((uint32_t) i);
+				uniform_int_distribution<size_t> distribution(0, pointCount - 1);
+				for (int attempt = 0; attempt < 16 && !hypothesisValid[i]; attempt++) {
+					size_t sample[3];
+					sample[0] = distribution(randomGenerator);
+					do {
+						sample[1] = distribution(randomGenerator);
+					} while (sample[1] == sample[0]);
+					do {
+						sample[2] = distribution(randomGenerator);
+					} while (sample[2] == sample[0] || sample[2] == sample[1]);
+					hypothesisValid[i] = fitRigid(this->inPoints, this->outPoints, sample, 3, noWeights, hypotheses[i]);
+				}
+			}, threadCount);
+
+			vector<size_t> liveHypotheses;
+			for (size_t i = 0; i < hypothesisCount; i++) {
+				if (hypothesisValid[i]) {
+					liveHypotheses.push_back(i);
+				}
+			}
+			if (liveHypotheses.empty()) {
+				throw(ofxRulr::Exception("All RANSAC samples were degenerate"));
+			}
+
+			//preemptive scoring : score every live hypothesis on a block of points in random order, then drop the worse half
+			vector<size_t> pointOrder(pointCount);
+			iota(pointOrder.begin(), pointOrder.end(), 0);
+			shuffle(pointOrder.begin(), pointOrder.end(), mt19937(0));
+
+			vector<double> costs(hypothesisCount, 0.0);
+			for (size_t blockStart = 0; blockStart < pointCount && liveHypotheses.size() > 1; blockStart += blockSize) {
+				const auto blockEnd = min(blockStart + blockSize, pointCount);
+				Utils::parallelFor(liveHypotheses.size(), [&](size_t i) {
+					const auto hypothesisIndex = liveHypotheses[i];
+					const auto & hypothesis = hypotheses[hypothesisIndex];
+					auto cost = 0.0;
+					for (size_t j = blockStart; j < blockEnd; j++) {
+						const auto pointIndex = pointOrder[j];
+						cost += min(getSquaredError(hypothesis, this->inPoints[pointIndex], this->outPoints[pointIndex]), squaredInlierThreshold);
+					}
+					costs[hypothesisIndex] += cost;
+				}, threadCount);
+
+				const auto keepCount = max<size_t>(liveHypotheses.size() / 2, 1);
+				nth_element(liveHypotheses.begin(), liveHypotheses.begin() + (keepCount - 1), liveHypotheses.end(), [&costs](size_t a, size_t b) {
+					return costs[a] < costs[b];
+				});
+				liveHypotheses.resize(keepCount);
+			}
+			auto bestHypothesis = *min_element(liveHypotheses.begin(), liveHypotheses.end(), [&costs](size_t a, size_t b) {
+				return costs[a] < costs[b];
+			});
+			auto transform = hypotheses[bestHypothesis];
+
+			//refine with iteratively reweighted least squares on the inliers, with Huber weights
+			vector<size_t> inliers;
+			vector<double> weights(pointCount, 0.0);
+			auto findInliers = [&]() {
+				inliers.clear();
+				for (size_t i = 0; i < pointCount; i++) {
+					auto squaredError = getSquaredError(transform, this->inPoints[i], this->outPoints[i]);
+					if (squaredError < squaredInlierThreshold) {
+						auto error = sqrt(squaredError);
+						weights[i] = error <= huberWidth ? 1.0 : huberWidth / error;
+						inliers.push_back(i);
+					}
+					else {
+						weights[i] = 0.0;
+					}
+				}
+			};
+
+			findInliers();
+			for (int iteration = 0; iteration < settings.refineIterations && inliers.size() >= 3; iteration++) {
+				RigidTransform refined;
+				if (!fitRigid(this->inPoints, this->outPoints, inliers.data(), inliers.size(), weights, refined)) {
+					break;
+				}
+				auto change = cv::norm(refined.translation - transform.translation) + cv::norm(refined.rotation - transform.rotation, cv::NORM_L2);
+				transform = refined;
+				findInliers();
+				if (change < 1e-9) {
+					break;
+				}
+			}
+
+			auto endTime = chrono::system_clock::now();
+
+			double sumSquaredError = 0.0;
+			for (auto index : inliers) {
+				sumSquaredError += getSquaredError(transform, this->inPoints[index], this->outPoints[index]);
+			}
+
+			const auto & r = transform.rotation;
+			const auto & t = transform.translation;
+			this->result.success = inliers.size() >= 3;
+			this->result.totalTime = endTime - startTime;
+			this->result.residual = inliers.empty() ? 0.0f : (float) sqrt(sumSquaredError / (double) inliers.size());
+			this->result.inlierCount = inliers.size();
+			this->result.transform = ofMatrix4x4(r(0, 0), r(1, 0), r(2, 0), 0.0f,
+												 r(0, 1), r(1, 1), r(2, 1), 0.0f,
+												 r(0, 2), r(1, 2), r(2, 2), 0.0f,
+												 t[0], t[1], t[2], 1.0f);
+
+			this->completed = true;
+		}
+
 		//----------
 		void SolveSet::serialize(Json::Value & json) {
 			{
@@ -158,8 +358,8 @@ namespace ofxRulr {
 				const auto & jsonDataSet = json["dataSet"];
 				for (const auto & jsonDataPoint : jsonDataSet) {
 					ofxNonLinearFit::Models::RigidBody::DataPoint dataPoint;
-					jsonDataPoint["x"] >> dataPoint.x;
-					jsonDataPoint["xdash"] >> dataPoint.xdash;
+					jsonDataPoint["src"] >> dataPoint.x;
+					jsonDataPoint["dst"] >> dataPoint.xdash;
 					this->dataSet.push_back(dataPoint);
 
 					cv::Point3f inPoint = cv::Point3f(dataPoint.x.x, dataPoint.x.y, dataPoint.x.z);
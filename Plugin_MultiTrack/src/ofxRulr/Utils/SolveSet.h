@@ -7,12 +7,13 @@ namespace ofxRulr {
 		class SolveSet {
 		public:
 			struct Result {
-				Result() : success(false) {};
+				Result() : success(false), inlierCount(0) {};
 
 				ofMatrix4x4 transform;
 				float residual;
 				chrono::system_clock::duration totalTime;
 				bool success;
+				size_t inlierCount; // solveRansac only
 			};
 
 			SolveSet();
@@ -24,6 +25,9 @@ namespace ofxRulr {
 			void solveNL();
 			void solveCv();
 
+			///Preemptive RANSAC over 3 point rigid (Kabsch) hypotheses, then a Huber weighted refinement of the best
+			void solveRansac();
+
 			void serialize(Json::Value &);
 			void deserialize(const Json::Value &);
 
@@ -39,7 +43,16 @@ namespace ofxRulr {
 					ofParameter<float> ransacThreshold{ "RANSAC Threshold", 3.0f, 0.0f, 10.0f };
 					PARAM_DECLARE("CV Estimate", ransacThreshold);
 				} cvSettings;
-				PARAM_DECLARE("Settings", nlSettings, cvSettings);
+				struct : ofParameterGroup {
+					ofParameter<int> hypotheses{ "Hypotheses", 512, 8, 16384 };
+					ofParameter<int> blockSize{ "Block size", 64, 1, 4096 };
+					ofParameter<float> inlierThreshold{ "Inlier threshold [m]", 0.05f, 0.001f, 1.0f };
+					ofParameter<float> huberWidth{ "Huber width [m]", 0.02f, 0.001f, 1.0f };
+					ofParameter<int> refineIterations{ "Refine iterations", 10, 0, 100 };
+					ofParameter<int> threads{ "Threads", 0, 0, 64 };
+					PARAM_DECLARE("RANSAC", hypotheses, blockSize, inlierThreshold, huberWidth, refineIterations, threads);
+				} ransacSettings;
+				PARAM_DECLARE("Settings", nlSettings, cvSettings, ransacSettings);
 			} parameters;
 
 		protected:
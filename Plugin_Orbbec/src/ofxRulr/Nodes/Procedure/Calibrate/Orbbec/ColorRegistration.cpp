@@ -4,6 +4,7 @@
 #include "ofxRulr/Nodes/Item/Orbbec/Color.h"
 #include "ofxRulr/Nodes/Item/Orbbec/Infrared.h"
 #include "ofxRulr/Nodes/Item/Board.h"
+#include "ofxRulr/Utils/BundleAdjuster.h"
 
 using namespace ofxCv;
 
@@ -304,6 +305,23 @@ namespace ofxRulr {
 						auto colorCameraMatrix = colorNode->getCameraMatrix();
 						auto colorDistortionCoefficients = colorNode->getDistortionCoefficients();
 
+						const auto useSparseSolver = this->parameters.solver.get() == CalibrationSolver::Sparse;
+						auto calibrateCamera = [useSparseSolver](const vector<vector<cv::Point3f>> & objectPoints
+							, const vector<vector<cv::Point2f>> & imagePoints
+							, cv::Size imageSize
+							, cv::Mat & cameraMatrix
+							, cv::Mat & distortionCoefficients
+							, vector<cv::Mat> & rotations
+							, vector<cv::Mat> & translations
+							, int flags) {
+							if (useSparseSolver) {
+								return Utils::BundleAdjuster::calibrateCamera(objectPoints, imagePoints, imageSize, cameraMatrix, distortionCoefficients, rotations, translations, flags);
+							}
+							else {
+								return cv::calibrateCamera(objectPoints, imagePoints, imageSize, cameraMatrix, distortionCoefficients, rotations, translations, flags);
+							}
+						};
+
 						//first let's calibrate the cameras
 						{
 							int flags = CV_CALIB_USE_INTRINSIC_GUESS | CV_CALIB_FIX_K5 | CV_CALIB_FIX_K6 | this->parameters.allowDistortion
@@ -311,7 +329,7 @@ namespace ofxRulr {
 								: CV_CALIB_USE_INTRINSIC_GUESS | CV_CALIB_FIX_K1 | CV_CALIB_FIX_K2 | CV_CALIB_FIX_K3 | CV_CALIB_FIX_K4 | CV_CALIB_ZERO_TANGENT_DIST;
 
 							vector<cv::Mat> rotations, translations;
-							cv::calibrateCamera(objectPoints
+							calibrateCamera(objectPoints
 								, colorImagePoints
 								, colorNode->getSize()
 								, colorCameraMatrix
@@ -322,7 +340,7 @@ namespace ofxRulr {
 							colorNode->setIntrinsics(colorCameraMatrix, colorDistortionCoefficients);
 
 							if (this->parameters.calibrateIRIntrinsics) {
-								cv::calibrateCamera(objectPoints
+								calibrateCamera(objectPoints
 									, irImagePoints
 									, irNode->getSize()
 									, irCameraMatrix
@@ -339,20 +357,37 @@ namespace ofxRulr {
 						cv::Mat essentialMatrx, fundamentalMatrix;
 
 						//then let's stereo calibrate between the 2 of them
-						this->reprojectionError = cv::stereoCalibrate(objectPoints
-							, irImagePoints
-							, colorImagePoints
-							, irCameraMatrix
-							, irDistortionCoefficients
-							, colorCameraMatrix
-							, colorDistortionCoefficients
-							, irNode->getSize()
-							, rotation
-							, translation
-							, essentialMatrx
-							, fundamentalMatrix
-							, TermCriteria(CV_TERMCRIT_ITER + CV_TERMCRIT_EPS, 100, 1e-5)
-							, CV_CALIB_FIX_INTRINSIC | CV_CALIB_USE_INTRINSIC_GUESS);
+						if (useSparseSolver) {
+							this->reprojectionError = Utils::BundleAdjuster::stereoCalibrate(objectPoints
+								, irImagePoints
+								, colorImagePoints
+								, irCameraMatrix
+								, irDistortionCoefficients
+								, colorCameraMatrix
+								, colorDistortionCoefficients
+								, irNode->getSize()
+								, rotation
+								, translation
+								, essentialMatrx
+								, fundamentalMatrix
+								, CV_CALIB_FIX_INTRINSIC | CV_CALIB_USE_INTRINSIC_GUESS);
+						}
+						else {
+							this->reprojectionError = cv::stereoCalibrate(objectPoints
+								, irImagePoints
+								, colorImagePoints
+								, irCameraMatrix
+								, irDistortionCoefficients
+								, colorCameraMatrix
+								, colorDistortionCoefficients
+								, irNode->getSize()
+								, rotation
+								, translation
+								, essentialMatrx
+								, fundamentalMatrix
+								, TermCriteria(CV_TERMCRIT_ITER + CV_TERMCRIT_EPS, 100, 1e-5)
+								, CV_CALIB_FIX_INTRINSIC | CV_CALIB_USE_INTRINSIC_GUESS);
+						}
 
 						colorNode->setExtrinsics(rotation, translation);
 
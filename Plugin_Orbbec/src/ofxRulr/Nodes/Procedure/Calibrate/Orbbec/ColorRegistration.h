@@ -34,7 +34,8 @@ namespace ofxRulr {
 							ofParameter<float> irExposure{ "IR exposure", 0.15, 0, 8 };
 							ofParameter<bool> calibrateIRIntrinsics{ "Calibrate IR Intrinsics", false };
 							ofParameter<bool> allowDistortion{ "Allow distortion", false };
-							PARAM_DECLARE("ColorRegistration", irExposure, calibrateIRIntrinsics, allowDistortion)
+							ofParameter<CalibrationSolver> solver{ "Solver", CalibrationSolver::OpenCV };
+							PARAM_DECLARE("ColorRegistration", irExposure, calibrateIRIntrinsics, allowDistortion, solver)
 						} parameters;
 
 						ofParameter<float> reprojectionError{ "Reprojection error", 0 };
@@ -4,6 +4,7 @@
 #include "ofxRulr/Nodes/Item/AbstractBoard.h"
 #include "ofxRulr/Nodes/Item/Camera.h"
 #include "ofxRulr/Nodes/Item/Projector.h"
+#include "ofxRulr/Utils/WorldBatch.h"
 
 namespace ofxRulr {
 	namespace Nodes {
@@ -198,21 +199,23 @@ namespace ofxRulr {
 				//----------
 				void LaserToWorld::drawWorldStage() {
 					auto captures = this->captures.getSelection();
+
+					//crosses go into the batch, the labels are still drawn one at a time
+					Utils::WorldBatch::Scope batch;
 					for (auto capture : captures) {
-						ofPushMatrix();
-						{
-							ofTranslate(capture->worldPosition);
-							ofPushStyle();
-							{
-								ofSetColor(capture->color);
-								ofDrawLine(0, -0.02, 0, +0.02);
-								ofDrawLine(-0.02, 0, +0.02, 0);
-								ofDrawBitmapString(ofToString(capture->projected, 3), 0, 0);
-							}
-							ofPopStyle();
+						const ofVec3f position = capture->worldPosition;
+						batch->addLine(position + ofVec3f(0, -0.02, 0), position + ofVec3f(0, +0.02, 0), capture->color.get());
+						batch->addLine(position + ofVec3f(-0.02, 0, 0), position + ofVec3f(+0.02, 0, 0), capture->color.get());
+					}
+
+					ofPushStyle();
+					{
+						for (auto capture : captures) {
+							ofSetColor(capture->color);
+							ofDrawBitmapString(ofToString(capture->projected, 3), capture->worldPosition);
 						}
-						ofPopMatrix();
 					}
+					ofPopStyle();
 				}
 
 				//----------